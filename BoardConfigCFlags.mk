@@ -182,3 +182,7 @@ endif
 ifeq ($(BOARD_USE_FULL_ST2094_40), true)
 LOCAL_CFLAGS += -DUSE_FULL_ST2094_40
 endif
+
+ifeq ($(BOARD_CAMERA_USES_SW_PIPE_TASK_EXECUTOR), true)
+LOCAL_CFLAGS += -DUSE_SW_PIPE_TASK_EXECUTOR
+endif
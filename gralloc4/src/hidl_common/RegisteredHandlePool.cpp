@@ -18,30 +18,237 @@
 
 #include "RegisteredHandlePool.h"
 
+/* Start of the probe sequence, the shard takes the top bits of the hash */
+#define SLOT_OF(hash, mask) (static_cast<size_t>((hash) >> 28) & (mask))
+
+RegisteredHandlePool::Table::Table(size_t capacity)
+    : mask(capacity - 1)
+    , slots(new std::atomic<uintptr_t>[capacity])
+{
+    for (size_t i = 0; i < capacity; i++)
+        slots[i].store(EMPTY, std::memory_order_relaxed);
+}
+
+RegisteredHandlePool::Table::~Table()
+{
+    delete[] slots;
+}
+
+std::atomic<uintptr_t> *RegisteredHandlePool::Table::find(uintptr_t key, uint64_t hash) const
+{
+    for (size_t i = SLOT_OF(hash, mask), probe = 0; probe <= mask; i = (i + 1) & mask, probe++)
+    {
+        uintptr_t value = slots[i].load(std::memory_order_acquire);
+
+        if (value == key)
+            return &slots[i];
+        if (value == EMPTY)
+            break;
+    }
+
+    return nullptr;
+}
+
+RegisteredHandlePool::RegisteredHandlePool()
+{
+    for (Shard &shard : shards)
+    {
+        shard.table.store(new Table(MIN_CAPACITY), std::memory_order_relaxed);
+        for (ReaderCount &reader : shard.readers)
+            reader.count.store(0, std::memory_order_relaxed);
+        shard.live = 0;
+        shard.used = 0;
+    }
+}
+
+RegisteredHandlePool::~RegisteredHandlePool()
+{
+    for (Shard &shard : shards)
+    {
+        for (RetiredTable &retired : shard.retired)
+            delete retired.table;
+        delete shard.table.load(std::memory_order_relaxed);
+    }
+}
+
+uint64_t RegisteredHandlePool::hash(uintptr_t key)
+{
+    /* Handles are aligned heap pointers, mix the middle bits up to the top */
+    return static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+}
+
+RegisteredHandlePool::Shard &RegisteredHandlePool::shardOf(uint64_t hash)
+{
+    return shards[hash >> 60 & (NUM_SHARDS - 1)];
+}
+
+/* Called with the shard mutex held */
+void RegisteredHandlePool::rebuild(Shard &shard, size_t needed)
+{
+    Table *old_table = shard.table.load(std::memory_order_relaxed);
+    size_t capacity = MIN_CAPACITY;
+
+    while (capacity < needed * 2)
+        capacity <<= 1;
+
+    Table *new_table = new Table(capacity);
+    for (size_t i = 0; i <= old_table->mask; i++)
+    {
+        uintptr_t value = old_table->slots[i].load(std::memory_order_relaxed);
+        if (value == EMPTY || value == REMOVED)
+            continue;
+
+        size_t j = SLOT_OF(hash(value), new_table->mask);
+        while (new_table->slots[j].load(std::memory_order_relaxed) != EMPTY)
+            j = (j + 1) & new_table->mask;
+        new_table->slots[j].store(value, std::memory_order_relaxed);
+    }
+
+    /* Pairs with the reader count increment in get() */
+    shard.table.store(new_table, std::memory_order_seq_cst);
+    shard.used = shard.live;
+    shard.retired.push_back({ old_table, 0 });
+}
+
+/* Called with the shard mutex held */
+void RegisteredHandlePool::reclaim(Shard &shard)
+{
+    /*
+     * A reader that could see a retired table counted itself before the table
+     * was replaced, so its slot stays non-zero until it is done. Once every slot
+     * was seen at zero after that, nobody can hold the table any more.
+     */
+    for (auto retired = shard.retired.begin(); retired != shard.retired.end();)
+    {
+        for (size_t i = 0; i < NUM_READER_SLOTS; i++)
+        {
+            if (shard.readers[i].count.load(std::memory_order_seq_cst) == 0)
+                retired->quiescent |= 1u << i;
+        }
+
+        if (retired->quiescent == (1u << NUM_READER_SLOTS) - 1)
+        {
+            delete retired->table;
+            retired = shard.retired.erase(retired);
+        }
+        else
+        {
+            retired++;
+        }
+    }
+}
+
 bool RegisteredHandlePool::add(buffer_handle_t bufferHandle)
 {
-    std::lock_guard<std::mutex> lock(mutex);
-    return bufPool.insert(bufferHandle).second;
+    const uintptr_t key = reinterpret_cast<uintptr_t>(bufferHandle);
+    const uint64_t key_hash = hash(key);
+    Shard &shard = shardOf(key_hash);
+
+    if (key == EMPTY || key == REMOVED)
+        return false;
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    reclaim(shard);
+
+    Table *table = shard.table.load(std::memory_order_relaxed);
+    if (table->find(key, key_hash) != nullptr)
+        return false;
+
+    /* Keep an empty slot on every probe sequence, removed entries count as used */
+    if ((shard.used + 1) * 4 > (table->mask + 1) * 3)
+    {
+        rebuild(shard, shard.live + 1);
+        table = shard.table.load(std::memory_order_relaxed);
+    }
+
+    std::atomic<uintptr_t> *free_slot = nullptr;
+    size_t i = SLOT_OF(key_hash, table->mask);
+    for (;; i = (i + 1) & table->mask)
+    {
+        uintptr_t value = table->slots[i].load(std::memory_order_relaxed);
+        if (value == REMOVED && free_slot == nullptr)
+        {
+            free_slot = &table->slots[i];
+        }
+        else if (value == EMPTY)
+        {
+            if (free_slot == nullptr)
+            {
+                free_slot = &table->slots[i];
+                shard.used++;
+            }
+            break;
+        }
+    }
+
+    free_slot->store(key, std::memory_order_release);
+    shard.live++;
+
+    return true;
 }
 
 native_handle_t* RegisteredHandlePool::remove(void* buffer)
 {
     auto bufferHandle = static_cast<native_handle_t*>(buffer);
+    const uintptr_t key = reinterpret_cast<uintptr_t>(buffer);
+    const uint64_t key_hash = hash(key);
+    Shard &shard = shardOf(key_hash);
+
+    if (key == EMPTY || key == REMOVED)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    std::atomic<uintptr_t> *slot = shard.table.load(std::memory_order_relaxed)->find(key, key_hash);
+    if (slot == nullptr)
+        return nullptr;
 
-    std::lock_guard<std::mutex> lock(mutex);
-    return bufPool.erase(bufferHandle) == 1 ? bufferHandle : nullptr;
+    slot->store(REMOVED, std::memory_order_release);
+    shard.live--;
+
+    return bufferHandle;
 }
 
 buffer_handle_t RegisteredHandlePool::get(const void* buffer)
 {
+    static std::atomic<uint32_t> next_reader_slot(0);
+    static thread_local const uint32_t reader_slot = next_reader_slot.fetch_add(1, std::memory_order_relaxed) % NUM_READER_SLOTS;
+
     auto bufferHandle = static_cast<buffer_handle_t>(buffer);
+    const uintptr_t key = reinterpret_cast<uintptr_t>(buffer);
+    const uint64_t key_hash = hash(key);
+    Shard &shard = shardOf(key_hash);
+
+    if (key == EMPTY || key == REMOVED)
+        return nullptr;
 
-    std::lock_guard<std::mutex> lock(mutex);
-    return bufPool.count(bufferHandle) == 1 ? bufferHandle : nullptr;
+    /* Count in before loading the table, see reclaim() */
+    std::atomic<uint32_t> &count = shard.readers[reader_slot].count;
+    count.fetch_add(1, std::memory_order_seq_cst);
+
+    const Table *table = shard.table.load(std::memory_order_seq_cst);
+    bool found = table->find(key, key_hash) != nullptr;
+
+    count.fetch_sub(1, std::memory_order_release);
+
+    return found ? bufferHandle : nullptr;
 }
 
 void RegisteredHandlePool::for_each(std::function<void(const buffer_handle_t &)> fn)
 {
-    std::lock_guard<std::mutex> lock(mutex);
-    std::for_each(bufPool.begin(), bufPool.end(), fn);
-}
\ No newline at end of file
+    for (Shard &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const Table *table = shard.table.load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i <= table->mask; i++)
+        {
+            uintptr_t value = table->slots[i].load(std::memory_order_relaxed);
+            if (value == EMPTY || value == REMOVED)
+                continue;
+
+            const buffer_handle_t bufferHandle = reinterpret_cast<buffer_handle_t>(value);
+            fn(bufferHandle);
+        }
+    }
+}
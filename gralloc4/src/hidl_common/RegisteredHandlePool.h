@@ -20,15 +20,26 @@
  #define GRALLOC_COMMON_REGISTERED_HANDLE_POOL_H
 
 #include <cutils/native_handle.h>
+#include <atomic>
 #include <mutex>
-#include <unordered_set>
+#include <vector>
 #include <algorithm>
 #include <functional>
 
-/* An unordered set to internally store / retrieve imported buffer handles */
+/*
+ * A set to internally store / retrieve imported buffer handles.
+ *
+ * Handles are spread over shards. Each shard is an open addressing table of
+ * atomic slots: get() probes it without locking, add() and remove() take the
+ * shard mutex. A table that fills up with removed entries is replaced by a new
+ * one, and freed once no reader that could still see it is left.
+ */
 class RegisteredHandlePool
 {
 public:
+	RegisteredHandlePool();
+	~RegisteredHandlePool();
+
 	/* Stores the buffer handle in the internal list */
 	bool add(buffer_handle_t bufferHandle);
 
@@ -42,8 +53,58 @@ public:
 	void for_each(std::function<void(const buffer_handle_t &)> fn);
 
 private:
-	std::mutex mutex;
-	std::unordered_set<buffer_handle_t> bufPool;
+	static constexpr size_t NUM_SHARDS = 16;
+	static constexpr size_t NUM_READER_SLOTS = 8;
+	static constexpr size_t MIN_CAPACITY = 16;
+
+	/* Slot values besides handles */
+	static constexpr uintptr_t EMPTY = 0;
+	static constexpr uintptr_t REMOVED = 1;
+
+	struct Table
+	{
+		explicit Table(size_t capacity);
+		~Table();
+
+		/* Returns the slot holding key, or nullptr */
+		std::atomic<uintptr_t> *find(uintptr_t key, uint64_t hash) const;
+
+		size_t mask;
+		std::atomic<uintptr_t> *slots;
+	};
+
+	/* Readers in flight, a reader counts in the slot of its thread */
+	struct alignas(64) ReaderCount
+	{
+		std::atomic<uint32_t> count;
+	};
+
+	struct RetiredTable
+	{
+		Table *table;
+		/* Reader slots seen empty since the table was replaced */
+		uint32_t quiescent;
+	};
+
+	struct alignas(64) Shard
+	{
+		std::atomic<Table *> table;
+		ReaderCount readers[NUM_READER_SLOTS];
+
+		/* Below is guarded by mutex */
+		std::mutex mutex;
+		size_t live;
+		size_t used;
+		std::vector<RetiredTable> retired;
+	};
+
+	static uint64_t hash(uintptr_t key);
+	Shard &shardOf(uint64_t hash);
+
+	void rebuild(Shard &shard, size_t needed);
+	void reclaim(Shard &shard);
+
+	Shard shards[NUM_SHARDS];
 };
 
 #endif /* GRALLOC_COMMON_REGISTERED_HANDLE_POOL_H */
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2020 ARM Limited. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Stress benchmark of RegisteredHandlePool on a plain Linux host.
+ *
+ * Every thread runs the cycle a mapper client does for its own buffers:
+ * importBuffer (add), lock, get metadata and unlock (get), freeBuffer
+ * (remove). In between it validates buffers shared by all threads and
+ * imported once, as SurfaceFlinger does with the buffers of its layers.
+ * Operations per second are printed per thread count, for the pool and for
+ * "mutex", the single lock + std::unordered_set it replaced.
+ *
+ * Build and run from gralloc4/src/hidl_common:
+ *
+ *   g++ -O2 -std=c++17 -pthread -Itest/stub -I. \
+ *       test/registered_handle_pool_bench.cpp RegisteredHandlePool.cpp \
+ *       -o registered_handle_pool_bench
+ *   ./registered_handle_pool_bench [max_threads] [ms_per_run]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "RegisteredHandlePool.h"
+
+#define BENCH_OWN_HANDLES     64
+#define BENCH_SHARED_HANDLES  256
+#define BENCH_SHARED_PER_CYCLE 4
+
+/* The pool as it was before, for reference */
+class MutexHandlePool
+{
+public:
+	bool add(buffer_handle_t bufferHandle)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return bufPool.insert(bufferHandle).second;
+	}
+
+	native_handle_t* remove(void* buffer)
+	{
+		auto bufferHandle = static_cast<native_handle_t*>(buffer);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		return bufPool.erase(bufferHandle) == 1 ? bufferHandle : nullptr;
+	}
+
+	buffer_handle_t get(const void* buffer)
+	{
+		auto bufferHandle = static_cast<buffer_handle_t>(buffer);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		return bufPool.count(bufferHandle) == 1 ? bufferHandle : nullptr;
+	}
+
+private:
+	std::mutex mutex;
+	std::unordered_set<buffer_handle_t> bufPool;
+};
+
+static std::vector<native_handle_t *> make_handles(size_t num)
+{
+	std::vector<native_handle_t *> handles(num);
+
+	for (auto &handle : handles)
+		handle = new native_handle_t();
+
+	return handles;
+}
+
+template <typename Pool>
+static void worker(Pool *pool, const std::vector<native_handle_t *> *shared, std::atomic<bool> *stop,
+                   unsigned seed, unsigned long long *ops, unsigned long long *errors)
+{
+	std::vector<native_handle_t *> own = make_handles(BENCH_OWN_HANDLES);
+	unsigned long long done = 0, failed = 0;
+	size_t next = seed;
+
+	while (!stop->load(std::memory_order_relaxed))
+	{
+		for (native_handle_t *handle : own)
+		{
+			failed += !pool->add(handle);
+			failed += pool->get(handle) != handle;
+			failed += pool->get(handle) != handle;
+			failed += pool->get(handle) != handle;
+
+			for (int i = 0; i < BENCH_SHARED_PER_CYCLE; i++)
+			{
+				native_handle_t *handle_shared = (*shared)[next++ % shared->size()];
+				failed += pool->get(handle_shared) != handle_shared;
+			}
+
+			failed += pool->remove(handle) != handle;
+			failed += pool->get(handle) != nullptr;
+			done += 6 + BENCH_SHARED_PER_CYCLE;
+		}
+	}
+
+	for (native_handle_t *handle : own)
+		delete handle;
+
+	*ops = done;
+	*errors = failed;
+}
+
+template <typename Pool>
+static double run(unsigned num_threads, unsigned ms, unsigned long long *errors)
+{
+	Pool *pool = new Pool();
+	std::vector<native_handle_t *> shared = make_handles(BENCH_SHARED_HANDLES);
+	std::vector<std::thread> threads;
+	std::vector<unsigned long long> ops(num_threads), failed(num_threads);
+	std::atomic<bool> stop(false);
+	unsigned long long total = 0;
+
+	for (native_handle_t *handle : shared)
+		pool->add(handle);
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned i = 0; i < num_threads; i++)
+		threads.emplace_back(worker<Pool>, pool, &shared, &stop, i * 37, &ops[i], &failed[i]);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+	stop.store(true);
+	for (auto &thread : threads)
+		thread.join();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	for (unsigned i = 0; i < num_threads; i++)
+	{
+		total += ops[i];
+		*errors += failed[i];
+	}
+
+	delete pool;
+	for (native_handle_t *handle : shared)
+		delete handle;
+
+	return total / elapsed.count();
+}
+
+int main(int argc, char **argv)
+{
+	unsigned max_threads = argc > 1 ? atoi(argv[1]) : std::thread::hardware_concurrency();
+	unsigned ms = argc > 2 ? atoi(argv[2]) : 1000;
+	unsigned long long errors = 0;
+
+	if (max_threads == 0 || ms == 0)
+	{
+		fprintf(stderr, "usage: %s [max_threads] [ms_per_run]\n", argv[0]);
+		return 1;
+	}
+
+	printf("%8s %16s %16s %8s\n", "threads", "mutex(ops/s)", "pool(ops/s)", "speedup");
+	for (unsigned num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+	{
+		double mutex_ops = run<MutexHandlePool>(num_threads, ms, &errors);
+		double pool_ops = run<RegisteredHandlePool>(num_threads, ms, &errors);
+
+		printf("%8u %16.0f %16.0f %7.2fx\n", num_threads, mutex_ops, pool_ops, pool_ops / mutex_ops);
+	}
+
+	if (errors != 0)
+	{
+		fprintf(stderr, "%llu lookups returned a wrong handle\n", errors);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2020 ARM Limited. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Host stand-in for the libcutils header, only what RegisteredHandlePool needs */
+
+#ifndef STUB_CUTILS_NATIVE_HANDLE_H
+#define STUB_CUTILS_NATIVE_HANDLE_H
+
+typedef struct native_handle
+{
+	int version;
+	int numFds;
+	int numInts;
+	int data[0];
+} native_handle_t;
+
+typedef const native_handle_t *buffer_handle_t;
+
+#endif /* STUB_CUTILS_NATIVE_HANDLE_H */
@@ -159,6 +159,10 @@ typedef struct _CSC_HANDLE {
     CSC_HW_FILTER    filter;
 
     unsigned int     frame_rate;
+
+    /* CSC_METHOD_SW worker pool, see csc_set_sw_threads() */
+    unsigned int     sw_threads;
+    void            *sw_pool;
 } CSC_HANDLE;
 
 /*
@@ -338,6 +342,24 @@ CSC_ERRORCODE csc_set_framerate(
     void              *handle,
     unsigned int      frame_rate);
 
+/*
+ * Set the number of threads used by CSC_METHOD_SW.
+ * The frame is split into horizontal stripes which run on a worker pool
+ * owned by the handle. The pool is kept until the next call or csc_deinit().
+ *
+ * @param handle
+ *   CSC handle[in]
+ *
+ * @param num_threads
+ *   number of threads including the caller, 0 or 1 : single thread[in]
+ *
+ * @return
+ *   error code
+ */
+CSC_ERRORCODE csc_set_sw_threads(
+    void              *handle,
+    unsigned int      num_threads);
+
 /*
  * Get source format.
  *
@@ -8816,7 +8816,8 @@ bool ExynosCamera::m_DNGCaptureThreadFunc(void)
         goto CLEAN;
     }
 
-    memcpy(m_dngBayerHeap->data, bayerBuffer.addr[0], bayerBuffer.size[0]);
+    /* the raw image goes behind the DNG header, makeDng() never moves it */
+    memcpy((char *)m_dngBayerHeap->data + DNG_HEADER_FILE_SIZE, bayerBuffer.addr[0], bayerBuffer.size[0]);
     CLOGD("[DNG] bayer copy complete! (%d bytes)", bayerBuffer.size[0]);
 
     m_dngCaptureDoneQ->pushProcessQ(&bayerBuffer);
@@ -8841,7 +8842,7 @@ bool ExynosCamera::m_DNGCaptureThreadFunc(void)
     CLOGD("[DNG]Raw Dump start (%s)", filePath);
 
     bRet = dumpToFile((char *)filePath,
-            (char *)m_dngBayerHeap->data,
+            (char *)m_dngBayerHeap->data + DNG_HEADER_FILE_SIZE,
             sensorMaxW * sensorMaxH * 2);
     if (bRet != true)
         CLOGE("couldn't make a raw file");
@@ -7334,6 +7334,7 @@ status_t ExynosCamera::m_setVendorPictureBuffer(void)
 #ifdef SAMSUNG_DNG
     if (m_parameters->getDNGCaptureModeOn() == true) {
         CLOGD("DEBUG(%s[%d]):DNG capture on", __FUNCTION__, __LINE__);
+        /* header, raw image and thumbnail in one buffer, see SecCameraDngCreator::makeDng() */
         dngBayerBufferSize = getBayerPlaneSize(sensorMaxW, sensorMaxH, bayerFormat)
                             + DNG_HEADER_LIMIT_SIZE
                             + (sensorMaxThumbW * sensorMaxThumbH * 3);
@@ -8257,7 +8258,8 @@ bool ExynosCamera::m_DNGCaptureThreadFunc(void)
         goto CLEAN;
     }
 
-    memcpy(m_dngBayerHeap->data, bayerBuffer.addr[0], bayerBuffer.size[0]);
+    /* the raw image goes behind the DNG header, makeDng() never moves it */
+    memcpy((char *)m_dngBayerHeap->data + DNG_HEADER_FILE_SIZE, bayerBuffer.addr[0], bayerBuffer.size[0]);
     CLOGD("[DNG](%s[%d]): bayer copy complete! (%d bytes)", __FUNCTION__, __LINE__, bayerBuffer.size[0]);
 
     m_dngCaptureDoneQ->pushProcessQ(&bayerBuffer);
@@ -8282,7 +8284,7 @@ bool ExynosCamera::m_DNGCaptureThreadFunc(void)
     CLOGD("[DNG](%s[%d]):Raw Dump start (%s)", __FUNCTION__, __LINE__, filePath);
 
     bRet = dumpToFile((char *)filePath,
-            (char *)m_dngBayerHeap->data,
+            (char *)m_dngBayerHeap->data + DNG_HEADER_FILE_SIZE,
             sensorMaxW * sensorMaxH * 2);
     if (bRet != true)
         CLOGE("couldn't make a raw file", __FUNCTION__, __LINE__);
@@ -2253,6 +2253,30 @@ char clip(int i)
         return i;
 }
 
+#ifdef __ARM_NEON
+/* R, G and B of 8 pixels, same math and clipping as the C code below */
+static inline void convertYUVtoRGB888Neon(int16x8_t c, int16x8_t d, int16x8_t e,
+                                          uint8x8_t *r, uint8x8_t *g, uint8x8_t *b)
+{
+    const int32x4_t round = vdupq_n_s32(128);
+    int32x4_t cLo = vmull_n_s16(vget_low_s16(c), 298);
+    int32x4_t cHi = vmull_n_s16(vget_high_s16(c), 298);
+    int32x4_t lo, hi;
+
+    lo = vmlal_n_s16(vaddq_s32(cLo, round), vget_low_s16(e), 409);
+    hi = vmlal_n_s16(vaddq_s32(cHi, round), vget_high_s16(e), 409);
+    *r = vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(lo, 8)), vqmovn_s32(vshrq_n_s32(hi, 8))));
+
+    lo = vmlsl_n_s16(vmlsl_n_s16(vaddq_s32(cLo, round), vget_low_s16(d), 100), vget_low_s16(e), 208);
+    hi = vmlsl_n_s16(vmlsl_n_s16(vaddq_s32(cHi, round), vget_high_s16(d), 100), vget_high_s16(e), 208);
+    *g = vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(lo, 8)), vqmovn_s32(vshrq_n_s32(hi, 8))));
+
+    lo = vmlal_n_s16(vaddq_s32(cLo, round), vget_low_s16(d), 516);
+    hi = vmlal_n_s16(vaddq_s32(cHi, round), vget_high_s16(d), 516);
+    *b = vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(lo, 8)), vqmovn_s32(vshrq_n_s32(hi, 8))));
+}
+#endif
+
 /*
  **    The only convertingYUYVtoRGB888() code is covered by BSD.
  **    URL from which the open source has been downloaded is
@@ -2263,7 +2287,41 @@ void convertingYUYVtoRGB888(char *dstBuf, char *srcBuf, int width, int height)
     int Y0, Y1, U, V, C0, C1, D, E;
 
     for(int y = 0; y < height; y++) {
-        for(int x = 0; x < (width / 2); x++)
+        int x = 0;
+
+#ifdef __ARM_NEON
+        /* 16 pixels per loop, the C code below finishes the row */
+        for (; x + 8 <= (width / 2); x += 8) {
+            uint8x8x4_t yuyv = vld4_u8((uint8_t *)&srcBuf[(2 * y * width) + (4 * x)]);
+            int16x8_t d = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(yuyv.val[1])), vdupq_n_s16(128));
+            int16x8_t e = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(yuyv.val[3])), vdupq_n_s16(128));
+            int16x8_t c0 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(yuyv.val[0])), vdupq_n_s16(16));
+            int16x8_t c1 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(yuyv.val[2])), vdupq_n_s16(16));
+            uint8x8_t r0, g0, b0, r1, g1, b1;
+            uint8x8x2_t r, g, b;
+            uint8x8x3_t rgb;
+
+            convertYUVtoRGB888Neon(c0, d, e, &r0, &g0, &b0);
+            convertYUVtoRGB888Neon(c1, d, e, &r1, &g1, &b1);
+
+            /* even and odd pixels back in order */
+            r = vzip_u8(r0, r1);
+            g = vzip_u8(g0, g1);
+            b = vzip_u8(b0, b1);
+
+            rgb.val[0] = r.val[0];
+            rgb.val[1] = g.val[0];
+            rgb.val[2] = b.val[0];
+            vst3_u8((uint8_t *)&dstBuf[6 * (x + (y * width / 2))], rgb);
+
+            rgb.val[0] = r.val[1];
+            rgb.val[1] = g.val[1];
+            rgb.val[2] = b.val[1];
+            vst3_u8((uint8_t *)&dstBuf[6 * (x + (y * width / 2)) + 24], rgb);
+        }
+#endif
+
+        for(; x < (width / 2); x++)
         {
             Y0 = srcBuf[(2 * y * width) + (4 * x)];
             Y1 = srcBuf[(2 * y * width) + (4 * x) + 2];
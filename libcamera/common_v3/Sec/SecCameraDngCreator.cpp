@@ -17,6 +17,7 @@
 
 #define LOG_TAG "SecCameraDngCreator"
 
+#include <pthread.h>
 #include <utils/Log.h>
 
 #include "ExynosCamera1Parameters.h"
@@ -34,21 +35,42 @@ SecCameraDngCreator::~SecCameraDngCreator()
 {
 }
 
+typedef struct dngThumbnailJob {
+    char *dstBuf;
+    char *srcBuf;
+    int width;
+    int height;
+} dngThumbnailJob_t;
+
+static void *dngThumbnailThreadFunc(void *data)
+{
+    dngThumbnailJob_t *job = (dngThumbnailJob_t *)data;
+
+    convertingYUYVtoRGB888(job->dstBuf, job->srcBuf, job->width, job->height);
+
+    return NULL;
+}
+
+/*
+ * The raw image must already sit at dngBuffer + DNG_HEADER_FILE_SIZE.
+ * The header is written in front of it and the thumbnail behind it,
+ * so the raw image is never moved.
+ */
 int SecCameraDngCreator::makeDng(ExynosCamera1Parameters *param,
                                 unsigned int frameCount,
                                 char* dngBuffer,
                                 unsigned int *rawSize)
 {
     int ret = NO_ERROR;
-    int index;
     int nDngSize = 0;
-    char *rawBuffer;
-    unsigned char *dngHeaderOut = NULL;
+    char *thumbBuffer = NULL;
     dng_attribute_t* dngInfo;
-    char *thumbAddr;
     unsigned int dngHeaderLen = 0;
-    unsigned int bufSize = DNG_HEADER_FILE_SIZE;
-    dng_thumbnail_t *curNode;
+    dng_thumbnail_t *curNode = NULL;
+    dngThumbnailJob_t thumbJob;
+    pthread_t thumbThread;
+    bool thumbThreadCreated = false;
+    int thumbRows = 0;
 
     ALOGD("DEBUG(%s[%d]): make DNG file : frameCount(%d)", __FUNCTION__, __LINE__, frameCount);
 
@@ -59,6 +81,14 @@ int SecCameraDngCreator::makeDng(ExynosCamera1Parameters *param,
 
     dngInfo = param->getDngInfo();
 
+    nDngSize = dngInfo->image_width * dngInfo->image_height * 2;
+
+    if (nDngSize <= 0) {
+        ALOGE("ERR(%s):output_size is too small(%d)!!", __FUNCTION__, nDngSize);
+        *rawSize = 0;
+        return BAD_VALUE;
+    }
+
     if (dngInfo->thumbnail_image_width != 0 && dngInfo->thumbnail_image_height != 0) {
         curNode = param->getDngThumbnailBuffer(frameCount);
         if ((curNode == NULL) || (curNode->size == 0)) {
@@ -67,61 +97,65 @@ int SecCameraDngCreator::makeDng(ExynosCamera1Parameters *param,
             dngInfo->thumbnail_size = 0;
             ALOGE("ERR(%s):Failed to get ThumbNail : set the size to 0 (%s)", __FUNCTION__,
                         curNode ? "buf size 0" : "null node");
+            curNode = NULL;
         } else {
-            convertingYUYVtoRGB888(dngBuffer + DNG_HEADER_FILE_SIZE + (dngInfo->image_width * dngInfo->image_height * 2),
-                curNode->buf, dngInfo->thumbnail_image_width, dngInfo->thumbnail_image_height);
+            thumbBuffer = dngBuffer + DNG_HEADER_FILE_SIZE + nDngSize;
             dngInfo->thumbnail_size = curNode->size / 2 * 3;
 
-            param->deleteDngThumbnailBuffer(curNode);
+            /* the upper half is converted while the header is made */
+            thumbRows = dngInfo->thumbnail_image_height / 2;
+            thumbJob.dstBuf = thumbBuffer;
+            thumbJob.srcBuf = curNode->buf;
+            thumbJob.width = dngInfo->thumbnail_image_width;
+            thumbJob.height = thumbRows;
+
+            if (pthread_create(&thumbThread, NULL, dngThumbnailThreadFunc, &thumbJob) == 0) {
+                thumbThreadCreated = true;
+            } else {
+                ALOGW("WARN(%s):Failed to create the thumbnail thread, convert here", __FUNCTION__);
+                thumbRows = 0;
+            }
         }
     }
 
     ALOGD("DEBUG(%s):[DNG] Thumbnailsize (%d)", __FUNCTION__, dngInfo->thumbnail_size);
 
-    rawBuffer = dngBuffer;
-
-    dngHeaderOut = new unsigned char[bufSize];
-    if (dngHeaderOut == NULL) {
-        ALOGE("ERR(%s):Failed to allocate for dngHeaderOut", __FUNCTION__);
-        return NO_MEMORY;
-    }
-    memset(dngHeaderOut, 0, bufSize);
+    memset(dngBuffer, 0, DNG_HEADER_FILE_SIZE);
 
-    if (makeDngHeader(dngHeaderOut, dngInfo, &dngHeaderLen)) {
+    if (makeDngHeader((unsigned char *)dngBuffer, dngInfo, &dngHeaderLen)) {
         ALOGE("ERR(%s):Failed to make DNG header", __FUNCTION__);
         ret = INVALID_OPERATION;
-        goto CLEAN_MEMORY;
+    } else if (dngHeaderLen > DNG_HEADER_LIMIT_SIZE) {
+        ALOGE("ERR(%s):dngHeaderLen(%d) is too bingger than DNG_HEADER_LIMIT_SIZE(%d)",
+            __FUNCTION__, dngHeaderLen, DNG_HEADER_LIMIT_SIZE);
+        ret = BAD_VALUE;
+    } else if (dngHeaderLen != DNG_HEADER_FILE_SIZE) {
+        /* the strip offsets point to DNG_HEADER_FILE_SIZE */
+        ALOGE("ERR(%s):dngHeaderLen(%d) is not DNG_HEADER_FILE_SIZE(%d)",
+            __FUNCTION__, dngHeaderLen, DNG_HEADER_FILE_SIZE);
+        ret = BAD_VALUE;
+    } else {
+        nDngSize += dngHeaderLen;
     }
 
-    nDngSize = dngInfo->image_width * dngInfo->image_height * 2;
+    if (curNode != NULL) {
+        /* the lower half, or all of it without the thread */
+        convertingYUYVtoRGB888(thumbBuffer + (thumbRows * dngInfo->thumbnail_image_width * 3),
+            curNode->buf + (thumbRows * dngInfo->thumbnail_image_width * 2),
+            dngInfo->thumbnail_image_width, dngInfo->thumbnail_image_height - thumbRows);
 
-    if (nDngSize <= 0) {
-        ALOGE("ERR(%s):output_size is too small(%d)!!", __FUNCTION__, nDngSize);
-        ret = BAD_VALUE;
-        goto CLEAN_MEMORY;
-    }
+        if (thumbThreadCreated == true)
+            pthread_join(thumbThread, NULL);
 
-    if (dngHeaderLen <= DNG_HEADER_LIMIT_SIZE) {
-        memmove(dngBuffer + dngHeaderLen, rawBuffer, nDngSize);
-        if (dngHeaderLen <= bufSize) {
-            memcpy(dngBuffer, dngHeaderOut, dngHeaderLen);
-            nDngSize += dngHeaderLen;
-        } else {
-            ALOGE("ERR(%s):dngHeaderLen(%d) is too bigger than DNG_HEADER_FILE_SIZE(%d)",
-                __FUNCTION__, dngHeaderLen, DNG_HEADER_FILE_SIZE);
-            ret = BAD_VALUE;
-        }
-    } else {
-        ALOGE("ERR(%s):dngHeaderLen(%d) is too bingger than DNG_HEADER_LIMIT_SIZE(%d)",
-            __FUNCTION__, dngHeaderLen, DNG_HEADER_LIMIT_SIZE);
-        ret = BAD_VALUE;
+        param->deleteDngThumbnailBuffer(curNode);
     }
 
-    nDngSize += dngInfo->thumbnail_size;
+    if (ret == INVALID_OPERATION)
+        nDngSize = 0;
+    else
+        nDngSize += dngInfo->thumbnail_size;
 
-CLEAN_MEMORY:
     *rawSize = nDngSize;
-    delete[] dngHeaderOut;
 
     return ret;
 }
@@ -22,6 +22,8 @@
 #include <utils/List.h>
 #include <utils/threads.h>
 
+#include "SecCameraVsyncModel.h"
+
 namespace android {
 
 #define MULTIPLE_VSYNC_DETECT_OFFSET_NS    (4000000)
@@ -49,6 +51,7 @@ private:
     nsecs_t    m_vsyncTime;
     nsecs_t    m_lastTargetTime;
     nsecs_t    m_vsyncPeriod;
+    nsecs_t    m_vsyncJitter;
     nsecs_t    m_videoSyncPeriod;
     int    m_syncAdjustCount;
     mutable Mutex        m_updateVsyncLock;
@@ -56,6 +59,7 @@ private:
     int    m_dropCount;
     float    m_targetFps;
 
+    SecCameraVsyncModel    m_vsyncModel;
     sp<ISurfaceComposer>    m_composer;
 
 };
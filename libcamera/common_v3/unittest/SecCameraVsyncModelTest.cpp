@@ -0,0 +1,284 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * SecCameraVsyncModel against synthetic vsync traces.
+ * A fake display runs at a given rate with timestamp noise, and the preview
+ * scheduler asks for the next vsync once per camera frame. SurfaceFlinger
+ * is only sampled when the model asks for it, and every prediction is
+ * compared with the real next vsync.
+ */
+
+#include <stdio.h>
+
+#include <gtest/gtest.h>
+
+#include "../Sec/SecCameraVsyncModel.h"
+
+using namespace android;
+
+#define TEST_CAMERA_PERIOD_NS   (33333333LL)
+#define TEST_NOISE_NS           (50000LL)
+/* a prediction within this of the real vsync is good enough to schedule */
+#define TEST_MAX_ERROR_NS       (250000LL)
+
+/* the display, with a deterministic timestamp noise */
+class FakeDisplay {
+public:
+    FakeDisplay(int64_t period, int64_t phase)
+    {
+        m_period = period;
+        m_phase = phase;
+        m_seed = 1;
+    }
+
+    /* changes the rate at time, keeping the vsync that runs at time */
+    void setPeriod(int64_t time, int64_t period)
+    {
+        m_phase = getNext(time);
+        m_period = period;
+    }
+
+    void shiftPhase(int64_t offset)
+    {
+        m_phase += offset;
+    }
+
+    int64_t getPeriod(void)
+    {
+        return m_period;
+    }
+
+    int64_t getNext(int64_t time)
+    {
+        int64_t index;
+
+        if (time <= m_phase)
+            index = -((m_phase - time) / m_period);
+        else
+            index = (time - m_phase + m_period - 1) / m_period;
+
+        return m_phase + index * m_period;
+    }
+
+    /* what getDisplayStats() reports at time */
+    int64_t sample(int64_t time)
+    {
+        return getNext(time) + m_noise();
+    }
+
+private:
+    int64_t m_noise(void)
+    {
+        m_seed = m_seed * 1103515245 + 12345;
+
+        return (int64_t)((m_seed >> 8) % (2 * TEST_NOISE_NS + 1)) - TEST_NOISE_NS;
+    }
+
+    int64_t     m_period;
+    int64_t     m_phase;
+    uint32_t    m_seed;
+};
+
+struct TraceResult {
+    int numOfFrame;
+    int numOfSample;
+    int numOfMiss;
+    int64_t maxError;
+    double meanError;
+};
+
+/*
+ * Runs the scheduler loop from startTime for numOfFrame camera frames.
+ * Frames before settleTime are not scored, dropStart..dropEnd get no sample.
+ */
+static void runTrace(SecCameraVsyncModel *model, FakeDisplay *display,
+                     int64_t startTime, int numOfFrame, int64_t settleTime,
+                     int64_t dropStart, int64_t dropEnd, TraceResult *result)
+{
+    int64_t now, predicted, real, error;
+    int64_t period;
+    double sum = 0.0;
+    int numOfScore = 0;
+
+    memset(result, 0x0, sizeof(TraceResult));
+
+    for (int i = 0; i < numOfFrame; i++) {
+        now = startTime + i * TEST_CAMERA_PERIOD_NS;
+
+        if (model->needSample(now) == true && (now < dropStart || now >= dropEnd)) {
+            model->addSample(display->sample(now), display->getPeriod());
+            result->numOfSample++;
+        }
+
+        predicted = model->predictNext(now);
+        if (now < settleTime)
+            continue;
+
+        real = display->getNext(now);
+        period = display->getPeriod();
+
+        /* the vsync next to a boundary may be taken for its neighbour */
+        error = (predicted - real) % period;
+        if (error > period / 2)
+            error -= period;
+        else if (error < -period / 2)
+            error += period;
+        if (error < 0)
+            error = -error;
+
+        if (error > TEST_MAX_ERROR_NS)
+            result->numOfMiss++;
+        if (result->maxError < error)
+            result->maxError = error;
+
+        sum += (double)error;
+        numOfScore++;
+    }
+
+    result->numOfFrame = numOfScore;
+    result->meanError = (numOfScore > 0) ? sum / numOfScore : 0.0;
+}
+
+static void printResult(const char *name, TraceResult *result)
+{
+    printf("  %-24s frames %5d samples %4d (%5.1f%%) : max %6lld ns, mean %8.1f ns, miss %d\n",
+           name, result->numOfFrame, result->numOfSample,
+           result->numOfFrame ? 100.0 * result->numOfSample / result->numOfFrame : 0.0,
+           (long long)result->maxError, result->meanError, result->numOfMiss);
+}
+
+static void runSteady(const char *name, int64_t displayPeriod)
+{
+    SecCameraVsyncModel model;
+    FakeDisplay display(displayPeriod, 1234567);
+    TraceResult result;
+
+    /* 60 sec of preview, scored after the first second */
+    runTrace(&model, &display, 1000000000LL, 1800, 2000000000LL, 0, 0, &result);
+    printResult(name, &result);
+
+    EXPECT_TRUE(model.isLocked());
+    EXPECT_EQ(0, result.numOfMiss);
+    EXPECT_LE(result.maxError, TEST_MAX_ERROR_NS);
+    /* SurfaceFlinger is sampled for a few percent of the frames only */
+    EXPECT_LT(result.numOfSample * 20, result.numOfFrame);
+    EXPECT_NEAR((double)displayPeriod, (double)model.getPeriod(), 1000.0);
+}
+
+TEST(SecCameraVsyncModelTest, Steady60Hz)
+{
+    runSteady("60Hz", 16666667LL);
+}
+
+TEST(SecCameraVsyncModelTest, Steady90Hz)
+{
+    runSteady("90Hz", 11111111LL);
+}
+
+TEST(SecCameraVsyncModelTest, Steady120Hz)
+{
+    runSteady("120Hz", 8333333LL);
+}
+
+TEST(SecCameraVsyncModelTest, NoSample)
+{
+    SecCameraVsyncModel model;
+    int64_t jitter = -1;
+
+    EXPECT_EQ(0, model.predictNext(1000, &jitter));
+    EXPECT_EQ(0, jitter);
+    EXPECT_EQ(0, model.getPeriod());
+    EXPECT_TRUE(model.needSample(1000));
+    EXPECT_FALSE(model.isLocked());
+}
+
+TEST(SecCameraVsyncModelTest, SameVsyncReportedAgain)
+{
+    SecCameraVsyncModel model;
+
+    /* SurfaceFlinger reports the same next vsync until it passes */
+    model.addSample(100000000LL, 16666667LL);
+    model.addSample(100000000LL, 16666667LL);
+    model.addSample(100000000LL, 16666667LL);
+
+    EXPECT_FALSE(model.isLocked());
+    EXPECT_EQ(100000000LL, model.predictNext(90000000LL));
+    EXPECT_EQ(116666667LL, model.predictNext(100000001LL));
+}
+
+TEST(SecCameraVsyncModelTest, ModeSwitch)
+{
+    SecCameraVsyncModel model;
+    FakeDisplay display(16666667LL, 1234567);
+    TraceResult result;
+    int64_t switchTime = 11000000000LL;
+
+    runTrace(&model, &display, 1000000000LL, 300, 2000000000LL, 0, 0, &result);
+    printResult("60Hz before switch", &result);
+    EXPECT_EQ(0, result.numOfMiss);
+
+    /* 60 -> 120 Hz, the reported period changes with the display */
+    display.setPeriod(switchTime, 8333333LL);
+    runTrace(&model, &display, switchTime, 600, switchTime + 1500000000LL, 0, 0, &result);
+    printResult("120Hz after switch", &result);
+    EXPECT_EQ(0, result.numOfMiss);
+    EXPECT_EQ(1u, model.getNumOfReset());
+    EXPECT_NEAR(8333333.0, (double)model.getPeriod(), 1000.0);
+
+    /* and back to 90 Hz */
+    switchTime += 600 * TEST_CAMERA_PERIOD_NS;
+    display.setPeriod(switchTime, 11111111LL);
+    runTrace(&model, &display, switchTime, 600, switchTime + 1500000000LL, 0, 0, &result);
+    printResult("90Hz after switch", &result);
+    EXPECT_EQ(0, result.numOfMiss);
+    EXPECT_EQ(2u, model.getNumOfReset());
+}
+
+TEST(SecCameraVsyncModelTest, DroppedSamples)
+{
+    SecCameraVsyncModel model;
+    FakeDisplay display(16666667LL, 1234567);
+    TraceResult result;
+
+    /* SurfaceFlinger does not answer for 5 sec in the middle */
+    runTrace(&model, &display, 1000000000LL, 1200, 2000000000LL,
+             10000000000LL, 15000000000LL, &result);
+    printResult("60Hz, 5 sec no sample", &result);
+
+    EXPECT_EQ(0, result.numOfMiss);
+    EXPECT_LE(result.maxError, TEST_MAX_ERROR_NS);
+}
+
+TEST(SecCameraVsyncModelTest, PhaseJump)
+{
+    SecCameraVsyncModel model;
+    FakeDisplay display(16666667LL, 1234567);
+    TraceResult result;
+    int64_t jumpTime = 11000000000LL;
+
+    runTrace(&model, &display, 1000000000LL, 300, 2000000000LL, 0, 0, &result);
+    EXPECT_EQ(0, result.numOfMiss);
+
+    /* the display restarts with the same rate and a new phase */
+    display.shiftPhase(6000000LL);
+    runTrace(&model, &display, jumpTime, 600, jumpTime + 1500000000LL, 0, 0, &result);
+    printResult("60Hz after phase jump", &result);
+
+    EXPECT_TRUE(model.isLocked());
+    EXPECT_EQ(0, result.numOfMiss);
+    EXPECT_EQ(1u, model.getNumOfReset());
+}
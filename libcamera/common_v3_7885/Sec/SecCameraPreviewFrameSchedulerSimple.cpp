@@ -30,8 +30,10 @@
 namespace android {
 
 SecCameraPreviewFrameScheduler::SecCameraPreviewFrameScheduler()
-    : m_vsyncTime(0),
-      m_vsyncPeriod(0)
+    : m_vsyncTimeOld(0),
+      m_vsyncTime(0),
+      m_vsyncPeriod(0),
+      m_vsyncJitter(0)
 {
     ALOGD("(%s[%d])", __FUNCTION__, __LINE__);
     m_reset(30);
@@ -54,12 +56,10 @@ void SecCameraPreviewFrameScheduler::m_reset(float targetFps)
 
 // This is the phase offset at which SurfaceFlinger's composition runs.
 static const int64_t sfVsyncPhaseOffsetNs = SF_VSYNC_EVENT_PHASE_OFFSET_NS;
+/* feeds one SurfaceFlinger sample to the vsync model */
 void SecCameraPreviewFrameScheduler::m_updateVsync()
 {
     Mutex::Autolock lock(m_updateVsyncLock);
-    m_vsyncPeriod = 0;
-    m_vsyncTimeOld = m_vsyncTime;
-    m_vsyncTime = 0;
 
     // For now, surface flinger only schedules frames on the primary display
     if (m_composer == NULL) {
@@ -74,8 +74,7 @@ void SecCameraPreviewFrameScheduler::m_updateVsync()
         if (res == OK) {
             ALOGV("vsync time:%lld period:%lld",
                     (long long)stats.vsyncTime, (long long)stats.vsyncPeriod);
-            m_vsyncTime = stats.vsyncTime + sfVsyncPhaseOffsetNs;
-            m_vsyncPeriod = stats.vsyncPeriod;
+            m_vsyncModel.addSample(stats.vsyncTime + sfVsyncPhaseOffsetNs, stats.vsyncPeriod);
         } else {
             ALOGW("getDisplayStats returned %d", res);
         }
@@ -89,8 +88,22 @@ nsecs_t SecCameraPreviewFrameScheduler::m_schedule()
     nsecs_t curTime = systemTime(SYSTEM_TIME_MONOTONIC);
     nsecs_t delayTime = 0;
     nsecs_t targetTime = 0;
+    nsecs_t scheduleOffset = FRAME_SCHEDULE_OFFSET_NS;
+    bool needSample;
+
+    m_updateVsyncLock.lock();
+    needSample = m_vsyncModel.needSample(curTime);
+    m_updateVsyncLock.unlock();
 
-    m_updateVsync();
+    /* SurfaceFlinger is only asked when the model needs a sample */
+    if (needSample == true)
+        m_updateVsync();
+
+    m_updateVsyncLock.lock();
+    m_vsyncTimeOld = m_vsyncTime;
+    m_vsyncTime = m_vsyncModel.predictNext(curTime, &m_vsyncJitter);
+    m_vsyncPeriod = m_vsyncModel.getPeriod();
+    m_updateVsyncLock.unlock();
 
     // without VSYNC info, there is nothing to do
     if (m_vsyncPeriod == 0) {
@@ -118,7 +131,17 @@ nsecs_t SecCameraPreviewFrameScheduler::m_schedule()
         }
     }
 
-    delayTime = (m_vsyncTime - curTime + FRAME_SCHEDULE_OFFSET_NS) % m_vsyncPeriod;
+    /*
+     * The predicted vsync may be off by the jitter of the fit : wake up that
+     * much later, so the frame still goes out after the real vsync.
+     * A locked model is within period/8, an unlocked one is capped there.
+     */
+    if (m_vsyncJitter < m_vsyncPeriod / VSYNC_MODEL_JITTER_RATIO)
+        scheduleOffset += m_vsyncJitter;
+    else
+        scheduleOffset += m_vsyncPeriod / VSYNC_MODEL_JITTER_RATIO;
+
+    delayTime = (m_vsyncTime - curTime + scheduleOffset) % m_vsyncPeriod;
     targetTime = curTime + delayTime;
 
     if ((targetTime - m_lastTargetTime) < (m_videoSyncPeriod - MULTIPLE_VSYNC_DETECT_OFFSET_NS)) {
@@ -146,8 +169,8 @@ func_exit:
 
     m_lastTargetTime = curTime + delayTime;
 
-    ALOGV("schedule() VsyncOld(%lld), Vsync(%lld), cur(%lld), VsyncPeriod(%lld), VideoPeriod(%lld), Delay(%lld), target(%lld)",
-            m_vsyncTimeOld, m_vsyncTime, curTime, m_vsyncPeriod, m_videoSyncPeriod, delayTime, curTime+delayTime);
+    ALOGV("schedule() VsyncOld(%lld), Vsync(%lld), cur(%lld), VsyncPeriod(%lld), Jitter(%lld), Offset(%lld), VideoPeriod(%lld), Delay(%lld), target(%lld)",
+            m_vsyncTimeOld, m_vsyncTime, curTime, m_vsyncPeriod, m_vsyncJitter, scheduleOffset, m_videoSyncPeriod, delayTime, curTime+delayTime);
 
     return delayTime;
 }
@@ -169,8 +192,12 @@ void SecCameraPreviewFrameScheduler::m_schedulePreviewFrame(float targetFps)
 
 void SecCameraPreviewFrameScheduler::m_release()
 {
-    ALOGD("(%s[%d] m_vsyncPeriod=%lld, Drop Count %d)",
-            __FUNCTION__, __LINE__, m_vsyncPeriod, m_dropCount);
+    ALOGD("(%s[%d] m_vsyncPeriod=%lld, Drop Count %d, Vsync model reset %d)",
+            __FUNCTION__, __LINE__, m_vsyncPeriod, m_dropCount, m_vsyncModel.getNumOfReset());
+
+    m_updateVsyncLock.lock();
+    m_vsyncModel.reset();
+    m_updateVsyncLock.unlock();
 
     m_composer.clear();
 }
@@ -0,0 +1,278 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SEC_CAMERA_VSYNC_MODEL_H_
+#define SEC_CAMERA_VSYNC_MODEL_H_
+
+#include <stdint.h>
+#include <math.h>
+
+/* samples kept for the fit, about 16 sec with the default resample interval */
+#define VSYNC_MODEL_MAX_SAMPLES         (16)
+/* samples needed before the model is trusted */
+#define VSYNC_MODEL_MIN_SAMPLES         (3)
+/* a locked model asks SurfaceFlinger again after this */
+#define VSYNC_MODEL_RESAMPLE_NS         (1000000000LL)
+/* a reported period further than 1/32 (3%) from the model is a mode switch */
+#define VSYNC_MODEL_PERIOD_TOLERANCE    (32)
+/* a sample further than period/4 from the model is an outlier */
+#define VSYNC_MODEL_OUTLIER_RATIO       (4)
+/* this many outliers in a row mean the phase has moved */
+#define VSYNC_MODEL_MAX_OUTLIERS        (2)
+/* a fit worse than period/8 is not locked */
+#define VSYNC_MODEL_JITTER_RATIO        (8)
+
+namespace android {
+
+/*
+ * Phase locked model of the display vsync.
+ * Samples from SurfaceFlinger (a vsync time and the period) are numbered by
+ * the vsync they belong to, and vsync(n) = phase + period * n is fitted by
+ * least squares over the last samples. Samples may be sparse: the number is
+ * recovered from the model, so dropped samples cost nothing.
+ * A new display period restarts the fit, and the jitter bound is the worst
+ * residual of the fit.
+ * Not thread safe, the owner serializes the calls.
+ */
+class SecCameraVsyncModel {
+public:
+    SecCameraVsyncModel()
+    {
+        reset();
+    }
+
+    void reset(void)
+    {
+        m_numOfSample = 0;
+        m_head = 0;
+        m_numOfOutlier = 0;
+        m_baseTime = 0;
+        m_reportedPeriod = 0;
+        m_lastSampleTime = 0;
+        m_phase = 0.0;
+        m_period = 0.0;
+        m_jitter = 0;
+        m_span = 0;
+        m_numOfReset = 0;
+    }
+
+    /* vsyncTime : a vsync time in ns, period : the reported period in ns */
+    void addSample(int64_t vsyncTime, int64_t period)
+    {
+        int64_t index;
+        double error;
+
+        if (period <= 0)
+            return;
+
+        m_lastSampleTime = vsyncTime;
+
+        if (m_numOfSample == 0 || m_isModeSwitch(period) == true) {
+            m_restart(vsyncTime, period);
+            return;
+        }
+
+        index = m_getIndex(vsyncTime);
+        error = (double)(vsyncTime - m_baseTime) - (m_phase + m_period * (double)index);
+
+        if (fabs(error) > m_period / VSYNC_MODEL_OUTLIER_RATIO) {
+            m_numOfOutlier++;
+            if (m_numOfOutlier >= VSYNC_MODEL_MAX_OUTLIERS)
+                m_restart(vsyncTime, period);
+            return;
+        }
+
+        m_numOfOutlier = 0;
+
+        /* the same vsync reported again */
+        if (m_sampleIndex[m_last()] == index) {
+            m_sampleTime[m_last()] = vsyncTime - m_baseTime;
+        } else {
+            m_sampleIndex[m_head] = index;
+            m_sampleTime[m_head] = vsyncTime - m_baseTime;
+            m_head = (m_head + 1) % VSYNC_MODEL_MAX_SAMPLES;
+            if (m_numOfSample < VSYNC_MODEL_MAX_SAMPLES)
+                m_numOfSample++;
+        }
+
+        m_fit();
+    }
+
+    /* the first vsync at or after time, 0 without a model */
+    int64_t predictNext(int64_t time, int64_t *jitter = NULL)
+    {
+        double offset;
+        int64_t index;
+
+        if (jitter != NULL)
+            *jitter = m_jitter;
+
+        if (m_numOfSample == 0 || m_period <= 0.0)
+            return 0;
+
+        offset = (double)(time - m_baseTime) - m_phase;
+        index = (int64_t)ceil(offset / m_period);
+
+        return m_baseTime + (int64_t)llround(m_phase + m_period * (double)index);
+    }
+
+    /*
+     * true when the caller should feed a new sample before predicting.
+     * A young fit is not extrapolated further than the time its samples
+     * cover, so the interval grows up to VSYNC_MODEL_RESAMPLE_NS.
+     */
+    bool needSample(int64_t now)
+    {
+        int64_t interval = VSYNC_MODEL_RESAMPLE_NS;
+
+        if (isLocked() == false)
+            return true;
+
+        if (interval > m_span)
+            interval = m_span;
+
+        return (now - m_lastSampleTime > interval);
+    }
+
+    bool isLocked(void)
+    {
+        if (m_numOfSample < VSYNC_MODEL_MIN_SAMPLES || m_numOfOutlier > 0)
+            return false;
+
+        return (m_jitter <= (int64_t)(m_period / VSYNC_MODEL_JITTER_RATIO));
+    }
+
+    int64_t getPeriod(void)
+    {
+        return (int64_t)llround(m_period);
+    }
+
+    int64_t getJitter(void)
+    {
+        return m_jitter;
+    }
+
+    /* restarts of the fit, for dump */
+    uint32_t getNumOfReset(void)
+    {
+        return m_numOfReset;
+    }
+
+private:
+    bool m_isModeSwitch(int64_t period)
+    {
+        int64_t diff = period - m_reportedPeriod;
+
+        if (diff < 0)
+            diff = -diff;
+
+        return (diff > m_reportedPeriod / VSYNC_MODEL_PERIOD_TOLERANCE);
+    }
+
+    void m_restart(int64_t vsyncTime, int64_t period)
+    {
+        if (m_numOfSample > 0)
+            m_numOfReset++;
+
+        m_baseTime = vsyncTime;
+        m_reportedPeriod = period;
+        m_phase = 0.0;
+        m_period = (double)period;
+        m_jitter = 0;
+        m_span = 0;
+        m_numOfOutlier = 0;
+
+        m_sampleIndex[0] = 0;
+        m_sampleTime[0] = 0;
+        m_head = 1;
+        m_numOfSample = 1;
+    }
+
+    int m_last(void)
+    {
+        return (m_head + VSYNC_MODEL_MAX_SAMPLES - 1) % VSYNC_MODEL_MAX_SAMPLES;
+    }
+
+    int64_t m_getIndex(int64_t vsyncTime)
+    {
+        return (int64_t)llround(((double)(vsyncTime - m_baseTime) - m_phase) / m_period);
+    }
+
+    void m_fit(void)
+    {
+        double meanIndex = 0.0, meanTime = 0.0;
+        double sxx = 0.0, sxy = 0.0;
+        double residual, worst = 0.0;
+        int64_t minIndex = m_sampleIndex[0], maxIndex = m_sampleIndex[0];
+        int i;
+
+        for (i = 0; i < m_numOfSample; i++) {
+            meanIndex += (double)m_sampleIndex[i];
+            meanTime += (double)m_sampleTime[i];
+            if (minIndex > m_sampleIndex[i])
+                minIndex = m_sampleIndex[i];
+            if (maxIndex < m_sampleIndex[i])
+                maxIndex = m_sampleIndex[i];
+        }
+        meanIndex /= m_numOfSample;
+        meanTime /= m_numOfSample;
+
+        for (i = 0; i < m_numOfSample; i++) {
+            double dx = (double)m_sampleIndex[i] - meanIndex;
+
+            sxx += dx * dx;
+            sxy += dx * ((double)m_sampleTime[i] - meanTime);
+        }
+
+        /* one distinct vsync : keep the reported period */
+        if (sxx > 0.0)
+            m_period = sxy / sxx;
+        else
+            m_period = (double)m_reportedPeriod;
+
+        m_phase = meanTime - m_period * meanIndex;
+
+        for (i = 0; i < m_numOfSample; i++) {
+            residual = fabs((double)m_sampleTime[i]
+                            - (m_phase + m_period * (double)m_sampleIndex[i]));
+            if (worst < residual)
+                worst = residual;
+        }
+
+        m_jitter = (int64_t)ceil(worst);
+        m_span = (int64_t)(m_period * (double)(maxIndex - minIndex));
+    }
+
+private:
+    int64_t     m_sampleIndex[VSYNC_MODEL_MAX_SAMPLES];
+    int64_t     m_sampleTime[VSYNC_MODEL_MAX_SAMPLES];  /* from m_baseTime */
+    int         m_numOfSample;
+    int         m_head;
+    int         m_numOfOutlier;
+    uint32_t    m_numOfReset;
+
+    int64_t     m_baseTime;
+    int64_t     m_reportedPeriod;
+    int64_t     m_lastSampleTime;
+    double      m_phase;    /* vsync(0) from m_baseTime */
+    double      m_period;
+    int64_t     m_jitter;
+    int64_t     m_span;     /* time covered by the samples */
+};
+
+}  // namespace android
+
+#endif  // SEC_CAMERA_VSYNC_MODEL_H_
@@ -178,6 +178,8 @@ ExynosCamera::ExynosCamera(int mainCameraId, __unused int subCameraId,  int scen
         case PIPE_GDC:
 #endif
             m_pipeFrameDoneQ[i] = new frame_queue_t;
+            /* pushed by every pipe thread per frame */
+            m_pipeFrameDoneQ[i]->setRingMode();
             break;
         default:
             m_pipeFrameDoneQ[i] = NULL;
@@ -968,6 +970,9 @@ void ExynosCamera::dump()
     }
     m_frameFactory[FRAME_FACTORY_TYPE_CAPTURE_PREVIEW]->dump();
     m_bufferSupplier->dump();
+
+    if (m_frameMgr != NULL)
+        m_frameMgr->dump();
 }
 
 int ExynosCamera::getCameraId() const
@@ -2503,9 +2508,11 @@ status_t ExynosCamera::m_setFrameManager()
 {
     sp<FrameWorker> worker;
 
-    m_frameMgr = new ExynosCameraFrameManager("FRAME MANAGER", m_cameraId, FRAMEMGR_OPER::SLIENT);
+    m_frameMgr = new ExynosCameraFrameManager("FRAME MANAGER", m_cameraId, FRAMEMGR_OPER::POOL);
 
-    worker = new CreateWorker("CREATE FRAME WORKER", m_cameraId, FRAMEMGR_OPER::SLIENT, 300, 200);
+    /* recycle frames, the bound is updated per stream configuration */
+    worker = new CreateWorker("CREATE FRAME WORKER", m_cameraId, FRAMEMGR_OPER::POOL,
+                              FRAME_POOL_SIZE_DEFAULT, FRAME_POOL_SIZE_DEFAULT / 2);
     m_frameMgr->setWorker(FRAMEMGR_WORKER::CREATE, worker);
 
     worker = new RunWorker("RUNNING FRAME WORKER", m_cameraId, FRAMEMGR_OPER::SLIENT, 100, 300);
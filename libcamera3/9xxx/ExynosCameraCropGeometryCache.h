@@ -0,0 +1,197 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EXYNOS_CAMERA_CROP_GEOMETRY_CACHE_H
+#define EXYNOS_CAMERA_CROP_GEOMETRY_CACHE_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace android {
+
+/* zoom ratios of the crop geometry cache, in getMaxZoomRatio() unit (x1000) */
+#define CROP_GEOMETRY_ZOOM_STEP     (100)
+#define CROP_GEOMETRY_MAX_ENTRY     (128)
+
+/*
+ * The crop chain of the centered crop regions of quantized zoom ratios,
+ * the table points. An entry is filled by its first lookup, and a new
+ * key drops every entry. A crop region between the table points has no
+ * entry. The owner serializes the calls.
+ *
+ * KEY is compared with memcmp(), it must be cleared before it is set.
+ * RECT has x, y, w and h.
+ */
+template <typename KEY, typename RECT, typename ENTRY>
+class ExynosCameraCropGeometryCache {
+public:
+    ExynosCameraCropGeometryCache()
+    {
+        memset(&m_key, 0x00, sizeof(m_key));
+        memset(m_state, STATE_EMPTY, sizeof(m_state));
+        m_valid = false;
+    }
+
+    void invalidate(void)
+    {
+        m_valid = false;
+    }
+
+    /* the number of table points up to maxZoomRatio, the last one may be off the step */
+    static int getNumOfEntry(int maxZoomRatio, int *step)
+    {
+        int numOfEntry = 0;
+
+        *step = CROP_GEOMETRY_ZOOM_STEP;
+
+        if (maxZoomRatio < 1000)
+            return 0;
+
+        if ((maxZoomRatio - 1000) / *step + 1 > CROP_GEOMETRY_MAX_ENTRY - 1)
+            *step = ((maxZoomRatio - 1000) + (CROP_GEOMETRY_MAX_ENTRY - 3)) / (CROP_GEOMETRY_MAX_ENTRY - 2);
+
+        numOfEntry = (maxZoomRatio - 1000) / *step + 1;
+        if ((numOfEntry - 1) * *step < maxZoomRatio - 1000)
+            numOfEntry++;
+
+        return numOfEntry;
+    }
+
+    static int getZoomRatio(int maxZoomRatio, int index)
+    {
+        int step = 0;
+        int zoomRatio;
+
+        getNumOfEntry(maxZoomRatio, &step);
+        zoomRatio = 1000 + index * step;
+
+        return (zoomRatio < maxZoomRatio) ? zoomRatio : maxZoomRatio;
+    }
+
+    /* the centered crop region of a zoom ratio, aligned as the request crop region */
+    static void getRegion(int zoomRatio, int maxSensorW, int maxSensorH, RECT *cropRegion)
+    {
+        cropRegion->w = m_alignUp2((int)ceil((float)maxSensorW * 1000.0f / (float)zoomRatio));
+        cropRegion->h = m_alignUp2((int)ceil((float)maxSensorH * 1000.0f / (float)zoomRatio));
+        if (cropRegion->w > maxSensorW)
+            cropRegion->w = maxSensorW;
+        if (cropRegion->h > maxSensorH)
+            cropRegion->h = maxSensorH;
+
+        cropRegion->x = m_alignDown2((maxSensorW - cropRegion->w) / 2);
+        cropRegion->y = m_alignDown2((maxSensorH - cropRegion->h) / 2);
+    }
+
+    /* the table point of cropRegion, -1 for a crop region between the table points */
+    static int getIndex(int maxZoomRatio, int maxSensorW, int maxSensorH, const RECT *cropRegion)
+    {
+        RECT region;
+        int step = 0;
+        int numOfEntry = getNumOfEntry(maxZoomRatio, &step);
+        int minZoomRatio, maxZoomRatioOfW;
+        int first, last;
+
+        if (numOfEntry <= 0 || cropRegion->w < 1 || cropRegion->h < 1)
+            return -1;
+
+        /*
+         * The aligned w is at most 2 over the exact one : the zoom ratio is in
+         * [maxSensorW / w, maxSensorW / (w - 2)), a few table points at a high zoom.
+         */
+        minZoomRatio = (int)(((int64_t)maxSensorW * 1000) / cropRegion->w);
+        maxZoomRatioOfW = (cropRegion->w > 2) ? (int)(((int64_t)maxSensorW * 1000) / (cropRegion->w - 2)) : maxZoomRatio;
+
+        first = (minZoomRatio - 1000) / step - 1;
+        last = (maxZoomRatioOfW - 1000) / step + 1;
+        if (first < 0)
+            first = 0;
+        if (last > numOfEntry - 1)
+            last = numOfEntry - 1;
+
+        for (int i = first; i <= last; i++) {
+            getRegion(getZoomRatio(maxZoomRatio, i), maxSensorW, maxSensorH, &region);
+            if (region.x == cropRegion->x && region.y == cropRegion->y
+                && region.w == cropRegion->w && region.h == cropRegion->h)
+                return i;
+        }
+
+        return -1;
+    }
+
+    /*
+     * The entry of index under key. An entry not filled yet for the key is
+     * filled by fill(index, entry), which returns false when the crop chain
+     * fails : a failed entry is not retried until the key changes.
+     */
+    template <typename FILL>
+    const ENTRY *get(const KEY *key, int index, FILL fill)
+    {
+        if (index < 0 || index >= CROP_GEOMETRY_MAX_ENTRY)
+            return NULL;
+
+        if (m_valid == false || memcmp(key, &m_key, sizeof(KEY)) != 0) {
+            m_key = *key;
+            memset(m_state, STATE_EMPTY, sizeof(m_state));
+            m_valid = true;
+        }
+
+        if (m_state[index] == STATE_EMPTY)
+            m_state[index] = (fill(index, &m_entry[index]) == true) ? STATE_FILLED : STATE_FAILED;
+
+        return (m_state[index] == STATE_FILLED) ? &m_entry[index] : NULL;
+    }
+
+    int getNumOfFilled(void) const
+    {
+        int num = 0;
+
+        if (m_valid == false)
+            return 0;
+
+        for (int i = 0; i < CROP_GEOMETRY_MAX_ENTRY; i++) {
+            if (m_state[i] != STATE_EMPTY)
+                num++;
+        }
+
+        return num;
+    }
+
+private:
+    enum {
+        STATE_EMPTY,
+        STATE_FILLED,
+        STATE_FAILED,
+    };
+
+    static int m_alignUp2(int x)
+    {
+        return (x + 1) & ~1;
+    }
+
+    static int m_alignDown2(int x)
+    {
+        return x & ~1;
+    }
+
+    ENTRY       m_entry[CROP_GEOMETRY_MAX_ENTRY];
+    uint8_t     m_state[CROP_GEOMETRY_MAX_ENTRY];
+    KEY         m_key;
+    bool        m_valid;
+};
+
+}; /* namespace android */
+#endif
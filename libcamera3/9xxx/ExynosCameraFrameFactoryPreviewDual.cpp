@@ -1808,6 +1808,19 @@ status_t ExynosCameraFrameFactoryPreviewDual::m_initPipes(uint32_t frameRate)
                 /* TODO: exception handling */
                 return INVALID_OPERATION;
             }
+
+#ifdef USE_SW_PIPE_TASK_EXECUTOR
+            /* the fusion of both cameras runs on the shared task executor */
+            camera_pipe_info_t fusionPipeInfo[MAX_NODE];
+
+            fusionPipeInfo[0].useTaskExecutor = true;
+            ret = m_pipes[PIPE_FUSION]->setupPipe(fusionPipeInfo, m_sensorIds[PIPE_FUSION]);
+            if (ret != NO_ERROR) {
+                CLOGE("Fusion setupPipe(useTaskExecutor) fail, ret(%d)", ret);
+                /* TODO: exception handling */
+                return INVALID_OPERATION;
+            }
+#endif
         }
     }
 #endif
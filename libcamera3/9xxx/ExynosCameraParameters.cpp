@@ -87,6 +87,12 @@ ExynosCameraParameters::ExynosCameraParameters(int cameraId, int scenario,
     m_previewDsInputPortId = MCSC_PORT_NONE;
     m_captureDsInputPortId = MCSC_PORT_NONE;
 
+    m_cropGeometryFill.tid.store(0);
+    m_cropGeometryCheck.tid.store(0);
+#ifdef DEBUG_CROP_GEOMETRY
+    m_cropGeometryChecked.store(false);
+#endif
+
     vendorSpecificConstructor(m_cameraId);
 
 #ifdef USE_DUAL_CAMERA
@@ -948,6 +954,16 @@ bool ExynosCameraParameters::m_isSupportedPictureSize(const int width,
 void ExynosCameraParameters::m_setHwBayerCropRegion(int w, int h, int x, int y)
 {
     Mutex::Autolock lock(m_parameterLock);
+    crop_geometry_override_t *cropGeometryOverride = m_getCropGeometryOverride();
+
+    /* the crop geometry cache does not touch the current one */
+    if (cropGeometryOverride != NULL) {
+        cropGeometryOverride->hwBayerCrop.w = w;
+        cropGeometryOverride->hwBayerCrop.h = h;
+        cropGeometryOverride->hwBayerCrop.x = x;
+        cropGeometryOverride->hwBayerCrop.y = y;
+        return;
+    }
 
     m_cameraInfo.hwBayerCropW = w;
     m_cameraInfo.hwBayerCropH = h;
@@ -958,6 +974,15 @@ void ExynosCameraParameters::m_setHwBayerCropRegion(int w, int h, int x, int y)
 void ExynosCameraParameters::getHwBayerCropRegion(int *w, int *h, int *x, int *y)
 {
     Mutex::Autolock lock(m_parameterLock);
+    crop_geometry_override_t *cropGeometryOverride = m_getCropGeometryOverride();
+
+    if (cropGeometryOverride != NULL) {
+        *w = cropGeometryOverride->hwBayerCrop.w;
+        *h = cropGeometryOverride->hwBayerCrop.h;
+        *x = cropGeometryOverride->hwBayerCrop.x;
+        *y = cropGeometryOverride->hwBayerCrop.y;
+        return;
+    }
 
     *w = m_cameraInfo.hwBayerCropW;
     *h = m_cameraInfo.hwBayerCropH;
@@ -1067,6 +1092,17 @@ status_t ExynosCameraParameters::setCropRegion(int x, int y, int w, int h)
 
 void ExynosCameraParameters::m_getCropRegion(int *x, int *y, int *w, int *h)
 {
+    crop_geometry_override_t *cropGeometryOverride = m_getCropGeometryOverride();
+
+    /* the crop geometry cache is built and checked for its own crop regions */
+    if (cropGeometryOverride != NULL) {
+        *x = cropGeometryOverride->cropRegion.x;
+        *y = cropGeometryOverride->cropRegion.y;
+        *w = cropGeometryOverride->cropRegion.w;
+        *h = cropGeometryOverride->cropRegion.h;
+        return;
+    }
+
     getMetaCtlCropRegion(&m_metadata, x, y, w, h);
 }
 
@@ -1344,6 +1380,8 @@ status_t ExynosCameraParameters::reInit(void)
 
     m_vendorReInit();
 
+    invalidateCropGeometry();
+
     return ret;
 }
 
@@ -1963,6 +2001,10 @@ status_t ExynosCameraParameters::getPreviewBayerCropSize(ExynosRect *srcRect, Ex
     int hwSensorMarginW = 0;
     int hwSensorMarginH = 0;
 
+    if (applyZoom == true
+        && m_getCropGeometry(CROP_GEOMETRY_PREVIEW_BAYER_CROP, srcRect, dstRect) == true)
+        return NO_ERROR;
+
     /* matched ratio LUT is not existed, use equation */
     if (m_useSizeTable == false
         || m_getPreviewSizeList(sizeList) != NO_ERROR)
@@ -2493,6 +2535,10 @@ status_t ExynosCameraParameters::getPreviewBdsSize(ExynosRect *dstRect, bool app
     ExynosRect bayerCropSize;
     ExynosRect bdsSize;
 
+    if (applyZoom == true
+        && m_getCropGeometry(CROP_GEOMETRY_PREVIEW_BDS, NULL, dstRect) == true)
+        return NO_ERROR;
+
     ret = m_getPreviewBdsSize(&bdsSize);
     if (ret != NO_ERROR) {
         CLOGE("Failed to m_getPreviewBdsSize()");
@@ -2618,6 +2664,9 @@ status_t ExynosCameraParameters::getPictureBdsSize(ExynosRect *dstRect)
     int hwBdsH = 0;
     int sizeList[SIZE_LUT_INDEX_END];
 
+    if (m_getCropGeometry(CROP_GEOMETRY_PICTURE_BDS, NULL, dstRect) == true)
+        return NO_ERROR;
+
     /* matched ratio LUT is not existed, use equation */
     if (m_useSizeTable == false
         || m_getPictureSizeList(sizeList) != NO_ERROR) {
@@ -2669,6 +2718,9 @@ status_t ExynosCameraParameters::getPreviewYuvCropSize(ExynosRect *yuvCropSize)
         return BAD_VALUE;
     }
 
+    if (m_getCropGeometry(CROP_GEOMETRY_PREVIEW_YUV_CROP, NULL, yuvCropSize) == true)
+        return NO_ERROR;
+
     /* 2. Get the BDS info & Zoom info */
     ret = this->getPreviewBdsSize(&previewBdsSize);
     if (ret != NO_ERROR) {
@@ -2754,6 +2806,9 @@ status_t ExynosCameraParameters::getPictureYuvCropSize(ExynosRect *yuvCropSize)
         return BAD_VALUE;
     }
 
+    if (m_getCropGeometry(CROP_GEOMETRY_PICTURE_YUV_CROP, NULL, yuvCropSize) == true)
+        return NO_ERROR;
+
     /* 2. Get the ISP input info & Zoom info */
     if (this->getUsePureBayerReprocessing() == true) {
         ret = this->getPictureBdsSize(&pictureBdsSize);
@@ -2829,6 +2884,339 @@ status_t ExynosCameraParameters::getPictureYuvCropSize(ExynosRect *yuvCropSize)
 }
 
 
+static bool isSameRect(const ExynosRect *rect1, const ExynosRect *rect2)
+{
+    return (rect1->x == rect2->x && rect1->y == rect2->y
+            && rect1->w == rect2->w && rect1->h == rect2->h
+            && rect1->fullW == rect2->fullW && rect1->fullH == rect2->fullH
+            && rect1->colorFormat == rect2->colorFormat);
+}
+
+void ExynosCameraParameters::invalidateCropGeometry(void)
+{
+    Mutex::Autolock lock(m_cropGeometryLock);
+
+    m_cropGeometry.invalidate();
+#ifdef DEBUG_CROP_GEOMETRY
+    m_cropGeometryChecked.store(false);
+#endif
+}
+
+status_t ExynosCameraParameters::checkCropGeometry(void)
+{
+    Mutex::Autolock lock(m_cropGeometryCheckLock);
+    status_t ret = NO_ERROR;
+    ExynosRect cropRegion;
+    int maxZoomRatio = (int)getMaxZoomRatio();
+    int zoomStep = CROP_GEOMETRY_ZOOM_STEP / 2;
+    int numOfRegion = 0, numOfFail = 0;
+
+    if (m_useSizeTable == false) {
+        CLOGW("Size table is not used");
+        return NO_ERROR;
+    }
+
+    /* the table points and the crop regions between them */
+    for (int zoomRatio = 1000; zoomRatio < maxZoomRatio + zoomStep; zoomRatio += zoomStep) {
+        m_getCropGeometryRegion(MIN(zoomRatio, maxZoomRatio), &cropRegion);
+
+        if (m_checkCropGeometry(&cropRegion) != NO_ERROR) {
+            CLOGE("ratioId(%d/%d) zoomRatio(%d) cropRegion %d,%d %dx%d : mismatch",
+                    m_cameraInfo.yuvSizeRatioId, m_cameraInfo.pictureSizeRatioId, zoomRatio,
+                    cropRegion.x, cropRegion.y, cropRegion.w, cropRegion.h);
+            numOfFail++;
+        }
+        numOfRegion++;
+    }
+
+    if (numOfFail > 0)
+        ret = INVALID_OPERATION;
+
+    CLOGI("%d crop regions, %d mismatches", numOfRegion, numOfFail);
+
+    return ret;
+}
+
+/* the override of the calling thread, the table point being filled first */
+crop_geometry_override_t *ExynosCameraParameters::m_getCropGeometryOverride(void)
+{
+    pid_t tid = gettid();
+
+    if (m_cropGeometryFill.tid.load() == tid)
+        return &m_cropGeometryFill;
+
+    if (m_cropGeometryCheck.tid.load() == tid)
+        return &m_cropGeometryCheck;
+
+    return NULL;
+}
+
+bool ExynosCameraParameters::m_getCropGeometry(enum CROP_GEOMETRY_TYPE type, ExynosRect *srcRect, ExynosRect *dstRect)
+{
+    crop_geometry_key_t key;
+    const crop_geometry_t *geometry = NULL;
+    ExynosRect cropRegion;
+    ExynosRect hwBayerCrop;
+    int maxSensorW = 0, maxSensorH = 0;
+    int maxZoomRatio = 0, index = -1;
+    crop_geometry_override_t *cropGeometryOverride = m_getCropGeometryOverride();
+
+    /* the cache is filled and checked by the direct calculation */
+    if (cropGeometryOverride != NULL && cropGeometryOverride->direct == true)
+        return false;
+
+    if (m_useSizeTable == false)
+        return false;
+
+#ifdef DEBUG_CROP_GEOMETRY
+    if (cropGeometryOverride == NULL && m_cropGeometryChecked.exchange(true) == false) {
+        checkCropGeometry();
+        return false;
+    }
+#endif
+
+    /* a crop region between the table points does not need the key */
+    m_getCropRegion(&cropRegion.x, &cropRegion.y, &cropRegion.w, &cropRegion.h);
+    getSize(HW_INFO_MAX_SENSOR_SIZE, (uint32_t *)&maxSensorW, (uint32_t *)&maxSensorH);
+    maxZoomRatio = (int)getMaxZoomRatio();
+
+    index = crop_geometry_cache_t::getIndex(maxZoomRatio, maxSensorW, maxSensorH, &cropRegion);
+    if (index < 0)
+        return false;
+
+    m_getCropGeometryKey(&key);
+
+    Mutex::Autolock lock(m_cropGeometryLock);
+
+    geometry = m_cropGeometry.get(&key, index,
+                                  [this, maxZoomRatio](int i, crop_geometry_t *entry) {
+                                      return m_fillCropGeometry(crop_geometry_cache_t::getZoomRatio(maxZoomRatio, i), entry);
+                                  });
+    if (geometry == NULL)
+        return false;
+
+    switch (type) {
+    case CROP_GEOMETRY_PREVIEW_BAYER_CROP:
+        *srcRect = geometry->previewBnsSize;
+        *dstRect = geometry->previewBayerCropSize;
+        break;
+    case CROP_GEOMETRY_PREVIEW_BDS:
+        *dstRect = geometry->previewBdsSize;
+        break;
+    case CROP_GEOMETRY_PREVIEW_YUV_CROP:
+        *dstRect = geometry->previewYuvCropSize;
+        break;
+    case CROP_GEOMETRY_PICTURE_BAYER_CROP:
+    case CROP_GEOMETRY_PICTURE_BDS:
+    case CROP_GEOMETRY_PICTURE_YUV_CROP:
+        /* the picture crop may follow the HW bayer crop of the preview */
+        getHwBayerCropRegion(&hwBayerCrop.w, &hwBayerCrop.h, &hwBayerCrop.x, &hwBayerCrop.y);
+        if (hwBayerCrop.x != geometry->previewBayerCropSize.x
+            || hwBayerCrop.y != geometry->previewBayerCropSize.y
+            || hwBayerCrop.w != geometry->previewBayerCropSize.w
+            || hwBayerCrop.h != geometry->previewBayerCropSize.h)
+            return false;
+
+        if (type == CROP_GEOMETRY_PICTURE_BAYER_CROP) {
+            *srcRect = geometry->pictureBnsSize;
+            *dstRect = geometry->pictureBayerCropSize;
+        } else if (type == CROP_GEOMETRY_PICTURE_BDS) {
+            *dstRect = geometry->pictureBdsSize;
+        } else {
+            *dstRect = geometry->pictureYuvCropSize;
+        }
+        return true;
+    default:
+        return false;
+    }
+
+    /* the preview crop chain sets the HW bayer crop region */
+    m_setHwBayerCropRegion(geometry->previewBayerCropSize.w, geometry->previewBayerCropSize.h,
+                           geometry->previewBayerCropSize.x, geometry->previewBayerCropSize.y);
+
+    return true;
+}
+
+void ExynosCameraParameters::m_getCropGeometryKey(crop_geometry_key_t *key)
+{
+    memset(key, 0x00, sizeof(crop_geometry_key_t));
+
+    m_configurations->getSize(CONFIGURATION_PREVIEW_SIZE, &key->previewW, &key->previewH);
+    m_configurations->getSize(CONFIGURATION_PICTURE_SIZE, &key->pictureW, &key->pictureH);
+    m_configurations->getSize(CONFIGURATION_VIDEO_SIZE, &key->videoW, &key->videoH);
+    key->configMode = m_configurations->getConfigMode();
+    key->binningRatio = m_configurations->getModeValue(CONFIGURATION_BINNING_RATIO);
+    key->maxZoomRatio = (int)getMaxZoomRatio();
+    getSize(HW_INFO_MAX_SENSOR_SIZE, (uint32_t *)&key->maxSensorW, (uint32_t *)&key->maxSensorH);
+    key->yuvSizeRatioId = m_cameraInfo.yuvSizeRatioId;
+    key->pictureSizeRatioId = m_cameraInfo.pictureSizeRatioId;
+    key->previewBayerFormat = getBayerFormat(PIPE_3AA);
+    key->pictureBayerFormat = getBayerFormat(PIPE_3AA_REPROCESSING);
+#ifdef DEBUG_RAWDUMP
+    if (m_configurations->checkBayerDumpEnable()) {
+        key->previewBayerFormat = CAMERA_DUMP_BAYER_FORMAT;
+        key->pictureBayerFormat = CAMERA_DUMP_BAYER_FORMAT;
+    }
+#endif
+#ifdef USE_BINNING_MODE
+    key->binningMode = getBinningMode();
+#endif
+    key->samsungCamera = m_configurations->getSamsungCamera();
+    key->pipMode = m_configurations->getMode(CONFIGURATION_PIP_MODE);
+    key->recordingMode = m_configurations->getMode(CONFIGURATION_RECORDING_MODE);
+    key->hwVdisMode = getHWVdisMode();
+    key->videoStreamExist = isVideoStreamExist();
+    key->pureBayerReprocessing = getUsePureBayerReprocessing();
+#ifdef SAMSUNG_HIFI_CAPTURE
+    key->hifiCaptureMode = m_configurations->getDynamicMode(DYNAMIC_HIFI_CAPTURE_MODE);
+    key->reprocessingBayerMode = getReprocessingBayerMode();
+#endif
+}
+
+/* the centered crop region of a zoom ratio, aligned as the request crop region */
+void ExynosCameraParameters::m_getCropGeometryRegion(int zoomRatio, ExynosRect *cropRegion)
+{
+    int maxSensorW = 0, maxSensorH = 0;
+
+    getSize(HW_INFO_MAX_SENSOR_SIZE, (uint32_t *)&maxSensorW, (uint32_t *)&maxSensorH);
+
+    crop_geometry_cache_t::getRegion(zoomRatio, maxSensorW, maxSensorH, cropRegion);
+}
+
+/* m_cropGeometryLock is held : the crop chain of one table point */
+bool ExynosCameraParameters::m_fillCropGeometry(int zoomRatio, crop_geometry_t *geometry)
+{
+    status_t ret;
+
+    m_getCropGeometryRegion(zoomRatio, &geometry->cropRegion);
+
+    /* from the HW bayer crop region of the caller, a checked one included */
+    getHwBayerCropRegion(&m_cropGeometryFill.hwBayerCrop.w, &m_cropGeometryFill.hwBayerCrop.h,
+                         &m_cropGeometryFill.hwBayerCrop.x, &m_cropGeometryFill.hwBayerCrop.y);
+    m_cropGeometryFill.cropRegion = geometry->cropRegion;
+    m_cropGeometryFill.direct = true;
+    m_cropGeometryFill.tid.store(gettid());
+
+    ret = m_calcCropGeometry(geometry);
+
+    m_cropGeometryFill.tid.store(0);
+
+    if (ret != NO_ERROR) {
+        CLOGW("zoomRatio(%d) cropRegion %d,%d %dx%d : ret(%d), calculated directly",
+                zoomRatio, geometry->cropRegion.x, geometry->cropRegion.y,
+                geometry->cropRegion.w, geometry->cropRegion.h, ret);
+        return false;
+    }
+
+    return true;
+}
+
+status_t ExynosCameraParameters::m_calcCropGeometry(crop_geometry_t *geometry)
+{
+    status_t ret = NO_ERROR;
+
+    /* preview first : the processed bayer picture crop follows the preview HW bayer crop */
+    ret = getPreviewBayerCropSize(&geometry->previewBnsSize, &geometry->previewBayerCropSize);
+    if (ret == NO_ERROR)
+        ret = getPreviewBdsSize(&geometry->previewBdsSize);
+    if (ret == NO_ERROR)
+        ret = getPreviewYuvCropSize(&geometry->previewYuvCropSize);
+    if (ret == NO_ERROR)
+        ret = getPictureBayerCropSize(&geometry->pictureBnsSize, &geometry->pictureBayerCropSize);
+    if (ret == NO_ERROR)
+        ret = getPictureBdsSize(&geometry->pictureBdsSize);
+    if (ret == NO_ERROR)
+        ret = getPictureYuvCropSize(&geometry->pictureYuvCropSize);
+
+    return ret;
+}
+
+/* m_cropGeometryCheckLock is held : compares the cache with the direct calculation for cropRegion */
+status_t ExynosCameraParameters::m_checkCropGeometry(const ExynosRect *cropRegion)
+{
+    status_t ret = NO_ERROR;
+    crop_geometry_t cached;
+    crop_geometry_t direct;
+    ExynosRect hwBayerCrop;
+    status_t cachedRet, directRet;
+
+    /* both from the current HW bayer crop region, which they do not change */
+    getHwBayerCropRegion(&hwBayerCrop.w, &hwBayerCrop.h, &hwBayerCrop.x, &hwBayerCrop.y);
+
+    m_cropGeometryCheck.cropRegion = *cropRegion;
+    m_cropGeometryCheck.hwBayerCrop = hwBayerCrop;
+    m_cropGeometryCheck.direct = false;
+    m_cropGeometryCheck.tid.store(gettid());
+
+    cachedRet = m_calcCropGeometry(&cached);
+
+    m_cropGeometryCheck.hwBayerCrop = hwBayerCrop;
+    m_cropGeometryCheck.direct = true;
+
+    directRet = m_calcCropGeometry(&direct);
+
+    m_cropGeometryCheck.tid.store(0);
+
+    if (cachedRet != directRet) {
+        CLOGE("ret cached(%d) direct(%d)", cachedRet, directRet);
+        return INVALID_OPERATION;
+    }
+
+    if (isSameRect(&cached.previewBnsSize, &direct.previewBnsSize) == false
+        || isSameRect(&cached.previewBayerCropSize, &direct.previewBayerCropSize) == false) {
+        CLOGE("previewBayerCrop cached %d,%d %dx%d direct %d,%d %dx%d",
+                cached.previewBayerCropSize.x, cached.previewBayerCropSize.y,
+                cached.previewBayerCropSize.w, cached.previewBayerCropSize.h,
+                direct.previewBayerCropSize.x, direct.previewBayerCropSize.y,
+                direct.previewBayerCropSize.w, direct.previewBayerCropSize.h);
+        ret = INVALID_OPERATION;
+    }
+
+    if (isSameRect(&cached.previewBdsSize, &direct.previewBdsSize) == false) {
+        CLOGE("previewBds cached %dx%d direct %dx%d",
+                cached.previewBdsSize.w, cached.previewBdsSize.h,
+                direct.previewBdsSize.w, direct.previewBdsSize.h);
+        ret = INVALID_OPERATION;
+    }
+
+    if (isSameRect(&cached.previewYuvCropSize, &direct.previewYuvCropSize) == false) {
+        CLOGE("previewYuvCrop cached %d,%d %dx%d direct %d,%d %dx%d",
+                cached.previewYuvCropSize.x, cached.previewYuvCropSize.y,
+                cached.previewYuvCropSize.w, cached.previewYuvCropSize.h,
+                direct.previewYuvCropSize.x, direct.previewYuvCropSize.y,
+                direct.previewYuvCropSize.w, direct.previewYuvCropSize.h);
+        ret = INVALID_OPERATION;
+    }
+
+    if (isSameRect(&cached.pictureBnsSize, &direct.pictureBnsSize) == false
+        || isSameRect(&cached.pictureBayerCropSize, &direct.pictureBayerCropSize) == false) {
+        CLOGE("pictureBayerCrop cached %d,%d %dx%d direct %d,%d %dx%d",
+                cached.pictureBayerCropSize.x, cached.pictureBayerCropSize.y,
+                cached.pictureBayerCropSize.w, cached.pictureBayerCropSize.h,
+                direct.pictureBayerCropSize.x, direct.pictureBayerCropSize.y,
+                direct.pictureBayerCropSize.w, direct.pictureBayerCropSize.h);
+        ret = INVALID_OPERATION;
+    }
+
+    if (isSameRect(&cached.pictureBdsSize, &direct.pictureBdsSize) == false) {
+        CLOGE("pictureBds cached %dx%d direct %dx%d",
+                cached.pictureBdsSize.w, cached.pictureBdsSize.h,
+                direct.pictureBdsSize.w, direct.pictureBdsSize.h);
+        ret = INVALID_OPERATION;
+    }
+
+    if (isSameRect(&cached.pictureYuvCropSize, &direct.pictureYuvCropSize) == false) {
+        CLOGE("pictureYuvCrop cached %d,%d %dx%d direct %d,%d %dx%d",
+                cached.pictureYuvCropSize.x, cached.pictureYuvCropSize.y,
+                cached.pictureYuvCropSize.w, cached.pictureYuvCropSize.h,
+                direct.pictureYuvCropSize.x, direct.pictureYuvCropSize.y,
+                direct.pictureYuvCropSize.w, direct.pictureYuvCropSize.h);
+        ret = INVALID_OPERATION;
+    }
+
+    return ret;
+}
+
 status_t ExynosCameraParameters::getFastenAeStableSensorSize(int *hwSensorW, int *hwSensorH, int index)
 {
     *hwSensorW = m_staticInfo->fastAeStableLut[index][SENSOR_W];
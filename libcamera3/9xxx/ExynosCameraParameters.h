@@ -28,6 +28,7 @@
 #include <videodev2_exynos_media.h>
 #include <videodev2_exynos_camera.h>
 #include <map>
+#include <atomic>
 
 #ifdef USE_CSC_FEATURE
 #include <SecNativeFeature.h>
@@ -45,6 +46,7 @@
 #include "ExynosCameraActivityControl.h"
 #include "ExynosCameraAutoTimer.h"
 #include "ExynosCameraConfigurations.h"
+#include "ExynosCameraCropGeometryCache.h"
 
 #ifdef SAMSUNG_TN_FEATURE
 #include "SecCameraParameters.h"
@@ -179,6 +181,69 @@ enum SUPPORTED_HW_FUNCTION_TYPE {
     SUPPORTED_HW_FUNCTION_MAX,
 };
 
+/* #define DEBUG_CROP_GEOMETRY */
+
+enum CROP_GEOMETRY_TYPE {
+    CROP_GEOMETRY_PREVIEW_BAYER_CROP,
+    CROP_GEOMETRY_PREVIEW_BDS,
+    CROP_GEOMETRY_PREVIEW_YUV_CROP,
+    CROP_GEOMETRY_PICTURE_BAYER_CROP,
+    CROP_GEOMETRY_PICTURE_BDS,
+    CROP_GEOMETRY_PICTURE_YUV_CROP,
+    CROP_GEOMETRY_TYPE_MAX,
+};
+
+/* the crop chain of one crop region, as the get*Size() functions return it */
+typedef struct crop_geometry {
+    ExynosRect  cropRegion;
+    ExynosRect  previewBnsSize;
+    ExynosRect  previewBayerCropSize;
+    ExynosRect  previewBdsSize;
+    ExynosRect  previewYuvCropSize;
+    ExynosRect  pictureBnsSize;
+    ExynosRect  pictureBayerCropSize;
+    ExynosRect  pictureBdsSize;
+    ExynosRect  pictureYuvCropSize;
+} crop_geometry_t;
+
+/* the configuration inputs of the crop chain that setSize() does not cover */
+typedef struct crop_geometry_key {
+    uint32_t    previewW, previewH;
+    uint32_t    pictureW, pictureH;
+    uint32_t    videoW, videoH;
+    int         configMode;
+    int         binningRatio;
+    int         maxZoomRatio;
+    int         maxSensorW, maxSensorH;
+    int         yuvSizeRatioId;
+    int         pictureSizeRatioId;
+    int         previewBayerFormat;
+    int         pictureBayerFormat;
+    int         reprocessingBayerMode;
+    int         binningMode;
+    bool        samsungCamera;
+    bool        pipMode;
+    bool        recordingMode;
+    bool        hwVdisMode;
+    bool        videoStreamExist;
+    bool        pureBayerReprocessing;
+    bool        hifiCaptureMode;
+} crop_geometry_key_t;
+
+typedef ExynosCameraCropGeometryCache<crop_geometry_key_t, ExynosRect, crop_geometry_t> crop_geometry_cache_t;
+
+/*
+ * The crop region and the HW bayer crop region one thread calculates the
+ * crop chain with, instead of the current ones. Only tid is read by the
+ * other threads.
+ */
+typedef struct crop_geometry_override {
+    std::atomic<pid_t>  tid;
+    bool                direct;     /* the cache is not looked up */
+    ExynosRect          cropRegion;
+    ExynosRect          hwBayerCrop;
+} crop_geometry_override_t;
+
 typedef enum DUAL_STANDBY_STATE {
     DUAL_STANDBY_STATE_ON,
     DUAL_STANDBY_STATE_ON_READY,
@@ -265,6 +330,13 @@ public:
     status_t        calcPreviewBDSSize(ExynosRect *srcRect, ExynosRect *dstRect);
     status_t        calcPictureBDSSize(ExynosRect *srcRect, ExynosRect *dstRect);
 
+    /* Drops the crop geometry cache. It is rebuilt on the next lookup. */
+    void            invalidateCropGeometry(void);
+    /* Compares the crop geometry cache with the direct calculation
+       over the whole zoom range, for the current configuration.
+       The crop region and the HW bayer crop region are not changed. */
+    status_t        checkCropGeometry(void);
+
 private:
     /* Sets the image format for preview-related HW. */
     void            m_setHwPreviewFormat(int colorFormat);
@@ -420,6 +492,15 @@ private:
     void            m_getSetfileYuvRange(bool flagReprocessing, int *setfile, int *yuvRange);
     void            m_getCropRegion(int *x, int *y, int *w, int *h);
 
+    /* Crop geometry cache */
+    bool            m_getCropGeometry(enum CROP_GEOMETRY_TYPE type, ExynosRect *srcRect, ExynosRect *dstRect);
+    crop_geometry_override_t *m_getCropGeometryOverride(void);
+    void            m_getCropGeometryKey(crop_geometry_key_t *key);
+    void            m_getCropGeometryRegion(int zoomRatio, ExynosRect *cropRegion);
+    bool            m_fillCropGeometry(int zoomRatio, crop_geometry_t *geometry);
+    status_t        m_calcCropGeometry(crop_geometry_t *geometry);
+    status_t        m_checkCropGeometry(const ExynosRect *cropRegion);
+
     void            m_setExifChangedAttribute(exif_attribute_t    *exifInfo,
                                               ExynosRect          *PictureRect,
                                               ExynosRect          *thumbnailRect,
@@ -622,6 +703,22 @@ private:
     float                       m_activeZoomRatio;
     int                         m_activeZoomMargin;
 
+    /*
+     * Crop geometry cache : the crop chain of each quantized zoom ratio
+     * for the current configuration, filled on demand. A crop region
+     * between the table points is calculated directly.
+     */
+    crop_geometry_cache_t       m_cropGeometry;
+    mutable Mutex               m_cropGeometryLock;
+    /* the table point being filled, under m_cropGeometryLock */
+    crop_geometry_override_t    m_cropGeometryFill;
+    /* the crop region being checked, under m_cropGeometryCheckLock */
+    crop_geometry_override_t    m_cropGeometryCheck;
+    mutable Mutex               m_cropGeometryCheckLock;
+#ifdef DEBUG_CROP_GEOMETRY
+    std::atomic<bool>           m_cropGeometryChecked;
+#endif
+
 /* Vedor specific API */
 private:
     status_t        m_vendorReInit(void);
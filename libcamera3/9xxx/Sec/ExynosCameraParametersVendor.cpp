@@ -139,6 +139,8 @@ status_t ExynosCameraParameters::setSize(enum HW_INFO_SIZE_TYPE type, uint32_t w
         break;
     }
 
+    invalidateCropGeometry();
+
     return ret;
 }
 
@@ -249,6 +251,8 @@ status_t ExynosCameraParameters::resetSize(enum HW_INFO_SIZE_TYPE type)
         break;
     }
 
+    invalidateCropGeometry();
+
     return ret;
 }
 
@@ -489,6 +493,9 @@ status_t ExynosCameraParameters::getPictureBayerCropSize(ExynosRect *srcRect, Ex
     int hwSensorMarginH = 0;
     int sizeList[SIZE_LUT_INDEX_END];
 
+    if (m_getCropGeometry(CROP_GEOMETRY_PICTURE_BAYER_CROP, srcRect, dstRect) == true)
+        return NO_ERROR;
+
     /* matched ratio LUT is not existed, use equation */
     if (m_useSizeTable == false
         || m_getPictureSizeList(sizeList) != NO_ERROR
@@ -5427,6 +5427,12 @@ status_t ExynosCamera::configureStreams(camera3_stream_configuration *stream_lis
         return ret;
     }
 
+    /* high speed modes keep more frames in flight */
+    if (m_configurations->getConfigMode() >= CONFIG_MODE::HIGHSPEED_120)
+        m_frameMgr->setPoolSize(FRAME_POOL_SIZE_HIGHSPEED);
+    else
+        m_frameMgr->setPoolSize(FRAME_POOL_SIZE_DEFAULT);
+
     /* The setting is effective if USE_BDS_OFF is enabled */
     if (m_parameters[m_cameraId]->isUse3aaBDSOff()) {
         m_parameters[m_cameraId]->setVideoStreamExistStatus(m_videoStreamExist);
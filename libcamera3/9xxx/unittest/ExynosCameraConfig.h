@@ -0,0 +1,26 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The device configuration comes with the board. The size tables and the
+ * parameters only read optional feature flags from it : none is set here,
+ * the test sees the default tables and crop chain.
+ */
+
+#ifndef EXYNOS_CAMERA_CONFIG_H
+#define EXYNOS_CAMERA_CONFIG_H
+
+#endif
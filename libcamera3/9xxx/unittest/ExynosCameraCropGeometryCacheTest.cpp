@@ -0,0 +1,474 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ExynosCameraParameters crop geometry cache against every size table.
+ * For every row of every LUT of the SizeTables headers, the parameters of
+ * a sensor with that LUT are configured for the ratio of the row through
+ * the same setters as a stream configuration. checkCropGeometry() then
+ * compares the cache with the direct calculation of the real get*Size()
+ * functions over the whole zoom range, and must leave the crop region,
+ * the HW bayer crop region and what the getters return as they were.
+ */
+
+#include <stdio.h>
+
+#include <gtest/gtest.h>
+
+#include "ExynosCameraConfigurations.h"
+#include "ExynosCameraParameters.h"
+
+/* the headers ExynosCameraSizeTable.h does not include, the two IMX240 ones share the guard */
+namespace android {
+namespace lut_4e6 {
+#include "ExynosCameraSizeTable4E6.h"
+}
+namespace lut_5e6 {
+#include "ExynosCameraSizeTable5E6.h"
+}
+namespace lut_imx240_fhd {
+#include "ExynosCameraSizeTableIMX240_2P2_FHD.h"
+}
+#undef EXYNOS_CAMERA_LUT_IMX240_2P2_H
+namespace lut_imx240_wqhd {
+#include "ExynosCameraSizeTableIMX240_2P2_WQHD.h"
+}
+}; /* namespace android */
+
+using namespace android;
+
+#define TEST_MAX_TABLE      (32)
+#define TEST_MAX_ROW        (32)
+
+struct TestKey {
+    const int  *previewLut;
+    int         maxZoomRatio;
+    int         maxSensorW, maxSensorH;
+};
+
+struct TestEntry {
+    ExynosRect  cropRegion;
+    int         index;
+};
+
+typedef ExynosCameraCropGeometryCache<TestKey, ExynosRect, TestEntry> TestCache;
+
+struct TestTable {
+    const char *name;
+    int       (*lut)[SIZE_OF_LUT];
+    int         numOfRow;
+};
+
+struct TestSensor {
+    const char *name;
+    TestTable   picture;
+    TestTable   tables[TEST_MAX_TABLE];
+};
+
+#define TABLE(lut) { #lut, lut, (int)(sizeof(lut) / sizeof(lut[0])) }
+
+static const TestSensor testSensors[] = {
+    { "2L7", TABLE(PICTURE_SIZE_LUT_S5K2L7), {
+        TABLE(PREVIEW_SIZE_LUT_S5K2L7), TABLE(PREVIEW_SIZE_LUT_S5K2L7_BNS),
+        TABLE(PICTURE_SIZE_LUT_S5K2L7), TABLE(VIDEO_SIZE_LUT_S5K2L7),
+        TABLE(VIDEO_SIZE_LUT_120FPS_HIGH_SPEED_S5K2L7), TABLE(VIDEO_SIZE_LUT_240FPS_HIGH_SPEED_S5K2L7),
+        TABLE(VTCALL_SIZE_LUT_S5K2L7), TABLE(FAST_AE_STABLE_SIZE_LUT_S5K2L7),
+        TABLE(PREVIEW_FULL_SIZE_LUT_S5K2L7), TABLE(PICTURE_FULL_SIZE_LUT_S5K2L7) } },
+    { "2P8", TABLE(PICTURE_SIZE_LUT_2P8), {
+        TABLE(PREVIEW_SIZE_LUT_2P8), TABLE(PREVIEW_SIZE_LUT_2P8_BDS),
+        TABLE(PREVIEW_SIZE_LUT_2P8_BDS_BNS15), TABLE(PREVIEW_SIZE_LUT_2P8_BDS_BNS20_WQHD),
+        TABLE(PREVIEW_SIZE_LUT_2P8_BDS_BNS20_FHD), TABLE(PICTURE_SIZE_LUT_2P8),
+        TABLE(VIDEO_SIZE_LUT_2P8_WQHD), TABLE(VIDEO_SIZE_LUT_2P8_BDS_WQHD),
+        TABLE(VIDEO_SIZE_LUT_2P8_BDS_DIS_WQHD), TABLE(VIDEO_SIZE_LUT_2P8_BDS_BNS15_WQHD),
+        TABLE(VIDEO_SIZE_LUT_2P8_BDS_BNS20_WQHD), TABLE(VIDEO_SIZE_LUT_2P8_FHD),
+        TABLE(VIDEO_SIZE_LUT_2P8_BDS_FHD), TABLE(VIDEO_SIZE_LUT_2P8_BDS_DIS_FHD),
+        TABLE(VIDEO_SIZE_LUT_2P8_BDS_BNS15_FHD), TABLE(VIDEO_SIZE_LUT_2P8_BDS_BNS15_DIS_FHD),
+        TABLE(VIDEO_SIZE_LUT_2P8_BDS_BNS20_FHD), TABLE(VIDEO_SIZE_LUT_2P8_BDS_BNS20_DIS_FHD),
+        TABLE(VIDEO_SIZE_LUT_60FPS_HIGH_SPEED_2P8), TABLE(VIDEO_SIZE_LUT_120FPS_HIGH_SPEED_2P8),
+        TABLE(VIDEO_SIZE_LUT_240FPS_HIGH_SPEED_2P8), TABLE(VIDEO_SIZE_LUT_HIGH_SPEED_2P8),
+        TABLE(VTCALL_SIZE_LUT_2P8), TABLE(FAST_AE_STABLE_SIZE_LUT_2P8),
+        TABLE(PREVIEW_FULL_SIZE_LUT_2P8), TABLE(PICTURE_FULL_SIZE_LUT_2P8) } },
+    { "2L3", TABLE(PICTURE_SIZE_LUT_2L3), {
+        TABLE(PREVIEW_SIZE_LUT_2L3), TABLE(PREVIEW_SIZE_LUT_2L3_BNS),
+        TABLE(PICTURE_SIZE_LUT_2L3), TABLE(VIDEO_SIZE_LUT_2L3),
+        TABLE(VIDEO_SIZE_LUT_120FPS_HIGH_SPEED_2L3), TABLE(VIDEO_SIZE_LUT_240FPS_HIGH_SPEED_2L3),
+        TABLE(VIDEO_SIZE_LUT_SSM_2L3), TABLE(VTCALL_SIZE_LUT_2L3),
+        TABLE(FAST_AE_STABLE_SIZE_LUT_2L3), TABLE(PREVIEW_FULL_SIZE_LUT_2L3),
+        TABLE(PICTURE_FULL_SIZE_LUT_2L3) } },
+    { "3M3", TABLE(PICTURE_SIZE_LUT_3M3), {
+        TABLE(PREVIEW_SIZE_LUT_3M3), TABLE(PREVIEW_SIZE_LUT_3M3_BNS),
+        TABLE(PICTURE_SIZE_LUT_3M3), TABLE(VIDEO_SIZE_LUT_3M3),
+        TABLE(VIDEO_SIZE_LUT_3M3_BNS), TABLE(VIDEO_SIZE_LUT_60FPS_HIGH_SPEED_3M3),
+        TABLE(VIDEO_SIZE_LUT_120FPS_HIGH_SPEED_3M3), TABLE(VTCALL_SIZE_LUT_3M3),
+        TABLE(FAST_AE_STABLE_SIZE_LUT_3M3), TABLE(PREVIEW_FULL_SIZE_LUT_3M3),
+        TABLE(PICTURE_FULL_SIZE_LUT_3M3) } },
+    { "5F1", TABLE(PREVIEW_FULL_SIZE_LUT_5F1), {
+        TABLE(PREVIEW_SIZE_LUT_5F1), TABLE(PREVIEW_FULL_SIZE_LUT_5F1) } },
+    { "RPB", TABLE(PICTURE_SIZE_LUT_RPB), {
+        TABLE(PREVIEW_SIZE_LUT_RPB), TABLE(PREVIEW_SIZE_LUT_RPB_BNS),
+        TABLE(PICTURE_SIZE_LUT_RPB), TABLE(VIDEO_SIZE_LUT_RPB),
+        TABLE(VIDEO_SIZE_LUT_120FPS_HIGH_SPEED_RPB), TABLE(VIDEO_SIZE_LUT_240FPS_HIGH_SPEED_RPB),
+        TABLE(VIDEO_SIZE_LUT_480FPS_HIGH_SPEED_RPB), TABLE(VTCALL_SIZE_LUT_RPB),
+        TABLE(FAST_AE_STABLE_SIZE_LUT_RPB), TABLE(PREVIEW_FULL_SIZE_LUT_RPB),
+        TABLE(PICTURE_FULL_SIZE_LUT_RPB) } },
+    { "2P7SQ", TABLE(PICTURE_SIZE_LUT_2P7SQ), {
+        TABLE(PREVIEW_SIZE_LUT_2P7SQ), TABLE(PREVIEW_SIZE_LUT_2P7SQ_BNS),
+        TABLE(PICTURE_SIZE_LUT_2P7SQ), TABLE(VIDEO_SIZE_LUT_2P7SQ),
+        TABLE(VIDEO_SIZE_LUT_120FPS_HIGH_SPEED_2P7SQ), TABLE(VIDEO_SIZE_LUT_240FPS_HIGH_SPEED_2P7SQ),
+        TABLE(VIDEO_SIZE_LUT_SSM_2P7SQ), TABLE(VTCALL_SIZE_LUT_2P7SQ),
+        TABLE(FAST_AE_STABLE_SIZE_LUT_2P7SQ), TABLE(PREVIEW_FULL_SIZE_LUT_2P7SQ),
+        TABLE(PICTURE_FULL_SIZE_LUT_2P7SQ) } },
+    { "2T7SX", TABLE(PICTURE_SIZE_LUT_2T7SX), {
+        TABLE(PREVIEW_SIZE_LUT_2T7SX), TABLE(DUAL_PREVIEW_SIZE_LUT_2T7SX),
+        TABLE(PREVIEW_SIZE_LUT_2T7SX_BNS), TABLE(PICTURE_SIZE_LUT_2T7SX),
+        TABLE(VIDEO_SIZE_LUT_2T7SX), TABLE(VIDEO_SIZE_LUT_120FPS_HIGH_SPEED_2T7SX),
+        TABLE(VIDEO_SIZE_LUT_240FPS_HIGH_SPEED_2T7SX), TABLE(VIDEO_SIZE_LUT_SSM_2T7SX),
+        TABLE(VTCALL_SIZE_LUT_2T7SX), TABLE(FAST_AE_STABLE_SIZE_LUT_2T7SX),
+        TABLE(PREVIEW_FULL_SIZE_LUT_2T7SX), TABLE(PICTURE_FULL_SIZE_LUT_2T7SX) } },
+    { "IMX260_2L1", TABLE(PICTURE_SIZE_LUT_IMX260_2L1), {
+        TABLE(PREVIEW_SIZE_LUT_IMX260_2L1), TABLE(PREVIEW_SIZE_LUT_IMX260_2L1_BNS),
+        TABLE(PICTURE_SIZE_LUT_IMX260_2L1), TABLE(VIDEO_SIZE_LUT_IMX260_2L1),
+        TABLE(VIDEO_SIZE_LUT_120FPS_HIGH_SPEED_IMX260_2L1), TABLE(VIDEO_SIZE_LUT_240FPS_HIGH_SPEED_IMX260_2L1),
+        TABLE(VTCALL_SIZE_LUT_IMX260_2L1), TABLE(FAST_AE_STABLE_SIZE_LUT_IMX260_2L1),
+        TABLE(PREVIEW_FULL_SIZE_LUT_IMX260_2L1), TABLE(PICTURE_FULL_SIZE_LUT_IMX260_2L1) } },
+    { "IMX333_2L2", TABLE(PICTURE_SIZE_LUT_IMX333_2L2), {
+        TABLE(PREVIEW_SIZE_LUT_IMX333_2L2), TABLE(PREVIEW_SIZE_LUT_IMX333_2L2_BNS),
+        TABLE(PICTURE_SIZE_LUT_IMX333_2L2), TABLE(VIDEO_SIZE_LUT_IMX333_2L2),
+        TABLE(VIDEO_SIZE_LUT_120FPS_HIGH_SPEED_IMX333_2L2), TABLE(VIDEO_SIZE_LUT_240FPS_HIGH_SPEED_IMX333_2L2),
+        TABLE(VTCALL_SIZE_LUT_IMX333_2L2), TABLE(FAST_AE_STABLE_SIZE_LUT_IMX333_2L2),
+        TABLE(PREVIEW_FULL_SIZE_LUT_IMX333_2L2), TABLE(PICTURE_FULL_SIZE_LUT_IMX333_2L2) } },
+    { "IMX320_3H1", TABLE(PICTURE_SIZE_LUT_IMX320_3H1), {
+        TABLE(PREVIEW_SIZE_LUT_IMX320_3H1), TABLE(DUAL_PREVIEW_SIZE_LUT_IMX320_3H1),
+        TABLE(PICTURE_SIZE_LUT_IMX320_3H1), TABLE(VIDEO_SIZE_LUT_IMX320_3H1),
+        TABLE(VIDEO_SIZE_LUT_60FPS_HIGH_SPEED_IMX320_3H1), TABLE(VIDEO_SIZE_LUT_120FPS_HIGH_SPEED_IMX320_3H1),
+        TABLE(PREVIEW_FULL_SIZE_LUT_IMX320_3H1), TABLE(PICTURE_FULL_SIZE_LUT_IMX320_3H1),
+        TABLE(VTCALL_SIZE_LUT_IMX320_3H1), TABLE(DUAL_VIDEO_SIZE_LUT_IMX320_3H1) } },
+    { "6B2", TABLE(PICTURE_SIZE_LUT_6B2), {
+        TABLE(PREVIEW_SIZE_LUT_6B2), TABLE(PICTURE_SIZE_LUT_6B2),
+        TABLE(VIDEO_SIZE_LUT_6B2), TABLE(PREVIEW_FULL_SIZE_LUT_6B2),
+        TABLE(PICTURE_FULL_SIZE_LUT_6B2), TABLE(VTCALL_SIZE_LUT_6B2) } },
+    { "4E6", TABLE(lut_4e6::PICTURE_SIZE_LUT_4E6), {
+        TABLE(lut_4e6::PREVIEW_SIZE_LUT_4E6), TABLE(lut_4e6::DUAL_PREVIEW_SIZE_LUT_4E6),
+        TABLE(lut_4e6::PICTURE_SIZE_LUT_4E6), TABLE(lut_4e6::VIDEO_SIZE_LUT_4E6),
+        TABLE(lut_4e6::VIDEO_SIZE_LUT_60FPS_HIGH_SPEED_4E6), TABLE(lut_4e6::VIDEO_SIZE_LUT_120FPS_HIGH_SPEED_4E6),
+        TABLE(lut_4e6::PREVIEW_FULL_SIZE_LUT_4E6), TABLE(lut_4e6::PICTURE_FULL_SIZE_LUT_4E6),
+        TABLE(lut_4e6::VTCALL_SIZE_LUT_4E6), TABLE(lut_4e6::DUAL_VIDEO_SIZE_LUT_4E6) } },
+    { "5E6", TABLE(lut_5e6::PICTURE_SIZE_LUT_5E6), {
+        TABLE(lut_5e6::PREVIEW_SIZE_LUT_5E6), TABLE(lut_5e6::PICTURE_SIZE_LUT_5E6),
+        TABLE(lut_5e6::VIDEO_SIZE_LUT_5E6), TABLE(lut_5e6::VTCALL_SIZE_LUT_5E6),
+        TABLE(lut_5e6::VIDEO_SIZE_LUT_120FPS_HIGH_SPEED_5E6), TABLE(lut_5e6::PREVIEW_FULL_SIZE_LUT_5E6),
+        TABLE(lut_5e6::PICTURE_FULL_SIZE_LUT_5E6), TABLE(lut_5e6::DUAL_VIDEO_SIZE_LUT_5E6) } },
+    { "IMX240_2P2_FHD", TABLE(lut_imx240_fhd::PICTURE_SIZE_LUT_IMX240_2P2), {
+        TABLE(lut_imx240_fhd::PREVIEW_SIZE_LUT_IMX240_2P2_BNS), TABLE(lut_imx240_fhd::PREVIEW_SIZE_LUT_IMX240_2P2_BNS_DUAL),
+        TABLE(lut_imx240_fhd::PREVIEW_SIZE_LUT_IMX240_2P2), TABLE(lut_imx240_fhd::PREVIEW_SIZE_LUT_IMX240_2P2_FULL_OTF),
+        TABLE(lut_imx240_fhd::PICTURE_SIZE_LUT_IMX240_2P2), TABLE(lut_imx240_fhd::VIDEO_SIZE_LUT_IMX240_2P2_BNS),
+        TABLE(lut_imx240_fhd::VIDEO_SIZE_LUT_IMX240_2P2), TABLE(lut_imx240_fhd::VIDEO_SIZE_LUT_IMX240_2P2_FULL_OTF),
+        TABLE(lut_imx240_fhd::VIDEO_SIZE_LUT_60FPS_HIGH_SPEED_IMX240_2P2_BNS),
+        TABLE(lut_imx240_fhd::VIDEO_SIZE_LUT_120FPS_HIGH_SPEED_IMX240_2P2_BNS),
+        TABLE(lut_imx240_fhd::VIDEO_SIZE_LUT_HIGH_SPEED_IMX240_2P2_BNS_FULL_OTF),
+        TABLE(lut_imx240_fhd::VTCALL_SIZE_LUT_IMX240_2P2_BNS), TABLE(lut_imx240_fhd::YUV_SIZE_LUT_IMX240_2P2) } },
+    { "IMX240_2P2_WQHD", TABLE(lut_imx240_wqhd::PICTURE_SIZE_LUT_IMX240_2P2), {
+        TABLE(lut_imx240_wqhd::PREVIEW_SIZE_LUT_IMX240_2P2_BNS), TABLE(lut_imx240_wqhd::PREVIEW_SIZE_LUT_IMX240_2P2),
+        TABLE(lut_imx240_wqhd::PICTURE_SIZE_LUT_IMX240_2P2), TABLE(lut_imx240_wqhd::VIDEO_SIZE_LUT_IMX240_2P2_BNS),
+        TABLE(lut_imx240_wqhd::VIDEO_SIZE_LUT_IMX240_2P2),
+        TABLE(lut_imx240_wqhd::VIDEO_SIZE_LUT_60FPS_HIGH_SPEED_IMX240_2P2_BNS),
+        TABLE(lut_imx240_wqhd::VIDEO_SIZE_LUT_120FPS_HIGH_SPEED_IMX240_2P2_BNS),
+        TABLE(lut_imx240_wqhd::VTCALL_SIZE_LUT_IMX240_2P2_BNS), TABLE(lut_imx240_wqhd::YUV_SIZE_LUT_IMX240_2P2),
+        TABLE(lut_imx240_wqhd::YUV_SIZE_LUT_IMX240_2P2_BDS) } },
+};
+
+/* up to the 3AA input crop limit, the default max zoom and one over CROP_GEOMETRY_MAX_ENTRY steps */
+static const int testMaxZoomRatios[] = { 4000, 8000, 30000 };
+
+/*
+ * A sensor with the LUT under test as its preview LUT : the configured ratio
+ * picks the row. The other static information is the one of a real sensor.
+ */
+struct TestSensorInfo : public ExynosCameraSensor2L7Base {
+    int yuvSizeList[TEST_MAX_ROW][SIZE_OF_RESOLUTION];
+    int jpegSizeList[TEST_MAX_ROW][SIZE_OF_RESOLUTION];
+
+    TestSensorInfo(const TestSensor *sensor, const TestTable *table, int zoomRatio)
+        : ExynosCameraSensor2L7Base()
+    {
+        getMaxSensorSize(sensor, &maxSensorW, &maxSensorH);
+        maxPreviewW = maxPictureW = maxSensorW;
+        maxPreviewH = maxPictureH = maxSensorH;
+        sensorMarginW = 0;
+        sensorMarginH = 0;
+        sizeTableSupport = true;
+
+        previewSizeLut = previewFullSizeLut = table->lut;
+        previewSizeLutMax = previewFullSizeLutMax = table->numOfRow;
+        pictureSizeLut = pictureFullSizeLut = sensor->picture.lut;
+        pictureSizeLutMax = pictureFullSizeLutMax = sensor->picture.numOfRow;
+
+        setSizeList(table, yuvSizeList);
+        setSizeList(&sensor->picture, jpegSizeList);
+        yuvList = yuvSizeList;
+        yuvListMax = (table->numOfRow < TEST_MAX_ROW) ? table->numOfRow : TEST_MAX_ROW;
+        jpegList = jpegSizeList;
+        jpegListMax = (sensor->picture.numOfRow < TEST_MAX_ROW) ? sensor->picture.numOfRow : TEST_MAX_ROW;
+        hiddenPreviewList = NULL;
+        hiddenPreviewListMax = 0;
+        hiddenPictureList = NULL;
+        hiddenPictureListMax = 0;
+
+        maxZoomRatio = zoomRatio;
+        maxZoomRatioVendor = zoomRatio;
+    }
+
+    static void getMaxSensorSize(const TestSensor *sensor, int *maxW, int *maxH)
+    {
+        *maxW = 0;
+        *maxH = 0;
+
+        for (int t = 0; t < TEST_MAX_TABLE && sensor->tables[t].lut != NULL; t++) {
+            for (int r = 0; r < sensor->tables[t].numOfRow; r++) {
+                if (*maxW < sensor->tables[t].lut[r][SENSOR_W])
+                    *maxW = sensor->tables[t].lut[r][SENSOR_W];
+                if (*maxH < sensor->tables[t].lut[r][SENSOR_H])
+                    *maxH = sensor->tables[t].lut[r][SENSOR_H];
+            }
+        }
+    }
+
+    /* the target sizes of the LUT rows, with their ratio */
+    static void setSizeList(const TestTable *table, int (*sizeList)[SIZE_OF_RESOLUTION])
+    {
+        for (int r = 0; r < table->numOfRow && r < TEST_MAX_ROW; r++) {
+            sizeList[r][0] = table->lut[r][TARGET_W];
+            sizeList[r][1] = table->lut[r][TARGET_H];
+            sizeList[r][2] = 30;
+            sizeList[r][3] = table->lut[r][RATIO_ID];
+        }
+    }
+};
+
+static const TestSensorInfo *testSensorInfo = NULL;
+
+namespace android {
+/* the board one is not built in : every camera is the sensor under test */
+struct ExynosCameraSensorInfoBase *createExynosCameraSensorInfo(__unused int cameraId)
+{
+    return new ExynosCameraSensorInfoBase(*testSensorInfo);
+}
+}; /* namespace android */
+
+/* what the get*Size() functions return for the current crop region */
+struct TestCropChain {
+    status_t    ret[6];
+    ExynosRect  previewBnsSize;
+    ExynosRect  previewBayerCropSize;
+    ExynosRect  previewBdsSize;
+    ExynosRect  previewYuvCropSize;
+    ExynosRect  pictureBnsSize;
+    ExynosRect  pictureBayerCropSize;
+    ExynosRect  pictureBdsSize;
+    ExynosRect  pictureYuvCropSize;
+};
+
+static void getCropChain(ExynosCameraParameters *parameters, TestCropChain *chain)
+{
+    memset(chain, 0x00, sizeof(TestCropChain));
+
+    chain->ret[0] = parameters->getPreviewBayerCropSize(&chain->previewBnsSize, &chain->previewBayerCropSize);
+    chain->ret[1] = parameters->getPreviewBdsSize(&chain->previewBdsSize);
+    chain->ret[2] = parameters->getPreviewYuvCropSize(&chain->previewYuvCropSize);
+    chain->ret[3] = parameters->getPictureBayerCropSize(&chain->pictureBnsSize, &chain->pictureBayerCropSize);
+    chain->ret[4] = parameters->getPictureBdsSize(&chain->pictureBdsSize);
+    chain->ret[5] = parameters->getPictureYuvCropSize(&chain->pictureYuvCropSize);
+}
+
+static bool isSameRect(const ExynosRect *rect1, const ExynosRect *rect2)
+{
+    return (rect1->x == rect2->x && rect1->y == rect2->y
+            && rect1->w == rect2->w && rect1->h == rect2->h);
+}
+
+static void expectSameCropChain(const TestCropChain *chain1, const TestCropChain *chain2, const char *what)
+{
+    for (int i = 0; i < 6; i++)
+        EXPECT_EQ(chain1->ret[i], chain2->ret[i]) << what << " ret[" << i << "]";
+
+    EXPECT_TRUE(isSameRect(&chain1->previewBnsSize, &chain2->previewBnsSize)) << what;
+    EXPECT_TRUE(isSameRect(&chain1->previewBayerCropSize, &chain2->previewBayerCropSize)) << what;
+    EXPECT_TRUE(isSameRect(&chain1->previewBdsSize, &chain2->previewBdsSize)) << what;
+    EXPECT_TRUE(isSameRect(&chain1->previewYuvCropSize, &chain2->previewYuvCropSize)) << what;
+    EXPECT_TRUE(isSameRect(&chain1->pictureBnsSize, &chain2->pictureBnsSize)) << what;
+    EXPECT_TRUE(isSameRect(&chain1->pictureBayerCropSize, &chain2->pictureBayerCropSize)) << what;
+    EXPECT_TRUE(isSameRect(&chain1->pictureBdsSize, &chain2->pictureBdsSize)) << what;
+    EXPECT_TRUE(isSameRect(&chain1->pictureYuvCropSize, &chain2->pictureYuvCropSize)) << what;
+}
+
+static const int *getPictureLut(const TestSensor *sensor, int ratioId)
+{
+    for (int r = 0; r < sensor->picture.numOfRow; r++) {
+        if (sensor->picture.lut[r][RATIO_ID] == ratioId)
+            return sensor->picture.lut[r];
+    }
+
+    return sensor->picture.lut[0];
+}
+
+TEST(ExynosCameraCropGeometryCacheTest, NumOfEntry)
+{
+    int step = 0;
+
+    EXPECT_EQ(0, TestCache::getNumOfEntry(999, &step));
+    EXPECT_EQ(1, TestCache::getNumOfEntry(1000, &step));
+    EXPECT_EQ(71, TestCache::getNumOfEntry(8000, &step));
+    EXPECT_EQ(CROP_GEOMETRY_ZOOM_STEP, step);
+    EXPECT_EQ(72, TestCache::getNumOfEntry(8050, &step));
+    EXPECT_EQ(8050, TestCache::getZoomRatio(8050, 71));
+
+    for (int maxZoomRatio = 1000; maxZoomRatio <= 100000; maxZoomRatio += 7) {
+        int numOfEntry = TestCache::getNumOfEntry(maxZoomRatio, &step);
+
+        ASSERT_LE(numOfEntry, CROP_GEOMETRY_MAX_ENTRY) << maxZoomRatio;
+        EXPECT_EQ(maxZoomRatio, TestCache::getZoomRatio(maxZoomRatio, numOfEntry - 1)) << maxZoomRatio;
+        EXPECT_LT(TestCache::getZoomRatio(maxZoomRatio, numOfEntry - 2), maxZoomRatio) << maxZoomRatio;
+    }
+}
+
+/* a cache lookup of cropRegion, the fill only records the table point */
+static const TestEntry *lookup(TestCache *cache, const TestKey *key, const ExynosRect *cropRegion, int *numOfFill)
+{
+    int index = TestCache::getIndex(key->maxZoomRatio, key->maxSensorW, key->maxSensorH, cropRegion);
+
+    if (index < 0)
+        return NULL;
+
+    return cache->get(key, index, [key, numOfFill](int i, TestEntry *entry) {
+        (*numOfFill)++;
+        TestCache::getRegion(TestCache::getZoomRatio(key->maxZoomRatio, i),
+                             key->maxSensorW, key->maxSensorH, &entry->cropRegion);
+        entry->index = i;
+        return true;
+    });
+}
+
+TEST(ExynosCameraCropGeometryCacheTest, FillOnDemand)
+{
+    TestCache cache;
+    TestKey key;
+    ExynosRect region;
+    const TestEntry *entry = NULL;
+    int numOfFill = 0;
+
+    memset(&key, 0x00, sizeof(key));
+    key.previewLut = testSensors[0].tables[0].lut[0];
+    key.maxZoomRatio = 8000;
+    TestSensorInfo::getMaxSensorSize(&testSensors[0], &key.maxSensorW, &key.maxSensorH);
+
+    /* between the table points : no entry */
+    TestCache::getRegion(1050, key.maxSensorW, key.maxSensorH, &region);
+    EXPECT_TRUE(lookup(&cache, &key, &region, &numOfFill) == NULL);
+    EXPECT_EQ(0, numOfFill);
+    EXPECT_EQ(0, cache.getNumOfFilled());
+
+    /* one table point fills one entry, once */
+    TestCache::getRegion(2000, key.maxSensorW, key.maxSensorH, &region);
+    for (int i = 0; i < 3; i++) {
+        entry = lookup(&cache, &key, &region, &numOfFill);
+        ASSERT_NE((const TestEntry *)NULL, entry);
+        EXPECT_TRUE(isSameRect(&region, &entry->cropRegion));
+        EXPECT_EQ(10, entry->index);
+    }
+    EXPECT_EQ(1, numOfFill);
+    EXPECT_EQ(1, cache.getNumOfFilled());
+
+    /* off the center : no entry */
+    region.x += 2;
+    EXPECT_TRUE(lookup(&cache, &key, &region, &numOfFill) == NULL);
+
+    /* a new key drops the entries */
+    key.previewLut = testSensors[0].tables[0].lut[1];
+    EXPECT_EQ(1, cache.getNumOfFilled());
+    TestCache::getRegion(3000, key.maxSensorW, key.maxSensorH, &region);
+    ASSERT_NE((const TestEntry *)NULL, lookup(&cache, &key, &region, &numOfFill));
+    EXPECT_EQ(2, numOfFill);
+    EXPECT_EQ(1, cache.getNumOfFilled());
+
+    cache.invalidate();
+    EXPECT_EQ(0, cache.getNumOfFilled());
+}
+
+TEST(ExynosCameraCropGeometryCacheTest, EverySizeTable)
+{
+    char what[160];
+    int numOfConfig = 0;
+
+    for (size_t s = 0; s < sizeof(testSensors) / sizeof(testSensors[0]); s++) {
+        const TestSensor *sensor = &testSensors[s];
+
+        for (int t = 0; t < TEST_MAX_TABLE && sensor->tables[t].lut != NULL; t++) {
+            const TestTable *table = &sensor->tables[t];
+
+            for (int r = 0; r < table->numOfRow && r < TEST_MAX_ROW; r++) {
+                const int *pictureLut = getPictureLut(sensor, table->lut[r][RATIO_ID]);
+
+                for (size_t z = 0; z < sizeof(testMaxZoomRatios) / sizeof(testMaxZoomRatios[0]); z++) {
+                    TestSensorInfo sensorInfo(sensor, table, testMaxZoomRatios[z]);
+                    ExynosCameraConfigurations *configurations = NULL;
+                    ExynosCameraParameters *parameters = NULL;
+                    TestCropChain before, after;
+                    ExynosRect region, hwBayerCrop, checkedHwBayerCrop;
+                    int maxSensorW = 0, maxSensorH = 0;
+
+                    snprintf(what, sizeof(what), "%s %s[%d] maxZoomRatio(%d)",
+                             sensor->name, table->name, r, testMaxZoomRatios[z]);
+
+                    testSensorInfo = &sensorInfo;
+                    configurations = new ExynosCameraConfigurations(CAMERA_ID_BACK, SCENARIO_NORMAL);
+                    parameters = new ExynosCameraParameters(CAMERA_ID_BACK, SCENARIO_NORMAL, configurations);
+
+                    /* the stream configuration of the row */
+                    configurations->setSamsungCamera(true);
+                    configurations->setConfigMode(CONFIG_MODE::NORMAL);
+                    ASSERT_EQ(NO_ERROR, parameters->checkYuvSize(table->lut[r][TARGET_W], table->lut[r][TARGET_H], 0)) << what;
+                    ASSERT_EQ(NO_ERROR, parameters->checkPictureSize(pictureLut[TARGET_W], pictureLut[TARGET_H])) << what;
+
+                    /* a request crop region between the table points */
+                    parameters->getSize(HW_INFO_MAX_SENSOR_SIZE, (uint32_t *)&maxSensorW, (uint32_t *)&maxSensorH);
+                    TestCache::getRegion(1050, maxSensorW, maxSensorH, &region);
+                    ASSERT_EQ(NO_ERROR, parameters->setCropRegion(region.x, region.y, region.w, region.h)) << what;
+
+                    getCropChain(parameters, &before);
+                    parameters->getHwBayerCropRegion(&hwBayerCrop.w, &hwBayerCrop.h, &hwBayerCrop.x, &hwBayerCrop.y);
+
+                    EXPECT_EQ(NO_ERROR, parameters->checkCropGeometry()) << what;
+
+                    /* the check works on its own crop state */
+                    parameters->getHwBayerCropRegion(&checkedHwBayerCrop.w, &checkedHwBayerCrop.h,
+                                                     &checkedHwBayerCrop.x, &checkedHwBayerCrop.y);
+                    EXPECT_TRUE(isSameRect(&hwBayerCrop, &checkedHwBayerCrop)) << what;
+
+                    getCropChain(parameters, &after);
+                    expectSameCropChain(&before, &after, what);
+
+                    delete parameters;
+                    delete configurations;
+                    testSensorInfo = NULL;
+                    numOfConfig++;
+                }
+            }
+        }
+    }
+
+    printf("%d configurations\n", numOfConfig);
+    EXPECT_GT(numOfConfig, 0);
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The sensor static information comes with the board. The test defines
+ * createExynosCameraSensorInfo() itself : every camera is the sensor of
+ * the size table under test.
+ */
+
+#ifndef EXYNOS_CAMERA_SENSOR_INFO_H
+#define EXYNOS_CAMERA_SENSOR_INFO_H
+
+#include "ExynosCameraSensorInfoBase.h"
+
+namespace android {
+
+struct ExynosCameraSensorInfoBase *createExynosCameraSensorInfo(int cameraId);
+
+}; /* namespace android */
+#endif
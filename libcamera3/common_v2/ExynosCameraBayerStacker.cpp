@@ -0,0 +1,482 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#define LOG_TAG "ExynosCameraBayerStacker"
+
+#include <string.h>
+#include <unistd.h>
+
+#include <log/log.h>
+
+#include "ExynosCameraBayerStacker.h"
+
+#define BAYER_STACK_STRIDE_ALIGN    (16)
+
+static const int bayerStackFormatBits[BAYER_STACK_FORMAT_MAX] = {16, 10, 12};
+
+/* the unpack and pack helpers work on whole groups: 4 pixels of packed10, 2 of packed12 */
+static void unpackPacked10(const uint8_t *src, uint16_t *dst, int width)
+{
+    for (int x = 0; x < width; x += 4) {
+        dst[0] = src[0] | ((src[1] & 0x03) << 8);
+        dst[1] = (src[1] >> 2) | ((src[2] & 0x0F) << 6);
+        dst[2] = (src[2] >> 4) | ((src[3] & 0x3F) << 4);
+        dst[3] = (src[3] >> 6) | (src[4] << 2);
+        src += 5;
+        dst += 4;
+    }
+}
+
+static void unpackPacked12(const uint8_t *src, uint16_t *dst, int width)
+{
+    for (int x = 0; x < width; x += 2) {
+        dst[0] = src[0] | ((src[1] & 0x0F) << 8);
+        dst[1] = (src[1] >> 4) | (src[2] << 4);
+        src += 3;
+        dst += 2;
+    }
+}
+
+static void packPacked10(const uint16_t *src, uint8_t *dst, int width)
+{
+    for (int x = 0; x < width; x += 4) {
+        dst[0] = (uint8_t)src[0];
+        dst[1] = (uint8_t)((src[0] >> 8) | (src[1] << 2));
+        dst[2] = (uint8_t)((src[1] >> 6) | (src[2] << 4));
+        dst[3] = (uint8_t)((src[2] >> 4) | (src[3] << 6));
+        dst[4] = (uint8_t)(src[3] >> 2);
+        src += 4;
+        dst += 5;
+    }
+}
+
+static void packPacked12(const uint16_t *src, uint8_t *dst, int width)
+{
+    for (int x = 0; x < width; x += 2) {
+        dst[0] = (uint8_t)src[0];
+        dst[1] = (uint8_t)((src[0] >> 8) | (src[1] << 4));
+        dst[2] = (uint8_t)(src[1] >> 4);
+        src += 2;
+        dst += 3;
+    }
+}
+
+ExynosCameraBayerStacker::ExynosCameraBayerStacker()
+{
+    m_width = 0;
+    m_height = 0;
+    m_stride = 0;
+    m_format = BAYER_STACK_FORMAT_UNPACKED16;
+    m_mode = BAYER_STACK_MODE_SUM;
+    m_maxValue = 0;
+    m_blackLevel = 0;
+    m_numOfThread = 1;
+
+    m_acc = NULL;
+    m_min = NULL;
+    m_max = NULL;
+    m_line = NULL;
+    m_lineSize = 0;
+    m_numOfFrame = 0;
+    m_weightSum = 0;
+
+    m_jobNumOfSrc = 0;
+    m_jobDst = NULL;
+    m_jobWeightSum = 0;
+}
+
+ExynosCameraBayerStacker::~ExynosCameraBayerStacker()
+{
+    deinit();
+}
+
+int ExynosCameraBayerStacker::getMinStride(int width, bayer_stack_format_t format)
+{
+    int bytes;
+
+    switch (format) {
+    case BAYER_STACK_FORMAT_PACKED10:
+        bytes = (width + 3) / 4 * 5;
+        break;
+    case BAYER_STACK_FORMAT_PACKED12:
+        bytes = (width + 1) / 2 * 3;
+        break;
+    case BAYER_STACK_FORMAT_UNPACKED16:
+    default:
+        bytes = width * 2;
+        break;
+    }
+
+    return (bytes + BAYER_STACK_STRIDE_ALIGN - 1) / BAYER_STACK_STRIDE_ALIGN * BAYER_STACK_STRIDE_ALIGN;
+}
+
+status_t ExynosCameraBayerStacker::init(int width, int height, int stride,
+                                        bayer_stack_format_t format, bayer_stack_mode_t mode,
+                                        int outputBits, int blackLevel, int numOfThread)
+{
+    int minStride;
+    size_t numOfPixel;
+
+    if (width <= 0 || height <= 0
+        || format < BAYER_STACK_FORMAT_UNPACKED16 || format >= BAYER_STACK_FORMAT_MAX
+        || mode < BAYER_STACK_MODE_SUM || mode >= BAYER_STACK_MODE_MAX) {
+        ALOGE("ERR(%s[%d]):Invalid size(%dx%d), format(%d) or mode(%d)",
+                __FUNCTION__, __LINE__, width, height, format, mode);
+        return BAD_VALUE;
+    }
+
+    if (outputBits <= 0 || outputBits > bayerStackFormatBits[format]
+        || blackLevel < 0 || blackLevel >= (1 << outputBits)) {
+        ALOGE("ERR(%s[%d]):Invalid outputBits(%d) or blackLevel(%d) for format(%d)",
+                __FUNCTION__, __LINE__, outputBits, blackLevel, format);
+        return BAD_VALUE;
+    }
+
+    minStride = getMinStride(width, format);
+    if (stride == 0)
+        stride = minStride;
+
+    if (stride < minStride) {
+        ALOGE("ERR(%s[%d]):stride(%d) < minimum stride(%d)", __FUNCTION__, __LINE__, stride, minStride);
+        return BAD_VALUE;
+    }
+
+    deinit();
+
+    if (numOfThread <= 0)
+        numOfThread = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (numOfThread > BAYER_STACK_MAX_THREADS)
+        numOfThread = BAYER_STACK_MAX_THREADS;
+    if (numOfThread > height)
+        numOfThread = height;
+    if (numOfThread <= 0)
+        numOfThread = 1;
+
+    m_width = width;
+    m_height = height;
+    m_stride = stride;
+    m_format = format;
+    m_mode = mode;
+    m_maxValue = (1U << outputBits) - 1;
+    m_blackLevel = blackLevel;
+    m_numOfThread = numOfThread;
+
+    /* the line buffers hold whole packing groups */
+    m_lineSize = (width + 3) & ~3;
+    numOfPixel = (size_t)width * height;
+
+    m_acc = new uint32_t[numOfPixel];
+    m_line = new uint16_t[(size_t)m_lineSize * numOfThread];
+    if (mode == BAYER_STACK_MODE_CLIPPED_MEAN) {
+        m_min = new uint16_t[numOfPixel];
+        m_max = new uint16_t[numOfPixel];
+    }
+
+    m_numOfFrame = 0;
+    m_weightSum = 0;
+
+    ALOGD("DEBUG(%s[%d]):%dx%d stride(%d) format(%d) mode(%d) outputBits(%d) blackLevel(%d) threads(%d)",
+            __FUNCTION__, __LINE__, width, height, stride, format, mode,
+            outputBits, blackLevel, numOfThread);
+
+    return NO_ERROR;
+}
+
+void ExynosCameraBayerStacker::deinit(void)
+{
+    delete[] m_acc;
+    delete[] m_min;
+    delete[] m_max;
+    delete[] m_line;
+
+    m_acc = NULL;
+    m_min = NULL;
+    m_max = NULL;
+    m_line = NULL;
+    m_numOfFrame = 0;
+    m_weightSum = 0;
+}
+
+status_t ExynosCameraBayerStacker::addFrame(const void *src, int weight)
+{
+    return stack(&src, &weight, 1, NULL);
+}
+
+status_t ExynosCameraBayerStacker::addFrames(const void *const *srcs, const int *weights, int numOfFrame)
+{
+    return stack(srcs, weights, numOfFrame, NULL);
+}
+
+status_t ExynosCameraBayerStacker::finalize(void *dst)
+{
+    if (dst == NULL) {
+        ALOGE("ERR(%s[%d]):dst is NULL", __FUNCTION__, __LINE__);
+        return BAD_VALUE;
+    }
+
+    return stack(NULL, NULL, 0, dst);
+}
+
+status_t ExynosCameraBayerStacker::stack(const void *const *srcs, const int *weights,
+                                         int numOfFrame, void *dst)
+{
+    uint64_t maxSample;
+    uint64_t weightSum = m_weightSum;
+
+    if (m_acc == NULL) {
+        ALOGE("ERR(%s[%d]):Not initialized", __FUNCTION__, __LINE__);
+        return INVALID_OPERATION;
+    }
+
+    if (numOfFrame < 0 || numOfFrame > BAYER_STACK_MAX_BATCH
+        || (numOfFrame > 0 && srcs == NULL)) {
+        ALOGE("ERR(%s[%d]):Invalid numOfFrame(%d) or srcs(%p)", __FUNCTION__, __LINE__, numOfFrame, srcs);
+        return BAD_VALUE;
+    }
+
+    for (int i = 0; i < numOfFrame; i++) {
+        int weight = BAYER_STACK_WEIGHT_ONE;
+
+        if (weights != NULL && m_mode == BAYER_STACK_MODE_WEIGHTED_MEAN)
+            weight = weights[i];
+
+        if (srcs[i] == NULL || weight <= 0 || weight > BAYER_STACK_WEIGHT_MAX) {
+            ALOGE("ERR(%s[%d]):Invalid src(%p) or weight(%d) of frame(%d)",
+                    __FUNCTION__, __LINE__, srcs[i], weight, i);
+            return BAD_VALUE;
+        }
+
+        m_jobSrc[i] = (const uint8_t *)srcs[i];
+        m_jobWeight[i] = (m_mode == BAYER_STACK_MODE_WEIGHTED_MEAN) ? weight : 1;
+        weightSum += m_jobWeight[i];
+    }
+
+    /* the accumulator must not wrap */
+    maxSample = (1ULL << bayerStackFormatBits[m_format]) - 1;
+    if (maxSample * weightSum > UINT32_MAX) {
+        ALOGE("ERR(%s[%d]):Too many frames(%d + %d), weightSum(%llu)",
+                __FUNCTION__, __LINE__, m_numOfFrame, numOfFrame, (unsigned long long)weightSum);
+        return INVALID_OPERATION;
+    }
+
+    if (dst != NULL && m_numOfFrame + numOfFrame == 0) {
+        ALOGE("ERR(%s[%d]):No frame to stack", __FUNCTION__, __LINE__);
+        return INVALID_OPERATION;
+    }
+
+    m_jobNumOfSrc = numOfFrame;
+    m_jobDst = (uint8_t *)dst;
+    m_jobWeightSum = (uint32_t)weightSum;
+
+    m_runBands();
+
+    m_numOfFrame += numOfFrame;
+    m_weightSum = (uint32_t)weightSum;
+
+    return NO_ERROR;
+}
+
+int ExynosCameraBayerStacker::getNumOfFrame(void)
+{
+    return m_numOfFrame;
+}
+
+int ExynosCameraBayerStacker::getStride(void)
+{
+    return m_stride;
+}
+
+void ExynosCameraBayerStacker::m_runBands(void)
+{
+    pthread_t threads[BAYER_STACK_MAX_THREADS];
+    bool created[BAYER_STACK_MAX_THREADS];
+    band_t bands[BAYER_STACK_MAX_THREADS];
+    int rows = m_height / m_numOfThread;
+    int remain = m_height % m_numOfThread;
+    int rowStart = 0;
+
+    for (int i = 0; i < m_numOfThread; i++) {
+        bands[i].stacker = this;
+        bands[i].rowStart = rowStart;
+        bands[i].rowEnd = rowStart + rows + ((i < remain) ? 1 : 0);
+        bands[i].line = m_line + (size_t)m_lineSize * i;
+        rowStart = bands[i].rowEnd;
+    }
+
+    /* the caller takes the first band */
+    for (int i = 1; i < m_numOfThread; i++) {
+        created[i] = (pthread_create(&threads[i], NULL, m_bandThreadFunc, &bands[i]) == 0);
+        if (created[i] == false) {
+            ALOGW("WARN(%s[%d]):Failed to create band thread(%d), run here", __FUNCTION__, __LINE__, i);
+            m_bandThreadFunc(&bands[i]);
+        }
+    }
+
+    m_bandThreadFunc(&bands[0]);
+
+    for (int i = 1; i < m_numOfThread; i++) {
+        if (created[i] == true)
+            pthread_join(threads[i], NULL);
+    }
+}
+
+/*
+ * A band runs row by row: the row of every frame of the job is added while
+ * the accumulator row stays in the cache, then the row is finalized.
+ */
+void *ExynosCameraBayerStacker::m_bandThreadFunc(void *data)
+{
+    band_t *band = (band_t *)data;
+    ExynosCameraBayerStacker *stacker = band->stacker;
+
+    for (int row = band->rowStart; row < band->rowEnd; row++) {
+        for (int i = 0; i < stacker->m_jobNumOfSrc; i++)
+            stacker->m_addRow(row, band->line, stacker->m_jobSrc[i], stacker->m_jobWeight[i],
+                              (stacker->m_numOfFrame + i == 0));
+
+        if (stacker->m_jobDst != NULL)
+            stacker->m_finalizeRow(row, band->line);
+    }
+
+    return NULL;
+}
+
+void ExynosCameraBayerStacker::m_addRow(int row, uint16_t *line,
+                                        const uint8_t *frame, uint32_t weight, bool first)
+{
+    const uint8_t *src = frame + (size_t)m_stride * row;
+    const uint16_t *__restrict in;
+    size_t offset = (size_t)m_width * row;
+    uint32_t *__restrict acc = m_acc + offset;
+    uint32_t black = m_blackLevel;
+    /* locals, so the stores to acc can not alias the members */
+    int width = m_width;
+    int x;
+
+    switch (m_format) {
+    case BAYER_STACK_FORMAT_PACKED10:
+        unpackPacked10(src, line, width);
+        in = line;
+        break;
+    case BAYER_STACK_FORMAT_PACKED12:
+        unpackPacked12(src, line, width);
+        in = line;
+        break;
+    case BAYER_STACK_FORMAT_UNPACKED16:
+    default:
+        in = (const uint16_t *)src;
+        break;
+    }
+
+    if (m_mode == BAYER_STACK_MODE_CLIPPED_MEAN) {
+        uint16_t *__restrict minLine = m_min + offset;
+        uint16_t *__restrict maxLine = m_max + offset;
+        uint16_t v;
+
+        if (first == true) {
+            for (x = 0; x < width; x++) {
+                v = (in[x] > black) ? in[x] - black : 0;
+                acc[x] = v;
+                minLine[x] = v;
+                maxLine[x] = v;
+            }
+        } else {
+            for (x = 0; x < width; x++) {
+                v = (in[x] > black) ? in[x] - black : 0;
+                acc[x] += v;
+                minLine[x] = (v < minLine[x]) ? v : minLine[x];
+                maxLine[x] = (v > maxLine[x]) ? v : maxLine[x];
+            }
+        }
+    } else if (first == true) {
+        for (x = 0; x < width; x++)
+            acc[x] = ((in[x] > black) ? in[x] - black : 0) * weight;
+    } else {
+        for (x = 0; x < width; x++)
+            acc[x] += ((in[x] > black) ? in[x] - black : 0) * weight;
+    }
+}
+
+void ExynosCameraBayerStacker::m_finalizeRow(int row, uint16_t *line)
+{
+    uint8_t *dst = m_jobDst + (size_t)m_stride * row;
+    uint16_t *__restrict out;
+    size_t offset = (size_t)m_width * row;
+    const uint32_t *__restrict acc = m_acc + offset;
+    uint32_t black = m_blackLevel;
+    uint32_t maxValue = m_maxValue;
+    uint32_t value, div;
+    /* the frames of the running job count */
+    uint32_t numOfFrame = m_numOfFrame + m_jobNumOfSrc;
+    int width = m_width;
+    int x;
+
+    /* unpacked output is written straight to dst */
+    out = (m_format == BAYER_STACK_FORMAT_UNPACKED16) ? (uint16_t *)dst : line;
+
+    switch (m_mode) {
+    case BAYER_STACK_MODE_WEIGHTED_MEAN:
+        div = m_jobWeightSum;
+        for (x = 0; x < width; x++) {
+            value = (acc[x] + div / 2) / div + black;
+            out[x] = (value > maxValue) ? maxValue : value;
+        }
+        break;
+    case BAYER_STACK_MODE_CLIPPED_MEAN:
+        if (numOfFrame >= 3) {
+            const uint16_t *__restrict minLine = m_min + offset;
+            const uint16_t *__restrict maxLine = m_max + offset;
+
+            div = numOfFrame - 2;
+            for (x = 0; x < width; x++) {
+                value = (acc[x] - minLine[x] - maxLine[x] + div / 2) / div + black;
+                out[x] = (value > maxValue) ? maxValue : value;
+            }
+        } else {
+            div = numOfFrame;
+            for (x = 0; x < width; x++) {
+                value = (acc[x] + div / 2) / div + black;
+                out[x] = (value > maxValue) ? maxValue : value;
+            }
+        }
+        break;
+    case BAYER_STACK_MODE_SUM:
+    default:
+        for (x = 0; x < width; x++) {
+            value = acc[x] + black;
+            out[x] = (value > maxValue) ? maxValue : value;
+        }
+        break;
+    }
+
+    /* pad the last packing group */
+    if (m_format != BAYER_STACK_FORMAT_UNPACKED16) {
+        for (x = width; x < m_lineSize; x++)
+            out[x] = 0;
+    }
+
+    switch (m_format) {
+    case BAYER_STACK_FORMAT_PACKED10:
+        packPacked10(out, dst, width);
+        break;
+    case BAYER_STACK_FORMAT_PACKED12:
+        packPacked12(out, dst, width);
+        break;
+    case BAYER_STACK_FORMAT_UNPACKED16:
+    default:
+        break;
+    }
+}
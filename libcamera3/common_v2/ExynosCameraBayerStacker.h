@@ -0,0 +1,134 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*!
+ * \file      ExynosCameraBayerStacker.h
+ * \brief     header file for the multi-frame bayer stacking engine
+ *
+ */
+
+#ifndef EXYNOS_CAMERA_BAYER_STACKER_H
+#define EXYNOS_CAMERA_BAYER_STACKER_H
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include <utils/Errors.h>
+
+using namespace android;
+
+#define BAYER_STACK_MAX_THREADS     (8)
+/* frame weights are Q8, BAYER_STACK_WEIGHT_ONE is 1.0 */
+#define BAYER_STACK_WEIGHT_ONE      (256)
+#define BAYER_STACK_WEIGHT_MAX      (BAYER_STACK_WEIGHT_ONE * 16)
+/* frames of one addFrames() or stack() call */
+#define BAYER_STACK_MAX_BATCH       (32)
+
+typedef enum BAYER_STACK_FORMAT {
+    BAYER_STACK_FORMAT_UNPACKED16,  /* V4L2_PIX_FMT_SBGGR16 */
+    BAYER_STACK_FORMAT_PACKED10,    /* V4L2_PIX_FMT_SBGGR10 : 4 pixels in 5 bytes */
+    BAYER_STACK_FORMAT_PACKED12,    /* V4L2_PIX_FMT_SBGGR12 : 2 pixels in 3 bytes */
+    BAYER_STACK_FORMAT_MAX,
+} bayer_stack_format_t;
+
+typedef enum BAYER_STACK_MODE {
+    BAYER_STACK_MODE_SUM,           /* brightens, like the pairwise addBayerBuffer() */
+    BAYER_STACK_MODE_WEIGHTED_MEAN,
+    BAYER_STACK_MODE_CLIPPED_MEAN,  /* drops the min and max sample of each pixel */
+    BAYER_STACK_MODE_MAX,
+} bayer_stack_mode_t;
+
+/*
+ * Stacks N bayer frames into one.
+ * Every input is unpacked once into a 32 bit accumulator; the output bit
+ * depth and packing are applied once, by finalize(). The frame is split
+ * into bands of rows that run on up to BAYER_STACK_MAX_THREADS threads.
+ * Frames given together (addFrames(), stack()) are added row by row, so
+ * the accumulator row stays in the cache for all of them.
+ * The black level is removed from every sample and restored once.
+ *
+ * ex.
+ *  stacker.init(w, h, stride, BAYER_STACK_FORMAT_PACKED12, BAYER_STACK_MODE_CLIPPED_MEAN, 10, 64);
+ *  for each frame : stacker.addFrame(frame);
+ *  stacker.finalize(out);
+ *  stacker.deinit();
+ * or, with all the frames at hand :
+ *  stacker.stack(frames, NULL, numOfFrame, out);
+ */
+class ExynosCameraBayerStacker {
+public:
+    ExynosCameraBayerStacker();
+    virtual ~ExynosCameraBayerStacker();
+
+    /* stride : bytes per line of the input and the output, 0 for the minimum */
+    status_t    init(int width, int height, int stride,
+                     bayer_stack_format_t format, bayer_stack_mode_t mode,
+                     int outputBits, int blackLevel, int numOfThread = 0);
+    void        deinit(void);
+
+    /* weights are only used by BAYER_STACK_MODE_WEIGHTED_MEAN, NULL for all 1.0 */
+    status_t    addFrame(const void *src, int weight = BAYER_STACK_WEIGHT_ONE);
+    status_t    addFrames(const void *const *srcs, const int *weights, int numOfFrame);
+    /* dst may be one of the added frames */
+    status_t    finalize(void *dst);
+    /* addFrames() and finalize() in one pass, dst may be NULL */
+    status_t    stack(const void *const *srcs, const int *weights, int numOfFrame, void *dst);
+
+    int         getNumOfFrame(void);
+    int         getStride(void);
+
+    static int  getMinStride(int width, bayer_stack_format_t format);
+
+private:
+    typedef struct {
+        ExynosCameraBayerStacker *stacker;
+        int rowStart;
+        int rowEnd;
+        uint16_t *line;
+    } band_t;
+
+    void        m_runBands(void);
+    static void *m_bandThreadFunc(void *data);
+    void        m_addRow(int row, uint16_t *line, const uint8_t *frame, uint32_t weight, bool first);
+    void        m_finalizeRow(int row, uint16_t *line);
+
+private:
+    int                     m_width;
+    int                     m_height;
+    int                     m_stride;
+    bayer_stack_format_t    m_format;
+    bayer_stack_mode_t      m_mode;
+    uint32_t                m_maxValue;
+    uint32_t                m_blackLevel;
+    int                     m_numOfThread;
+
+    uint32_t                *m_acc;
+    uint16_t                *m_min;     /* only for BAYER_STACK_MODE_CLIPPED_MEAN */
+    uint16_t                *m_max;
+    uint16_t                *m_line;    /* unpacked line of each band */
+    int                     m_lineSize;
+    int                     m_numOfFrame;
+    uint32_t                m_weightSum;
+
+    /* the job of the running m_runBands() */
+    const uint8_t           *m_jobSrc[BAYER_STACK_MAX_BATCH];
+    uint32_t                m_jobWeight[BAYER_STACK_MAX_BATCH];
+    int                     m_jobNumOfSrc;
+    uint8_t                 *m_jobDst;
+    uint32_t                m_jobWeightSum;
+};
+
+#endif
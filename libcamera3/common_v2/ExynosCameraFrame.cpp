@@ -20,6 +20,7 @@
 #include <log/log.h>
 
 #include "ExynosCameraFrame.h"
+#include "ExynosCameraFrameManager.h"
 
 namespace android {
 
@@ -43,6 +44,8 @@ ExynosCameraFrame::ExynosCameraFrame(
     m_frameIndex = 0;
     m_frameType = frameType;
     memset(m_name, 0x00, sizeof(m_name));
+    m_pooled = false;
+    m_revivingTid = 0;
 
     CLOGV(" create frame type(%d), frameCount(%d)", frameType, frameCount);
 
@@ -58,13 +61,17 @@ ExynosCameraFrame::ExynosCameraFrame(int cameraId)
     m_frameIndex = 0;
     m_frameType = FRAME_TYPE_OTHERS;
     memset(m_name, 0x00, sizeof(m_name));
+    m_pooled = false;
+    m_revivingTid = 0;
 
     m_init();
 }
 
 ExynosCameraFrame::~ExynosCameraFrame()
 {
-    m_deinit();
+    /* a pooled frame is already deinitialized in onLastStrongRef() */
+    if (m_deinitDone == false)
+        m_deinit();
 }
 
 #ifdef DEBUG_FRAME_MEMORY_LEAK
@@ -1892,6 +1899,61 @@ status_t ExynosCameraFrame::setFrameMgrInfo(frame_key_queue_t *queue)
     return ret;
 }
 
+void ExynosCameraFrame::m_setFramePool(ExynosCameraFramePool *pool)
+{
+    m_framePool = pool;
+    m_pooled = true;
+
+    /* keep the object alive on the last sp, the pool revives it by promote() */
+    extendObjectLifetime(OBJECT_LIFETIME_WEAK);
+}
+
+void ExynosCameraFrame::m_reuse(void)
+{
+    m_configurations = NULL;
+    m_parameters = NULL;
+    m_frameCount = 0;
+    m_frameIndex = 0;
+    m_frameType = FRAME_TYPE_OTHERS;
+    memset(m_name, 0x00, sizeof(m_name));
+
+    m_init();
+}
+
+void ExynosCameraFrame::onLastStrongRef(__unused const void *id)
+{
+    sp<ExynosCameraFramePool> framePool = NULL;
+
+    if (m_pooled == false)
+        return;
+
+    /* the pool resets and parks the frame, unless it is in use again */
+    framePool = m_framePool.promote();
+    if (framePool != NULL) {
+        framePool->releaseFrame(this);
+        return;
+    }
+
+    if (getStrongCount() > 0)
+        return;
+
+    /* release the key and the entities now, same as the destructor does */
+    m_deinit();
+    m_deinitDone = true;
+}
+
+bool ExynosCameraFrame::onIncStrongAttempted(uint32_t flags, const void *id)
+{
+    /*
+     * A released frame must not be promoted by stale wp, e.g. RunWorker list:
+     * only the thread reviving it in ExynosCameraFramePool::getFrame() may.
+     */
+    if (m_pooled == true)
+        return (m_revivingTid.load() == gettid());
+
+    return RefBase::onIncStrongAttempted(flags, id);
+}
+
 void ExynosCameraFrame::setFrameType(frame_type_t frameType)
 {
     m_frameType = frameType;
@@ -1956,6 +2018,7 @@ status_t ExynosCameraFrame::m_init()
     m_dupBufferInfo.extScalerPipeID = 0;
 
     m_frameQueue = NULL;
+    m_deinitDone = false;
 
 #ifdef CORRECT_TIMESTAMP_FOR_SENSORFUSION
     m_adjustedTimestampFlag = false;
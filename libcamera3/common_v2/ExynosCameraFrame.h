@@ -20,6 +20,8 @@
 
 #include <utils/List.h>
 
+#include <atomic>
+
 #include "ExynosCameraConfigurations.h"
 #include "ExynosCameraParameters.h"
 #include "ExynosCameraSensorInfo.h"
@@ -296,12 +298,15 @@ typedef struct ExynosCameraDupBufferInfo {
     int extScalerPipeID;
 } dup_buffer_info_t;
 
+class ExynosCameraFramePool;
+
 class ExynosCameraFrame : public RefBase {
 
     friend class FrameWorker;
     friend class CreateWorker;
     friend class DeleteWorker;
     friend class ExynosCameraFrameManager;
+    friend class ExynosCameraFramePool;
 
 public:
     typedef enum result_update_type {
@@ -671,6 +676,11 @@ private:
 
     /* ACCESS allowed only frameManager */
     status_t        setFrameMgrInfo(frame_key_queue_t *queue);
+    void            m_setFramePool(ExynosCameraFramePool *pool);
+    void            m_reuse(void);
+
+    virtual void    onLastStrongRef(const void *id);
+    virtual bool    onIncStrongAttempted(uint32_t flags, const void *id);
 
 private:
     int                         m_cameraId;
@@ -732,6 +742,11 @@ private:
     uint32_t                    m_specialCaptureStep;
 
     frame_key_queue_t          *m_frameQueue;
+    wp<ExynosCameraFramePool>   m_framePool;
+    bool                        m_pooled;
+    bool                        m_deinitDone;
+    /* the thread of getFrame() that may promote the parked frame, 0 for none */
+    std::atomic<pid_t>          m_revivingTid;
     bool                        m_hasRequest;
     bool                        m_updateResult;
 
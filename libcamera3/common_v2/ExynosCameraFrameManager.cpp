@@ -30,6 +30,214 @@ namespace android {
 
 #define RUN_THREAD_TIMEOUT (5000000000L) /* 5 sec */
 
+ExynosCameraFramePool::ExynosCameraFramePool(const char* name, int cameraid, int32_t maxSize)
+{
+    m_cameraId = cameraid;
+    strncpy(m_name, name, EXYNOS_CAMERA_NAME_STR_SIZE - 1);
+
+    m_enable = true;
+    m_maxSize = maxSize;
+    m_numOfFrames = 0;
+    m_highWaterMark = 0;
+    m_numOfReuse = 0;
+    m_numOfFallback = 0;
+}
+
+ExynosCameraFramePool::~ExynosCameraFramePool()
+{
+    flush();
+}
+
+ExynosCameraFrameSP_sptr_t ExynosCameraFramePool::getFrame(void)
+{
+    ExynosCameraFrameSP_sptr_t frame = NULL;
+    ExynosCameraFrameWP_t freeFrame;
+    ExynosCameraFrame *rawFrame = NULL;
+    pid_t noTid;
+
+    for (;;) {
+        {
+            Mutex::Autolock lock(m_lock);
+
+            if (m_enable == false)
+                return NULL;
+
+            if (m_freeList.empty() == true) {
+                frame = m_newFrame();
+                if (frame == NULL)
+                    m_numOfFallback++;
+
+                return frame;
+            }
+
+            freeFrame = *m_freeList.begin();
+            m_freeList.erase(m_freeList.begin());
+        }
+
+        /*
+         * The frame was reset in onLastStrongRef(), weak ref keeps it alive.
+         * It is promoted out of m_lock : a failed revive ends in
+         * onLastStrongRef(), which takes m_lock in releaseFrame().
+         */
+        rawFrame = freeFrame.unsafe_get();
+        noTid = 0;
+        if (rawFrame->m_revivingTid.compare_exchange_strong(noTid, gettid()) == true) {
+            frame = freeFrame.promote();
+            rawFrame->m_revivingTid = 0;
+        } else {
+            CLOGE("frame is revived by tid(%d) too", noTid);
+            frame = NULL;
+        }
+
+        if (frame != NULL) {
+            frame->m_reuse();
+
+            Mutex::Autolock lock(m_lock);
+            m_numOfReuse++;
+            return frame;
+        }
+
+        CLOGW("failed to revive pooled frame");
+
+        /* the frame is deleted with the last weak ref, out of m_lock */
+        freeFrame.clear();
+
+        Mutex::Autolock lock(m_lock);
+        m_numOfFrames--;
+    }
+}
+
+/*
+ * The in-use check, the reset and the parking are one step under m_lock.
+ * Only getFrame() can bring the strong count back from 0 and it only
+ * revives parked frames, so a frame that is not in use here stays unused.
+ */
+bool ExynosCameraFramePool::releaseFrame(ExynosCameraFrame *frame)
+{
+    Mutex::Autolock lock(m_lock);
+
+    if (frame->getStrongCount() > 0)
+        return false;
+
+    /* release the key and the entities now, same as the destructor does */
+    frame->m_deinit();
+    frame->m_deinitDone = true;
+
+    if (m_enable == false || m_numOfFrames > m_maxSize) {
+        /* nobody keeps a weak ref, the frame is deleted by the caller's decWeak() */
+        m_numOfFrames--;
+        return true;
+    }
+
+    m_freeList.push_back(ExynosCameraFrameWP_t(frame));
+
+    return true;
+}
+
+status_t ExynosCameraFramePool::setMaxSize(int32_t maxSize)
+{
+    List<ExynosCameraFrameWP_t> trashList;
+
+    if (maxSize <= 0) {
+        CLOGE("invalid pool size(%d)", maxSize);
+        return BAD_VALUE;
+    }
+
+    {
+        Mutex::Autolock lock(m_lock);
+
+        if (m_maxSize != maxSize)
+            CLOGD("pool size is updated (%d) -> (%d)", m_maxSize, maxSize);
+
+        m_maxSize = maxSize;
+        m_trimFreeList(&trashList);
+    }
+
+    /* the parked frames are deleted here, out of m_lock */
+    trashList.clear();
+
+    return NO_ERROR;
+}
+
+status_t ExynosCameraFramePool::prepare(int32_t numOfFrames)
+{
+    List<ExynosCameraFrameSP_sptr_t> frameList;
+    ExynosCameraFrameSP_sptr_t frame = NULL;
+
+    {
+        Mutex::Autolock lock(m_lock);
+
+        for (int32_t i = m_freeList.size(); i < numOfFrames; i++) {
+            frame = m_newFrame();
+            if (frame == NULL)
+                break;
+
+            frameList.push_back(frame);
+        }
+    }
+
+    /* the last strong refs are dropped out of m_lock, frames go to the free list */
+    frame = NULL;
+    frameList.clear();
+
+    return NO_ERROR;
+}
+
+status_t ExynosCameraFramePool::flush(void)
+{
+    List<ExynosCameraFrameWP_t> trashList;
+
+    {
+        Mutex::Autolock lock(m_lock);
+
+        m_enable = false;
+        m_numOfFrames -= m_freeList.size();
+        trashList = m_freeList;
+        m_freeList.clear();
+    }
+
+    trashList.clear();
+
+    return NO_ERROR;
+}
+
+status_t ExynosCameraFramePool::dump(void)
+{
+    Mutex::Autolock lock(m_lock);
+
+    CLOGI("pool frames(%d/%d) free(%zu) highWaterMark(%d) reuse(%ju) fallback(%ju)",
+            m_numOfFrames, m_maxSize, m_freeList.size(), m_highWaterMark,
+            m_numOfReuse, m_numOfFallback);
+
+    return NO_ERROR;
+}
+
+ExynosCameraFrameSP_sptr_t ExynosCameraFramePool::m_newFrame(void)
+{
+    ExynosCameraFrameSP_sptr_t frame = NULL;
+
+    if (m_enable == false || m_numOfFrames >= m_maxSize)
+        return NULL;
+
+    frame = new ExynosCameraFrame(m_cameraId);
+    frame->m_setFramePool(this);
+
+    m_numOfFrames++;
+    if (m_highWaterMark < m_numOfFrames)
+        m_highWaterMark = m_numOfFrames;
+
+    return frame;
+}
+
+void ExynosCameraFramePool::m_trimFreeList(List<ExynosCameraFrameWP_t> *trashList)
+{
+    while (m_numOfFrames > m_maxSize && m_freeList.empty() == false) {
+        trashList->push_back(*m_freeList.begin());
+        m_freeList.erase(m_freeList.begin());
+        m_numOfFrames--;
+    }
+}
+
 FrameWorker::FrameWorker(const char* name, int cameraid, FRAMEMGR_OPER::MODE operMode)
 {
     m_cameraId = cameraid;
@@ -66,6 +274,12 @@ status_t FrameWorker::setKey(uint32_t key)
     return 0;
 }
 
+status_t FrameWorker::setPoolSize(__unused int32_t size)
+{
+    CLOGE(" do not support setPoolSize function.");
+    return INVALID_OPERATION;
+}
+
 status_t FrameWorker::dump()
 {
     CLOGE(" do not support dump function.");
@@ -141,6 +355,9 @@ CreateWorker::CreateWorker(const char* name,
             operMode, minMargin, maxMargin);
     m_init();
     m_setMargin(maxMargin, minMargin);
+
+    if (m_framePool != NULL)
+        m_framePool->setMaxSize(m_getMargin(FRAME_MARGIN_MAX));
 }
 CreateWorker::~CreateWorker()
 {
@@ -166,6 +383,25 @@ status_t CreateWorker::m_deinit()
             m_lock = NULL;
         }
 
+        break;
+    case FRAMEMGR_OPER::POOL:
+        m_setEnable(false);
+        if (m_framePool != NULL) {
+            m_framePool->dump();
+            m_framePool->flush();
+            m_framePool = NULL;
+        }
+
+        if (m_worklist != NULL) {
+            delete m_worklist;
+            m_worklist = NULL;
+        }
+
+        if (m_lock != NULL) {
+            delete m_lock;
+            m_lock = NULL;
+        }
+
         break;
     case FRAMEMGR_OPER::SLIENT:
         m_setEnable(false);
@@ -232,9 +468,31 @@ status_t CreateWorker::setMargin(int32_t max, int32_t min)
 
     m_setMargin(max, min);
 
+    if (m_framePool != NULL)
+        m_framePool->setMaxSize(m_getMargin(FRAME_MARGIN_MAX));
+
     return ret;
 }
 
+status_t CreateWorker::setPoolSize(int32_t size)
+{
+    if (m_framePool == NULL) {
+        CLOGE(" operMode is not POOL operMode(%d)", m_operMode);
+        return INVALID_OPERATION;
+    }
+
+    /* the pool has its own lock, so it can be resized while running */
+    return m_framePool->setMaxSize(size);
+}
+
+status_t CreateWorker::dump()
+{
+    if (m_framePool == NULL)
+        return FrameWorker::dump();
+
+    return m_framePool->dump();
+}
+
 status_t CreateWorker::start()
 {
     if (m_worklist->getSizeOfProcessQ() > 0) {
@@ -247,6 +505,11 @@ status_t CreateWorker::start()
     case FRAMEMGR_OPER::ONDEMAND:
         m_setEnable(true);
         break;
+    case FRAMEMGR_OPER::POOL:
+        /* allocate the steady state frames before the first request */
+        m_framePool->prepare(m_getMargin(FRAME_MARGIN_MIN));
+        m_setEnable(true);
+        break;
     case FRAMEMGR_OPER::SLIENT:
         m_setEnable(true);
         m_command.sendCommand(FrameWorkerCommand::START);
@@ -271,6 +534,11 @@ status_t CreateWorker::stop()
     case FRAMEMGR_OPER::ONDEMAND:
         m_setEnable(false);
         break;
+    case FRAMEMGR_OPER::POOL:
+        /* free frames stay in the pool for the next start */
+        m_setEnable(false);
+        m_framePool->dump();
+        break;
     case FRAMEMGR_OPER::SLIENT:
         m_setEnable(false);
         m_command.sendCommand(FrameWorkerCommand::STOP);
@@ -301,6 +569,13 @@ ExynosCameraFrameSP_sptr_t CreateWorker::m_execute()
     case FRAMEMGR_OPER::ONDEMAND:
         frame = new ExynosCameraFrame(m_cameraId);
         break;
+    case FRAMEMGR_OPER::POOL:
+        frame = m_framePool->getFrame();
+        if (frame == NULL) {
+            /* pool is exhausted, this frame is not recycled */
+            frame = new ExynosCameraFrame(m_cameraId);
+        }
+        break;
     case FRAMEMGR_OPER::SLIENT:
         m_worklist->popProcessQ(&frame);
         if (frame == NULL) {
@@ -333,6 +608,11 @@ status_t CreateWorker::m_init()
         m_worklist = new frame_manager_queue_t;
         m_lock = new Mutex();
         break;
+    case FRAMEMGR_OPER::POOL:
+        m_framePool = new ExynosCameraFramePool("FRAME POOL", m_cameraId, CREATE_WORKER_DEFAULT_MARGIN_MAX);
+        m_worklist = new frame_manager_queue_t;
+        m_lock = new Mutex();
+        break;
     case FRAMEMGR_OPER::SLIENT:
         m_thread =  new FrameManagerThread(this,
                                         static_cast<func_ptr_t_>(&CreateWorker::workerMain),
@@ -1152,6 +1432,23 @@ int ExynosCameraFrameManager::getOperMode()
     return m_getOperMode();
 }
 
+status_t ExynosCameraFrameManager::setPoolSize(int32_t size)
+{
+    Mutex::Autolock lock(m_stateLock);
+    map<uint32_t, sp<FrameWorker> >::iterator iter;
+
+    if (m_operMode != FRAMEMGR_OPER::POOL)
+        return INVALID_OPERATION;
+
+    iter = m_workerList.find(FRAMEMGR_WORKER::CREATE);
+    if (iter == m_workerList.end()) {
+        CLOGE("do not find worker(%d) !!", FRAMEMGR_WORKER::CREATE);
+        return INVALID_OPERATION;
+    }
+
+    return iter->second->setPoolSize(size);
+}
+
 status_t ExynosCameraFrameManager::m_init()
 {
     int ret = FRAMEMGR_ERRCODE::OK;
@@ -1320,6 +1617,7 @@ ExynosCameraFrameSP_sptr_t ExynosCameraFrameManager::m_createFrame(ExynosCameraC
     switch (m_operMode) {
     case FRAMEMGR_OPER::ONDEMAND:
     case FRAMEMGR_OPER::SLIENT:
+    case FRAMEMGR_OPER::POOL:
         worker->execute(NULL, frame);
         if (frame == NULL) {
             CLOGE("Frame is NULL");
@@ -1360,7 +1658,15 @@ ExynosCameraFrameSP_sptr_t ExynosCameraFrameManager::m_createFrame(ExynosCameraC
 
 status_t ExynosCameraFrameManager::dump()
 {
+    Mutex::Autolock lock(m_stateLock);
     status_t ret = FRAMEMGR_ERRCODE::OK;
+    map<uint32_t, sp<FrameWorker> >::iterator iter;
+
+    if (m_operMode == FRAMEMGR_OPER::POOL) {
+        iter = m_workerList.find(FRAMEMGR_WORKER::CREATE);
+        if (iter != m_workerList.end())
+            ret = iter->second->dump();
+    }
 
     return ret;
 }
@@ -1396,6 +1702,7 @@ status_t ExynosCameraFrameManager::m_setOperMode(FRAMEMGR_OPER::MODE mode)
     switch (mode) {
     case FRAMEMGR_OPER::ONDEMAND:
     case FRAMEMGR_OPER::SLIENT:
+    case FRAMEMGR_OPER::POOL:
         m_operMode = mode;
         break;
     default:
@@ -73,7 +73,8 @@ namespace FRAMEMGR_OPER {
     enum MODE {
         NONE      = 0,
         ONDEMAND  = 1,
-        SLIENT    = 2
+        SLIENT    = 2,
+        POOL      = 3
     };
 };
 
@@ -97,6 +98,9 @@ namespace DEBUG_LEVEL {
 
 #define EXYNOS_CAMERA_FRAME_CREATE_PERFORMANCE /* framecreate performance */
 
+#define FRAME_POOL_SIZE_DEFAULT   (100)
+#define FRAME_POOL_SIZE_HIGHSPEED (300)
+
 class KeyBox : public virtual RefBase{
 public:
     KeyBox(const char* name, int cameraid) {
@@ -140,6 +144,45 @@ private:
 };
 
 
+/*
+ * Recycles ExynosCameraFrame objects for FRAMEMGR_OPER::POOL.
+ * A pooled frame is reset by ExynosCameraFrame::onLastStrongRef() and parked
+ * here as a weak pointer, so the next getFrame() revives it instead of
+ * allocating a new frame with its metadata storage.
+ */
+class ExynosCameraFramePool : public virtual RefBase {
+
+public:
+    ExynosCameraFramePool(const char* name, int cameraid, int32_t maxSize);
+    virtual ~ExynosCameraFramePool();
+
+    ExynosCameraFrameSP_sptr_t getFrame(void);
+    status_t                setMaxSize(int32_t maxSize);
+    status_t                prepare(int32_t numOfFrames);
+    status_t                flush(void);
+    status_t                dump(void);
+
+    /* ACCESS allowed only ExynosCameraFrame */
+    bool                    releaseFrame(ExynosCameraFrame *frame);
+
+private:
+    ExynosCameraFrameSP_sptr_t m_newFrame(void);
+    void                    m_trimFreeList(List<ExynosCameraFrameWP_t> *trashList);
+
+private:
+    int                     m_cameraId;
+    char                    m_name[EXYNOS_CAMERA_NAME_STR_SIZE];
+    mutable Mutex           m_lock;
+    List<ExynosCameraFrameWP_t> m_freeList;
+    bool                    m_enable;
+    int32_t                 m_maxSize;
+    /* frames owned by the pool, in use and free */
+    int32_t                 m_numOfFrames;
+    int32_t                 m_highWaterMark;
+    uint64_t                m_numOfReuse;
+    uint64_t                m_numOfFallback;
+};
+
 class FrameWorker : public virtual RefBase {
 
 public:
@@ -153,6 +196,7 @@ public:
 
     virtual status_t        execute(ExynosCameraFrameSP_sptr_t inframe, ExynosCameraFrameSP_dptr_t outframe) = 0;
     virtual status_t        setMargin(int32_t max, int32_t min) = 0;
+    virtual status_t        setPoolSize(int32_t size);
     virtual status_t        start() = 0;
     virtual status_t        stop() = 0;
     virtual status_t        dump();
@@ -223,8 +267,10 @@ public:
 
     virtual status_t        execute(ExynosCameraFrameSP_sptr_t inframe, ExynosCameraFrameSP_dptr_t outframe);
     virtual status_t        setMargin(int32_t max, int32_t min);
+    virtual status_t        setPoolSize(int32_t size);
     virtual status_t        start();
     virtual status_t        stop();
+    virtual status_t        dump();
 
 protected:
     virtual bool            workerMain();
@@ -238,6 +284,7 @@ private:
 private:
     frame_manager_queue_t   *m_worklist;
     mutable Mutex           *m_lock;
+    sp<ExynosCameraFramePool> m_framePool;
 
 #if defined EXYNOS_CAMERA_FRAME_CREATE_PERFORMANCE
     ExynosCameraDurationTimer	m_createTimer;
@@ -333,6 +380,7 @@ public:
 
     status_t            setOperMode(FRAMEMGR_OPER::MODE mode);
     int                 getOperMode();
+    status_t            setPoolSize(int32_t size);
 
     status_t            start();
     status_t            stop();
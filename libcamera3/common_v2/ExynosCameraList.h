@@ -31,6 +31,7 @@
 
 #include <fcntl.h>
 #include <unistd.h>
+#include <sched.h>
 #include <errno.h>
 #include <signal.h>
 #include <sys/mman.h>
@@ -46,9 +47,13 @@
 #include <utils/List.h>
 #include "cutils/properties.h"
 
+#include "ExynosCameraRingQueue.h"
+
 #define THREAD_NAME_DEFAULT "ExynosList%d"
 #define WAIT_TIME (150 * 1000000)
 #define DEFAULT_PROCESSQ_MARGIN (1)
+#define DEFAULT_RING_CAPACITY (32)
+#define LISTENER_WAIT_TIME (100) /* us */
 
 using namespace android;
 
@@ -56,6 +61,15 @@ enum LIST_CMD {
     WAKE_UP = 1,
 };
 
+/* told about every push, outside the queue lock, so it may pop */
+template<typename T>
+class ExynosCameraListListener {
+public:
+    virtual ~ExynosCameraListListener() {}
+
+    virtual void onPushProcessQ(T *buf) = 0;
+};
+
 template<typename T>
 class ExynosCameraList {
 public:
@@ -69,6 +83,10 @@ public:
         m_waitTime = WAIT_TIME;
         m_thread = NULL;
         m_processQMargin = processQMargin;
+        m_ring = NULL;
+        m_overflowCount = 0;
+        m_listener = NULL;
+        m_listenerCalls = 0;
     }
 
     ExynosCameraList(sp<Thread> thread, uint32_t processQMargin = DEFAULT_PROCESSQ_MARGIN)
@@ -80,11 +98,45 @@ public:
 
         m_thread = thread;
         m_processQMargin = processQMargin;
+        m_ring = NULL;
+        m_overflowCount = 0;
+        m_listener = NULL;
+        m_listenerCalls = 0;
     }
 
     ~ExynosCameraList()
     {
+        setListener(NULL);
         release();
+
+        if (m_ring != NULL)
+            delete m_ring;
+    }
+
+    /*
+     * Switch the process queue to the lock-free ring.
+     * Must be called before the first push. Pushes that find the ring
+     * full spill into the locked list, so nothing is dropped.
+     * getRawProcessList() only covers the spilled items in this mode,
+     * so do not use it on queues that are walked in place.
+     */
+    status_t setRingMode(uint32_t capacity = DEFAULT_RING_CAPACITY)
+    {
+        Mutex::Autolock lock(m_processQMutex);
+
+        if (m_ring != NULL || m_processQ.size() > 0) {
+            ALOGE("ERR(%s[%d]):ring mode must be set on an unused queue", __FUNCTION__, __LINE__);
+            return INVALID_OPERATION;
+        }
+
+        m_ring = new ExynosCameraRingQueue<T>(capacity);
+
+        return NO_ERROR;
+    }
+
+    bool isRingMode(void)
+    {
+        return (m_ring != NULL);
     }
 
     void setName(const char* name, ...)
@@ -108,10 +160,29 @@ public:
         m_processQMutex.unlock();
     }
 
+    /*
+     * The listener runs the consumer instead of a thread : set it with
+     * setup(NULL), before the first push.
+     * Returns once no push calls the old listener, so it may go away.
+     * Must not be called from the listener.
+     */
+    void setListener(ExynosCameraListListener<T> *listener)
+    {
+        m_listener.store(listener);
+
+        while (m_listenerCalls.load() > 0)
+            usleep(LISTENER_WAIT_TIME);
+    }
+
     void wakeupAll(void)
     {
         setStatusException(TIMED_OUT);
 
+        if (m_ring != NULL) {
+            m_ring->wake(true);
+            return;
+        }
+
         Mutex::Autolock lock(m_processQMutex);
         if (m_waitProcessQ)
             m_processQCondition.signal();
@@ -144,57 +215,41 @@ public:
     /* Process Queue */
     void pushProcessQ(T *buf)
     {
-        status_t ret = NO_ERROR;
-        int retryCount = 3;
-        bool retryFlag = false;
+        ExynosCameraListListener<T> *listener = NULL;
 
         if (buf == NULL) {
             ALOGW("WARN(%s[%d]):Input buf is NULL", __FUNCTION__, __LINE__);
             return;
         }
 
-        Mutex::Autolock lock(m_processQMutex);
-        m_processQ.push_back(*buf);
+        if (m_ring != NULL) {
+            m_pushRing(buf);
+        } else {
+            Mutex::Autolock lock(m_processQMutex);
+            m_processQ.push_back(*buf);
 
-        if (m_waitProcessQ && m_processQ.size() >= m_processQMargin) {
-            m_processQCondition.signal();
-        } else if (m_thread != NULL && m_thread->isRunning() == false && m_processQ.size() >= m_processQMargin) {
-            do {
-                if (m_name.empty())
-                    setName(THREAD_NAME_DEFAULT, gettid());
-
-                ret = m_thread->run(m_name.c_str());
-                switch (ret) {
-                    case INVALID_OPERATION:
-                        /* Already running */
-                        ALOGW("WARN(%s[%d]):[TID %d]Failed to run thread. Already running.",
-                                __FUNCTION__, __LINE__, m_thread->getTid());
-
-                        retryFlag = false;
-                        break;
-                    case UNKNOWN_ERROR:
-                        /* Failed to run thread */
-                        ALOGE("ERR(%s[%d]):[TID %d]Failed to run Thread. Unknown error. Retry. RemainCount %d",
-                                __FUNCTION__, __LINE__, m_thread->getTid(), retryCount);
-
-                        retryFlag = true;
-                        break;
-                    default:
-                        /* Success to run thread */
-                        ALOGV("DEBUG(%s[%d]):[TID %d]Success to run thread",
-                                __FUNCTION__, __LINE__, m_thread->getTid());
-
-                        retryFlag = false;
-                        break;
-                }
-            } while (retryFlag == true && retryCount-- > 0);
+            if (m_waitProcessQ && m_processQ.size() >= m_processQMargin) {
+                m_processQCondition.signal();
+            } else if (m_thread != NULL && m_thread->isRunning() == false && m_processQ.size() >= m_processQMargin) {
+                m_runThread();
+            }
         }
+
+        /* counted before the load : setListener() waits for this call */
+        m_listenerCalls++;
+        listener = m_listener.load();
+        if (listener != NULL)
+            listener->onPushProcessQ(buf);
+        m_listenerCalls--;
     };
 
     status_t popProcessQ(T *buf)
     {
         iterator r;
 
+        if (m_ring != NULL)
+            return m_popRing(buf);
+
         Mutex::Autolock lock(m_processQMutex);
         if (m_processQ.empty())
             return TIMED_OUT;
@@ -211,6 +266,10 @@ public:
         iterator r;
 
         status_t ret;
+
+        if (m_ring != NULL)
+            return m_waitAndPopRing(buf);
+
         m_processQMutex.lock();
         if (m_processQ.size() < m_processQMargin) {
             m_waitProcessQ = true;
@@ -257,6 +316,9 @@ public:
 
     int getSizeOfProcessQ(void)
     {
+        if (m_ring != NULL)
+            return m_ring->size() + m_overflowCount.load();
+
         Mutex::Autolock lock(m_processQMutex);
         return m_processQ.size();
     };
@@ -266,6 +328,21 @@ public:
     {
         setStatusException(TIMED_OUT);
 
+        if (m_ring != NULL) {
+            T item;
+            int remained = 0;
+
+            m_ring->wake(true);
+
+            while (m_ring->pop(&item) == true)
+                remained++;
+
+            if (remained > 0) {
+                ALOGD("DEBUG(%s):Remained item %d in ring will be deleted",
+                        __FUNCTION__, remained);
+            }
+        }
+
         m_processQMutex.lock();
         if (m_waitProcessQ)
             m_processQCondition.signal();
@@ -276,6 +353,7 @@ public:
         }
 
         m_processQ.clear();
+        m_overflowCount = 0;
         m_processQMutex.unlock();
     };
 
@@ -286,6 +364,9 @@ public:
     }
 
     bool isWaiting(void) {
+        if (m_ring != NULL)
+            return (m_ring->getSleepers() > 0);
+
         Mutex::Autolock lock(m_processQMutex);
         return m_waitProcessQ;
     }
@@ -306,6 +387,146 @@ public:
     }
 
 private:
+    /* called with m_processQMutex held */
+    void m_runThread(void)
+    {
+        status_t ret = NO_ERROR;
+        int retryCount = 3;
+        bool retryFlag = false;
+
+        do {
+            if (m_name.empty())
+                setName(THREAD_NAME_DEFAULT, gettid());
+
+            ret = m_thread->run(m_name.c_str());
+            switch (ret) {
+                case INVALID_OPERATION:
+                    /* Already running */
+                    ALOGW("WARN(%s[%d]):[TID %d]Failed to run thread. Already running.",
+                            __FUNCTION__, __LINE__, m_thread->getTid());
+
+                    retryFlag = false;
+                    break;
+                case UNKNOWN_ERROR:
+                    /* Failed to run thread */
+                    ALOGE("ERR(%s[%d]):[TID %d]Failed to run Thread. Unknown error. Retry. RemainCount %d",
+                            __FUNCTION__, __LINE__, m_thread->getTid(), retryCount);
+
+                    retryFlag = true;
+                    break;
+                default:
+                    /* Success to run thread */
+                    ALOGV("DEBUG(%s[%d]):[TID %d]Success to run thread",
+                            __FUNCTION__, __LINE__, m_thread->getTid());
+
+                    retryFlag = false;
+                    break;
+            }
+        } while (retryFlag == true && retryCount-- > 0);
+    }
+
+    void m_pushRing(T *buf)
+    {
+        bool pushed = false;
+
+        /* keep FIFO order : once items spilled, follow them into the list */
+        if (m_overflowCount.load() == 0)
+            pushed = m_ring->push(*buf);
+
+        if (pushed == false) {
+            Mutex::Autolock lock(m_processQMutex);
+
+            if (m_overflowCount.load() == 0)
+                pushed = m_ring->push(*buf);
+
+            if (pushed == false) {
+                m_processQ.push_back(*buf);
+                m_overflowCount++;
+
+                if (m_ring->getSleepers() > 0)
+                    m_ring->wake(false);
+            }
+        }
+
+        if (m_thread != NULL
+            && m_ring->getSleepers() == 0
+            && (uint32_t)getSizeOfProcessQ() >= m_processQMargin) {
+            Mutex::Autolock lock(m_processQMutex);
+
+            if (m_thread->isRunning() == false)
+                m_runThread();
+        }
+    }
+
+    status_t m_popRing(T *buf)
+    {
+        iterator r;
+
+        if (m_ring->pop(buf) == true)
+            return OK;
+
+        if (m_overflowCount.load() == 0)
+            return TIMED_OUT;
+
+        Mutex::Autolock lock(m_processQMutex);
+
+        /* a producer may have refilled the ring before the list drained */
+        if (m_processQ.empty())
+            return (m_ring->pop(buf) == true) ? OK : TIMED_OUT;
+
+        r = m_processQ.begin();
+        *buf = *r;
+        m_processQ.erase(r);
+        m_overflowCount--;
+
+        return OK;
+    }
+
+    status_t m_waitAndPopRing(T *buf)
+    {
+        status_t ret;
+        nsecs_t deadline = 0;
+        nsecs_t remain;
+
+        for (;;) {
+            if ((uint32_t)getSizeOfProcessQ() >= m_processQMargin) {
+                if (m_popRing(buf) == OK)
+                    return OK;
+
+                /*
+                 * size() counts the cells producers have reserved, a pop misses
+                 * until the item is published. That is a matter of a few
+                 * instructions on the producer side, so do not sleep on it.
+                 */
+                sched_yield();
+            }
+
+            if (deadline == 0) {
+                deadline = systemTime(SYSTEM_TIME_MONOTONIC) + m_waitTime;
+                setStatusException(NO_ERROR);
+            }
+
+            remain = deadline - systemTime(SYSTEM_TIME_MONOTONIC);
+            if (remain <= 0) {
+                ALOGV("DEBUG(%s):Time out, Skip to pop process Q", __FUNCTION__);
+                return TIMED_OUT;
+            }
+
+            if ((uint32_t)getSizeOfProcessQ() < m_processQMargin)
+                m_ring->wait(m_processQMargin, remain);
+
+            ret = getStatusException();
+            if (ret != NO_ERROR) {
+                if (ret == TIMED_OUT) {
+                    ALOGV("DEBUG(%s):return CAM_ECANCELED.(%d).", __FUNCTION__, ret);
+                } else {
+                    ALOGW("WARN(%s[%d]): Exception status(%d)", __FUNCTION__, __LINE__, ret);
+                }
+                return ret;
+            }
+        }
+    }
+
     List<T>             m_processQ;
     Mutex               m_processQMutex;
     Mutex               m_flagMutex;
@@ -318,5 +539,13 @@ private:
 
     String8             m_name;
     sp<Thread>          m_thread;
+
+    /* lock-free backend, NULL for the list */
+    ExynosCameraRingQueue<T>    *m_ring;
+    std::atomic<uint32_t>       m_overflowCount;
+
+    std::atomic<ExynosCameraListListener<T> *> m_listener;
+    /* pushes between the listener load and the end of its call */
+    std::atomic<uint32_t>       m_listenerCalls;
 };
 #endif
@@ -32,6 +32,34 @@ namespace android {
 #define META_VALIDATE_CHECK(x)
 #endif
 
+#define META_DELTA_GROUP_TAG_MAX    (4)
+#define CTL_MEMBER(member)          offsetof(struct camera2_ctl, member), sizeof(((struct camera2_ctl *)0)->member)
+
+static const struct {
+    uint32_t tag[META_DELTA_GROUP_TAG_MAX];
+    size_t   ctlOffset;
+    size_t   ctlSize;
+} META_DELTA_GROUP_INFO[META_DELTA_GROUP_MAX] = {
+    /* META_DELTA_GROUP_COLOR */
+    {{ANDROID_COLOR_CORRECTION_MODE, ANDROID_COLOR_CORRECTION_TRANSFORM,
+      ANDROID_COLOR_CORRECTION_GAINS, ANDROID_COLOR_CORRECTION_ABERRATION_MODE}, CTL_MEMBER(color)},
+    /* META_DELTA_GROUP_DEMOSAIC */
+    {{ANDROID_DEMOSAIC_MODE}, CTL_MEMBER(demosaic)},
+    /* META_DELTA_GROUP_EDGE */
+    {{ANDROID_EDGE_STRENGTH, ANDROID_EDGE_MODE}, CTL_MEMBER(edge)},
+    /* META_DELTA_GROUP_HOTPIXEL */
+    {{ANDROID_HOT_PIXEL_MODE}, CTL_MEMBER(hotpixel)},
+    /* META_DELTA_GROUP_NOISE */
+    {{ANDROID_NOISE_REDUCTION_STRENGTH, ANDROID_NOISE_REDUCTION_MODE}, CTL_MEMBER(noise)},
+    /* META_DELTA_GROUP_SHADING */
+    {{ANDROID_SHADING_MODE, ANDROID_SHADING_STRENGTH}, CTL_MEMBER(shading)},
+    /* META_DELTA_GROUP_TONEMAP */
+    {{ANDROID_TONEMAP_MODE, ANDROID_TONEMAP_CURVE_BLUE,
+      ANDROID_TONEMAP_CURVE_GREEN, ANDROID_TONEMAP_CURVE_RED}, CTL_MEMBER(tonemap)},
+    /* META_DELTA_GROUP_BLACKLEVEL */
+    {{ANDROID_BLACK_LEVEL_LOCK}, CTL_MEMBER(blacklevel)},
+};
+
 
 ExynosCameraMetadataConverter::ExynosCameraMetadataConverter(int cameraId,
                                                              ExynosCameraConfigurations *configurations,
@@ -65,6 +93,14 @@ ExynosCameraMetadataConverter::ExynosCameraMetadataConverter(int cameraId,
     memset(m_frameCountMap, 0x00, sizeof(m_frameCountMap));
     memset(m_name, 0x00, sizeof(m_name));
     m_prevMeta = NULL;
+
+    m_deltaTranslation = true;
+    memset(m_deltaGroupValid, 0x00, sizeof(m_deltaGroupValid));
+    memset(m_deltaGroupHash, 0x00, sizeof(m_deltaGroupHash));
+    memset(&m_deltaCtl, 0x00, sizeof(m_deltaCtl));
+    m_deltaAaMode = AA_CONTROL_OFF;
+    m_deltaSceneMode = AA_SCENE_MODE_DISABLED;
+    memset(&m_translationStat, 0x00, sizeof(m_translationStat));
 #ifdef SUPPORT_MULTI_AF
     m_flagMultiAf = false;
 #endif
@@ -2629,6 +2665,105 @@ void ExynosCameraMetadataConverter::setPreviousMeta(CameraMetadata *meta)
     m_prevMeta = meta;
 }
 
+void ExynosCameraMetadataConverter::setDeltaTranslation(bool enable)
+{
+    CLOGD("delta translation(%d)", enable);
+
+    m_deltaTranslation = enable;
+    memset(m_deltaGroupValid, 0x00, sizeof(m_deltaGroupValid));
+}
+
+void ExynosCameraMetadataConverter::getTranslationStat(struct meta_translation_stat *stat)
+{
+    if (stat == NULL)
+        return;
+
+    *stat = m_translationStat;
+}
+
+uint64_t ExynosCameraMetadataConverter::m_hashMetaGroup(CameraMetadata *settings, enum meta_delta_group group)
+{
+    camera_metadata_ro_entry_t entry;
+    const uint8_t *data;
+    size_t dataSize;
+    /* FNV-1a */
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (int i = 0; i < META_DELTA_GROUP_TAG_MAX; i++) {
+        uint32_t tag = META_DELTA_GROUP_INFO[group].tag[i];
+        if (tag == 0)
+            break;
+
+        entry = ((const CameraMetadata *)settings)->find(tag);
+
+        hash = (hash ^ tag) * 0x100000001b3ULL;
+        hash = (hash ^ entry.count) * 0x100000001b3ULL;
+        if (entry.count == 0)
+            continue;
+
+        data = entry.data.u8;
+        dataSize = camera_metadata_type_size[entry.type] * entry.count;
+        for (size_t j = 0; j < dataSize; j++)
+            hash = (hash ^ data[j]) * 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+bool ExynosCameraMetadataConverter::m_restoreMetaGroup(CameraMetadata *settings,
+                                                       struct camera2_shot_ext *dst_ext,
+                                                       enum meta_delta_group group)
+{
+    uint64_t hash;
+
+    if (m_deltaTranslation == false)
+        return false;
+
+    hash = m_hashMetaGroup(settings, group);
+    if (m_deltaGroupValid[group] == true && m_deltaGroupHash[group] == hash) {
+        memcpy((char *)&dst_ext->shot.ctl + META_DELTA_GROUP_INFO[group].ctlOffset,
+               (char *)&m_deltaCtl + META_DELTA_GROUP_INFO[group].ctlOffset,
+               META_DELTA_GROUP_INFO[group].ctlSize);
+        dst_ext->shot.magicNumber = SHOT_MAGIC_NUMBER;
+        return true;
+    }
+
+    /* Translated again, m_storeMetaGroup() validates the new hash */
+    m_deltaGroupHash[group] = hash;
+    m_deltaGroupValid[group] = false;
+
+    return false;
+}
+
+void ExynosCameraMetadataConverter::m_storeMetaGroup(struct camera2_shot_ext *dst_ext, enum meta_delta_group group)
+{
+    if (m_deltaTranslation == false)
+        return;
+
+    memcpy((char *)&m_deltaCtl + META_DELTA_GROUP_INFO[group].ctlOffset,
+           (char *)&dst_ext->shot.ctl + META_DELTA_GROUP_INFO[group].ctlOffset,
+           META_DELTA_GROUP_INFO[group].ctlSize);
+    m_deltaGroupValid[group] = true;
+}
+
+/*
+ * translateControlControlData() lets the scene mode override the edge, noise
+ * and color controls, so the stored groups hold the override of the scene
+ * mode they were translated under : a new scene mode drops them.
+ */
+void ExynosCameraMetadataConverter::m_checkMetaGroupSceneMode(struct camera2_shot_ext *dst_ext)
+{
+    if (m_deltaTranslation == false)
+        return;
+
+    if (dst_ext->shot.ctl.aa.mode == m_deltaAaMode && dst_ext->shot.ctl.aa.sceneMode == m_deltaSceneMode)
+        return;
+
+    m_deltaAaMode = dst_ext->shot.ctl.aa.mode;
+    m_deltaSceneMode = dst_ext->shot.ctl.aa.sceneMode;
+    memset(m_deltaGroupValid, 0x00, sizeof(m_deltaGroupValid));
+}
+
 status_t ExynosCameraMetadataConverter::convertRequestToShot(ExynosCameraRequestSP_sprt_t request, int *reqId)
 {
     status_t ret = OK;
@@ -2636,6 +2771,8 @@ status_t ExynosCameraMetadataConverter::convertRequestToShot(ExynosCameraRequest
     struct camera2_shot_ext *dst_ext = NULL;
     CameraMetadata *meta;
     struct CameraMetaParameters *metaParameters = NULL;
+    uint32_t skipGroupCount = 0;
+    nsecs_t startTime = systemTime(SYSTEM_TIME_MONOTONIC);
     request->setRequestLock();
 
     meta = request->getServiceMeta();
@@ -2663,24 +2800,49 @@ status_t ExynosCameraMetadataConverter::convertRequestToShot(ExynosCameraRequest
 
     META_VALIDATE_CHECK(meta);
 
-    ret = translateColorControlData(meta, dst_ext);
-    if (ret != OK)
-        errorFlag |= (1 << 0);
+    if (m_restoreMetaGroup(meta, dst_ext, META_DELTA_GROUP_COLOR) == true) {
+        skipGroupCount++;
+    } else {
+        ret = translateColorControlData(meta, dst_ext);
+        if (ret != OK)
+            errorFlag |= (1 << 0);
+        else
+            m_storeMetaGroup(dst_ext, META_DELTA_GROUP_COLOR);
+    }
     ret = translateControlControlData(meta, dst_ext, metaParameters);
     if (ret != OK)
         errorFlag |= (1 << 1);
-    ret = translateDemosaicControlData(meta, dst_ext);
-    if (ret != OK)
-        errorFlag |= (1 << 2);
-    ret = translateEdgeControlData(meta, dst_ext);
-    if (ret != OK)
-        errorFlag |= (1 << 3);
+    m_checkMetaGroupSceneMode(dst_ext);
+    if (m_restoreMetaGroup(meta, dst_ext, META_DELTA_GROUP_DEMOSAIC) == true) {
+        skipGroupCount++;
+    } else {
+        ret = translateDemosaicControlData(meta, dst_ext);
+        if (ret != OK)
+            errorFlag |= (1 << 2);
+        else
+            m_storeMetaGroup(dst_ext, META_DELTA_GROUP_DEMOSAIC);
+    }
+    if (m_restoreMetaGroup(meta, dst_ext, META_DELTA_GROUP_EDGE) == true) {
+        skipGroupCount++;
+    } else {
+        ret = translateEdgeControlData(meta, dst_ext);
+        if (ret != OK)
+            errorFlag |= (1 << 3);
+        else
+            m_storeMetaGroup(dst_ext, META_DELTA_GROUP_EDGE);
+    }
     ret = translateFlashControlData(meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 4);
-    ret = translateHotPixelControlData(meta, dst_ext);
-    if (ret != OK)
-        errorFlag |= (1 << 5);
+    if (m_restoreMetaGroup(meta, dst_ext, META_DELTA_GROUP_HOTPIXEL) == true) {
+        skipGroupCount++;
+    } else {
+        ret = translateHotPixelControlData(meta, dst_ext);
+        if (ret != OK)
+            errorFlag |= (1 << 5);
+        else
+            m_storeMetaGroup(dst_ext, META_DELTA_GROUP_HOTPIXEL);
+    }
     ret = translateJpegControlData(meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 6);
@@ -2690,33 +2852,65 @@ status_t ExynosCameraMetadataConverter::convertRequestToShot(ExynosCameraRequest
     ret = translateLensControlData(meta, dst_ext, metaParameters);
     if (ret != OK)
         errorFlag |= (1 << 8);
-    ret = translateNoiseControlData(meta, dst_ext);
-    if (ret != OK)
-        errorFlag |= (1 << 9);
+    if (m_restoreMetaGroup(meta, dst_ext, META_DELTA_GROUP_NOISE) == true) {
+        skipGroupCount++;
+    } else {
+        ret = translateNoiseControlData(meta, dst_ext);
+        if (ret != OK)
+            errorFlag |= (1 << 9);
+        else
+            m_storeMetaGroup(dst_ext, META_DELTA_GROUP_NOISE);
+    }
     ret = translateRequestControlData(meta, dst_ext, reqId);
     if (ret != OK)
         errorFlag |= (1 << 10);
     ret = translateSensorControlData(meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 11);
-    ret = translateShadingControlData(meta, dst_ext);
-    if (ret != OK)
-        errorFlag |= (1 << 12);
+    if (m_restoreMetaGroup(meta, dst_ext, META_DELTA_GROUP_SHADING) == true) {
+        skipGroupCount++;
+    } else {
+        ret = translateShadingControlData(meta, dst_ext);
+        if (ret != OK)
+            errorFlag |= (1 << 12);
+        else
+            m_storeMetaGroup(dst_ext, META_DELTA_GROUP_SHADING);
+    }
     ret = translateStatisticsControlData(meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 13);
-    ret = translateTonemapControlData(meta, dst_ext);
-    if (ret != OK)
-        errorFlag |= (1 << 14);
+    if (m_restoreMetaGroup(meta, dst_ext, META_DELTA_GROUP_TONEMAP) == true) {
+        skipGroupCount++;
+    } else {
+        ret = translateTonemapControlData(meta, dst_ext);
+        if (ret != OK)
+            errorFlag |= (1 << 14);
+        else
+            m_storeMetaGroup(dst_ext, META_DELTA_GROUP_TONEMAP);
+    }
     ret = translateLedControlData(meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 15);
-    ret = translateBlackLevelControlData(meta, dst_ext);
-    if (ret != OK)
-        errorFlag |= (1 << 16);
+    if (m_restoreMetaGroup(meta, dst_ext, META_DELTA_GROUP_BLACKLEVEL) == true) {
+        skipGroupCount++;
+    } else {
+        ret = translateBlackLevelControlData(meta, dst_ext);
+        if (ret != OK)
+            errorFlag |= (1 << 16);
+        else
+            m_storeMetaGroup(dst_ext, META_DELTA_GROUP_BLACKLEVEL);
+    }
 
     request->setRequestUnlock();
 
+    m_translationStat.frameCount++;
+    m_translationStat.lastCost = systemTime(SYSTEM_TIME_MONOTONIC) - startTime;
+    m_translationStat.totalCost += m_translationStat.lastCost;
+    m_translationStat.lastSkipGroupCount = skipGroupCount;
+    m_translationStat.totalSkipGroupCount += skipGroupCount;
+    CLOGV("translation cost(%lld ns) skipGroupCount(%d/%d)",
+            (long long)m_translationStat.lastCost, skipGroupCount, META_DELTA_GROUP_MAX);
+
     if (errorFlag != 0) {
         CLOGE("failed to translate Control Data(%d)", errorFlag);
         return INVALID_OPERATION;
@@ -98,6 +98,30 @@ enum metadata_type {
     PARTIAL_MAX,
 };
 
+/*
+ * Tag groups whose translation only depends on their own request tags.
+ * Those can be skipped when the tags did not change since the last request.
+ */
+enum meta_delta_group {
+    META_DELTA_GROUP_COLOR,
+    META_DELTA_GROUP_DEMOSAIC,
+    META_DELTA_GROUP_EDGE,
+    META_DELTA_GROUP_HOTPIXEL,
+    META_DELTA_GROUP_NOISE,
+    META_DELTA_GROUP_SHADING,
+    META_DELTA_GROUP_TONEMAP,
+    META_DELTA_GROUP_BLACKLEVEL,
+    META_DELTA_GROUP_MAX,
+};
+
+struct meta_translation_stat {
+    uint32_t frameCount;
+    nsecs_t  lastCost;              /* nsec spent by the last convertRequestToShot */
+    nsecs_t  totalCost;
+    uint32_t lastSkipGroupCount;
+    uint64_t totalSkipGroupCount;
+};
+
 class ExynosCameraMetadataConverter : public virtual RefBase {
 public:
     ExynosCameraMetadataConverter(int cameraId, ExynosCameraConfigurations *configuraitons,
@@ -112,6 +136,8 @@ public:
     virtual status_t        convertRequestToShot(ExynosCameraRequestSP_sprt_t request, int *reqId = NULL);
     virtual status_t        updateDynamicMeta(ExynosCameraRequestSP_sprt_t requestInfo, enum metadata_type metaType);
     virtual void            setPreviousMeta(CameraMetadata *meta);
+    void                    setDeltaTranslation(bool enable);
+    void                    getTranslationStat(struct meta_translation_stat *stat);
 
     /* meta -> shot */
     virtual status_t        translateColorControlData(CameraMetadata *settings, struct camera2_shot_ext *dst_ext);
@@ -200,6 +226,12 @@ public:
     void                    setSessionParams(const camera_metadata_t *);
 
 private:
+    uint64_t                m_hashMetaGroup(CameraMetadata *settings, enum meta_delta_group group);
+    bool                    m_restoreMetaGroup(CameraMetadata *settings, struct camera2_shot_ext *dst_ext,
+                                               enum meta_delta_group group);
+    void                    m_storeMetaGroup(struct camera2_shot_ext *dst_ext, enum meta_delta_group group);
+    void                    m_checkMetaGroupSceneMode(struct camera2_shot_ext *dst_ext);
+
     static status_t         m_createAvailableCapabilities(const struct ExynosCameraSensorInfoBase *sensorStaticInfo,
                                                           Vector<uint8_t> *capabilities);
     static status_t         m_createAvailableKeys(const struct ExynosCameraSensorInfoBase *sensorStaticInfo,
@@ -303,6 +335,13 @@ private:
     CameraMetadata                  m_defaultRequestSetting;
     CameraMetadata                  m_sessionParams;
     CameraMetadata                  *m_prevMeta;
+    bool                            m_deltaTranslation;
+    bool                            m_deltaGroupValid[META_DELTA_GROUP_MAX];
+    uint64_t                        m_deltaGroupHash[META_DELTA_GROUP_MAX];
+    struct camera2_ctl              m_deltaCtl;
+    enum aa_mode                    m_deltaAaMode;
+    enum aa_scene_mode              m_deltaSceneMode;
+    struct meta_translation_stat    m_translationStat;
     struct ExynosCameraSensorInfoBase *m_sensorStaticInfo;
 
     int                             m_frameCountMapIndex;
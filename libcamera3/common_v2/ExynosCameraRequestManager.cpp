@@ -1249,6 +1249,11 @@ ExynosCameraRequestManager::ExynosCameraRequestManager(int cameraId, ExynosCamer
     for (int i = 0; i < EXYNOS_REQUEST_RESULT::CALLBACK_MAX; i++)
         m_lastResultKey[i] = 0;
 
+    m_coalesceSavedCount = 0;
+    m_coalesceSavedWindowCount = 0;
+    m_coalesceWindowStart = systemTime(SYSTEM_TIME_MONOTONIC);
+    m_coalesceSavedPerSec = 0;
+
     memset(&m_faceDetectMeta, 0x00, sizeof(m_faceDetectMeta));
 }
 
@@ -1261,6 +1266,8 @@ ExynosCameraRequestManager::~ExynosCameraRequestManager()
 
     stopThreadAndInputQ(m_resultCallbackThread, 1, &m_resultCallbackQ);
 
+    m_releaseCoalescedResults();
+
     if (m_notifySequencer != NULL) {
         m_notifySequencer->flush();
         delete m_notifySequencer;
@@ -1411,31 +1418,7 @@ status_t ExynosCameraRequestManager::m_pushBack(ExynosCameraRequestSP_sprt_t ite
 {
     status_t ret = NO_ERROR;
     lock->lock();
-    list->push_back(item);
-    lock->unlock();
-    return ret;
-}
-
-status_t ExynosCameraRequestManager::m_popBack(ExynosCameraRequestSP_dptr_t item, RequestInfoList *list, Mutex *lock)
-{
-    status_t ret = NO_ERROR;
-    lock->lock();
-    if (list->size() > 0) {
-        item = list->back();
-        list->pop_back();
-    } else {
-        CLOGE("m_popBack failed, size(%zu)", list->size());
-        ret = INVALID_OPERATION;
-    }
-    lock->unlock();
-    return ret;
-}
-
-status_t ExynosCameraRequestManager::m_pushFront(ExynosCameraRequestSP_sprt_t item, RequestInfoList *list, Mutex *lock)
-{
-    status_t ret = NO_ERROR;
-    lock->lock();
-    list->push_front(item);
+    list->pushBack(item);
     lock->unlock();
     return ret;
 }
@@ -1444,10 +1427,7 @@ status_t ExynosCameraRequestManager::m_popFront(ExynosCameraRequestSP_dptr_t ite
 {
     status_t ret = NO_ERROR;
     lock->lock();
-    if (list->size() > 0) {
-        item = list->front();
-        list->pop_front();
-    } else {
+    if (list->popFront(&item) == false) {
         CLOGE("m_popFront failed, size(%zu)", list->size());
         ret = INVALID_OPERATION;
     }
@@ -1456,50 +1436,11 @@ status_t ExynosCameraRequestManager::m_popFront(ExynosCameraRequestSP_dptr_t ite
     return ret;
 }
 
-status_t ExynosCameraRequestManager::m_get(uint32_t frameCount,
-                                        ExynosCameraRequestSP_dptr_t item,
-                                        RequestInfoList *list,
-                                        Mutex *lock)
-{
-    status_t ret = INVALID_OPERATION;
-    RequestInfoListIterator iter;
-    ExynosCameraRequestSP_sprt_t request = NULL;
-
-    if (item == NULL) {
-        CLOGE("item is NULL");
-        return BAD_VALUE;
-    }
-
-    if (list == NULL) {
-        CLOGE("list is NULL");
-        return BAD_VALUE;
-    }
-
-    if (lock == NULL) {
-        CLOGE("lock is NULL");
-        return BAD_VALUE;
-    }
-
-    lock->lock();
-    for (iter = list->begin(); iter != list->end(); ++iter) {
-        request = *iter;
-        if (request->getKey() == frameCount) {
-            ret = NO_ERROR;
-            break;
-        }
-    }
-    lock->unlock();
-
-    return ret;
-}
-
 status_t ExynosCameraRequestManager::m_push(ExynosCameraRequestSP_sprt_t request, RequestInfoMap *list, Mutex *lock)
 {
     status_t ret = NO_ERROR;
-    pair<RequestInfoMap::iterator,bool> listRet;
     lock->lock();
-    listRet = list->insert( pair<uint32_t, ExynosCameraRequestSP_sprt_t>(request->getKey(), request));
-    if (listRet.second == false) {
+    if (list->insert(request->getKey(), request) == false) {
         ret = INVALID_OPERATION;
         CLOGE("m_push failed, request already exist!! Request frameCnt( %d )", request->getFrameCount());
     }
@@ -1516,17 +1457,9 @@ status_t ExynosCameraRequestManager::m_pop(uint32_t key,
                                             Mutex *lock)
 {
     status_t ret = NO_ERROR;
-    pair<RequestInfoMap::iterator,bool> listRet;
-    RequestInfoMapIterator iter;
-    ExynosCameraRequestSP_sprt_t request = NULL;
 
     lock->lock();
-    iter = list->find(key);
-    if (iter != list->end()) {
-        request = iter->second;
-        item = request;
-        list->erase( iter );
-    } else {
+    if (list->erase(key, &item) == false) {
         CLOGE("m_pop failed, request is not EXIST Request key(%d)", key);
         ret = INVALID_OPERATION;
     }
@@ -1541,16 +1474,9 @@ status_t ExynosCameraRequestManager::m_get(uint32_t key,
                                            Mutex *lock)
 {
     status_t ret = NO_ERROR;
-    pair<RequestInfoMap::iterator,bool> listRet;
-    RequestInfoMapIterator iter;
-    ExynosCameraRequestSP_sprt_t request = NULL;
 
     lock->lock();
-    iter = list->find(key);
-    if (iter != list->end()) {
-        request = iter->second;
-        item = request;
-    } else {
+    if (list->find(key, &item) == false) {
         CLOGE("m_pop failed, request is not EXIST Request key(%d)", key);
         ret = INVALID_OPERATION;
     }
@@ -1565,48 +1491,47 @@ void ExynosCameraRequestManager::m_printAllServiceRequestInfo(void)
 {
     Mutex::Autolock l(m_requestLock);
 
-    RequestInfoListIterator iter;
-    ExynosCameraRequestSP_sprt_t request;
-    camera3_capture_request_t *serviceRequest;
+    m_serviceRequests.forEach([this](ExynosCameraRequestSP_sprt_t &request) {
+        camera3_capture_request_t *serviceRequest = request->getServiceRequest();
 
-    for (iter = m_serviceRequests.begin(); iter != m_serviceRequests.end(); ++iter) {
-        request = *iter;
-        serviceRequest = request->getServiceRequest();
         CLOGI("key(%d), serviceFrameCount(%d), (%p) frame_number(%d), outputNum(%d)",
                 request->getKey(),
                 request->getFrameCount(),
                 serviceRequest,
                 serviceRequest->frame_number,
                 serviceRequest->num_output_buffers);
-
-    }
+    });
 }
 
-void ExynosCameraRequestManager::m_printAllRequestInfo(RequestInfoMap *map, Mutex *lock)
+void ExynosCameraRequestManager::m_printTranslationStat(void)
 {
-    RequestInfoMapIterator iter;
-    ExynosCameraRequestSP_sprt_t request = NULL;
-    ExynosCameraRequestSP_sprt_t item = NULL;
-    camera3_capture_request_t *serviceRequest = NULL;
+    struct meta_translation_stat stat;
 
-    lock->lock();
-    iter = map->begin();
+    if (m_converter == NULL)
+        return;
 
-    while(iter != map->end()) {
-        request = iter->second;
-        item = request;
+    m_converter->getTranslationStat(&stat);
+    CLOGD("MetaTranslation frameCount(%d) lastCost(%lld ns) avgCost(%lld ns) skipGroupCount(last %d, total %llu)",
+            stat.frameCount, (long long)stat.lastCost,
+            (long long)(stat.frameCount ? stat.totalCost / stat.frameCount : 0),
+            stat.lastSkipGroupCount, (unsigned long long)stat.totalSkipGroupCount);
+}
 
-        serviceRequest = item->getServiceRequest();
+void ExynosCameraRequestManager::m_printAllRequestInfo(RequestInfoMap *map, Mutex *lock)
+{
+    lock->lock();
+    map->forEach([this](uint32_t key, ExynosCameraRequestSP_sprt_t &request) {
+        camera3_capture_request_t *serviceRequest = request->getServiceRequest();
 
         CLOGI("key(%d), serviceFrameCount(%d), (%p) frame_number(%d), outputNum(%d)",
-            request->getKey(),
+            key,
             request->getFrameCount(),
             serviceRequest,
             serviceRequest->frame_number,
             serviceRequest->num_output_buffers);
-
-        iter++;
-    }
+    });
+    if (map->getNumOfOverflow() > 0)
+        CLOGI("ring capacity(%d), overflow(%d)", map->capacity(), map->getNumOfOverflow());
     lock->unlock();
 }
 
@@ -1809,12 +1734,17 @@ status_t ExynosCameraRequestManager::flush()
 
     stopThreadAndInputQ(m_resultCallbackThread, 1, &m_resultCallbackQ);
 
+    /* the results staged by the stopped thread go first */
+    m_sendCoalescedResults(-1, true);
+
     m_callbackFlushTimer.start();
 
     CLOGD("IN+++");
     CLOGD("AllRequestCount(%d), ServiceRequestCount(%d), RunningRequestCount(%d)",
             getAllRequestCount(), getServiceRequestCount(), getRunningRequestCount());
 
+    m_printTranslationStat();
+
     do {
         /*
          * If the flush is operated, the frameCount in request may be an inavlid value.
@@ -1825,11 +1755,13 @@ status_t ExynosCameraRequestManager::flush()
             eraseFromServiceList();
         }
 
-        while (m_runningRequests.begin() != m_runningRequests.end()) {
-            RequestInfoMapIterator requestMapIter = m_runningRequests.begin();
-
-            request = requestMapIter->second;
-            requestKey = request->getKey();
+        while (true) {
+            m_requestLock.lock();
+            if (m_runningRequests.first(&requestKey, &request) == false) {
+                m_requestLock.unlock();
+                break;
+            }
+            m_requestLock.unlock();
 
             notifyMsg = NULL;
             cbType = EXYNOS_REQUEST_RESULT::CALLBACK_NOTIFY_ONLY;
@@ -1997,6 +1929,8 @@ status_t ExynosCameraRequestManager::flush()
         }
     } while (getServiceRequestCount() > 0);
 
+    m_sendCoalescedResults(-1, true);
+
     m_serviceRequests.clear();
     m_runningRequests.clear();
 
@@ -2032,17 +1966,11 @@ status_t ExynosCameraRequestManager::flush()
 status_t ExynosCameraRequestManager::m_getKey(uint32_t *key, uint32_t frameCount)
 {
     status_t ret = NO_ERROR;
-    RequestFrameCountMapIterator iter;
 
-    m_requestFrameCountMapLock.lock();
-    iter = m_requestFrameCountMap.find(frameCount);
-    if (iter != m_requestFrameCountMap.end()) {
-        *key = iter->second;
-    } else {
+    if (m_requestFrameCountMap.find(frameCount, key) == false) {
         CLOGE("get request key is failed. request for framecount(%d) is not EXIST", frameCount);
         ret = INVALID_OPERATION;
     }
-    m_requestFrameCountMapLock.unlock();
 
     return ret;
 }
@@ -2050,18 +1978,11 @@ status_t ExynosCameraRequestManager::m_getKey(uint32_t *key, uint32_t frameCount
 status_t ExynosCameraRequestManager::m_popKey(uint32_t *key, uint32_t frameCount)
 {
     status_t ret = NO_ERROR;
-    RequestFrameCountMapIterator iter;
 
-    m_requestFrameCountMapLock.lock();
-    iter = m_requestFrameCountMap.find(frameCount);
-    if (iter != m_requestFrameCountMap.end()) {
-        *key = iter->second;
-        m_requestFrameCountMap.erase(iter);
-    } else {
+    if (m_requestFrameCountMap.erase(frameCount, key) == false) {
         CLOGE("get request key is failed. request for framecount(%d) is not EXIST", frameCount);
         ret = INVALID_OPERATION;
     }
-    m_requestFrameCountMapLock.unlock();
 
     return ret;
 }
@@ -2095,18 +2016,13 @@ status_t ExynosCameraRequestManager::setCallbackOps(const camera3_callback_ops *
 status_t ExynosCameraRequestManager::setFrameCount(uint32_t frameCount, uint32_t requestKey)
 {
     status_t ret = NO_ERROR;
-    pair<RequestFrameCountMapIterator, bool> listRet;
     ExynosCameraRequestSP_sprt_t request = NULL;
 
-    m_requestFrameCountMapLock.lock();
-    listRet = m_requestFrameCountMap.insert(pair<uint32_t, uint32_t>(frameCount, requestKey));
-    if (listRet.second == false) {
+    if (m_requestFrameCountMap.insert(frameCount, requestKey) == false) {
         ret = INVALID_OPERATION;
         CLOGE("Failed, requestKey(%d) already exist!!", frameCount);
-        m_requestFrameCountMapLock.unlock();
         return ret;
     }
-    m_requestFrameCountMapLock.unlock();
 
     ret = m_get(requestKey, request, &m_runningRequests, &m_requestLock);
     if (ret < 0)
@@ -2191,7 +2107,7 @@ status_t ExynosCameraRequestManager::m_sendCallbackResult(ResultRequest result)
         break;
     case EXYNOS_REQUEST_RESULT::CALLBACK_BUFFER_ONLY:
         capture_result = result->getCaptureResult();
-        m_callbackOpsCaptureResult(capture_result, result->getType());
+        m_coalesceCaptureResult(request, capture_result);
         break;
     case EXYNOS_REQUEST_RESULT::CALLBACK_PARTIAL_3AA:
     case EXYNOS_REQUEST_RESULT::CALLBACK_PARTIAL_SHUTTER:
@@ -2217,7 +2133,8 @@ status_t ExynosCameraRequestManager::m_sendCallbackResult(ResultRequest result)
         if (request->getSkipMetaResult() == true) {
             CLOGV("[R%d] skip CALLBACK_ALL_RESULT.", result->getRequestKey());
         } else {
-            m_callbackOpsCaptureResult(capture_result, result->getType());
+            /* the staged result owns the metadata from here */
+            m_coalesceCaptureResult(request, capture_result);
         }
 
         if (capture_result->result != NULL) {
@@ -2226,6 +2143,9 @@ status_t ExynosCameraRequestManager::m_sendCallbackResult(ResultRequest result)
         }
         break;
     case EXYNOS_REQUEST_RESULT::CALLBACK_NOTIFY_ERROR:
+        /* keep the order between the staged results and the error */
+        m_sendCoalescedResults(-1, true);
+
         notify_msg = result->getNotifyMsg();
         m_callbackOpsNotify(notify_msg);
         break;
@@ -2319,8 +2239,6 @@ status_t ExynosCameraRequestManager::m_callbackOpsNotify(camera3_notify_msg_t *m
 status_t ExynosCameraRequestManager::m_increasePipelineDepth(RequestInfoMap *map, Mutex *lock)
 {
     status_t ret = NO_ERROR;
-    RequestInfoMapIterator requestIter;
-    ExynosCameraRequestSP_sprt_t request = NULL;
 
     lock->lock();
     if (map->size() < 1) {
@@ -2329,13 +2247,9 @@ status_t ExynosCameraRequestManager::m_increasePipelineDepth(RequestInfoMap *map
         goto func_exit;
     }
 
-    requestIter = map->begin();
-    while (requestIter != map->end()) {
-        request = requestIter->second;
-
+    map->forEach([](uint32_t, ExynosCameraRequestSP_sprt_t &request) {
         request->increasePipelineDepth();
-        requestIter++;
-    }
+    });
 
 func_exit:
     lock->unlock();
@@ -2406,6 +2320,13 @@ void ExynosCameraRequestManager::dump(void)
     CLOGD("AllRequestCount(%d), ServiceRequestCount(%d), RunningRequestCount(%d)",
             getAllRequestCount(), getServiceRequestCount(), getRunningRequestCount());
 
+    m_printTranslationStat();
+
+    m_coalescedResultsLock.lock();
+    CLOGD("ResultCoalescing savedCallbacks(%u/sec, total %ju) pendingFrames(%zu)",
+            m_coalesceSavedPerSec, m_coalesceSavedCount, m_coalescedResults.size());
+    m_coalescedResultsLock.unlock();
+
     CLOGD("----- Last Result Key -----");
     for (int i = 0; i < EXYNOS_REQUEST_RESULT::CALLBACK_MAX; i++)
         CLOGI("Type[%d] = Last Key(%d)", i, m_lastResultKey[i]);
@@ -2446,7 +2367,10 @@ bool ExynosCameraRequestManager::m_resultCallbackThreadFunc(void)
     status_t ret = NO_ERROR;
 
     ret = m_resultCallback();
-    if (ret != NO_ERROR) {
+    if (ret == TIMED_OUT) {
+        /* nothing was due in this wait, e.g. an empty coalescing window */
+        CLOGV("ResultCallback timeout");
+    } else if (ret != NO_ERROR) {
         CLOGE("ResultCallback fail, ret(%d)", ret);
         /* TODO: doing exception handling */
     } else {
@@ -2464,9 +2388,15 @@ status_t ExynosCameraRequestManager::m_resultCallback(void)
     ExynosCameraRequestSP_sprt_t curRequest = NULL;
     ResultRequest result = NULL;
 
+    /* wake up at the end of the coalescing window */
+    m_resultCallbackQ.setWaitTime(m_getCoalesceWaitTime());
+
     ret = m_resultCallbackQ.waitAndPopProcessQ(&result);
     if (ret == TIMED_OUT) {
         CLOGV("resultCallbackQ wait timeout");
+        if (m_sendCoalescedResults(-1, false) > 0)
+            return NO_ERROR;
+
         return ret;
     } else if (ret != NO_ERROR) {
         CLOGE("resultCallbackQ wait and pop fail, ret(%d)", ret);
@@ -2514,6 +2444,12 @@ status_t ExynosCameraRequestManager::m_resultCallback(void)
         break;
     }
 
+    /* every result of this request is staged, do not wait for the window */
+    if (curRequest->isComplete() == true && curRequest->isAllBufferCallbackDone() == true)
+        m_sendCoalescedResults(curRequest->getKey(), false);
+    else
+        m_sendCoalescedResults(-1, false);
+
     CLOGV("-OUT-");
 
     return ret;
@@ -2736,6 +2672,10 @@ bool ExynosCameraRequestManager::m_bufferOnlyCallback(ExynosCameraRequestSP_sprt
     privStreamInfo = static_cast<ExynosCameraStream*>(resultStream->priv);
     privStreamInfo->getID(&resultStreamId);
 
+    /* a previous frame still holds a buffer of this stream, send it before the stream is updated */
+    if (m_isCoalescedStream(resultStream, curRequest->getKey()) == true)
+        m_sendCoalescedResults((int64_t)curRequest->getKey() - 1, false);
+
 #ifdef SAMSUNG_TN_FEATURE
     streamBuffer->stream->stream_timestamp = 0;
     streamBuffer->stream->minFps = 0;
@@ -2839,6 +2779,175 @@ bool ExynosCameraRequestManager::m_notifyErrorCallback(ExynosCameraRequestSP_spr
     return ret;
 }
 
+status_t ExynosCameraRequestManager::m_coalesceCaptureResult(ExynosCameraRequestSP_sprt_t request,
+                                                             camera3_capture_result_t *result)
+{
+    Mutex::Autolock l(m_coalescedResultsLock);
+    CoalescedResultMapIterator iter;
+    CoalescedResult *staged = NULL;
+
+    if (result == NULL) {
+        CLOGE("result is NULL");
+        return BAD_VALUE;
+    }
+
+    iter = m_coalescedResults.find(result->frame_number);
+    if (iter == m_coalescedResults.end()) {
+        CoalescedResult newResult;
+
+        newResult.request = request;
+        newResult.frameNumber = result->frame_number;
+        newResult.deadline = systemTime(SYSTEM_TIME_MONOTONIC) + RESULT_COALESCE_WINDOW_NS;
+        newResult.inputBuffer = NULL;
+        newResult.result = NULL;
+        newResult.partialResult = 0;
+        newResult.numOfResults = 0;
+
+        iter = m_coalescedResults.insert(pair<uint32_t, CoalescedResult>(result->frame_number, newResult)).first;
+    }
+
+    staged = &(iter->second);
+
+    for (uint32_t i = 0; i < result->num_output_buffers; i++)
+        staged->outputBuffers.push_back(result->output_buffers[i]);
+
+    if (staged->inputBuffer == NULL)
+        staged->inputBuffer = result->input_buffer;
+
+    if (result->result != NULL) {
+        if (staged->result != NULL) {
+            CLOGW("[R%d]Metadata is already staged. partial(%d -> %d)",
+                    result->frame_number, staged->partialResult, result->partial_result);
+            free((camera_metadata_t *)(staged->result));
+        }
+
+        staged->result = result->result;
+        staged->partialResult = result->partial_result;
+        result->result = NULL;
+    }
+
+    staged->numOfResults++;
+
+    return NO_ERROR;
+}
+
+/*
+ * Send the staged results in frame number order.
+ * Every frame up to frameNumber is sent, as well as every frame before an
+ * expired one. force sends all of them, e.g. before an error notify.
+ */
+int ExynosCameraRequestManager::m_sendCoalescedResults(int64_t frameNumber, bool force)
+{
+    list<CoalescedResult> sendList;
+    list<CoalescedResult>::iterator sendIter;
+    CoalescedResultMapIterator iter;
+    camera3_capture_result_t captureResult;
+    nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+    int64_t limit = frameNumber;
+    uint64_t savedCount = 0;
+    int numOfResults = 0;
+
+    m_coalescedResultsLock.lock();
+    for (iter = m_coalescedResults.begin(); iter != m_coalescedResults.end(); iter++) {
+        if (force == true || iter->second.deadline <= now) {
+            if ((int64_t)iter->first > limit)
+                limit = iter->first;
+        }
+    }
+
+    while (m_coalescedResults.empty() == false
+           && (int64_t)m_coalescedResults.begin()->first <= limit) {
+        sendList.push_back(m_coalescedResults.begin()->second);
+        m_coalescedResults.erase(m_coalescedResults.begin());
+    }
+    m_coalescedResultsLock.unlock();
+
+    for (sendIter = sendList.begin(); sendIter != sendList.end(); sendIter++) {
+        memset(&captureResult, 0x00, sizeof(captureResult));
+        captureResult.frame_number = sendIter->frameNumber;
+        captureResult.result = sendIter->result;
+        captureResult.num_output_buffers = sendIter->outputBuffers.size();
+        captureResult.output_buffers = (sendIter->outputBuffers.empty() == true) ? NULL : &(sendIter->outputBuffers[0]);
+        captureResult.input_buffer = sendIter->inputBuffer;
+        captureResult.partial_result = (sendIter->result != NULL) ? sendIter->partialResult : 0;
+
+        m_callbackOpsCaptureResult(&captureResult,
+                                   (sendIter->result != NULL) ? EXYNOS_REQUEST_RESULT::CALLBACK_ALL_RESULT
+                                                              : EXYNOS_REQUEST_RESULT::CALLBACK_BUFFER_ONLY);
+
+        if (sendIter->result != NULL)
+            free((camera_metadata_t *)(sendIter->result));
+
+        numOfResults += sendIter->numOfResults;
+        savedCount += sendIter->numOfResults - 1;
+    }
+
+    m_coalescedResultsLock.lock();
+    m_coalesceSavedCount += savedCount;
+    m_coalesceSavedWindowCount += savedCount;
+    if (now - m_coalesceWindowStart >= 1000000000LL) {
+        m_coalesceSavedPerSec = (uint32_t)(m_coalesceSavedWindowCount * 1000000000LL / (now - m_coalesceWindowStart));
+        m_coalesceSavedWindowCount = 0;
+        m_coalesceWindowStart = now;
+    }
+    m_coalescedResultsLock.unlock();
+
+    return numOfResults;
+}
+
+bool ExynosCameraRequestManager::m_isCoalescedStream(camera3_stream_t *stream, uint32_t frameNumber)
+{
+    Mutex::Autolock l(m_coalescedResultsLock);
+    CoalescedResultMapIterator iter;
+
+    for (iter = m_coalescedResults.begin(); iter != m_coalescedResults.end(); iter++) {
+        if (iter->first >= frameNumber)
+            break;
+
+        for (size_t i = 0; i < iter->second.outputBuffers.size(); i++) {
+            if (iter->second.outputBuffers[i].stream == stream)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+uint64_t ExynosCameraRequestManager::m_getCoalesceWaitTime(void)
+{
+    Mutex::Autolock l(m_coalescedResultsLock);
+    CoalescedResultMapIterator iter;
+    nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+    nsecs_t deadline = 0;
+
+    if (m_coalescedResults.empty() == true)
+        return WAIT_TIME;
+
+    deadline = m_coalescedResults.begin()->second.deadline;
+    for (iter = m_coalescedResults.begin(); iter != m_coalescedResults.end(); iter++) {
+        if (iter->second.deadline < deadline)
+            deadline = iter->second.deadline;
+    }
+
+    return (deadline > now) ? (uint64_t)(deadline - now) : 0;
+}
+
+void ExynosCameraRequestManager::m_releaseCoalescedResults(void)
+{
+    Mutex::Autolock l(m_coalescedResultsLock);
+    CoalescedResultMapIterator iter;
+
+    for (iter = m_coalescedResults.begin(); iter != m_coalescedResults.end(); iter++) {
+        CLOGW("[R%d]Staged result is dropped. buffers(%zu)",
+                iter->first, iter->second.outputBuffers.size());
+
+        if (iter->second.result != NULL)
+            free((camera_metadata_t *)(iter->second.result));
+    }
+
+    m_coalescedResults.clear();
+}
+
 status_t ExynosCameraRequestManager::waitforRequestflush()
 {
     int count = 0;
@@ -24,6 +24,7 @@
 #include <CameraMetadata.h>
 #include <map>
 #include <list>
+#include <vector>
 #include <android/sync.h>
 
 #include "ExynosCameraDefine.h"
@@ -34,11 +35,15 @@
 #include "ExynosCameraSensorInfo.h"
 #include "ExynosCameraMetadataConverter.h"
 #include "ExynosCameraTimeLogger.h"
+#include "ExynosCameraRequestRing.h"
 
 namespace android {
 
 using namespace std;
 
+/* buffers and final meta of the same frame ready within this window go in one callback */
+#define RESULT_COALESCE_WINDOW_NS   (1000000) /* 1ms */
+
 namespace EXYNOS_REQUEST_RESULT {
     enum TYPE {
         CALLBACK_INVALID         = -1,
@@ -394,18 +399,12 @@ public:
     void                           dump(void);
 
 private:
-    typedef map<uint32_t, ExynosCameraRequestSP_sprt_t>           RequestInfoMap;
-    typedef map<uint32_t, ExynosCameraRequestSP_sprt_t>::iterator RequestInfoMapIterator;
-    typedef list<ExynosCameraRequestSP_sprt_t>                    RequestInfoList;
-    typedef list<ExynosCameraRequestSP_sprt_t>::iterator          RequestInfoListIterator;
-    typedef map<uint32_t, uint32_t>                       RequestFrameCountMap;
-    typedef map<uint32_t, uint32_t>::iterator             RequestFrameCountMapIterator;
+    typedef ExynosCameraRequestRing<ExynosCameraRequestSP_sprt_t> RequestInfoMap;
+    typedef ExynosCameraRequestFifo<ExynosCameraRequestSP_sprt_t> RequestInfoList;
+    typedef ExynosCameraKeyRing                                   RequestFrameCountMap;
 
     status_t                       m_pushBack(ExynosCameraRequestSP_sprt_t item, RequestInfoList *list, Mutex *lock);
-    status_t                       m_popBack(ExynosCameraRequestSP_dptr_t item, RequestInfoList *list, Mutex *lock);
-    status_t                       m_pushFront(ExynosCameraRequestSP_sprt_t item, RequestInfoList *list, Mutex *lock);
     status_t                       m_popFront(ExynosCameraRequestSP_dptr_t item, RequestInfoList *list, Mutex *lock);
-    status_t                       m_get(uint32_t frameCount, ExynosCameraRequestSP_dptr_t item, RequestInfoList *list, Mutex *lock);
 
     status_t                       m_push(ExynosCameraRequestSP_sprt_t item, RequestInfoMap *list, Mutex *lock);
     status_t                       m_pop(uint32_t frameCount, ExynosCameraRequestSP_dptr_t item, RequestInfoMap *list, Mutex *lock);
@@ -413,6 +412,7 @@ private:
 
     void                           m_printAllServiceRequestInfo(void);
     void                           m_printAllRequestInfo(RequestInfoMap *map, Mutex *lock);
+    void                           m_printTranslationStat(void);
 
     status_t                       m_removeFromRunningList(uint32_t requestKey);
 
@@ -451,6 +451,13 @@ private:
 
     void                           m_adjustFaceDetectMetadata(ExynosCameraRequestSP_sprt_t request);
 
+    /* result coalescing */
+    status_t                       m_coalesceCaptureResult(ExynosCameraRequestSP_sprt_t request, camera3_capture_result_t *result);
+    int                            m_sendCoalescedResults(int64_t frameNumber, bool force);
+    bool                           m_isCoalescedStream(camera3_stream_t *stream, uint32_t frameNumber);
+    uint64_t                       m_getCoalesceWaitTime(void);
+    void                           m_releaseCoalescedResults(void);
+
 #if 0
     /* Other helper functions */
     status_t        initShotData(void);
@@ -458,6 +465,19 @@ private:
     uint32_t        getFrameNumber(void);
 #endif
 private:
+    struct CoalescedResult {
+        ExynosCameraRequestSP_sprt_t    request;
+        uint32_t                        frameNumber;
+        nsecs_t                         deadline;
+        vector<camera3_stream_buffer_t> outputBuffers;
+        const camera3_stream_buffer_t   *inputBuffer;
+        const camera_metadata_t         *result;
+        uint32_t                        partialResult;
+        uint32_t                        numOfResults;
+    };
+    typedef map<uint32_t, CoalescedResult>           CoalescedResultMap;
+    typedef map<uint32_t, CoalescedResult>::iterator CoalescedResultMapIterator;
+
     bool                          m_flushFlag;
     mutable Mutex                 m_flushLock;
 
@@ -479,8 +499,8 @@ private:
     FrameFactoryMap               m_factoryMap;
     mutable Mutex                 m_factoryMapLock;
 
+    /* lookups take no lock, inserts and erases lock inside */
     RequestFrameCountMap          m_requestFrameCountMap;
-    mutable Mutex                 m_requestFrameCountMapLock;
 
     ExynosCameraDurationTimer     m_callbackFlushTimer;
 
@@ -492,6 +512,13 @@ private:
     result_queue_t                m_resultCallbackQ;
     sp<callbackThread>            m_resultCallbackThread;
 
+    CoalescedResultMap            m_coalescedResults;
+    mutable Mutex                 m_coalescedResultsLock;
+    uint64_t                      m_coalesceSavedCount;
+    uint64_t                      m_coalesceSavedWindowCount;
+    nsecs_t                       m_coalesceWindowStart;
+    uint32_t                      m_coalesceSavedPerSec;
+
     ExynosCameraCallbackSequencer *m_notifySequencer;
     ExynosCameraCallbackSequencer *m_allMetaSequencer;
 
@@ -0,0 +1,462 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed toggle an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file      ExynosCameraRequestRing.h
+ * \brief     header file for the frame-number-indexed request bookkeeping
+ *
+ */
+
+#ifndef EXYNOS_CAMERA_REQUEST_RING_H__
+#define EXYNOS_CAMERA_REQUEST_RING_H__
+
+#include <stdint.h>
+
+#include <atomic>
+#include <list>
+#include <map>
+
+#include <utils/Mutex.h>
+
+using namespace android;
+
+/* covers the camera3 in-flight requests with room to spare */
+#define REQUEST_RING_SIZE_DEFAULT   (64)
+
+static inline uint32_t requestRingRoundUp(uint32_t capacity)
+{
+    uint32_t size = 2;
+
+    while (size < capacity && size < (1U << 30))
+        size <<= 1;
+
+    return size;
+}
+
+/*
+ * Map of dense, increasing keys (frame numbers) to items.
+ * A key lives in slot (key & mask) and the slot keeps the key as its tag,
+ * so a lookup is one index and one compare. A key whose slot is still held
+ * by an older key goes to the overflow map, which stays empty as long as
+ * the pipeline is shallower than the ring.
+ * Not thread safe, the owner serializes the calls.
+ */
+template<typename T>
+class ExynosCameraRequestRing {
+public:
+    ExynosCameraRequestRing(uint32_t capacity = REQUEST_RING_SIZE_DEFAULT)
+    {
+        uint32_t size = requestRingRoundUp(capacity);
+
+        m_mask = size - 1;
+        m_slots = new Slot[size];
+        m_size = 0;
+        m_numOfOverflow = 0;
+    }
+
+    ~ExynosCameraRequestRing()
+    {
+        delete[] m_slots;
+    }
+
+    /* returns false when the key already exists */
+    bool insert(uint32_t key, const T &item)
+    {
+        Slot *slot = &m_slots[key & m_mask];
+
+        if (slot->used == true) {
+            if (slot->key == key)
+                return false;
+
+            if (m_overflow.insert(std::pair<uint32_t, T>(key, item)).second == false)
+                return false;
+
+            m_numOfOverflow++;
+        } else {
+            if (m_overflow.find(key) != m_overflow.end())
+                return false;
+
+            slot->key = key;
+            slot->data = item;
+            slot->used = true;
+        }
+
+        m_size++;
+
+        return true;
+    }
+
+    bool find(uint32_t key, T *item)
+    {
+        Slot *slot = &m_slots[key & m_mask];
+
+        if (slot->used == true && slot->key == key) {
+            *item = slot->data;
+            return true;
+        }
+
+        return m_findOverflow(key, item, false);
+    }
+
+    bool erase(uint32_t key, T *item)
+    {
+        Slot *slot = &m_slots[key & m_mask];
+
+        if (slot->used == true && slot->key == key) {
+            *item = slot->data;
+            /* drop the reference held by the slot */
+            slot->data = T();
+            slot->used = false;
+            m_size--;
+            return true;
+        }
+
+        if (m_findOverflow(key, item, true) == true) {
+            m_size--;
+            return true;
+        }
+
+        return false;
+    }
+
+    /* the lowest key, like begin() of a map */
+    bool first(uint32_t *key, T *item)
+    {
+        Slot *found = NULL;
+        typename std::map<uint32_t, T>::iterator iter;
+
+        for (uint32_t i = 0; i <= m_mask; i++) {
+            if (m_slots[i].used == true
+                && (found == NULL || m_slots[i].key < found->key))
+                found = &m_slots[i];
+        }
+
+        iter = m_overflow.begin();
+        if (iter != m_overflow.end()
+            && (found == NULL || iter->first < found->key)) {
+            *key = iter->first;
+            *item = iter->second;
+            return true;
+        }
+
+        if (found == NULL)
+            return false;
+
+        *key = found->key;
+        *item = found->data;
+
+        return true;
+    }
+
+    /* visits every item, not in key order */
+    template<typename F>
+    void forEach(F func)
+    {
+        for (uint32_t i = 0; i <= m_mask; i++) {
+            if (m_slots[i].used == true)
+                func(m_slots[i].key, m_slots[i].data);
+        }
+
+        for (auto &iter : m_overflow)
+            func(iter.first, iter.second);
+    }
+
+    void clear(void)
+    {
+        for (uint32_t i = 0; i <= m_mask; i++) {
+            m_slots[i].data = T();
+            m_slots[i].used = false;
+        }
+
+        m_overflow.clear();
+        m_size = 0;
+    }
+
+    size_t size(void) const
+    {
+        return m_size;
+    }
+
+    uint32_t capacity(void) const
+    {
+        return m_mask + 1;
+    }
+
+    /* keys that ever spilled, for dump */
+    uint32_t getNumOfOverflow(void) const
+    {
+        return m_numOfOverflow;
+    }
+
+private:
+    bool m_findOverflow(uint32_t key, T *item, bool erase)
+    {
+        typename std::map<uint32_t, T>::iterator iter;
+
+        if (m_overflow.empty() == true)
+            return false;
+
+        iter = m_overflow.find(key);
+        if (iter == m_overflow.end())
+            return false;
+
+        *item = iter->second;
+        if (erase == true)
+            m_overflow.erase(iter);
+
+        return true;
+    }
+
+private:
+    struct Slot {
+        Slot() : key(0), used(false) {}
+
+        uint32_t    key;
+        bool        used;
+        T           data;
+    };
+
+    Slot                    *m_slots;
+    uint32_t                m_mask;
+    size_t                  m_size;
+    uint32_t                m_numOfOverflow;
+    std::map<uint32_t, T>   m_overflow;
+};
+
+/*
+ * FIFO of the requests waiting for a frame.
+ * push and pop move two counters on a fixed array. A push that finds the
+ * array full spills into a list, and later pushes follow it there until
+ * the array drains, so the order is kept.
+ * Not thread safe, the owner serializes the calls.
+ */
+template<typename T>
+class ExynosCameraRequestFifo {
+public:
+    ExynosCameraRequestFifo(uint32_t capacity = REQUEST_RING_SIZE_DEFAULT)
+    {
+        uint32_t size = requestRingRoundUp(capacity);
+
+        m_mask = size - 1;
+        m_items = new T[size];
+        m_head = 0;
+        m_tail = 0;
+    }
+
+    ~ExynosCameraRequestFifo()
+    {
+        delete[] m_items;
+    }
+
+    void pushBack(const T &item)
+    {
+        if (m_overflow.empty() == false || m_tail - m_head > m_mask) {
+            m_overflow.push_back(item);
+            return;
+        }
+
+        m_items[m_tail & m_mask] = item;
+        m_tail++;
+    }
+
+    /* returns false when the fifo is empty */
+    bool popFront(T *item)
+    {
+        if (m_tail == m_head)
+            return false;
+
+        *item = m_items[m_head & m_mask];
+        m_items[m_head & m_mask] = T();
+        m_head++;
+
+        /* refill from the spill list to keep the order */
+        while (m_overflow.empty() == false && m_tail - m_head <= m_mask) {
+            m_items[m_tail & m_mask] = m_overflow.front();
+            m_overflow.pop_front();
+            m_tail++;
+        }
+
+        return true;
+    }
+
+    /* visits every item from the front */
+    template<typename F>
+    void forEach(F func)
+    {
+        for (uint32_t pos = m_head; pos != m_tail; pos++)
+            func(m_items[pos & m_mask]);
+
+        for (auto &item : m_overflow)
+            func(item);
+    }
+
+    void clear(void)
+    {
+        for (uint32_t i = 0; i <= m_mask; i++)
+            m_items[i] = T();
+
+        m_overflow.clear();
+        m_head = 0;
+        m_tail = 0;
+    }
+
+    size_t size(void) const
+    {
+        return (size_t)(m_tail - m_head) + m_overflow.size();
+    }
+
+private:
+    T               *m_items;
+    uint32_t        m_mask;
+    uint32_t        m_head;
+    uint32_t        m_tail;
+    std::list<T>    m_overflow;
+};
+
+/*
+ * frameCount to request key table.
+ * Each slot packs (frameCount << 32 | key) in one atomic word, so getKey()
+ * runs without a lock and sees either the whole entry or nothing.
+ * Insert and erase are serialized by an internal lock, which also guards
+ * the overflow map for frameCounts whose slot is still taken.
+ */
+class ExynosCameraKeyRing {
+public:
+    ExynosCameraKeyRing(uint32_t capacity = REQUEST_RING_SIZE_DEFAULT)
+    {
+        uint32_t size = requestRingRoundUp(capacity);
+
+        m_mask = size - 1;
+        m_slots = new std::atomic<uint64_t>[size];
+        for (uint32_t i = 0; i < size; i++)
+            m_slots[i].store(KEY_RING_EMPTY, std::memory_order_relaxed);
+
+        m_numOfOverflow.store(0, std::memory_order_relaxed);
+    }
+
+    ~ExynosCameraKeyRing()
+    {
+        delete[] m_slots;
+    }
+
+    /* returns false when the frameCount already exists */
+    bool insert(uint32_t frameCount, uint32_t key)
+    {
+        Mutex::Autolock lock(m_lock);
+        std::atomic<uint64_t> *slot = &m_slots[frameCount & m_mask];
+        uint64_t entry = m_pack(frameCount, key);
+        uint64_t old = slot->load(std::memory_order_relaxed);
+
+        if (old != KEY_RING_EMPTY && (uint32_t)(old >> 32) == frameCount)
+            return false;
+
+        if (old == KEY_RING_EMPTY && entry != KEY_RING_EMPTY) {
+            if (m_overflow.find(frameCount) != m_overflow.end())
+                return false;
+
+            slot->store(entry, std::memory_order_release);
+            return true;
+        }
+
+        if (m_overflow.insert(std::pair<uint32_t, uint32_t>(frameCount, key)).second == false)
+            return false;
+
+        m_numOfOverflow.fetch_add(1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool find(uint32_t frameCount, uint32_t *key)
+    {
+        uint64_t entry = m_slots[frameCount & m_mask].load(std::memory_order_acquire);
+
+        if (entry != KEY_RING_EMPTY && (uint32_t)(entry >> 32) == frameCount) {
+            *key = (uint32_t)entry;
+            return true;
+        }
+
+        if (m_numOfOverflow.load(std::memory_order_acquire) == 0)
+            return false;
+
+        return m_findOverflow(frameCount, key, false);
+    }
+
+    bool erase(uint32_t frameCount, uint32_t *key)
+    {
+        Mutex::Autolock lock(m_lock);
+        std::atomic<uint64_t> *slot = &m_slots[frameCount & m_mask];
+        uint64_t entry = slot->load(std::memory_order_relaxed);
+
+        if (entry != KEY_RING_EMPTY && (uint32_t)(entry >> 32) == frameCount) {
+            *key = (uint32_t)entry;
+            slot->store(KEY_RING_EMPTY, std::memory_order_release);
+            return true;
+        }
+
+        return m_findOverflowLocked(frameCount, key, true);
+    }
+
+    void clear(void)
+    {
+        Mutex::Autolock lock(m_lock);
+
+        for (uint32_t i = 0; i <= m_mask; i++)
+            m_slots[i].store(KEY_RING_EMPTY, std::memory_order_relaxed);
+
+        m_overflow.clear();
+        m_numOfOverflow.store(0, std::memory_order_release);
+    }
+
+private:
+    static const uint64_t KEY_RING_EMPTY = ~0ULL;
+
+    static uint64_t m_pack(uint32_t frameCount, uint32_t key)
+    {
+        return ((uint64_t)frameCount << 32) | key;
+    }
+
+    bool m_findOverflow(uint32_t frameCount, uint32_t *key, bool erase)
+    {
+        Mutex::Autolock lock(m_lock);
+
+        return m_findOverflowLocked(frameCount, key, erase);
+    }
+
+    bool m_findOverflowLocked(uint32_t frameCount, uint32_t *key, bool erase)
+    {
+        std::map<uint32_t, uint32_t>::iterator iter;
+
+        iter = m_overflow.find(frameCount);
+        if (iter == m_overflow.end())
+            return false;
+
+        *key = iter->second;
+        if (erase == true) {
+            m_overflow.erase(iter);
+            m_numOfOverflow.fetch_sub(1, std::memory_order_release);
+        }
+
+        return true;
+    }
+
+private:
+    std::atomic<uint64_t>           *m_slots;
+    uint32_t                        m_mask;
+    std::atomic<uint32_t>           m_numOfOverflow;
+    std::map<uint32_t, uint32_t>    m_overflow;
+    Mutex                           m_lock;
+};
+#endif
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed toggle an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file      ExynosCameraRingQueue.h
+ * \brief     header file for the lock-free ring backend of ExynosCameraList
+ *
+ */
+
+#ifndef EXYNOS_CAMERA_RING_QUEUE_H__
+#define EXYNOS_CAMERA_RING_QUEUE_H__
+
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include <atomic>
+
+#define RING_QUEUE_CACHE_LINE (64)
+
+/*
+ * Bounded multi-producer/multi-consumer ring.
+ * Every cell carries a sequence number, so push and pop only race on
+ * one compare-and-swap of the head or the tail. Consumers that find
+ * the ring empty sleep on a futex word which producers only touch when
+ * somebody is sleeping.
+ */
+template<typename T>
+class ExynosCameraRingQueue {
+public:
+    ExynosCameraRingQueue(uint32_t capacity)
+    {
+        uint32_t size = 2;
+
+        while (size < capacity && size < (1U << 30))
+            size <<= 1;
+
+        m_mask = size - 1;
+        m_cells = new Cell[size];
+        for (uint32_t i = 0; i < size; i++)
+            m_cells[i].seq.store(i, std::memory_order_relaxed);
+
+        m_enqueuePos.store(0, std::memory_order_relaxed);
+        m_dequeuePos.store(0, std::memory_order_relaxed);
+        m_event.store(0, std::memory_order_relaxed);
+        m_sleepers.store(0, std::memory_order_relaxed);
+    }
+
+    ~ExynosCameraRingQueue()
+    {
+        delete[] m_cells;
+    }
+
+    /* returns false when the ring is full */
+    bool push(const T &item)
+    {
+        Cell *cell;
+        uint32_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            uint32_t seq = cell->seq.load(std::memory_order_acquire);
+            int32_t diff = (int32_t)(seq - pos);
+
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = item;
+        cell->seq.store(pos + 1, std::memory_order_release);
+
+        /* pairs with the fence in wait() */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleepers.load(std::memory_order_relaxed) > 0)
+            wake(false);
+
+        return true;
+    }
+
+    /* returns false when the ring is empty */
+    bool pop(T *item)
+    {
+        Cell *cell;
+        uint32_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            uint32_t seq = cell->seq.load(std::memory_order_acquire);
+            int32_t diff = (int32_t)(seq - (pos + 1));
+
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        *item = cell->data;
+        /* drop the reference held by the cell, e.g. sp<> of a frame */
+        cell->data = T();
+        cell->seq.store(pos + m_mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    uint32_t size(void)
+    {
+        uint32_t dequeuePos = m_dequeuePos.load(std::memory_order_acquire);
+        uint32_t enqueuePos = m_enqueuePos.load(std::memory_order_acquire);
+        int32_t diff = (int32_t)(enqueuePos - dequeuePos);
+
+        if (diff < 0)
+            return 0;
+        if ((uint32_t)diff > m_mask + 1)
+            return m_mask + 1;
+
+        return (uint32_t)diff;
+    }
+
+    uint32_t capacity(void)
+    {
+        return m_mask + 1;
+    }
+
+    int32_t getSleepers(void)
+    {
+        return m_sleepers.load(std::memory_order_relaxed);
+    }
+
+    /*
+     * Sleep until at least minSize items are queued, wake() is called
+     * or timeoutNs passes. It may return early, callers re-check.
+     */
+    void wait(uint32_t minSize, int64_t timeoutNs)
+    {
+        struct timespec ts;
+        int32_t event = m_event.load(std::memory_order_acquire);
+
+        m_sleepers.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (size() < minSize) {
+            ts.tv_sec = timeoutNs / 1000000000LL;
+            ts.tv_nsec = timeoutNs % 1000000000LL;
+            syscall(SYS_futex, reinterpret_cast<int32_t *>(&m_event),
+                    FUTEX_WAIT_PRIVATE, event, &ts, NULL, 0);
+        }
+
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void wake(bool all)
+    {
+        m_event.fetch_add(1, std::memory_order_release);
+        syscall(SYS_futex, reinterpret_cast<int32_t *>(&m_event),
+                FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, NULL, NULL, 0);
+    }
+
+private:
+    struct Cell {
+        std::atomic<uint32_t> seq;
+        T data;
+    };
+
+    Cell                                                *m_cells;
+    uint32_t                                            m_mask;
+
+    alignas(RING_QUEUE_CACHE_LINE) std::atomic<uint32_t> m_enqueuePos;
+    alignas(RING_QUEUE_CACHE_LINE) std::atomic<uint32_t> m_dequeuePos;
+    alignas(RING_QUEUE_CACHE_LINE) std::atomic<int32_t>  m_event;
+    std::atomic<int32_t>                                m_sleepers;
+};
+#endif
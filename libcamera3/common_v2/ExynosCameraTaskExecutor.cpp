@@ -0,0 +1,391 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/* #define LOG_NDEBUG 0 */
+#define LOG_TAG "ExynosCameraTaskExecutor"
+
+#include <stdio.h>
+#include <unistd.h>
+#include <log/log.h>
+
+#include "ExynosCameraTaskExecutor.h"
+
+/*
+ * Class ExynosCameraTaskWorker
+ */
+ExynosCameraTaskWorker::ExynosCameraTaskWorker()
+{
+    running = NULL;
+    tid = 0;
+    numOfRun = 0;
+    numOfSteal = 0;
+
+    m_executor = NULL;
+    m_index = 0;
+    m_name[0] = '\0';
+}
+
+void ExynosCameraTaskWorker::init(ExynosCameraTaskExecutor *executor, int index)
+{
+    m_executor = executor;
+    m_index = index;
+    snprintf(m_name, sizeof(m_name), "CameraTaskWorker%d", index);
+}
+
+status_t ExynosCameraTaskWorker::start(void)
+{
+    status_t ret;
+
+    tid = 0;
+    m_thread = new ExynosCameraThread<ExynosCameraTaskWorker>(this, &ExynosCameraTaskWorker::m_threadFunc, m_name);
+
+    ret = m_thread->run();
+    if (ret != NO_ERROR) {
+        ALOGE("ERR(%s[%d]):Failed to run %s, ret(%d)", __FUNCTION__, __LINE__, m_name, ret);
+        m_thread.clear();
+    }
+
+    return ret;
+}
+
+void ExynosCameraTaskWorker::stop(void)
+{
+    if (m_thread == NULL)
+        return;
+
+    m_thread->requestExitAndWait();
+    m_thread.clear();
+    tid = 0;
+}
+
+void ExynosCameraTaskWorker::push(executor_task_t *task, int priority)
+{
+    Mutex::Autolock lock(m_queueLock);
+    List<executor_task_t>::iterator r;
+
+    for (r = m_queue[priority].begin(); r != m_queue[priority].end(); r++) {
+        if (r->timestamp > task->timestamp)
+            break;
+    }
+
+    m_queue[priority].insert(r, *task);
+}
+
+bool ExynosCameraTaskWorker::pop(executor_task_t *task, int priority, ExynosCameraTaskWorker *taker)
+{
+    Mutex::Autolock lock(m_queueLock);
+    List<executor_task_t>::iterator r;
+
+    if (m_queue[priority].empty())
+        return false;
+
+    r = m_queue[priority].begin();
+    *task = *r;
+    m_queue[priority].erase(r);
+
+    /* cancel() removes under this lock and then checks running, it never misses the task */
+    taker->running = task->runnable;
+
+    return true;
+}
+
+void ExynosCameraTaskWorker::remove(ExynosCameraTaskRunnable *runnable, int *removed)
+{
+    Mutex::Autolock lock(m_queueLock);
+    List<executor_task_t>::iterator r;
+
+    for (int i = 0; i < TASK_PRIORITY_MAX; i++) {
+        removed[i] = 0;
+
+        r = m_queue[i].begin();
+        while (r != m_queue[i].end()) {
+            if (r->runnable == runnable) {
+                r = m_queue[i].erase(r);
+                removed[i]++;
+            } else {
+                r++;
+            }
+        }
+    }
+}
+
+int ExynosCameraTaskWorker::getSize(void)
+{
+    Mutex::Autolock lock(m_queueLock);
+    int size = 0;
+
+    for (int i = 0; i < TASK_PRIORITY_MAX; i++)
+        size += m_queue[i].size();
+
+    return size;
+}
+
+bool ExynosCameraTaskWorker::m_threadFunc(void)
+{
+    if (tid == 0)
+        tid = gettid();
+
+    if (m_executor->m_runOne(m_index) == false)
+        m_executor->m_wait();
+
+    return (m_executor->m_flagExit == false);
+}
+
+/*
+ * Class ExynosCameraTaskExecutor
+ */
+ExynosCameraTaskExecutor::ExynosCameraTaskExecutor()
+{
+    for (int i = 0; i < TASK_EXECUTOR_NUM_OF_WORKER; i++)
+        m_worker[i].init(this, i);
+
+    for (int i = 0; i < TASK_PRIORITY_MAX; i++)
+        m_numOfQueued[i] = 0;
+
+    m_numOfUser = 0;
+    m_numOfCaptureRunning = 0;
+    m_nextWorker = 0;
+    m_flagExit = false;
+}
+
+ExynosCameraTaskExecutor::~ExynosCameraTaskExecutor()
+{
+    if (m_numOfUser > 0) {
+        ALOGW("WARN(%s[%d]):%d users are still attached", __FUNCTION__, __LINE__, m_numOfUser);
+        m_numOfUser = 1;
+        detach();
+    }
+}
+
+status_t ExynosCameraTaskExecutor::attach(void)
+{
+    Mutex::Autolock lock(m_userLock);
+    status_t ret = NO_ERROR;
+
+    if (m_numOfUser == 0) {
+        m_flagExit = false;
+
+        for (int i = 0; i < TASK_EXECUTOR_NUM_OF_WORKER; i++) {
+            ret = m_worker[i].start();
+            if (ret != NO_ERROR) {
+                m_flagExit = true;
+                {
+                    Mutex::Autolock lock(m_lock);
+                    m_workCondition.broadcast();
+                }
+                for (int j = 0; j < i; j++)
+                    m_worker[j].stop();
+
+                return ret;
+            }
+        }
+
+        ALOGD("DEBUG(%s[%d]):%d workers started", __FUNCTION__, __LINE__, TASK_EXECUTOR_NUM_OF_WORKER);
+    }
+
+    m_numOfUser++;
+
+    return NO_ERROR;
+}
+
+void ExynosCameraTaskExecutor::detach(void)
+{
+    Mutex::Autolock lock(m_userLock);
+
+    if (m_numOfUser <= 0) {
+        ALOGE("ERR(%s[%d]):Not attached", __FUNCTION__, __LINE__);
+        return;
+    }
+
+    m_numOfUser--;
+    if (m_numOfUser > 0)
+        return;
+
+    m_flagExit = true;
+    {
+        Mutex::Autolock lock(m_lock);
+        m_workCondition.broadcast();
+    }
+
+    for (int i = 0; i < TASK_EXECUTOR_NUM_OF_WORKER; i++)
+        m_worker[i].stop();
+
+    for (int i = 0; i < TASK_PRIORITY_MAX; i++) {
+        if (m_numOfQueued[i] != 0)
+            ALOGW("WARN(%s[%d]):%d tasks of priority(%d) are left",
+                    __FUNCTION__, __LINE__, m_numOfQueued[i].load(), i);
+    }
+
+    ALOGD("DEBUG(%s[%d]):workers stopped", __FUNCTION__, __LINE__);
+}
+
+status_t ExynosCameraTaskExecutor::submit(ExynosCameraTaskRunnable *runnable, int priority, int64_t timestamp)
+{
+    executor_task_t task;
+    int index;
+
+    if (runnable == NULL || priority < TASK_PRIORITY_PREVIEW || priority >= TASK_PRIORITY_MAX) {
+        ALOGE("ERR(%s[%d]):Invalid runnable(%p) or priority(%d)", __FUNCTION__, __LINE__, runnable, priority);
+        return BAD_VALUE;
+    }
+
+    task.runnable = runnable;
+    task.timestamp = timestamp;
+
+    /* a task from a worker stays on it, the others go round robin */
+    index = m_getWorkerIndex();
+    if (index < 0)
+        index = m_nextWorker++ % TASK_EXECUTOR_NUM_OF_WORKER;
+
+    /* counted first : a worker that sees the count retries until the push lands */
+    m_numOfQueued[priority]++;
+    m_worker[index].push(&task, priority);
+
+    Mutex::Autolock lock(m_lock);
+    m_workCondition.signal();
+
+    return NO_ERROR;
+}
+
+void ExynosCameraTaskExecutor::cancel(ExynosCameraTaskRunnable *runnable)
+{
+    int removed[TASK_PRIORITY_MAX];
+    int self = m_getWorkerIndex();
+    bool busy;
+
+    for (int i = 0; i < TASK_EXECUTOR_NUM_OF_WORKER; i++) {
+        m_worker[i].remove(runnable, removed);
+        for (int j = 0; j < TASK_PRIORITY_MAX; j++)
+            m_numOfQueued[j] -= removed[j];
+    }
+
+    Mutex::Autolock lock(m_lock);
+    do {
+        busy = false;
+        for (int i = 0; i < TASK_EXECUTOR_NUM_OF_WORKER; i++) {
+            /* a task may cancel itself */
+            if (i != self && m_worker[i].running == runnable)
+                busy = true;
+        }
+
+        if (busy == true)
+            m_doneCondition.waitRelative(m_lock, TASK_EXECUTOR_IDLE_WAIT_TIME);
+    } while (busy == true);
+}
+
+void ExynosCameraTaskExecutor::dump(void)
+{
+    ALOGI("INFO(%s[%d]):users(%d) queued(preview %d, capture %d) captureRunning(%d)",
+            __FUNCTION__, __LINE__, m_numOfUser,
+            m_numOfQueued[TASK_PRIORITY_PREVIEW].load(), m_numOfQueued[TASK_PRIORITY_CAPTURE].load(),
+            m_numOfCaptureRunning.load());
+
+    for (int i = 0; i < TASK_EXECUTOR_NUM_OF_WORKER; i++) {
+        ALOGI("INFO(%s[%d]):worker(%d) tid(%d) queued(%d) run(%u) steal(%u) running(%p)",
+                __FUNCTION__, __LINE__, i, m_worker[i].tid.load(), m_worker[i].getSize(),
+                m_worker[i].numOfRun.load(), m_worker[i].numOfSteal.load(),
+                m_worker[i].running.load());
+    }
+}
+
+bool ExynosCameraTaskExecutor::m_runOne(int index)
+{
+    executor_task_t task;
+    int priority;
+
+    if (m_take(index, &task, &priority) == false)
+        return false;
+
+    /* running was set by m_take() */
+    task.runnable->runTask();
+    m_worker[index].running = NULL;
+    m_worker[index].numOfRun++;
+
+    if (priority == TASK_PRIORITY_CAPTURE)
+        m_numOfCaptureRunning--;
+
+    Mutex::Autolock lock(m_lock);
+    m_doneCondition.broadcast();
+    /* a capture task may wait for this worker */
+    if (priority == TASK_PRIORITY_CAPTURE)
+        m_workCondition.broadcast();
+
+    return true;
+}
+
+/* own queue first, then steal from the others, preview before capture */
+bool ExynosCameraTaskExecutor::m_take(int index, executor_task_t *task, int *priority)
+{
+    int victim;
+
+    for (int p = TASK_PRIORITY_PREVIEW; p < TASK_PRIORITY_MAX; p++) {
+        if (m_numOfQueued[p] <= 0)
+            continue;
+
+        if (p == TASK_PRIORITY_CAPTURE
+            && m_numOfCaptureRunning.fetch_add(1) >= TASK_EXECUTOR_MAX_CAPTURE_WORKER) {
+            m_numOfCaptureRunning--;
+            continue;
+        }
+
+        for (int i = 0; i < TASK_EXECUTOR_NUM_OF_WORKER; i++) {
+            victim = (index + i) % TASK_EXECUTOR_NUM_OF_WORKER;
+
+            if (m_worker[victim].pop(task, p, &m_worker[index]) == true) {
+                m_numOfQueued[p]--;
+                if (victim != index)
+                    m_worker[index].numOfSteal++;
+
+                *priority = p;
+                return true;
+            }
+        }
+
+        if (p == TASK_PRIORITY_CAPTURE)
+            m_numOfCaptureRunning--;
+    }
+
+    return false;
+}
+
+void ExynosCameraTaskExecutor::m_wait(void)
+{
+    Mutex::Autolock lock(m_lock);
+
+    if (m_flagExit == true)
+        return;
+
+    /* work left that this worker may take : retry */
+    if (m_numOfQueued[TASK_PRIORITY_PREVIEW] > 0)
+        return;
+    if (m_numOfQueued[TASK_PRIORITY_CAPTURE] > 0
+        && m_numOfCaptureRunning < TASK_EXECUTOR_MAX_CAPTURE_WORKER)
+        return;
+
+    m_workCondition.waitRelative(m_lock, TASK_EXECUTOR_IDLE_WAIT_TIME);
+}
+
+int ExynosCameraTaskExecutor::m_getWorkerIndex(void)
+{
+    pid_t self = gettid();
+
+    for (int i = 0; i < TASK_EXECUTOR_NUM_OF_WORKER; i++) {
+        if (m_worker[i].tid == self)
+            return i;
+    }
+
+    return -1;
+}
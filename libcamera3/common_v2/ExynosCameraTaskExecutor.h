@@ -0,0 +1,150 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*!
+ * \file      ExynosCameraTaskExecutor.h
+ * \brief     header file for the shared task executor of the SW pipes
+ *
+ */
+
+#ifndef EXYNOS_CAMERA_TASK_EXECUTOR_H
+#define EXYNOS_CAMERA_TASK_EXECUTOR_H
+
+#include <atomic>
+
+#include <utils/threads.h>
+#include <utils/List.h>
+#include <utils/Timers.h>
+
+#include "ExynosCameraSingleton.h"
+#include "ExynosCameraThread.h"
+
+using namespace android;
+
+#define TASK_EXECUTOR_NUM_OF_WORKER     (4)
+/* capture tasks run on this many workers at most */
+#define TASK_EXECUTOR_MAX_CAPTURE_WORKER    (TASK_EXECUTOR_NUM_OF_WORKER - 1)
+/* an idle worker looks for work to steal at least this often */
+#define TASK_EXECUTOR_IDLE_WAIT_TIME    (100000000LL) /* 100ms */
+
+/* lower runs first */
+enum TASK_PRIORITY {
+    TASK_PRIORITY_PREVIEW = 0,
+    TASK_PRIORITY_CAPTURE,
+    TASK_PRIORITY_MAX,
+};
+
+class ExynosCameraTaskRunnable {
+public:
+    virtual ~ExynosCameraTaskRunnable() {}
+
+    virtual void runTask(void) = 0;
+};
+
+typedef struct executor_task {
+    ExynosCameraTaskRunnable *runnable;
+    int64_t timestamp;  /* the older frame runs first in a priority */
+} executor_task_t;
+
+class ExynosCameraTaskExecutor;
+
+class ExynosCameraTaskWorker {
+public:
+    ExynosCameraTaskWorker();
+    virtual ~ExynosCameraTaskWorker() {}
+
+    void        init(ExynosCameraTaskExecutor *executor, int index);
+    status_t    start(void);
+    void        stop(void);
+
+    void        push(executor_task_t *task, int priority);
+    /* taker : the worker that runs the task, marked running under the queue lock */
+    bool        pop(executor_task_t *task, int priority, ExynosCameraTaskWorker *taker);
+    /* removed : the number of removed tasks per priority */
+    void        remove(ExynosCameraTaskRunnable *runnable, int *removed);
+    int         getSize(void);
+
+private:
+    bool        m_threadFunc(void);
+
+public:
+    std::atomic<ExynosCameraTaskRunnable *> running;
+    std::atomic<pid_t>      tid;
+    std::atomic<uint32_t>   numOfRun;
+    std::atomic<uint32_t>   numOfSteal;
+
+private:
+    ExynosCameraTaskExecutor    *m_executor;
+    int                         m_index;
+    char                        m_name[32];
+    sp<ExynosCameraThread<ExynosCameraTaskWorker> > m_thread;
+
+    /* sorted by timestamp, per priority */
+    List<executor_task_t>   m_queue[TASK_PRIORITY_MAX];
+    Mutex                   m_queueLock;
+};
+
+/*
+ * A fixed pool of workers shared by every SW pipe that opts in, instead of
+ * a thread per pipe. Each worker has its own queues; a task submitted from
+ * a worker stays on it (the next pipe of a frame runs on a warm cache), and
+ * an idle worker steals from the others. Preview tasks are taken before
+ * capture tasks, and capture tasks never take the last worker, so preview
+ * is never stuck behind a long capture post-processing.
+ * The executor does not serialize the tasks of a runnable: the owner keeps
+ * at most one task of it queued.
+ */
+class ExynosCameraTaskExecutor : public ExynosCameraSingleton<ExynosCameraTaskExecutor> {
+protected:
+    friend class ExynosCameraSingleton<ExynosCameraTaskExecutor>;
+    friend class ExynosCameraTaskWorker;
+
+    ExynosCameraTaskExecutor();
+    virtual ~ExynosCameraTaskExecutor();
+
+public:
+    /* the workers run from the first attach() to the last detach() */
+    status_t    attach(void);
+    void        detach(void);
+
+    status_t    submit(ExynosCameraTaskRunnable *runnable, int priority, int64_t timestamp);
+    /* drops the queued tasks of runnable and waits for its running one */
+    void        cancel(ExynosCameraTaskRunnable *runnable);
+
+    void        dump(void);
+
+private:
+    bool        m_runOne(int index);
+    bool        m_take(int index, executor_task_t *task, int *priority);
+    void        m_wait(void);
+    int         m_getWorkerIndex(void);
+
+private:
+    ExynosCameraTaskWorker  m_worker[TASK_EXECUTOR_NUM_OF_WORKER];
+    int                     m_numOfUser;
+    Mutex                   m_userLock;
+
+    std::atomic<int>        m_numOfQueued[TASK_PRIORITY_MAX];
+    std::atomic<int>        m_numOfCaptureRunning;
+    std::atomic<uint32_t>   m_nextWorker;
+    std::atomic<bool>       m_flagExit;
+
+    Mutex                   m_lock;
+    Condition               m_workCondition;
+    Condition               m_doneCondition;
+};
+
+#endif
@@ -17,6 +17,13 @@
 #define LOG_TAG "ExynosCameraTimeLogger"
 
 
+#include <inttypes.h>
+#include <sys/prctl.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+
 #include "ExynosCameraTimeLogger.h"
 
 /*
@@ -122,15 +129,31 @@ ExynosCameraTimeLogger::ExynosCameraTimeLogger()
     m_categoryStr[LOGGER_CATEGORY_POST_DESTRUCTOR_END]                  = MAKE_STRING(POST_DESTRUCTOR_END);
 
     for (int i = 0; i < CAMERA_ID_MAX; i++) {
-        m_buffer[i] = NULL;
-        m_bufferIndex[i] = 0;
         m_stopFlag[i] = true;
-        m_firstCheckFlag[i] = true;
+        m_count[i] = 0;
+        m_numOfDropped[i] = 0;
+        m_startTime[i] = 0;
     }
+
+    for (int i = 0; i < TIME_LOGGER_MAX_THREADS; i++)
+        m_ring[i] = NULL;
+
+    m_numOfRing = 0;
+
+    /* the destructor hands the ring back when its thread exits */
+    if (pthread_key_create(&m_ringKey, m_releaseRing) != 0)
+        CLOGE("can't create the ring key");
 }
 
 ExynosCameraTimeLogger::~ExynosCameraTimeLogger()
-{}
+{
+    pthread_key_delete(m_ringKey);
+
+    for (int i = 0; i < m_numOfRing; i++) {
+        delete m_ring[i];
+        m_ring[i] = NULL;
+    }
+}
 
 status_t ExynosCameraTimeLogger::init(int cameraId)
 {
@@ -138,20 +161,16 @@ status_t ExynosCameraTimeLogger::init(int cameraId)
 
     CLOGD3(cameraId, "");
 
-    /* alloc buffer for dump */
-    m_buffer[cameraId] = (timeLogger_t *)malloc(sizeof(timeLogger_t) * TIME_LOGGER_SIZE);
-    if (m_buffer[cameraId] == NULL) {
-        CLOGE3(cameraId, "can't alloc buffer");
-        return INVALID_OPERATION;
-    }
-
-    memset(m_buffer[cameraId], 0x0, sizeof(timeLogger_t) * TIME_LOGGER_SIZE);
+    /* a previous session of the camera may have ended without save() */
+    m_ringLock.lock();
+    m_recycleRings(cameraId);
+    m_ringLock.unlock();
 
     /* init the variables */
-    m_bufferIndex[cameraId] = 0;
-    m_stopFlag[cameraId] = false;
-    m_firstCheckFlag[cameraId] = false;
     m_count[cameraId] = 0;
+    m_numOfDropped[cameraId] = 0;
+    m_startTime[cameraId] = traceRingNow();
+    m_stopFlag[cameraId] = false;
 
     return ret;
 }
@@ -159,18 +178,13 @@ status_t ExynosCameraTimeLogger::init(int cameraId)
 status_t ExynosCameraTimeLogger::update(int cameraId, uint64_t key, uint32_t pipeId, LOGGER_TYPE type, LOGGER_CATEGORY category, uint64_t userData)
 {
     status_t ret = NO_ERROR;
-    ExynosCameraDurationTimer *timer;
-    timeLogger_t *buffer;
-    int bufferIndex;
+    ExynosCameraTraceRing *ring;
+    uint8_t phase = TRACE_PHASE_INSTANT;
+    uint32_t value = 0;
 
     if (m_stopFlag[cameraId] == true || checkCondition(category) == false)
         return ret;
 
-    if (m_buffer[cameraId] == NULL) {
-        CLOGE3(cameraId, "can't alloc buffer");
-        return INVALID_OPERATION;
-    }
-
     if (type <= LOGGER_TYPE_BASE || type >= LOGGER_TYPE_MAX) {
         CLOGE3(cameraId, "invalid type(%d)", type);
         return INVALID_OPERATION;
@@ -181,83 +195,35 @@ status_t ExynosCameraTimeLogger::update(int cameraId, uint64_t key, uint32_t pip
         return INVALID_OPERATION;
     }
 
-    timer = &m_timer[cameraId][type][category][pipeId];
+    ring = m_getRing();
+    if (ring == NULL) {
+        android_atomic_inc(&m_numOfDropped[cameraId]);
+        return INVALID_OPERATION;
+    }
 
     switch (type) {
-    case LOGGER_TYPE_INTERVAL:
-        timer->stop();
-
-        if (m_firstCheckFlag[cameraId] == false) {
-            timer->start();
-            m_firstCheckFlag[cameraId] = true;
-        } else {
-            goto p_logger;
-        }
-        break;
     case LOGGER_TYPE_DURATION:
-        if (userData) {
-            timer->start();
-        } else {
-            timer->stop();
-            goto p_logger;
-        }
+        phase = (userData) ? TRACE_PHASE_BEGIN : TRACE_PHASE_END;
         break;
     case LOGGER_TYPE_CUMULATIVE_CNT:
-        if (m_firstCheckFlag[cameraId] == false) {
-            m_count[cameraId] = 1;
-            m_firstCheckFlag[cameraId] = true;
-        } else {
-            m_count[cameraId]++;
-        }
-        goto p_logger;
+        value = android_atomic_inc(&m_count[cameraId]) + 1;
         break;
     case LOGGER_TYPE_USER_DATA:
-        goto p_logger;
+        value = (uint32_t)userData;
         break;
     default:
         break;
     }
 
-    return ret;
-
-p_logger:
-    bufferIndex = (android_atomic_inc(&m_bufferIndex[cameraId])) % TIME_LOGGER_SIZE;
-    buffer = &m_buffer[cameraId][bufferIndex];
+    ring->record(cameraId, (uint32_t)key, (uint16_t)pipeId, type, category, phase, value);
 
-    /* save the time(us) or count */
-    switch (type) {
-    case LOGGER_TYPE_INTERVAL:
-        buffer->calTime = timer->durationUsecs();
-        /* for interval time */
-        if (type == LOGGER_TYPE_INTERVAL)
-            timer->start();
-        break;
-    case LOGGER_TYPE_DURATION:
-        buffer->calTime = timer->durationUsecs();
-        break;
-    case LOGGER_TYPE_CUMULATIVE_CNT:
-        buffer->calTime = m_count[cameraId];
-        break;
-    case LOGGER_TYPE_USER_DATA:
-        buffer->calTime = userData;
-        break;
-    default:
-        break;
-    };
-    buffer->timeStamp = systemTime(SYSTEM_TIME_REALTIME) / 1000000LL;
-    buffer->cameraId = cameraId;
-    buffer->key = key;
-    buffer->pipeId = pipeId;
-    buffer->type = type;
-    buffer->category = category;
-
-    CLOGV3(cameraId, "TimeStamp:%jd,Key:%jd,Pipe:%d,Type:%s,Cate:%s,CalT:%d",
-            buffer->timeStamp,
-            buffer->key,
-            buffer->pipeId,
-            m_typeStr[buffer->type],
-            m_categoryStr[buffer->category],
-            buffer->calTime);
+    CLOGV3(cameraId, "Key:%jd,Pipe:%d,Type:%s,Cate:%s,Phase:%d,Value:%d",
+            key,
+            pipeId,
+            m_typeStr[type],
+            m_categoryStr[category],
+            phase,
+            value);
 
     return ret;
 }
@@ -267,20 +233,35 @@ status_t ExynosCameraTimeLogger::save(int cameraId)
     status_t ret = NO_ERROR;
     FILE *fd = NULL;
     char filePath[128];
-    timeLogger_t *buffer;
-
-    if (m_stopFlag[cameraId] == true) {
-        return ret;
-    } else if (m_bufferIndex[cameraId] == 0) {
-        CLOGD3(cameraId, "No data to save");
+    std::vector<traceEvent_t> events;
+    std::vector<int> tids;
+    std::vector<std::pair<int, std::string> > threads;
+    std::map<uint32_t, uint64_t> lastInterval;
+    std::map<uint32_t, uint64_t>::iterator iter;
+    uint32_t numOfLost = 0;
+    const char phaseChar[] = {'i', 'B', 'E'};
+
+    if (m_stopFlag[cameraId] == true)
         return ret;
-    }
 
     m_stopFlag[cameraId] = true;
 
-    if (m_buffer[cameraId] == NULL) {
-        CLOGE3(cameraId, "can't alloc buffer");
-        return INVALID_OPERATION;
+    /* collect the session from every thread, then the camera is done with the rings */
+    m_ringLock.lock();
+    for (int i = 0; i < m_numOfRing; i++) {
+        uint32_t numOfRead = m_ring[i]->read(cameraId, m_startTime[cameraId], &events);
+
+        tids.insert(tids.end(), numOfRead, m_ring[i]->getTid());
+        numOfLost += m_ring[i]->getNumOfLost();
+        if (numOfRead > 0)
+            threads.push_back(std::make_pair(m_ring[i]->getTid(), std::string(m_ring[i]->getName())));
+    }
+    m_recycleRings(cameraId);
+    m_ringLock.unlock();
+
+    if (events.empty() == true) {
+        CLOGD3(cameraId, "No data to save");
+        return ret;
     }
 
     snprintf(filePath, sizeof(filePath), TIME_LOGGER_PATH, cameraId, (unsigned long long)systemTime(SYSTEM_TIME_MONOTONIC));
@@ -291,38 +272,138 @@ status_t ExynosCameraTimeLogger::save(int cameraId)
         return INVALID_OPERATION;
     }
 
-    CLOGD3(cameraId, "save the time logger(%s)", filePath);
-
-    /* save the file */
-    fprintf(fd, "timestamp(ms),key,pipeId,type,category,calTime(us)\n");
-    for (int i = 0; i < TIME_LOGGER_SIZE; i++) {
-        buffer = &m_buffer[cameraId][i];
-        if (buffer->timeStamp == 0)
-            continue;
-
-        fprintf(fd, "%jd,%jd,%d,%s,%s,%d\n",
-                buffer->timeStamp,
-                buffer->key,
-                buffer->pipeId,
-                m_typeStr[buffer->type],
-                m_categoryStr[buffer->category],
-                buffer->calTime);
+    CLOGD3(cameraId, "save the time logger(%s), events(%zu)", filePath, events.size());
+
+    /* every thread is already in time order, merge them */
+    std::vector<uint32_t> order(events.size());
+    for (uint32_t i = 0; i < order.size(); i++)
+        order[i] = i;
+
+    std::stable_sort(order.begin(), order.end(), [&events](uint32_t a, uint32_t b) {
+        return events[a].timeStamp < events[b].timeStamp;
+    });
+
+    fprintf(fd, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(fd, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"camera%d\"}}",
+            cameraId, cameraId);
+
+    for (uint32_t i = 0; i < threads.size(); i++) {
+        fprintf(fd, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                cameraId, threads[i].first, threads[i].second.c_str());
+    }
+
+    for (uint32_t i = 0; i < order.size(); i++) {
+        traceEvent_t *event = &events[order[i]];
+
+        fprintf(fd, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%" PRIu64 ".%03u,"
+                "\"pid\":%d,\"tid\":%d,%s\"args\":{\"key\":%u,\"pipeId\":%u",
+                m_categoryStr[event->category],
+                m_typeStr[event->type],
+                phaseChar[event->phase],
+                event->timeStamp / 1000, (uint32_t)(event->timeStamp % 1000),
+                cameraId,
+                tids[order[i]],
+                (event->phase == TRACE_PHASE_INSTANT) ? "\"s\":\"t\"," : "",
+                event->key,
+                event->pipeId);
+
+        switch (event->type) {
+        case LOGGER_TYPE_INTERVAL:
+            iter = lastInterval.find((event->category << 16) | event->pipeId);
+            if (iter != lastInterval.end()) {
+                fprintf(fd, ",\"interval_us\":%" PRIu64 ".%03u",
+                        (event->timeStamp - iter->second) / 1000,
+                        (uint32_t)((event->timeStamp - iter->second) % 1000));
+                iter->second = event->timeStamp;
+            } else {
+                lastInterval[(event->category << 16) | event->pipeId] = event->timeStamp;
+            }
+            break;
+        case LOGGER_TYPE_CUMULATIVE_CNT:
+            fprintf(fd, ",\"count\":%u", event->value);
+            break;
+        case LOGGER_TYPE_USER_DATA:
+            fprintf(fd, ",\"value\":%u", event->value);
+            break;
+        default:
+            break;
+        }
+
+        fprintf(fd, "}}");
     }
-    fprintf(fd, "totalCount:%d\n", m_count[cameraId]);
+
+    fprintf(fd, "\n],\"otherData\":{\"totalCount\":\"%d\",\"lost\":\"%u\",\"dropped\":\"%d\"}}\n",
+            m_count[cameraId], numOfLost, m_numOfDropped[cameraId]);
 
     fflush(fd);
 
     CLOGD3(cameraId, "success!! to save the time logger(%s)", filePath);
 
-    /* free the memory */
     if (fd)
         fclose(fd);
-    free(m_buffer[cameraId]);
-    m_buffer[cameraId] = NULL;
 
     return ret;
 }
 
+ExynosCameraTraceRing *ExynosCameraTimeLogger::m_getRing(void)
+{
+    ExynosCameraTraceRing *ring = (ExynosCameraTraceRing *)pthread_getspecific(m_ringKey);
+    char name[TRACE_RING_NAME_SIZE] = {0};
+    int tid;
+
+    if (ring != NULL)
+        return ring;
+
+    /* first event of this thread */
+    prctl(PR_GET_NAME, name, 0, 0, 0);
+    tid = gettid();
+
+    Mutex::Autolock lock(m_ringLock);
+
+    for (int i = 0; i < m_numOfRing; i++) {
+        if (m_ring[i]->acquire(tid, name) == true) {
+            ring = m_ring[i];
+            break;
+        }
+    }
+
+    if (ring == NULL) {
+        if (m_numOfRing >= TIME_LOGGER_MAX_THREADS)
+            return NULL;
+
+        ring = new ExynosCameraTraceRing(TIME_LOGGER_RING_SIZE);
+        ring->acquire(tid, name);
+        m_ring[m_numOfRing++] = ring;
+    }
+
+    pthread_setspecific(m_ringKey, ring);
+
+    return ring;
+}
+
+/*
+ * Called with m_ringLock held. The rings of exited threads are handed out
+ * again once every camera they recorded for is idle, idleCameraId counts
+ * as idle.
+ */
+void ExynosCameraTimeLogger::m_recycleRings(int idleCameraId)
+{
+    uint32_t busyCameraMask = 0;
+
+    for (int i = 0; i < CAMERA_ID_MAX; i++) {
+        if (i != idleCameraId && m_stopFlag[i] == false)
+            busyCameraMask |= (1U << i);
+    }
+
+    for (int i = 0; i < m_numOfRing; i++)
+        m_ring[i]->recycle(busyCameraMask);
+}
+
+void ExynosCameraTimeLogger::m_releaseRing(void *ring)
+{
+    ((ExynosCameraTraceRing *)ring)->release();
+}
+
 bool ExynosCameraTimeLogger::checkCondition(LOGGER_CATEGORY category)
 {
     if (category > LOGGER_CATEGORY_LAUNCHING_TIME_START
@@ -28,6 +28,7 @@
 #define EXYNOS_CAMERA_TIME_LOGGER_H
 
 #include "string.h"
+#include <pthread.h>
 #include <utils/Log.h>
 #include <cutils/atomic.h>
 
@@ -36,12 +37,15 @@
 #include "ExynosCameraCommonInclude.h"
 #include "ExynosCameraSingleton.h"
 #include "ExynosCameraSensorInfoBase.h"
+#include "ExynosCameraTraceRing.h"
 
-#define TIME_LOGGER_SIZE (1024 * 100) /* 100K * logger */
+#define TIME_LOGGER_RING_SIZE   (1024 * 4) /* 4K events(96KB) per thread */
+#define TIME_LOGGER_MAX_THREADS (64)
+/* chrome trace-event json, opens in chrome://tracing and ui.perfetto.dev */
 #ifdef CAMERA_GED_FEATURE
-#define TIME_LOGGER_PATH "/data/dump/exynos_camera_time_logger_cam%d_%lld.csv"
+#define TIME_LOGGER_PATH "/data/dump/exynos_camera_time_logger_cam%d_%lld.json"
 #else
-#define TIME_LOGGER_PATH "/data/camera/exynos_camera_time_logger_cam%d_%lld.csv"
+#define TIME_LOGGER_PATH "/data/camera/exynos_camera_time_logger_cam%d_%lld.json"
 #endif
 
 #define TIME_LOGGER_INIT_BASE(logger, cameraId)          \
@@ -188,24 +192,14 @@ typedef enum LOGGER_CATEGORY {
 /*
  * Class ExynosCameraTimeLogger
  * ExynosCameraTimeLogger is the time logging class for profiling performance.
- * This class cannot support concurrent processing of timelogging for same logger
- * (same logger condition : same pipeLine && same logger_type && same logger_category)
+ * Every thread records compact events into its own ExynosCameraTraceRing,
+ * so loggers of the same pipe, type and category can run concurrently.
+ * Durations and intervals are resolved when the session is exported.
  */
 class ExynosCameraTimeLogger
 {
 public:
-
-    typedef struct timeLogger {
-        uint64_t timeStamp;     /* ns : logging time */
-        int cameraId;
-        uint64_t key;
-        uint32_t pipeId;
-        LOGGER_TYPE type;
-        LOGGER_CATEGORY category;
-        uint32_t calTime;       /* us : cacluated time(duration, interval..) */
-    } timeLogger_t;
-
-    /* memset all logger information */
+    /* start a session of cameraId */
     status_t init(int cameraId);
 
     /*
@@ -229,7 +223,12 @@ public:
     status_t update(int cameraId, uint64_t key, uint32_t pipeId, LOGGER_TYPE type, LOGGER_CATEGORY category, uint64_t userData);
 
     /*
-     * save all information to file
+     * save the session to a chrome trace-event json file
+     *  DURATION        : "B"/"E" slice on the recording thread
+     *  INTERVAL        : instant, args.interval_us from the previous one of
+     *                    the same category and pipe
+     *  CUMULATIVE_CNT  : instant, args.count
+     *  USER_DATA       : instant, args.value
      */
     status_t save(int cameraId);
 
@@ -242,13 +241,22 @@ public:
     ExynosCameraTimeLogger();
     virtual ~ExynosCameraTimeLogger();
 
+private:
+    ExynosCameraTraceRing   *m_getRing(void);
+    void                    m_recycleRings(int idleCameraId);
+    static void             m_releaseRing(void *ring);
+
 private:
     bool                    m_stopFlag[CAMERA_ID_MAX];
-    bool                    m_firstCheckFlag[CAMERA_ID_MAX];
-    ExynosCameraDurationTimer   m_timer[CAMERA_ID_MAX][LOGGER_TYPE_MAX][LOGGER_CATEGORY_MAX][MAX_PIPE_NUM];
-    uint32_t                m_count[CAMERA_ID_MAX];
-    int32_t                 m_bufferIndex[CAMERA_ID_MAX];
-    timeLogger_t            *m_buffer[CAMERA_ID_MAX];
+    int32_t                 m_count[CAMERA_ID_MAX];
+    int32_t                 m_numOfDropped[CAMERA_ID_MAX];
+    uint64_t                m_startTime[CAMERA_ID_MAX];
+
+    pthread_key_t           m_ringKey;
+    ExynosCameraTraceRing   *m_ring[TIME_LOGGER_MAX_THREADS];
+    int32_t                 m_numOfRing;
+    Mutex                   m_ringLock;
+
     char                    m_name[EXYNOS_CAMERA_NAME_STR_SIZE];
     char                    *m_typeStr[LOGGER_TYPE_MAX];
     char                    *m_categoryStr[LOGGER_CATEGORY_MAX];
@@ -0,0 +1,210 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*!
+ * \file      ExynosCameraTraceRing.h
+ * \brief     header file for the per-thread event ring of ExynosCameraTimeLogger
+ *
+ */
+
+#ifndef EXYNOS_CAMERA_TRACE_RING_H
+#define EXYNOS_CAMERA_TRACE_RING_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <atomic>
+#include <vector>
+
+#define TRACE_RING_NAME_SIZE (16)
+
+typedef enum TRACE_RING_STATE {
+    TRACE_RING_STATE_FREE,      /* empty, can be handed to a thread */
+    TRACE_RING_STATE_USED,      /* owned by a live thread */
+    TRACE_RING_STATE_RELEASED,  /* owner exited, events kept for export by its cameras */
+} trace_ring_state_t;
+
+typedef enum TRACE_PHASE {
+    TRACE_PHASE_INSTANT,
+    TRACE_PHASE_BEGIN,
+    TRACE_PHASE_END,
+} trace_phase_t;
+
+/* 24 bytes, fields are narrowed to what the logger really uses */
+typedef struct traceEvent {
+    uint64_t timeStamp;     /* ns : CLOCK_MONOTONIC */
+    uint32_t key;           /* frameCount, request key or buffer index */
+    uint32_t value;         /* user data or count */
+    uint16_t pipeId;
+    uint8_t  cameraId;
+    uint8_t  type;
+    uint8_t  category;
+    uint8_t  phase;
+} traceEvent_t;
+
+static inline uint64_t traceRingNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*
+ * Flight recorder of one thread.
+ * Only the owner thread records, so a record is a store of the event and
+ * a release store of the head, without lock or atomic read-modify-write.
+ * When the ring wraps the oldest events are overwritten.
+ * Readers copy the last events after the head; they should stop the
+ * writers first, or the oldest copied events may be torn.
+ */
+class ExynosCameraTraceRing {
+public:
+    ExynosCameraTraceRing(uint32_t size)
+    {
+        uint32_t ringSize = 2;
+
+        while (ringSize < size && ringSize < (1U << 24))
+            ringSize <<= 1;
+
+        m_mask = ringSize - 1;
+        m_events = new traceEvent_t[ringSize];
+        m_head.store(0, std::memory_order_relaxed);
+        m_state.store(TRACE_RING_STATE_FREE, std::memory_order_relaxed);
+        m_cameraMask.store(0, std::memory_order_relaxed);
+        m_tid = 0;
+        memset(m_name, 0x0, sizeof(m_name));
+    }
+
+    ~ExynosCameraTraceRing()
+    {
+        delete[] m_events;
+    }
+
+    inline void record(uint8_t cameraId, uint32_t key, uint16_t pipeId,
+                       uint8_t type, uint8_t category, uint8_t phase, uint32_t value)
+    {
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        uint32_t cameraMask = m_cameraMask.load(std::memory_order_relaxed);
+        traceEvent_t *event = &m_events[head & m_mask];
+
+        if ((cameraMask & (1U << (cameraId & 31))) == 0)
+            m_cameraMask.store(cameraMask | (1U << (cameraId & 31)), std::memory_order_relaxed);
+
+        event->timeStamp = traceRingNow();
+        event->key = key;
+        event->value = value;
+        event->pipeId = pipeId;
+        event->cameraId = cameraId;
+        event->type = type;
+        event->category = category;
+        event->phase = phase;
+
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    /* copies the events of cameraId recorded since startTime, oldest first */
+    uint32_t read(int cameraId, uint64_t startTime, std::vector<traceEvent_t> *events)
+    {
+        uint32_t head = m_head.load(std::memory_order_acquire);
+        uint32_t count = (head > m_mask + 1) ? m_mask + 1 : head;
+        uint32_t numOfRead = 0;
+
+        for (uint32_t pos = head - count; pos != head; pos++) {
+            traceEvent_t *event = &m_events[pos & m_mask];
+
+            if (event->cameraId != cameraId || event->timeStamp < startTime)
+                continue;
+
+            events->push_back(*event);
+            numOfRead++;
+        }
+
+        return numOfRead;
+    }
+
+    /* events overwritten by the wrap */
+    uint32_t getNumOfLost(void)
+    {
+        uint32_t head = m_head.load(std::memory_order_acquire);
+
+        return (head > m_mask + 1) ? head - (m_mask + 1) : 0;
+    }
+
+    /*
+     * Owner bookkeeping. A ring keeps the events of its exited owner until
+     * recycle(), so the export still names the right thread. The owner
+     * marks every camera it records for, the ring is recycled once those
+     * are done with it.
+     */
+    bool acquire(int tid, const char *name)
+    {
+        int state = TRACE_RING_STATE_FREE;
+
+        if (m_state.compare_exchange_strong(state, TRACE_RING_STATE_USED) == false)
+            return false;
+
+        m_tid = tid;
+        snprintf(m_name, sizeof(m_name), "%s", name);
+        m_head.store(0, std::memory_order_relaxed);
+        m_cameraMask.store(0, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    void release(void)
+    {
+        m_state.store(TRACE_RING_STATE_RELEASED, std::memory_order_release);
+    }
+
+    /* busyCameraMask : a bit per camera id still logging */
+    bool recycle(uint32_t busyCameraMask)
+    {
+        int state = TRACE_RING_STATE_RELEASED;
+
+        /* the acquire pairs with release(), the owner is done with the mask */
+        if (m_state.load(std::memory_order_acquire) != TRACE_RING_STATE_RELEASED)
+            return false;
+
+        if ((m_cameraMask.load(std::memory_order_relaxed) & busyCameraMask) != 0)
+            return false;
+
+        return m_state.compare_exchange_strong(state, TRACE_RING_STATE_FREE);
+    }
+
+    int getTid(void)
+    {
+        return m_tid;
+    }
+
+    const char *getName(void)
+    {
+        return m_name;
+    }
+
+private:
+    traceEvent_t            *m_events;
+    uint32_t                m_mask;
+    std::atomic<uint32_t>   m_head;
+    std::atomic<int>        m_state;
+    std::atomic<uint32_t>   m_cameraMask;
+    int                     m_tid;
+    char                    m_name[TRACE_RING_NAME_SIZE];
+};
+#endif //EXYNOS_CAMERA_TRACE_RING_H
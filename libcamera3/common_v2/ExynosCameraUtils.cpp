@@ -2768,166 +2768,310 @@ bool isFastenAeStableSupported(int cameraId)
 
 #ifdef USE_INTERNAL_ALLOC_DEBUG
 //NOTE: Can't use the default C++ map and list utilities incase of global new/delete operator overloading
-using namespace std;
-#define PRINT_CALLSTACK
-
-static int alloc_cnt = 0;
-android::Mutex              m_myAllocLock;
-android::Mutex             m_AllocLock;
+#include <atomic>
+#include <stdint.h>
+#include <sched.h>
 
+#define PRINT_CALLSTACK
 
-typedef struct myElm myElm_t;
-struct myElm {
-    void *ptr;
-    int size;
-    int cnt;
-};
+/*
+ * Live blocks are kept in ALLOC_INFO_SHARD_NUM open-addressing hash tables.
+ * The shard is picked from the pointer hash, so concurrent new/delete on
+ * different blocks hardly ever touch the same shard lock, and insert/erase
+ * are O(1) regardless of how many blocks are alive.
+ * Erase uses backward-shift deletion, so there are no tombstones to purge.
+ * A block whose shard is full goes to the overflow shard instead, so every
+ * tracked delete can still be matched and an unknown pointer is an error.
+ */
+#define ALLOC_INFO_SHARD_SHIFT      (6)
+#define ALLOC_INFO_SHARD_NUM        (1 << ALLOC_INFO_SHARD_SHIFT)
+#define ALLOC_INFO_SLOT_SHIFT       (13)
+#define ALLOC_INFO_SLOT_NUM         (1 << ALLOC_INFO_SLOT_SHIFT)
+#define ALLOC_INFO_SLOT_MASK        (ALLOC_INFO_SLOT_NUM - 1)
+#define ALLOC_INFO_SLOT_LIMIT       ((ALLOC_INFO_SLOT_NUM * 3) / 4)
+
+typedef struct alloc_slot {
+    uintptr_t ptr;  /* 0 : empty slot */
+    size_t    size;
+    void     *caller;
+} alloc_slot_t;
+
+typedef struct alloc_shard {
+    std::atomic<bool> lock;
+    int               used;
+    alloc_slot_t     *slot;
+} __attribute__((aligned(64))) alloc_shard_t;
+
+static alloc_shard_t        g_allocShard[ALLOC_INFO_SHARD_NUM];
+static alloc_shard_t        g_allocOverflow;
+static std::atomic<int>     alloc_cnt(0);
+static std::atomic<size_t>  alloc_bytes(0);
+static std::atomic<int>     dropped_cnt(0);
+static std::atomic<int>     lost_cnt(0);
 
-typedef struct my_node my_node_t;
-struct my_node {
-    my_node_t *next;
-    myElm_t elm;
-};
+static int elm_size()
+{
+    return alloc_cnt.load(std::memory_order_relaxed);
+}
 
-my_node_t *used_list = NULL;
-my_node_t *free_list = NULL;
-static int used_cnt = 0;
-static int myList_init = 0;
+static inline uint64_t alloc_hash(uintptr_t ptr)
+{
+    /* malloc alignment leaves the low bits empty, fibonacci hashing spreads the rest */
+    return (uint64_t)(ptr >> 4) * 0x9E3779B97F4A7C15ULL;
+}
 
-static int elm_size()
+static inline int alloc_shard_index(uint64_t hash)
 {
-    return alloc_cnt;
+    return (int)(hash >> (64 - ALLOC_INFO_SHARD_SHIFT));
 }
 
+static inline int alloc_slot_index(uint64_t hash)
+{
+    return (int)((hash >> (64 - ALLOC_INFO_SHARD_SHIFT - ALLOC_INFO_SLOT_SHIFT)) & ALLOC_INFO_SLOT_MASK);
+}
 
-my_node_t *get_node()
+static inline void shard_lock(alloc_shard_t *shard)
 {
-    my_node_t *node;
-    node = (my_node_t *)malloc(sizeof(my_node_t));
-    if (!node) {
-        ALOGE("[EXYNOS_CAMERA_ALLOC: %s:  %d], failed to allocate", __FUNCTION__, __LINE__);
-        return NULL;
+    while (shard->lock.exchange(true, std::memory_order_acquire) == true) {
+        while (shard->lock.load(std::memory_order_relaxed) == true)
+            sched_yield();
     }
+}
 
-    node->next = NULL;
-    node->elm.ptr = NULL;
-    node->elm.size = 0;
-    return node;
+static inline void shard_unlock(alloc_shard_t *shard)
+{
+    shard->lock.store(false, std::memory_order_release);
 }
 
-void insert_node(my_node_t **list, my_node_t *node)
+static bool shard_insert(alloc_shard_t *shard, uint64_t hash, void *ptr, size_t size, void *caller)
 {
-    m_myAllocLock.lock();
-    if (*list == NULL) {
-        *list = node;
-        goto insert_node_end;
+    bool ret = false;
+    int i;
+
+    shard_lock(shard);
+    if (shard->slot == NULL) {
+        shard->slot = (alloc_slot_t *)calloc(ALLOC_INFO_SLOT_NUM, sizeof(alloc_slot_t));
+        if (shard->slot == NULL) {
+            ALOGE("[EXYNOS_CAMERA_ALLOC: %s:  %d], failed to allocate", __FUNCTION__, __LINE__);
+            goto insert_node_end;
+        }
     }
 
-    node->next = *list;
-    *list = node;
+    if (shard->used >= ALLOC_INFO_SLOT_LIMIT)
+        goto insert_node_end;
+
+    i = alloc_slot_index(hash);
+    while (shard->slot[i].ptr != 0)
+        i = (i + 1) & ALLOC_INFO_SLOT_MASK;
+
+    shard->slot[i].ptr = (uintptr_t)ptr;
+    shard->slot[i].size = size;
+    shard->slot[i].caller = caller;
+    shard->used++;
+    ret = true;
 
 insert_node_end:
-    m_myAllocLock.unlock();
+    shard_unlock(shard);
+    return ret;
 }
 
-
-my_node_t *delete_node(my_node_t *node, my_node_t *prev)
+static bool shard_remove(alloc_shard_t *shard, uint64_t hash, void *ptr, size_t *size)
 {
+    alloc_slot_t *slot;
+    bool ret = false;
+    int i, j, home;
+
+    shard_lock(shard);
+    slot = shard->slot;
+    if (slot == NULL)
+        goto remove_node_end;
+
+    i = alloc_slot_index(hash);
+    while (slot[i].ptr != 0 && slot[i].ptr != (uintptr_t)ptr)
+        i = (i + 1) & ALLOC_INFO_SLOT_MASK;
+
+    if (slot[i].ptr == 0)
+        goto remove_node_end;
+
+    *size = slot[i].size;
+    slot[i].ptr = 0;
+    shard->used--;
+    ret = true;
 
-    my_node_t *ret_node = NULL;
-    if (node == NULL) {
-        return NULL;
+    /* Shift the rest of the probe chain back into the hole */
+    j = i;
+    while (true) {
+        j = (j + 1) & ALLOC_INFO_SLOT_MASK;
+        if (slot[j].ptr == 0)
+            break;
+
+        home = alloc_slot_index(alloc_hash(slot[j].ptr));
+        if (((j - home) & ALLOC_INFO_SLOT_MASK) >= ((j - i) & ALLOC_INFO_SLOT_MASK)) {
+            slot[i] = slot[j];
+            slot[j].ptr = 0;
+            i = j;
+        }
     }
 
-    if (prev != NULL) {
-        prev->next = node->next;
-        ret_node = prev;
-    } else {
-        ret_node = node->next;
+remove_node_end:
+    shard_unlock(shard);
+    return ret;
+}
+
+static bool insert_node(void *ptr, size_t size, void *caller)
+{
+    uint64_t hash = alloc_hash((uintptr_t)ptr);
+
+    if (shard_insert(&g_allocShard[alloc_shard_index(hash)], hash, ptr, size, caller) == true)
+        return true;
+
+    if (shard_insert(&g_allocOverflow, hash, ptr, size, caller) == true) {
+        dropped_cnt.fetch_add(1, std::memory_order_relaxed);
+        return true;
     }
 
-    free(node);
-    return ret_node;
+    lost_cnt.fetch_add(1, std::memory_order_relaxed);
+    return false;
 }
 
-my_node_t *remove_node(my_node_t **list, void* ptr)
+static bool remove_node(void *ptr, size_t *size)
 {
-    my_node_t *node;
-    my_node_t *ret_node;
-    my_node_t *prev = NULL;
-    myElm_t *elm = NULL;
+    uint64_t hash = alloc_hash((uintptr_t)ptr);
 
-    m_myAllocLock.lock();
-    node = *list;
-    if (node && node->elm.ptr == ptr) {
-        *list = node->next;
-        goto remove_node_end;
+    if (shard_remove(&g_allocShard[alloc_shard_index(hash)], hash, ptr, size) == true)
+        return true;
+
+    if (dropped_cnt.load(std::memory_order_relaxed) > 0
+        && shard_remove(&g_allocOverflow, hash, ptr, size) == true) {
+        dropped_cnt.fetch_sub(1, std::memory_order_relaxed);
+        return true;
     }
 
-    while (node && node->elm.ptr != ptr) {
-        prev = node;
-        node = node->next;
+    return false;
+}
+
+static int size_class(size_t size)
+{
+    int sizeClass = 0;
+
+    while (size > 1 && sizeClass < ALLOC_INFO_SIZE_CLASS_MAX - 1) {
+        size >>= 1;
+        sizeClass++;
     }
 
-    if (node == NULL) {
-        ALOGE("[EXYNOS_CAMERA_ALLOC: %s : %d]: failed to find the elm->ptr[%p] to remove : alloc_cnt = %d",
-            __FUNCTION__, __LINE__, ptr, alloc_cnt);
-    } else if (prev) {
-        prev->next = node->next;
-        node->next = NULL;
+    return sizeClass;
+}
+
+static void add_callsite(alloc_info_snapshot_t *snapshot, void *caller, size_t size)
+{
+    for (int i = 0; i < snapshot->callsite_cnt; i++) {
+        if (snapshot->callsite[i].caller == caller) {
+            snapshot->callsite[i].count++;
+            snapshot->callsite[i].bytes += size;
+            return;
+        }
     }
-remove_node_end:
 
-    m_myAllocLock.unlock();
-    return node;
+    if (snapshot->callsite_cnt < ALLOC_INFO_CALLSITE_MAX) {
+        alloc_info_callsite_t *callsite = &snapshot->callsite[snapshot->callsite_cnt++];
+        callsite->caller = caller;
+        callsite->count = 1;
+        callsite->bytes = size;
+    } else {
+        snapshot->callsite_overflow_cnt++;
+    }
 }
 
-my_node_t *get_free_node(my_node_t **list)
+int alloc_info_snapshot(alloc_info_snapshot_t *snapshot)
 {
-    my_node_t *node;
-    myElm_t *elm = NULL;
+    alloc_shard_t *shard;
+
+    if (snapshot == NULL)
+        return -1;
 
-    m_myAllocLock.lock();
-    node = *list;
-    if (!node) {
-        node = get_node();
-        if (!node)
-            goto get_free_node_end;
+    memset(snapshot, 0, sizeof(alloc_info_snapshot_t));
+
+    for (int s = 0; s <= ALLOC_INFO_SHARD_NUM; s++) {
+        shard = (s < ALLOC_INFO_SHARD_NUM) ? &g_allocShard[s] : &g_allocOverflow;
+        shard_lock(shard);
+        if (shard->slot != NULL && shard->used > 0) {
+            for (int i = 0; i < ALLOC_INFO_SLOT_NUM; i++) {
+                alloc_slot_t *slot = &shard->slot[i];
+                if (slot->ptr == 0)
+                    continue;
+
+                int sizeClass = size_class(slot->size);
+                snapshot->live_cnt++;
+                snapshot->live_bytes += slot->size;
+                snapshot->size_class[sizeClass].count++;
+                snapshot->size_class[sizeClass].bytes += slot->size;
+                add_callsite(snapshot, slot->caller, slot->size);
+            }
+        }
+        shard_unlock(shard);
     }
-    *list = node->next;
-    node->next = NULL;
-get_free_node_end:
 
-    m_myAllocLock.unlock();
+    snapshot->dropped_cnt = dropped_cnt.load(std::memory_order_relaxed);
+    snapshot->lost_cnt = lost_cnt.load(std::memory_order_relaxed);
 
-    return node;
+    return 0;
 }
 
 int alloc_info_print(int flag)
 {
-    my_node_t *node;
-    m_myAllocLock.lock();
+    alloc_info_snapshot_t *snapshot;
 
-    ALOGI("[EXYNOS_CAMERA_ALLOC: %s : %d] : ALIVE MEMORY BLOCKS INFO -Start",
-        __FUNCTION__, __LINE__);
-    ALOGI("[EXYNOS_CAMERA_ALLOC: %s : %d] : %p : alloc_cnt %d used_cnt %d",
-        __FUNCTION__, __LINE__, used_list, alloc_cnt, used_cnt);
-
-    if (flag == 0) {
-        node = used_list;
-    } else {
-        node = free_list;
+    snapshot = (alloc_info_snapshot_t *)malloc(sizeof(alloc_info_snapshot_t));
+    if (snapshot == NULL) {
+        ALOGE("[EXYNOS_CAMERA_ALLOC: %s:  %d], failed to allocate", __FUNCTION__, __LINE__);
+        return -1;
     }
 
-    while(node) {
-        ALOGI("[EXYNOS_CAMERA_ALLOC: %s : %d] : %p : %d : %d", __FUNCTION__, __LINE__,
-            node->elm.ptr, node->elm.size, node->elm.cnt);
-        node = node->next;
+    alloc_info_snapshot(snapshot);
+
+    ALOGI("[EXYNOS_CAMERA_ALLOC: %s : %d] : ALIVE MEMORY BLOCKS INFO -Start",
+        __FUNCTION__, __LINE__);
+    ALOGI("[EXYNOS_CAMERA_ALLOC: %s : %d] : alloc_cnt %d live_cnt %zu live_bytes %zu dropped_cnt %d lost_cnt %d",
+        __FUNCTION__, __LINE__, elm_size(), snapshot->live_cnt, snapshot->live_bytes,
+        snapshot->dropped_cnt, snapshot->lost_cnt);
+
+    for (int i = 0; i < ALLOC_INFO_SIZE_CLASS_MAX; i++) {
+        if (snapshot->size_class[i].count == 0)
+            continue;
+        ALOGI("[EXYNOS_CAMERA_ALLOC: %s : %d] : size class [%zu ~ ) : %zu blocks : %zu bytes",
+            __FUNCTION__, __LINE__, (size_t)1 << i,
+            snapshot->size_class[i].count, snapshot->size_class[i].bytes);
+    }
+
+    for (int i = 0; i < snapshot->callsite_cnt; i++) {
+        ALOGI("[EXYNOS_CAMERA_ALLOC: %s : %d] : caller %p : %zu blocks : %zu bytes",
+            __FUNCTION__, __LINE__, snapshot->callsite[i].caller,
+            snapshot->callsite[i].count, snapshot->callsite[i].bytes);
+    }
+    if (snapshot->callsite_overflow_cnt > 0) {
+        ALOGI("[EXYNOS_CAMERA_ALLOC: %s : %d] : %zu blocks from untracked callers",
+            __FUNCTION__, __LINE__, snapshot->callsite_overflow_cnt);
+    }
+
+    /* flag != 0 : dump every alive block as well */
+    if (flag != 0) {
+        for (int s = 0; s <= ALLOC_INFO_SHARD_NUM; s++) {
+            alloc_shard_t *shard = (s < ALLOC_INFO_SHARD_NUM) ? &g_allocShard[s] : &g_allocOverflow;
+            shard_lock(shard);
+            for (int i = 0; shard->slot != NULL && i < ALLOC_INFO_SLOT_NUM; i++) {
+                if (shard->slot[i].ptr == 0)
+                    continue;
+                ALOGI("[EXYNOS_CAMERA_ALLOC: %s : %d] : %p : %zu : %p", __FUNCTION__, __LINE__,
+                    (void *)shard->slot[i].ptr, shard->slot[i].size, shard->slot[i].caller);
+            }
+            shard_unlock(shard);
+        }
     }
 
     ALOGI("[EXYNOS_CAMERA_ALLOC: %s : %d] : ALIVE MEMORY BLOCKS INFO -End",
         __FUNCTION__, __LINE__);
-    m_myAllocLock.unlock();
+
+    free(snapshot);
     return 0;
 }
 
@@ -2940,142 +3084,80 @@ int print_stack() {
     return 0;
 }
 
-void * operator new(size_t size)
+static void *alloc_info_new(size_t size, void *caller)
 {
-    int cnt = 0;
-    my_node_t *node;
-
 #ifdef ALLOC_INFO_DUMP
-    ALOGV("[EXYNOS_CAMERA_ALLOC: %s++ operator overloading: %d] %d : cnt = %d",
+    ALOGV("[EXYNOS_CAMERA_ALLOC: %s++ operator overloading: %d] %zu : cnt = %d",
     __FUNCTION__, __LINE__, size, elm_size());
 #endif
 
-    android::Mutex::Autolock lock(m_AllocLock);
     void * p = malloc(size);
     if (!p) {
         ALOGE("[EXYNOS_CAMERA_ALLOC: %s : %d] Failed to allocate", __FUNCTION__, __LINE__);
     } else {
-        alloc_cnt++;
-        node = get_free_node(&free_list);
-        if (node) {
-            node->elm.ptr = p;
-            node->elm.size = size;
-            node->elm.cnt = elm_size();
-            node->next = NULL;
-            insert_node(&used_list, node);
-            used_cnt++;
-        } else {
+        alloc_cnt.fetch_add(1, std::memory_order_relaxed);
+        alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+        if (insert_node(p, size, caller) == false) {
             ALOGE("[EXYNOS_CAMERA_ALLOC: %s : %d] Failed to get node for storing the alloc info : %d  %d",
-                __FUNCTION__, __LINE__, alloc_cnt, used_cnt);
+                __FUNCTION__, __LINE__, elm_size(), lost_cnt.load(std::memory_order_relaxed));
         }
     }
 #ifdef ALLOC_INFO_DUMP
-    ALOGI("[EXYNOS_CAMERA_ALLOC: %s-- operator overloading: %d] %p : %d : cnt = %d",
+    ALOGI("[EXYNOS_CAMERA_ALLOC: %s-- operator overloading: %d] %p : %zu : cnt = %d",
     __FUNCTION__, __LINE__, p, size, elm_size());
 #endif
     return p;
 }
 
-void operator delete(void * p)
+static void alloc_info_delete(void *p)
 {
-    my_node_t *node;
+    size_t size = 0;
+
+    if (p == NULL)
+        return;
+
 #ifdef ALLOC_INFO_DUMP
     ALOGV("[EXYNOS_CAMERA_ALLOC: %s++ operator overloading: %d] %p : %d",
     __FUNCTION__, __LINE__, p, elm_size());
 #endif
 
-    android::Mutex::Autolock lock(m_AllocLock);
-    free(p);
-    alloc_cnt--;
-    node = remove_node(&used_list, p);
-    if (node) {
-        used_cnt--;
-        node->elm.ptr = NULL;
-        node->elm.size = 0;
-        node->elm.cnt = elm_size();
-        node->next = NULL;
-        insert_node(&free_list, node);
+    if (remove_node(p, &size) == true) {
+        alloc_cnt.fetch_sub(1, std::memory_order_relaxed);
+        alloc_bytes.fetch_sub(size, std::memory_order_relaxed);
     } else {
-        ALOGE("[EXYNOS_CAMERA_ALLOC: %s : %d] Seems..the pointer is invalid or already freed : [%p] : %d  %d",
-            __FUNCTION__, __LINE__, p, alloc_cnt, used_cnt);
+        /* lost_cnt > 0 : the block may be one that could not be tracked at all */
+        ALOGE("[EXYNOS_CAMERA_ALLOC: %s : %d] Seems..the pointer is invalid or already freed : [%p] : %d (lost %d)",
+            __FUNCTION__, __LINE__, p, elm_size(), lost_cnt.load(std::memory_order_relaxed));
         print_stack();
         alloc_info_print(0);
         //assert(false);
     }
+    free(p);
+
 #ifdef ALLOC_INFO_DUMP
     ALOGI("[EXYNOS_CAMERA_ALLOC : %s-- operator overloading: %d] %p : %d",
     __FUNCTION__, __LINE__, p, elm_size());
 #endif
-    return;
 }
 
-void * operator new[](size_t size)
+void * operator new(size_t size)
 {
-    int cnt = 0;
-    my_node_t *node;
+    return alloc_info_new(size, __builtin_return_address(0));
+}
 
-#ifdef ALLOC_INFO_DUMP
-    ALOGV("[EXYNOS_CAMERA_ALLOC: %s++ operator overloading: %d] %d : cnt = %d",
-    __FUNCTION__, __LINE__, size, elm_size());
-#endif
+void operator delete(void * p)
+{
+    alloc_info_delete(p);
+}
 
-    android::Mutex::Autolock lock(m_AllocLock);
-    void * p = malloc(size);
-    if (!p) {
-        ALOGE("[EXYNOS_CAMERA_ALLOC: %s : %d] Failed to allocate", __FUNCTION__, __LINE__);
-    } else {
-        alloc_cnt++;
-        node = get_free_node(&free_list);
-        if (node) {
-            node->elm.ptr = p;
-            node->elm.size = size;
-            node->elm.cnt = elm_size();
-            node->next = NULL;
-            insert_node(&used_list, node);
-            used_cnt++;
-        } else {
-            ALOGE("[EXYNOS_CAMERA_ALLOC: %s : %d] Failed to get node for storing the alloc info : %d  %d",
-                __FUNCTION__, __LINE__, alloc_cnt, used_cnt);
-        }
-    }
-#ifdef ALLOC_INFO_DUMP
-    ALOGI("[EXYNOS_CAMERA_ALLOC: %s-- operator overloading: %d] %p : %d : cnt = %d",
-    __FUNCTION__, __LINE__, p, size, elm_size());
-#endif
-    return p;
+void * operator new[](size_t size)
+{
+    return alloc_info_new(size, __builtin_return_address(0));
 }
 
 void operator delete[](void * p)
 {
-    my_node_t *node;
-#ifdef ALLOC_INFO_DUMP
-    ALOGV("[EXYNOS_CAMERA_ALLOC : %s++ operator overloading: %d] %p : %d",
-    __FUNCTION__, __LINE__, p, elm_size());
-#endif
-
-    android::Mutex::Autolock lock(m_AllocLock);
-    free(p);
-    alloc_cnt--;
-    node = remove_node(&used_list, p);
-    if (node) {
-        used_cnt--;
-        node->elm.ptr = NULL;
-        node->elm.size = 0;
-        node->elm.cnt = elm_size();
-        node->next = NULL;
-        insert_node(&free_list, node);
-    } else {
-        ALOGE("[EXYNOS_CAMERA_ALLOC: %s : %d] Seems..the pointer is invalid or already freed : [%p] : %d  %d",
-            __FUNCTION__, __LINE__, p, alloc_cnt, used_cnt);
-        print_stack();
-        alloc_info_print(0);
-        //assert(false);
-    }
-#ifdef ALLOC_INFO_DUMP
-    ALOGI("[EXYNOS_CAMERA_ALLOC: %s-- operator overloading: %d] %p : %d",
-    __FUNCTION__, __LINE__, p, elm_size());
-#endif
-    return;
+    alloc_info_delete(p);
 }
 
 #endif
@@ -366,6 +366,37 @@ void* operator new(std::size_t);
 void  operator delete(void*);
 void* operator new[](std::size_t);
 void  operator delete[](void*);
+
+#define ALLOC_INFO_SIZE_CLASS_MAX   (24)
+#define ALLOC_INFO_CALLSITE_MAX     (64)
+
+typedef struct alloc_info_size_class {
+    size_t count;
+    size_t bytes;
+} alloc_info_size_class_t;
+
+typedef struct alloc_info_callsite {
+    void  *caller;
+    size_t count;
+    size_t bytes;
+} alloc_info_callsite_t;
+
+typedef struct alloc_info_snapshot {
+    size_t live_cnt;
+    size_t live_bytes;
+    /* blocks which are tracked in the overflow shard because their shard was full */
+    int    dropped_cnt;
+    /* blocks which could not be tracked because the overflow shard was full too */
+    int    lost_cnt;
+    /* size_class[i] : blocks of [2^i, 2^(i+1)) bytes, the last class is open-ended */
+    alloc_info_size_class_t size_class[ALLOC_INFO_SIZE_CLASS_MAX];
+    int    callsite_cnt;
+    alloc_info_callsite_t callsite[ALLOC_INFO_CALLSITE_MAX];
+    /* blocks whose caller did not fit in callsite[] */
+    size_t callsite_overflow_cnt;
+} alloc_info_snapshot_t;
+
+int alloc_info_snapshot(alloc_info_snapshot_t *snapshot);
 int alloc_info_print(int flag = 0);
 #endif
 
@@ -133,6 +133,9 @@ typedef struct ExynosCameraPipeInfo {
     /* The yuvPixelSize is used to distinguish pixel size of YUV format */
     camera_pixel_size pixelSize;
 
+    /* SW pipe only : run on the shared ExynosCameraTaskExecutor, not on an own thread */
+    bool useTaskExecutor;
+
     ExynosCameraPipeInfo()
     {
         memset(&bufInfo, 0, sizeof(v4l2_requestbuffers));
@@ -141,6 +144,7 @@ typedef struct ExynosCameraPipeInfo {
             bytesPerPlane[i] = 0;
 
         pixelSize = CAMERA_PIXEL_SIZE_8BIT;
+        useTaskExecutor = false;
     }
 
     ExynosCameraPipeInfo& operator =(const ExynosCameraPipeInfo &other)
@@ -153,6 +157,7 @@ typedef struct ExynosCameraPipeInfo {
             bytesPerPlane[i] = other.bytesPerPlane[i];
 
         pixelSize = other.pixelSize;
+        useTaskExecutor = other.useTaskExecutor;
 
         return *this;
     }
@@ -120,7 +120,7 @@ status_t ExynosCameraPipeGMV::stop(void)
         return INVALID_OPERATION;
     }
 
-    stopThreadAndInputQ(m_mainThread, 1, m_inputFrameQ);
+    m_stopThreadAndInputQ();
     CLOGD("thead exited");
 
 #ifdef DUMP_GMV_INPUT
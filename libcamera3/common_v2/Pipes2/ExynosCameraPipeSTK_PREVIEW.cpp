@@ -57,12 +57,10 @@ status_t ExynosCameraPipeSTK_PREVIEW::stop(void)
     CLOGV("");
     int ret = 0;
 
-    m_mainThread->requestExitAndWait();
+    m_stopThreadAndInputQ();
 
     CLOGD(" thead exited");
 
-    m_inputFrameQ->release();
-
     if (bSTKInit == false) {
         return NO_ERROR;
     }
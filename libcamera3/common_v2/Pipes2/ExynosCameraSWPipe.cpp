@@ -38,6 +38,50 @@ status_t ExynosCameraSWPipe::create(__unused int32_t *sensorIds)
 
 }
 
+status_t ExynosCameraSWPipe::setupPipe(camera_pipe_info_t *pipeInfos, __unused int32_t *sensorIds)
+{
+    bool useTaskExecutor;
+
+    if (pipeInfos == NULL) {
+        CLOGE("pipeInfos is NULL");
+        return BAD_VALUE;
+    }
+
+    useTaskExecutor = pipeInfos[0].useTaskExecutor;
+    if (useTaskExecutor == m_useTaskExecutor)
+        return NO_ERROR;
+
+    if (m_inputFrameQ == NULL) {
+        CLOGE("inputFrameQ is NULL, create() first");
+        return INVALID_OPERATION;
+    }
+
+    if (isThreadRunning() == true) {
+        CLOGE("Can not change useTaskExecutor(%d) while running", useTaskExecutor);
+        return INVALID_OPERATION;
+    }
+
+    if (useTaskExecutor == true) {
+#ifdef USE_SW_PIPE_TASK_EXECUTOR
+        m_taskExecutor = ExynosCameraTaskExecutor::getInstance();
+        m_inputFrameQ->setup(NULL);
+        m_inputFrameQ->setListener(this);
+#else
+        CLOGE("The task executor is not built in, BOARD_CAMERA_USES_SW_PIPE_TASK_EXECUTOR is not set");
+        return INVALID_OPERATION;
+#endif
+    } else {
+        m_inputFrameQ->setListener(NULL);
+        m_inputFrameQ->setup(m_mainThread);
+    }
+
+    m_useTaskExecutor = useTaskExecutor;
+
+    CLOGI("setupPipe() is succeed (%d) useTaskExecutor(%d)", getPipeId(), m_useTaskExecutor);
+
+    return NO_ERROR;
+}
+
 status_t ExynosCameraSWPipe::start(void)
 {
     CLOGD("");
@@ -53,7 +97,7 @@ status_t ExynosCameraSWPipe::stop(void)
 
     m_flagTryStop = true;
 
-    stopThreadAndInputQ(m_mainThread, 1, m_inputFrameQ);
+    m_stopThreadAndInputQ();
 
     CLOGD("thead exited");
 
@@ -73,6 +117,16 @@ status_t ExynosCameraSWPipe::startThread(void)
 
     m_flagTryStop = false;
 
+    if (m_useTaskExecutor == true) {
+        Mutex::Autolock lock(m_taskLock);
+        status_t ret = m_startTask();
+        if (ret != NO_ERROR)
+            return ret;
+
+        CLOGI("startThread is succeed (%d) on the task executor", getPipeId());
+        return NO_ERROR;
+    }
+
     m_mainThread->run(m_name);
 
     CLOGI("startThread is succeed (%d)", getPipeId());
@@ -84,14 +138,140 @@ status_t ExynosCameraSWPipe::stopThread(void)
 {
     m_flagTryStop = true;
 
-    m_mainThread->requestExit();
-    m_inputFrameQ->sendCmd(WAKE_UP);
+    if (m_useTaskExecutor == true) {
+        m_stopTask();
+    } else {
+        m_mainThread->requestExit();
+        m_inputFrameQ->sendCmd(WAKE_UP);
+    }
 
     m_dumpRunningFrameList();
 
     return NO_ERROR;
 }
 
+bool ExynosCameraSWPipe::isThreadRunning(void)
+{
+    if (m_useTaskExecutor == true) {
+        Mutex::Autolock lock(m_taskLock);
+        return m_flagTaskStarted;
+    }
+
+    return ExynosCameraPipe::isThreadRunning();
+}
+
+void ExynosCameraSWPipe::dump(void)
+{
+    ExynosCameraPipe::dump();
+
+    if (m_useTaskExecutor == false)
+        return;
+
+    m_taskLock.lock();
+    CLOGI("task started(%d) queued(%d) pending(%zu) run(%u)"
+          " queue avg(%lld) max(%lld) us, run avg(%lld) max(%lld) us",
+            m_flagTaskStarted, m_flagTaskQueued, m_taskKeyList.size(), m_taskStat.numOfRun,
+            (long long)(m_taskStat.numOfRun ? m_taskStat.queueSum / m_taskStat.numOfRun / 1000 : 0),
+            (long long)(m_taskStat.queueMax / 1000),
+            (long long)(m_taskStat.numOfRun ? m_taskStat.runSum / m_taskStat.numOfRun / 1000 : 0),
+            (long long)(m_taskStat.runMax / 1000));
+    m_taskLock.unlock();
+
+#ifdef USE_SW_PIPE_TASK_EXECUTOR
+    m_taskExecutor->dump();
+#endif
+}
+
+void ExynosCameraSWPipe::onPushProcessQ(ExynosCameraFrameSP_sptr_t *frame)
+{
+    Mutex::Autolock lock(m_taskLock);
+    sw_pipe_task_key_t key;
+    uint32_t frameType;
+    int64_t timestamp;
+
+    key.pushTime = systemTime(SYSTEM_TIME_MONOTONIC);
+    key.priority = (m_isReprocessing() == true) ? TASK_PRIORITY_CAPTURE : TASK_PRIORITY_PREVIEW;
+    key.timestamp = key.pushTime;
+
+    if (frame != NULL && *frame != NULL) {
+        frameType = (*frame)->getFrameType();
+        switch (frameType) {
+        case FRAME_TYPE_REPROCESSING:
+        case FRAME_TYPE_JPEG_REPROCESSING:
+        case FRAME_TYPE_REPROCESSING_SLAVE:
+        case FRAME_TYPE_REPROCESSING_DUAL_MASTER:
+        case FRAME_TYPE_REPROCESSING_DUAL_SLAVE:
+            key.priority = TASK_PRIORITY_CAPTURE;
+            break;
+        default:
+            break;
+        }
+
+        /* the older frame first, by the sensor time */
+        timestamp = (*frame)->getTimeStamp();
+        if (timestamp > 0)
+            key.timestamp = timestamp;
+    }
+
+    m_taskKeyList.push_back(key);
+
+    /* as the thread does, the first push starts the pipe */
+    if (m_flagTaskStarted == false) {
+        m_startTask();
+        return;
+    }
+
+    m_submitTask();
+}
+
+void ExynosCameraSWPipe::runTask(void)
+{
+    status_t ret = NO_ERROR;
+    sw_pipe_task_key_t key;
+    nsecs_t startTime, runTime, queueTime;
+
+    startTime = systemTime(SYSTEM_TIME_MONOTONIC);
+
+    /* stopping : the frame and its key wait for the next start */
+    if (m_flagTryStop == true) {
+        Mutex::Autolock lock(m_taskLock);
+        m_flagTaskQueued = false;
+        return;
+    }
+
+    /* the queue may have been released under the key */
+    if (m_inputFrameQ->getSizeOfProcessQ() > 0) {
+        ret = m_run();
+        if (ret != NO_ERROR) {
+            if (ret != TIMED_OUT) {
+                CLOGE("Failed to run()");
+            }
+        }
+    }
+
+    runTime = systemTime(SYSTEM_TIME_MONOTONIC) - startTime;
+
+    Mutex::Autolock lock(m_taskLock);
+
+    if (m_taskKeyList.empty() == false) {
+        key = *m_taskKeyList.begin();
+        m_taskKeyList.erase(m_taskKeyList.begin());
+
+        queueTime = startTime - key.pushTime;
+
+        m_taskStat.numOfRun++;
+        m_taskStat.queueSum += queueTime;
+        m_taskStat.runSum += runTime;
+        if (m_taskStat.queueMax < queueTime)
+            m_taskStat.queueMax = queueTime;
+        if (m_taskStat.runMax < runTime)
+            m_taskStat.runMax = runTime;
+    }
+
+    m_flagTaskQueued = false;
+    m_submitTask();
+}
+
 bool ExynosCameraSWPipe::m_mainThreadFunc(void)
 {
     status_t ret = NO_ERROR;
@@ -108,6 +288,9 @@ bool ExynosCameraSWPipe::m_mainThreadFunc(void)
 
 status_t ExynosCameraSWPipe::m_destroy(void)
 {
+    if (m_useTaskExecutor == true)
+        m_stopTask();
+
     if (m_inputFrameQ != NULL) {
         m_inputFrameQ->release();
         delete m_inputFrameQ;
@@ -119,5 +302,99 @@ status_t ExynosCameraSWPipe::m_destroy(void)
     return NO_ERROR;
 }
 
+/* stops the thread or the tasks, and releases the input queue */
+void ExynosCameraSWPipe::m_stopThreadAndInputQ(void)
+{
+    if (m_useTaskExecutor == false) {
+        stopThreadAndInputQ(m_mainThread, 1, m_inputFrameQ);
+        return;
+    }
+
+    m_stopTask();
+    m_inputFrameQ->release();
+
+    m_taskLock.lock();
+    m_taskKeyList.clear();
+    m_taskLock.unlock();
+}
+
+void ExynosCameraSWPipe::m_initTask(void)
+{
+    m_useTaskExecutor = false;
+    m_taskExecutor = NULL;
+    m_flagTaskStarted = false;
+    m_flagTaskQueued = false;
+    memset(&m_taskStat, 0x00, sizeof(m_taskStat));
+}
+
+/* called with m_taskLock held */
+status_t ExynosCameraSWPipe::m_startTask(void)
+{
+    status_t ret;
+
+    if (m_flagTaskStarted == true)
+        return NO_ERROR;
+
+#ifdef USE_SW_PIPE_TASK_EXECUTOR
+    ret = m_taskExecutor->attach();
+#else
+    ret = INVALID_OPERATION;
+#endif
+    if (ret != NO_ERROR) {
+        CLOGE("Failed to attach to the task executor, ret(%d)", ret);
+        return ret;
+    }
+
+    m_flagTaskStarted = true;
+
+    /* frames pushed before the start */
+    m_submitTask();
+
+    return NO_ERROR;
+}
+
+/* called with m_taskLock held : keeps one task of the pipe queued or running */
+void ExynosCameraSWPipe::m_submitTask(void)
+{
+    if (m_flagTaskStarted == false || m_flagTaskQueued == true
+        || m_flagTryStop == true || m_taskKeyList.empty() == true)
+        return;
+
+#ifdef USE_SW_PIPE_TASK_EXECUTOR
+    sw_pipe_task_key_t *key = &(*m_taskKeyList.begin());
+    if (m_taskExecutor->submit(this, key->priority, key->timestamp) != NO_ERROR) {
+        CLOGE("Failed to submit the task");
+        return;
+    }
+
+    m_flagTaskQueued = true;
+#endif
+}
+
+void ExynosCameraSWPipe::m_stopTask(void)
+{
+    m_taskLock.lock();
+    if (m_flagTaskStarted == false) {
+        m_taskLock.unlock();
+        return;
+    }
+    m_flagTaskStarted = false;
+    m_taskLock.unlock();
+
+#ifdef USE_SW_PIPE_TASK_EXECUTOR
+    /* not with m_taskLock held, the running task takes it at the end */
+    m_taskExecutor->cancel(this);
+#endif
+
+    m_taskLock.lock();
+    if (m_flagTaskStarted == false)
+        m_flagTaskQueued = false;
+    m_taskLock.unlock();
+
+#ifdef USE_SW_PIPE_TASK_EXECUTOR
+    m_taskExecutor->detach();
+#endif
+}
+
 }; /* namespace android */
 
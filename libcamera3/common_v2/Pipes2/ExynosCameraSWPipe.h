@@ -19,14 +19,37 @@
 #define EXYNOS_CAMERA_SW_PIPE_H
 
 #include "ExynosCameraPipe.h"
+#include "ExynosCameraTaskExecutor.h"
 
 namespace android {
 
-class ExynosCameraSWPipe : public ExynosCameraPipe {
+typedef struct sw_pipe_task_key {
+    int     priority;
+    int64_t timestamp;
+    nsecs_t pushTime;
+} sw_pipe_task_key_t;
+
+typedef struct sw_pipe_task_stat {
+    uint32_t    numOfRun;
+    nsecs_t     queueSum;   /* push to run */
+    nsecs_t     queueMax;
+    nsecs_t     runSum;
+    nsecs_t     runMax;
+} sw_pipe_task_stat_t;
+
+/*
+ * A SW pipe runs m_run() on its own thread, or, when setupPipe() sets
+ * useTaskExecutor, as tasks of the shared ExynosCameraTaskExecutor: every
+ * frame pushed to the input queue makes one m_run() task, and the tasks of
+ * a pipe run one at a time in push order.
+ */
+class ExynosCameraSWPipe : public ExynosCameraPipe,
+                           public ExynosCameraListListener<ExynosCameraFrameSP_sptr_t>,
+                           public ExynosCameraTaskRunnable {
 public:
     ExynosCameraSWPipe()
     {
-    /* NOP */
+        m_initTask();
     }
 
     ExynosCameraSWPipe(
@@ -36,7 +59,7 @@ public:
         bool isReprocessing,
         int32_t *nodeNums) : ExynosCameraPipe(cameraId, configurations, obj_param, isReprocessing, nodeNums)
     {
-    /* NOP */
+        m_initTask();
     }
 
     virtual status_t destroy(void)
@@ -45,15 +68,41 @@ public:
     }
 
     virtual status_t        create(int32_t *sensorIds = NULL);
+    /* only pipeInfos[0].useTaskExecutor is used, before startThread() */
+    virtual status_t        setupPipe(camera_pipe_info_t *pipeInfos, int32_t *sensorIds = NULL);
     virtual status_t        start(void);
     virtual status_t        stop(void);
     virtual status_t        startThread(void);
     virtual status_t        stopThread(void);
+    virtual bool            isThreadRunning(void);
+
+    virtual void            dump(void);
+
+    virtual void            onPushProcessQ(ExynosCameraFrameSP_sptr_t *frame);
+    virtual void            runTask(void);
 
 protected:
     virtual bool            m_mainThreadFunc(void);
     virtual status_t        m_destroy(void);
     virtual status_t        m_run(void) = 0;
+    void                    m_stopThreadAndInputQ(void);
+
+private:
+    void                    m_initTask(void);
+    status_t                m_startTask(void);
+    void                    m_submitTask(void);
+    void                    m_stopTask(void);
+
+private:
+    bool                        m_useTaskExecutor;
+    ExynosCameraTaskExecutor    *m_taskExecutor;
+    /* guards the members below */
+    Mutex                       m_taskLock;
+    bool                        m_flagTaskStarted;
+    bool                        m_flagTaskQueued;
+    /* a key per pushed frame, the front one is queued or running */
+    List<sw_pipe_task_key_t>    m_taskKeyList;
+    sw_pipe_task_stat_t         m_taskStat;
 };
 
 }; /* namespace android */
@@ -0,0 +1,91 @@
+# Copyright 2017 The Android Open Source Project
+
+LOCAL_PATH := $(call my-dir)
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := ExynosCameraListBench.cpp
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE := exynoscamera_list_bench
+LOCAL_MODULE_TAGS := optional
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES += \
+    $(TOP)/hardware/samsung_slsi-linaro/exynos/libcamera3/common_v2
+
+LOCAL_CFLAGS := -Wno-unused-parameter
+
+include $(TOP)/hardware/samsung_slsi-linaro/exynos/BoardConfigCFlags.mk
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := ExynosCameraRequestRingBench.cpp
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE := exynoscamera_request_ring_bench
+LOCAL_MODULE_TAGS := optional
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES += \
+    $(TOP)/hardware/samsung_slsi-linaro/exynos/libcamera3/common_v2
+
+LOCAL_CFLAGS := -Wno-unused-parameter
+
+include $(TOP)/hardware/samsung_slsi-linaro/exynos/BoardConfigCFlags.mk
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := ExynosCameraTraceRingBench.cpp
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE := exynoscamera_trace_ring_bench
+LOCAL_MODULE_TAGS := optional
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES += \
+    $(TOP)/hardware/samsung_slsi-linaro/exynos/libcamera3/common_v2
+
+LOCAL_CFLAGS := -Wno-unused-parameter
+
+include $(TOP)/hardware/samsung_slsi-linaro/exynos/BoardConfigCFlags.mk
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+    ExynosCameraBayerStackerBench.cpp \
+    ../ExynosCameraBayerStacker.cpp
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE := exynoscamera_bayer_stacker_bench
+LOCAL_MODULE_TAGS := optional
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES += \
+    $(TOP)/hardware/samsung_slsi-linaro/exynos/libcamera3/common_v2
+
+LOCAL_CFLAGS := -Wno-unused-parameter
+
+include $(TOP)/hardware/samsung_slsi-linaro/exynos/BoardConfigCFlags.mk
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+    ExynosCameraTaskExecutorBench.cpp \
+    ../ExynosCameraTaskExecutor.cpp
+LOCAL_SHARED_LIBRARIES := libutils libcutils liblog
+
+LOCAL_MODULE := exynoscamera_task_executor_bench
+LOCAL_MODULE_TAGS := optional
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES += \
+    $(TOP)/hardware/samsung_slsi-linaro/exynos/libcamera3/common_v2
+
+LOCAL_CFLAGS := -Wno-unused-parameter
+
+include $(TOP)/hardware/samsung_slsi-linaro/exynos/BoardConfigCFlags.mk
+include $(BUILD_EXECUTABLE)
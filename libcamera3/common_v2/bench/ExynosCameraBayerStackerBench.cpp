@@ -0,0 +1,336 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Long exposure stacking, pairwise addBayerBuffer() vs ExynosCameraBayerStacker.
+ * The pairwise loops are the scalar forms of addBayerBufferByCpu() and of
+ * addBayerBufferByNeonPacked(): they add one frame into the other, and the
+ * packed one unpacks both frames and repacks the result on every add.
+ * The stacker adds every frame into its 32 bit accumulator and writes the
+ * output once, one frame per call (as frames come from the sensor) or all
+ * frames in one stack() call.
+ * Every stacker output is checked against a per pixel reference that reads
+ * the samples straight from the bit stream of the input frames; the exit
+ * status is the number of failed runs.
+ *
+ * usage : exynoscamera_bayer_stacker_bench [frames] [width] [height]
+ */
+
+#define LOG_TAG "ExynosCameraBayerStackerBench"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+#include <log/log.h>
+
+#include "ExynosCameraBayerStacker.h"
+
+#define BENCH_DEFAULT_FRAMES    (8)
+#define BENCH_DEFAULT_WIDTH     (4032)
+#define BENCH_DEFAULT_HEIGHT    (3024)
+#define BENCH_OUTPUT_BITS       (10)
+#define BENCH_BLACK_LEVEL       (64)
+
+#define SATURATING_ADD(a, b)  (((a) > (0x3FF - (b))) ? 0x3FF : ((a) + (b)))
+#define COMBINE_P0(a, b) ((((a)&0x00FF)|((b<<8)&0x0F00)))
+#define COMBINE_P1(a, b) ((((a>>4)&0x000F)|((b<<4)&0x0FF0)))
+#define COMBINE_P3(a, b) ((((a>>8)&0x000F)|((b<<4)&0x00F0)))
+
+static int64_t getNowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void pairwiseAdd16(const uint16_t *src, uint16_t *dst, size_t numOfPixel)
+{
+    for (size_t i = 0; i < numOfPixel; i++)
+        dst[i] = SATURATING_ADD(dst[i], src[i]);
+}
+
+static void pairwiseAddPacked12(const uint8_t *src, uint8_t *dst, int width, int height, int stride)
+{
+    for (int row = 0; row < height; row++) {
+        const uint8_t *s = src + (size_t)stride * row;
+        uint8_t *d = dst + (size_t)stride * row;
+
+        for (int col = 0; col + 3 <= width * 3 / 2; col += 3) {
+            uint16_t d0 = COMBINE_P0(d[col], d[col + 1]);
+            uint16_t d1 = COMBINE_P1(d[col + 1], d[col + 2]);
+            uint16_t s0 = COMBINE_P0(s[col], s[col + 1]);
+            uint16_t s1 = COMBINE_P1(s[col + 1], s[col + 2]);
+
+            d0 = SATURATING_ADD(d0, s0);
+            d1 = SATURATING_ADD(d1, s1);
+
+            d[col] = (uint8_t)d0;
+            d[col + 1] = (uint8_t)COMBINE_P3(d0, d1);
+            d[col + 2] = (uint8_t)(d1 >> 4);
+        }
+    }
+}
+
+static void fillFrames(std::vector<std::vector<uint8_t> > *frames, size_t size)
+{
+    uint32_t seed = 1;
+
+    for (auto &frame : *frames) {
+        frame.resize(size);
+        for (size_t i = 0; i < size; i++) {
+            seed = seed * 1103515245 + 12345;
+            frame[i] = (uint8_t)(seed >> 16);
+        }
+    }
+}
+
+/* a packed group is a little endian bit stream : pixel k is bits [k * bits, (k + 1) * bits) */
+static uint32_t getPixel(const uint8_t *frame, bayer_stack_format_t format, int stride, int x, int y)
+{
+    const uint8_t *line = frame + (size_t)stride * y;
+    int bits, pixelsPerGroup, bytesPerGroup;
+    uint64_t group = 0;
+
+    if (format == BAYER_STACK_FORMAT_UNPACKED16)
+        return line[x * 2] | (line[x * 2 + 1] << 8);
+
+    bits = (format == BAYER_STACK_FORMAT_PACKED10) ? 10 : 12;
+    pixelsPerGroup = (format == BAYER_STACK_FORMAT_PACKED10) ? 4 : 2;
+    bytesPerGroup = pixelsPerGroup * bits / 8;
+
+    for (int i = bytesPerGroup - 1; i >= 0; i--)
+        group = (group << 8) | line[x / pixelsPerGroup * bytesPerGroup + i];
+
+    return (uint32_t)(group >> ((x % pixelsPerGroup) * bits)) & ((1U << bits) - 1);
+}
+
+static int getWeight(int index)
+{
+    return BAYER_STACK_WEIGHT_ONE / 2 * (1 + index % 4);
+}
+
+/* the expected output, one pixel at a time */
+static void makeReference(const std::vector<std::vector<uint8_t> > &frames,
+                          bayer_stack_format_t format, bayer_stack_mode_t mode,
+                          int width, int height, int stride, std::vector<uint16_t> *ref)
+{
+    uint32_t maxValue = (1U << BENCH_OUTPUT_BITS) - 1;
+    uint32_t numOfFrame = frames.size();
+
+    ref->resize((size_t)width * height);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint64_t sum = 0, weighted = 0, weightSum = 0;
+            uint32_t minSample = UINT32_MAX, maxSample = 0, sample, value;
+
+            for (uint32_t i = 0; i < numOfFrame; i++) {
+                sample = getPixel(frames[i].data(), format, stride, x, y);
+                sample = (sample > BENCH_BLACK_LEVEL) ? sample - BENCH_BLACK_LEVEL : 0;
+
+                sum += sample;
+                weighted += (uint64_t)sample * getWeight(i);
+                weightSum += getWeight(i);
+                if (sample < minSample)
+                    minSample = sample;
+                if (sample > maxSample)
+                    maxSample = sample;
+            }
+
+            switch (mode) {
+            case BAYER_STACK_MODE_WEIGHTED_MEAN:
+                value = (uint32_t)((weighted + weightSum / 2) / weightSum);
+                break;
+            case BAYER_STACK_MODE_CLIPPED_MEAN:
+                if (numOfFrame >= 3)
+                    value = (uint32_t)((sum - minSample - maxSample + (numOfFrame - 2) / 2) / (numOfFrame - 2));
+                else
+                    value = (uint32_t)((sum + numOfFrame / 2) / numOfFrame);
+                break;
+            case BAYER_STACK_MODE_SUM:
+            default:
+                value = (uint32_t)sum;
+                break;
+            }
+
+            value += BENCH_BLACK_LEVEL;
+            (*ref)[(size_t)width * y + x] = (value > maxValue) ? maxValue : value;
+        }
+    }
+}
+
+static bool checkOutput(const char *name, const uint8_t *out, bayer_stack_format_t format,
+                        int width, int height, int stride, const std::vector<uint16_t> &ref)
+{
+    int numOfMismatch = 0, firstX = 0, firstY = 0;
+    uint32_t value, firstValue = 0;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            value = getPixel(out, format, stride, x, y);
+            if (value == ref[(size_t)width * y + x])
+                continue;
+
+            if (numOfMismatch == 0) {
+                firstX = x;
+                firstY = y;
+                firstValue = value;
+            }
+            numOfMismatch++;
+        }
+    }
+
+    if (numOfMismatch == 0)
+        return true;
+
+    printf("  %-32s FAIL : %d pixels differ, first (%d, %d) = %u, expected %u\n",
+           name, numOfMismatch, firstX, firstY, firstValue, ref[(size_t)width * firstY + firstX]);
+
+    return false;
+}
+
+static void runPairwise(const char *name, bayer_stack_format_t format,
+                        int numOfFrame, int width, int height)
+{
+    int stride = ExynosCameraBayerStacker::getMinStride(width, format);
+    std::vector<std::vector<uint8_t> > frames(numOfFrame);
+    int64_t start, end;
+
+    fillFrames(&frames, (size_t)stride * height);
+
+    start = getNowNs();
+    for (int i = 1; i < numOfFrame; i++) {
+        if (format == BAYER_STACK_FORMAT_UNPACKED16)
+            pairwiseAdd16((uint16_t *)frames[i].data(), (uint16_t *)frames[0].data(),
+                          (size_t)stride / 2 * height);
+        else
+            pairwiseAddPacked12(frames[i].data(), frames[0].data(), width, height, stride);
+    }
+    end = getNowNs();
+
+    printf("  %-32s %8.2f ms\n", name, (double)(end - start) / 1000000.0);
+}
+
+/* the output goes to the first frame, as the pairwise add does */
+static bool runStacker(const char *name, bayer_stack_format_t format, bayer_stack_mode_t mode,
+                       int numOfThread, bool batch, int numOfFrame, int width, int height)
+{
+    /* the frames are the same on every run, so is the reference of a format and a mode */
+    static std::vector<uint16_t> refs[BAYER_STACK_FORMAT_MAX][BAYER_STACK_MODE_MAX];
+    std::vector<uint16_t> &ref = refs[format][mode];
+    ExynosCameraBayerStacker stacker;
+    int stride = ExynosCameraBayerStacker::getMinStride(width, format);
+    std::vector<std::vector<uint8_t> > frames(numOfFrame);
+    std::vector<const void *> srcs(numOfFrame);
+    std::vector<int> weights(numOfFrame);
+    status_t ret = NO_ERROR;
+    int64_t start, end;
+
+    fillFrames(&frames, (size_t)stride * height);
+    for (int i = 0; i < numOfFrame; i++) {
+        srcs[i] = frames[i].data();
+        weights[i] = getWeight(i);
+    }
+
+    if (ref.empty() == true)
+        makeReference(frames, format, mode, width, height, stride, &ref);
+
+    if (stacker.init(width, height, stride, format, mode,
+                     BENCH_OUTPUT_BITS, BENCH_BLACK_LEVEL, numOfThread) != NO_ERROR) {
+        printf("  %-32s init fail\n", name);
+        return false;
+    }
+
+    start = getNowNs();
+    if (batch == true) {
+        ret = stacker.stack(srcs.data(), weights.data(), numOfFrame, frames[0].data());
+    } else {
+        for (int i = 0; i < numOfFrame && ret == NO_ERROR; i++)
+            ret = stacker.addFrame(srcs[i], weights[i]);
+        if (ret == NO_ERROR)
+            ret = stacker.finalize(frames[0].data());
+    }
+    end = getNowNs();
+
+    if (ret != NO_ERROR) {
+        printf("  %-32s stack fail, ret(%d)\n", name, ret);
+        return false;
+    }
+
+    printf("  %-32s %8.2f ms\n", name, (double)(end - start) / 1000000.0);
+
+    return checkOutput(name, frames[0].data(), format, width, height, stride, ref);
+}
+
+int main(int argc, char *argv[])
+{
+    int numOfFrame = BENCH_DEFAULT_FRAMES;
+    int width = BENCH_DEFAULT_WIDTH;
+    int height = BENCH_DEFAULT_HEIGHT;
+    char name[64];
+    int numOfFail = 0;
+
+    if (argc > 1)
+        numOfFrame = atoi(argv[1]);
+    if (argc > 2)
+        width = atoi(argv[2]);
+    if (argc > 3)
+        height = atoi(argv[3]);
+
+    if (numOfFrame < 2 || width <= 0 || height <= 0) {
+        printf("usage : %s [frames] [width] [height]\n", argv[0]);
+        return -1;
+    }
+
+    printf("Bayer stacking : %d frames of %dx%d\n", numOfFrame, width, height);
+
+    runPairwise("pairwise unpacked16", BAYER_STACK_FORMAT_UNPACKED16, numOfFrame, width, height);
+    runPairwise("pairwise packed12", BAYER_STACK_FORMAT_PACKED12, numOfFrame, width, height);
+
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        for (int batch = 0; batch <= 1; batch++) {
+            const char *type = (batch == 1) ? "stack" : "add";
+
+            snprintf(name, sizeof(name), "%s unpacked16 sum x%d", type, threads);
+            if (runStacker(name, BAYER_STACK_FORMAT_UNPACKED16, BAYER_STACK_MODE_SUM,
+                           threads, batch, numOfFrame, width, height) == false)
+                numOfFail++;
+            snprintf(name, sizeof(name), "%s packed12 sum x%d", type, threads);
+            if (runStacker(name, BAYER_STACK_FORMAT_PACKED12, BAYER_STACK_MODE_SUM,
+                           threads, batch, numOfFrame, width, height) == false)
+                numOfFail++;
+            snprintf(name, sizeof(name), "%s packed12 clipped x%d", type, threads);
+            if (runStacker(name, BAYER_STACK_FORMAT_PACKED12, BAYER_STACK_MODE_CLIPPED_MEAN,
+                           threads, batch, numOfFrame, width, height) == false)
+                numOfFail++;
+            snprintf(name, sizeof(name), "%s packed10 weighted x%d", type, threads);
+            if (runStacker(name, BAYER_STACK_FORMAT_PACKED10, BAYER_STACK_MODE_WEIGHTED_MEAN,
+                           threads, batch, numOfFrame, width, height) == false)
+                numOfFail++;
+        }
+    }
+
+    if (numOfFail > 0)
+        printf("%d runs differ from the reference\n", numOfFail);
+
+    return numOfFail;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed toggle an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Throughput and latency of ExynosCameraList, list vs ring backend.
+ * 2..8 producer threads stand for the pipe threads pushing done frames,
+ * one consumer drains the queue with waitAndPopProcessQ().
+ *
+ * usage : exynoscamera_list_bench [items per producer]
+ */
+
+#define LOG_TAG "ExynosCameraListBench"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <log/log.h>
+
+#include "ExynosCameraList.h"
+
+#define BENCH_DEFAULT_ITEMS     (200000)
+#define BENCH_MIN_PRODUCERS     (2)
+#define BENCH_MAX_PRODUCERS     (8)
+
+static int64_t getNowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void runBench(bool ring, int numProducers, int numItems)
+{
+    ExynosCameraList<int64_t> queue;
+    std::vector<std::thread> producers;
+    std::vector<int64_t> latency;
+    int total = numProducers * numItems;
+    int64_t start, end, item;
+
+    if (ring == true)
+        queue.setRingMode();
+
+    /* 1 sec, producers never pause that long */
+    queue.setWaitTime(1000000000);
+    latency.reserve(total);
+
+    start = getNowNs();
+
+    for (int i = 0; i < numProducers; i++) {
+        producers.emplace_back([&queue, numItems]() {
+            for (int j = 0; j < numItems; j++) {
+                int64_t now = getNowNs();
+                queue.pushProcessQ(&now);
+            }
+        });
+    }
+
+    while ((int)latency.size() < total) {
+        if (queue.waitAndPopProcessQ(&item) != NO_ERROR) {
+            printf("  pop failed after %zu items\n", latency.size());
+            break;
+        }
+
+        latency.push_back(getNowNs() - item);
+    }
+
+    end = getNowNs();
+
+    for (auto &producer : producers)
+        producer.join();
+
+    if (latency.empty())
+        return;
+
+    std::sort(latency.begin(), latency.end());
+
+    printf("  %-4s producers %d : %8.2f Mitems/s, p50 %7.2f us, p99 %8.2f us\n",
+            ring ? "ring" : "list", numProducers,
+            (double)latency.size() * 1000.0 / (double)(end - start),
+            (double)latency[latency.size() / 2] / 1000.0,
+            (double)latency[latency.size() * 99 / 100] / 1000.0);
+}
+
+int main(int argc, char *argv[])
+{
+    int numItems = BENCH_DEFAULT_ITEMS;
+
+    if (argc > 1)
+        numItems = atoi(argv[1]);
+
+    if (numItems <= 0) {
+        printf("usage : %s [items per producer]\n", argv[0]);
+        return -1;
+    }
+
+    printf("ExynosCameraList : %d items per producer\n", numItems);
+
+    for (int producers = BENCH_MIN_PRODUCERS; producers <= BENCH_MAX_PRODUCERS; producers *= 2) {
+        runBench(false, producers, numItems);
+        runBench(true, producers, numItems);
+    }
+
+    return 0;
+}
@@ -0,0 +1,250 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed toggle an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Request bookkeeping of ExynosCameraRequestManager, map vs ring.
+ * One thread stands for processCaptureRequest: it registers the request
+ * key and its frameCount, keeping the pipeline depth in flight, and
+ * removes the oldest one. 1..4 pipe threads look requests up through the
+ * frameCount, the way getRunningRequest() does several times per frame.
+ *
+ * usage : exynoscamera_request_ring_bench [frames] [pipeline depth]
+ */
+
+#define LOG_TAG "ExynosCameraRequestRingBench"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include <log/log.h>
+#include <utils/Mutex.h>
+#include <utils/RefBase.h>
+
+#include "ExynosCameraRequestRing.h"
+
+#define BENCH_DEFAULT_FRAMES    (200000)
+#define BENCH_DEFAULT_DEPTH     (8)
+#define BENCH_MAX_READERS       (4)
+/* the first frameCount differs from the request key, as in the HAL */
+#define BENCH_FRAME_COUNT_BASE  (1000)
+
+class BenchRequest : public RefBase {
+public:
+    BenchRequest(uint32_t key) : m_key(key) {}
+    uint32_t getKey(void) { return m_key; }
+
+private:
+    uint32_t m_key;
+};
+
+typedef sp<BenchRequest> BenchRequestSP;
+
+/* the bookkeeping before the ring, both maps under their own lock */
+class MapBook {
+public:
+    void add(uint32_t key, uint32_t frameCount, BenchRequestSP request)
+    {
+        m_requestLock.lock();
+        m_requests.insert(std::pair<uint32_t, BenchRequestSP>(key, request));
+        m_requestLock.unlock();
+
+        m_frameCountLock.lock();
+        m_frameCounts.insert(std::pair<uint32_t, uint32_t>(frameCount, key));
+        m_frameCountLock.unlock();
+    }
+
+    BenchRequestSP get(uint32_t frameCount)
+    {
+        BenchRequestSP request = NULL;
+        std::map<uint32_t, uint32_t>::iterator keyIter;
+        std::map<uint32_t, BenchRequestSP>::iterator iter;
+        uint32_t key;
+
+        m_frameCountLock.lock();
+        keyIter = m_frameCounts.find(frameCount);
+        if (keyIter == m_frameCounts.end()) {
+            m_frameCountLock.unlock();
+            return NULL;
+        }
+        key = keyIter->second;
+        m_frameCountLock.unlock();
+
+        m_requestLock.lock();
+        iter = m_requests.find(key);
+        if (iter != m_requests.end())
+            request = iter->second;
+        m_requestLock.unlock();
+
+        return request;
+    }
+
+    void remove(uint32_t key, uint32_t frameCount)
+    {
+        m_requestLock.lock();
+        m_requests.erase(key);
+        m_requestLock.unlock();
+
+        m_frameCountLock.lock();
+        m_frameCounts.erase(frameCount);
+        m_frameCountLock.unlock();
+    }
+
+private:
+    std::map<uint32_t, BenchRequestSP>  m_requests;
+    Mutex                               m_requestLock;
+    std::map<uint32_t, uint32_t>        m_frameCounts;
+    Mutex                               m_frameCountLock;
+};
+
+class RingBook {
+public:
+    void add(uint32_t key, uint32_t frameCount, BenchRequestSP request)
+    {
+        m_requestLock.lock();
+        m_requests.insert(key, request);
+        m_requestLock.unlock();
+
+        m_frameCounts.insert(frameCount, key);
+    }
+
+    BenchRequestSP get(uint32_t frameCount)
+    {
+        BenchRequestSP request = NULL;
+        uint32_t key;
+
+        if (m_frameCounts.find(frameCount, &key) == false)
+            return NULL;
+
+        m_requestLock.lock();
+        m_requests.find(key, &request);
+        m_requestLock.unlock();
+
+        return request;
+    }
+
+    void remove(uint32_t key, uint32_t frameCount)
+    {
+        BenchRequestSP request = NULL;
+
+        m_requestLock.lock();
+        m_requests.erase(key, &request);
+        m_requestLock.unlock();
+
+        m_frameCounts.erase(frameCount, &key);
+    }
+
+private:
+    ExynosCameraRequestRing<BenchRequestSP> m_requests;
+    Mutex                                   m_requestLock;
+    ExynosCameraKeyRing                     m_frameCounts;
+};
+
+static int64_t getNowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+template<typename BOOK>
+static void runBench(const char *name, int numReaders, int numFrames, int depth)
+{
+    BOOK book;
+    std::vector<std::thread> readers;
+    std::atomic<uint32_t> newest(0);
+    std::atomic<bool> done(false);
+    std::atomic<int64_t> numOfLookup(0);
+    std::atomic<int64_t> numOfMiss(0);
+    int64_t start, end;
+
+    for (int i = 0; i < numReaders; i++) {
+        readers.emplace_back([&, i]() {
+            int64_t lookup = 0, miss = 0;
+
+            while (done.load(std::memory_order_relaxed) == false) {
+                uint32_t head = newest.load(std::memory_order_acquire);
+
+                /* every pipe asks for a frame inside the pipeline */
+                for (int j = 0; j < depth; j++) {
+                    uint32_t key = head - ((i + j) % depth);
+                    BenchRequestSP request = book.get(key + BENCH_FRAME_COUNT_BASE);
+
+                    if (request == NULL || request->getKey() != key)
+                        miss++;
+                    lookup++;
+                }
+            }
+
+            numOfLookup.fetch_add(lookup);
+            numOfMiss.fetch_add(miss);
+        });
+    }
+
+    start = getNowNs();
+
+    for (int key = 0; key < numFrames; key++) {
+        book.add(key, key + BENCH_FRAME_COUNT_BASE, new BenchRequest(key));
+        newest.store(key, std::memory_order_release);
+
+        if (key >= depth)
+            book.remove(key - depth, key - depth + BENCH_FRAME_COUNT_BASE);
+    }
+
+    end = getNowNs();
+
+    done.store(true);
+    for (auto &reader : readers)
+        reader.join();
+
+    printf("  %-4s readers %d : register/remove %7.1f ns/frame, %8.2f Mlookups/s, miss %lld\n",
+            name, numReaders,
+            (double)(end - start) / (double)numFrames,
+            (double)numOfLookup.load() * 1000.0 / (double)(end - start),
+            (long long)numOfMiss.load());
+}
+
+int main(int argc, char *argv[])
+{
+    int numFrames = BENCH_DEFAULT_FRAMES;
+    int depth = BENCH_DEFAULT_DEPTH;
+
+    if (argc > 1)
+        numFrames = atoi(argv[1]);
+    if (argc > 2)
+        depth = atoi(argv[2]);
+
+    if (numFrames <= depth || depth <= 0) {
+        printf("usage : %s [frames] [pipeline depth]\n", argv[0]);
+        return -1;
+    }
+
+    printf("Request bookkeeping : %d frames, pipeline depth %d\n", numFrames, depth);
+
+    for (int readers = 1; readers <= BENCH_MAX_READERS; readers *= 2) {
+        runBench<MapBook>("map", readers, numFrames, depth);
+        runBench<RingBook>("ring", readers, numFrames, depth);
+    }
+
+    return 0;
+}
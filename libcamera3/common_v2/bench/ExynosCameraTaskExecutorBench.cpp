@@ -0,0 +1,292 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * SW pipes of a multi camera preview, a thread per pipe vs the shared
+ * ExynosCameraTaskExecutor.
+ * Each camera runs a chain of preview SW pipes at 30fps, and a burst of
+ * capture post-processing runs on capture SW pipes at the same time.
+ * The preview latency is from the push to the first pipe to the end of
+ * the last one.
+ *
+ * usage : exynoscamera_task_executor_bench [cameras] [preview frames]
+ */
+
+#define LOG_TAG "ExynosCameraTaskExecutorBench"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <vector>
+
+#include <log/log.h>
+
+#include "ExynosCameraTaskExecutor.h"
+
+#define BENCH_DEFAULT_CAMERAS       (2)
+#define BENCH_DEFAULT_FRAMES        (150)
+#define BENCH_MAX_CAMERAS           (4)
+#define BENCH_PREVIEW_PIPES         (3)
+#define BENCH_PREVIEW_WORK_US       (1500)
+#define BENCH_CAPTURE_PIPES         (2)
+#define BENCH_CAPTURE_WORK_US       (40000)
+#define BENCH_CAPTURE_FRAMES        (8)
+#define BENCH_FRAME_INTERVAL_US     (33333)
+
+static void busyWork(int us)
+{
+    nsecs_t end = systemTime(SYSTEM_TIME_MONOTONIC) + (nsecs_t)us * 1000;
+    volatile uint32_t x = 0;
+
+    while (systemTime(SYSTEM_TIME_MONOTONIC) < end)
+        x++;
+}
+
+/* a frame is its first push time */
+class BenchPipe : public ExynosCameraTaskRunnable {
+public:
+    BenchPipe(int workUs, int priority, BenchPipe *next, bool useExecutor)
+    {
+        m_workUs = workUs;
+        m_priority = priority;
+        m_next = next;
+        m_useExecutor = useExecutor;
+        m_executor = ExynosCameraTaskExecutor::getInstance();
+        m_queued = false;
+        m_exit = false;
+        numOfDone = 0;
+    }
+
+    virtual ~BenchPipe() {}
+
+    void start(void)
+    {
+        if (m_useExecutor == true)
+            m_executor->attach();
+        else
+            pthread_create(&m_thread, NULL, m_threadFunc, this);
+    }
+
+    void stop(void)
+    {
+        if (m_useExecutor == true) {
+            m_executor->cancel(this);
+            m_executor->detach();
+            return;
+        }
+
+        m_lock.lock();
+        m_exit = true;
+        m_condition.signal();
+        m_lock.unlock();
+        pthread_join(m_thread, NULL);
+    }
+
+    void push(nsecs_t frame)
+    {
+        Mutex::Autolock lock(m_lock);
+
+        m_queue.push_back(frame);
+
+        if (m_useExecutor == false) {
+            m_condition.signal();
+        } else if (m_queued == false) {
+            m_queued = true;
+            m_executor->submit(this, m_priority, m_queue.front());
+        }
+    }
+
+    /* the end to end latency of the frames that left the last pipe */
+    std::vector<nsecs_t> latency;
+    std::atomic<int> numOfDone;
+
+    virtual void runTask(void)
+    {
+        nsecs_t frame;
+
+        m_lock.lock();
+        frame = m_queue.front();
+        m_queue.pop_front();
+        m_lock.unlock();
+
+        m_process(frame);
+
+        Mutex::Autolock lock(m_lock);
+        m_queued = false;
+        if (m_queue.empty() == false) {
+            m_queued = true;
+            m_executor->submit(this, m_priority, m_queue.front());
+        }
+    }
+
+private:
+    void m_process(nsecs_t frame)
+    {
+        busyWork(m_workUs);
+
+        if (m_next != NULL) {
+            m_next->push(frame);
+        } else {
+            Mutex::Autolock lock(m_lock);
+            latency.push_back(systemTime(SYSTEM_TIME_MONOTONIC) - frame);
+        }
+
+        numOfDone++;
+    }
+
+    static void *m_threadFunc(void *data)
+    {
+        BenchPipe *pipe = (BenchPipe *)data;
+        nsecs_t frame;
+
+        while (true) {
+            pipe->m_lock.lock();
+            while (pipe->m_queue.empty() == true && pipe->m_exit == false)
+                pipe->m_condition.waitRelative(pipe->m_lock, TASK_EXECUTOR_IDLE_WAIT_TIME);
+
+            if (pipe->m_exit == true) {
+                pipe->m_lock.unlock();
+                break;
+            }
+
+            frame = pipe->m_queue.front();
+            pipe->m_queue.pop_front();
+            pipe->m_lock.unlock();
+
+            pipe->m_process(frame);
+        }
+
+        return NULL;
+    }
+
+    int                         m_workUs;
+    int                         m_priority;
+    BenchPipe                   *m_next;
+    bool                        m_useExecutor;
+    ExynosCameraTaskExecutor    *m_executor;
+    pthread_t                   m_thread;
+
+    Mutex                       m_lock;
+    Condition                   m_condition;
+    std::deque<nsecs_t>         m_queue;
+    bool                        m_queued;
+    bool                        m_exit;
+};
+
+static void run(const char *name, bool useExecutor, int numOfCamera, int numOfFrame)
+{
+    std::vector<BenchPipe *> pipes;
+    BenchPipe *head[BENCH_MAX_CAMERAS];
+    BenchPipe *tail[BENCH_MAX_CAMERAS];
+    BenchPipe *capture[BENCH_CAPTURE_PIPES];
+    std::vector<nsecs_t> latency;
+    nsecs_t start, captureEnd = 0;
+    int numOfCaptureDone;
+
+    for (int c = 0; c < numOfCamera; c++) {
+        BenchPipe *next = NULL;
+
+        for (int i = 0; i < BENCH_PREVIEW_PIPES; i++) {
+            next = new BenchPipe(BENCH_PREVIEW_WORK_US, TASK_PRIORITY_PREVIEW, next, useExecutor);
+            pipes.push_back(next);
+            if (i == 0)
+                tail[c] = next;
+        }
+        head[c] = next;
+    }
+
+    for (int i = 0; i < BENCH_CAPTURE_PIPES; i++) {
+        capture[i] = new BenchPipe(BENCH_CAPTURE_WORK_US, TASK_PRIORITY_CAPTURE, NULL, useExecutor);
+        pipes.push_back(capture[i]);
+    }
+
+    for (size_t i = 0; i < pipes.size(); i++)
+        pipes[i]->start();
+
+    start = systemTime(SYSTEM_TIME_MONOTONIC);
+
+    /* the capture burst comes with the first preview frame */
+    for (int i = 0; i < BENCH_CAPTURE_FRAMES; i++)
+        capture[i % BENCH_CAPTURE_PIPES]->push(start);
+
+    for (int f = 0; f < numOfFrame; f++) {
+        for (int c = 0; c < numOfCamera; c++)
+            head[c]->push(systemTime(SYSTEM_TIME_MONOTONIC));
+
+        numOfCaptureDone = 0;
+        for (int i = 0; i < BENCH_CAPTURE_PIPES; i++)
+            numOfCaptureDone += capture[i]->numOfDone;
+        if (captureEnd == 0 && numOfCaptureDone == BENCH_CAPTURE_FRAMES)
+            captureEnd = systemTime(SYSTEM_TIME_MONOTONIC);
+
+        usleep(BENCH_FRAME_INTERVAL_US);
+    }
+
+    /* drain */
+    usleep(200000);
+
+    for (size_t i = 0; i < pipes.size(); i++)
+        pipes[i]->stop();
+
+    for (int c = 0; c < numOfCamera; c++)
+        latency.insert(latency.end(), tail[c]->latency.begin(), tail[c]->latency.end());
+
+    std::sort(latency.begin(), latency.end());
+
+    if (latency.empty() == false) {
+        printf("  %-10s threads %2d : preview %4zu frames p50 %6.2f p99 %6.2f max %6.2f ms, capture %s %7.1f ms\n",
+               name,
+               useExecutor ? TASK_EXECUTOR_NUM_OF_WORKER : (int)pipes.size(),
+               latency.size(),
+               latency[latency.size() / 2] / 1000000.0,
+               latency[latency.size() * 99 / 100] / 1000000.0,
+               latency.back() / 1000000.0,
+               captureEnd ? "done in" : "not done",
+               captureEnd ? (captureEnd - start) / 1000000.0 : 0.0);
+    }
+
+    for (size_t i = 0; i < pipes.size(); i++)
+        delete pipes[i];
+}
+
+int main(int argc, char *argv[])
+{
+    int numOfCamera = BENCH_DEFAULT_CAMERAS;
+    int numOfFrame = BENCH_DEFAULT_FRAMES;
+
+    if (argc > 1)
+        numOfCamera = atoi(argv[1]);
+    if (argc > 2)
+        numOfFrame = atoi(argv[2]);
+
+    if (numOfCamera <= 0 || numOfCamera > BENCH_MAX_CAMERAS || numOfFrame <= 0) {
+        printf("usage : %s [cameras(1~%d)] [preview frames]\n", argv[0], BENCH_MAX_CAMERAS);
+        return -1;
+    }
+
+    printf("SW pipes : %d cameras x %d preview pipes (%d us), %d capture pipes (%d us x %d frames)\n",
+           numOfCamera, BENCH_PREVIEW_PIPES, BENCH_PREVIEW_WORK_US,
+           BENCH_CAPTURE_PIPES, BENCH_CAPTURE_WORK_US, BENCH_CAPTURE_FRAMES);
+
+    run("thread", false, numOfCamera, numOfFrame);
+    run("executor", true, numOfCamera, numOfFrame);
+
+    return 0;
+}
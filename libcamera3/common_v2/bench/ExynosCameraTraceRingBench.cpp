@@ -0,0 +1,111 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed toggle an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Recording cost of the ExynosCameraTimeLogger event ring.
+ * Every thread records into its own ring, the way pipe threads do, and the
+ * cost per event is printed next to the bare CLOCK_MONOTONIC read that
+ * each event pays for its timestamp.
+ *
+ * usage : exynoscamera_trace_ring_bench [events per thread]
+ */
+
+#define LOG_TAG "ExynosCameraTraceRingBench"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <thread>
+#include <vector>
+
+#include <log/log.h>
+
+#include "ExynosCameraTraceRing.h"
+
+#define BENCH_DEFAULT_EVENTS    (2000000)
+#define BENCH_MAX_THREADS       (4)
+#define BENCH_RING_SIZE         (1024 * 4)
+
+static double runClock(int numEvents)
+{
+    uint64_t start, end, sum = 0;
+
+    start = traceRingNow();
+    for (int i = 0; i < numEvents; i++)
+        sum += traceRingNow();
+    end = traceRingNow();
+
+    /* keep the loop */
+    if (sum == 0)
+        printf("\n");
+
+    return (double)(end - start) / (double)numEvents;
+}
+
+static void runBench(int numThreads, int numEvents)
+{
+    std::vector<std::thread> threads;
+    std::vector<double> cost(numThreads);
+    double worst = 0.0;
+
+    for (int i = 0; i < numThreads; i++) {
+        threads.emplace_back([&cost, i, numEvents]() {
+            ExynosCameraTraceRing ring(BENCH_RING_SIZE);
+            uint64_t start, end;
+
+            ring.acquire(i, "bench");
+
+            start = traceRingNow();
+            for (int j = 0; j < numEvents; j++)
+                ring.record(0, j, i, 1, 1, j & 0x1, j);
+            end = traceRingNow();
+
+            cost[i] = (double)(end - start) / (double)numEvents;
+        });
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    for (int i = 0; i < numThreads; i++) {
+        if (worst < cost[i])
+            worst = cost[i];
+    }
+
+    printf("  threads %d : worst %6.1f ns/event\n", numThreads, worst);
+}
+
+int main(int argc, char *argv[])
+{
+    int numEvents = BENCH_DEFAULT_EVENTS;
+
+    if (argc > 1)
+        numEvents = atoi(argv[1]);
+
+    if (numEvents <= 0) {
+        printf("usage : %s [events per thread]\n", argv[0]);
+        return -1;
+    }
+
+    printf("ExynosCameraTraceRing : %d events per thread, %zu bytes per event\n",
+            numEvents, sizeof(traceEvent_t));
+    printf("  clock_gettime : %6.1f ns\n", runClock(numEvents));
+
+    for (int threads = 1; threads <= BENCH_MAX_THREADS; threads *= 2)
+        runBench(threads, numEvents);
+
+    return 0;
+}
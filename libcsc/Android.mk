@@ -29,6 +29,10 @@ LOCAL_SHARED_LIBRARIES := liblog libexynosscaler
 
 LOCAL_CFLAGS += -DUSE_SAMSUNG_COLORFORMAT
 
+ifeq ($(BOARD_USE_NV12T_128X64), true)
+LOCAL_CFLAGS += -DUSE_NV12T_128X64
+endif
+
 ifdef BOARD_DEFAULT_CSC_HW_SCALER
 LOCAL_CFLAGS += -DDEFAULT_CSC_HW=$(BOARD_DEFAULT_CSC_HW_SCALER)
 else
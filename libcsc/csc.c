@@ -31,6 +31,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include <log/log.h>
 #include <system/graphics.h>
 
@@ -231,6 +232,329 @@ static CSC_ERRORCODE copy_mfc_data(CSC_HANDLE *handle) {
     return ret;
 }
 
+/*
+ * CSC_METHOD_SW worker pool
+ * conv_sw splits a conversion into horizontal stripes of whole rows.
+ * The stripes are handed out to the workers and the caller thread,
+ * and csc_sw_run_stripes() returns when all of them are done.
+ */
+#define CSC_SW_MAX_THREADS          8
+#define CSC_SW_STRIPES_PER_THREAD   2
+
+#ifdef USE_NV12T_128X64
+/* 128x64 tiles run in Z order over tile row pairs, keep the frame whole */
+#define CSC_SW_NV12T_STRIPE_ALIGN   0
+#else
+/* Y tiles are 16x16 and UV tiles 16x8 */
+#define CSC_SW_NV12T_STRIPE_ALIGN   16
+#endif
+
+typedef void (*CSC_SW_STRIPE_FUNC)(CSC_HANDLE *handle, unsigned int top, unsigned int bottom);
+
+typedef struct _CSC_SW_POOL {
+    pthread_t           threads[CSC_SW_MAX_THREADS - 1];
+    unsigned int        num_workers;
+    pthread_mutex_t     lock;
+    pthread_cond_t      start_cond;
+    pthread_cond_t      done_cond;
+    unsigned int        generation;
+    int                 exit;
+
+    /* current job, protected by lock */
+    CSC_HANDLE         *handle;
+    CSC_SW_STRIPE_FUNC  func;
+    unsigned int        height;
+    unsigned int        stripe_height;
+    unsigned int        num_stripes;
+    unsigned int        next_stripe;
+    unsigned int        pending;
+} CSC_SW_POOL;
+
+/* called with pool->lock held, returns with it held */
+static void csc_sw_do_stripes(CSC_SW_POOL *pool)
+{
+    unsigned int top, bottom;
+
+    while (pool->next_stripe < pool->num_stripes) {
+        top = pool->next_stripe * pool->stripe_height;
+        bottom = top + pool->stripe_height;
+        if (bottom > pool->height)
+            bottom = pool->height;
+        pool->next_stripe++;
+
+        pthread_mutex_unlock(&pool->lock);
+        pool->func(pool->handle, top, bottom);
+        pthread_mutex_lock(&pool->lock);
+
+        if (--pool->pending == 0)
+            pthread_cond_signal(&pool->done_cond);
+    }
+}
+
+static void *csc_sw_worker(void *arg)
+{
+    CSC_SW_POOL *pool = (CSC_SW_POOL *)arg;
+    unsigned int generation = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (!pool->exit && pool->generation == generation)
+            pthread_cond_wait(&pool->start_cond, &pool->lock);
+        if (pool->exit)
+            break;
+
+        generation = pool->generation;
+        csc_sw_do_stripes(pool);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+static void csc_sw_pool_destroy(
+    CSC_SW_POOL *pool)
+{
+    unsigned int i;
+
+    if (pool == NULL)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->exit = 1;
+    pthread_cond_broadcast(&pool->start_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (i = 0; i < pool->num_workers; i++)
+        pthread_join(pool->threads[i], NULL);
+
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_cond_destroy(&pool->start_cond);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+static CSC_SW_POOL *csc_sw_pool_create(
+    unsigned int num_workers)
+{
+    CSC_SW_POOL *pool;
+    unsigned int i;
+
+    pool = (CSC_SW_POOL *)malloc(sizeof(CSC_SW_POOL));
+    if (pool == NULL)
+        return NULL;
+
+    memset(pool, 0, sizeof(CSC_SW_POOL));
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+
+    for (i = 0; i < num_workers; i++) {
+        if (pthread_create(&pool->threads[i], NULL, csc_sw_worker, pool) != 0) {
+            ALOGE("%s:: pthread_create fail, %d of %d workers", __func__, i, num_workers);
+            break;
+        }
+        pool->num_workers++;
+    }
+
+    if (pool->num_workers == 0) {
+        csc_sw_pool_destroy(pool);
+        pool = NULL;
+    }
+
+    return pool;
+}
+
+/*
+ * Runs func over [0, height) in stripes whose height is a multiple of align.
+ * Without a pool (or align 0, or a frame too small to split) func runs once
+ * over the whole frame on the caller thread.
+ */
+static void csc_sw_run_stripes(
+    CSC_HANDLE         *handle,
+    CSC_SW_STRIPE_FUNC  func,
+    unsigned int        height,
+    unsigned int        align)
+{
+    CSC_SW_POOL *pool = (CSC_SW_POOL *)handle->sw_pool;
+    unsigned int num_threads, stripe_height;
+
+    if (pool == NULL || align == 0 || height < (align * 2)) {
+        func(handle, 0, height);
+        return;
+    }
+
+    num_threads = pool->num_workers + 1;
+    stripe_height = ALIGN((height + (num_threads * CSC_SW_STRIPES_PER_THREAD) - 1) /
+                          (num_threads * CSC_SW_STRIPES_PER_THREAD), align);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->handle = handle;
+    pool->func = func;
+    pool->height = height;
+    pool->stripe_height = stripe_height;
+    pool->num_stripes = (height + stripe_height - 1) / stripe_height;
+    pool->next_stripe = 0;
+    pool->pending = pool->num_stripes;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start_cond);
+
+    csc_sw_do_stripes(pool);
+    while (pool->pending > 0)
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static int is_yv12(
+    unsigned int color_format)
+{
+    return (color_format == HAL_PIXEL_FORMAT_YV12) ||
+           (color_format == HAL_PIXEL_FORMAT_EXYNOS_YV12_M);
+}
+
+/* rows [top, bottom) of BGRA8888/RGBA8888 to YUV420P/YV12, top is even */
+static void conv_sw_stripe_rgb_to_yuv420p(
+    CSC_HANDLE   *handle,
+    unsigned int  top,
+    unsigned int  bottom)
+{
+    unsigned int width = handle->src_format.width;
+    unsigned int chroma_top = (top >> 1) * ((width + 1) >> 1);
+    unsigned char *y_dst = (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE] + (width * top);
+    unsigned char *u_dst = (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE] + chroma_top;
+    unsigned char *v_dst = (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE] + chroma_top;
+    unsigned char *rgb_src = (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE] + (width * top * 4);
+
+    if (is_yv12(handle->dst_format.color_format)) {
+        unsigned char *tmp = u_dst;
+        u_dst = v_dst;
+        v_dst = tmp;
+    }
+
+    if (handle->src_format.color_format == HAL_PIXEL_FORMAT_BGRA_8888)
+        csc_BGRA8888_to_YUV420P(y_dst, u_dst, v_dst, rgb_src, width, bottom - top);
+    else
+        csc_RGBA8888_to_YUV420P(y_dst, u_dst, v_dst, rgb_src, width, bottom - top);
+}
+
+/* rows [top, bottom) of BGRA8888/RGBA8888 to YUV420SP, top is even */
+static void conv_sw_stripe_rgb_to_yuv420sp(
+    CSC_HANDLE   *handle,
+    unsigned int  top,
+    unsigned int  bottom)
+{
+    unsigned int width = handle->src_format.width;
+    unsigned char *y_dst = (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE] + (width * top);
+    unsigned char *uv_dst = (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE] +
+                            ((top >> 1) * ((width + 1) >> 1) * 2);
+    unsigned char *rgb_src = (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE] + (width * top * 4);
+
+    if (handle->src_format.color_format == HAL_PIXEL_FORMAT_BGRA_8888)
+        csc_BGRA8888_to_YUV420SP(y_dst, uv_dst, rgb_src, width, bottom - top);
+    else
+        csc_RGBA8888_to_YUV420SP(y_dst, uv_dst, rgb_src, width, bottom - top);
+}
+
+/*
+ * rows [top, bottom) of NV12T to YUV420P/YUV420SP
+ * top is a multiple of 16, so the Y(16x16) and UV(16x8) tile rows start at
+ * tiled_width * top and tiled_width * top / 2
+ */
+static void conv_sw_stripe_nv12t(
+    CSC_HANDLE   *handle,
+    unsigned int  top,
+    unsigned int  bottom)
+{
+    unsigned int width = handle->src_format.crop_width;
+    unsigned int tiled_width = ALIGN(width, 16);
+    unsigned char *y_src = (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE] + (tiled_width * top);
+    unsigned char *uv_src = (unsigned char *)handle->src_buffer.planes[CSC_UV_PLANE] + (tiled_width * (top >> 1));
+
+    csc_tiled_to_linear_y(
+        (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE] + (width * top),
+        y_src, width, bottom - top);
+
+    switch (handle->dst_format.color_format) {
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P:
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P_M:
+    case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_PN:
+        csc_tiled_to_linear_uv_deinterleave(
+            (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE] + ((width >> 1) * (top >> 1)),
+            (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE] + ((width >> 1) * (top >> 1)),
+            uv_src, width, (bottom >> 1) - (top >> 1));
+        break;
+    default:
+        csc_tiled_to_linear_uv(
+            (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE] + (width * (top >> 1)),
+            uv_src, width, (bottom >> 1) - (top >> 1));
+        break;
+    }
+}
+
+/* rows [top, bottom) of YUV420P/YV12 to YUV420SP */
+static void conv_sw_stripe_yuv420p_to_yuv420sp(
+    CSC_HANDLE   *handle,
+    unsigned int  top,
+    unsigned int  bottom)
+{
+    unsigned int width = handle->src_format.width;
+    unsigned int chroma_top = (width * top) >> 2;
+    unsigned int chroma_bottom = (width * bottom) >> 2;
+    unsigned char *u_src = (unsigned char *)handle->src_buffer.planes[CSC_U_PLANE];
+    unsigned char *v_src = (unsigned char *)handle->src_buffer.planes[CSC_V_PLANE];
+
+    if (is_yv12(handle->src_format.color_format)) {
+        unsigned char *tmp = u_src;
+        u_src = v_src;
+        v_src = tmp;
+    }
+
+    memcpy((unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE] + (width * top),
+           (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE] + (width * top),
+           width * (bottom - top));
+    csc_interleave_memcpy(
+        (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE] + (chroma_top * 2),
+        u_src + chroma_top,
+        v_src + chroma_top,
+        chroma_bottom - chroma_top);
+}
+
+/* rows [top, bottom) of NV12/NV21 to YUV420P/YV12, top is even */
+static void conv_sw_stripe_yuv420sp_to_yuv420p(
+    CSC_HANDLE   *handle,
+    unsigned int  top,
+    unsigned int  bottom)
+{
+    unsigned int width = handle->src_format.width;
+    unsigned int crop_width = handle->src_format.crop_width;
+    unsigned int i, j;
+    char *pSrc  = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
+    char *pDst  = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
+    char *pDstU = (char *)handle->dst_buffer.planes[CSC_U_PLANE];
+    char *pDstV = (char *)handle->dst_buffer.planes[CSC_V_PLANE];
+    int srcOffset, dstOffset;
+    int swap_uv;
+
+    for (i = top; i < bottom; i++)
+        memcpy(pDst + (crop_width * i), pSrc + (width * i), crop_width);
+
+    /* NV21 source and YV12 destination both swap the chroma order */
+    swap_uv = (handle->src_format.color_format == HAL_PIXEL_FORMAT_YCrCb_420_SP) ||
+              (handle->src_format.color_format == HAL_PIXEL_FORMAT_EXYNOS_YCrCb_420_SP_M);
+    if (is_yv12(handle->dst_format.color_format))
+        swap_uv = !swap_uv;
+
+    pSrc = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
+    for (i = (top >> 1); i < (bottom >> 1); i++) {
+        for (j = 0; j < (crop_width >> 1); j++) {
+            srcOffset = (i * width) + (j * 2);
+            dstOffset = i * (crop_width >> 1);
+
+            pDstU[dstOffset + j] = pSrc[srcOffset + swap_uv];
+            pDstV[dstOffset + j] = pSrc[srcOffset + !swap_uv];
+        }
+    }
+}
+
 /* source is BRGA888 */
 static CSC_ERRORCODE conv_sw_src_argb888(
     CSC_HANDLE *handle)
@@ -248,36 +572,18 @@ static CSC_ERRORCODE conv_sw_src_argb888(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_PN:
-        csc_BGRA8888_to_YUV420P(
-            (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-            (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE],
-            (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE],
-            handle->src_format.width,
-            handle->src_format.height);
+    case HAL_PIXEL_FORMAT_YV12:
+    case HAL_PIXEL_FORMAT_EXYNOS_YV12_M:
+        csc_sw_run_stripes(handle, conv_sw_stripe_rgb_to_yuv420p,
+                           handle->src_format.height, 2);
         ret = CSC_ErrorNone;
         break;
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_PRIV:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN:
-        csc_BGRA8888_to_YUV420SP(
-            (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-            (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE],
-            handle->src_format.width,
-            handle->src_format.height);
-        ret = CSC_ErrorNone;
-        break;
-    case HAL_PIXEL_FORMAT_YV12:
-    case HAL_PIXEL_FORMAT_EXYNOS_YV12_M:
-        csc_BGRA8888_to_YUV420P(
-            (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-            (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE],
-            (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE],
-            handle->src_format.width,
-            handle->src_format.height);
+        csc_sw_run_stripes(handle, conv_sw_stripe_rgb_to_yuv420sp,
+                           handle->src_format.height, 2);
         ret = CSC_ErrorNone;
         break;
     default:
@@ -305,36 +611,18 @@ static CSC_ERRORCODE conv_sw_src_rgba888(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_PN:
-        csc_RGBA8888_to_YUV420P(
-            (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-            (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE],
-            (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE],
-            handle->src_format.width,
-            handle->src_format.height);
+    case HAL_PIXEL_FORMAT_YV12:
+    case HAL_PIXEL_FORMAT_EXYNOS_YV12_M:
+        csc_sw_run_stripes(handle, conv_sw_stripe_rgb_to_yuv420p,
+                           handle->src_format.height, 2);
         ret = CSC_ErrorNone;
         break;
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_PRIV:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN:
-        csc_RGBA8888_to_YUV420SP(
-            (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-            (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE],
-            handle->src_format.width,
-            handle->src_format.height);
-        ret = CSC_ErrorNone;
-        break;
-    case HAL_PIXEL_FORMAT_YV12:
-    case HAL_PIXEL_FORMAT_EXYNOS_YV12_M:
-        csc_RGBA8888_to_YUV420P(
-            (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-            (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE],
-            (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE],
-            handle->src_format.width,
-            handle->src_format.height);
+        csc_sw_run_stripes(handle, conv_sw_stripe_rgb_to_yuv420sp,
+                           handle->src_format.height, 2);
         ret = CSC_ErrorNone;
         break;
     default:
@@ -356,33 +644,12 @@ static CSC_ERRORCODE conv_sw_src_nv12t(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_PN:
-        csc_tiled_to_linear_y(
-            (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
-            handle->src_format.crop_width,
-            handle->src_format.crop_height);
-        csc_tiled_to_linear_uv_deinterleave(
-            (unsigned char *)handle->dst_buffer.planes[CSC_U_PLANE],
-            (unsigned char *)handle->dst_buffer.planes[CSC_V_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_UV_PLANE],
-            handle->src_format.crop_width,
-            handle->src_format.crop_height / 2);
-        ret = CSC_ErrorNone;
-        break;
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_PRIV:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN:
-        csc_tiled_to_linear_y(
-            (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
-            handle->src_format.crop_width,
-            handle->src_format.crop_height);
-        csc_tiled_to_linear_uv(
-            (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_UV_PLANE],
-            handle->src_format.crop_width,
-            handle->src_format.crop_height / 2);
+        csc_sw_run_stripes(handle, conv_sw_stripe_nv12t,
+                           handle->src_format.crop_height, CSC_SW_NV12T_STRIPE_ALIGN);
         ret = CSC_ErrorNone;
         break;
     default:
@@ -422,14 +689,8 @@ static CSC_ERRORCODE conv_sw_src_yuv420p(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_PRIV:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN:
-        memcpy((unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-               (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
-               handle->src_format.width * handle->src_format.height);
-        csc_interleave_memcpy(
-            (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_U_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_V_PLANE],
-            (handle->src_format.width * handle->src_format.height) >> 2);
+        csc_sw_run_stripes(handle, conv_sw_stripe_yuv420p_to_yuv420sp,
+                           handle->src_format.height, 2);
         ret = CSC_ErrorNone;
         break;
     default:
@@ -468,14 +729,8 @@ static CSC_ERRORCODE conv_sw_src_yvu420p(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_PRIV:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SPN:
-        memcpy((unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
-               (unsigned char *)handle->src_buffer.planes[CSC_Y_PLANE],
-               handle->src_format.width * handle->src_format.height);
-        csc_interleave_memcpy(
-            (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_V_PLANE],
-            (unsigned char *)handle->src_buffer.planes[CSC_U_PLANE],
-            (handle->src_format.width * handle->src_format.height) >> 2);
+        csc_sw_run_stripes(handle, conv_sw_stripe_yuv420p_to_yuv420sp,
+                           handle->src_format.height, 2);
         ret = CSC_ErrorNone;
         break;
     default:
@@ -492,13 +747,6 @@ static CSC_ERRORCODE conv_sw_src_yuv420sp(
 {
     CSC_ERRORCODE ret = CSC_ErrorNone;
 
-    char *pSrc  = NULL;
-    char *pDst  = NULL;
-    char *pDstU = NULL;
-    char *pDstV = NULL;
-    int srcOffset, dstOffset;
-    int i, j;
-
     switch (handle->dst_format.color_format) {
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP:    /* bypass */
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M:
@@ -519,52 +767,10 @@ static CSC_ERRORCODE conv_sw_src_yuv420sp(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_PN:
-    {
-        pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
-        pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-        for (i = 0; i < (int)handle->src_format.crop_height; i++) {
-            memcpy(pDst + (handle->src_format.crop_width * i),
-                   pSrc + (handle->src_format.width * i),
-                   handle->src_format.crop_width);
-        }
-
-        pSrc  = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
-        pDstU = (char *)handle->dst_buffer.planes[CSC_U_PLANE];
-        pDstV = (char *)handle->dst_buffer.planes[CSC_V_PLANE];
-        for (i = 0; i < (int)(handle->src_format.crop_height >> 1); i++) {
-            for (j = 0; j < (int)(handle->src_format.crop_width >> 1); j++) {
-                srcOffset = (i * handle->src_format.width) + (j * 2);
-                dstOffset = i * (handle->src_format.crop_width >> 1);
-
-                pDstU[dstOffset + j] = pSrc[srcOffset];
-                pDstV[dstOffset + j] = pSrc[srcOffset + 1];
-            }
-        }
-        ret = CSC_ErrorNone;
-    }
-        break;
     case HAL_PIXEL_FORMAT_YV12:
     case HAL_PIXEL_FORMAT_EXYNOS_YV12_M:
-        pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
-        pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-        for (i = 0; i < (int)handle->src_format.crop_height; i++) {
-            memcpy(pDst + (handle->src_format.crop_width * i),
-                   pSrc + (handle->src_format.width * i),
-                   handle->src_format.crop_width);
-        }
-
-        pSrc  = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
-        pDstU = (char *)handle->dst_buffer.planes[CSC_U_PLANE];
-        pDstV = (char *)handle->dst_buffer.planes[CSC_V_PLANE];
-        for (i = 0; i < (int)(handle->src_format.crop_height >> 1); i++) {
-            for (j = 0; j < (int)(handle->src_format.crop_width >> 1); j++) {
-                srcOffset = (i * handle->src_format.width) + (j * 2);
-                dstOffset = i * (handle->src_format.crop_width >> 1);
-
-                pDstU[dstOffset + j] = pSrc[srcOffset + 1];
-                pDstV[dstOffset + j] = pSrc[srcOffset];
-            }
-        }
+        csc_sw_run_stripes(handle, conv_sw_stripe_yuv420sp_to_yuv420p,
+                           handle->src_format.crop_height, 2);
         ret = CSC_ErrorNone;
         break;
     default:
@@ -581,13 +787,6 @@ static CSC_ERRORCODE conv_sw_src_yvu420sp(
 {
     CSC_ERRORCODE ret = CSC_ErrorNone;
 
-    char *pSrc  = NULL;
-    char *pDst  = NULL;
-    char *pDstU = NULL;
-    char *pDstV = NULL;
-    int srcOffset, dstOffset;
-    int i, j;
-
     switch (handle->dst_format.color_format) {
     case HAL_PIXEL_FORMAT_YCrCb_420_SP:  /* bypass */
     case HAL_PIXEL_FORMAT_EXYNOS_YCrCb_420_SP_M:
@@ -607,50 +806,10 @@ static CSC_ERRORCODE conv_sw_src_yvu420sp(
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_P_M:
     case HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_PN:
-        pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
-        pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-        for (i = 0; i < (int)handle->src_format.crop_height; i++) {
-            memcpy(pDst + (handle->src_format.crop_width * i),
-                   pSrc + (handle->src_format.width * i),
-                   handle->src_format.crop_width);
-        }
-
-        pSrc  = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
-        pDstU = (char *)handle->dst_buffer.planes[CSC_U_PLANE];
-        pDstV = (char *)handle->dst_buffer.planes[CSC_V_PLANE];
-        for (i = 0; i < (int)(handle->src_format.crop_height >> 1); i++) {
-            for (j = 0; j < (int)(handle->src_format.crop_width >> 1); j++) {
-                srcOffset = (i * handle->src_format.width) + (j * 2);
-                dstOffset = i * (handle->src_format.crop_width >> 1);
-
-                pDstU[dstOffset + j] = pSrc[srcOffset + 1];
-                pDstV[dstOffset + j] = pSrc[srcOffset];
-            }
-        }
-        ret = CSC_ErrorNone;
-        break;
     case HAL_PIXEL_FORMAT_YV12:
     case HAL_PIXEL_FORMAT_EXYNOS_YV12_M:
-        pSrc = (char *)handle->src_buffer.planes[CSC_Y_PLANE];
-        pDst = (char *)handle->dst_buffer.planes[CSC_Y_PLANE];
-        for (i = 0; i < (int)handle->src_format.crop_height; i++) {
-            memcpy(pDst + (handle->src_format.crop_width * i),
-                   pSrc + (handle->src_format.width * i),
-                   handle->src_format.crop_width);
-        }
-
-        pSrc  = (char *)handle->src_buffer.planes[CSC_UV_PLANE];
-        pDstU = (char *)handle->dst_buffer.planes[CSC_U_PLANE];
-        pDstV = (char *)handle->dst_buffer.planes[CSC_V_PLANE];
-        for (i = 0; i < (int)(handle->src_format.crop_height >> 1); i++) {
-            for (j = 0; j < (int)(handle->src_format.crop_width >> 1); j++) {
-                srcOffset = (i * handle->src_format.width) + (j * 2);
-                dstOffset = i * (handle->src_format.crop_width >> 1);
-
-                pDstU[dstOffset + j] = pSrc[srcOffset];
-                pDstV[dstOffset + j] = pSrc[srcOffset + 1];
-            }
-        }
+        csc_sw_run_stripes(handle, conv_sw_stripe_yuv420sp_to_yuv420p,
+                           handle->src_format.crop_height, 2);
         ret = CSC_ErrorNone;
         break;
     default:
@@ -971,6 +1130,7 @@ void *csc_init(
     csc_handle->hw_property.fixed_node = DEFAULT_CSC_HW;	/* CSC_HW_SC1 == 5 */
     csc_handle->hw_property.mode_drm = 0;
     csc_handle->csc_method = method;
+    csc_handle->sw_threads = 1;
 
     return (void *)csc_handle;
 }
@@ -1004,6 +1164,7 @@ CSC_ERRORCODE csc_deinit(
         }
     }
 
+    csc_sw_pool_destroy((CSC_SW_POOL *)csc_handle->sw_pool);
     free(csc_handle);
     ret = CSC_ErrorNone;
 
@@ -1152,6 +1313,43 @@ CSC_ERRORCODE csc_set_framerate(
     return ret;
 }
 
+CSC_ERRORCODE csc_set_sw_threads(
+    void              *handle,
+    unsigned int      num_threads)
+{
+    CSC_HANDLE *csc_handle;
+    CSC_ERRORCODE ret = CSC_ErrorNone;
+
+    if (handle == NULL)
+        return CSC_ErrorNotInit;
+
+    csc_handle = (CSC_HANDLE *)handle;
+    if (num_threads == 0)
+        num_threads = 1;
+    if (num_threads > CSC_SW_MAX_THREADS)
+        num_threads = CSC_SW_MAX_THREADS;
+
+    if (num_threads == csc_handle->sw_threads)
+        return ret;
+
+    csc_sw_pool_destroy((CSC_SW_POOL *)csc_handle->sw_pool);
+    csc_handle->sw_pool = NULL;
+    csc_handle->sw_threads = 1;
+
+    if (num_threads > 1) {
+        /* the caller thread takes stripes too */
+        csc_handle->sw_pool = csc_sw_pool_create(num_threads - 1);
+        if (csc_handle->sw_pool == NULL) {
+            ALOGE("%s:: can't create %d sw threads", __func__, num_threads);
+            ret = CSC_Error;
+        } else {
+            csc_handle->sw_threads = ((CSC_SW_POOL *)csc_handle->sw_pool)->num_workers + 1;
+        }
+    }
+
+    return ret;
+}
+
 CSC_ERRORCODE csc_get_src_format(
     void           *handle,
     unsigned int   *width,
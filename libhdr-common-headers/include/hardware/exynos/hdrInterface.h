@@ -118,6 +118,14 @@ public:
     // debug phase
     virtual void setLogLevel(int __attribute__((unused)) log_level) {}
     virtual void setDebugMode(enum DebugMode __attribute__((unused)) debug_mode) {}
+
+    // statistics phase
+    virtual void getCurveCacheStat(unsigned int *hit, unsigned int *miss) {
+        if (hit != nullptr)
+            *hit = 0;
+        if (miss != nullptr)
+            *miss = 0;
+    }
 };
 
 #endif /* __HDR_INTERFACE_H__ */
@@ -4,6 +4,8 @@
 #include "libhdr_parcel_header.h"
 #include "hdrUtil.h"
 #include "hdrHwInfo.h"
+#include "hdrLutBlob.h"
+#include <list>
 #include <algorithm>
 #include "hdrModuleSpecifiers.h"
 
@@ -32,6 +34,10 @@ private:
     std::unordered_map<int, struct hdr10pModule> layerToHdr10pMod;
     void parse(std::vector<struct supportedHdrHw> *list, struct hdrContext *ctx);
     void __parse__(int hw_id, struct hdrContext *ctx);
+    bool parse_xml(int hw_id, std::string &fn_target);
+    /* blobs the coef tables point into */
+    std::list<hdrLutBlob> blobs;
+    bool load_blob(int hw_id, std::string &fn_target);
     void parse_hdr10pMods(
         int hw_id,
         xmlDocPtr xml_doc,
@@ -68,6 +74,9 @@ public:
     hdr10pCoef (void);
     void parse(hdrHwInfo *hwInfo,
                 struct hdrContext *ctx);
+    int compile(hdrHwInfo *hwInfo,
+                std::string &xmlFile,
+                std::string &blobFile);
     int coefBuildup(int layer_index,
                 struct hdrContext *out);
     void init(struct hdrContext *ctx);
@@ -19,6 +19,7 @@
 
 #include <fcntl.h>
 #include "hdrModuleSpecifiers.h"
+#include "hdrCurveCache.h"
 
 namespace hdrPerLayerState {
 enum layerState {
@@ -114,6 +115,7 @@ struct hdrContext {
     unsigned int target_luminance[HdrTargetLuminanceType::MAX] = {0};
     class hdrModuleSpecifiers moduleSpecifiers;
     class hdrMetaInterface* metaIf;
+    class hdrCurveCache curveCache;
 
     void init (class hdrHwInfo *hwInfo);
     std::string getTargetName(void);
@@ -0,0 +1,92 @@
+#ifndef __HDR_CURVE_CACHE_H__
+#define __HDR_CURVE_CACHE_H__
+
+#include <list>
+#include <string.h>
+#include <unordered_map>
+#include "libhdr_parcel_header.h"
+#include "dynamic_info_legacy.h"
+
+#define HDR_CURVE_CACHE_SIZE    32
+
+enum hdrCurveType {
+    HDR_CURVE_TM = 0,       /* genTMCurve by static luminance */
+    HDR_CURVE_TM_DYNAMIC,   /* genTMCurve by dynamic meta */
+    HDR_CURVE_EOTF,         /* genEOTFCurve */
+};
+
+/* every input of the curve synthesis and of the packing */
+struct hdrCurveKey {
+    int type;
+    int hw_id;
+    int layer_index;
+    int dataspace;
+    unsigned int source_luminance;
+    unsigned int target_luminance;
+    const void *metaIf;
+    /* the hash only picks the bucket, equal keys also compare the whole meta */
+    unsigned long long dyn_meta_hash;
+    bool has_dyn_meta;
+    ExynosHdrDynamicInfo_t dyn_meta;
+
+    hdrCurveKey(int type, int hw_id, int layer_index, int dataspace,
+            unsigned int source_luminance, unsigned int target_luminance,
+            const void *metaIf = nullptr, const ExynosHdrDynamicInfo_t *dyn_meta = nullptr);
+    bool operator==(const struct hdrCurveKey &op) const {
+        return (type == op.type) && (hw_id == op.hw_id) &&
+            (layer_index == op.layer_index) && (dataspace == op.dataspace) &&
+            (source_luminance == op.source_luminance) &&
+            (target_luminance == op.target_luminance) &&
+            (metaIf == op.metaIf) && (dyn_meta_hash == op.dyn_meta_hash) &&
+            (has_dyn_meta == op.has_dyn_meta) &&
+            (!has_dyn_meta || memcmp(&dyn_meta, &op.dyn_meta, sizeof(dyn_meta)) == 0);
+    }
+};
+
+struct hdrCurveKeyHash {
+    size_t operator()(const struct hdrCurveKey &key) const;
+};
+
+struct hdrCurveNode {
+    struct hdr_dat_node mod_en_packed;
+    struct hdr_dat_node mod_x_packed;
+    struct hdr_dat_node mod_y_packed;
+};
+
+class hdrCurveCache {
+private:
+    typedef std::list<std::pair<struct hdrCurveKey, struct hdrCurveNode>> lruList;
+    unsigned int capacity;
+    unsigned int hit = 0;
+    unsigned int miss = 0;
+    lruList lru;
+    std::unordered_map<struct hdrCurveKey, lruList::iterator, struct hdrCurveKeyHash> index;
+
+    struct hdrCurveNode *find(const struct hdrCurveKey &key);
+    struct hdrCurveNode *insert(const struct hdrCurveKey &key);
+public:
+    hdrCurveCache(unsigned int capacity = HDR_CURVE_CACHE_SIZE) : capacity(capacity) {}
+    void clear(void);
+    void getStat(unsigned int *hit, unsigned int *miss);
+
+    /* Spec : tonemapModuleSpecifier or eotfModuleSpecifier */
+    template <typename Spec>
+    bool load(const struct hdrCurveKey &key, Spec *spec) {
+        struct hdrCurveNode *node = find(key);
+        if (node == nullptr)
+            return false;
+        spec->mod_en_packed = node->mod_en_packed;
+        spec->mod_x_packed = node->mod_x_packed;
+        spec->mod_y_packed = node->mod_y_packed;
+        return true;
+    }
+    template <typename Spec>
+    void store(const struct hdrCurveKey &key, Spec *spec) {
+        struct hdrCurveNode *node = insert(key);
+        node->mod_en_packed = spec->mod_en_packed;
+        node->mod_x_packed = spec->mod_x_packed;
+        node->mod_y_packed = spec->mod_y_packed;
+    }
+};
+
+#endif
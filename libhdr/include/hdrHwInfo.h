@@ -29,6 +29,9 @@ private:
 public:
     void init(void);
     IHdrHw *getIf (int hw_id);
+    /* the hw info xml the luts are packed with, overridable before init() */
+    std::string getInfoFile (int hw_id);
+    void setInfoFile (int hw_id, const std::string &file);
     std::vector<struct supportedHdrHw> *getListHdrHw(void);
 };
 
@@ -0,0 +1,119 @@
+#ifndef __HDR_LUT_BLOB_H__
+#define __HDR_LUT_BLOB_H__
+
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include "libhdr_parcel_header.h"
+
+/*
+ * Precompiled LUT blob
+ *
+ * hdr_lut_compiler parses a LUT xml (hdr10Lut.xml, wcgLut.xml, ...) once on
+ * the host and stores the already packed hdr_dat_nodes as a flat record
+ * stream. At runtime the blob next to the xml ("xxx.xml" -> "xxx.bin") is
+ * mapped and replayed into the coef tables instead of parsing the xml.
+ *
+ * [hdr_lut_blob_header][record][words...][record][words...]...
+ *
+ * The xmls are not read again at load time : a blob is stale when an xml
+ * is newer than the blob (pushed after the image was built) or its size
+ * differs from the one the blob was compiled from.
+ *
+ * The packed words are not copied : the nodes point into the mapping, so
+ * the hdrLutBlob has to stay open as long as the coef tables are in use.
+ */
+#define HDR_LUT_BLOB_MAGIC      0x54554C48  /* "HLUT" */
+#define HDR_LUT_BLOB_VERSION    3
+#define HDR_LUT_BLOB_NAME_LEN   32
+
+enum hdrLutBlobKind {
+    HDR_LUT_BLOB_HDR10 = 1,
+    HDR_LUT_BLOB_HDR10P,
+    HDR_LUT_BLOB_HLG,
+    HDR_LUT_BLOB_WCG,
+};
+
+enum hdrLutBlobRecordType {
+    HDR_LUT_REC_DATA = 0,   /* packed hdr_dat_node */
+    HDR_LUT_REC_NODE,       /* end of a lut node, key[0] : max luminance */
+    HDR_LUT_REC_MODULE,     /* start of a module */
+    HDR_LUT_REC_LAYER,      /* module committed to the layer */
+    HDR_LUT_REC_CUSTOM,     /* wcg custom, key[] : in dataspace, out dataspace, capa */
+};
+
+struct hdr_lut_blob_header {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int kind;
+    unsigned int hw_id;
+    unsigned int total_bytesize;
+    unsigned int num_records;
+    /* sizes of the source xml and of the hw info xml, checked at load time */
+    unsigned long long src_size;
+    unsigned long long hw_size;
+};
+
+struct hdr_lut_blob_record {
+    unsigned int type;
+    int layer;
+    int key[3];
+    char name[HDR_LUT_BLOB_NAME_LEN];
+    struct hdr_lut_header header;
+    int group_id;
+    unsigned int num_words;
+    /* followed by num_words packed words, a HDR_LUT_REC_DATA has at least one */
+};
+
+class hdrHwInfo;
+
+class hdrLutBlobWriter {
+private:
+    unsigned int kind;
+    unsigned int hw_id;
+    unsigned int num_records = 0;
+    std::vector<char> records;
+public:
+    hdrLutBlobWriter(unsigned int kind, unsigned int hw_id) : kind(kind), hw_id(hw_id) {}
+    void add(unsigned int type, int layer, int key0 = 0, int key1 = 0, int key2 = 0,
+            const std::string &name = "", struct hdr_dat_node *dat = nullptr);
+    int save(const std::string &path, const std::string &srcFile, const std::string &hwFile);
+};
+
+class hdrLutBlob {
+private:
+    void *addr = nullptr;
+    size_t size = 0;
+    const struct hdr_lut_blob_header *header = nullptr;
+
+    static bool enabled;
+    static std::string searchDir;
+    static unsigned int numLoaded;
+
+    bool isValidRecord(const struct hdr_lut_blob_record *rec);
+public:
+    hdrLutBlob(void) = default;
+    hdrLutBlob(const hdrLutBlob &) = delete;
+    hdrLutBlob &operator=(const hdrLutBlob &) = delete;
+    ~hdrLutBlob(void) { close(); }
+    bool open(const std::string &xmlFile, unsigned int kind, unsigned int hw_id,
+            const std::string &hwFile);
+    void close(void);
+    unsigned int getNumRecords(void) { return header ? header->num_records : 0; }
+    const struct hdr_lut_blob_record *first(void);
+    const struct hdr_lut_blob_record *next(const struct hdr_lut_blob_record *rec);
+    /* out refers to the words in the mapping, it must not outlive the blob */
+    static void getDatNode(const struct hdr_lut_blob_record *rec, struct hdr_dat_node &out);
+
+    static std::string getBlobPath(const std::string &xmlFile);
+    static bool isStale(const std::string &file, unsigned long long size, const struct stat &blobStat);
+    /* test hooks : force the xml path, or look up blobs in another directory */
+    static void setEnabled(bool enable) { enabled = enable; }
+    static void setSearchDir(const std::string &dir) { searchDir = dir; }
+    static unsigned int getNumLoaded(void) { return numLoaded; }
+};
+
+/* compiles a lut xml (kind detected by the root node) into a blob */
+int hdrLutCompile(hdrHwInfo *hwInfo, std::string &xmlFile, std::string &blobFile);
+
+#endif
@@ -4,6 +4,8 @@
 #include "libhdr_parcel_header.h"
 #include "hdrUtil.h"
 #include "hdrHwInfo.h"
+#include "hdrLutBlob.h"
+#include <list>
 #include <algorithm>
 
 struct hlgNode {
@@ -24,6 +26,10 @@ private:
     std::unordered_map<int, struct hlgModule> layerToHlgMod;
     void parse(std::vector<struct supportedHdrHw> *list, struct hdrContext *ctx);
     void __parse__(int hw_id, struct hdrContext *ctx);
+    bool parse_xml(int hw_id, std::string &fn_target);
+    /* blobs the coef tables point into */
+    std::list<hdrLutBlob> blobs;
+    bool load_blob(int hw_id, std::string &fn_target);
     void parse_hlgMods(
         int hw_id,
         xmlDocPtr xml_doc,
@@ -57,6 +63,9 @@ public:
     hlgCoef (void);
     void parse(hdrHwInfo *hwInfo,
                 struct hdrContext *ctx);
+    int compile(hdrHwInfo *hwInfo,
+                std::string &xmlFile,
+                std::string &blobFile);
     int coefBuildup(int layer_index,
                 struct hdrContext *out);
     void init(struct hdrContext *ctx);
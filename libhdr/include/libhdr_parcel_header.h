@@ -52,6 +52,8 @@ struct hdr_dat_node {
     struct hdr_lut_header header;
     char *data;
     int group_id;
+    /* data points into a read-only lut blob mapping, it is shared not owned */
+    bool mapped = false;
     hdr_dat_node () {
         this->header.byte_offset = -1;
         this->header.length = -1;
@@ -74,7 +76,10 @@ struct hdr_dat_node {
         this->header.magic = op.header.magic;
         this->group_id= op.group_id;
 
-        if (op.data != NULL) {
+        if (op.mapped) {
+            this->data = op.data;
+            this->mapped = true;
+        } else if (op.data != NULL) {
             data = new char[this->header.length*4];
             memcpy(this->data, op.data, this->header.length*4);
         } else 
@@ -85,12 +90,40 @@ struct hdr_dat_node {
         this->header.length = -1;
         this->header.magic = -1;
         this->group_id= -1;
-        if (this->data != NULL)
+        if (this->data != NULL && !this->mapped)
             delete[] this->data;
         else
             this->data = NULL;
     }
+    /* refers to the words of a blob record, the blob has to outlive the node */
+    void map(const struct hdr_lut_header &header, int group_id, const void *words) {
+        if (this->data != NULL && !this->mapped)
+            delete[] this->data;
+        this->header = header;
+        this->group_id = group_id;
+        this->data = (char *)words;
+        this->mapped = true;
+    }
+    /* takes a private copy of mapped words before they are modified */
+    void unmap(void) {
+        if (!this->mapped)
+            return;
+        char *words = new char[this->header.length*4];
+        memcpy(words, this->data, this->header.length*4);
+        this->data = words;
+        this->mapped = false;
+    }
     struct hdr_dat_node &operator=(const struct hdr_dat_node &op) {
+        if (op.mapped) {
+            if (this != &op)
+                map(op.header, op.group_id, op.data);
+            return *this;
+        }
+        if (this->mapped) {
+            this->data = NULL;
+            this->mapped = false;
+            this->header.length = -1;
+        }
         if (this->header.length != op.header.length) {
             if (this->data != NULL)
                 delete[] this->data;
@@ -105,6 +138,16 @@ struct hdr_dat_node {
         return *this;
     }
     struct hdr_dat_node &operator=(struct hdr_dat_node &&op) noexcept {
+        if (op.mapped) {
+            if (this != &op)
+                map(op.header, op.group_id, op.data);
+            return *this;
+        }
+        if (this->mapped) {
+            this->data = NULL;
+            this->mapped = false;
+            this->header.length = -1;
+        }
         if (this->header.length != op.header.length) {
             if (this->data != NULL)
                 delete[] this->data;
@@ -125,6 +168,11 @@ struct hdr_dat_node {
         return out_data;
     }
     void set_header (unsigned int byte_offset, unsigned int length) {
+        if (this->mapped) {
+            this->data = NULL;
+            this->mapped = false;
+            this->header.length = -1;
+        }
         if (this->header.length != length) {
             if (this->data != NULL)
                 delete[] this->data;
@@ -142,6 +190,7 @@ struct hdr_dat_node {
             bool lastNodeAlign,
             std::vector<unsigned int> bitOffsets,
             std::vector<unsigned int> masks) {
+        unmap();
         PACK(((int*)this->data), lut, numNodes, numNodesPerReg,
                 ((int)lastNodeAlign), masks, bitOffsets);
     }
@@ -191,6 +240,7 @@ struct hdr_dat_node {
         if (this->data == NULL)
             return NULL;
         this->header = op->header;
+        unmap();
 
         for (int i = 0; i < this->header.length; i++)
             ((int*)this->data)[i] |= ((int*)op->data)[i];
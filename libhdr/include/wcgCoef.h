@@ -6,6 +6,16 @@
 #include "libhdr_parcel_header.h"
 #include "hdrUtil.h"
 #include "hdrHwInfo.h"
+#include "hdrLutBlob.h"
+#include <list>
+
+/* wcg tables kept in a HDR_LUT_REC_DATA record, key[0] */
+enum wcgBlobTable {
+    WCG_BLOB_MOD_EN = 0,    /* key[1] : eq/neq, key[2] : mod en */
+    WCG_BLOB_EOTF,          /* key[1] : in transfer */
+    WCG_BLOB_OETF,          /* key[1] : out transfer */
+    WCG_BLOB_GM,            /* key[1] : in gamut, key[2] : out gamut */
+};
 
 class wcgCoef {
 private:
@@ -345,9 +355,15 @@ private:
     std::string filename = "/vendor/etc/dqe/wcgLut";
 
     hdrHwInfo *hwInfo = NULL;
+    hdrLutBlobWriter *blobWriter = NULL;
 
+    void init_maps(void);
     void parse(std::vector<struct supportedHdrHw> *list, struct hdrContext *ctx);
     void __parse__(int hw_id, struct hdrContext *ctx);
+    bool parse_xml(int hw_id, std::string &fn);
+    /* blobs the coef tables point into */
+    std::list<hdrLutBlob> blobs;
+    bool load_blob(int hw_id, std::string &fn);
     void parse_wcgMods(
         int hw_id,
         xmlDocPtr xml_doc,
@@ -389,6 +405,7 @@ private:
         xmlDocPtr xml_doc,
         xmlNodePtr xml_out);
     void parse_inoutCustom(
+        int module_id,
         struct wcgModule &wcg_module,
         xmlNodePtr xml_in);
     void dump(void) {
@@ -409,6 +426,9 @@ private:
 public:
     void init(hdrHwInfo *hwInfo,
                 struct hdrContext *ctx);
+    int compile(hdrHwInfo *hwInfo,
+                std::string &xmlFile,
+                std::string &blobFile);
     int coefBuildup(int layer_index,
                 struct hdrContext *out);
 };
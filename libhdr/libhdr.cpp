@@ -156,6 +156,11 @@ void hdrImplementation::setLogLevel(int __attribute__((unused)) log_level)
     LIBHDR_LOGD(Ctx.log_level, "%s -", __func__);
 }
 
+void hdrImplementation::getCurveCacheStat(unsigned int *hit, unsigned int *miss)
+{
+    Ctx.curveCache.getStat(hit, miss);
+}
+
 hdrInterface *hdrInterface::createInstance(void) {
     return new hdrImplementation();
 }
@@ -37,6 +37,7 @@ public:
                 struct hdrCoefParcel __attribute__((unused)) *parcel);
 
     void setLogLevel(int __attribute__((unused)) log_level);
+    void getCurveCacheStat(unsigned int *hit, unsigned int *miss);
 };
 
 #endif
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include "hdrHwInfo.h"
+#include "hdrLutBlob.h"
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <hdrHwDPU.xml> <lut.xml> [lut.bin]\n", argv[0]);
+        return 1;
+    }
+
+    std::string hwFile = argv[1];
+    std::string xmlFile = argv[2];
+    std::string blobFile = (argc > 3) ? argv[3] : hdrLutBlob::getBlobPath(xmlFile);
+
+    /* the blob holds packed words, so it is packed with the target hw layout */
+    hdrHwInfo hwInfo;
+    hwInfo.setInfoFile(HDR_HW_DPU, hwFile);
+    hwInfo.init();
+
+    if (hdrLutCompile(&hwInfo, xmlFile, blobFile) != HDR_ERR_NO) {
+        fprintf(stderr, "failed to compile %s\n", xmlFile.c_str());
+        return 1;
+    }
+    printf("%s -> %s\n", xmlFile.c_str(), blobFile.c_str());
+
+    return 0;
+}
@@ -89,12 +89,11 @@ void hdr10pCoef::parse_hdr10pMods(
     }
 }
 
-void hdr10pCoef::__parse__(int hw_id, struct hdrContext *ctx)
+bool hdr10pCoef::parse_xml(int hw_id, std::string &fn_target)
 {
     xmlDocPtr doc;
     xmlNodePtr root;
-
-    std::string fn_target = hdr10pinfo.getFileName(&ctx->Target);
+    bool parsed = false;
 
     doc = xmlParseFile(fn_target.c_str());
     if (doc == NULL) {
@@ -115,13 +114,84 @@ void hdr10pCoef::__parse__(int hw_id, struct hdrContext *ctx)
     }
 
     parse_hdr10pMods(hw_id, doc, root->xmlChildrenNode);
+    parsed = true;
 
 free_root:
     //xmlFree(root);
 free_doc:
     xmlFreeDoc(doc);
 ret:
-    return;
+    return parsed;
+}
+
+void hdr10pCoef::__parse__(int hw_id, struct hdrContext *ctx)
+{
+    std::string fn_target = hdr10pinfo.getFileName(&ctx->Target);
+
+    if (load_blob(hw_id, fn_target))
+        return;
+    parse_xml(hw_id, fn_target);
+}
+
+bool hdr10pCoef::load_blob(int hw_id, std::string &fn_target)
+{
+    struct hdr10pModule hdr10pMod;
+    struct hdr10pNode tmpNode;
+    const struct hdr_lut_blob_record *rec;
+
+    blobs.emplace_back();
+    hdrLutBlob &blob = blobs.back();
+    if (!blob.open(fn_target, HDR_LUT_BLOB_HDR10P, hw_id, hwInfo->getInfoFile(hw_id))) {
+        blobs.pop_back();
+        return false;
+    }
+
+    rec = blob.first();
+    for (unsigned int i = 0; i < blob.getNumRecords(); i++, rec = blob.next(rec)) {
+        switch (rec->type) {
+            case HDR_LUT_REC_DATA: {
+                struct hdr_dat_node tmp;
+                hdrLutBlob::getDatNode(rec, tmp);
+                tmpNode.coef_packed.push_back(tmp);
+                break;
+            }
+            case HDR_LUT_REC_NODE:
+                tmpNode.max_luminance = rec->key[0];
+                hdr10pMod.hdr10pNodeTable.push_back(tmpNode);
+                tmpNode.coef_packed.clear();
+                break;
+            case HDR_LUT_REC_LAYER:
+                /* nodes are stored already sorted */
+                layerToHdr10pMod.insert(make_pair(rec->layer, hdr10pMod));
+                hdr10pMod.hdr10pNodeTable.clear();
+                break;
+            default:
+                break;
+        }
+    }
+
+    return true;
+}
+
+int hdr10pCoef::compile(hdrHwInfo *hwInfo, std::string &xmlFile, std::string &blobFile)
+{
+    hdrLutBlobWriter writer(HDR_LUT_BLOB_HDR10P, HDR_HW_DPU);
+
+    this->hwInfo = hwInfo;
+    layerToHdr10pMod.clear();
+    if (!parse_xml(HDR_HW_DPU, xmlFile))
+        return HDR_ERR_INVAL;
+
+    for (auto &layer : layerToHdr10pMod) {
+        for (auto &node : layer.second.hdr10pNodeTable) {
+            for (auto &dat : node.coef_packed)
+                writer.add(HDR_LUT_REC_DATA, layer.first, 0, 0, 0, "", &dat);
+            writer.add(HDR_LUT_REC_NODE, layer.first, node.max_luminance);
+        }
+        writer.add(HDR_LUT_REC_LAYER, layer.first);
+    }
+
+    return writer.save(blobFile, xmlFile, hwInfo->getInfoFile(HDR_HW_DPU));
 }
 
 void hdr10pCoef::parse(std::vector<struct supportedHdrHw> *list, struct hdrContext *ctx)
@@ -152,25 +222,30 @@ void hdr10pCoef::tm_coefBuildup(int hw_id, int layer_index,
     if (tmModSpecifier->has) {
         IHdrHw *IHw = hwInfo->getIf(hw_id);
         struct hdr_dat_node* dat;
-        tmModSpecifier->mod_en[0] = 1;
-        genTMCurve({layer->dataspace, layer->source_luminance, layer->target_luminance},
-                &layer->dyn_meta,
-                tmModSpecifier->mod_x, tmModSpecifier->mod_y, tmModSpecifier->size_x,
-                tmModSpecifier->mod_x_bit, tmModSpecifier->mod_y_bit, tmModSpecifier->mod_minx_bit);
+        struct hdrCurveKey key(HDR_CURVE_TM_DYNAMIC, hw_id, layer_index, layer->dataspace,
+                layer->source_luminance, layer->target_luminance, nullptr, &layer->dyn_meta);
+        if (layer->ctx->curveCache.load(key, tmModSpecifier) == false) {
+            tmModSpecifier->mod_en[0] = 1;
+            genTMCurve({layer->dataspace, layer->source_luminance, layer->target_luminance},
+                    &layer->dyn_meta,
+                    tmModSpecifier->mod_x, tmModSpecifier->mod_y, tmModSpecifier->size_x,
+                    tmModSpecifier->mod_x_bit, tmModSpecifier->mod_y_bit, tmModSpecifier->mod_minx_bit);
+            IHw->pack(tmModSpecifier->mod_en_id, layer_index, tmModSpecifier->mod_en, tmModSpecifier->mod_en_packed);
+            IHw->pack(tmModSpecifier->mod_x_id, layer_index, tmModSpecifier->mod_x, tmModSpecifier->mod_x_packed);
+            IHw->pack(tmModSpecifier->mod_y_id, layer_index, tmModSpecifier->mod_y, tmModSpecifier->mod_y_packed);
+            layer->ctx->curveCache.store(key, tmModSpecifier);
+        }
 
-        IHw->pack(tmModSpecifier->mod_en_id, layer_index, tmModSpecifier->mod_en, tmModSpecifier->mod_en_packed);
         dat = &tmModSpecifier->mod_en_packed;
         dat->queue_and_group(
                 layer->shall,
                 layer->group[hw_id]);
 
-        IHw->pack(tmModSpecifier->mod_x_id, layer_index, tmModSpecifier->mod_x, tmModSpecifier->mod_x_packed);
         dat = &tmModSpecifier->mod_x_packed;
         dat->queue_and_group(
                 layer->shall,
                 layer->group[hw_id]);
 
-        IHw->pack(tmModSpecifier->mod_y_id, layer_index, tmModSpecifier->mod_y, tmModSpecifier->mod_y_packed);
         dat = &tmModSpecifier->mod_y_packed;
         dat->queue_and_group(
                 layer->shall,
@@ -230,24 +305,29 @@ void hdr10pCoef::eotf_coefBuildup(int hw_id, int layer_index,
             return;
         IHdrHw *IHw = hwInfo->getIf(hw_id);
         struct hdr_dat_node* dat;
-        eotfModSpecifier->mod_en[0] = 1;
-        genEOTFCurve({layer->dataspace, layer->source_luminance, 0},
-                eotfModSpecifier->mod_x, eotfModSpecifier->mod_y, eotfModSpecifier->size_x,
-                eotfModSpecifier->mod_x_bit, eotfModSpecifier->mod_y_bit, eotfModSpecifier->mod_minx_bit);
+        struct hdrCurveKey key(HDR_CURVE_EOTF, hw_id, layer_index, layer->dataspace,
+                layer->source_luminance, 0);
+        if (layer->ctx->curveCache.load(key, eotfModSpecifier) == false) {
+            eotfModSpecifier->mod_en[0] = 1;
+            genEOTFCurve({layer->dataspace, layer->source_luminance, 0},
+                    eotfModSpecifier->mod_x, eotfModSpecifier->mod_y, eotfModSpecifier->size_x,
+                    eotfModSpecifier->mod_x_bit, eotfModSpecifier->mod_y_bit, eotfModSpecifier->mod_minx_bit);
+            IHw->pack(eotfModSpecifier->mod_en_id, layer_index, eotfModSpecifier->mod_en, eotfModSpecifier->mod_en_packed);
+            IHw->pack(eotfModSpecifier->mod_x_id, layer_index, eotfModSpecifier->mod_x, eotfModSpecifier->mod_x_packed);
+            IHw->pack(eotfModSpecifier->mod_y_id, layer_index, eotfModSpecifier->mod_y, eotfModSpecifier->mod_y_packed);
+            layer->ctx->curveCache.store(key, eotfModSpecifier);
+        }
 
-        IHw->pack(eotfModSpecifier->mod_en_id, layer_index, eotfModSpecifier->mod_en, eotfModSpecifier->mod_en_packed);
         dat = &eotfModSpecifier->mod_en_packed;
         dat->queue_and_group(
                 layer->shall,
                 layer->group[hw_id]);
 
-        IHw->pack(eotfModSpecifier->mod_x_id, layer_index, eotfModSpecifier->mod_x, eotfModSpecifier->mod_x_packed);
         dat = &eotfModSpecifier->mod_x_packed;
         dat->queue_and_group(
                 layer->shall,
                 layer->group[hw_id]);
 
-        IHw->pack(eotfModSpecifier->mod_y_id, layer_index, eotfModSpecifier->mod_y, eotfModSpecifier->mod_y_packed);
         dat = &eotfModSpecifier->mod_y_packed;
         dat->queue_and_group(
                 layer->shall,
@@ -24,3 +24,16 @@ std::vector<struct supportedHdrHw> *hdrHwInfo::getListHdrHw(void)
 {
     return &listHdrHw;
 }
+
+std::string hdrHwInfo::getInfoFile (int hw_id)
+{
+    return idToFileName[hw_id];
+}
+
+void hdrHwInfo::setInfoFile (int hw_id, const std::string &file)
+{
+    for (auto &item : listHdrHw) {
+        if (item.id == hw_id)
+            item.hdrHwInfoFile = file;
+    }
+}
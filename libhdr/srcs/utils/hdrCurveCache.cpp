@@ -0,0 +1,91 @@
+#include "hdrCurveCache.h"
+
+static inline unsigned long long fnv1a(unsigned long long hash, const void *data, size_t len)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    for (size_t i = 0; i < len; i++)
+        hash = (hash ^ p[i]) * 0x100000001b3ULL;
+    return hash;
+}
+
+hdrCurveKey::hdrCurveKey(int type, int hw_id, int layer_index, int dataspace,
+        unsigned int source_luminance, unsigned int target_luminance,
+        const void *metaIf, const ExynosHdrDynamicInfo_t *dyn_meta)
+{
+    this->type = type;
+    this->hw_id = hw_id;
+    this->layer_index = layer_index;
+    this->dataspace = dataspace;
+    this->source_luminance = source_luminance;
+    this->target_luminance = target_luminance;
+    this->metaIf = metaIf;
+    this->dyn_meta_hash = 0;
+    this->has_dyn_meta = (dyn_meta != nullptr);
+    if (dyn_meta != nullptr) {
+        this->dyn_meta_hash = fnv1a(0xcbf29ce484222325ULL, dyn_meta, sizeof(ExynosHdrDynamicInfo_t));
+        memcpy(&this->dyn_meta, dyn_meta, sizeof(ExynosHdrDynamicInfo_t));
+    } else
+        memset(&this->dyn_meta, 0, sizeof(ExynosHdrDynamicInfo_t));
+}
+
+size_t hdrCurveKeyHash::operator()(const struct hdrCurveKey &key) const
+{
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+
+    hash = fnv1a(hash, &key.type, sizeof(key.type));
+    hash = fnv1a(hash, &key.hw_id, sizeof(key.hw_id));
+    hash = fnv1a(hash, &key.layer_index, sizeof(key.layer_index));
+    hash = fnv1a(hash, &key.dataspace, sizeof(key.dataspace));
+    hash = fnv1a(hash, &key.source_luminance, sizeof(key.source_luminance));
+    hash = fnv1a(hash, &key.target_luminance, sizeof(key.target_luminance));
+    hash = fnv1a(hash, &key.metaIf, sizeof(key.metaIf));
+    hash ^= key.dyn_meta_hash;
+
+    return (size_t)hash;
+}
+
+struct hdrCurveNode *hdrCurveCache::find(const struct hdrCurveKey &key)
+{
+    auto iter = index.find(key);
+    if (iter == index.end()) {
+        miss++;
+        return nullptr;
+    }
+
+    hit++;
+    /* most recently used on the front */
+    lru.splice(lru.begin(), lru, iter->second);
+    return &iter->second->second;
+}
+
+struct hdrCurveNode *hdrCurveCache::insert(const struct hdrCurveKey &key)
+{
+    auto iter = index.find(key);
+    if (iter != index.end()) {
+        lru.splice(lru.begin(), lru, iter->second);
+        return &iter->second->second;
+    }
+
+    if (capacity > 0 && lru.size() >= capacity) {
+        index.erase(lru.back().first);
+        lru.pop_back();
+    }
+
+    lru.emplace_front(key, hdrCurveNode());
+    index[key] = lru.begin();
+    return &lru.front().second;
+}
+
+void hdrCurveCache::clear(void)
+{
+    index.clear();
+    lru.clear();
+}
+
+void hdrCurveCache::getStat(unsigned int *hit, unsigned int *miss)
+{
+    if (hit != nullptr)
+        *hit = this->hit;
+    if (miss != nullptr)
+        *miss = this->miss;
+}
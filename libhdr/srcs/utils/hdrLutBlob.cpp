@@ -0,0 +1,278 @@
+#include "hdrLutBlob.h"
+#include "hdrHwInfo.h"
+#include "hdr10Coef.h"
+#include "hdr10pCoef.h"
+#include "hlgCoef.h"
+#include "wcgCoef.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+bool hdrLutBlob::enabled = true;
+std::string hdrLutBlob::searchDir;
+unsigned int hdrLutBlob::numLoaded = 0;
+
+void hdrLutBlobWriter::add(unsigned int type, int layer, int key0, int key1, int key2,
+        const std::string &name, struct hdr_dat_node *dat)
+{
+    struct hdr_lut_blob_record rec;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.type = type;
+    rec.layer = layer;
+    rec.key[0] = key0;
+    rec.key[1] = key1;
+    rec.key[2] = key2;
+    strncpy(rec.name, name.c_str(), HDR_LUT_BLOB_NAME_LEN - 1);
+    rec.group_id = -1;
+    rec.header.byte_offset = -1;
+    rec.header.length = -1;
+    rec.header.magic = -1;
+    if (dat != nullptr) {
+        rec.header = dat->header;
+        rec.group_id = dat->group_id;
+        if (dat->data != NULL)
+            rec.num_words = dat->header.length;
+    }
+
+    if (type == HDR_LUT_REC_DATA && rec.num_words == 0) {
+        ALOGE("%s: data record without words(layer %d, %s)", __func__, layer, name.c_str());
+        return;
+    }
+
+    size_t offset = records.size();
+    records.resize(offset + sizeof(rec) + (rec.num_words * sizeof(int)));
+    memcpy(&records[offset], &rec, sizeof(rec));
+    if (rec.num_words)
+        memcpy(&records[offset + sizeof(rec)], dat->data, rec.num_words * sizeof(int));
+    num_records++;
+}
+
+int hdrLutBlobWriter::save(const std::string &path, const std::string &srcFile,
+        const std::string &hwFile)
+{
+    struct hdr_lut_blob_header header;
+    struct stat st;
+
+    header.magic = HDR_LUT_BLOB_MAGIC;
+    header.version = HDR_LUT_BLOB_VERSION;
+    header.kind = kind;
+    header.hw_id = hw_id;
+    header.total_bytesize = sizeof(header) + records.size();
+    header.num_records = num_records;
+    header.src_size = (stat(srcFile.c_str(), &st) == 0) ? st.st_size : 0;
+    header.hw_size = (stat(hwFile.c_str(), &st) == 0) ? st.st_size : 0;
+
+    FILE *fp = fopen(path.c_str(), "wb");
+    if (fp == NULL) {
+        ALOGE("%s: can not open %s", __func__, path.c_str());
+        return HDR_ERR_INVAL;
+    }
+    bool ok = (fwrite(&header, sizeof(header), 1, fp) == 1);
+    if (ok && records.size())
+        ok = (fwrite(records.data(), records.size(), 1, fp) == 1);
+    fclose(fp);
+    if (!ok) {
+        ALOGE("%s: write failed(%s)", __func__, path.c_str());
+        unlink(path.c_str());
+        return HDR_ERR_INVAL;
+    }
+
+    return HDR_ERR_NO;
+}
+
+std::string hdrLutBlob::getBlobPath(const std::string &xmlFile)
+{
+    std::string path = xmlFile;
+    size_t ext = path.rfind(".xml");
+
+    if (ext != std::string::npos && ext + 4 == path.size())
+        path.erase(ext);
+    path += ".bin";
+
+    if (!searchDir.empty()) {
+        size_t base = path.rfind('/');
+        path = searchDir + ((base == std::string::npos) ? path : path.substr(base + 1));
+    }
+
+    return path;
+}
+
+/*
+ * An xml which is not on the device does not make the blob stale. The image
+ * gives the xml and the blob the same time, an xml pushed later is newer.
+ */
+bool hdrLutBlob::isStale(const std::string &file, unsigned long long size, const struct stat &blobStat)
+{
+    struct stat st;
+
+    if (stat(file.c_str(), &st) < 0)
+        return false;
+
+    if ((unsigned long long)st.st_size != size)
+        return true;
+
+    if (st.st_mtim.tv_sec != blobStat.st_mtim.tv_sec)
+        return (st.st_mtim.tv_sec > blobStat.st_mtim.tv_sec);
+
+    return (st.st_mtim.tv_nsec > blobStat.st_mtim.tv_nsec);
+}
+
+bool hdrLutBlob::open(const std::string &xmlFile, unsigned int kind, unsigned int hw_id,
+        const std::string &hwFile)
+{
+    struct stat st;
+    std::string path;
+    int fd;
+
+    close();
+    if (!enabled)
+        return false;
+
+    path = getBlobPath(xmlFile);
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(struct hdr_lut_blob_header)) {
+        ::close(fd);
+        return false;
+    }
+    addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        addr = nullptr;
+        return false;
+    }
+    size = st.st_size;
+    header = (const struct hdr_lut_blob_header *)addr;
+
+    if (header->magic != HDR_LUT_BLOB_MAGIC || header->version != HDR_LUT_BLOB_VERSION ||
+        header->kind != kind || header->hw_id != hw_id || header->total_bytesize != size) {
+        ALOGE("%s: invalid blob(%s), version(%u), kind(%u), size(%u/%zu)", __func__,
+                path.c_str(), header->version, header->kind, header->total_bytesize, size);
+        close();
+        return false;
+    }
+
+    /* a blob is only valid for the xmls it was compiled from */
+    if (isStale(xmlFile, header->src_size, st) || isStale(hwFile, header->hw_size, st)) {
+        ALOGD("%s: stale blob(%s), falls back to xml", __func__, path.c_str());
+        close();
+        return false;
+    }
+
+    /* walk once so that replaying never reads past the mapping */
+    const struct hdr_lut_blob_record *rec = first();
+    for (unsigned int i = 0; i < header->num_records; i++) {
+        if (rec == nullptr) {
+            ALOGE("%s: truncated blob(%s)", __func__, path.c_str());
+            close();
+            return false;
+        }
+        if (!isValidRecord(rec)) {
+            ALOGE("%s: invalid record(%u) in blob(%s), type(%u), words(%u)", __func__,
+                    i, path.c_str(), rec->type, rec->num_words);
+            close();
+            return false;
+        }
+        rec = next(rec);
+    }
+
+    numLoaded++;
+    ALOGD("%s: %s, records(%u)", __func__, path.c_str(), header->num_records);
+    return true;
+}
+
+void hdrLutBlob::close(void)
+{
+    if (addr != nullptr)
+        munmap(addr, size);
+    addr = nullptr;
+    size = 0;
+    header = nullptr;
+}
+
+/* a data record has to carry the words its lut header describes */
+bool hdrLutBlob::isValidRecord(const struct hdr_lut_blob_record *rec)
+{
+    if (rec->type != HDR_LUT_REC_DATA)
+        return true;
+
+    return (rec->num_words > 0) && (rec->header.length == rec->num_words);
+}
+
+static inline bool in_range(size_t size, size_t offset, size_t len)
+{
+    return (offset <= size) && (len <= size - offset);
+}
+
+const struct hdr_lut_blob_record *hdrLutBlob::first(void)
+{
+    size_t offset = sizeof(struct hdr_lut_blob_header);
+    const struct hdr_lut_blob_record *rec;
+
+    if (header == nullptr || !in_range(size, offset, sizeof(*rec)))
+        return nullptr;
+    rec = (const struct hdr_lut_blob_record *)((const char *)addr + offset);
+    if (!in_range(size, offset + sizeof(*rec), (size_t)rec->num_words * sizeof(int)))
+        return nullptr;
+
+    return rec;
+}
+
+const struct hdr_lut_blob_record *hdrLutBlob::next(const struct hdr_lut_blob_record *rec)
+{
+    size_t offset = ((const char *)rec - (const char *)addr) +
+                    sizeof(*rec) + ((size_t)rec->num_words * sizeof(int));
+
+    if (!in_range(size, offset, sizeof(*rec)))
+        return nullptr;
+    rec = (const struct hdr_lut_blob_record *)((const char *)addr + offset);
+    if (!in_range(size, offset + sizeof(*rec), (size_t)rec->num_words * sizeof(int)))
+        return nullptr;
+
+    return rec;
+}
+
+void hdrLutBlob::getDatNode(const struct hdr_lut_blob_record *rec, struct hdr_dat_node &out)
+{
+    out.map(rec->header, rec->group_id, rec + 1);
+}
+
+int hdrLutCompile(hdrHwInfo *hwInfo, std::string &xmlFile, std::string &blobFile)
+{
+    xmlDocPtr doc;
+    xmlNodePtr root;
+    std::string rootName;
+
+    doc = xmlParseFile(xmlFile.c_str());
+    if (doc == NULL) {
+        ALOGE("%s: can not parse the document(%s)", __func__, xmlFile.c_str());
+        return HDR_ERR_INVAL;
+    }
+    root = xmlDocGetRootElement(doc);
+    if (root != NULL)
+        rootName = (char*)root->name;
+    xmlFreeDoc(doc);
+
+    if (rootName == "HDR10_LUT") {
+        hdr10Coef coef;
+        return coef.compile(hwInfo, xmlFile, blobFile);
+    } else if (rootName == "HDR10P_LUT") {
+        hdr10pCoef coef;
+        return coef.compile(hwInfo, xmlFile, blobFile);
+    } else if (rootName == "HLG_LUT") {
+        hlgCoef coef;
+        return coef.compile(hwInfo, xmlFile, blobFile);
+    } else if (rootName == "WCG") {
+        wcgCoef coef;
+        return coef.compile(hwInfo, xmlFile, blobFile);
+    }
+
+    ALOGD("%s: %s is not a lut document(%s)", __func__, xmlFile.c_str(), rootName.c_str());
+    return HDR_ERR_INVAL;
+}
@@ -1,6 +1,7 @@
 #include "wcgCoef.h"
 #include "hdrContext.h"
 #include <unistd.h>
+#include <memory>
 
 using namespace std;
 
@@ -41,6 +42,9 @@ void wcgCoef::parse_inoutGamut(
                             struct gm tmp;
                             tmp.gmCoef = out_vec;
                             IHw->pack(subModName, module_id, out_vec, tmp.gmCoef_packed);
+                            if (blobWriter)
+                                blobWriter->add(HDR_LUT_REC_DATA, module_id, WCG_BLOB_GM,
+                                        in_gamut_id, out_gamut_id, subModName, &tmp.gmCoef_packed);
                             wcg_module.gmTable[in_gamut_id].out[out_gamut_id].data.insert(make_pair(subModName, tmp));
                             //wcg_module.gmTable[in_gamut_id].out[out_gamut_id].data[subModName].dump();
                         }
@@ -86,6 +90,9 @@ void wcgCoef::parse_outTransfer(
                             struct oetf tmp;
                             tmp.oetfCoef = out_vec;
                             IHw->pack(subModName, module_id, out_vec, tmp.oetfCoef_packed);
+                            if (blobWriter)
+                                blobWriter->add(HDR_LUT_REC_DATA, module_id, WCG_BLOB_OETF,
+                                        id, 0, subModName, &tmp.oetfCoef_packed);
                             wcg_module.oetfTable[id].data.insert(make_pair(subModName, tmp));
                             //wcg_module.oetfTable[id].data[subModName].dump();
                         }
@@ -131,6 +138,9 @@ void wcgCoef::parse_inTransfer(
                             struct eotf tmp;
                             tmp.eotfCoef = in_vec;
                             IHw->pack(subModName, module_id, in_vec, tmp.eotfCoef_packed);
+                            if (blobWriter)
+                                blobWriter->add(HDR_LUT_REC_DATA, module_id, WCG_BLOB_EOTF,
+                                        id, 0, subModName, &tmp.eotfCoef_packed);
                             wcg_module.eotfTable[id].data.insert(make_pair(subModName, tmp));
                             //wcg_module.eotfTable[id].data[subModName].dump();
                         }
@@ -188,6 +198,9 @@ void wcgCoef::parse_inoutDataspace(
                     tmp.modEnCoef = (bool)in[0];
                     IHw->pack(subModName, module_id, in, tmp.modEnCoef_packed);
                     //tmp.modEnCoef_packed.dump();
+                    if (blobWriter)
+                        blobWriter->add(HDR_LUT_REC_DATA, module_id, WCG_BLOB_MOD_EN,
+                                0, tmp.modEnCoef, subModName, &tmp.modEnCoef_packed);
                     wcg_module.modEnTable[0].data.insert(make_pair(subModName, tmp));
                 }
                 eqSubMod = eqSubMod->next;
@@ -207,6 +220,9 @@ void wcgCoef::parse_inoutDataspace(
                     tmp.modEnCoef = (bool)in[0];
                     IHw->pack(subModName, module_id, in, tmp.modEnCoef_packed);
                     //tmp.modEnCoef_packed.dump();
+                    if (blobWriter)
+                        blobWriter->add(HDR_LUT_REC_DATA, module_id, WCG_BLOB_MOD_EN,
+                                1, tmp.modEnCoef, subModName, &tmp.modEnCoef_packed);
                     wcg_module.modEnTable[1].data.insert(make_pair(subModName, tmp));
                 }
                 neqSubMod = neqSubMod->next;
@@ -217,6 +233,7 @@ void wcgCoef::parse_inoutDataspace(
 }
 
 void wcgCoef::parse_inoutCustom(
+        int module_id,
         struct wcgModule &wcg_module,
         xmlNodePtr xml_in)
 {
@@ -265,6 +282,9 @@ void wcgCoef::parse_inoutCustom(
                     out_dataspace = (out_gamut_id << HAL_DATASPACE_STANDARD_SHIFT) |
                                     (out_transfer_id << HAL_DATASPACE_TRANSFER_SHIFT);
                     wcg_module.customTable[in_dataspace] = {out_dataspace, out_capa_id};
+                    if (blobWriter)
+                        blobWriter->add(HDR_LUT_REC_CUSTOM, module_id,
+                                in_dataspace, out_dataspace, out_capa_id);
                 }
                 out = out->next;
             }
@@ -289,7 +309,7 @@ void wcgCoef::parse_wcgMod(
         else if (!xmlStrcmp(subInfo->name, (const xmlChar *)"inout-gamut"))
             parse_inoutGamut(hw_id, module_id, wcg_module, xml_doc, subInfo->xmlChildrenNode);
         else if (!xmlStrcmp(subInfo->name, (const xmlChar *)"inout-custom"))
-            parse_inoutCustom(wcg_module, subInfo->xmlChildrenNode);
+            parse_inoutCustom(module_id, wcg_module, subInfo->xmlChildrenNode);
         subInfo = subInfo->next;
     }
 }
@@ -312,34 +332,31 @@ void wcgCoef::parse_wcgMods(
         split(string((char*)module_id), ',', wcgModIds);
         xmlFree(module_id);
 
+        if (blobWriter)
+            blobWriter->add(HDR_LUT_REC_MODULE, -1);
         for (auto &modId : wcgModIds) {
             parse_wcgMod(hw_id, modId, wcgMod, xml_doc, module->xmlChildrenNode);
 
             layerToWcgMod.insert(make_pair(modId, wcgMod));
+            if (blobWriter)
+                blobWriter->add(HDR_LUT_REC_LAYER, modId);
         }
 
         module = module->next;
     }
 }
 
-void wcgCoef::__parse__(int hw_id, struct hdrContext *ctx)
+bool wcgCoef::parse_xml(int hw_id, std::string &fn)
 {
     xmlDocPtr doc;
     xmlNodePtr root;
+    bool parsed = false;
 
-    std::string fn_default = filename + (std::string)".xml";
-    std::string fn_target = filename + ctx->target_name;
-
-    doc = xmlParseFile(fn_target.c_str());
+    doc = xmlParseFile(fn.c_str());
     if (doc == NULL) {
         ALOGD("no document or can not parse the document(%s)",
-                fn_target.c_str());
-        doc = xmlParseFile(fn_default.c_str());
-        if (doc == NULL) {
-            ALOGD("no document or can not parse the default document(%s)",
-                fn_default.c_str());
-            goto ret;
-        }
+                fn.c_str());
+        goto ret;
     }
 
     root = xmlDocGetRootElement(doc);
@@ -354,13 +371,107 @@ void wcgCoef::__parse__(int hw_id, struct hdrContext *ctx)
     }
 
     parse_wcgMods(hw_id, doc, root->xmlChildrenNode);
+    parsed = true;
 
 free_root:
     //xmlFree(root);
 free_doc:
     xmlFreeDoc(doc);
 ret:
-    return;
+    return parsed;
+}
+
+bool wcgCoef::load_blob(int hw_id, std::string &fn)
+{
+    std::unique_ptr<struct wcgModule> wcgMod;
+    const struct hdr_lut_blob_record *rec;
+
+    blobs.emplace_back();
+    hdrLutBlob &blob = blobs.back();
+    if (!blob.open(fn, HDR_LUT_BLOB_WCG, hw_id, hwInfo->getInfoFile(hw_id))) {
+        blobs.pop_back();
+        return false;
+    }
+
+    /*
+     * replays the table operations of parse_wcgMods() in the same order,
+     * so that the unordered tables iterate (and serialize) identically
+     */
+    rec = blob.first();
+    for (unsigned int i = 0; i < blob.getNumRecords(); i++, rec = blob.next(rec)) {
+        if (rec->type == HDR_LUT_REC_MODULE) {
+            wcgMod.reset(new struct wcgModule);
+            continue;
+        }
+        if (wcgMod == nullptr)
+            break;
+
+        switch (rec->type) {
+            case HDR_LUT_REC_DATA: {
+                string subModName = string(rec->name);
+                unsigned int idx = rec->key[1];
+                unsigned int out_idx = rec->key[2];
+                if ((rec->key[0] == WCG_BLOB_MOD_EN && idx >= wcgMod->modEnTable.size()) ||
+                    (rec->key[0] == WCG_BLOB_EOTF && idx >= wcgMod->eotfTable.size()) ||
+                    (rec->key[0] == WCG_BLOB_OETF && idx >= wcgMod->oetfTable.size()) ||
+                    (rec->key[0] == WCG_BLOB_GM && (idx >= wcgMod->gmTable.size() ||
+                        out_idx >= wcgMod->gmTable[idx].out.size()))) {
+                    ALOGE("%s: table index out of range(%d, %u, %u)", __func__,
+                            rec->key[0], idx, out_idx);
+                    break;
+                }
+                switch (rec->key[0]) {
+                    case WCG_BLOB_MOD_EN: {
+                        struct modEn tmp;
+                        tmp.modEnCoef = (bool)rec->key[2];
+                        hdrLutBlob::getDatNode(rec, tmp.modEnCoef_packed);
+                        wcgMod->modEnTable[idx].data.insert(make_pair(subModName, tmp));
+                        break;
+                    }
+                    case WCG_BLOB_EOTF: {
+                        struct eotf tmp;
+                        hdrLutBlob::getDatNode(rec, tmp.eotfCoef_packed);
+                        wcgMod->eotfTable[idx].data.insert(make_pair(subModName, tmp));
+                        break;
+                    }
+                    case WCG_BLOB_OETF: {
+                        struct oetf tmp;
+                        hdrLutBlob::getDatNode(rec, tmp.oetfCoef_packed);
+                        wcgMod->oetfTable[idx].data.insert(make_pair(subModName, tmp));
+                        break;
+                    }
+                    case WCG_BLOB_GM: {
+                        struct gm tmp;
+                        hdrLutBlob::getDatNode(rec, tmp.gmCoef_packed);
+                        wcgMod->gmTable[idx].out[out_idx].data.insert(make_pair(subModName, tmp));
+                        break;
+                    }
+                }
+                break;
+            }
+            case HDR_LUT_REC_CUSTOM:
+                wcgMod->customTable[rec->key[0]] = {rec->key[1], rec->key[2]};
+                break;
+            case HDR_LUT_REC_LAYER:
+                layerToWcgMod.insert(make_pair(rec->layer, *wcgMod));
+                break;
+            default:
+                break;
+        }
+    }
+
+    return true;
+}
+
+void wcgCoef::__parse__(int hw_id, struct hdrContext *ctx)
+{
+    std::string fn_default = filename + (std::string)".xml";
+    std::string fn_target = filename + ctx->target_name;
+
+    if (load_blob(hw_id, fn_target) || parse_xml(hw_id, fn_target))
+        return;
+    if (!load_blob(hw_id, fn_default))
+        parse_xml(hw_id, fn_default);
 }
 
 void wcgCoef::parse(vector<struct supportedHdrHw> *list, struct hdrContext *ctx)
@@ -377,7 +488,7 @@ void wcgCoef::parse(vector<struct supportedHdrHw> *list, struct hdrContext *ctx)
     }
 }
 
-void wcgCoef::init(hdrHwInfo *hwInfo, struct hdrContext *ctx)
+void wcgCoef::init_maps(void)
 {
     capStrMap = mapStringToCapa();
     tfStrMap.clear();
@@ -386,12 +497,35 @@ void wcgCoef::init(hdrHwInfo *hwInfo, struct hdrContext *ctx)
     stStrMap.clear();
     for (auto &st : standardTable)
         stStrMap[st.str] = st.id;
+}
+
+void wcgCoef::init(hdrHwInfo *hwInfo, struct hdrContext *ctx)
+{
+    init_maps();
 
     this->hwInfo = hwInfo;
     parse(hwInfo->getListHdrHw(), ctx);
     //this->dump();
 }
 
+int wcgCoef::compile(hdrHwInfo *hwInfo, std::string &xmlFile, std::string &blobFile)
+{
+    hdrLutBlobWriter writer(HDR_LUT_BLOB_WCG, HDR_HW_DPU);
+    bool parsed;
+
+    init_maps();
+    this->hwInfo = hwInfo;
+    layerToWcgMod.clear();
+
+    blobWriter = &writer;
+    parsed = parse_xml(HDR_HW_DPU, xmlFile);
+    blobWriter = NULL;
+    if (!parsed)
+        return HDR_ERR_INVAL;
+
+    return writer.save(blobFile, xmlFile, hwInfo->getInfoFile(HDR_HW_DPU));
+}
+
 int wcgCoef::coefBuildup(int layer_index, struct hdrContext *ctx)
 {
     int ret = HDR_ERR_NO;
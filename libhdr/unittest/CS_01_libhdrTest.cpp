@@ -20,6 +20,9 @@
 #include <hardware/exynos/hdrInterface.h>
 #include <system/graphics.h>
 #include <cutils/properties.h>
+#include <hdrLutBlob.h>
+#include <dirent.h>
+#include <sys/stat.h>
 
 #include "wcgTestVector.h"
 #include "hdrTestVector.h"
@@ -58,6 +61,8 @@ class CS_01_libhdrTest : public ::testing::Test {
             Ihdr->setLogLevel(0);
         }
         void TearDown() override {
+            hdrLutBlob::setEnabled(true);
+            hdrLutBlob::setSearchDir("");
             delete (char*)data.hdrCoef;
             delete Ihdr;
         }
@@ -243,6 +248,45 @@ class CS_01_libhdrTest : public ::testing::Test {
         void setDynamicMeta(ExynosHdrDynamicInfo *d_meta, int index) {
             hdr10pTV.setDynamicMeta(d_meta, index);
         }
+        void pushCoefData(vector<vector<char>> &out) {
+            struct hdr_coef_header *header_g = (struct hdr_coef_header *)data.hdrCoef;
+            char *coef = (char *)data.hdrCoef;
+            unsigned int size = std::min(header_g->total_bytesize, (unsigned int)buf_size);
+            out.push_back(vector<char>(coef, coef + size));
+        }
+        void buildCoefData(vector<vector<char>> &out) {
+            ExynosHdrStaticInfo s_meta;
+            ExynosHdrDynamicInfo d_meta;
+            vector<int> ds_list = {HAL_DATASPACE_V0_SRGB, HAL_DATASPACE_DISPLAY_P3,
+                HAL_DATASPACE_BT2020, HAL_DATASPACE_BT2020_PQ, HAL_DATASPACE_BT2020_HLG};
+            vector<int> lum_list = {(300 * 10000), (1000 * 10000), (4000 * 10000)};
+
+            tInfo = {HAL_DATASPACE_V0_SRGB, 0, 1000, HDR_BPC_10, HDR_CAPA_INNER};
+            Ihdr->setTargetInfo(&tInfo);
+            for (auto ds : ds_list) {
+                for (int i = 0; i < lum_list.size(); i++) {
+                    s_meta.sType1.mMaxDisplayLuminance = lum_list[i];
+                    setDynamicMeta(&d_meta, i);
+                    for (int dynamic = 0; dynamic < 2; dynamic++) {
+                        Ihdr->initHdrCoefBuildup(HDR_HW_DPU);
+                        Ihdr->setHDRlayer(false);
+                        lInfo = {ds,        // dataspace
+                               &s_meta, sizeof(ExynosHdrStaticInfo),        // static
+                               dynamic ? &d_meta : NULL,                    // dynamic
+                               dynamic ? sizeof(ExynosHdrDynamicInfo) : 0,
+                               true,                // pre mult
+                               HDR_BPC_10,          // bpc
+                               REND_ORI,            // source
+                               NULL,                // tf_matrix
+                               false};              // bypass
+                        Ihdr->setLayerInfo(0,       //layer
+                                &lInfo);
+                        Ihdr->getHdrCoefData(HDR_HW_DPU, 0, &data);
+                        pushCoefData(out);
+                    }
+                }
+            }
+        }
         void Verify_Hdr10p_Data(int hw_id, int layer, ExynosHdrStaticInfo *s_meta, ExynosHdrDynamicInfo *d_meta) {
             std::unordered_map<int,struct hdr_dat_node*> hdr10pTV_map = hdr10pTV.getTestVector(hw_id, layer, s_meta, d_meta); 
             void *coef = data.hdrCoef;
@@ -469,6 +513,103 @@ TEST_F (CS_01_libhdrTest, CS_01_06_VerifyDataHDR10P) {
     }
 }
 
+TEST_F (CS_01_libhdrTest, CS_01_08_CurveCacheHDR10P) {
+    tInfo = {HAL_DATASPACE_V0_SRGB, 0, 1000, HDR_BPC_10, HDR_CAPA_INNER};
+    Ihdr->setTargetInfo(&tInfo);
+
+    ExynosHdrStaticInfo s_meta;
+    s_meta.sType1.mMaxDisplayLuminance = (1000 * 10000);
+
+    ExynosHdrDynamicInfo d_meta[2];
+    setDynamicMeta(&d_meta[0], 0);
+    setDynamicMeta(&d_meta[1], 1);
+
+    vector<char> first[2];
+    unsigned int hit_before, hit_after, miss;
+
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < 2; i++) {
+            Ihdr->initHdrCoefBuildup(HDR_HW_DPU);
+            Ihdr->setHDRlayer(false);
+            lInfo = {HAL_DATASPACE_BT2020_PQ,// dataspace
+                   &s_meta, sizeof(ExynosHdrStaticInfo),        // static
+                   &d_meta[i], sizeof(ExynosHdrDynamicInfo),    // dynamic
+                   true,                // pre mult
+                   HDR_BPC_10,          // bpc
+                   REND_ORI,            // source
+                   NULL,                // tf_matrix
+                   false};              // bypass
+
+            Ihdr->getCurveCacheStat(&hit_before, &miss);
+            Ihdr->setLayerInfo(0,       //layer
+                    &lInfo);
+            Ihdr->getCurveCacheStat(&hit_after, &miss);
+            Ihdr->getHdrCoefData(HDR_HW_DPU, 0, &data);
+
+            struct hdr_coef_header *header_g = (struct hdr_coef_header *)data.hdrCoef;
+            char *coef = (char *)data.hdrCoef;
+            if (round == 0) {
+                first[i].assign(coef, coef + header_g->total_bytesize);
+            } else {
+                /* the second round is built from the cache only */
+                ASSERT_GT(hit_after, hit_before) << "curve cache not hit for dynamic meta " << i;
+                ASSERT_EQ(first[i].size(), header_g->total_bytesize);
+                ASSERT_EQ(memcmp(first[i].data(), coef, first[i].size()), 0)
+                    << "cached coef differs from synthesized coef for dynamic meta " << i;
+            }
+        }
+    }
+}
+
+TEST_F (CS_01_libhdrTest, CS_01_09_PrecompiledLut) {
+    const std::string lut_dir = "/vendor/etc/dqe/";
+    const std::string blob_dir = "/data/local/tmp/libhdr_lut/";
+    vector<vector<char>> from_xml, from_blob;
+    vector<std::string> blobs;
+
+    /* reference : every lut parsed from xml */
+    delete Ihdr;
+    hdrLutBlob::setEnabled(false);
+    Ihdr = hdrInterface::createInstance();
+    buildCoefData(from_xml);
+
+    /* compile every lut xml on the device into blob_dir */
+    mkdir(blob_dir.c_str(), 0755);
+    DIR *dir = opendir(lut_dir.c_str());
+    ASSERT_NE(dir, (DIR *)NULL);
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL) {
+        std::string name = ent->d_name;
+        if (name.size() < 4 || name.compare(name.size() - 4, 4, ".xml"))
+            continue;
+        std::string xml = lut_dir + name;
+        std::string bin = blob_dir + name.substr(0, name.size() - 4) + ".bin";
+        if (hdrLutCompile(&hw, xml, bin) == HDR_ERR_NO)
+            blobs.push_back(bin);
+    }
+    closedir(dir);
+    ASSERT_FALSE(blobs.empty()) << "no lut compiled from " << lut_dir;
+
+    unsigned int loaded = hdrLutBlob::getNumLoaded();
+    delete Ihdr;
+    hdrLutBlob::setSearchDir(blob_dir);
+    hdrLutBlob::setEnabled(true);
+    Ihdr = hdrInterface::createInstance();
+    buildCoefData(from_blob);
+    ASSERT_GT(hdrLutBlob::getNumLoaded(), loaded) << "no lut loaded from " << blob_dir;
+
+    for (auto &bin : blobs)
+        unlink(bin.c_str());
+    rmdir(blob_dir.c_str());
+
+    ASSERT_EQ(from_xml.size(), from_blob.size());
+    for (int i = 0; i < from_xml.size(); i++) {
+        ASSERT_EQ(from_xml[i].size(), from_blob[i].size()) << "coef size differs, case " << i;
+        ASSERT_EQ(memcmp(from_xml[i].data(), from_blob[i].data(), from_xml[i].size()), 0)
+            << "coef from blob differs from coef from xml, case " << i;
+    }
+}
+
 TEST_F (CS_01_libhdrTest, CS_01_07_RandomSequence) {
     for (int i = 0; i < 500; i++) {
         int idx = rand() % 5;
@@ -14,8 +14,12 @@
  * limitations under the License.
  */
 
+#include <list>
+#include <mutex>
 #include <utility>
 #include <unordered_map>
+#include <unordered_set>
+#include <condition_variable>
 
 #include <log/log.h>
 #include <sys/mman.h>
@@ -38,14 +42,73 @@ using namespace vendor::graphics;
 namespace SBWCHelper
 {
 
+/*
+ * Serializes the public functions over all of the state below, clients call
+ * them from several threads. The decompression itself runs without it, on
+ * AHBs acquired for the call.
+ */
+static std::mutex helperLock;
+
+// YUV AHBs being written by the decompression, one request at a time for each
+static std::unordered_set<AHardwareBuffer*> decoding;
+static std::condition_variable decodeDone;
+
 static std::unordered_map<AHardwareBuffer*, AHardwareBuffer*> yuvToSbwc;
 static std::unordered_map<AHardwareBuffer*, AHardwareBuffer*> sbwcToYuv;
 static std::unordered_map<AHardwareBuffer*, int32_t> ref;
 
 static buffer_handle_t lastSrc, lastDst;
 
+// Content generation decompressed into each registered YUV AHB
+static std::unordered_map<AHardwareBuffer*, uint64_t> decodedGen;
+
+/*
+ * YUV AHBs that are no longer referenced are parked here by the buffer id of
+ * their SBWC AHB instead of being released. The next newYuvAHB() for the same
+ * buffer reuses the allocation and, if the generation still matches, the
+ * decompressed data as well.
+ */
+struct CacheEntry
+{
+	AHardwareBuffer *yuvAHB;
+	bool decoded;
+	uint64_t generation;
+	size_t size;
+	uint64_t lastUse;
+};
+
+// Front is the most recently parked
+static std::list<std::pair<uint64_t, CacheEntry>> cacheLru;
+static std::unordered_map<uint64_t, std::list<std::pair<uint64_t, CacheEntry>>::iterator> cacheMap;
+static size_t cacheBytes;
+
+// Counts the registrations in newYuvAHB(), the clock of CacheEntry::lastUse
+static uint64_t useCount;
+
+struct CacheStats
+{
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t reused;
+	uint64_t evicted;
+};
+
+static CacheStats stats;
+
 static bool debugEnabled = android::base::GetBoolProperty("vendor.sbwchelper.debug.enabled", false);
 static bool traceEnabled = android::base::GetBoolProperty("vendor.sbwchelper.trace.enabled", false);
+// 32 MB unless set, 0 turns the cache off
+static size_t cacheBudget = android::base::GetUintProperty<size_t>("vendor.sbwchelper.cache.budget_kb", 32768) * 1024;
+
+/*
+ * Buffer ids are never reused, and a producer registers its buffers again
+ * every few frames. An id not registered for this many newYuvAHB() calls
+ * belongs to a freed buffer: its entry can not be hit anymore.
+ */
+static constexpr uint64_t cacheMaxIdle = 64;
+
+// Print the cache stats every this many decompress requests when debug is enabled
+static constexpr uint64_t statsPeriod = 300;
 
 /** Check format is 10bit or not
  *
@@ -74,6 +137,8 @@ static uint32_t getAttr(const native_handle_t *handle);
  * @param[in] inYuvAHB YUV AHardwareBuffer will be stored decompressed data
  * @param[in] inSbwcAHB SBWC AHardwareBuffer has source data
  * @return success or fail
+ *
+ * Called without helperLock, it does not touch the state of the helper.
  */
 static bool requestDecompress(AHardwareBuffer *inYuvAHB, AHardwareBuffer *inSbwcAHB);
 
@@ -83,6 +148,40 @@ static bool requestDecompress(AHardwareBuffer *inYuvAHB, AHardwareBuffer *inSbwc
  */
 static bool isRealSbwc(buffer_handle_t handle);
 
+/** Take the parked YUV AHB of the SBWC AHB out of the cache
+ *
+ * @param[in] inSbwcAHB SBWC AHardwareBuffer
+ * @param[out] outYuvAHB YUV AHardwareBuffer parked for inSbwcAHB
+ * @return whether a YUV AHardwareBuffer was found
+ */
+static bool getCachedAHB(AHardwareBuffer *inSbwcAHB, AHardwareBuffer **outYuvAHB);
+
+/** Evict the entries of SBWC AHBs that have been freed
+ */
+static void pruneCachedAHB();
+
+/** Park the YUV AHB of the SBWC AHB in the cache, or release it
+ *
+ * @param[in] inSbwcAHB SBWC AHardwareBuffer
+ * @param[in] inYuvAHB YUV AHardwareBuffer no longer referenced
+ */
+static void putCachedAHB(AHardwareBuffer *inSbwcAHB, AHardwareBuffer *inYuvAHB);
+
+/** Decompress unless the YUV AHB already holds the given generation
+ *
+ * @param[in] inSbwcAHB SBWC AHardwareBuffer
+ * @param[in] hasGeneration whether generation is valid
+ * @param[in] generation content generation of inSbwcAHB
+ * @return success or fail
+ */
+static bool doDecompress(AHardwareBuffer *inSbwcAHB, bool hasGeneration, uint64_t generation);
+
+/** Count a decompress request and export the hit rate
+ *
+ * @param[in] hit whether the decompression was skipped
+ */
+static void updateStats(bool hit);
+
 /** Get GraphicBuffer's id from ExynosGraphicBuffer
  *
  * @param[in] AHardwareBuffer will be used to get id
@@ -192,6 +291,8 @@ bool newYuvAHB(AHardwareBuffer *inSbwcAHB, AHardwareBuffer **outYuvAHB)
 		return false;
 	}
 
+	std::lock_guard<std::mutex> lock(helperLock);
+
 	if (sbwcToYuv.count(inSbwcAHB) > 0)
 	{
 		AHardwareBuffer *yuvAHB = sbwcToYuv.at(inSbwcAHB);
@@ -210,9 +311,10 @@ bool newYuvAHB(AHardwareBuffer *inSbwcAHB, AHardwareBuffer **outYuvAHB)
 		return true;
 	}
 
-	// Allocate AHB per every request now
-	// To do: Make more efficiently
-	result = allocAHB(inSbwcAHB, &yuvAHB);
+	if (!getCachedAHB(inSbwcAHB, &yuvAHB))
+	{
+		result = allocAHB(inSbwcAHB, &yuvAHB);
+	}
 
 	if (result != android::NO_ERROR)
 	{
@@ -224,7 +326,7 @@ bool newYuvAHB(AHardwareBuffer *inSbwcAHB, AHardwareBuffer **outYuvAHB)
 	yuvToSbwc.insert({yuvAHB, inSbwcAHB});
 	sbwcToYuv.insert({inSbwcAHB, yuvAHB});
 
-	ref.insert({yuvAHB, 1});
+	ref[yuvAHB] = 1;
 
 	*outYuvAHB = yuvAHB;
 
@@ -249,6 +351,16 @@ bool newYuvAHB(AHardwareBuffer *inSbwcAHB, AHardwareBuffer **outYuvAHB)
 }
 
 bool decompress(AHardwareBuffer *inSbwcAHB)
+{
+	return doDecompress(inSbwcAHB, false, 0);
+}
+
+bool decompress(AHardwareBuffer *inSbwcAHB, uint64_t generation)
+{
+	return doDecompress(inSbwcAHB, true, generation);
+}
+
+static bool doDecompress(AHardwareBuffer *inSbwcAHB, bool hasGeneration, uint64_t generation)
 {
 	if (traceEnabled)
 	{
@@ -270,16 +382,104 @@ bool decompress(AHardwareBuffer *inSbwcAHB)
 		ALOGD("[SBWC] %s: inSbwcAHB: %p", __func__, inSbwcAHB);
 	}
 
-	if (sbwcToYuv.count(inSbwcAHB) <= 0)
+	std::unique_lock<std::mutex> lock(helperLock);
+	AHardwareBuffer *yuvAHB;
+
+	// The previous request on the same YUV AHB finishes first
+	for (;;)
 	{
-		ALOGE("[SBWC] %s: Invalid value \"Not registered SBWC AHB\" AHB: %p %s:%d",
-				__func__, inSbwcAHB, __FILE__, __LINE__);
-		return false;
+		if (sbwcToYuv.count(inSbwcAHB) <= 0)
+		{
+			ALOGE("[SBWC] %s: Invalid value \"Not registered SBWC AHB\" AHB: %p %s:%d",
+					__func__, inSbwcAHB, __FILE__, __LINE__);
+			return false;
+		}
+
+		yuvAHB = sbwcToYuv.at(inSbwcAHB);
+
+		if (decoding.count(yuvAHB) == 0)
+		{
+			break;
+		}
+
+		decodeDone.wait(lock);
+	}
+
+	if (hasGeneration)
+	{
+		auto it = decodedGen.find(yuvAHB);
+
+		if ((it != decodedGen.end()) && (it->second == generation))
+		{
+			if (debugEnabled)
+			{
+				ALOGD("[SBWC] %s: Skip decompress of generation %" PRIu64 " AHB: %p",
+						__func__, generation, inSbwcAHB);
+			}
+
+			updateStats(true);
+
+			return true;
+		}
+	}
+
+	const native_handle_t *yuvHandle = AHardwareBuffer_getNativeHandle(yuvAHB);
+	const native_handle_t *sbwcHandle = AHardwareBuffer_getNativeHandle(inSbwcAHB);
+
+	if ((lastSrc == yuvHandle) && (lastDst == sbwcHandle))
+	{
+		if (debugEnabled)
+		{
+			ALOGD("[SBWC] Skip decompress because same request");
+		}
+
+		updateStats(true);
+
+		return true;
+	}
+
+	decodedGen.erase(yuvAHB);
+	decoding.insert(yuvAHB);
+
+	// Neither can be released by freeYuvAHB() or the cache while written
+	AHardwareBuffer_acquire(yuvAHB);
+	AHardwareBuffer_acquire(inSbwcAHB);
+
+	lock.unlock();
+
+	bool result = requestDecompress(yuvAHB, inSbwcAHB);
+
+	lock.lock();
+
+	decoding.erase(yuvAHB);
+	updateStats(false);
+
+	auto registered = sbwcToYuv.find(inSbwcAHB);
+
+	if (result && (registered != sbwcToYuv.end()) && (registered->second == yuvAHB))
+	{
+		lastSrc = yuvHandle;
+		lastDst = sbwcHandle;
+
+		if (hasGeneration)
+		{
+			decodedGen[yuvAHB] = generation;
+		}
+	}
+	else
+	{
+		// Failed, or freed while written: the YUV AHB content is unknown
+		lastSrc = lastDst = 0;
 	}
 
-	AHardwareBuffer *yuvAHB = sbwcToYuv.at(inSbwcAHB);
+	decodeDone.notify_all();
+
+	lock.unlock();
+
+	AHardwareBuffer_release(inSbwcAHB);
+	AHardwareBuffer_release(yuvAHB);
 
-	return requestDecompress(yuvAHB, inSbwcAHB);
+	return result;
 }
 
 // To do: Deferred free
@@ -302,6 +502,8 @@ bool freeYuvAHB(AHardwareBuffer **inYuvAHB)
 		return false;
 	}
 
+	std::lock_guard<std::mutex> lock(helperLock);
+
 	if ((yuvToSbwc.count(*inYuvAHB) == 0) || (ref.at(*inYuvAHB) <= 0))
 	{
 		ALOGE("[SBWC] %s: Invalid value \"Not registered YUV AHB\" %s:%d",
@@ -338,7 +540,9 @@ bool freeYuvAHB(AHardwareBuffer **inYuvAHB)
 				__func__, *inYuvAHB);
 	}
 
-	AHardwareBuffer_release(*inYuvAHB);
+	ref.erase(*inYuvAHB);
+
+	putCachedAHB(sbwcAHB, *inYuvAHB);
 	AHardwareBuffer_release(sbwcAHB);
 
 	*inYuvAHB = nullptr;
@@ -394,6 +598,8 @@ AHardwareBuffer *newYuvAHB(AHardwareBuffer *sbwcAHB)
 		return nullptr;
 	}
 
+	std::lock_guard<std::mutex> lock(helperLock);
+
 	if (sbwcToYuv.count(sbwcAHB) > 0)
 	{
 		AHardwareBuffer *yuvAHB = sbwcToYuv.at(sbwcAHB);
@@ -410,9 +616,10 @@ AHardwareBuffer *newYuvAHB(AHardwareBuffer *sbwcAHB)
 		return yuvAHB;
 	}
 
-	// Allocate AHB per every request now
-	// To do: Make more efficiently
-	result = allocAHB(sbwcAHB, &yuvAHB);
+	if (!getCachedAHB(sbwcAHB, &yuvAHB))
+	{
+		result = allocAHB(sbwcAHB, &yuvAHB);
+	}
 
 	if (result != android::NO_ERROR)
 	{
@@ -424,7 +631,7 @@ AHardwareBuffer *newYuvAHB(AHardwareBuffer *sbwcAHB)
 	yuvToSbwc.insert({yuvAHB, sbwcAHB});
 	sbwcToYuv.insert({sbwcAHB, yuvAHB});
 
-	ref.insert({yuvAHB, 1});
+	ref[yuvAHB] = 1;
 
 	if (debugEnabled)
 	{
@@ -460,6 +667,8 @@ bool freeYuvAHB(AHardwareBuffer *yuvAHB)
 		return false;
 	}
 
+	std::lock_guard<std::mutex> lock(helperLock);
+
 	if ((yuvToSbwc.count(yuvAHB) == 0) || (ref.at(yuvAHB) <= 0))
 	{
 		ALOGE("[SBWC] %s: Invalid value \"Not registered YUV AHB: %p\" %s:%d",
@@ -494,7 +703,9 @@ bool freeYuvAHB(AHardwareBuffer *yuvAHB)
 		ALOGD("[SBWC] %s: Deleted YUV AHB: %p", __func__, yuvAHB);
 	}
 
-	AHardwareBuffer_release(yuvAHB);
+	ref.erase(yuvAHB);
+
+	putCachedAHB(sbwcAHB, yuvAHB);
 	AHardwareBuffer_release(sbwcAHB);
 
 	if ((sbwcToYuv.size() == 0) && (yuvToSbwc.size() == 0)) {
@@ -599,40 +810,37 @@ static bool requestDecompress(AHardwareBuffer *inYuvAHB, AHardwareBuffer *inSbwc
 	android::hardware::hidl_handle yuvHidlHandle(yuvHandle);
 	android::hardware::hidl_handle sbwcHidlHandle(sbwcHandle);
 
+	static std::mutex serviceLock;
 	static android::sp<ISbwcDecompService> sbwcDecompService = nullptr;
+	android::sp<ISbwcDecompService> service;
 
-	if ((lastSrc == yuvHandle) && (lastDst == sbwcHandle)) {
-		if (debugEnabled) {
-			ALOGD("[SBWC] Skip decompress because same request");
-		}
-		return true;
-	}
-
-	if (sbwcDecompService == nullptr)
 	{
-		sbwcDecompService = ISbwcDecompService::getService();
+		std::lock_guard<std::mutex> lock(serviceLock);
+
 		if (sbwcDecompService == nullptr)
 		{
-			ALOGE("[SBWC] %s: \"SbwcDecompService getting failed\" %s:%d",
-					__func__, __FILE__, __LINE__);
-			return false;
+			sbwcDecompService = ISbwcDecompService::getService();
+			if (sbwcDecompService == nullptr)
+			{
+				ALOGE("[SBWC] %s: \"SbwcDecompService getting failed\" %s:%d",
+						__func__, __FILE__, __LINE__);
+				return false;
+			}
 		}
+
+		service = sbwcDecompService;
 	}
 
 	uint32_t attr = getAttr(yuvHandle);
-	uint32_t result = sbwcDecompService->decode(sbwcHidlHandle, yuvHidlHandle, attr);
+	uint32_t result = service->decode(sbwcHidlHandle, yuvHidlHandle, attr);
 
 	if (result != android::NO_ERROR)
 	{
 		ALOGE("[SBWC] %s: \"SbwcDecompService decompression failed\" %s:%d",
 					__func__, __FILE__, __LINE__);
-		lastSrc = lastDst = 0;
 		return false;
 	}
 
-	lastSrc = yuvHandle;
-	lastDst = sbwcHandle;
-
 	if (debugEnabled)
 	{
 		const native_handle_t *handle = AHardwareBuffer_getNativeHandle(inSbwcAHB);
@@ -659,4 +867,165 @@ static bool requestDecompress(AHardwareBuffer *inYuvAHB, AHardwareBuffer *inSbwc
 	return true;
 }
 
+static size_t getAllocSize(AHardwareBuffer *inAHB)
+{
+	const native_handle_t *handle = AHardwareBuffer_getNativeHandle(inAHB);
+	size_t size = 0;
+
+	if (handle == nullptr)
+	{
+		return 0;
+	}
+
+	for (int i = 0; i < ExynosGraphicBufferMeta::get_num_image_fds(handle); i++)
+	{
+		size += ExynosGraphicBufferMeta::get_size(handle, i);
+	}
+
+	return size;
+}
+
+static void evictCachedAHB(std::list<std::pair<uint64_t, CacheEntry>>::iterator it)
+{
+	AHardwareBuffer *yuvAHB = it->second.yuvAHB;
+
+	if (lastSrc == AHardwareBuffer_getNativeHandle(yuvAHB))
+	{
+		lastSrc = lastDst = 0;
+	}
+
+	if (debugEnabled)
+	{
+		ALOGD("[SBWC] %s: Evicted YUV AHB: %p id: %" PRIu64 " size: %zu",
+				__func__, yuvAHB, it->first, it->second.size);
+	}
+
+	cacheBytes -= it->second.size;
+	cacheMap.erase(it->first);
+	cacheLru.erase(it);
+
+	stats.evicted++;
+
+	AHardwareBuffer_release(yuvAHB);
+}
+
+static void pruneCachedAHB()
+{
+	// The back was parked first, so it was used first
+	while (!cacheLru.empty() && (cacheLru.back().second.lastUse + cacheMaxIdle < useCount))
+	{
+		evictCachedAHB(std::prev(cacheLru.end()));
+	}
+}
+
+static bool getCachedAHB(AHardwareBuffer *inSbwcAHB, AHardwareBuffer **outYuvAHB)
+{
+	useCount++;
+	pruneCachedAHB();
+
+	auto it = cacheMap.find(getId(inSbwcAHB));
+
+	if (it == cacheMap.end())
+	{
+		return false;
+	}
+
+	CacheEntry entry = it->second->second;
+
+	cacheBytes -= entry.size;
+	cacheLru.erase(it->second);
+	cacheMap.erase(it);
+
+	if (entry.decoded)
+	{
+		decodedGen[entry.yuvAHB] = entry.generation;
+	}
+
+	*outYuvAHB = entry.yuvAHB;
+
+	stats.reused++;
+
+	if (debugEnabled)
+	{
+		ALOGD("[SBWC] %s: Reused YUV AHB: %p for SBWC AHB: %p",
+				__func__, entry.yuvAHB, inSbwcAHB);
+	}
+
+	return true;
+}
+
+static void putCachedAHB(AHardwareBuffer *inSbwcAHB, AHardwareBuffer *inYuvAHB)
+{
+	// The SBWC AHB may be freed by the caller and its handle reused
+	if (lastDst == AHardwareBuffer_getNativeHandle(inSbwcAHB))
+	{
+		lastSrc = lastDst = 0;
+	}
+
+	CacheEntry entry = { inYuvAHB, false, 0, getAllocSize(inYuvAHB), useCount };
+	auto gen = decodedGen.find(inYuvAHB);
+
+	if (gen != decodedGen.end())
+	{
+		entry.decoded = true;
+		entry.generation = gen->second;
+		decodedGen.erase(gen);
+	}
+
+	uint64_t id = getId(inSbwcAHB);
+
+	if ((entry.size == 0) || (entry.size > cacheBudget) || (id == static_cast<uint64_t>(-1)))
+	{
+		AHardwareBuffer_release(inYuvAHB);
+		return;
+	}
+
+	auto old = cacheMap.find(id);
+	if (old != cacheMap.end())
+	{
+		evictCachedAHB(old->second);
+	}
+
+	cacheLru.emplace_front(id, entry);
+	cacheMap[id] = cacheLru.begin();
+	cacheBytes += entry.size;
+
+	while (cacheBytes > cacheBudget)
+	{
+		evictCachedAHB(std::prev(cacheLru.end()));
+	}
+
+	if (traceEnabled)
+	{
+		ATRACE_INT64("SBWCHelper cache bytes", cacheBytes);
+	}
+}
+
+static void updateStats(bool hit)
+{
+	if (hit)
+	{
+		stats.hits++;
+	}
+	else
+	{
+		stats.misses++;
+	}
+
+	uint64_t total = stats.hits + stats.misses;
+
+	if (traceEnabled)
+	{
+		ATRACE_INT("SBWCHelper hit rate", static_cast<int32_t>(stats.hits * 100 / total));
+	}
+
+	if (debugEnabled && ((total % statsPeriod) == 0))
+	{
+		ALOGD("[SBWC] %s: hit: %" PRIu64 " miss: %" PRIu64 " (%" PRIu64 "%%) reused: %" PRIu64
+				" evicted: %" PRIu64 " cached: %zu/%zu bytes",
+				__func__, stats.hits, stats.misses, stats.hits * 100 / total,
+				stats.reused, stats.evicted, cacheBytes, cacheBudget);
+	}
+}
+
 } // namespace SBWCHelper
@@ -46,6 +46,21 @@ bool newYuvAHB(AHardwareBuffer *inSbwcAHB, AHardwareBuffer **outYuvAHB);
  */
 bool decompress(AHardwareBuffer *inSbwcAHB);
 
+/** Request decompress to SBWCHelper for a known content generation
+ *
+ * The decompression is skipped when the YUV buffer already holds the result
+ * of the same generation of inSbwcAHB. This includes a YUV buffer reused
+ * after freeYuvAHB() from the cache, sized by vendor.sbwchelper.cache.budget_kb
+ * (32 MB by default, 0 turns it off). Consumers that sample a buffer more
+ * than once per frame, e.g. GPU composition, should use this one.
+ *
+ * @param[in] inSbwcAHB The buffer to decompress
+ * @param[in] generation Content generation of inSbwcAHB, e.g. frame number.
+ *            It must change whenever the producer writes the buffer.
+ * @return result
+ */
+bool decompress(AHardwareBuffer *inSbwcAHB, uint64_t generation);
+
 /** Inform SBWCHelper that you are no longer using YUV AHB to avoid memory leak
  *
  * @param[in] Double pointer of the buffer want to free
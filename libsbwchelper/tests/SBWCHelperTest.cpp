@@ -15,9 +15,12 @@
  */
 
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include <log/log.h>
 #include <gtest/gtest.h>
+#include <android-base/properties.h>
 #include <ui/GraphicBuffer.h>
 #include <vndk/hardware_buffer.h>
 
@@ -317,6 +320,119 @@ TEST(SBWCHelperTest, DecompressWithSbwc10BitRegistered)
 	EXPECT_TRUE(SBWCHelper::freeYuvAHB(&yuvAHB));
 }
 
+TEST(SBWCHelperTest, DecompressWithGeneration)
+{
+	printTestName();
+
+	sp<GraphicBuffer> sbwcGB = newFHDGB(HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_SBWC);
+	AHardwareBuffer *sbwcAHB = sbwcGB->toAHardwareBuffer();
+
+	AHardwareBuffer *yuvAHB = nullptr;
+	EXPECT_TRUE(SBWCHelper::newYuvAHB(sbwcAHB, &yuvAHB));
+
+	EXPECT_TRUE(SBWCHelper::decompress(sbwcAHB, 1));
+	EXPECT_TRUE(SBWCHelper::decompress(sbwcAHB, 1));
+	EXPECT_TRUE(SBWCHelper::decompress(sbwcAHB, 2));
+
+	EXPECT_TRUE(SBWCHelper::freeYuvAHB(&yuvAHB));
+
+	EXPECT_FALSE(SBWCHelper::decompress(sbwcAHB, 2));
+}
+
+TEST(SBWCHelperTest, NewYuvAHBReusedAfterFree)
+{
+	printTestName();
+
+	if (android::base::GetUintProperty<size_t>("vendor.sbwchelper.cache.budget_kb", 32768) == 0)
+	{
+		GTEST_SKIP() << "The cache is disabled";
+	}
+
+	sp<GraphicBuffer> sbwcGB = newFHDGB(HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_SBWC);
+	AHardwareBuffer *sbwcAHB = sbwcGB->toAHardwareBuffer();
+
+	AHardwareBuffer *yuvAHB = nullptr;
+	EXPECT_TRUE(SBWCHelper::newYuvAHB(sbwcAHB, &yuvAHB));
+	EXPECT_TRUE(SBWCHelper::decompress(sbwcAHB, 1));
+
+	AHardwareBuffer *firstAHB = yuvAHB;
+	EXPECT_TRUE(SBWCHelper::freeYuvAHB(&yuvAHB));
+
+	EXPECT_TRUE(SBWCHelper::newYuvAHB(sbwcAHB, &yuvAHB));
+	EXPECT_TRUE(yuvAHB == firstAHB);
+	EXPECT_TRUE(SBWCHelper::decompress(sbwcAHB, 1));
+
+	EXPECT_TRUE(SBWCHelper::freeYuvAHB(&yuvAHB));
+}
+
+TEST(SBWCHelperTest, NewYuvAHBNotReusedAfterIdle)
+{
+	printTestName();
+
+	if (android::base::GetUintProperty<size_t>("vendor.sbwchelper.cache.budget_kb", 32768) == 0)
+	{
+		GTEST_SKIP() << "The cache is disabled";
+	}
+
+	sp<GraphicBuffer> sbwcGB = newFHDGB(HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_SBWC);
+	AHardwareBuffer *sbwcAHB = sbwcGB->toAHardwareBuffer();
+	sp<GraphicBuffer> otherGB = newFHDGB(HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_SBWC);
+	AHardwareBuffer *otherAHB = otherGB->toAHardwareBuffer();
+
+	AHardwareBuffer *yuvAHB = nullptr;
+	EXPECT_TRUE(SBWCHelper::newYuvAHB(sbwcAHB, &yuvAHB));
+
+	AHardwareBuffer *firstAHB = yuvAHB;
+	EXPECT_TRUE(SBWCHelper::freeYuvAHB(&yuvAHB));
+
+	// Only the other buffer is used for a while, as if the first one was freed
+	for (int i = 0; i < 100; i++)
+	{
+		EXPECT_TRUE(SBWCHelper::newYuvAHB(otherAHB, &yuvAHB));
+		EXPECT_TRUE(SBWCHelper::freeYuvAHB(&yuvAHB));
+	}
+
+	EXPECT_TRUE(SBWCHelper::newYuvAHB(sbwcAHB, &yuvAHB));
+	EXPECT_TRUE(yuvAHB != firstAHB);
+
+	EXPECT_TRUE(SBWCHelper::freeYuvAHB(&yuvAHB));
+}
+
+TEST(SBWCHelperTest, DecompressFromThreads)
+{
+	printTestName();
+
+	std::vector<sp<GraphicBuffer>> sbwcGBs;
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < 4; i++)
+	{
+		sbwcGBs.push_back(newFHDGB(HAL_PIXEL_FORMAT_EXYNOS_YCbCr_420_SP_M_SBWC));
+	}
+
+	// Two threads per buffer, as a compositor and a recorder sampling the same frames
+	for (int i = 0; i < 8; i++)
+	{
+		AHardwareBuffer *sbwcAHB = sbwcGBs[i % 4]->toAHardwareBuffer();
+
+		threads.emplace_back([sbwcAHB]() {
+			for (uint64_t frame = 0; frame < 30; frame++)
+			{
+				AHardwareBuffer *yuvAHB = nullptr;
+
+				EXPECT_TRUE(SBWCHelper::newYuvAHB(sbwcAHB, &yuvAHB));
+				EXPECT_TRUE(SBWCHelper::decompress(sbwcAHB, frame));
+				EXPECT_TRUE(SBWCHelper::freeYuvAHB(&yuvAHB));
+			}
+		});
+	}
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+}
+
 TEST(SBWCHelperTest, FreeYuvAHBWithNull)
 {
 	printTestName();
@@ -5,7 +5,8 @@ include $(CLEAR_VARS)
 LOCAL_MODULE_TAGS := optional
 
 LOCAL_SRC_FILES := \
-	swconvertor.c
+	swconvertor.c \
+	swconvertor_simd.c
 
 ifeq ($(TARGET_ARCH), arm)
 ifeq ($(ARCH_ARM_HAVE_NEON),true)
@@ -50,3 +51,24 @@ LOCAL_SHARED_LIBRARIES := liblog
 LOCAL_CFLAGS += -Wno-unused-variable -Wno-unused-function
 
 include $(BUILD_STATIC_LIBRARY)
+
+# swconverter_bench [iterations]
+# C vs NEON/SSE2 throughput of the csc kernels, fails on any output mismatch
+include $(CLEAR_VARS)
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_SRC_FILES := \
+	bench/swconverter_bench.c \
+	swconvertor.c \
+	swconvertor_simd.c
+
+LOCAL_C_INCLUDES := \
+	$(LOCAL_PATH) \
+	$(LOCAL_PATH)/../include
+
+LOCAL_MODULE := swconverter_bench
+
+LOCAL_CFLAGS += -Werror -Wno-unused-variable -Wno-unused-function
+
+include $(BUILD_HOST_EXECUTABLE)
@@ -0,0 +1,195 @@
+/*
+ *
+ * Copyright 2012 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    swconverter_bench.c
+ *
+ * @brief   compares the C and the vector path of libswconverter
+ *          prints MPix/s of both and fails if the outputs differ
+ *
+ *   swconverter_bench [iterations]
+ *
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "swconverter.h"
+#include "swconverter_simd.h"
+
+enum {
+    BENCH_RGB565_YUV420P,
+    BENCH_RGB565_YUV420SP,
+    BENCH_BGRA8888_YUV420P,
+    BENCH_BGRA8888_YUV420SP,
+    BENCH_RGBA8888_YUV420P,
+    BENCH_RGBA8888_YUV420SP,
+    BENCH_INTERLEAVE,
+    BENCH_DEINTERLEAVE,
+    BENCH_MAX,
+};
+
+static const char *bench_name[BENCH_MAX] = {
+    "RGB565_to_YUV420P",
+    "RGB565_to_YUV420SP",
+    "BGRA8888_to_YUV420P",
+    "BGRA8888_to_YUV420SP",
+    "RGBA8888_to_YUV420P",
+    "RGBA8888_to_YUV420SP",
+    "interleave_memcpy",
+    "deinterleave_memcpy",
+};
+
+struct bench_buf {
+    unsigned char *src;
+    unsigned char *dst;
+    size_t src_size;
+    size_t dst_size;
+};
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void run(int kernel, struct bench_buf *buf, unsigned int w, unsigned int h)
+{
+    unsigned char *y = buf->dst;
+    unsigned char *u = y + (size_t)w * h;
+    unsigned char *v = u + (size_t)((w + 1) / 2) * ((h + 1) / 2);
+    unsigned int chroma = (w / 2) * (h / 2);
+
+    switch (kernel) {
+    case BENCH_RGB565_YUV420P:
+        csc_RGB565_to_YUV420P(y, u, v, buf->src, w, h);
+        break;
+    case BENCH_RGB565_YUV420SP:
+        csc_RGB565_to_YUV420SP(y, u, buf->src, w, h);
+        break;
+    case BENCH_BGRA8888_YUV420P:
+        csc_BGRA8888_to_YUV420P(y, u, v, buf->src, w, h);
+        break;
+    case BENCH_BGRA8888_YUV420SP:
+        csc_BGRA8888_to_YUV420SP(y, u, buf->src, w, h);
+        break;
+    case BENCH_RGBA8888_YUV420P:
+        csc_RGBA8888_to_YUV420P(y, u, v, buf->src, w, h);
+        break;
+    case BENCH_RGBA8888_YUV420SP:
+        csc_RGBA8888_to_YUV420SP(y, u, buf->src, w, h);
+        break;
+    case BENCH_INTERLEAVE:
+        /* a NV12 chroma plane built from two planar ones */
+        csc_interleave_memcpy(buf->dst, buf->src, buf->src + chroma, chroma);
+        break;
+    case BENCH_DEINTERLEAVE:
+        csc_deinterleave_memcpy(buf->dst, buf->dst + chroma, buf->src, chroma * 2);
+        break;
+    }
+}
+
+/* runs one kernel with both paths, returns 0 if the outputs are equal */
+static int bench(int kernel, unsigned int w, unsigned int h, int iter, int report)
+{
+    struct bench_buf buf;
+    unsigned char *ref;
+    double t, mpix[2];
+    int simd, i, ret = 0;
+
+    buf.src_size = (size_t)w * h * 4;
+    buf.dst_size = (size_t)w * h * 2 + 64;
+    buf.src = malloc(buf.src_size);
+    buf.dst = malloc(buf.dst_size);
+    ref = malloc(buf.dst_size);
+    if (buf.src == NULL || buf.dst == NULL || ref == NULL) {
+        fprintf(stderr, "out of memory(%ux%u)\n", w, h);
+        free(buf.src);
+        free(buf.dst);
+        free(ref);
+        return -1;
+    }
+
+    srand(w * 31 + h);
+    for (i = 0; i < (int)buf.src_size; i++)
+        buf.src[i] = rand() & 0xFF;
+
+    for (simd = 0; simd < 2; simd++) {
+        csc_simd_enable(simd);
+        memset(buf.dst, 0xA5, buf.dst_size);
+        run(kernel, &buf, w, h);
+        if (simd == 0)
+            memcpy(ref, buf.dst, buf.dst_size);
+        else if (memcmp(ref, buf.dst, buf.dst_size)) {
+            fprintf(stderr, "MISMATCH %s %ux%u\n", bench_name[kernel], w, h);
+            ret = -1;
+        }
+
+        if (report) {
+            t = now_sec();
+            for (i = 0; i < iter; i++)
+                run(kernel, &buf, w, h);
+            t = now_sec() - t;
+            mpix[simd] = ((double)w * h * iter) / (t * 1e6);
+        }
+    }
+
+    if (report)
+        printf("%-22s %5ux%-5u c %8.1f  %-7s %8.1f MPix/s  x%.2f\n",
+                bench_name[kernel], w, h, mpix[0], CSC_SIMD_NAME, mpix[1], mpix[1] / mpix[0]);
+
+    free(buf.src);
+    free(buf.dst);
+    free(ref);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    static const unsigned int sizes[][2] = {
+        { 1280,  720 },
+        { 1920, 1080 },
+        { 3840, 2160 },
+        { 7680, 4320 },
+    };
+    /* widths that end in every tail length of the 16 pixel loop */
+    static const unsigned int odd_sizes[][2] = {
+        { 1, 1 }, { 2, 2 }, { 15, 3 }, { 17, 5 }, { 31, 7 }, { 33, 9 }, { 177, 101 }, { 1918, 1081 },
+    };
+    int iter = (argc > 1) ? atoi(argv[1]) : 10;
+    int kernel, fail = 0;
+    unsigned int i;
+
+    if (iter < 1)
+        iter = 1;
+
+    printf("simd backend : %s, supported : %d\n", CSC_SIMD_NAME, csc_simd_supported());
+
+    for (kernel = 0; kernel < BENCH_MAX; kernel++) {
+        for (i = 0; i < sizeof(odd_sizes) / sizeof(odd_sizes[0]); i++)
+            fail |= bench(kernel, odd_sizes[i][0], odd_sizes[i][1], 0, 0);
+        for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+            fail |= bench(kernel, sizes[i][0], sizes[i][1], (sizes[i][0] > 3840) ? 1 + iter / 4 : iter, 1);
+    }
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,281 @@
+/*
+ *
+ * Copyright 2012 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    swconverter_simd.h
+ *
+ * @brief   128bit vector abstraction for the csc kernels
+ *          NEON(arm, arm64), SSE2(x86, x86_64) or plain C
+ *
+ * @version 1.0
+ */
+
+#ifndef SWCONVERTER_SIMD_H_
+#define SWCONVERTER_SIMD_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CSC_SIMD_NEON
+#define CSC_SIMD_NAME "neon"
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CSC_SIMD_SSE2
+#define CSC_SIMD_NAME "sse2"
+#else
+#define CSC_SIMD_GENERIC
+#define CSC_SIMD_NAME "generic"
+#endif
+
+/*
+ * csc_u8x16 : 16 x uint8
+ * csc_u16x8 : 8 x uint16, also used as int16 by csc_sra_u16()
+ */
+#if defined(CSC_SIMD_NEON)
+typedef uint8x16_t csc_u8x16;
+typedef uint16x8_t csc_u16x8;
+
+#define csc_load_u8x16(p)           vld1q_u8(p)
+#define csc_store_u8x16(p, v)       vst1q_u8(p, v)
+#define csc_store_half_u8x16(p, v)  vst1_u8(p, vget_low_u8(v))
+#define csc_load_u16x8(p)           vld1q_u16((const uint16_t *)(p))
+#define csc_store_u16x8(p, v)       vst1q_u8(p, vreinterpretq_u8_u16(v))
+#define csc_dup_u16(n)              vdupq_n_u16(n)
+#define csc_add_u16(a, b)           vaddq_u16(a, b)
+#define csc_sub_u16(a, b)           vsubq_u16(a, b)
+#define csc_mul_u16(a, n)           vmulq_n_u16(a, n)
+#define csc_and_u16(a, n)           vandq_u16(a, vdupq_n_u16(n))
+#define csc_or_u16(a, b)            vorrq_u16(a, b)
+#define csc_shl_u16(a, n)           vshlq_n_u16(a, n)
+#define csc_shr_u16(a, n)           vshrq_n_u16(a, n)
+#define csc_sra_u16(a, n)           vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(a), n))
+#define csc_widen_lo(v)             vmovl_u8(vget_low_u8(v))
+#define csc_widen_hi(v)             vmovl_u8(vget_high_u8(v))
+#define csc_even_u8(v)              vandq_u16(vreinterpretq_u16_u8(v), vdupq_n_u16(0xFF))
+#define csc_odd_u8(v)               vshrq_n_u16(vreinterpretq_u16_u8(v), 8)
+#define csc_narrow(lo, hi)          vcombine_u8(vmovn_u16(lo), vmovn_u16(hi))
+
+static inline void csc_load2_u8x16(const uint8_t *p, csc_u8x16 *a, csc_u8x16 *b)
+{
+    uint8x16x2_t v = vld2q_u8(p);
+    *a = v.val[0];
+    *b = v.val[1];
+}
+
+static inline void csc_store2_u8x16(uint8_t *p, csc_u8x16 a, csc_u8x16 b)
+{
+    uint8x16x2_t v;
+    v.val[0] = a;
+    v.val[1] = b;
+    vst2q_u8(p, v);
+}
+
+static inline void csc_load4_u8x16(const uint8_t *p, csc_u8x16 c[4])
+{
+    uint8x16x4_t v = vld4q_u8(p);
+    c[0] = v.val[0];
+    c[1] = v.val[1];
+    c[2] = v.val[2];
+    c[3] = v.val[3];
+}
+
+#elif defined(CSC_SIMD_SSE2)
+typedef __m128i csc_u8x16;
+typedef __m128i csc_u16x8;
+
+#define csc_load_u8x16(p)           _mm_loadu_si128((const __m128i *)(p))
+#define csc_store_u8x16(p, v)       _mm_storeu_si128((__m128i *)(p), v)
+#define csc_store_half_u8x16(p, v)  _mm_storel_epi64((__m128i *)(p), v)
+#define csc_load_u16x8(p)           _mm_loadu_si128((const __m128i *)(p))
+#define csc_store_u16x8(p, v)       _mm_storeu_si128((__m128i *)(p), v)
+#define csc_dup_u16(n)              _mm_set1_epi16((short)(n))
+#define csc_add_u16(a, b)           _mm_add_epi16(a, b)
+#define csc_sub_u16(a, b)           _mm_sub_epi16(a, b)
+#define csc_mul_u16(a, n)           _mm_mullo_epi16(a, _mm_set1_epi16((short)(n)))
+#define csc_and_u16(a, n)           _mm_and_si128(a, _mm_set1_epi16((short)(n)))
+#define csc_or_u16(a, b)            _mm_or_si128(a, b)
+#define csc_shl_u16(a, n)           _mm_slli_epi16(a, n)
+#define csc_shr_u16(a, n)           _mm_srli_epi16(a, n)
+#define csc_sra_u16(a, n)           _mm_srai_epi16(a, n)
+#define csc_widen_lo(v)             _mm_unpacklo_epi8(v, _mm_setzero_si128())
+#define csc_widen_hi(v)             _mm_unpackhi_epi8(v, _mm_setzero_si128())
+#define csc_even_u8(v)              _mm_and_si128(v, _mm_set1_epi16(0xFF))
+#define csc_odd_u8(v)               _mm_srli_epi16(v, 8)
+/* every lane is already in 0 ~ 255, so the saturation never kicks in */
+#define csc_narrow(lo, hi)          _mm_packus_epi16(lo, hi)
+
+static inline void csc_load2_u8x16(const uint8_t *p, csc_u8x16 *a, csc_u8x16 *b)
+{
+    __m128i v0 = csc_load_u8x16(p);
+    __m128i v1 = csc_load_u8x16(p + 16);
+    *a = _mm_packus_epi16(csc_even_u8(v0), csc_even_u8(v1));
+    *b = _mm_packus_epi16(csc_odd_u8(v0), csc_odd_u8(v1));
+}
+
+static inline void csc_store2_u8x16(uint8_t *p, csc_u8x16 a, csc_u8x16 b)
+{
+    csc_store_u8x16(p, _mm_unpacklo_epi8(a, b));
+    csc_store_u8x16(p + 16, _mm_unpackhi_epi8(a, b));
+}
+
+static inline __m128i csc_sse2_channel(__m128i v0, __m128i v1, __m128i v2, __m128i v3, int shift)
+{
+    __m128i mask = _mm_set1_epi32(0xFF);
+    __m128i c0 = _mm_and_si128(_mm_srli_epi32(v0, shift), mask);
+    __m128i c1 = _mm_and_si128(_mm_srli_epi32(v1, shift), mask);
+    __m128i c2 = _mm_and_si128(_mm_srli_epi32(v2, shift), mask);
+    __m128i c3 = _mm_and_si128(_mm_srli_epi32(v3, shift), mask);
+    return _mm_packus_epi16(_mm_packs_epi32(c0, c1), _mm_packs_epi32(c2, c3));
+}
+
+static inline void csc_load4_u8x16(const uint8_t *p, csc_u8x16 c[4])
+{
+    __m128i v0 = csc_load_u8x16(p);
+    __m128i v1 = csc_load_u8x16(p + 16);
+    __m128i v2 = csc_load_u8x16(p + 32);
+    __m128i v3 = csc_load_u8x16(p + 48);
+    c[0] = csc_sse2_channel(v0, v1, v2, v3, 0);
+    c[1] = csc_sse2_channel(v0, v1, v2, v3, 8);
+    c[2] = csc_sse2_channel(v0, v1, v2, v3, 16);
+    c[3] = csc_sse2_channel(v0, v1, v2, v3, 24);
+}
+
+#else /* CSC_SIMD_GENERIC */
+typedef struct { uint8_t v[16]; } csc_u8x16;
+typedef struct { uint16_t v[8]; } csc_u16x8;
+
+#define CSC_FOR8(i)     for (int i = 0; i < 8; i++)
+#define CSC_FOR16(i)    for (int i = 0; i < 16; i++)
+
+static inline csc_u8x16 csc_load_u8x16(const uint8_t *p) { csc_u8x16 r; memcpy(r.v, p, 16); return r; }
+static inline void csc_store_u8x16(uint8_t *p, csc_u8x16 v) { memcpy(p, v.v, 16); }
+static inline void csc_store_half_u8x16(uint8_t *p, csc_u8x16 v) { memcpy(p, v.v, 8); }
+static inline csc_u16x8 csc_load_u16x8(const void *p) { csc_u16x8 r; memcpy(r.v, p, 16); return r; }
+static inline void csc_store_u16x8(uint8_t *p, csc_u16x8 v) { memcpy(p, v.v, 16); }
+static inline csc_u16x8 csc_dup_u16(uint16_t n) { csc_u16x8 r; CSC_FOR8(i) r.v[i] = n; return r; }
+static inline csc_u16x8 csc_add_u16(csc_u16x8 a, csc_u16x8 b) { CSC_FOR8(i) a.v[i] += b.v[i]; return a; }
+static inline csc_u16x8 csc_sub_u16(csc_u16x8 a, csc_u16x8 b) { CSC_FOR8(i) a.v[i] -= b.v[i]; return a; }
+static inline csc_u16x8 csc_mul_u16(csc_u16x8 a, uint16_t n) { CSC_FOR8(i) a.v[i] *= n; return a; }
+static inline csc_u16x8 csc_and_u16(csc_u16x8 a, uint16_t n) { CSC_FOR8(i) a.v[i] &= n; return a; }
+static inline csc_u16x8 csc_or_u16(csc_u16x8 a, csc_u16x8 b) { CSC_FOR8(i) a.v[i] |= b.v[i]; return a; }
+static inline csc_u16x8 csc_shl_u16(csc_u16x8 a, int n) { CSC_FOR8(i) a.v[i] <<= n; return a; }
+static inline csc_u16x8 csc_shr_u16(csc_u16x8 a, int n) { CSC_FOR8(i) a.v[i] >>= n; return a; }
+static inline csc_u16x8 csc_sra_u16(csc_u16x8 a, int n) { CSC_FOR8(i) a.v[i] = (uint16_t)((int16_t)a.v[i] >> n); return a; }
+static inline csc_u16x8 csc_widen_lo(csc_u8x16 v) { csc_u16x8 r; CSC_FOR8(i) r.v[i] = v.v[i]; return r; }
+static inline csc_u16x8 csc_widen_hi(csc_u8x16 v) { csc_u16x8 r; CSC_FOR8(i) r.v[i] = v.v[i + 8]; return r; }
+static inline csc_u16x8 csc_even_u8(csc_u8x16 v) { csc_u16x8 r; CSC_FOR8(i) r.v[i] = v.v[2 * i]; return r; }
+static inline csc_u16x8 csc_odd_u8(csc_u8x16 v) { csc_u16x8 r; CSC_FOR8(i) r.v[i] = v.v[2 * i + 1]; return r; }
+static inline csc_u8x16 csc_narrow(csc_u16x8 lo, csc_u16x8 hi)
+{
+    csc_u8x16 r;
+    CSC_FOR8(i) {
+        r.v[i] = (uint8_t)lo.v[i];
+        r.v[i + 8] = (uint8_t)hi.v[i];
+    }
+    return r;
+}
+static inline void csc_load2_u8x16(const uint8_t *p, csc_u8x16 *a, csc_u8x16 *b)
+{
+    CSC_FOR16(i) {
+        a->v[i] = p[2 * i];
+        b->v[i] = p[2 * i + 1];
+    }
+}
+static inline void csc_store2_u8x16(uint8_t *p, csc_u8x16 a, csc_u8x16 b)
+{
+    CSC_FOR16(i) {
+        p[2 * i] = a.v[i];
+        p[2 * i + 1] = b.v[i];
+    }
+}
+static inline void csc_load4_u8x16(const uint8_t *p, csc_u8x16 c[4])
+{
+    CSC_FOR16(i) {
+        c[0].v[i] = p[4 * i];
+        c[1].v[i] = p[4 * i + 1];
+        c[2].v[i] = p[4 * i + 2];
+        c[3].v[i] = p[4 * i + 3];
+    }
+}
+#endif
+
+/*
+ * Returns 1 when the vector kernels may run on this cpu.
+ * The result is probed once (hwcap on arm, cpuid on x86).
+ */
+int csc_simd_supported(void);
+
+/*
+ * Enables/disables the vector kernels (enabled by default).
+ * Used by the benchmark to run the C code on the same cpu.
+ */
+void csc_simd_enable(int enable);
+
+/* csc_simd_supported() && enabled */
+int csc_simd_enabled(void);
+
+void csc_deinterleave_memcpy_simd(
+    unsigned char *dest1,
+    unsigned char *dest2,
+    unsigned char *src,
+    unsigned int src_size);
+
+void csc_interleave_memcpy_simd(
+    unsigned char *dest,
+    unsigned char *src1,
+    unsigned char *src2,
+    unsigned int src_size);
+
+void csc_RGB565_to_YUV420P_simd(
+    unsigned char *y_dst,
+    unsigned char *u_dst,
+    unsigned char *v_dst,
+    unsigned char *rgb_src,
+    int width,
+    int height);
+
+void csc_RGB565_to_YUV420SP_simd(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    int width,
+    int height);
+
+/*
+ * r_pos : byte position of R in a pixel
+ *         2 for csc_BGRA8888_to_*, 0 for csc_RGBA8888_to_*
+ */
+void csc_RGB32_to_YUV420P_simd(
+    unsigned char *y_dst,
+    unsigned char *u_dst,
+    unsigned char *v_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height,
+    int r_pos);
+
+void csc_RGB32_to_YUV420SP_simd(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height,
+    int r_pos);
+
+#endif /*SWCONVERTER_SIMD_H_ */
@@ -32,6 +32,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "swconverter.h"
+#include "swconverter_simd.h"
 
 #ifdef NEON_SUPPORT
 #ifdef USE_NV12T_128X64
@@ -1337,6 +1338,12 @@ void csc_deinterleave_memcpy(
     unsigned int src_size)
 {
     unsigned int i = 0;
+
+    if (csc_simd_enabled()) {
+        csc_deinterleave_memcpy_simd(dest1, dest2, src, src_size);
+        return;
+    }
+
     for(i=0; i<src_size/2; i++) {
         dest1[i] = src[i*2];
         dest2[i] = src[i*2+1];
@@ -1368,6 +1375,11 @@ void csc_interleave_memcpy(
     csc_interleave_memcpy_neon(dest, src1, src2, src_size);
 #else
 /* not neon */
+    if (csc_simd_enabled()) {
+        csc_interleave_memcpy_simd(dest, src1, src2, src_size);
+        return;
+    }
+
     unsigned int i = 0;
     for(i=0; i<src_size; i++) {
         dest[i*2] = src1[i];
@@ -1789,6 +1801,11 @@ void csc_RGB565_to_YUV420P(
     int width,
     int height)
 {
+    if (csc_simd_enabled()) {
+        csc_RGB565_to_YUV420P_simd(y_dst, u_dst, v_dst, rgb_src, width, height);
+        return;
+    }
+
     int i, j;
     unsigned int tmp;
 
@@ -1863,6 +1880,11 @@ void csc_RGB565_to_YUV420SP(
     int width,
     int height)
 {
+    if (csc_simd_enabled()) {
+        csc_RGB565_to_YUV420SP_simd(y_dst, uv_dst, rgb_src, width, height);
+        return;
+    }
+
     int i, j;
     unsigned int tmp;
 
@@ -1940,6 +1962,11 @@ void csc_BGRA8888_to_YUV420P(
     unsigned int width,
     unsigned int height)
 {
+    if (csc_simd_enabled()) {
+        csc_RGB32_to_YUV420P_simd(y_dst, u_dst, v_dst, rgb_src, width, height, 2);
+        return;
+    }
+
     unsigned int i, j;
     unsigned int tmp;
 
@@ -2017,6 +2044,11 @@ void csc_RGBA8888_to_YUV420P(
     unsigned int width,
     unsigned int height)
 {
+    if (csc_simd_enabled()) {
+        csc_RGB32_to_YUV420P_simd(y_dst, u_dst, v_dst, rgb_src, width, height, 0);
+        return;
+    }
+
     unsigned int i, j;
     unsigned int tmp;
 
@@ -2093,6 +2125,11 @@ void csc_BGRA8888_to_YUV420SP(
 #ifdef NEON_SUPPORT
     csc_BGRA8888_to_YUV420SP_NEON(y_dst, uv_dst, rgb_src, width, height);
 #else
+    if (csc_simd_enabled()) {
+        csc_RGB32_to_YUV420SP_simd(y_dst, uv_dst, rgb_src, width, height, 2);
+        return;
+    }
+
     unsigned int i, j;
     unsigned int tmp;
 
@@ -2167,6 +2204,11 @@ void csc_RGBA8888_to_YUV420SP(
 #ifdef NEON_SUPPORT
     csc_RGBA8888_to_YUV420SP_NEON(y_dst, uv_dst, rgb_src, width, height);
 #else
+    if (csc_simd_enabled()) {
+        csc_RGB32_to_YUV420SP_simd(y_dst, uv_dst, rgb_src, width, height, 0);
+        return;
+    }
+
     unsigned int i, j;
     unsigned int tmp;
 
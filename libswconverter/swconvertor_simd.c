@@ -0,0 +1,375 @@
+/*
+ *
+ * Copyright 2012 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    swconvertor_simd.c
+ *
+ * @brief   vector implementation of the csc functions in swconvertor.c
+ *          every kernel is bit exact with the C code it replaces
+ *
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "swconverter.h"
+#include "swconverter_simd.h"
+
+#if defined(CSC_SIMD_NEON) && !defined(__aarch64__)
+#include <sys/auxv.h>
+#ifndef HWCAP_NEON
+#define HWCAP_NEON (1 << 12)
+#endif
+#endif
+
+static int csc_simd_probed = -1;
+static int csc_simd_on = 1;
+
+int csc_simd_supported(void)
+{
+    if (csc_simd_probed < 0) {
+#if defined(CSC_SIMD_NEON) && defined(__aarch64__)
+        /* advanced simd is mandatory on armv8-a */
+        csc_simd_probed = 1;
+#elif defined(CSC_SIMD_NEON)
+        csc_simd_probed = (getauxval(AT_HWCAP) & HWCAP_NEON) ? 1 : 0;
+#elif defined(CSC_SIMD_SSE2) && defined(__x86_64__)
+        csc_simd_probed = 1;
+#elif defined(CSC_SIMD_SSE2)
+        csc_simd_probed = __builtin_cpu_supports("sse2") ? 1 : 0;
+#else
+        csc_simd_probed = 0;
+#endif
+    }
+
+    return csc_simd_probed;
+}
+
+void csc_simd_enable(int enable)
+{
+    csc_simd_on = enable;
+}
+
+int csc_simd_enabled(void)
+{
+    return csc_simd_on && csc_simd_supported();
+}
+
+/*
+ * Same expressions as the C code, used for the pixels left over
+ * after the last full vector of a row.
+ */
+static inline unsigned char csc_rgb_to_y(unsigned int R, unsigned int G, unsigned int B)
+{
+    unsigned int Y = ((66 * R) + (129 * G) + (25 * B) + 128);
+    Y = Y >> 8;
+    Y += 16;
+    return (unsigned char)Y;
+}
+
+static inline unsigned char csc_rgb_to_u(unsigned int R, unsigned int G, unsigned int B)
+{
+    unsigned int U = ((-38 * R) - (74 * G) + (112 * B) + 128);
+    U = U >> 8;
+    U += 128;
+    return (unsigned char)U;
+}
+
+static inline unsigned char csc_rgb_to_v(unsigned int R, unsigned int G, unsigned int B)
+{
+    unsigned int V = ((112 * R) - (94 * G) - (18 * B) + 128);
+    V = V >> 8;
+    V += 128;
+    return (unsigned char)V;
+}
+
+/*
+ * Y fits in 16bit unsigned (max 56228).
+ * U, V sums fit in 16bit signed (-28432 ~ 28688), so the wrapping 16bit
+ * arithmetic followed by an arithmetic shift gives the same low 8bit as
+ * the 32bit unsigned C code.
+ */
+static inline csc_u16x8 csc_rgb_to_y16(csc_u16x8 r, csc_u16x8 g, csc_u16x8 b)
+{
+    csc_u16x8 y = csc_add_u16(csc_add_u16(csc_mul_u16(r, 66), csc_mul_u16(g, 129)),
+                              csc_add_u16(csc_mul_u16(b, 25), csc_dup_u16(128)));
+    return csc_add_u16(csc_shr_u16(y, 8), csc_dup_u16(16));
+}
+
+static inline csc_u16x8 csc_rgb_to_u16(csc_u16x8 r, csc_u16x8 g, csc_u16x8 b)
+{
+    csc_u16x8 u = csc_add_u16(csc_mul_u16(b, 112), csc_dup_u16(128));
+    u = csc_sub_u16(u, csc_add_u16(csc_mul_u16(r, 38), csc_mul_u16(g, 74)));
+    return csc_add_u16(csc_sra_u16(u, 8), csc_dup_u16(128));
+}
+
+static inline csc_u16x8 csc_rgb_to_v16(csc_u16x8 r, csc_u16x8 g, csc_u16x8 b)
+{
+    csc_u16x8 v = csc_add_u16(csc_mul_u16(r, 112), csc_dup_u16(128));
+    v = csc_sub_u16(v, csc_add_u16(csc_mul_u16(g, 94), csc_mul_u16(b, 18)));
+    return csc_add_u16(csc_sra_u16(v, 8), csc_dup_u16(128));
+}
+
+/*
+ * Stores 8 U and 8 V
+ * uv_step 2 : u_dst, v_dst point into one interleaved UV plane (v_dst == u_dst + 1)
+ * uv_step 1 : separate planes
+ */
+static inline void csc_store_uv(unsigned char *u_dst, unsigned char *v_dst, int uv_step,
+        csc_u16x8 u, csc_u16x8 v)
+{
+    if (uv_step == 2) {
+        csc_store_u16x8(u_dst, csc_or_u16(u, csc_shl_u16(v, 8)));
+    } else {
+        csc_store_half_u8x16(u_dst, csc_narrow(u, u));
+        csc_store_half_u8x16(v_dst, csc_narrow(v, v));
+    }
+}
+
+void csc_deinterleave_memcpy_simd(
+    unsigned char *dest1,
+    unsigned char *dest2,
+    unsigned char *src,
+    unsigned int src_size)
+{
+    unsigned int i = 0;
+    unsigned int size = src_size / 2;
+    csc_u8x16 a, b;
+
+    for (; i + 16 <= size; i += 16) {
+        csc_load2_u8x16(src + (i * 2), &a, &b);
+        csc_store_u8x16(dest1 + i, a);
+        csc_store_u8x16(dest2 + i, b);
+    }
+    /* a 16 byte tile row of csc_tiled_to_linear_uv_deinterleave() */
+    for (; i + 8 <= size; i += 8) {
+        a = csc_load_u8x16(src + (i * 2));
+        csc_store_half_u8x16(dest1 + i, csc_narrow(csc_even_u8(a), csc_even_u8(a)));
+        csc_store_half_u8x16(dest2 + i, csc_narrow(csc_odd_u8(a), csc_odd_u8(a)));
+    }
+    for (; i < size; i++) {
+        dest1[i] = src[i * 2];
+        dest2[i] = src[i * 2 + 1];
+    }
+}
+
+void csc_interleave_memcpy_simd(
+    unsigned char *dest,
+    unsigned char *src1,
+    unsigned char *src2,
+    unsigned int src_size)
+{
+    unsigned int i = 0;
+
+    for (; i + 16 <= src_size; i += 16)
+        csc_store2_u8x16(dest + (i * 2), csc_load_u8x16(src1 + i), csc_load_u8x16(src2 + i));
+    for (; i < src_size; i++) {
+        dest[i * 2] = src1[i];
+        dest[i * 2 + 1] = src2[i];
+    }
+}
+
+/* one row of RGB565, u_dst/v_dst are NULL on odd rows */
+static void csc_RGB565_row(
+    unsigned char *y_dst,
+    unsigned char *u_dst,
+    unsigned char *v_dst,
+    int uv_step,
+    const unsigned short *src,
+    int width)
+{
+    int i = 0;
+
+    for (; i + 16 <= width; i += 16) {
+        csc_u16x8 p0 = csc_load_u16x8(src + i);
+        csc_u16x8 p1 = csc_load_u16x8(src + i + 8);
+        csc_u16x8 r0 = csc_and_u16(csc_shr_u16(p0, 8), 0xF8);
+        csc_u16x8 g0 = csc_and_u16(csc_shr_u16(p0, 3), 0xFC);
+        csc_u16x8 b0 = csc_and_u16(csc_shl_u16(p0, 3), 0xF8);
+        csc_u16x8 r1 = csc_and_u16(csc_shr_u16(p1, 8), 0xF8);
+        csc_u16x8 g1 = csc_and_u16(csc_shr_u16(p1, 3), 0xFC);
+        csc_u16x8 b1 = csc_and_u16(csc_shl_u16(p1, 3), 0xF8);
+
+        csc_store_u8x16(y_dst + i, csc_narrow(csc_rgb_to_y16(r0, g0, b0),
+                                              csc_rgb_to_y16(r1, g1, b1)));
+
+        if (u_dst != NULL) {
+            csc_u16x8 re = csc_even_u8(csc_narrow(r0, r1));
+            csc_u16x8 ge = csc_even_u8(csc_narrow(g0, g1));
+            csc_u16x8 be = csc_even_u8(csc_narrow(b0, b1));
+
+            csc_store_uv(u_dst, v_dst, uv_step,
+                    csc_rgb_to_u16(re, ge, be), csc_rgb_to_v16(re, ge, be));
+            u_dst += 8 * uv_step;
+            v_dst += 8 * uv_step;
+        }
+    }
+
+    for (; i < width; i++) {
+        unsigned int tmp = src[i];
+        unsigned int R = (tmp & 0x0000F800) >> 8;
+        unsigned int G = (tmp & 0x000007E0) >> 3;
+        unsigned int B = (tmp & 0x0000001F) << 3;
+
+        y_dst[i] = csc_rgb_to_y(R, G, B);
+        if (u_dst != NULL && (i % 2) == 0) {
+            *u_dst = csc_rgb_to_u(R, G, B);
+            *v_dst = csc_rgb_to_v(R, G, B);
+            u_dst += uv_step;
+            v_dst += uv_step;
+        }
+    }
+}
+
+/* one row of 32bit RGB, u_dst/v_dst are NULL on odd rows */
+static void csc_RGB32_row(
+    unsigned char *y_dst,
+    unsigned char *u_dst,
+    unsigned char *v_dst,
+    int uv_step,
+    const unsigned char *src,
+    unsigned int width,
+    int r_pos)
+{
+    unsigned int i = 0;
+    int b_pos = 2 - r_pos;
+
+    for (; i + 16 <= width; i += 16) {
+        csc_u8x16 c[4];
+
+        csc_load4_u8x16(src + (i * 4), c);
+        csc_store_u8x16(y_dst + i, csc_narrow(
+                    csc_rgb_to_y16(csc_widen_lo(c[r_pos]), csc_widen_lo(c[1]), csc_widen_lo(c[b_pos])),
+                    csc_rgb_to_y16(csc_widen_hi(c[r_pos]), csc_widen_hi(c[1]), csc_widen_hi(c[b_pos]))));
+
+        if (u_dst != NULL) {
+            csc_u16x8 re = csc_even_u8(c[r_pos]);
+            csc_u16x8 ge = csc_even_u8(c[1]);
+            csc_u16x8 be = csc_even_u8(c[b_pos]);
+
+            csc_store_uv(u_dst, v_dst, uv_step,
+                    csc_rgb_to_u16(re, ge, be), csc_rgb_to_v16(re, ge, be));
+            u_dst += 8 * uv_step;
+            v_dst += 8 * uv_step;
+        }
+    }
+
+    for (; i < width; i++) {
+        unsigned int R = src[(i * 4) + r_pos];
+        unsigned int G = src[(i * 4) + 1];
+        unsigned int B = src[(i * 4) + b_pos];
+
+        y_dst[i] = csc_rgb_to_y(R, G, B);
+        if (u_dst != NULL && (i % 2) == 0) {
+            *u_dst = csc_rgb_to_u(R, G, B);
+            *v_dst = csc_rgb_to_v(R, G, B);
+            u_dst += uv_step;
+            v_dst += uv_step;
+        }
+    }
+}
+
+void csc_RGB565_to_YUV420P_simd(
+    unsigned char *y_dst,
+    unsigned char *u_dst,
+    unsigned char *v_dst,
+    unsigned char *rgb_src,
+    int width,
+    int height)
+{
+    const unsigned short *pSrc = (const unsigned short *)rgb_src;
+    int j;
+
+    for (j = 0; j < height; j++) {
+        int even = ((j % 2) == 0);
+
+        csc_RGB565_row(y_dst + (size_t)j * width,
+                even ? u_dst : NULL, even ? v_dst : NULL, 1,
+                pSrc + (size_t)j * width, width);
+        if (even) {
+            u_dst += (width + 1) / 2;
+            v_dst += (width + 1) / 2;
+        }
+    }
+}
+
+void csc_RGB565_to_YUV420SP_simd(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    int width,
+    int height)
+{
+    const unsigned short *pSrc = (const unsigned short *)rgb_src;
+    int j;
+
+    for (j = 0; j < height; j++) {
+        int even = ((j % 2) == 0);
+
+        csc_RGB565_row(y_dst + (size_t)j * width,
+                even ? uv_dst : NULL, even ? uv_dst + 1 : NULL, 2,
+                pSrc + (size_t)j * width, width);
+        if (even)
+            uv_dst += ((width + 1) / 2) * 2;
+    }
+}
+
+void csc_RGB32_to_YUV420P_simd(
+    unsigned char *y_dst,
+    unsigned char *u_dst,
+    unsigned char *v_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height,
+    int r_pos)
+{
+    unsigned int j;
+
+    for (j = 0; j < height; j++) {
+        int even = ((j % 2) == 0);
+
+        csc_RGB32_row(y_dst + (size_t)j * width,
+                even ? u_dst : NULL, even ? v_dst : NULL, 1,
+                rgb_src + (size_t)j * width * 4, width, r_pos);
+        if (even) {
+            u_dst += (width + 1) / 2;
+            v_dst += (width + 1) / 2;
+        }
+    }
+}
+
+void csc_RGB32_to_YUV420SP_simd(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height,
+    int r_pos)
+{
+    unsigned int j;
+
+    for (j = 0; j < height; j++) {
+        int even = ((j % 2) == 0);
+
+        csc_RGB32_row(y_dst + (size_t)j * width,
+                even ? uv_dst : NULL, even ? uv_dst + 1 : NULL, 2,
+                rgb_src + (size_t)j * width * 4, width, r_pos);
+        if (even)
+            uv_dst += ((width + 1) / 2) * 2;
+    }
+}
@@ -90,4 +90,7 @@ $(warning ##############################################)
 
 include $(LOCAL_ROOT_PATH)/kernel/vpu/Android.mk
 include $(LOCAL_ROOT_PATH)/kernel/score/Android.mk
+include $(LOCAL_ROOT_PATH)/kernel/cpu/Android.mk
+include $(LOCAL_ROOT_PATH)/system/test/Android.mk
+include $(LOCAL_ROOT_PATH)/tools/Android.mk
 #include $(LOCAL_ROOT_PATH)/kernel/opencl/Android.mk
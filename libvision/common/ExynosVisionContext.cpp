@@ -161,6 +161,14 @@ ExynosVisionContext::init(void)
     else
         VXLOGD("loading kernels: exynosscorekernel");
 
+    /* Load cpu kernels, samsung */
+    VXLOGD("loading exynoscpukernel");
+    load_status = loadKernels("exynoscpukernel");
+    if (load_status != VX_SUCCESS)
+        VXLOGE("ERR(%d):loading kernel of exynoscpukernel fail", load_status);
+    else
+        VXLOGD("loading kernels: exynoscpukernel");
+
     m_performance_monitor = new ExynosVisionPerfMonitor<ExynosVisionGraph*>;
     if (m_performance_monitor == NULL) {
         VXLOGE("performance monitor can't create");
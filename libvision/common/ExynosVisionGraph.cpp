@@ -17,10 +17,15 @@
 #define LOG_TAG "ExynosVisionGraph"
 #include <cutils/log.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "ExynosVisionAutoTimer.h"
+#include "ExynosVisionPerfReport.h"
 
 #include "ExynosVisionGraph.h"
 #include "ExynosVisionSubgraph.h"
+#include "ExynosVisionImage.h"
 
 #define GRAPHDBG    /* VXLOGD */
 
@@ -39,6 +44,8 @@ ExynosVisionGraph::ExynosVisionGraph(ExynosVisionContext *context)
     m_schedule_complete_event = NULL;
 
     m_exec_mode = GRAPH_EXEC_NORMAL;
+    m_pipeline_depth = DEFAULT_SLOT_NUM;
+    m_perf_trace = vx_false_e;
 
     m_performance_monitor = NULL;
     m_is_replaced_flag = vx_false_e;
@@ -537,6 +544,11 @@ ExynosVisionGraph::verifyGraph(void)
         goto Exit;
     }
 
+    measureTraffic();
+
+    if (getContext()->getPerfMonitor() != NULL)
+        getContext()->getPerfMonitor()->setTraceMode(this, m_perf_trace);
+
 Exit:
     verify_end = ExynosVisionDurationTimer::getTimeUs();
     m_verify_time = verify_end - verify_start;
@@ -746,14 +758,188 @@ ExynosVisionGraph::initializeKernel(void)
     return status;
 }
 
+vx_bool
+ExynosVisionGraph::isGraphParameter(ExynosVisionDataReference *data_ref)
+{
+    for (vx_uint32 i = 0; i < m_param_vector.size(); i++) {
+        if (m_param_vector[i].node->getDataRefByIndex(m_param_vector[i].index) == data_ref)
+            return vx_true_e;
+    }
+
+    return vx_false_e;
+}
+
+vx_bool
+ExynosVisionGraph::isFusibleNode(ExynosVisionNode *node)
+{
+    const ExynosVisionKernel *kernel = node->getKernelHandle();
+    vx_uint32 width = 0, height = 0;
+
+    if ((kernel->isBandCapable() != vx_true_e) || (node->getChildGraphOfNode() != NULL))
+        return vx_false_e;
+
+    /* band function takes single plane images of the same size, every output is an image */
+    for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+        if (kernel->getParamDirection(p) == VX_BIDIRECTIONAL)
+            return vx_false_e;
+
+        if (kernel->getParamType(p) != VX_TYPE_IMAGE) {
+            if (kernel->getParamDirection(p) == VX_OUTPUT)
+                return vx_false_e;
+            continue;
+        }
+
+        ExynosVisionImage *image = (ExynosVisionImage*)node->getDataRefByIndex(p);
+        if (image == NULL)
+            continue;
+
+        vx_uint32 image_width = 0, image_height = 0;
+        vx_df_image format = VX_DF_IMAGE_VIRT;
+        if ((image->getDimension(&image_width, &image_height) != VX_SUCCESS) ||
+            (image->queryImage(VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format)) != VX_SUCCESS))
+            return vx_false_e;
+
+        if (ExynosVisionSubgraph::getBandPixelSize(format) == 0)
+            return vx_false_e;
+
+        if (width == 0) {
+            width = image_width;
+            height = image_height;
+        } else if ((width != image_width) || (height != image_height)) {
+            return vx_false_e;
+        }
+    }
+
+    return vx_true_e;
+}
+
+vx_bool
+ExynosVisionGraph::isFusibleEdge(ExynosVisionDataReference *data_ref)
+{
+    /* only a virtual image that nobody outside of graph can see stays in bands */
+    if ((data_ref->getType() != VX_TYPE_IMAGE) || (data_ref->isVirtual() != vx_true_e) ||
+        (data_ref->isDelayElement() == vx_true_e) || (data_ref->isQueue() == vx_true_e) ||
+        isGraphParameter(data_ref))
+        return vx_false_e;
+
+    if ((data_ref->getDirectInputNodeNum(this) != 1) ||
+        (data_ref->getDirectInputNodeNum(this) != data_ref->getIndirectInputNodeNum(this)) ||
+        (data_ref->getDirectOutputNodeNum(this) == 0) ||
+        (data_ref->getDirectOutputNodeNum(this) != data_ref->getIndirectOutputNodeNum(this)))
+        return vx_false_e;
+
+    if (isFusibleNode(data_ref->getDirectInputNode(this, 0)) != vx_true_e)
+        return vx_false_e;
+
+    for (vx_uint32 i = 0; i < data_ref->getDirectOutputNodeNum(this); i++) {
+        if (isFusibleNode(data_ref->getDirectOutputNode(this, i)) != vx_true_e)
+            return vx_false_e;
+    }
+
+    return vx_true_e;
+}
+
+ExynosVisionNode*
+ExynosVisionGraph::findFusionLeader(ExynosVisionNode *node, map<ExynosVisionNode*, ExynosVisionNode*> *leader_map)
+{
+    const ExynosVisionKernel *kernel = node->getKernelHandle();
+    ExynosVisionNode *leader = NULL;
+
+    if (isFusibleNode(node) != vx_true_e)
+        return node;
+
+    /* every input written by a node of this graph should come from the same group */
+    for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+        ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+        if ((data_ref == NULL) || (kernel->getParamDirection(p) != VX_INPUT))
+            continue;
+
+        if (data_ref->getIndirectInputNodeNum(this) == 0)
+            continue;
+
+        if (isFusibleEdge(data_ref) != vx_true_e)
+            return node;
+
+        ExynosVisionNode *producer_leader = (*leader_map)[data_ref->getDirectInputNode(this, 0)];
+        if (producer_leader == NULL)
+            return node;
+
+        if (leader == NULL)
+            leader = producer_leader;
+        else if (leader != producer_leader)
+            return node;
+    }
+
+    return (leader != NULL) ? leader : node;
+}
+
+vx_bool
+ExynosVisionGraph::isInternalEdge(ExynosVisionDataReference *data_ref, ExynosVisionNode *leader,
+                                            map<ExynosVisionNode*, ExynosVisionNode*> *leader_map)
+{
+    if ((*leader_map)[data_ref->getDirectInputNode(this, 0)] != leader)
+        return vx_false_e;
+
+    for (vx_uint32 i = 0; i < data_ref->getDirectOutputNodeNum(this); i++) {
+        if ((*leader_map)[data_ref->getDirectOutputNode(this, i)] != leader)
+            return vx_false_e;
+    }
+
+    return vx_true_e;
+}
+
 vx_status
 ExynosVisionGraph::groupingSubgraph(void)
 {
     EXYNOS_VISION_SYSTEM_IN();
     vx_status status = VX_FAILURE;
 
-    for (List<ExynosVisionNode*>::iterator node_iter = m_sorted_node_list.begin(); node_iter != m_sorted_node_list.end(); node_iter++ ) {
+    List<ExynosVisionNode*>::iterator node_iter;
+
+    /* band-capable node joins the group of its producer, the group becomes a single subgraph
+        that runs band by band and never allocates the images between its nodes */
+    map<ExynosVisionNode*, ExynosVisionNode*> leader_map;
+    for (node_iter = m_sorted_node_list.begin(); node_iter != m_sorted_node_list.end(); node_iter++)
+        leader_map[*node_iter] = findFusionLeader(*node_iter, &leader_map);
+
+    /* an image read in a group is a port if a node out of the group reads it too,
+        the reader in the group could not start before the group ends, so it leaves the group */
+    vx_bool changed = vx_true_e;
+    while (changed == vx_true_e) {
+        changed = vx_false_e;
+
+        for (node_iter = m_sorted_node_list.begin(); node_iter != m_sorted_node_list.end(); node_iter++) {
+            ExynosVisionNode *cur_node = *node_iter;
+            ExynosVisionNode *leader = leader_map[cur_node];
+            if (leader == cur_node)
+                continue;
+
+            for (vx_uint32 p = 0; p < cur_node->getDataRefNum(); p++) {
+                ExynosVisionDataReference *data_ref = cur_node->getDataRefByIndex(p);
+                if ((data_ref == NULL) || (cur_node->getKernelHandle()->getParamDirection(p) != VX_INPUT) ||
+                    (data_ref->getIndirectInputNodeNum(this) == 0))
+                    continue;
+
+                if (isInternalEdge(data_ref, leader, &leader_map) != vx_true_e) {
+                    leader_map[cur_node] = cur_node;
+                    changed = vx_true_e;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (node_iter = m_sorted_node_list.begin(); node_iter != m_sorted_node_list.end(); node_iter++ ) {
         ExynosVisionNode *cur_node = *node_iter;
+        ExynosVisionNode *leader = leader_map[cur_node];
+
+        if (leader != cur_node) {
+            status = leader->getSubgraph()->addNode(cur_node);
+            cur_node->setSubgraph(leader->getSubgraph());
+            VXLOGD2("%s is fused to %s", cur_node->getName(), leader->getSubgraph()->getSgName());
+            continue;
+        }
+
         ExynosVisionSubgraph *cur_subgraph = new ExynosVisionSubgraph(this);
 
         status = cur_subgraph->init(cur_node);
@@ -812,6 +998,10 @@ ExynosVisionGraph::checkExecutionModePropriety(void)
                 if (data_ref == NULL)
                     continue;
 
+                /* intermediate image of fused subgraph never leaves the subgraph */
+                if ((*iter_node)->getSubgraph()->isInternalRef(data_ref))
+                    continue;
+
                 /* there are some restricts in stream mode.
                     1. can't contain delay object
                     2. can't contain alliance object.
@@ -834,6 +1024,67 @@ EXIT:
     return status;
 }
 
+void
+ExynosVisionGraph::measureTraffic(void)
+{
+    traffic_info_t traffic;
+    memset(&traffic, 0x0, sizeof(traffic));
+
+    /* every image parameter of a node is read or written once per frame */
+    for (List<ExynosVisionNode*>::iterator node_iter = m_sorted_node_list.begin(); node_iter != m_sorted_node_list.end(); node_iter++) {
+        ExynosVisionNode *node = *node_iter;
+        traffic_info_t node_traffic;
+        memset(&node_traffic, 0x0, sizeof(node_traffic));
+
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+            if ((data_ref == NULL) || (data_ref->getType() != VX_TYPE_IMAGE))
+                continue;
+
+            ExynosVisionImage *image = (ExynosVisionImage*)data_ref;
+            vx_size size = 0;
+            if (data_ref->isAllocated()) {
+                image->queryImage(VX_IMAGE_ATTRIBUTE_SIZE, &size, sizeof(size));
+            } else {
+                vx_uint32 width = 0, height = 0;
+                vx_df_image format = VX_DF_IMAGE_VIRT;
+                image->getDimension(&width, &height);
+                image->queryImage(VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format));
+                size = width * height * ExynosVisionSubgraph::getBandPixelSize(format);
+            }
+
+            vx_enum direction = node->getKernelHandle()->getParamDirection(p);
+
+            node_traffic.unfused_bytes += size;
+            if (node->getSubgraph()->isInternalRef(data_ref)) {
+                if (direction == VX_OUTPUT)
+                    node_traffic.unallocated_bytes += size;
+            } else {
+                node_traffic.fused_bytes += size;
+                if (direction != VX_OUTPUT)
+                    node_traffic.read_bytes += size;
+                if (direction != VX_INPUT)
+                    node_traffic.write_bytes += size;
+            }
+        }
+
+        traffic.unfused_bytes += node_traffic.unfused_bytes;
+        traffic.fused_bytes += node_traffic.fused_bytes;
+        traffic.unallocated_bytes += node_traffic.unallocated_bytes;
+        traffic.read_bytes += node_traffic.read_bytes;
+        traffic.write_bytes += node_traffic.write_bytes;
+
+        if (m_performance_monitor != NULL)
+            m_performance_monitor->setTrafficInfo(node, &node_traffic);
+    }
+
+    if (getContext()->getPerfMonitor() != NULL)
+        getContext()->getPerfMonitor()->setTrafficInfo(this, &traffic);
+
+    VXLOGD2("%s, traffic:%llu -> %llu bytes, not allocated:%llu bytes", getName(),
+                traffic.unfused_bytes, traffic.fused_bytes, traffic.unallocated_bytes);
+}
+
 vx_status
 ExynosVisionGraph::setParentNode(ExynosVisionNode* node)
 {
@@ -1014,6 +1265,47 @@ ExynosVisionGraph::queryGraph(vx_enum attribute, void *ptr, vx_size size)
             status = VX_ERROR_INVALID_PARAMETERS;
         }
         break;
+    case VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH:
+        if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3))
+            *(vx_uint32 *)ptr = m_pipeline_depth;
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+        break;
+    case VX_GRAPH_ATTRIBUTE_PERF_TRACE:
+        if (VX_CHECK_PARAM(ptr, size, vx_bool, 0x3))
+            *(vx_bool *)ptr = m_perf_trace;
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+        break;
+    case VX_GRAPH_ATTRIBUTE_PERF_TRACE_SIZE:
+        if (VX_CHECK_PARAM(ptr, size, vx_size, 0x3)) {
+            String8 trace;
+            status = exportPerfTrace(&trace);
+            *(vx_size *)ptr = (status == VX_SUCCESS) ? trace.length() + 1 : 0;
+        } else {
+            status = VX_ERROR_INVALID_PARAMETERS;
+        }
+        break;
+    case VX_GRAPH_ATTRIBUTE_PERF_TRACE_JSON:
+        if ((ptr != NULL) && (size != 0)) {
+            String8 trace;
+            status = exportPerfTrace(&trace);
+            if ((status == VX_SUCCESS) && (trace.length() + 1 > size)) {
+                VXLOGE("trace needs %d bytes, size:%d", trace.length() + 1, size);
+                status = VX_ERROR_INVALID_PARAMETERS;
+            }
+            if (status == VX_SUCCESS)
+                memcpy(ptr, trace.string(), trace.length() + 1);
+        } else {
+            status = VX_ERROR_INVALID_PARAMETERS;
+        }
+        break;
+    case VX_GRAPH_ATTRIBUTE_PERF_REPORT:
+        if ((ptr != NULL) && (size >= sizeof(vx_node_perf_report_t)) && (size % sizeof(vx_node_perf_report_t) == 0))
+            status = makePerfReport((vx_node_perf_report_t*)ptr, size / sizeof(vx_node_perf_report_t));
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+        break;
     default:
         status = VX_ERROR_NOT_SUPPORTED;
         break;
@@ -1025,9 +1317,39 @@ ExynosVisionGraph::queryGraph(vx_enum attribute, void *ptr, vx_size size)
 vx_status
 ExynosVisionGraph::setGraphAttribute(vx_enum attribute, const void *ptr, vx_size size)
 {
-    vx_status status = VX_ERROR_NOT_SUPPORTED;
+    vx_status status = VX_SUCCESS;
 
-    VXLOGE("there are no settable attributes, attribute:0x%x, ptr:%p, size:%d", attribute, ptr, size);
+    /* virtual objects are allocated at verification with the depth of that time */
+    if (isGraphVerified() == vx_true_e) {
+        VXLOGE("%s is already verified, attribute:0x%x", getName(), attribute);
+        return VX_ERROR_NOT_SUPPORTED;
+    }
+
+    switch (attribute) {
+    case VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH:
+        if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3)) {
+            vx_uint32 depth = *(vx_uint32 *)ptr;
+            if ((depth == 0) || (depth > MAX_SLOT_NUM)) {
+                VXLOGE("pipeline depth is out of range, depth:%d, max:%d", depth, MAX_SLOT_NUM);
+                status = VX_ERROR_INVALID_VALUE;
+            } else {
+                m_pipeline_depth = depth;
+            }
+        } else {
+            status = VX_ERROR_INVALID_PARAMETERS;
+        }
+        break;
+    case VX_GRAPH_ATTRIBUTE_PERF_TRACE:
+        if (VX_CHECK_PARAM(ptr, size, vx_bool, 0x3))
+            m_perf_trace = *(vx_bool *)ptr;
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+        break;
+    default:
+        VXLOGE("there are no settable attributes, attribute:0x%x, ptr:%p, size:%d", attribute, ptr, size);
+        status = VX_ERROR_NOT_SUPPORTED;
+        break;
+    }
 
     return status;
 }
@@ -1038,6 +1360,171 @@ ExynosVisionGraph::requestNewFrameCnt(ExynosVisionReference *ref)
     return ++m_frame_cnt_map[ref];
 }
 
+static void
+appendTraceEvent(String8 *trace, const vx_char *name, const vx_char *cat, vx_uint32 pid, vx_uint32 tid,
+                    vx_uint32 frame_number, const time_pair_t *time_pair, const traffic_info_t *traffic)
+{
+    trace->appendFormat(",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%llu,\"dur\":%llu,\"args\":{\"frame\":%d",
+                        name, cat, pid, tid, time_pair->start, time_pair->end - time_pair->start, frame_number);
+    if (traffic)
+        trace->appendFormat(",\"read_bytes\":%llu,\"write_bytes\":%llu", traffic->read_bytes, traffic->write_bytes);
+    trace->append("}}");
+}
+
+/* a span runs from the first node of the frame entering to the last one leaving */
+static void
+mergeTraceSpan(map<vx_uint32, time_pair_t> *span_map, vx_uint32 frame_number, const time_pair_t *time_pair)
+{
+    map<vx_uint32, time_pair_t>::iterator span_iter = span_map->find(frame_number);
+
+    if (span_iter == span_map->end()) {
+        (*span_map)[frame_number] = *time_pair;
+    } else {
+        if (span_iter->second.start > time_pair->start)
+            span_iter->second.start = time_pair->start;
+        if (span_iter->second.end < time_pair->end)
+            span_iter->second.end = time_pair->end;
+    }
+}
+
+vx_status
+ExynosVisionGraph::exportPerfTrace(String8 *trace)
+{
+    Vector<trace_record_t> records;
+    map<vx_uint32, time_pair_t> graph_span_map;
+    map<vx_uint32, time_pair_t>::iterator span_iter;
+    vx_uint32 pid = getId();
+    vx_uint32 i, tid;
+    vx_bool graph_stamped = vx_false_e;
+
+    if (m_perf_trace == vx_false_e) {
+        VXLOGE("%s is not in trace mode", getName());
+        return VX_ERROR_NOT_SUPPORTED;
+    }
+
+    if ((getContext()->getPerfMonitor() == NULL) || (m_performance_monitor == NULL)) {
+        VXLOGE("performance monitor is not assigned");
+        return VX_FAILURE;
+    }
+
+    /*
+     * The graph on lane 0, then a lane per subgraph holding the nodes of it.
+     * processGraph() stamps the graph, a stream never calls it: there lane 0
+     * takes the span of each frame number over all of the nodes, which count
+     * the frames of the stream one by one.
+     */
+    trace->setTo("{\"traceEvents\":[\n");
+    trace->appendFormat("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"%s\"}}", pid, getName());
+
+    getContext()->getPerfMonitor()->getTraceRecords(this, &records);
+    for (i=0; i<records.size(); i++) {
+        const trace_record_t &record = records[i];
+        if (record.time_pair[TIMEPAIR_PROCESS].end > record.time_pair[TIMEPAIR_PROCESS].start) {
+            appendTraceEvent(trace, getName(), PERF_TRACE_CAT_GRAPH, pid, 0, record.frame_number, &record.time_pair[TIMEPAIR_PROCESS], NULL);
+            graph_stamped = vx_true_e;
+        }
+    }
+
+    List<ExynosVisionSubgraph*>::iterator sg_iter;
+    for (sg_iter=m_sg_list.begin(), tid=1; sg_iter!=m_sg_list.end(); sg_iter++, tid++) {
+        ExynosVisionSubgraph *subgraph = *sg_iter;
+        map<vx_uint32, time_pair_t> sg_span_map;
+
+        trace->appendFormat(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                                pid, tid, subgraph->getSgName());
+
+        List<ExynosVisionNode*>::iterator node_iter;
+        for (node_iter=subgraph->getNodeList()->begin(); node_iter!=subgraph->getNodeList()->end(); node_iter++) {
+            ExynosVisionNode *node = *node_iter;
+            traffic_info_t *traffic = m_performance_monitor->getTrafficInfo(node);
+
+            m_performance_monitor->getTraceRecords(node, &records);
+            for (i=0; i<records.size(); i++) {
+                const trace_record_t &record = records[i];
+                const time_pair_t *framework = &record.time_pair[TIMEPAIR_FRAMEWORK];
+
+                if (framework->end <= framework->start)
+                    continue;
+
+                appendTraceEvent(trace, node->getName(), PERF_TRACE_CAT_NODE, pid, tid, record.frame_number, framework, traffic);
+                if (record.time_pair[TIMEPAIR_KERNEL].end > record.time_pair[TIMEPAIR_KERNEL].start)
+                    appendTraceEvent(trace, node->getKernelName(), PERF_TRACE_CAT_KERNEL, pid, tid, record.frame_number,
+                                        &record.time_pair[TIMEPAIR_KERNEL], NULL);
+                if (record.time_pair[TIMEPAIR_FIRMWARE].end > record.time_pair[TIMEPAIR_FIRMWARE].start)
+                    appendTraceEvent(trace, node->getKernelName(), PERF_TRACE_CAT_FIRMWARE, pid, tid, record.frame_number,
+                                        &record.time_pair[TIMEPAIR_FIRMWARE], NULL);
+
+                mergeTraceSpan(&sg_span_map, record.frame_number, framework);
+                if (graph_stamped == vx_false_e)
+                    mergeTraceSpan(&graph_span_map, record.frame_number, framework);
+            }
+        }
+
+        for (span_iter=sg_span_map.begin(); span_iter!=sg_span_map.end(); span_iter++)
+            appendTraceEvent(trace, subgraph->getSgName(), PERF_TRACE_CAT_SUBGRAPH, pid, tid, span_iter->first, &span_iter->second, NULL);
+    }
+
+    for (span_iter=graph_span_map.begin(); span_iter!=graph_span_map.end(); span_iter++)
+        appendTraceEvent(trace, getName(), PERF_TRACE_CAT_GRAPH, pid, 0, span_iter->first, &span_iter->second, NULL);
+
+    trace->append("\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    return VX_SUCCESS;
+}
+
+vx_status
+ExynosVisionGraph::makePerfReport(vx_node_perf_report_t *report, vx_uint32 report_num)
+{
+    Vector<trace_record_t> records;
+    vector<vx_uint64> durations;
+    vx_uint32 i;
+
+    if (m_perf_trace == vx_false_e) {
+        VXLOGE("%s is not in trace mode", getName());
+        return VX_ERROR_NOT_SUPPORTED;
+    }
+
+    if (m_performance_monitor == NULL) {
+        VXLOGE("performance monitor is not assigned");
+        return VX_FAILURE;
+    }
+
+    memset(report, 0x0, sizeof(vx_node_perf_report_t) * report_num);
+
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_node_list.begin(), i=0; (node_iter!=m_node_list.end()) && (i<report_num); node_iter++, i++) {
+        ExynosVisionNode *node = *node_iter;
+        traffic_info_t *traffic = m_performance_monitor->getTrafficInfo(node);
+
+        strncpy(report[i].name, node->getName(), VX_MAX_KERNEL_NAME - 1);
+        strncpy(report[i].kernel_name, node->getKernelName(), VX_MAX_KERNEL_NAME - 1);
+
+        durations.clear();
+        m_performance_monitor->getTraceRecords(node, &records);
+        for (vx_uint32 r=0; r<records.size(); r++) {
+            const time_pair_t *framework = &records[r].time_pair[TIMEPAIR_FRAMEWORK];
+            if (framework->end > framework->start)
+                durations.push_back(framework->end - framework->start);
+        }
+        sort(durations.begin(), durations.end());
+
+        report[i].num = durations.size();
+        if (durations.size() != 0) {
+            report[i].p50 = perfPercentile(&durations[0], durations.size(), 50);
+            report[i].p95 = perfPercentile(&durations[0], durations.size(), 95);
+            report[i].p99 = perfPercentile(&durations[0], durations.size(), 99);
+        }
+
+        if (traffic != NULL) {
+            report[i].read_bytes = traffic->read_bytes;
+            report[i].write_bytes = traffic->write_bytes;
+        }
+        report[i].gbps = perfGbps(report[i].read_bytes + report[i].write_bytes, report[i].p50);
+    }
+
+    return VX_SUCCESS;
+}
+
 vx_status
 ExynosVisionGraph::pushErrorEvent(ExynosVisionSubgraph *subgraph, vx_status error)
 {
@@ -1196,6 +1683,23 @@ ExynosVisionGraph::displayPerf(vx_uint32 tab_num, vx_bool detail_info)
     VXLOGI("%s\tverify: %0.3lf ms", MAKE_TAB(tap, tab_num), (vx_float32)m_verify_time/1000.0f);
     VXLOGI("%s\tprocess [%llu]: %0.3lf ms", MAKE_TAB(tap, tab_num), vx_perf[TIMEPAIR_PROCESS].num, (vx_float32)vx_perf[TIMEPAIR_PROCESS].avg/1000.0f);
 
+    traffic_info_t *traffic = getContext()->getPerfMonitor()->getTrafficInfo(this);
+    if (traffic != NULL) {
+        VXLOGI("%s\timage traffic: %llu bytes, %llu bytes unfused", MAKE_TAB(tap, tab_num), traffic->fused_bytes, traffic->unfused_bytes);
+        VXLOGI("%s\tnot allocated: %llu bytes", MAKE_TAB(tap, tab_num), traffic->unallocated_bytes);
+    }
+
+    if (m_perf_trace == vx_true_e) {
+        vector<vx_node_perf_report_t> report(m_node_list.size());
+        if ((report.size() != 0) && (makePerfReport(&report[0], report.size()) == VX_SUCCESS)) {
+            for (vx_uint32 i=0; i<report.size(); i++) {
+                VXLOGI("%s\tnode(%s, %s) [%d] p50:%llu us, p95:%llu us, p99:%llu us, rd:%llu, wr:%llu bytes, %0.2f GB/s", MAKE_TAB(tap, tab_num),
+                    report[i].name, report[i].kernel_name, report[i].num, report[i].p50, report[i].p95, report[i].p99,
+                    report[i].read_bytes, report[i].write_bytes, report[i].gbps);
+            }
+        }
+    }
+
     if (detail_info == vx_true_e) {
         List<ExynosVisionSubgraph*>::iterator sg_iter;
         for (sg_iter=m_sg_list.begin(); sg_iter!=m_sg_list.end(); sg_iter++)
@@ -18,6 +18,7 @@
 #define EXYNOS_VISION_GRAPH_H
 
 #include <utils/threads.h>
+#include <utils/String8.h>
 
 #include "ExynosVisionQueue.h"
 #include "ExynosVisionState.h"
@@ -104,6 +105,10 @@ private:
     ExynosVisionEvent *m_schedule_complete_event;
 
     graph_exec_mode_t m_exec_mode;
+    /* frames in flight between subgraphs in stream mode, the slot number of virtual objects */
+    vx_uint32 m_pipeline_depth;
+    /* node and graph executions are recorded in the trace ring of the performance monitor */
+    vx_bool m_perf_trace;
 
     ExynosVisionPerfMonitor<ExynosVisionNode*> *m_performance_monitor;
 
@@ -130,6 +135,15 @@ private:
     vx_status groupingSubgraph(void);
     vx_status fixAllSubgraph(void);
     vx_status checkExecutionModePropriety(void);
+    void measureTraffic(void);
+
+    /* fusion of band-capable nodes, see groupingSubgraph() */
+    vx_bool isGraphParameter(ExynosVisionDataReference *data_ref);
+    vx_bool isFusibleNode(ExynosVisionNode *node);
+    vx_bool isFusibleEdge(ExynosVisionDataReference *data_ref);
+    ExynosVisionNode* findFusionLeader(ExynosVisionNode *node, map<ExynosVisionNode*, ExynosVisionNode*> *leader_map);
+    vx_bool isInternalEdge(ExynosVisionDataReference *data_ref, ExynosVisionNode *leader,
+                                        map<ExynosVisionNode*, ExynosVisionNode*> *leader_map);
 
     vx_status stopProcessGraph(void);
 
@@ -193,6 +207,8 @@ public:
     vx_status stopGraph();
     vx_status pushErrorEvent(ExynosVisionSubgraph *subgraph, vx_status error);
 
+    vx_status exportPerfTrace(String8 *trace);
+    vx_status makePerfReport(vx_node_perf_report_t *report, vx_uint32 report_num);
     virtual void displayInfo(vx_uint32 tab_num, vx_bool detail_info);
     virtual void displayPerf(vx_uint32 tab_num, vx_bool detail_info);
 
@@ -210,6 +226,14 @@ public:
     {
         return m_exec_mode;
     }
+    vx_uint32 getPipelineDepth(void)
+    {
+        return m_pipeline_depth;
+    }
+    vx_bool isPerfTraceEnabled(void)
+    {
+        return m_perf_trace;
+    }
 
     vx_uint32 requestNewFrameCnt(ExynosVisionReference *ref);
 
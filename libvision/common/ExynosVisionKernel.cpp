@@ -40,6 +40,8 @@ ExynosVisionKernel::ExynosVisionKernel(ExynosVisionContext *context)
     m_initialize = 0;
     m_deinitialize = 0;
     memset(&m_attributes, 0x0, sizeof(m_attributes));
+    m_band_function = NULL;
+    m_band_radius = 0;
 }
 
 ExynosVisionKernel::~ExynosVisionKernel()
@@ -100,6 +102,18 @@ ExynosVisionKernel::setKernelAttribute(vx_enum attribute, const void *ptr, vx_si
         else
             status = VX_ERROR_INVALID_PARAMETERS;
         break;
+    case VX_KERNEL_ATTRIBUTE_BAND_FUNCTION:
+        if (VX_CHECK_PARAM(ptr, size, vx_kernel_band_f, 0x1))
+            m_band_function = *(vx_kernel_band_f *)ptr;
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+        break;
+    case VX_KERNEL_ATTRIBUTE_BAND_RADIUS:
+        if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3))
+            m_band_radius = *(vx_uint32 *)ptr;
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+        break;
 
     default:
         status = VX_ERROR_NOT_SUPPORTED;
@@ -144,6 +158,18 @@ ExynosVisionKernel::queryKernel(vx_enum attribute, void *ptr, vx_size size)
         else
             status = VX_ERROR_INVALID_PARAMETERS;
         break;
+    case VX_KERNEL_ATTRIBUTE_BAND_FUNCTION:
+        if (VX_CHECK_PARAM(ptr, size, vx_kernel_band_f, 0x1))
+            *(vx_kernel_band_f *)ptr = m_band_function;
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+        break;
+    case VX_KERNEL_ATTRIBUTE_BAND_RADIUS:
+        if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3))
+            *(vx_uint32 *)ptr = m_band_radius;
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+        break;
     default:
         status = VX_ERROR_NOT_SUPPORTED;
         break;
@@ -335,6 +361,28 @@ ExynosVisionKernel::kernelFunction(ExynosVisionNode *node, const ExynosVisionDat
     return status;
 }
 
+vx_status
+ExynosVisionKernel::bandFunction(ExynosVisionNode *node, const ExynosVisionDataReference **parameters, vx_uint32 num,
+                                        const vx_image_band_t *bands) const
+{
+    EXYNOS_VISION_SYSTEM_IN();
+    vx_status status;
+
+    if (m_band_function) {
+        status = m_band_function((vx_node)node, (vx_reference*)parameters, num, bands);
+        if (status != VX_SUCCESS) {
+            VXLOGE("band function fail at kernel(%s) from %s, err:%d", m_kernel_name, node->getName(), status);
+        }
+    } else {
+        VXLOGE("band function is not implemented");
+        status = VX_ERROR_NOT_IMPLEMENTED;
+    }
+
+    EXYNOS_VISION_SYSTEM_OUT();
+
+    return status;
+}
+
 void
 ExynosVisionKernel::fiiledAttr(vx_kernel_attr_t *attributes)
 {
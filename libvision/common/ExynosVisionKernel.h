@@ -72,6 +72,10 @@ private:
     vx_kernel_deinitialize_f m_deinitialize;
     /*! \brief The collection of attributes of a kernel */
     vx_kernel_attr_t m_attributes;
+    /*! \brief The row band entry, NULL when the kernel only runs on whole images */
+    vx_kernel_band_f m_band_function;
+    /*! \brief Input rows read above and below an output row by the band entry */
+    vx_uint32 m_band_radius;
 
 public:
 
@@ -111,6 +115,8 @@ public:
     vx_status initialize(ExynosVisionNode *node, const ExynosVisionDataReference **parameters, vx_uint32 num);
     vx_status deinitialize(ExynosVisionNode *node, const ExynosVisionDataReference **parameters, vx_uint32 num);
     vx_status kernelFunction(ExynosVisionNode *node, const ExynosVisionDataReference **parameters, vx_uint32 num) const;
+    vx_status bandFunction(ExynosVisionNode *node, const ExynosVisionDataReference **parameters, vx_uint32 num,
+                                const vx_image_band_t *bands) const;
 
     void fiiledAttr(vx_kernel_attr_t *attributes);
 
@@ -143,6 +149,15 @@ public:
     {
         return (enum vx_parameter_state_e)m_signature.states[index];
     }
+    vx_bool isBandCapable(void) const
+    {
+        return m_band_function ? vx_true_e : vx_false_e;
+    }
+    vx_uint32 getBandRadius(void) const
+    {
+        return m_band_radius;
+    }
+
     vx_bool getFinalizeFlag(void)
     {
         return m_enabled;
@@ -263,6 +263,7 @@ public:
     vx_uint32 getIndirectInputNodeNum(ExynosVisionGraph *graph);
     vx_uint32 getIndirectOutputNodeNum(ExynosVisionGraph *graph);
 
+    ExynosVisionNode* getDirectInputNode(ExynosVisionGraph *graph, vx_uint32 node_idx);
     ExynosVisionNode* getDirectOutputNode(ExynosVisionGraph *graph, vx_uint32 node_idx);
     ExynosVisionNode* getIndirectOutputNode(ExynosVisionGraph *graph, vx_uint32 node_idx);
 
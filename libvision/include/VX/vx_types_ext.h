@@ -32,6 +32,41 @@ enum vx_node_attribute_ext_e {
     VX_NODE_ATTRIBUTE_SHARE_RESOURCE =  VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_NODE) + 0x4,
 };
 
+enum vx_graph_attribute_ext_e {
+    /*! \brief Sets the number of frames a stream graph keeps in flight between its stages,
+     * the virtual images get one buffer per frame. Set it before the graph is verified.
+     * Use a <tt>\ref vx_uint32</tt> parameter.
+     */
+    VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH = VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_GRAPH) + 0x0,
+    /*! \brief Sets the graph to record the time of its last executions without locking, it feeds
+     * <tt>\ref VX_GRAPH_ATTRIBUTE_PERF_TRACE_JSON</tt> and <tt>\ref VX_GRAPH_ATTRIBUTE_PERF_REPORT</tt>.
+     * Set it before the graph is verified. Use a <tt>\ref vx_bool</tt> parameter.
+     */
+    VX_GRAPH_ATTRIBUTE_PERF_TRACE = VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_GRAPH) + 0x1,
+    /*! \brief Queries the bytes of the trace, the terminating null included. Use a <tt>\ref vx_size</tt> parameter. */
+    VX_GRAPH_ATTRIBUTE_PERF_TRACE_SIZE = VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_GRAPH) + 0x2,
+    /*! \brief Queries the recorded executions of the graph, its subgraphs and its nodes in the
+     * Chrome trace event JSON format. Use a <tt>\ref vx_char</tt> array of
+     * <tt>\ref VX_GRAPH_ATTRIBUTE_PERF_TRACE_SIZE</tt> bytes.
+     */
+    VX_GRAPH_ATTRIBUTE_PERF_TRACE_JSON = VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_GRAPH) + 0x3,
+    /*! \brief Queries the recorded executions per node, one entry per node in the order the nodes
+     * were created, as many as the array holds. Use a <tt>\ref vx_node_perf_report_t</tt> array.
+     */
+    VX_GRAPH_ATTRIBUTE_PERF_REPORT = VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_GRAPH) + 0x4,
+};
+
+enum vx_kernel_attribute_ext_e {
+    /*! \brief Sets the row band entry of a kernel, it lets the graph run the kernel fused with its neighbors.
+     * Use a <tt>\ref vx_kernel_band_f</tt> parameter.
+     */
+    VX_KERNEL_ATTRIBUTE_BAND_FUNCTION = VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_KERNEL) + 0x0,
+    /*! \brief Sets the number of input rows above and below an output row that the band entry reads.
+     * Use a <tt>\ref vx_uint32</tt> parameter.
+     */
+    VX_KERNEL_ATTRIBUTE_BAND_RADIUS = VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_KERNEL) + 0x1,
+};
+
 enum vx_target_ext_e {
     VX_TARGET_VPU = VX_ENUM_BASE(VX_ID_SAMSUNG, VX_ENUM_TARGET) + 0x0,
     VX_TARGET_CPU = VX_ENUM_BASE(VX_ID_SAMSUNG, VX_ENUM_TARGET) + 0x1,
@@ -99,5 +134,58 @@ typedef vx_status (VX_API_CALL *vx_module_initializer_f)(vx_context context);
  */
 typedef vx_status (VX_API_CALL *vx_module_deinitializer_f)(void);
 
+/*!
+ * \brief The executions of a node recorded in trace mode, see <tt>\ref VX_GRAPH_ATTRIBUTE_PERF_REPORT</tt>.
+ * \note Times are in microseconds from entering to leaving the node. Bytes are the images the node
+ * reads and writes in memory per frame; images kept inside a fused subgraph are not counted.
+ * \ingroup group_graph
+ */
+typedef struct _vx_node_perf_report_t {
+    vx_char name[VX_MAX_KERNEL_NAME];
+    vx_char kernel_name[VX_MAX_KERNEL_NAME];
+    /*! \brief The number of executions held by the trace */
+    vx_uint32 num;
+    vx_uint64 p50;
+    vx_uint64 p95;
+    vx_uint64 p99;
+    vx_uint64 read_bytes;
+    vx_uint64 write_bytes;
+    /*! \brief read_bytes and write_bytes over p50 */
+    vx_float32 gbps;
+} vx_node_perf_report_t;
+
+/*!
+ * \brief Rows of plane 0 of an image, handed to a band entry.
+ * \note A band may be a buffer of its own; row y of the image is at
+ * <tt>ptr + (y - start_y) * stride_y</tt> for start_y <= y < end_y only.
+ * \ingroup group_user_kernels
+ */
+typedef struct _vx_image_band_t {
+    /*! \brief Row start_y of the image */
+    void *ptr;
+    /*! \brief Bytes between rows, pixels are packed */
+    vx_int32 stride_y;
+    /*! \brief Dimensions of the whole image */
+    vx_uint32 width;
+    vx_uint32 height;
+    vx_df_image format;
+    /*! \brief The rows held, end_y is exclusive */
+    vx_uint32 start_y;
+    vx_uint32 end_y;
+} vx_image_band_t;
+
+/*!
+ * \brief The row band entry of a kernel, see <tt>\ref VX_KERNEL_ATTRIBUTE_BAND_FUNCTION</tt>.
+ * \param [in] node The handle to the node that contains this kernel.
+ * \param [in] parameters The array of parameter references, images are not accessible.
+ * \param [in] num The number of parameters.
+ * \param [in] bands One band per parameter, image parameters only. The kernel writes the rows
+ * its output bands hold; input bands hold those rows and <tt>\ref VX_KERNEL_ATTRIBUTE_BAND_RADIUS</tt>
+ * rows around them, as far as the image goes. Rows beyond the image come from the border mode.
+ * \ingroup group_user_kernels
+ */
+typedef vx_status (VX_CALLBACK *vx_kernel_band_f)(vx_node node, const vx_reference *parameters, vx_uint32 num,
+                                                    const vx_image_band_t *bands);
+
 #endif
 
@@ -0,0 +1,71 @@
+# Copyright (C) 2015 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+LOCAL_PATH:= $(call my-dir)
+
+include $(CLEAR_VARS)
+
+LOCAL_PRELINK_MODULE := false
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+LOCAL_SHARED_LIBRARIES += libexynosvision
+LOCAL_PROPRIETARY_MODULE := true
+
+# vxcpu_simd.h is plain vector extensions, let the compiler schedule them
+LOCAL_CFLAGS += -O3 -fno-math-errno
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/../../include \
+	$(LOCAL_PATH)/../../common \
+	$(LOCAL_PATH)/../../system \
+	$(LOCAL_PATH)/../../utils \
+	$(LOCAL_PATH)/
+
+LOCAL_SRC_FILES:= \
+	./vxcpu_parallel.cpp \
+	./vxcpu_core_pixelwise.cpp \
+	./vxcpu_core_filter.cpp \
+	./vxcpu_core_statistics.cpp \
+	./vxcpu_core_geometry.cpp \
+	./vxcpu_core_optflow.cpp \
+	./vxcpu_kernel_util.cpp \
+	./vxcpu_kernel_module.cpp \
+	./vx_absdiff.cpp \
+	./vx_addsub.cpp \
+	./vx_bitwise.cpp \
+	./vx_convolution.cpp \
+	./vx_filter.cpp \
+	./vx_gradient.cpp \
+	./vx_magnitude.cpp \
+	./vx_phase.cpp \
+	./vx_threshold.cpp \
+	./vx_histogram.cpp \
+	./vx_integralimage.cpp \
+	./vx_scale.cpp \
+	./vx_warp.cpp \
+	./vx_pyramid.cpp \
+	./vx_optpyrlk.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynoscpukernel
+
+include $(BUILD_SHARED_LIBRARY)
+
+$(warning ##############################################)
+$(warning ##############################################)
+$(warning ##########    EVF CPU Kernel     #############)
+$(warning ##############################################)
+$(warning ##############################################)
+
+include $(LOCAL_PATH)/test/Android.mk
@@ -0,0 +1,39 @@
+# Copyright (C) 2015 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+LOCAL_PATH:= $(call my-dir)
+
+include $(CLEAR_VARS)
+
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_CFLAGS += -O3 -fno-math-errno
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/../../../include \
+	$(LOCAL_PATH)/..
+
+LOCAL_SRC_FILES:= \
+	./vxcpu_conformance.cpp \
+	../vxcpu_parallel.cpp \
+	../vxcpu_core_pixelwise.cpp \
+	../vxcpu_core_filter.cpp \
+	../vxcpu_core_statistics.cpp \
+	../vxcpu_core_geometry.cpp \
+	../vxcpu_core_optflow.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := vxcpu_conformance
+
+include $(BUILD_EXECUTABLE)
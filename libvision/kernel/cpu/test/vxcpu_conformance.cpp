@@ -0,0 +1,887 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Conformance and throughput of the cpu target compute part.
+ *
+ * Every function of vxcpu_core.h is run on random images of random sizes,
+ * row strides and border modes, and compared against a plain per-pixel
+ * implementation of the OpenVX 1.0 definition below.  Then each one is
+ * timed at 1920x1080 against that reference, on one thread and on the whole
+ * pool.  It needs no framework, so it also builds on a host:
+ *
+ *   g++ -std=c++14 -O3 -fno-math-errno -pthread \
+ *       -I../../../include -I.. -o vxcpu_conformance vxcpu_conformance.cpp \
+ *       ../vxcpu_parallel.cpp ../vxcpu_core_*.cpp
+ *
+ * Exit status is the number of failed checks.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "vxcpu_core.h"
+#include "vxcpu_parallel.h"
+
+static int g_failures = 0;
+
+#define CHECK(cond, ...)                                \
+    do {                                                \
+        if (!(cond)) {                                  \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);  \
+            printf(__VA_ARGS__);                        \
+            printf("\n");                               \
+            g_failures++;                               \
+        }                                               \
+    } while (0)
+
+/* image with its own memory, rows may be padded */
+struct test_image {
+    std::vector<vx_uint8> mem;
+    vxcpu_image_t img;
+
+    test_image(vx_uint32 width, vx_uint32 height, vx_df_image format, vx_uint32 pad = 0)
+    {
+        vx_uint32 bpp = (format == VX_DF_IMAGE_U8) ? 1 : ((format == VX_DF_IMAGE_S16) ? 2 : 4);
+
+        img.stride = (vx_int32)((width + pad) * bpp);
+        img.width = width;
+        img.height = height;
+        img.format = format;
+        img.start_y = 0;
+        img.end_y = 0;
+        mem.assign((size_t)img.stride * (height ? height : 1), 0xCD);
+        img.ptr = mem.data();
+    }
+
+    template <typename T>
+    T &at(vx_uint32 x, vx_uint32 y) { return ((T *)(mem.data() + (size_t)y * img.stride))[x]; }
+    template <typename T>
+    T at(vx_uint32 x, vx_uint32 y) const { return ((const T *)(mem.data() + (size_t)y * img.stride))[x]; }
+};
+
+static vx_uint32 rnd(vx_uint32 n)
+{
+    return (vx_uint32)rand() % n;
+}
+
+static void fill_random(test_image *t)
+{
+    for (vx_uint32 y = 0; y < t->img.height; y++) {
+        for (vx_uint32 x = 0; x < t->img.width; x++) {
+            if (t->img.format == VX_DF_IMAGE_U8)
+                t->at<vx_uint8>(x, y) = (vx_uint8)rnd(256);
+            else
+                t->at<vx_int16>(x, y) = (vx_int16)(rnd(65536) - 32768);
+        }
+    }
+}
+
+/* smooth content, so that trackers and interpolators have something to work on */
+static void fill_texture(test_image *t, vx_float32 dx, vx_float32 dy)
+{
+    for (vx_uint32 y = 0; y < t->img.height; y++) {
+        for (vx_uint32 x = 0; x < t->img.width; x++) {
+            vx_float32 u = (vx_float32)x - dx, v = (vx_float32)y - dy;
+            vx_float32 f = 128.0f + 60.0f * sinf(u * 0.21f) * cosf(v * 0.17f) + 50.0f * sinf((u + v) * 0.05f);
+
+            t->at<vx_uint8>(x, y) = (vx_uint8)std::min(255.0f, std::max(0.0f, f));
+        }
+    }
+}
+
+static vx_border_mode_t random_border(void)
+{
+    static const vx_enum modes[] = {
+        VX_BORDER_MODE_UNDEFINED, VX_BORDER_MODE_CONSTANT, VX_BORDER_MODE_REPLICATE,
+    };
+    vx_border_mode_t border;
+
+    border.mode = modes[rnd(3)];
+    border.constant_value = rnd(256);
+    return border;
+}
+
+/* counts differing pixels, and those off by more than tolerance */
+template <typename T>
+static void compare(const test_image &a, const test_image &b, vx_int32 tolerance,
+                        vx_uint32 *diff, vx_uint32 *bad)
+{
+    *diff = *bad = 0;
+    for (vx_uint32 y = 0; y < a.img.height; y++) {
+        for (vx_uint32 x = 0; x < a.img.width; x++) {
+            vx_int32 d = abs((vx_int32)a.at<T>(x, y) - (vx_int32)b.at<T>(x, y));
+
+            if (d)
+                (*diff)++;
+            if (d > tolerance)
+                (*bad)++;
+        }
+    }
+}
+
+#define CHECK_SAME(T, got, ref, tolerance, what)                                                   \
+    do {                                                                                            \
+        vx_uint32 diff_, bad_;                                                                      \
+        compare<T>(got, ref, tolerance, &diff_, &bad_);                                             \
+        CHECK(bad_ == 0, "%s %ux%u: %u pixels off by more than %d", what, (got).img.width,          \
+              (got).img.height, bad_, tolerance);                                                   \
+    } while (0)
+
+/*
+ * References, straight from the definitions.
+ */
+
+static vx_int32 ref_pixel(const test_image &in, vx_int32 x, vx_int32 y, const vx_border_mode_t &border)
+{
+    if (x < 0 || y < 0 || x >= (vx_int32)in.img.width || y >= (vx_int32)in.img.height) {
+        if (border.mode == VX_BORDER_MODE_CONSTANT)
+            return (vx_uint8)border.constant_value;
+        /* undefined is replicate on the cpu target */
+        x = std::min(std::max(x, 0), (vx_int32)in.img.width - 1);
+        y = std::min(std::max(y, 0), (vx_int32)in.img.height - 1);
+    }
+    return in.at<vx_uint8>(x, y);
+}
+
+static vx_int32 sat(vx_int32 v, vx_int32 lo, vx_int32 hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static void ref_convolve(const test_image &in, const vx_int32 *coeffs, vx_int32 cols, vx_int32 rows,
+                            vx_int32 scale, test_image *out, const vx_border_mode_t &border)
+{
+    for (vx_int32 y = 0; y < (vx_int32)in.img.height; y++) {
+        for (vx_int32 x = 0; x < (vx_int32)in.img.width; x++) {
+            vx_int32 sum = 0;
+
+            for (vx_int32 j = -rows / 2; j <= rows / 2; j++) {
+                for (vx_int32 i = -cols / 2; i <= cols / 2; i++)
+                    sum += ref_pixel(in, x + i, y + j, border) * coeffs[(rows / 2 - j) * cols + (cols / 2 - i)];
+            }
+            sum /= scale;
+            if (out->img.format == VX_DF_IMAGE_U8)
+                out->at<vx_uint8>(x, y) = (vx_uint8)sat(sum, 0, 255);
+            else
+                out->at<vx_int16>(x, y) = (vx_int16)sat(sum, INT16_MIN, INT16_MAX);
+        }
+    }
+}
+
+static void ref_median3x3(const test_image &in, test_image *out, const vx_border_mode_t &border)
+{
+    for (vx_int32 y = 0; y < (vx_int32)in.img.height; y++) {
+        for (vx_int32 x = 0; x < (vx_int32)in.img.width; x++) {
+            vx_int32 v[9], n = 0;
+
+            for (vx_int32 j = -1; j <= 1; j++) {
+                for (vx_int32 i = -1; i <= 1; i++)
+                    v[n++] = ref_pixel(in, x + i, y + j, border);
+            }
+            std::nth_element(v, v + 4, v + 9);
+            out->at<vx_uint8>(x, y) = (vx_uint8)v[4];
+        }
+    }
+}
+
+static vx_int32 ref_nearest(vx_uint32 x, vx_float32 ratio, vx_uint32 size)
+{
+    vx_float32 src = ((vx_float32)x + 0.5f) * ratio - 0.5f;
+    vx_int32 i = (vx_int32)src;
+
+    if (src - (vx_float32)i >= 0.5f)
+        i++;
+    return sat(i, 0, (vx_int32)size - 1);
+}
+
+static void ref_scale(const test_image &in, test_image *out, vx_enum interp, const vx_border_mode_t &border)
+{
+    vx_float32 wr = (vx_float32)in.img.width / out->img.width;
+    vx_float32 hr = (vx_float32)in.img.height / out->img.height;
+
+    if (interp == VX_INTERPOLATION_TYPE_AREA &&
+        (out->img.width > in.img.width || out->img.height > in.img.height))
+        interp = VX_INTERPOLATION_TYPE_BILINEAR;
+
+    for (vx_uint32 y = 0; y < out->img.height; y++) {
+        for (vx_uint32 x = 0; x < out->img.width; x++) {
+            vx_int32 v = 0;
+
+            if (interp == VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR) {
+                v = in.at<vx_uint8>(ref_nearest(x, wr, in.img.width), ref_nearest(y, hr, in.img.height));
+            } else if (interp == VX_INTERPOLATION_TYPE_BILINEAR) {
+                vx_float32 sx = ((vx_float32)x + 0.5f) * wr - 0.5f;
+                vx_float32 sy = ((vx_float32)y + 0.5f) * hr - 0.5f;
+                vx_int32 x0 = (vx_int32)floorf(sx), y0 = (vx_int32)floorf(sy);
+                vx_float32 ax = sx - x0, ay = sy - y0;
+                vx_float32 top = ref_pixel(in, x0, y0, border) * (1 - ax) + ref_pixel(in, x0 + 1, y0, border) * ax;
+                vx_float32 bot = ref_pixel(in, x0, y0 + 1, border) * (1 - ax) +
+                                    ref_pixel(in, x0 + 1, y0 + 1, border) * ax;
+
+                v = (vx_int32)(top * (1 - ay) + bot * ay + 0.5f);
+            } else {
+                vx_int32 x0 = (vx_int32)((vx_float32)x * wr), x1 = (vx_int32)((vx_float32)(x + 1) * wr);
+                vx_int32 y0 = (vx_int32)((vx_float32)y * hr), y1 = (vx_int32)((vx_float32)(y + 1) * hr);
+                vx_int32 sum = 0, n;
+
+                x1 = std::min(std::max(x1, x0 + 1), (vx_int32)in.img.width);
+                y1 = std::min(std::max(y1, y0 + 1), (vx_int32)in.img.height);
+                for (vx_int32 j = y0; j < y1; j++) {
+                    for (vx_int32 i = x0; i < x1; i++)
+                        sum += in.at<vx_uint8>(i, j);
+                }
+                n = (x1 - x0) * (y1 - y0);
+                v = (sum + n / 2) / n;
+            }
+            out->at<vx_uint8>(x, y) = (vx_uint8)v;
+        }
+    }
+}
+
+/* m maps destination to source, column major as vxWarp*Node() takes it */
+static void ref_warp(const test_image &in, const vx_float32 *m, vx_bool perspective, vx_enum interp,
+                        test_image *out, const vx_border_mode_t &border)
+{
+    for (vx_uint32 y = 0; y < out->img.height; y++) {
+        for (vx_uint32 x = 0; x < out->img.width; x++) {
+            vx_float32 fx = (vx_float32)x, fy = (vx_float32)y;
+            vx_float32 sx, sy;
+            vx_int32 x0, y0;
+
+            if (perspective) {
+                vx_float32 z = fx * m[2] + fy * m[5] + m[8];
+
+                sx = (fx * m[0] + fy * m[3] + m[6]) / z;
+                sy = (fx * m[1] + fy * m[4] + m[7]) / z;
+            } else {
+                sx = fx * m[0] + fy * m[2] + m[4];
+                sy = fx * m[1] + fy * m[3] + m[5];
+            }
+            sx = std::min(std::max(sx, -2.0f), (vx_float32)in.img.width + 1.0f);
+            sy = std::min(std::max(sy, -2.0f), (vx_float32)in.img.height + 1.0f);
+            x0 = (vx_int32)floorf(sx);
+            y0 = (vx_int32)floorf(sy);
+
+            if (interp == VX_INTERPOLATION_TYPE_BILINEAR) {
+                vx_float32 ax = sx - x0, ay = sy - y0;
+                vx_float32 p00 = ref_pixel(in, x0, y0, border), p01 = ref_pixel(in, x0 + 1, y0, border);
+                vx_float32 p10 = ref_pixel(in, x0, y0 + 1, border), p11 = ref_pixel(in, x0 + 1, y0 + 1, border);
+                vx_float32 top = p00 + (p01 - p00) * ax, bottom = p10 + (p11 - p10) * ax;
+
+                out->at<vx_uint8>(x, y) = (vx_uint8)(top + (bottom - top) * ay + 0.5f);
+            } else {
+                out->at<vx_uint8>(x, y) = (vx_uint8)ref_pixel(in, x0, y0, border);
+            }
+        }
+    }
+}
+
+static const vx_int32 k_box[9] = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+static const vx_int32 k_gauss3[9] = { 1, 2, 1, 2, 4, 2, 1, 2, 1 };
+static const vx_int32 k_gauss5[25] = {
+    1, 4, 6, 4, 1, 4, 16, 24, 16, 4, 6, 24, 36, 24, 6, 4, 16, 24, 16, 4, 1, 4, 6, 4, 1,
+};
+/* flipped, the reference flips them back */
+static const vx_int32 k_sobel_x[9] = { 1, 0, -1, 2, 0, -2, 1, 0, -1 };
+static const vx_int32 k_sobel_y[9] = { 1, 2, 1, 0, 0, 0, -1, -2, -1 };
+
+static void ref_pyramid_level(const test_image &in, test_image *out, const vx_border_mode_t &border)
+{
+    test_image smooth(in.img.width, in.img.height, VX_DF_IMAGE_U8);
+
+    ref_convolve(in, k_gauss5, 5, 5, 256, &smooth, border);
+    ref_scale(smooth, out, VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR, border);
+}
+
+/*
+ * Conformance
+ */
+
+static void test_pixelwise(vx_uint32 w, vx_uint32 h)
+{
+    test_image a8(w, h, VX_DF_IMAGE_U8, rnd(9)), b8(w, h, VX_DF_IMAGE_U8, rnd(9));
+    test_image a16(w, h, VX_DF_IMAGE_S16, rnd(9)), b16(w, h, VX_DF_IMAGE_S16, rnd(9));
+    test_image got8(w, h, VX_DF_IMAGE_U8, rnd(9)), ref8(w, h, VX_DF_IMAGE_U8);
+    test_image got16(w, h, VX_DF_IMAGE_S16, rnd(9)), ref16(w, h, VX_DF_IMAGE_S16);
+
+    fill_random(&a8);
+    fill_random(&b8);
+    fill_random(&a16);
+    fill_random(&b16);
+
+    /* absdiff */
+    CHECK(vxcpu_absdiff(&a8.img, &b8.img, &got8.img) == VX_SUCCESS, "absdiff u8");
+    for (vx_uint32 y = 0; y < h; y++)
+        for (vx_uint32 x = 0; x < w; x++)
+            ref8.at<vx_uint8>(x, y) = (vx_uint8)abs(a8.at<vx_uint8>(x, y) - b8.at<vx_uint8>(x, y));
+    CHECK_SAME(vx_uint8, got8, ref8, 0, "absdiff u8");
+
+    CHECK(vxcpu_absdiff(&a16.img, &b16.img, &got16.img) == VX_SUCCESS, "absdiff s16");
+    for (vx_uint32 y = 0; y < h; y++)
+        for (vx_uint32 x = 0; x < w; x++)
+            ref16.at<vx_int16>(x, y) =
+                (vx_int16)sat(abs(a16.at<vx_int16>(x, y) - b16.at<vx_int16>(x, y)), 0, INT16_MAX);
+    CHECK_SAME(vx_int16, got16, ref16, 0, "absdiff s16");
+
+    /* add / subtract, every format combination and policy */
+    for (vx_uint32 c = 0; c < 16; c++) {
+        vx_bool subtract = (c & 1) ? vx_true_e : vx_false_e;
+        vx_enum policy = (c & 2) ? VX_CONVERT_POLICY_SATURATE : VX_CONVERT_POLICY_WRAP;
+        test_image *in1 = (c & 4) ? &a16 : &a8;
+        test_image *in2 = (c & 8) ? &b16 : &b8;
+        vx_bool to_u8 = (in1 == &a8 && in2 == &b8 && (c & 1) == 0) ? vx_true_e : vx_false_e;
+        test_image &got = to_u8 ? got8 : got16;
+        test_image &ref = to_u8 ? ref8 : ref16;
+
+        CHECK(vxcpu_arithmetic(&in1->img, &in2->img, policy, subtract, &got.img) == VX_SUCCESS, "arithmetic %u", c);
+        for (vx_uint32 y = 0; y < h; y++) {
+            for (vx_uint32 x = 0; x < w; x++) {
+                vx_int32 p = (in1 == &a8) ? a8.at<vx_uint8>(x, y) : a16.at<vx_int16>(x, y);
+                vx_int32 q = (in2 == &b8) ? b8.at<vx_uint8>(x, y) : b16.at<vx_int16>(x, y);
+                vx_int32 r = subtract ? p - q : p + q;
+
+                if (to_u8)
+                    ref8.at<vx_uint8>(x, y) = (vx_uint8)(policy == VX_CONVERT_POLICY_SATURATE ? sat(r, 0, 255) : r);
+                else
+                    ref16.at<vx_int16>(x, y) =
+                        (vx_int16)(policy == VX_CONVERT_POLICY_SATURATE ? sat(r, INT16_MIN, INT16_MAX) : r);
+            }
+        }
+        if (to_u8)
+            CHECK_SAME(vx_uint8, got, ref, 0, subtract ? "subtract" : "add");
+        else
+            CHECK_SAME(vx_int16, got, ref, 0, subtract ? "subtract" : "add");
+    }
+
+    /* bitwise */
+    for (vx_enum op = VXCPU_BITWISE_AND; op <= VXCPU_BITWISE_NOT; op++) {
+        CHECK(vxcpu_bitwise(&a8.img, &b8.img, op, &got8.img) == VX_SUCCESS, "bitwise %d", op);
+        for (vx_uint32 y = 0; y < h; y++) {
+            for (vx_uint32 x = 0; x < w; x++) {
+                vx_uint8 p = a8.at<vx_uint8>(x, y), q = b8.at<vx_uint8>(x, y);
+
+                ref8.at<vx_uint8>(x, y) = (vx_uint8)(op == VXCPU_BITWISE_AND ? (p & q) :
+                                                    op == VXCPU_BITWISE_OR ? (p | q) :
+                                                    op == VXCPU_BITWISE_XOR ? (p ^ q) : ~p);
+            }
+        }
+        CHECK_SAME(vx_uint8, got8, ref8, 0, "bitwise");
+    }
+
+    /* threshold, bounds also outside of u8 */
+    for (vx_uint32 c = 0; c < 4; c++) {
+        vx_enum type = (c & 1) ? VX_THRESHOLD_TYPE_RANGE : VX_THRESHOLD_TYPE_BINARY;
+        vx_int32 value = (vx_int32)rnd(300) - 20;
+        vx_int32 lower = (vx_int32)rnd(300) - 20, upper = (vx_int32)rnd(300) - 20;
+
+        CHECK(vxcpu_threshold(&a8.img, type, value, lower, upper, &got8.img) == VX_SUCCESS, "threshold");
+        for (vx_uint32 y = 0; y < h; y++) {
+            for (vx_uint32 x = 0; x < w; x++) {
+                vx_int32 v = a8.at<vx_uint8>(x, y);
+                bool on = (type == VX_THRESHOLD_TYPE_BINARY) ? (v > value) : !(v > upper || v < lower);
+
+                ref8.at<vx_uint8>(x, y) = on ? 255 : 0;
+            }
+        }
+        CHECK_SAME(vx_uint8, got8, ref8, 0, "threshold");
+    }
+
+    /* magnitude, exact */
+    CHECK(vxcpu_magnitude(&a16.img, &b16.img, &got16.img) == VX_SUCCESS, "magnitude");
+    for (vx_uint32 y = 0; y < h; y++) {
+        for (vx_uint32 x = 0; x < w; x++) {
+            vx_float64 gx = a16.at<vx_int16>(x, y), gy = b16.at<vx_int16>(x, y);
+
+            ref16.at<vx_int16>(x, y) = (vx_int16)std::min(sqrt(gx * gx + gy * gy) + 0.5, (vx_float64)INT16_MAX);
+        }
+    }
+    CHECK_SAME(vx_int16, got16, ref16, 0, "magnitude");
+
+    /* phase, within a step, 256 wraps to 0 */
+    CHECK(vxcpu_phase(&a16.img, &b16.img, &got8.img) == VX_SUCCESS, "phase");
+    {
+        vx_uint32 bad = 0;
+
+        for (vx_uint32 y = 0; y < h; y++) {
+            for (vx_uint32 x = 0; x < w; x++) {
+                vx_float64 a = atan2((vx_float64)b16.at<vx_int16>(x, y), (vx_float64)a16.at<vx_int16>(x, y));
+                vx_int32 ref = (vx_int32)floor((a < 0 ? a + 2 * M_PI : a) * 256.0 / (2 * M_PI) + 0.5) & 0xFF;
+                vx_int32 d = abs(ref - got8.at<vx_uint8>(x, y));
+
+                if (std::min(d, 256 - d) > 1)
+                    bad++;
+            }
+        }
+        CHECK(bad == 0, "phase %ux%u: %u pixels off by more than 1", w, h, bad);
+    }
+}
+
+static void test_filters(vx_uint32 w, vx_uint32 h)
+{
+    vx_border_mode_t border = random_border();
+    test_image in(w, h, VX_DF_IMAGE_U8, rnd(9));
+    test_image got8(w, h, VX_DF_IMAGE_U8, rnd(9)), ref8(w, h, VX_DF_IMAGE_U8);
+    test_image gx(w, h, VX_DF_IMAGE_S16, rnd(9)), gy(w, h, VX_DF_IMAGE_S16, rnd(9));
+    test_image ref16(w, h, VX_DF_IMAGE_S16);
+
+    fill_random(&in);
+
+    CHECK(vxcpu_box3x3(&in.img, &got8.img, &border) == VX_SUCCESS, "box3x3");
+    ref_convolve(in, k_box, 3, 3, 9, &ref8, border);
+    CHECK_SAME(vx_uint8, got8, ref8, 0, "box3x3");
+
+    CHECK(vxcpu_gaussian3x3(&in.img, &got8.img, &border) == VX_SUCCESS, "gaussian3x3");
+    ref_convolve(in, k_gauss3, 3, 3, 16, &ref8, border);
+    CHECK_SAME(vx_uint8, got8, ref8, 0, "gaussian3x3");
+
+    CHECK(vxcpu_gaussian5x5(&in.img, &got8.img, &border) == VX_SUCCESS, "gaussian5x5");
+    ref_convolve(in, k_gauss5, 5, 5, 256, &ref8, border);
+    CHECK_SAME(vx_uint8, got8, ref8, 0, "gaussian5x5");
+
+    CHECK(vxcpu_median3x3(&in.img, &got8.img, &border) == VX_SUCCESS, "median3x3");
+    ref_median3x3(in, &ref8, border);
+    CHECK_SAME(vx_uint8, got8, ref8, 0, "median3x3");
+
+    CHECK(vxcpu_sobel3x3(&in.img, &gx.img, &gy.img, &border) == VX_SUCCESS, "sobel3x3");
+    ref_convolve(in, k_sobel_x, 3, 3, 1, &ref16, border);
+    CHECK_SAME(vx_int16, gx, ref16, 0, "sobel3x3 x");
+    ref_convolve(in, k_sobel_y, 3, 3, 1, &ref16, border);
+    CHECK_SAME(vx_int16, gy, ref16, 0, "sobel3x3 y");
+    CHECK(vxcpu_sobel3x3(&in.img, NULL, &gy.img, &border) == VX_SUCCESS, "sobel3x3 y only");
+    CHECK_SAME(vx_int16, gy, ref16, 0, "sobel3x3 y only");
+
+    /* custom convolution: random odd sizes, scales and both outputs */
+    for (vx_uint32 c = 0; c < 3; c++) {
+        vx_uint32 cols = 1 + 2 * rnd(VXCPU_MAX_CONVOLUTION_DIM / 2 + 1);
+        vx_uint32 rows = 1 + 2 * rnd(VXCPU_MAX_CONVOLUTION_DIM / 2 + 1);
+        vx_uint32 scale = (c == 2) ? 3 : (1u << rnd(9));
+        vx_int16 coeffs[VXCPU_MAX_CONVOLUTION_DIM * VXCPU_MAX_CONVOLUTION_DIM];
+        vx_int32 ref_coeffs[VXCPU_MAX_CONVOLUTION_DIM * VXCPU_MAX_CONVOLUTION_DIM];
+        test_image *got = (c & 1) ? &gx : &got8;
+        test_image *ref = (c & 1) ? &ref16 : &ref8;
+
+        for (vx_uint32 k = 0; k < cols * rows; k++) {
+            coeffs[k] = (vx_int16)((vx_int32)rnd(512) - 256);
+            ref_coeffs[k] = coeffs[k];
+        }
+        CHECK(vxcpu_convolve(&in.img, coeffs, cols, rows, scale, &got->img, &border) == VX_SUCCESS, "convolve");
+        ref_convolve(in, ref_coeffs, cols, rows, scale, ref, border);
+        if (c & 1)
+            CHECK_SAME(vx_int16, *got, *ref, 0, "convolve");
+        else
+            CHECK_SAME(vx_uint8, *got, *ref, 0, "convolve");
+    }
+}
+
+/* rows y0..y1 - 1 of t, in place */
+static vxcpu_image_t band_view(const test_image &t, vx_uint32 y0, vx_uint32 y1)
+{
+    vxcpu_image_t band = t.img;
+
+    band.ptr = (vx_uint8 *)t.img.ptr + (size_t)y0 * t.img.stride;
+    band.start_y = y0;
+    band.end_y = y1;
+    return band;
+}
+
+/* rows y0..y1 - 1 of a w x h image, in a buffer of their own */
+static vxcpu_image_t band_buffer(std::vector<vx_uint8> *buf, vx_uint32 w, vx_uint32 h, vx_df_image format,
+                                    vx_uint32 y0, vx_uint32 y1)
+{
+    vx_uint32 bpp = (format == VX_DF_IMAGE_U8) ? 1 : 2;
+    vxcpu_image_t band = { NULL, (vx_int32)(w * bpp), w, h, format, y0, y1 };
+
+    buf->assign((size_t)band.stride * (y1 - y0), 0xCD);
+    band.ptr = buf->data();
+    return band;
+}
+
+/*
+ * gaussian3x3 -> sobel3x3 -> magnitude, phase, run in strips as a fused
+ * graph does: intermediates only hold the rows a strip needs, recomputed
+ * around each strip.  Must match the whole image run.
+ */
+static void test_bands(vx_uint32 w, vx_uint32 h)
+{
+    vx_border_mode_t border = random_border();
+    test_image in(w, h, VX_DF_IMAGE_U8, rnd(9));
+    test_image blur(w, h, VX_DF_IMAGE_U8), gx(w, h, VX_DF_IMAGE_S16), gy(w, h, VX_DF_IMAGE_S16);
+    test_image mag(w, h, VX_DF_IMAGE_S16), ref_mag(w, h, VX_DF_IMAGE_S16);
+    test_image phase(w, h, VX_DF_IMAGE_U8), ref_phase(w, h, VX_DF_IMAGE_U8);
+    vx_uint32 strip = 1 + rnd(h);
+
+    fill_random(&in);
+
+    vxcpu_gaussian3x3(&in.img, &blur.img, &border);
+    vxcpu_sobel3x3(&blur.img, &gx.img, &gy.img, &border);
+    vxcpu_magnitude(&gx.img, &gy.img, &ref_mag.img);
+    vxcpu_phase(&gx.img, &gy.img, &ref_phase.img);
+
+    for (vx_uint32 y0 = 0; y0 < h; y0 += strip) {
+        vx_uint32 y1 = std::min(h, y0 + strip);
+        /* rows needed, walking back from the outputs */
+        vx_uint32 b0 = y0 ? y0 - 1 : 0, b1 = std::min(h, y1 + 1);
+        std::vector<vx_uint8> src_buf, blur_buf, gx_buf, gy_buf;
+        vxcpu_image_t src = band_buffer(&src_buf, w, h, VX_DF_IMAGE_U8, b0 ? b0 - 1 : 0, std::min(h, b1 + 1));
+        vxcpu_image_t blur_band = band_buffer(&blur_buf, w, h, VX_DF_IMAGE_U8, b0, b1);
+        vxcpu_image_t gx_band = band_buffer(&gx_buf, w, h, VX_DF_IMAGE_S16, y0, y1);
+        vxcpu_image_t gy_band = band_buffer(&gy_buf, w, h, VX_DF_IMAGE_S16, y0, y1);
+        vxcpu_image_t mag_band = band_view(mag, y0, y1);
+        vxcpu_image_t phase_band = band_view(phase, y0, y1);
+
+        /* a copy, so that reading outside the band shows up */
+        for (vx_uint32 y = src.start_y; y < src.end_y; y++)
+            memcpy((vx_uint8 *)src.ptr + (size_t)(y - src.start_y) * src.stride, &in.at<vx_uint8>(0, y), w);
+
+        CHECK(vxcpu_gaussian3x3(&src, &blur_band, &border) == VX_SUCCESS, "gaussian3x3 band");
+        CHECK(vxcpu_sobel3x3(&blur_band, &gx_band, &gy_band, &border) == VX_SUCCESS, "sobel3x3 band");
+        CHECK(vxcpu_magnitude(&gx_band, &gy_band, &mag_band) == VX_SUCCESS, "magnitude band");
+        CHECK(vxcpu_phase(&gx_band, &gy_band, &phase_band) == VX_SUCCESS, "phase band");
+    }
+
+    CHECK_SAME(vx_int16, mag, ref_mag, 0, "magnitude in bands");
+    CHECK_SAME(vx_uint8, phase, ref_phase, 0, "phase in bands");
+}
+
+static void test_statistics(vx_uint32 w, vx_uint32 h)
+{
+    test_image in(w, h, VX_DF_IMAGE_U8, rnd(9));
+    test_image got(w, h, VX_DF_IMAGE_U32, rnd(9)), ref(w, h, VX_DF_IMAGE_U32);
+    vx_uint32 num_bins = 1 + rnd(256);
+    vx_int32 offset = (vx_int32)rnd(64);
+    vx_uint32 range = num_bins + rnd(257 - num_bins);
+    std::vector<vx_uint32> bins(num_bins), ref_bins(num_bins, 0);
+    vx_uint32 window = range / num_bins;
+
+    fill_random(&in);
+
+    CHECK(vxcpu_histogram(&in.img, bins.data(), num_bins, offset, range) == VX_SUCCESS, "histogram");
+    for (vx_uint32 y = 0; y < h; y++) {
+        for (vx_uint32 x = 0; x < w; x++) {
+            vx_int32 v = in.at<vx_uint8>(x, y);
+
+            if (v >= offset && v < offset + (vx_int32)range && (vx_uint32)(v - offset) / window < num_bins)
+                ref_bins[(v - offset) / window]++;
+        }
+    }
+    CHECK(bins == ref_bins, "histogram %ux%u, %u bins from %d over %u", w, h, num_bins, offset, range);
+
+    CHECK(vxcpu_integral_image(&in.img, &got.img) == VX_SUCCESS, "integral image");
+    for (vx_uint32 y = 0; y < h; y++) {
+        for (vx_uint32 x = 0; x < w; x++) {
+            vx_uint32 v = in.at<vx_uint8>(x, y);
+
+            v += x ? ref.at<vx_uint32>(x - 1, y) : 0;
+            v += y ? ref.at<vx_uint32>(x, y - 1) : 0;
+            v -= (x && y) ? ref.at<vx_uint32>(x - 1, y - 1) : 0;
+            ref.at<vx_uint32>(x, y) = v;
+        }
+    }
+    CHECK_SAME(vx_uint32, got, ref, 0, "integral image");
+}
+
+static void test_geometry(vx_uint32 w, vx_uint32 h)
+{
+    static const vx_enum interps[] = {
+        VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR, VX_INTERPOLATION_TYPE_BILINEAR, VX_INTERPOLATION_TYPE_AREA,
+    };
+    vx_border_mode_t border = random_border();
+    test_image in(w, h, VX_DF_IMAGE_U8, rnd(9));
+
+    if (rnd(2))
+        fill_random(&in);
+    else
+        fill_texture(&in, 0.0f, 0.0f);
+
+    for (vx_uint32 i = 0; i < 3; i++) {
+        vx_uint32 ow = 1 + rnd(2 * w), oh = 1 + rnd(2 * h);
+        test_image got(ow, oh, VX_DF_IMAGE_U8, rnd(9)), ref(ow, oh, VX_DF_IMAGE_U8);
+
+        CHECK(vxcpu_scale_image(&in.img, &got.img, interps[i], &border) == VX_SUCCESS, "scale");
+        ref_scale(in, &ref, interps[i], border);
+        /* fixed point against float blending */
+        CHECK_SAME(vx_uint8, got, ref, interps[i] == VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR ? 0 : 1,
+                   interps[i] == VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR ? "scale nearest" :
+                   interps[i] == VX_INTERPOLATION_TYPE_BILINEAR ? "scale bilinear" : "scale area");
+    }
+
+    for (vx_uint32 i = 0; i < 4; i++) {
+        vx_bool perspective = (i & 2) ? vx_true_e : vx_false_e;
+        vx_enum interp = interps[i & 1];
+        vx_float32 angle = (vx_float32)rnd(360) * 0.0174533f;
+        vx_float32 zoom = 0.5f + (vx_float32)rnd(100) / 50.0f;
+        vx_float32 m[9] = {
+            zoom * cosf(angle), zoom * sinf(angle), 0.0f,
+            -zoom * sinf(angle), zoom * cosf(angle), 0.0f,
+            (vx_float32)rnd(w) - w / 2.0f, (vx_float32)rnd(h) - h / 2.0f, 1.0f,
+        };
+        test_image got(w, h, VX_DF_IMAGE_U8, rnd(9)), ref(w, h, VX_DF_IMAGE_U8);
+        vx_uint32 diff, bad;
+
+        if (perspective) {
+            m[2] = ((vx_float32)rnd(100) - 50.0f) * 1e-5f;
+            m[5] = ((vx_float32)rnd(100) - 50.0f) * 1e-5f;
+        } else {
+            /* 2x3 column major */
+            m[4] = m[6];
+            m[5] = m[7];
+        }
+
+        if (perspective)
+            CHECK(vxcpu_warp_perspective(&in.img, m, interp, &got.img, &border) == VX_SUCCESS, "warp");
+        else
+            CHECK(vxcpu_warp_affine(&in.img, m, interp, &got.img, &border) == VX_SUCCESS, "warp");
+        ref_warp(in, m, perspective, interp, &ref, border);
+
+        /* a coordinate right on a pixel edge may round the other way in the vector math */
+        compare<vx_uint8>(got, ref, 1, &diff, &bad);
+        CHECK(diff <= w * h / 100 + 1, "warp %s %s %ux%u: %u of %u pixels differ",
+              perspective ? "perspective" : "affine",
+              interp == VX_INTERPOLATION_TYPE_BILINEAR ? "bilinear" : "nearest", w, h, diff, w * h);
+    }
+
+    /* one pyramid step, both standard scales */
+    for (vx_uint32 i = 0; i < 2; i++) {
+        vx_float32 scale = i ? 0.8408964f : 0.5f;
+        vx_uint32 ow = (vx_uint32)ceilf(w * scale), oh = (vx_uint32)ceilf(h * scale);
+        test_image got(ow, oh, VX_DF_IMAGE_U8, rnd(9)), ref(ow, oh, VX_DF_IMAGE_U8);
+
+        CHECK(vxcpu_pyramid_level(&in.img, &got.img, &border) == VX_SUCCESS, "pyramid");
+        ref_pyramid_level(in, &ref, border);
+        CHECK_SAME(vx_uint8, got, ref, 0, "pyramid");
+    }
+}
+
+/* a shifted texture: points have to follow the shift */
+static void test_optical_flow(void)
+{
+    const vx_uint32 w = 320, h = 240, num_levels = 4;
+    const vx_float32 dx = 5.3f, dy = -3.6f;
+    vx_border_mode_t border = { VX_BORDER_MODE_REPLICATE, 0 };
+    std::vector<test_image> old_pyr, new_pyr;
+    std::vector<vxcpu_image_t> old_levels, new_levels;
+    std::vector<vx_keypoint_t> old_points, new_points;
+    vxcpu_optflow_params_t params = { VX_TERM_CRITERIA_BOTH, 0.01f, 20, vx_false_e, 9, 0.5f };
+    vx_uint32 tracked = 0, good = 0;
+
+    for (vx_uint32 l = 0; l < num_levels; l++) {
+        vx_uint32 lw = (vx_uint32)ceilf(w * powf(0.5f, (vx_float32)l));
+        vx_uint32 lh = (vx_uint32)ceilf(h * powf(0.5f, (vx_float32)l));
+
+        old_pyr.push_back(test_image(lw, lh, VX_DF_IMAGE_U8));
+        new_pyr.push_back(test_image(lw, lh, VX_DF_IMAGE_U8));
+    }
+    fill_texture(&old_pyr[0], 0.0f, 0.0f);
+    fill_texture(&new_pyr[0], dx, dy);
+    for (vx_uint32 l = 1; l < num_levels; l++) {
+        vxcpu_pyramid_level(&old_pyr[l - 1].img, &old_pyr[l].img, &border);
+        vxcpu_pyramid_level(&new_pyr[l - 1].img, &new_pyr[l].img, &border);
+    }
+    for (vx_uint32 l = 0; l < num_levels; l++) {
+        old_levels.push_back(old_pyr[l].img);
+        new_levels.push_back(new_pyr[l].img);
+    }
+
+    for (vx_int32 y = 30; y < (vx_int32)h - 30; y += 10) {
+        for (vx_int32 x = 30; x < (vx_int32)w - 30; x += 10) {
+            vx_keypoint_t p = { x, y, 100.0f, 0.0f, 0.0f, 1, 0.0f };
+
+            old_points.push_back(p);
+        }
+    }
+    new_points.resize(old_points.size());
+
+    CHECK(vxcpu_optical_flow_pyr_lk(old_levels.data(), new_levels.data(), num_levels, old_points.data(), NULL,
+                                    new_points.data(), old_points.size(), &params) == VX_SUCCESS, "optical flow");
+    for (size_t i = 0; i < old_points.size(); i++) {
+        if (!new_points[i].tracking_status)
+            continue;
+        tracked++;
+        if (fabsf(new_points[i].x - (old_points[i].x + dx)) <= 1.0f &&
+            fabsf(new_points[i].y - (old_points[i].y + dy)) <= 1.0f)
+            good++;
+    }
+    CHECK(tracked >= old_points.size() * 9 / 10 && good >= tracked * 9 / 10,
+          "optical flow: %u of %zu tracked, %u of them on target", tracked, old_points.size(), good);
+}
+
+/*
+ * Throughput
+ */
+
+static double now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static double best_ms(const std::function<void(void)> &body, vx_uint32 runs)
+{
+    double best = 1e30;
+
+    for (vx_uint32 i = 0; i < runs; i++) {
+        double start = now_ms();
+
+        body();
+        best = std::min(best, now_ms() - start);
+    }
+    return best;
+}
+
+struct bench_case {
+    const char *name;
+    std::function<void(void)> ref;
+    std::function<void(void)> cpu;
+};
+
+static void run_throughput(vx_uint32 threads)
+{
+    const vx_uint32 w = 1920, h = 1080;
+    vx_border_mode_t border = { VX_BORDER_MODE_REPLICATE, 0 };
+    test_image a8(w, h, VX_DF_IMAGE_U8), b8(w, h, VX_DF_IMAGE_U8), o8(w, h, VX_DF_IMAGE_U8);
+    test_image a16(w, h, VX_DF_IMAGE_S16), b16(w, h, VX_DF_IMAGE_S16), o16(w, h, VX_DF_IMAGE_S16);
+    test_image o32(w, h, VX_DF_IMAGE_U32), half(w / 2, h / 2, VX_DF_IMAGE_U8);
+    vx_uint32 bins[256];
+    vx_int16 coeffs[25];
+    vx_int32 ref_coeffs[25];
+    vx_float32 affine[6] = { 0.9f, 0.1f, -0.1f, 0.9f, 40.0f, 20.0f };
+    std::vector<bench_case> cases;
+
+    fill_random(&a8);
+    fill_random(&b8);
+    fill_random(&a16);
+    fill_random(&b16);
+    for (vx_uint32 k = 0; k < 25; k++) {
+        coeffs[k] = (vx_int16)(k % 7) - 3;
+        ref_coeffs[k] = coeffs[k];
+    }
+
+    cases.push_back({ "absdiff u8",
+        [&] { for (vx_uint32 y = 0; y < h; y++) for (vx_uint32 x = 0; x < w; x++)
+                o8.at<vx_uint8>(x, y) = (vx_uint8)abs(a8.at<vx_uint8>(x, y) - b8.at<vx_uint8>(x, y)); },
+        [&] { vxcpu_absdiff(&a8.img, &b8.img, &o8.img); } });
+    cases.push_back({ "add u8 sat",
+        [&] { for (vx_uint32 y = 0; y < h; y++) for (vx_uint32 x = 0; x < w; x++)
+                o8.at<vx_uint8>(x, y) = (vx_uint8)sat(a8.at<vx_uint8>(x, y) + b8.at<vx_uint8>(x, y), 0, 255); },
+        [&] { vxcpu_arithmetic(&a8.img, &b8.img, VX_CONVERT_POLICY_SATURATE, vx_false_e, &o8.img); } });
+    cases.push_back({ "magnitude",
+        [&] { for (vx_uint32 y = 0; y < h; y++) for (vx_uint32 x = 0; x < w; x++) {
+                vx_float64 gx = a16.at<vx_int16>(x, y), gy = b16.at<vx_int16>(x, y);
+                o16.at<vx_int16>(x, y) = (vx_int16)std::min(sqrt(gx * gx + gy * gy) + 0.5, 32767.0); } },
+        [&] { vxcpu_magnitude(&a16.img, &b16.img, &o16.img); } });
+    cases.push_back({ "phase",
+        [&] { for (vx_uint32 y = 0; y < h; y++) for (vx_uint32 x = 0; x < w; x++) {
+                vx_float64 a = atan2((vx_float64)b16.at<vx_int16>(x, y), (vx_float64)a16.at<vx_int16>(x, y));
+                o8.at<vx_uint8>(x, y) = (vx_uint8)((vx_int32)((a < 0 ? a + 2 * M_PI : a) * 40.74 + 0.5)); } },
+        [&] { vxcpu_phase(&a16.img, &b16.img, &o8.img); } });
+    cases.push_back({ "box3x3",
+        [&] { ref_convolve(a8, k_box, 3, 3, 9, &o8, border); },
+        [&] { vxcpu_box3x3(&a8.img, &o8.img, &border); } });
+    cases.push_back({ "gaussian3x3",
+        [&] { ref_convolve(a8, k_gauss3, 3, 3, 16, &o8, border); },
+        [&] { vxcpu_gaussian3x3(&a8.img, &o8.img, &border); } });
+    cases.push_back({ "median3x3",
+        [&] { ref_median3x3(a8, &o8, border); },
+        [&] { vxcpu_median3x3(&a8.img, &o8.img, &border); } });
+    cases.push_back({ "sobel3x3",
+        [&] { ref_convolve(a8, k_sobel_x, 3, 3, 1, &o16, border); ref_convolve(a8, k_sobel_y, 3, 3, 1, &o16, border); },
+        [&] { vxcpu_sobel3x3(&a8.img, &o16.img, &a16.img, &border); } });
+    cases.push_back({ "convolve 5x5",
+        [&] { ref_convolve(a8, ref_coeffs, 5, 5, 16, &o16, border); },
+        [&] { vxcpu_convolve(&a8.img, coeffs, 5, 5, 16, &o16.img, &border); } });
+    cases.push_back({ "threshold",
+        [&] { for (vx_uint32 y = 0; y < h; y++) for (vx_uint32 x = 0; x < w; x++)
+                o8.at<vx_uint8>(x, y) = a8.at<vx_uint8>(x, y) > 100 ? 255 : 0; },
+        [&] { vxcpu_threshold(&a8.img, VX_THRESHOLD_TYPE_BINARY, 100, 0, 0, &o8.img); } });
+    cases.push_back({ "histogram",
+        [&] { memset(bins, 0, sizeof(bins)); for (vx_uint32 y = 0; y < h; y++) for (vx_uint32 x = 0; x < w; x++)
+                bins[a8.at<vx_uint8>(x, y)]++; },
+        [&] { vxcpu_histogram(&a8.img, bins, 256, 0, 256); } });
+    cases.push_back({ "integral image",
+        [&] { for (vx_uint32 y = 0; y < h; y++) { vx_uint32 s = 0; for (vx_uint32 x = 0; x < w; x++) {
+                s += a8.at<vx_uint8>(x, y); o32.at<vx_uint32>(x, y) = s + (y ? o32.at<vx_uint32>(x, y - 1) : 0); } } },
+        [&] { vxcpu_integral_image(&a8.img, &o32.img); } });
+    cases.push_back({ "scale bilinear 1/2",
+        [&] { ref_scale(a8, &half, VX_INTERPOLATION_TYPE_BILINEAR, border); },
+        [&] { vxcpu_scale_image(&a8.img, &half.img, VX_INTERPOLATION_TYPE_BILINEAR, &border); } });
+    cases.push_back({ "warp affine bilinear",
+        [&] { ref_warp(a8, affine, vx_false_e, VX_INTERPOLATION_TYPE_BILINEAR, &o8, border); },
+        [&] { vxcpu_warp_affine(&a8.img, affine, VX_INTERPOLATION_TYPE_BILINEAR, &o8.img, &border); } });
+    cases.push_back({ "pyramid level 1/2",
+        [&] { ref_pyramid_level(a8, &half, border); },
+        [&] { vxcpu_pyramid_level(&a8.img, &half.img, &border); } });
+
+    printf("\n%-22s %10s %10s %10s %8s %8s\n", "1920x1080", "ref ms", "1 thr ms", "N thr ms", "simd x", "total x");
+    for (size_t i = 0; i < cases.size(); i++) {
+        double ref_ms = best_ms(cases[i].ref, 2);
+        double one_ms, all_ms;
+
+        vxcpu_parallel_init(1);
+        one_ms = best_ms(cases[i].cpu, 5);
+        vxcpu_parallel_deinit();
+
+        vxcpu_parallel_init(threads);
+        all_ms = best_ms(cases[i].cpu, 5);
+        vxcpu_parallel_deinit();
+
+        printf("%-22s %10.2f %10.2f %10.2f %8.1f %8.1f\n", cases[i].name, ref_ms, one_ms, all_ms,
+               ref_ms / one_ms, ref_ms / all_ms);
+    }
+    printf("(N = %u threads)\n", threads);
+}
+
+int main(int argc, char **argv)
+{
+    vx_uint32 rounds = (argc > 1) ? (vx_uint32)atoi(argv[1]) : 20;
+    vx_uint32 threads = (argc > 2) ? (vx_uint32)atoi(argv[2]) : 0;
+
+    srand(1234);
+
+    /* same checks on one thread and on the pool, tiling must not change results */
+    for (vx_uint32 pass = 0; pass < 2; pass++) {
+        vxcpu_parallel_init(pass ? threads : 1);
+        for (vx_uint32 r = 0; r < rounds; r++) {
+            /* small sizes hit the scalar tails, large ones the tiling */
+            vx_uint32 w = (r < rounds / 2) ? 1 + rnd(40) : 64 + rnd(700);
+            vx_uint32 h = (r < rounds / 2) ? 1 + rnd(40) : 16 + rnd(300);
+
+            test_pixelwise(w, h);
+            test_filters(w, h);
+            test_bands(w, h);
+            test_statistics(w, h);
+            test_geometry(w, h);
+        }
+        test_optical_flow();
+        printf("conformance on %u thread(s): %d failures\n", vxcpu_parallel_threads(), g_failures);
+        vxcpu_parallel_deinit();
+    }
+
+    if (g_failures == 0)
+        run_throughput(threads ? threads : (vx_uint32)std::max(1L, sysconf(_SC_NPROCESSORS_ONLN)));
+
+    return g_failures;
+}
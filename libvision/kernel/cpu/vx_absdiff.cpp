@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelAbsDiff"
+#include <cutils/log.h>
+
+#include "vxcpu_kernel_module.h"
+
+static vx_param_description_t absdiff_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+static vx_status VX_CALLBACK vxAbsDiffKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = VX_SUCCESS;
+    vxcpu_image_access_t src1, src2, dst;
+
+    status |= vxcpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &src1);
+    status |= vxcpuAccessImage((vx_image)parameters[1], VX_READ_ONLY, &src2);
+    status |= vxcpuAccessImage((vx_image)parameters[2], VX_WRITE_ONLY, &dst);
+    if (status == VX_SUCCESS) {
+        status = vxcpu_absdiff(&src1.plane, &src2.plane, &dst.plane);
+        if (status != VX_SUCCESS)
+            VXLOGE("absdiff fails, err:%d, node:%p, num:%d", status, node, num);
+    }
+
+    status |= vxcpuCommitImage(&src1);
+    status |= vxcpuCommitImage(&src2);
+    status |= vxcpuCommitImage(&dst);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxAbsDiffBand(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                            const vx_image_band_t bands[])
+{
+    vx_status status;
+    vxcpu_image_t src1, src2, dst;
+
+    vxcpuBandImage(&bands[0], &src1);
+    vxcpuBandImage(&bands[1], &src2);
+    vxcpuBandImage(&bands[2], &dst);
+
+    status = vxcpu_absdiff(&src1, &src2, &dst);
+    if (status != VX_SUCCESS)
+        VXLOGE("absdiff band fails, err:%d, node:%p, num:%d", status, node, num);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxAbsDiffInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format = 0;
+
+    if (index == 0) {
+        if (vxcpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) {
+            if ((format == VX_DF_IMAGE_U8) || (format == VX_DF_IMAGE_S16))
+                status = VX_SUCCESS;
+        }
+    } else if (index == 1) {
+        status = vxcpuCheckSameImageParam(node, 0, 1, vx_true_e);
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxAbsDiffOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width = 0, height = 0;
+    vx_df_image format = 0;
+
+    if (index == 2) {
+        status = vxcpuQueryImageParam(node, 0, &width, &height, &format);
+        if (status == VX_SUCCESS)
+            status = vxcpuSetMetaImage(meta, width, height, format);
+    }
+
+    return status;
+}
+
+vx_kernel_description_t absdiff_cpu_kernel = {
+    VX_KERNEL_ABSDIFF,
+    "org.khronos.openvx.absdiff",
+    vxAbsDiffKernel,
+    absdiff_kernel_params, dimof(absdiff_kernel_params),
+    vxAbsDiffInputValidator,
+    vxAbsDiffOutputValidator,
+    NULL,
+    NULL,
+};
+
+vxcpu_band_description_t absdiff_cpu_band = {
+    VX_KERNEL_ABSDIFF,
+    vxAbsDiffBand,
+    0,
+};
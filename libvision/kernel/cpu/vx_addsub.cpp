@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelAddSub"
+#include <cutils/log.h>
+
+#include "vxcpu_kernel_module.h"
+
+static vx_param_description_t arithmetic_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+static vx_status vxArithmeticKernel(const vx_reference parameters[], vx_bool subtract)
+{
+    vx_status status = VX_SUCCESS;
+    vxcpu_image_access_t src1, src2, dst;
+    vx_enum policy = VX_CONVERT_POLICY_WRAP;
+
+    status = vxReadScalarValue((vx_scalar)parameters[2], &policy);
+    if (status != VX_SUCCESS) {
+        VXLOGE("reading policy fails, err:%d", status);
+        return status;
+    }
+
+    status |= vxcpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &src1);
+    status |= vxcpuAccessImage((vx_image)parameters[1], VX_READ_ONLY, &src2);
+    status |= vxcpuAccessImage((vx_image)parameters[3], VX_WRITE_ONLY, &dst);
+    if (status == VX_SUCCESS) {
+        status = vxcpu_arithmetic(&src1.plane, &src2.plane, policy, subtract, &dst.plane);
+        if (status != VX_SUCCESS)
+            VXLOGE("%s fails, err:%d", subtract ? "subtract" : "add", status);
+    }
+
+    status |= vxcpuCommitImage(&src1);
+    status |= vxcpuCommitImage(&src2);
+    status |= vxcpuCommitImage(&dst);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxAddKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = vxArithmeticKernel(parameters, vx_false_e);
+    if (status != VX_SUCCESS)
+        VXLOGE("add kernel fails, node:%p, num:%d", node, num);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxSubtractKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = vxArithmeticKernel(parameters, vx_true_e);
+    if (status != VX_SUCCESS)
+        VXLOGE("subtract kernel fails, node:%p, num:%d", node, num);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxArithmeticBand(const vx_reference parameters[], const vx_image_band_t bands[], vx_bool subtract)
+{
+    vx_status status;
+    vx_enum policy = VX_CONVERT_POLICY_WRAP;
+    vxcpu_image_t src1, src2, dst;
+
+    status = vxReadScalarValue((vx_scalar)parameters[2], &policy);
+    if (status != VX_SUCCESS) {
+        VXLOGE("reading policy fails, err:%d", status);
+        return status;
+    }
+
+    vxcpuBandImage(&bands[0], &src1);
+    vxcpuBandImage(&bands[1], &src2);
+    vxcpuBandImage(&bands[3], &dst);
+
+    status = vxcpu_arithmetic(&src1, &src2, policy, subtract, &dst);
+    if (status != VX_SUCCESS)
+        VXLOGE("%s band fails, err:%d", subtract ? "subtract" : "add", status);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxAddBand(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                            const vx_image_band_t bands[])
+{
+    vx_status status = vxArithmeticBand(parameters, bands, vx_false_e);
+    if (status != VX_SUCCESS)
+        VXLOGE("add band fails, node:%p, num:%d", node, num);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxSubtractBand(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                            const vx_image_band_t bands[])
+{
+    vx_status status = vxArithmeticBand(parameters, bands, vx_true_e);
+    if (status != VX_SUCCESS)
+        VXLOGE("subtract band fails, node:%p, num:%d", node, num);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxArithmeticInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format = 0;
+    vx_enum type = 0;
+
+    if ((index == 0) || (index == 1)) {
+        if (vxcpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) {
+            if ((format == VX_DF_IMAGE_U8) || (format == VX_DF_IMAGE_S16))
+                status = VX_SUCCESS;
+        }
+        if ((status == VX_SUCCESS) && (index == 1))
+            status = vxcpuCheckSameImageParam(node, 0, 1, vx_false_e);
+    } else if (index == 2) {
+        if (vxcpuQueryScalarParam(node, index, &type) == VX_SUCCESS)
+            status = (type == VX_TYPE_ENUM) ? VX_SUCCESS : VX_ERROR_INVALID_TYPE;
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxArithmeticOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width = 0, height = 0;
+    vx_df_image format[3] = {0, 0, 0};
+
+    if (index == 3) {
+        status = vxcpuQueryImageParam(node, 0, &width, &height, &format[0]);
+        status |= vxcpuQueryImageParam(node, 1, NULL, NULL, &format[1]);
+        status |= vxcpuQueryImageParam(node, 3, NULL, NULL, &format[2]);
+        if (status != VX_SUCCESS)
+            return VX_ERROR_INVALID_PARAMETERS;
+
+        /* U8 only when both inputs are U8 and the output does not ask for S16 */
+        if ((format[0] == VX_DF_IMAGE_U8) && (format[1] == VX_DF_IMAGE_U8) && (format[2] != VX_DF_IMAGE_S16))
+            status = vxcpuSetMetaImage(meta, width, height, VX_DF_IMAGE_U8);
+        else
+            status = vxcpuSetMetaImage(meta, width, height, VX_DF_IMAGE_S16);
+    }
+
+    return status;
+}
+
+vx_kernel_description_t add_cpu_kernel = {
+    VX_KERNEL_ADD,
+    "org.khronos.openvx.add",
+    vxAddKernel,
+    arithmetic_kernel_params, dimof(arithmetic_kernel_params),
+    vxArithmeticInputValidator,
+    vxArithmeticOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t subtract_cpu_kernel = {
+    VX_KERNEL_SUBTRACT,
+    "org.khronos.openvx.subtract",
+    vxSubtractKernel,
+    arithmetic_kernel_params, dimof(arithmetic_kernel_params),
+    vxArithmeticInputValidator,
+    vxArithmeticOutputValidator,
+    NULL,
+    NULL,
+};
+
+vxcpu_band_description_t add_cpu_band = {
+    VX_KERNEL_ADD,
+    vxAddBand,
+    0,
+};
+
+vxcpu_band_description_t subtract_cpu_band = {
+    VX_KERNEL_SUBTRACT,
+    vxSubtractBand,
+    0,
+};
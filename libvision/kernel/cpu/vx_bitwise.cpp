@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelBitwise"
+#include <cutils/log.h>
+
+#include "vxcpu_kernel_module.h"
+
+static vx_param_description_t binary_bitwise_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+static vx_param_description_t unary_bitwise_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+static vx_status vxBitwiseKernel(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_enum op)
+{
+    vx_status status = VX_SUCCESS;
+    vxcpu_image_access_t src1, src2, dst;
+    vx_bool unary = (op == VXCPU_BITWISE_NOT) ? vx_true_e : vx_false_e;
+
+    if (num != (unary ? dimof(unary_bitwise_kernel_params) : dimof(binary_bitwise_kernel_params)))
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    status |= vxcpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &src1);
+    if (unary)
+        src2 = src1;
+    else
+        status |= vxcpuAccessImage((vx_image)parameters[1], VX_READ_ONLY, &src2);
+    status |= vxcpuAccessImage((vx_image)parameters[num - 1], VX_WRITE_ONLY, &dst);
+    if (status == VX_SUCCESS) {
+        status = vxcpu_bitwise(&src1.plane, &src2.plane, op, &dst.plane);
+        if (status != VX_SUCCESS)
+            VXLOGE("bitwise op(%d) fails, err:%d, node:%p", op, status, node);
+    }
+
+    status |= vxcpuCommitImage(&src1);
+    if (!unary)
+        status |= vxcpuCommitImage(&src2);
+    status |= vxcpuCommitImage(&dst);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxAndKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = vxBitwiseKernel(node, parameters, num, VXCPU_BITWISE_AND);
+    EXYNOS_CPU_KERNEL_IF_OUT();
+    return status;
+}
+
+static vx_status VX_CALLBACK vxOrKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = vxBitwiseKernel(node, parameters, num, VXCPU_BITWISE_OR);
+    EXYNOS_CPU_KERNEL_IF_OUT();
+    return status;
+}
+
+static vx_status VX_CALLBACK vxXorKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = vxBitwiseKernel(node, parameters, num, VXCPU_BITWISE_XOR);
+    EXYNOS_CPU_KERNEL_IF_OUT();
+    return status;
+}
+
+static vx_status VX_CALLBACK vxNotKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = vxBitwiseKernel(node, parameters, num, VXCPU_BITWISE_NOT);
+    EXYNOS_CPU_KERNEL_IF_OUT();
+    return status;
+}
+
+static vx_status vxBitwiseBand(vx_node node, const vx_image_band_t bands[], vx_uint32 num, vx_enum op)
+{
+    vx_status status;
+    vxcpu_image_t src1, src2, dst;
+    vx_bool unary = (op == VXCPU_BITWISE_NOT) ? vx_true_e : vx_false_e;
+
+    if (num != (unary ? dimof(unary_bitwise_kernel_params) : dimof(binary_bitwise_kernel_params)))
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    vxcpuBandImage(&bands[0], &src1);
+    if (unary)
+        src2 = src1;
+    else
+        vxcpuBandImage(&bands[1], &src2);
+    vxcpuBandImage(&bands[num - 1], &dst);
+
+    status = vxcpu_bitwise(&src1, &src2, op, &dst);
+    if (status != VX_SUCCESS)
+        VXLOGE("bitwise op(%d) band fails, err:%d, node:%p", op, status, node);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxAndBand(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                            const vx_image_band_t bands[])
+{
+    return vxBitwiseBand(node, bands, num, VXCPU_BITWISE_AND);
+}
+
+static vx_status VX_CALLBACK vxOrBand(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                            const vx_image_band_t bands[])
+{
+    return vxBitwiseBand(node, bands, num, VXCPU_BITWISE_OR);
+}
+
+static vx_status VX_CALLBACK vxXorBand(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                            const vx_image_band_t bands[])
+{
+    return vxBitwiseBand(node, bands, num, VXCPU_BITWISE_XOR);
+}
+
+static vx_status VX_CALLBACK vxNotBand(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                            const vx_image_band_t bands[])
+{
+    return vxBitwiseBand(node, bands, num, VXCPU_BITWISE_NOT);
+}
+
+static vx_status VX_CALLBACK vxBinaryBitwiseInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format = 0;
+
+    if ((index == 0) || (index == 1)) {
+        if (vxcpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) {
+            if (format == VX_DF_IMAGE_U8)
+                status = VX_SUCCESS;
+        }
+        if ((status == VX_SUCCESS) && (index == 1))
+            status = vxcpuCheckSameImageParam(node, 0, 1, vx_true_e);
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxBinaryBitwiseOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width = 0, height = 0;
+
+    if (index == 2) {
+        status = vxcpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            status = vxcpuSetMetaImage(meta, width, height, VX_DF_IMAGE_U8);
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxUnaryBitwiseInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format = 0;
+
+    if (index == 0) {
+        if (vxcpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) {
+            if (format == VX_DF_IMAGE_U8)
+                status = VX_SUCCESS;
+        }
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxUnaryBitwiseOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width = 0, height = 0;
+
+    if (index == 1) {
+        status = vxcpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            status = vxcpuSetMetaImage(meta, width, height, VX_DF_IMAGE_U8);
+    }
+
+    return status;
+}
+
+vx_kernel_description_t and_cpu_kernel = {
+    VX_KERNEL_AND,
+    "org.khronos.openvx.and",
+    vxAndKernel,
+    binary_bitwise_kernel_params, dimof(binary_bitwise_kernel_params),
+    vxBinaryBitwiseInputValidator,
+    vxBinaryBitwiseOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t or_cpu_kernel = {
+    VX_KERNEL_OR,
+    "org.khronos.openvx.or",
+    vxOrKernel,
+    binary_bitwise_kernel_params, dimof(binary_bitwise_kernel_params),
+    vxBinaryBitwiseInputValidator,
+    vxBinaryBitwiseOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t xor_cpu_kernel = {
+    VX_KERNEL_XOR,
+    "org.khronos.openvx.xor",
+    vxXorKernel,
+    binary_bitwise_kernel_params, dimof(binary_bitwise_kernel_params),
+    vxBinaryBitwiseInputValidator,
+    vxBinaryBitwiseOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t not_cpu_kernel = {
+    VX_KERNEL_NOT,
+    "org.khronos.openvx.not",
+    vxNotKernel,
+    unary_bitwise_kernel_params, dimof(unary_bitwise_kernel_params),
+    vxUnaryBitwiseInputValidator,
+    vxUnaryBitwiseOutputValidator,
+    NULL,
+    NULL,
+};
+
+vxcpu_band_description_t and_cpu_band = {
+    VX_KERNEL_AND,
+    vxAndBand,
+    0,
+};
+
+vxcpu_band_description_t or_cpu_band = {
+    VX_KERNEL_OR,
+    vxOrBand,
+    0,
+};
+
+vxcpu_band_description_t xor_cpu_band = {
+    VX_KERNEL_XOR,
+    vxXorBand,
+    0,
+};
+
+vxcpu_band_description_t not_cpu_band = {
+    VX_KERNEL_NOT,
+    vxNotBand,
+    0,
+};
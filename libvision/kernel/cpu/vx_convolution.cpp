@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelConvolution"
+#include <cutils/log.h>
+
+#include "vxcpu_kernel_module.h"
+
+static vx_param_description_t convolution_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_CONVOLUTION, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+static vx_status vxReadConvolution(vx_convolution conv, vx_int16 *coeffs, vx_size *columns, vx_size *rows,
+                                        vx_uint32 *scale)
+{
+    vx_status status = VX_SUCCESS;
+
+    status |= vxQueryConvolution(conv, VX_CONVOLUTION_ATTRIBUTE_COLUMNS, columns, sizeof(*columns));
+    status |= vxQueryConvolution(conv, VX_CONVOLUTION_ATTRIBUTE_ROWS, rows, sizeof(*rows));
+    status |= vxQueryConvolution(conv, VX_CONVOLUTION_ATTRIBUTE_SCALE, scale, sizeof(*scale));
+    if ((status != VX_SUCCESS) || (*columns > VXCPU_MAX_CONVOLUTION_DIM) || (*rows > VXCPU_MAX_CONVOLUTION_DIM)) {
+        VXLOGE("convolution is not supported, %zux%zu, err:%d", *columns, *rows, status);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+    status = vxReadConvolutionCoefficients(conv, coeffs);
+    if (status != VX_SUCCESS)
+        VXLOGE("reading coefficients fails, err:%d", status);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxConvolutionKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = VX_SUCCESS;
+    vx_int16 coeffs[VXCPU_MAX_CONVOLUTION_DIM * VXCPU_MAX_CONVOLUTION_DIM];
+    vx_size columns = 0, rows = 0;
+    vx_uint32 scale = 1;
+    vx_border_mode_t border;
+    vxcpu_image_access_t src, dst;
+
+    status = vxReadConvolution((vx_convolution)parameters[1], coeffs, &columns, &rows, &scale);
+    if (status != VX_SUCCESS)
+        return status;
+    vxcpuQueryBorder(node, &border);
+
+    status |= vxcpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &src);
+    status |= vxcpuAccessImage((vx_image)parameters[2], VX_WRITE_ONLY, &dst);
+    if (status == VX_SUCCESS) {
+        status = vxcpu_convolve(&src.plane, coeffs, (vx_uint32)columns, (vx_uint32)rows, scale, &dst.plane, &border);
+        if (status != VX_SUCCESS)
+            VXLOGE("convolution fails, err:%d, num:%d", status, num);
+    }
+
+    status |= vxcpuCommitImage(&src);
+    status |= vxcpuCommitImage(&dst);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxConvolutionBand(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                            const vx_image_band_t bands[])
+{
+    vx_status status;
+    vx_int16 coeffs[VXCPU_MAX_CONVOLUTION_DIM * VXCPU_MAX_CONVOLUTION_DIM];
+    vx_size columns = 0, rows = 0;
+    vx_uint32 scale = 1;
+    vx_border_mode_t border;
+    vxcpu_image_t src, dst;
+
+    status = vxReadConvolution((vx_convolution)parameters[1], coeffs, &columns, &rows, &scale);
+    if (status != VX_SUCCESS)
+        return status;
+    vxcpuQueryBorder(node, &border);
+    vxcpuBandImage(&bands[0], &src);
+    vxcpuBandImage(&bands[2], &dst);
+
+    status = vxcpu_convolve(&src, coeffs, (vx_uint32)columns, (vx_uint32)rows, scale, &dst, &border);
+    if (status != VX_SUCCESS)
+        VXLOGE("convolution band fails, err:%d, num:%d", status, num);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxConvolutionInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format = 0;
+
+    if (index == 0) {
+        if (vxcpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) {
+            if (format == VX_DF_IMAGE_U8)
+                status = VX_SUCCESS;
+        }
+    } else if (index == 1) {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        vx_convolution conv = 0;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &conv, sizeof(conv));
+            if (conv) {
+                vx_size columns = 0, rows = 0;
+
+                vxQueryConvolution(conv, VX_CONVOLUTION_ATTRIBUTE_COLUMNS, &columns, sizeof(columns));
+                vxQueryConvolution(conv, VX_CONVOLUTION_ATTRIBUTE_ROWS, &rows, sizeof(rows));
+                if ((columns <= VXCPU_MAX_CONVOLUTION_DIM) && (rows <= VXCPU_MAX_CONVOLUTION_DIM) &&
+                    (columns & 1) && (rows & 1))
+                    status = VX_SUCCESS;
+                vxReleaseConvolution(&conv);
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxConvolutionOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width = 0, height = 0;
+    vx_df_image format = 0;
+
+    if (index == 2) {
+        status = vxcpuQueryImageParam(node, 0, &width, &height, NULL);
+        status |= vxcpuQueryImageParam(node, 2, NULL, NULL, &format);
+        if (status == VX_SUCCESS) {
+            /* both U8 and S16 are allowed, a virtual output gets S16 */
+            if (format != VX_DF_IMAGE_U8)
+                format = VX_DF_IMAGE_S16;
+            status = vxcpuSetMetaImage(meta, width, height, format);
+        }
+    }
+
+    return status;
+}
+
+vx_kernel_description_t convolution_cpu_kernel = {
+    VX_KERNEL_CUSTOM_CONVOLUTION,
+    "org.khronos.openvx.custom_convolution",
+    vxConvolutionKernel,
+    convolution_kernel_params, dimof(convolution_kernel_params),
+    vxConvolutionInputValidator,
+    vxConvolutionOutputValidator,
+    NULL,
+    NULL,
+};
+
+/* the radius is fixed per kernel, so it covers the largest matrix */
+vxcpu_band_description_t convolution_cpu_band = {
+    VX_KERNEL_CUSTOM_CONVOLUTION,
+    vxConvolutionBand,
+    VXCPU_MAX_CONVOLUTION_DIM / 2,
+};
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelFilter"
+#include <cutils/log.h>
+
+#include "vxcpu_kernel_module.h"
+
+typedef vx_status (*vxcpu_filter_f)(const vxcpu_image_t *in, vxcpu_image_t *out, const vx_border_mode_t *border);
+
+static vx_param_description_t filter_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+static vx_status vxFilterKernel(vx_node node, const vx_reference parameters[], vxcpu_filter_f filter)
+{
+    vx_status status = VX_SUCCESS;
+    vx_border_mode_t border;
+    vxcpu_image_access_t src, dst;
+
+    vxcpuQueryBorder(node, &border);
+
+    status |= vxcpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &src);
+    status |= vxcpuAccessImage((vx_image)parameters[1], VX_WRITE_ONLY, &dst);
+    if (status == VX_SUCCESS)
+        status = filter(&src.plane, &dst.plane, &border);
+
+    status |= vxcpuCommitImage(&src);
+    status |= vxcpuCommitImage(&dst);
+
+    return status;
+}
+
+static vx_status vxFilterBand(vx_node node, const vx_image_band_t bands[], vxcpu_filter_f filter)
+{
+    vx_border_mode_t border;
+    vxcpu_image_t src, dst;
+
+    vxcpuQueryBorder(node, &border);
+    vxcpuBandImage(&bands[0], &src);
+    vxcpuBandImage(&bands[1], &dst);
+
+    return filter(&src, &dst, &border);
+}
+
+static vx_status VX_CALLBACK vxBox3x3Kernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = vxFilterKernel(node, parameters, vxcpu_box3x3);
+    if (status != VX_SUCCESS)
+        VXLOGE("box3x3 fails, err:%d, num:%d", status, num);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxBox3x3Band(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                            const vx_image_band_t bands[])
+{
+    vx_status status = vxFilterBand(node, bands, vxcpu_box3x3);
+    if (status != VX_SUCCESS)
+        VXLOGE("box3x3 band fails, err:%d, num:%d", status, num);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxGaussian3x3Kernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = vxFilterKernel(node, parameters, vxcpu_gaussian3x3);
+    if (status != VX_SUCCESS)
+        VXLOGE("gaussian3x3 fails, err:%d, num:%d", status, num);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxGaussian3x3Band(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                            const vx_image_band_t bands[])
+{
+    vx_status status = vxFilterBand(node, bands, vxcpu_gaussian3x3);
+    if (status != VX_SUCCESS)
+        VXLOGE("gaussian3x3 band fails, err:%d, num:%d", status, num);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxMedian3x3Kernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = vxFilterKernel(node, parameters, vxcpu_median3x3);
+    if (status != VX_SUCCESS)
+        VXLOGE("median3x3 fails, err:%d, num:%d", status, num);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxMedian3x3Band(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                            const vx_image_band_t bands[])
+{
+    vx_status status = vxFilterBand(node, bands, vxcpu_median3x3);
+    if (status != VX_SUCCESS)
+        VXLOGE("median3x3 band fails, err:%d, num:%d", status, num);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxFilterInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format = 0;
+
+    if (index == 0) {
+        if (vxcpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) {
+            if (format == VX_DF_IMAGE_U8)
+                status = VX_SUCCESS;
+        }
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxFilterOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width = 0, height = 0;
+
+    if (index == 1) {
+        status = vxcpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            status = vxcpuSetMetaImage(meta, width, height, VX_DF_IMAGE_U8);
+    }
+
+    return status;
+}
+
+vx_kernel_description_t box3x3_cpu_kernel = {
+    VX_KERNEL_BOX_3x3,
+    "org.khronos.openvx.box_3x3",
+    vxBox3x3Kernel,
+    filter_kernel_params, dimof(filter_kernel_params),
+    vxFilterInputValidator,
+    vxFilterOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t gaussian3x3_cpu_kernel = {
+    VX_KERNEL_GAUSSIAN_3x3,
+    "org.khronos.openvx.gaussian_3x3",
+    vxGaussian3x3Kernel,
+    filter_kernel_params, dimof(filter_kernel_params),
+    vxFilterInputValidator,
+    vxFilterOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t median3x3_cpu_kernel = {
+    VX_KERNEL_MEDIAN_3x3,
+    "org.khronos.openvx.median_3x3",
+    vxMedian3x3Kernel,
+    filter_kernel_params, dimof(filter_kernel_params),
+    vxFilterInputValidator,
+    vxFilterOutputValidator,
+    NULL,
+    NULL,
+};
+
+vxcpu_band_description_t box3x3_cpu_band = {
+    VX_KERNEL_BOX_3x3,
+    vxBox3x3Band,
+    1,
+};
+
+vxcpu_band_description_t gaussian3x3_cpu_band = {
+    VX_KERNEL_GAUSSIAN_3x3,
+    vxGaussian3x3Band,
+    1,
+};
+
+vxcpu_band_description_t median3x3_cpu_band = {
+    VX_KERNEL_MEDIAN_3x3,
+    vxMedian3x3Band,
+    1,
+};
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelGradient"
+#include <cutils/log.h>
+
+#include <string.h>
+
+#include "vxcpu_kernel_module.h"
+
+static vx_param_description_t sobel3x3_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_OPTIONAL},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_OPTIONAL},
+};
+
+static vx_status VX_CALLBACK vxSobel3x3Kernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = VX_SUCCESS;
+    vx_border_mode_t border;
+    vxcpu_image_access_t src, grad_x, grad_y;
+
+    memset(&grad_x, 0x0, sizeof(grad_x));
+    memset(&grad_y, 0x0, sizeof(grad_y));
+    vxcpuQueryBorder(node, &border);
+
+    status |= vxcpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &src);
+    if (parameters[1])
+        status |= vxcpuAccessImage((vx_image)parameters[1], VX_WRITE_ONLY, &grad_x);
+    if (parameters[2])
+        status |= vxcpuAccessImage((vx_image)parameters[2], VX_WRITE_ONLY, &grad_y);
+    if (status == VX_SUCCESS) {
+        status = vxcpu_sobel3x3(&src.plane, parameters[1] ? &grad_x.plane : NULL,
+                                    parameters[2] ? &grad_y.plane : NULL, &border);
+        if (status != VX_SUCCESS)
+            VXLOGE("sobel3x3 fails, err:%d, num:%d", status, num);
+    }
+
+    status |= vxcpuCommitImage(&src);
+    status |= vxcpuCommitImage(&grad_x);
+    status |= vxcpuCommitImage(&grad_y);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxSobel3x3Band(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                            const vx_image_band_t bands[])
+{
+    vx_status status;
+    vx_border_mode_t border;
+    vxcpu_image_t src, grad_x, grad_y;
+
+    vxcpuQueryBorder(node, &border);
+    vxcpuBandImage(&bands[0], &src);
+    if (parameters[1])
+        vxcpuBandImage(&bands[1], &grad_x);
+    if (parameters[2])
+        vxcpuBandImage(&bands[2], &grad_y);
+
+    status = vxcpu_sobel3x3(&src, parameters[1] ? &grad_x : NULL, parameters[2] ? &grad_y : NULL, &border);
+    if (status != VX_SUCCESS)
+        VXLOGE("sobel3x3 band fails, err:%d, num:%d", status, num);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxSobel3x3InputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format = 0;
+
+    if (index == 0) {
+        if (vxcpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) {
+            if (format == VX_DF_IMAGE_U8)
+                status = VX_SUCCESS;
+        }
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxSobel3x3OutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width = 0, height = 0;
+
+    if ((index == 1) || (index == 2)) {
+        status = vxcpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            status = vxcpuSetMetaImage(meta, width, height, VX_DF_IMAGE_S16);
+    }
+
+    return status;
+}
+
+vx_kernel_description_t sobel3x3_cpu_kernel = {
+    VX_KERNEL_SOBEL_3x3,
+    "org.khronos.openvx.sobel_3x3",
+    vxSobel3x3Kernel,
+    sobel3x3_kernel_params, dimof(sobel3x3_kernel_params),
+    vxSobel3x3InputValidator,
+    vxSobel3x3OutputValidator,
+    NULL,
+    NULL,
+};
+
+vxcpu_band_description_t sobel3x3_cpu_band = {
+    VX_KERNEL_SOBEL_3x3,
+    vxSobel3x3Band,
+    1,
+};
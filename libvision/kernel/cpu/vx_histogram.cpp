@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelHistogram"
+#include <cutils/log.h>
+
+#include "vxcpu_kernel_module.h"
+
+static vx_param_description_t histogram_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_DISTRIBUTION, VX_PARAMETER_STATE_REQUIRED},
+};
+
+static vx_status VX_CALLBACK vxHistogramKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = VX_SUCCESS;
+    vx_distribution dist = (vx_distribution)parameters[1];
+    vx_size num_bins = 0;
+    vx_int32 offset = 0;
+    vx_uint32 range = 0;
+    void *bins = NULL;
+    vxcpu_image_access_t src;
+
+    status |= vxQueryDistribution(dist, VX_DISTRIBUTION_ATTRIBUTE_BINS, &num_bins, sizeof(num_bins));
+    status |= vxQueryDistribution(dist, VX_DISTRIBUTION_ATTRIBUTE_OFFSET, &offset, sizeof(offset));
+    status |= vxQueryDistribution(dist, VX_DISTRIBUTION_ATTRIBUTE_RANGE, &range, sizeof(range));
+    if (status != VX_SUCCESS) {
+        VXLOGE("querying distribution fails, err:%d", status);
+        return status;
+    }
+
+    status = vxAccessDistribution(dist, &bins, VX_WRITE_ONLY);
+    if (status != VX_SUCCESS) {
+        VXLOGE("accessing distribution fails, err:%d", status);
+        return status;
+    }
+
+    status = vxcpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &src);
+    if (status == VX_SUCCESS) {
+        status = vxcpu_histogram(&src.plane, (vx_uint32 *)bins, num_bins, offset, range);
+        if (status != VX_SUCCESS)
+            VXLOGE("histogram fails, err:%d, node:%p, num:%d", status, node, num);
+    }
+
+    status |= vxcpuCommitImage(&src);
+    status |= vxCommitDistribution(dist, bins);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxHistogramInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format = 0;
+
+    if (index == 0) {
+        if (vxcpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) {
+            if (format == VX_DF_IMAGE_U8)
+                status = VX_SUCCESS;
+        }
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxHistogramOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+
+    if (index == 1) {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        vx_distribution dist = 0;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &dist, sizeof(dist));
+            if (dist) {
+                vx_size num_bins = 0;
+                vx_uint32 range = 0;
+
+                vxQueryDistribution(dist, VX_DISTRIBUTION_ATTRIBUTE_BINS, &num_bins, sizeof(num_bins));
+                vxQueryDistribution(dist, VX_DISTRIBUTION_ATTRIBUTE_RANGE, &range, sizeof(range));
+                /* the distribution is not virtual, nothing to fill in the meta */
+                if ((num_bins != 0) && (range >= num_bins))
+                    status = VX_SUCCESS;
+                vxReleaseDistribution(&dist);
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validator fails, %p", meta);
+
+    return status;
+}
+
+vx_kernel_description_t histogram_cpu_kernel = {
+    VX_KERNEL_HISTOGRAM,
+    "org.khronos.openvx.histogram",
+    vxHistogramKernel,
+    histogram_kernel_params, dimof(histogram_kernel_params),
+    vxHistogramInputValidator,
+    vxHistogramOutputValidator,
+    NULL,
+    NULL,
+};
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelIntegralImage"
+#include <cutils/log.h>
+
+#include "vxcpu_kernel_module.h"
+
+static vx_param_description_t integralimage_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+static vx_status VX_CALLBACK vxIntegralImageKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = VX_SUCCESS;
+    vxcpu_image_access_t src, dst;
+
+    status |= vxcpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &src);
+    status |= vxcpuAccessImage((vx_image)parameters[1], VX_WRITE_ONLY, &dst);
+    if (status == VX_SUCCESS) {
+        status = vxcpu_integral_image(&src.plane, &dst.plane);
+        if (status != VX_SUCCESS)
+            VXLOGE("integral image fails, err:%d, node:%p, num:%d", status, node, num);
+    }
+
+    status |= vxcpuCommitImage(&src);
+    status |= vxcpuCommitImage(&dst);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxIntegralImageInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format = 0;
+
+    if (index == 0) {
+        if (vxcpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) {
+            if (format == VX_DF_IMAGE_U8)
+                status = VX_SUCCESS;
+        }
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxIntegralImageOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width = 0, height = 0;
+
+    if (index == 1) {
+        status = vxcpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            status = vxcpuSetMetaImage(meta, width, height, VX_DF_IMAGE_U32);
+    }
+
+    return status;
+}
+
+vx_kernel_description_t integralimage_cpu_kernel = {
+    VX_KERNEL_INTEGRAL_IMAGE,
+    "org.khronos.openvx.integral_image",
+    vxIntegralImageKernel,
+    integralimage_kernel_params, dimof(integralimage_kernel_params),
+    vxIntegralImageInputValidator,
+    vxIntegralImageOutputValidator,
+    NULL,
+    NULL,
+};
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelMagnitude"
+#include <cutils/log.h>
+
+#include "vxcpu_kernel_module.h"
+
+static vx_param_description_t magnitude_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+static vx_status VX_CALLBACK vxMagnitudeKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = VX_SUCCESS;
+    vxcpu_image_access_t grad_x, grad_y, dst;
+
+    status |= vxcpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &grad_x);
+    status |= vxcpuAccessImage((vx_image)parameters[1], VX_READ_ONLY, &grad_y);
+    status |= vxcpuAccessImage((vx_image)parameters[2], VX_WRITE_ONLY, &dst);
+    if (status == VX_SUCCESS) {
+        status = vxcpu_magnitude(&grad_x.plane, &grad_y.plane, &dst.plane);
+        if (status != VX_SUCCESS)
+            VXLOGE("magnitude fails, err:%d, node:%p, num:%d", status, node, num);
+    }
+
+    status |= vxcpuCommitImage(&grad_x);
+    status |= vxcpuCommitImage(&grad_y);
+    status |= vxcpuCommitImage(&dst);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxMagnitudeBand(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                            const vx_image_band_t bands[])
+{
+    vx_status status;
+    vxcpu_image_t grad_x, grad_y, dst;
+
+    vxcpuBandImage(&bands[0], &grad_x);
+    vxcpuBandImage(&bands[1], &grad_y);
+    vxcpuBandImage(&bands[2], &dst);
+
+    status = vxcpu_magnitude(&grad_x, &grad_y, &dst);
+    if (status != VX_SUCCESS)
+        VXLOGE("magnitude band fails, err:%d, node:%p, num:%d", status, node, num);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxMagnitudeInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format = 0;
+
+    if ((index == 0) || (index == 1)) {
+        if (vxcpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) {
+            if (format == VX_DF_IMAGE_S16)
+                status = VX_SUCCESS;
+        }
+        if ((status == VX_SUCCESS) && (index == 1))
+            status = vxcpuCheckSameImageParam(node, 0, 1, vx_true_e);
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxMagnitudeOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width = 0, height = 0;
+
+    if (index == 2) {
+        status = vxcpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            status = vxcpuSetMetaImage(meta, width, height, VX_DF_IMAGE_S16);
+    }
+
+    return status;
+}
+
+vx_kernel_description_t magnitude_cpu_kernel = {
+    VX_KERNEL_MAGNITUDE,
+    "org.khronos.openvx.magnitude",
+    vxMagnitudeKernel,
+    magnitude_kernel_params, dimof(magnitude_kernel_params),
+    vxMagnitudeInputValidator,
+    vxMagnitudeOutputValidator,
+    NULL,
+    NULL,
+};
+
+vxcpu_band_description_t magnitude_cpu_band = {
+    VX_KERNEL_MAGNITUDE,
+    vxMagnitudeBand,
+    0,
+};
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelOptPyrLk"
+#include <cutils/log.h>
+
+#include <string.h>
+#include <vector>
+
+#include "vxcpu_kernel_module.h"
+
+static vx_param_description_t optpyrlk_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_PYRAMID, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_PYRAMID, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+};
+
+/* copies the keypoints out, the array stride may be wider than an item */
+static vx_status vxReadKeypoints(vx_array array, std::vector<vx_keypoint_t> *points)
+{
+    vx_status status;
+    vx_size num_items = 0, stride = 0;
+    void *base = NULL;
+
+    points->clear();
+    status = vxQueryArray(array, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num_items, sizeof(num_items));
+    if ((status != VX_SUCCESS) || (num_items == 0))
+        return status;
+
+    status = vxAccessArrayRange(array, 0, num_items, &stride, &base, VX_READ_ONLY);
+    if (status != VX_SUCCESS)
+        return status;
+
+    points->resize(num_items);
+    for (vx_size i = 0; i < num_items; i++)
+        memcpy(&(*points)[i], (const vx_uint8 *)base + i * stride, sizeof(vx_keypoint_t));
+
+    return vxCommitArrayRange(array, 0, num_items, base);
+}
+
+static vx_status vxAccessPyramid(vx_pyramid pyramid, vx_size num_levels, std::vector<vxcpu_image_access_t> *access)
+{
+    vx_status status = VX_SUCCESS;
+
+    access->resize(num_levels);
+    for (vx_size l = 0; l < num_levels; l++) {
+        vx_image level = vxGetPyramidLevel(pyramid, (vx_uint32)l);
+
+        status |= vxcpuAccessImage(level, VX_READ_ONLY, &(*access)[l]);
+        /* the pyramid holds the level while it is accessed */
+        vxReleaseImage(&level);
+    }
+
+    return status;
+}
+
+static vx_status vxCommitPyramid(std::vector<vxcpu_image_access_t> *access)
+{
+    vx_status status = VX_SUCCESS;
+
+    for (vx_size l = 0; l < access->size(); l++)
+        status |= vxcpuCommitImage(&(*access)[l]);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxOptPyrLkKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = VX_SUCCESS;
+    vx_pyramid old_pyramid = (vx_pyramid)parameters[0];
+    vx_pyramid new_pyramid = (vx_pyramid)parameters[1];
+    vx_array new_points = (vx_array)parameters[4];
+    vx_size num_levels = 0;
+    vxcpu_optflow_params_t params;
+    std::vector<vx_keypoint_t> old_kp, estimate_kp, new_kp;
+    std::vector<vxcpu_image_access_t> old_levels, new_levels;
+    std::vector<vxcpu_image_t> old_planes, new_planes;
+
+    memset(&params, 0x0, sizeof(params));
+    status |= vxReadScalarValue((vx_scalar)parameters[5], &params.termination);
+    status |= vxReadScalarValue((vx_scalar)parameters[6], &params.epsilon);
+    status |= vxReadScalarValue((vx_scalar)parameters[7], &params.num_iterations);
+    status |= vxReadScalarValue((vx_scalar)parameters[8], &params.use_initial_estimate);
+    status |= vxReadScalarValue((vx_scalar)parameters[9], &params.window_dimension);
+    status |= vxQueryPyramid(old_pyramid, VX_PYRAMID_ATTRIBUTE_LEVELS, &num_levels, sizeof(num_levels));
+    status |= vxQueryPyramid(old_pyramid, VX_PYRAMID_ATTRIBUTE_SCALE, &params.pyramid_scale, sizeof(params.pyramid_scale));
+    if (status != VX_SUCCESS) {
+        VXLOGE("reading parameters fails, err:%d", status);
+        return status;
+    }
+
+    status |= vxReadKeypoints((vx_array)parameters[2], &old_kp);
+    status |= vxReadKeypoints((vx_array)parameters[3], &estimate_kp);
+    if ((status != VX_SUCCESS) || (params.use_initial_estimate && (estimate_kp.size() != old_kp.size()))) {
+        VXLOGE("reading points fails, err:%d, %zu/%zu points", status, old_kp.size(), estimate_kp.size());
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+    new_kp.resize(old_kp.size());
+
+    status |= vxAccessPyramid(old_pyramid, num_levels, &old_levels);
+    status |= vxAccessPyramid(new_pyramid, num_levels, &new_levels);
+    if ((status == VX_SUCCESS) && !old_kp.empty()) {
+        for (vx_size l = 0; l < num_levels; l++) {
+            old_planes.push_back(old_levels[l].plane);
+            new_planes.push_back(new_levels[l].plane);
+        }
+        status = vxcpu_optical_flow_pyr_lk(old_planes.data(), new_planes.data(), num_levels, old_kp.data(),
+                                            params.use_initial_estimate ? estimate_kp.data() : NULL,
+                                            new_kp.data(), old_kp.size(), &params);
+        if (status != VX_SUCCESS)
+            VXLOGE("optical flow fails, err:%d, node:%p, num:%d", status, node, num);
+    }
+
+    status |= vxCommitPyramid(&old_levels);
+    status |= vxCommitPyramid(&new_levels);
+
+    if (status == VX_SUCCESS) {
+        status = vxTruncateArray(new_points, 0);
+        if ((status == VX_SUCCESS) && !new_kp.empty())
+            status = vxAddArrayItems(new_points, new_kp.size(), new_kp.data(), sizeof(vx_keypoint_t));
+    }
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxOptPyrLkInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_enum type = 0;
+
+    if ((index == 0) || (index == 1)) {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        vx_pyramid pyramid = 0;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &pyramid, sizeof(pyramid));
+            if (pyramid) {
+                vx_size num_levels = 0;
+                vx_df_image format = 0;
+
+                vxQueryPyramid(pyramid, VX_PYRAMID_ATTRIBUTE_LEVELS, &num_levels, sizeof(num_levels));
+                vxQueryPyramid(pyramid, VX_PYRAMID_ATTRIBUTE_FORMAT, &format, sizeof(format));
+                if ((num_levels != 0) && (format == VX_DF_IMAGE_U8))
+                    status = VX_SUCCESS;
+                vxReleasePyramid(&pyramid);
+            }
+            vxReleaseParameter(&param);
+        }
+    } else if ((index == 2) || (index == 3)) {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        vx_array array = 0;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &array, sizeof(array));
+            if (array) {
+                vx_enum item_type = 0;
+
+                vxQueryArray(array, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &item_type, sizeof(item_type));
+                if (item_type == VX_TYPE_KEYPOINT)
+                    status = VX_SUCCESS;
+                vxReleaseArray(&array);
+            }
+            vxReleaseParameter(&param);
+        }
+    } else if (index == 5) {
+        if (vxcpuQueryScalarParam(node, index, &type) == VX_SUCCESS)
+            status = (type == VX_TYPE_ENUM) ? VX_SUCCESS : VX_ERROR_INVALID_TYPE;
+    } else if (index == 6) {
+        if (vxcpuQueryScalarParam(node, index, &type) == VX_SUCCESS)
+            status = (type == VX_TYPE_FLOAT32) ? VX_SUCCESS : VX_ERROR_INVALID_TYPE;
+    } else if (index == 7) {
+        if (vxcpuQueryScalarParam(node, index, &type) == VX_SUCCESS)
+            status = (type == VX_TYPE_UINT32) ? VX_SUCCESS : VX_ERROR_INVALID_TYPE;
+    } else if (index == 8) {
+        if (vxcpuQueryScalarParam(node, index, &type) == VX_SUCCESS)
+            status = (type == VX_TYPE_BOOL) ? VX_SUCCESS : VX_ERROR_INVALID_TYPE;
+    } else if (index == 9) {
+        if (vxcpuQueryScalarParam(node, index, &type) == VX_SUCCESS)
+            status = (type == VX_TYPE_SIZE) ? VX_SUCCESS : VX_ERROR_INVALID_TYPE;
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxOptPyrLkOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+
+    if (index == 4) {
+        vx_parameter param = vxGetParameterByIndex(node, 2);
+        vx_array array = 0;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &array, sizeof(array));
+            if (array) {
+                vx_enum item_type = VX_TYPE_KEYPOINT;
+                vx_size capacity = 0;
+
+                vxQueryArray(array, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity));
+                vxSetMetaFormatAttribute(meta, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &item_type, sizeof(item_type));
+                vxSetMetaFormatAttribute(meta, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity));
+                status = VX_SUCCESS;
+                vxReleaseArray(&array);
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+
+    return status;
+}
+
+vx_kernel_description_t optpyrlk_cpu_kernel = {
+    VX_KERNEL_OPTICAL_FLOW_PYR_LK,
+    "org.khronos.openvx.optical_flow_pyr_lk",
+    vxOptPyrLkKernel,
+    optpyrlk_kernel_params, dimof(optpyrlk_kernel_params),
+    vxOptPyrLkInputValidator,
+    vxOptPyrLkOutputValidator,
+    NULL,
+    NULL,
+};
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelPyramid"
+#include <cutils/log.h>
+
+#include <string.h>
+
+#include "vxcpu_kernel_module.h"
+
+static vx_param_description_t pyramid_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_PYRAMID, VX_PARAMETER_STATE_REQUIRED},
+};
+
+/* level 0 of the pyramid is a copy of the input */
+static vx_status vxPyramidBaseLevel(vx_image input, vx_image level)
+{
+    vx_status status = VX_SUCCESS;
+    vxcpu_image_access_t src, dst;
+
+    status |= vxcpuAccessImage(input, VX_READ_ONLY, &src);
+    status |= vxcpuAccessImage(level, VX_WRITE_ONLY, &dst);
+    if (status == VX_SUCCESS) {
+        if ((src.plane.width == dst.plane.width) && (src.plane.height == dst.plane.height)) {
+            for (vx_uint32 y = 0; y < dst.plane.height; y++) {
+                memcpy((vx_uint8 *)dst.plane.ptr + y * dst.plane.stride,
+                        (const vx_uint8 *)src.plane.ptr + y * src.plane.stride, dst.plane.width);
+            }
+        } else {
+            status = VX_ERROR_INVALID_PARAMETERS;
+        }
+    }
+
+    status |= vxcpuCommitImage(&src);
+    status |= vxcpuCommitImage(&dst);
+
+    return status;
+}
+
+static vx_status vxPyramidNextLevel(vx_image upper, vx_image level, const vx_border_mode_t *border)
+{
+    vx_status status = VX_SUCCESS;
+    vxcpu_image_access_t src, dst;
+
+    status |= vxcpuAccessImage(upper, VX_READ_ONLY, &src);
+    status |= vxcpuAccessImage(level, VX_WRITE_ONLY, &dst);
+    if (status == VX_SUCCESS)
+        status = vxcpu_pyramid_level(&src.plane, &dst.plane, border);
+
+    status |= vxcpuCommitImage(&src);
+    status |= vxcpuCommitImage(&dst);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxPyramidKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = VX_SUCCESS;
+    vx_image input = (vx_image)parameters[0];
+    vx_pyramid pyramid = (vx_pyramid)parameters[1];
+    vx_size num_levels = 0;
+    vx_border_mode_t border;
+    vx_image upper = NULL, level = NULL;
+
+    status = vxQueryPyramid(pyramid, VX_PYRAMID_ATTRIBUTE_LEVELS, &num_levels, sizeof(num_levels));
+    if ((status != VX_SUCCESS) || (num_levels == 0)) {
+        VXLOGE("querying pyramid fails, err:%d, levels:%zu", status, num_levels);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+    vxcpuQueryBorder(node, &border);
+
+    upper = vxGetPyramidLevel(pyramid, 0);
+    status = vxPyramidBaseLevel(input, upper);
+    if (status != VX_SUCCESS) {
+        VXLOGE("copying level 0 fails, err:%d", status);
+        goto EXIT;
+    }
+
+    /* every level comes from the one above */
+    for (vx_uint32 l = 1; l < num_levels; l++) {
+        level = vxGetPyramidLevel(pyramid, l);
+        status = vxPyramidNextLevel(upper, level, &border);
+        vxReleaseImage(&upper);
+        upper = level;
+        if (status != VX_SUCCESS) {
+            VXLOGE("making level %u fails, err:%d, num:%d", l, status, num);
+            break;
+        }
+    }
+
+EXIT:
+    vxReleaseImage(&upper);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxPyramidInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format = 0;
+
+    if (index == 0) {
+        if (vxcpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) {
+            if (format == VX_DF_IMAGE_U8)
+                status = VX_SUCCESS;
+        }
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxPyramidOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+
+    if (index == 1) {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        vx_pyramid pyramid = 0;
+        vx_uint32 width = 0, height = 0;
+        vx_df_image format = 0;
+
+        if (param && (vxcpuQueryImageParam(node, 0, &width, &height, &format) == VX_SUCCESS)) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &pyramid, sizeof(pyramid));
+            if (pyramid) {
+                vx_size num_levels = 0;
+                vx_float32 scale = 0.0f;
+
+                vxQueryPyramid(pyramid, VX_PYRAMID_ATTRIBUTE_LEVELS, &num_levels, sizeof(num_levels));
+                vxQueryPyramid(pyramid, VX_PYRAMID_ATTRIBUTE_SCALE, &scale, sizeof(scale));
+
+                /* fill in the meta data with the attributes so that the checker will pass */
+                vxSetMetaFormatAttribute(meta, VX_PYRAMID_ATTRIBUTE_WIDTH, &width, sizeof(width));
+                vxSetMetaFormatAttribute(meta, VX_PYRAMID_ATTRIBUTE_HEIGHT, &height, sizeof(height));
+                vxSetMetaFormatAttribute(meta, VX_PYRAMID_ATTRIBUTE_FORMAT, &format, sizeof(format));
+                vxSetMetaFormatAttribute(meta, VX_PYRAMID_ATTRIBUTE_LEVELS, &num_levels, sizeof(num_levels));
+                vxSetMetaFormatAttribute(meta, VX_PYRAMID_ATTRIBUTE_SCALE, &scale, sizeof(scale));
+
+                if ((scale == VX_SCALE_PYRAMID_HALF) || (scale == VX_SCALE_PYRAMID_ORB))
+                    status = VX_SUCCESS;
+                else
+                    status = VX_ERROR_INVALID_REFERENCE;
+                vxReleasePyramid(&pyramid);
+            }
+        }
+        if (param)
+            vxReleaseParameter(&param);
+    }
+
+    return status;
+}
+
+vx_kernel_description_t pyramid_cpu_kernel = {
+    VX_KERNEL_GAUSSIAN_PYRAMID,
+    "org.khronos.openvx.gaussian_pyramid",
+    vxPyramidKernel,
+    pyramid_kernel_params, dimof(pyramid_kernel_params),
+    vxPyramidInputValidator,
+    vxPyramidOutputValidator,
+    NULL,
+    NULL,
+};
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelScale"
+#include <cutils/log.h>
+
+#include "vxcpu_kernel_module.h"
+
+static vx_param_description_t scaleimage_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL},
+};
+
+static vx_status VX_CALLBACK vxScaleImageKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = VX_SUCCESS;
+    vx_enum interp = VX_INTERPOLATION_TYPE_BILINEAR;
+    vx_border_mode_t border;
+    vxcpu_image_access_t src, dst;
+
+    if ((num > 2) && parameters[2]) {
+        status = vxReadScalarValue((vx_scalar)parameters[2], &interp);
+        if (status != VX_SUCCESS) {
+            VXLOGE("reading interpolation fails, err:%d", status);
+            return status;
+        }
+    }
+    vxcpuQueryBorder(node, &border);
+
+    status |= vxcpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &src);
+    status |= vxcpuAccessImage((vx_image)parameters[1], VX_WRITE_ONLY, &dst);
+    if (status == VX_SUCCESS) {
+        status = vxcpu_scale_image(&src.plane, &dst.plane, interp, &border);
+        if (status != VX_SUCCESS)
+            VXLOGE("scale image fails, err:%d, interp:0x%x", status, interp);
+    }
+
+    status |= vxcpuCommitImage(&src);
+    status |= vxcpuCommitImage(&dst);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxScaleImageInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format = 0;
+
+    if (index == 0) {
+        if (vxcpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) {
+            if (format == VX_DF_IMAGE_U8)
+                status = VX_SUCCESS;
+        }
+    } else if (index == 2) {
+        status = vxcpuCheckInterpolationParam(node, index, vx_true_e);
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxScaleImageOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width = 0, height = 0;
+    vx_df_image format = VX_DF_IMAGE_VIRT;
+
+    if (index == 1) {
+        /* output can not be virtual, its size gives the scale */
+        status = vxcpuQueryImageParam(node, index, &width, &height, &format);
+        if ((status == VX_SUCCESS) && (width != 0) && (height != 0) && (format == VX_DF_IMAGE_U8))
+            status = vxcpuSetMetaImage(meta, width, height, format);
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    return status;
+}
+
+vx_kernel_description_t scaleimage_cpu_kernel = {
+    VX_KERNEL_SCALE_IMAGE,
+    "org.khronos.openvx.scale_image",
+    vxScaleImageKernel,
+    scaleimage_kernel_params, dimof(scaleimage_kernel_params),
+    vxScaleImageInputValidator,
+    vxScaleImageOutputValidator,
+    NULL,
+    NULL,
+};
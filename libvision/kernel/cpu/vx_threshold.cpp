@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelThreshold"
+#include <cutils/log.h>
+
+#include "vxcpu_kernel_module.h"
+
+static vx_param_description_t threshold_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_THRESHOLD, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+static vx_status vxQueryThresholdBounds(vx_threshold threshold, vx_enum *type, vx_int32 *value,
+                                                vx_int32 *lower, vx_int32 *upper)
+{
+    vx_status status;
+
+    *value = *lower = *upper = 0;
+
+    status = vxQueryThreshold(threshold, VX_THRESHOLD_ATTRIBUTE_TYPE, type, sizeof(*type));
+    if (*type == VX_THRESHOLD_TYPE_BINARY) {
+        status |= vxQueryThreshold(threshold, VX_THRESHOLD_ATTRIBUTE_THRESHOLD_VALUE, value, sizeof(*value));
+    } else {
+        status |= vxQueryThreshold(threshold, VX_THRESHOLD_ATTRIBUTE_THRESHOLD_LOWER, lower, sizeof(*lower));
+        status |= vxQueryThreshold(threshold, VX_THRESHOLD_ATTRIBUTE_THRESHOLD_UPPER, upper, sizeof(*upper));
+    }
+    if (status != VX_SUCCESS)
+        VXLOGE("querying threshold fails, err:%d", status);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxThresholdKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = VX_SUCCESS;
+    vx_enum type = 0;
+    vx_int32 value, lower, upper;
+    vxcpu_image_access_t src, dst;
+
+    status = vxQueryThresholdBounds((vx_threshold)parameters[1], &type, &value, &lower, &upper);
+    if (status != VX_SUCCESS)
+        return status;
+
+    status |= vxcpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &src);
+    status |= vxcpuAccessImage((vx_image)parameters[2], VX_WRITE_ONLY, &dst);
+    if (status == VX_SUCCESS) {
+        status = vxcpu_threshold(&src.plane, type, value, lower, upper, &dst.plane);
+        if (status != VX_SUCCESS)
+            VXLOGE("threshold fails, err:%d, node:%p, num:%d", status, node, num);
+    }
+
+    status |= vxcpuCommitImage(&src);
+    status |= vxcpuCommitImage(&dst);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxThresholdBand(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                            const vx_image_band_t bands[])
+{
+    vx_status status;
+    vx_enum type = 0;
+    vx_int32 value, lower, upper;
+    vxcpu_image_t src, dst;
+
+    status = vxQueryThresholdBounds((vx_threshold)parameters[1], &type, &value, &lower, &upper);
+    if (status != VX_SUCCESS)
+        return status;
+
+    vxcpuBandImage(&bands[0], &src);
+    vxcpuBandImage(&bands[2], &dst);
+
+    status = vxcpu_threshold(&src, type, value, lower, upper, &dst);
+    if (status != VX_SUCCESS)
+        VXLOGE("threshold band fails, err:%d, node:%p, num:%d", status, node, num);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxThresholdInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format = 0;
+
+    if (index == 0) {
+        if (vxcpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) {
+            if (format == VX_DF_IMAGE_U8)
+                status = VX_SUCCESS;
+        }
+    } else if (index == 1) {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        vx_threshold threshold = 0;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &threshold, sizeof(threshold));
+            if (threshold) {
+                vx_enum type = 0;
+
+                vxQueryThreshold(threshold, VX_THRESHOLD_ATTRIBUTE_TYPE, &type, sizeof(type));
+                if ((type == VX_THRESHOLD_TYPE_BINARY) || (type == VX_THRESHOLD_TYPE_RANGE))
+                    status = VX_SUCCESS;
+                else
+                    status = VX_ERROR_INVALID_TYPE;
+                vxReleaseThreshold(&threshold);
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxThresholdOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width = 0, height = 0;
+
+    if (index == 2) {
+        status = vxcpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            status = vxcpuSetMetaImage(meta, width, height, VX_DF_IMAGE_U8);
+    }
+
+    return status;
+}
+
+vx_kernel_description_t threshold_cpu_kernel = {
+    VX_KERNEL_THRESHOLD,
+    "org.khronos.openvx.threshold",
+    vxThresholdKernel,
+    threshold_kernel_params, dimof(threshold_kernel_params),
+    vxThresholdInputValidator,
+    vxThresholdOutputValidator,
+    NULL,
+    NULL,
+};
+
+vxcpu_band_description_t threshold_cpu_band = {
+    VX_KERNEL_THRESHOLD,
+    vxThresholdBand,
+    0,
+};
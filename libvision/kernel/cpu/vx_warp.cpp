@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelWarp"
+#include <cutils/log.h>
+
+#include "vxcpu_kernel_module.h"
+
+static vx_param_description_t warp_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_MATRIX, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+static vx_status vxWarpKernel(vx_node node, const vx_reference parameters[], vx_bool perspective)
+{
+    vx_status status = VX_SUCCESS;
+    vx_float32 matrix[9];
+    vx_enum interp = VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR;
+    vx_border_mode_t border;
+    vxcpu_image_access_t src, dst;
+
+    status |= vxReadMatrix((vx_matrix)parameters[1], matrix);
+    status |= vxReadScalarValue((vx_scalar)parameters[2], &interp);
+    if (status != VX_SUCCESS) {
+        VXLOGE("reading warp parameters fails, err:%d", status);
+        return status;
+    }
+    vxcpuQueryBorder(node, &border);
+
+    status |= vxcpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &src);
+    status |= vxcpuAccessImage((vx_image)parameters[3], VX_WRITE_ONLY, &dst);
+    if (status == VX_SUCCESS) {
+        if (perspective)
+            status = vxcpu_warp_perspective(&src.plane, matrix, interp, &dst.plane, &border);
+        else
+            status = vxcpu_warp_affine(&src.plane, matrix, interp, &dst.plane, &border);
+        if (status != VX_SUCCESS)
+            VXLOGE("warp %s fails, err:%d", perspective ? "perspective" : "affine", status);
+    }
+
+    status |= vxcpuCommitImage(&src);
+    status |= vxcpuCommitImage(&dst);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxWarpAffineKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = vxWarpKernel(node, parameters, vx_false_e);
+    if (status != VX_SUCCESS)
+        VXLOGE("warp affine kernel fails, num:%d", num);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxWarpPerspectiveKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = vxWarpKernel(node, parameters, vx_true_e);
+    if (status != VX_SUCCESS)
+        VXLOGE("warp perspective kernel fails, num:%d", num);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxWarpInputValidator(vx_node node, vx_uint32 index, vx_size mat_columns)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format = 0;
+
+    if (index == 0) {
+        if (vxcpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) {
+            if (format == VX_DF_IMAGE_U8)
+                status = VX_SUCCESS;
+        }
+    } else if (index == 1) {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        vx_matrix matrix = 0;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &matrix, sizeof(matrix));
+            if (matrix) {
+                vx_enum data_type = 0;
+                vx_size rows = 0ul, columns = 0ul;
+
+                vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_TYPE, &data_type, sizeof(data_type));
+                vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_ROWS, &rows, sizeof(rows));
+                vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_COLUMNS, &columns, sizeof(columns));
+                if ((data_type == VX_TYPE_FLOAT32) && (columns == mat_columns) && (rows == 3))
+                    status = VX_SUCCESS;
+                vxReleaseMatrix(&matrix);
+            }
+            vxReleaseParameter(&param);
+        }
+    } else if (index == 2) {
+        status = vxcpuCheckInterpolationParam(node, index, vx_false_e);
+    }
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxWarpAffineInputValidator(vx_node node, vx_uint32 index)
+{
+    return vxWarpInputValidator(node, index, 2);
+}
+
+static vx_status VX_CALLBACK vxWarpPerspectiveInputValidator(vx_node node, vx_uint32 index)
+{
+    return vxWarpInputValidator(node, index, 3);
+}
+
+static vx_status VX_CALLBACK vxWarpOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width = 0, height = 0;
+    vx_df_image format = VX_DF_IMAGE_VIRT;
+
+    if (index == 3) {
+        /* output can not be virtual */
+        status = vxcpuQueryImageParam(node, index, &width, &height, &format);
+        if ((status == VX_SUCCESS) && (width != 0) && (height != 0) && (format == VX_DF_IMAGE_U8))
+            status = vxcpuSetMetaImage(meta, width, height, format);
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    return status;
+}
+
+vx_kernel_description_t warp_affine_cpu_kernel = {
+    VX_KERNEL_WARP_AFFINE,
+    "org.khronos.openvx.warp_affine",
+    vxWarpAffineKernel,
+    warp_kernel_params, dimof(warp_kernel_params),
+    vxWarpAffineInputValidator,
+    vxWarpOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t warp_perspective_cpu_kernel = {
+    VX_KERNEL_WARP_PERSPECTIVE,
+    "org.khronos.openvx.warp_perspective",
+    vxWarpPerspectiveKernel,
+    warp_kernel_params, dimof(warp_kernel_params),
+    vxWarpPerspectiveInputValidator,
+    vxWarpOutputValidator,
+    NULL,
+    NULL,
+};
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VXCPU_CORE_H
+#define VXCPU_CORE_H
+
+#include <VX/vx.h>
+
+/*
+ * Compute part of the cpu target kernels.
+ *
+ * Works on plain memory, so it has no dependency on the framework objects:
+ * the vx_*.cpp kernel functions map the images and call these.  Every
+ * function tiles its work over the vxcpu_parallel pool.
+ *
+ * Border modes follow the node attribute.  VX_BORDER_MODE_UNDEFINED is
+ * handled like VX_BORDER_MODE_REPLICATE, which is one of its valid results.
+ */
+
+#define VXCPU_MAX_CONVOLUTION_DIM   (15)
+
+/*
+ * A band holds rows start_y..end_y - 1 of the image only, ptr is then pixel
+ * (0, start_y).  end_y 0 is the whole image.  Functions marked "band" below
+ * compute the rows their output holds; inputs hold those rows plus the
+ * rows of the window around them, as far as the image goes.
+ */
+struct vxcpu_image_t {
+    void *ptr;          /* pixel (0, start_y) */
+    vx_int32 stride;    /* bytes between rows */
+    vx_uint32 width;
+    vx_uint32 height;
+    vx_df_image format;
+    vx_uint32 start_y;
+    vx_uint32 end_y;
+};
+
+enum vxcpu_bitwise_op_e {
+    VXCPU_BITWISE_AND,
+    VXCPU_BITWISE_OR,
+    VXCPU_BITWISE_XOR,
+    VXCPU_BITWISE_NOT,
+};
+
+/* pixelwise, band, vxcpu_core_pixelwise.cpp */
+vx_status vxcpu_absdiff(const vxcpu_image_t *in1, const vxcpu_image_t *in2, vxcpu_image_t *out);
+vx_status vxcpu_arithmetic(const vxcpu_image_t *in1, const vxcpu_image_t *in2, vx_enum policy,
+                                vx_bool subtract, vxcpu_image_t *out);
+/* in2 is not used by VXCPU_BITWISE_NOT */
+vx_status vxcpu_bitwise(const vxcpu_image_t *in1, const vxcpu_image_t *in2, vx_enum op, vxcpu_image_t *out);
+vx_status vxcpu_threshold(const vxcpu_image_t *in, vx_enum type, vx_int32 value,
+                                vx_int32 lower, vx_int32 upper, vxcpu_image_t *out);
+vx_status vxcpu_magnitude(const vxcpu_image_t *grad_x, const vxcpu_image_t *grad_y, vxcpu_image_t *mag);
+vx_status vxcpu_phase(const vxcpu_image_t *grad_x, const vxcpu_image_t *grad_y, vxcpu_image_t *orientation);
+
+/* neighborhood, band, vxcpu_core_filter.cpp */
+vx_status vxcpu_box3x3(const vxcpu_image_t *in, vxcpu_image_t *out, const vx_border_mode_t *border);
+vx_status vxcpu_gaussian3x3(const vxcpu_image_t *in, vxcpu_image_t *out, const vx_border_mode_t *border);
+vx_status vxcpu_gaussian5x5(const vxcpu_image_t *in, vxcpu_image_t *out, const vx_border_mode_t *border);
+vx_status vxcpu_median3x3(const vxcpu_image_t *in, vxcpu_image_t *out, const vx_border_mode_t *border);
+/* either output may be NULL */
+vx_status vxcpu_sobel3x3(const vxcpu_image_t *in, vxcpu_image_t *grad_x, vxcpu_image_t *grad_y,
+                                const vx_border_mode_t *border);
+vx_status vxcpu_scharr3x3(const vxcpu_image_t *in, vxcpu_image_t *grad_x, vxcpu_image_t *grad_y,
+                                const vx_border_mode_t *border);
+/* coefficients row-major, cols x rows odd and <= VXCPU_MAX_CONVOLUTION_DIM */
+vx_status vxcpu_convolve(const vxcpu_image_t *in, const vx_int16 *coeffs, vx_uint32 cols, vx_uint32 rows,
+                                vx_uint32 scale, vxcpu_image_t *out, const vx_border_mode_t *border);
+
+/* statistics, vxcpu_core_statistics.cpp */
+vx_status vxcpu_histogram(const vxcpu_image_t *in, vx_uint32 *bins, vx_size num_bins,
+                                vx_int32 offset, vx_uint32 range);
+vx_status vxcpu_integral_image(const vxcpu_image_t *in, vxcpu_image_t *out);
+
+/* geometry, vxcpu_core_geometry.cpp */
+vx_status vxcpu_scale_image(const vxcpu_image_t *in, vxcpu_image_t *out, vx_enum interpolation,
+                                const vx_border_mode_t *border);
+/* matrix as laid out by vxWarpAffineNode(), 2x3 column major */
+vx_status vxcpu_warp_affine(const vxcpu_image_t *in, const vx_float32 matrix[6], vx_enum interpolation,
+                                vxcpu_image_t *out, const vx_border_mode_t *border);
+/* matrix as laid out by vxWarpPerspectiveNode(), 3x3 column major */
+vx_status vxcpu_warp_perspective(const vxcpu_image_t *in, const vx_float32 matrix[9], vx_enum interpolation,
+                                vxcpu_image_t *out, const vx_border_mode_t *border);
+/* level i + 1 of a gaussian pyramid from level i */
+vx_status vxcpu_pyramid_level(const vxcpu_image_t *in, vxcpu_image_t *out, const vx_border_mode_t *border);
+
+/* tracking, vxcpu_core_optflow.cpp */
+struct vxcpu_optflow_params_t {
+    vx_enum termination;
+    vx_float32 epsilon;
+    vx_uint32 num_iterations;
+    vx_bool use_initial_estimate;
+    vx_size window_dimension;
+    vx_float32 pyramid_scale;
+};
+
+/* levels[0] is the full resolution, U8 */
+vx_status vxcpu_optical_flow_pyr_lk(const vxcpu_image_t *old_levels, const vxcpu_image_t *new_levels,
+                                vx_size num_levels, const vx_keypoint_t *old_points,
+                                const vx_keypoint_t *new_points_estimates, vx_keypoint_t *new_points,
+                                vx_size num_points, const vxcpu_optflow_params_t *params);
+
+#endif
@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vxcpu_core_priv.h"
+
+#define VXCPU_MAX_FILTER_RADIUS     (VXCPU_MAX_CONVOLUTION_DIM / 2)
+
+/*
+ * Separable filter on U8 rows y0..y1: vert(rows, x) gives 8 sums of the
+ * window column at x as s16, horz(mid, x, &v) combines them along the row
+ * into the 8 output values at x, store(y, x, v) writes them.
+ */
+template <typename Vert, typename Horz, typename Store>
+static void vxcpu_separable(const vxcpu_image_t *in, vx_int32 radius, const vx_border_mode_t *border,
+                                vx_uint32 y0, vx_uint32 y1, Vert vert, Horz horz, Store store)
+{
+    vxcpu_row_cache cache(in, radius, radius, border);
+    std::vector<vx_int16> buf(in->width + 2 * radius + 2 * VXCPU_LANES);
+    vx_int16 *mid = &buf[radius];
+    const vx_uint8 *rows[2 * VXCPU_MAX_FILTER_RADIUS + 1];
+    vx_int32 width = in->width;
+    v_int32x8 v;
+
+    for (vx_uint32 y = y0; y < y1; y++) {
+        for (vx_int32 i = 0; i <= 2 * radius; i++)
+            rows[i] = cache.row((vx_int32)y - radius + i);
+
+        for (vx_int32 x = -radius; x < width + radius; x += VXCPU_LANES)
+            v_store(mid + x, vert(rows, x));
+        for (vx_int32 x = 0; x < width; x += VXCPU_LANES) {
+            horz(mid, x, &v);
+            store(y, x, v);
+        }
+    }
+}
+
+/* m[i] = mid at x + i - radius, i = 0..2 * radius */
+static inline void vxcpu_mid(v_int32x8 *m, vx_int32 radius, const vx_int16 *mid, vx_int32 x)
+{
+    for (vx_int32 i = 0; i <= 2 * radius; i++)
+        v_load_expand_s32(&m[i], mid + x + i - radius);
+}
+
+static inline v_int16x8 vxcpu_col(const vx_uint8 *row, vx_int32 x)
+{
+    return v_load_expand_s16(row + x);
+}
+
+static vx_status vxcpu_check_u8(const vxcpu_image_t *in, const vxcpu_image_t *out, vx_df_image out_format)
+{
+    if (!vxcpu_same_size(in, out))
+        return VX_ERROR_INVALID_PARAMETERS;
+    if (in->format != VX_DF_IMAGE_U8 || out->format != out_format)
+        return VX_ERROR_INVALID_FORMAT;
+
+    return VX_SUCCESS;
+}
+
+vx_status vxcpu_box3x3(const vxcpu_image_t *in, vxcpu_image_t *out, const vx_border_mode_t *border)
+{
+    vx_status status = vxcpu_check_u8(in, out, VX_DF_IMAGE_U8);
+
+    if (status != VX_SUCCESS)
+        return status;
+
+    vxcpu_parallel_band(out, [=](vx_uint32 y0, vx_uint32 y1) {
+        vxcpu_separable(in, 1, border, y0, y1,
+            [](const vx_uint8 **r, vx_int32 x) {
+                return vxcpu_col(r[0], x) + vxcpu_col(r[1], x) + vxcpu_col(r[2], x);
+            },
+            [](const vx_int16 *mid, vx_int32 x, v_int32x8 *v) {
+                v_int32x8 m[3];
+
+                vxcpu_mid(m, 1, mid, x);
+                /* sum / 9, exact for sums up to 9 * 255 */
+                *v = ((m[0] + m[1] + m[2]) * 7282) >> 16;
+            },
+            [=](vx_uint32 y, vx_int32 x, const v_int32x8 &v) {
+                vxcpu_store_u8(vxcpu_row<vx_uint8>(out, y), x, out->width, v);
+            });
+    });
+
+    return VX_SUCCESS;
+}
+
+vx_status vxcpu_gaussian3x3(const vxcpu_image_t *in, vxcpu_image_t *out, const vx_border_mode_t *border)
+{
+    vx_status status = vxcpu_check_u8(in, out, VX_DF_IMAGE_U8);
+
+    if (status != VX_SUCCESS)
+        return status;
+
+    vxcpu_parallel_band(out, [=](vx_uint32 y0, vx_uint32 y1) {
+        vxcpu_separable(in, 1, border, y0, y1,
+            [](const vx_uint8 **r, vx_int32 x) {
+                return vxcpu_col(r[0], x) + (vxcpu_col(r[1], x) << 1) + vxcpu_col(r[2], x);
+            },
+            [](const vx_int16 *mid, vx_int32 x, v_int32x8 *v) {
+                v_int32x8 m[3];
+
+                vxcpu_mid(m, 1, mid, x);
+                *v = (m[0] + (m[1] << 1) + m[2]) >> 4;
+            },
+            [=](vx_uint32 y, vx_int32 x, const v_int32x8 &v) {
+                vxcpu_store_u8(vxcpu_row<vx_uint8>(out, y), x, out->width, v);
+            });
+    });
+
+    return VX_SUCCESS;
+}
+
+vx_status vxcpu_gaussian5x5(const vxcpu_image_t *in, vxcpu_image_t *out, const vx_border_mode_t *border)
+{
+    vx_status status = vxcpu_check_u8(in, out, VX_DF_IMAGE_U8);
+
+    if (status != VX_SUCCESS)
+        return status;
+
+    vxcpu_parallel_band(out, [=](vx_uint32 y0, vx_uint32 y1) {
+        vxcpu_separable(in, 2, border, y0, y1,
+            [](const vx_uint8 **r, vx_int32 x) {
+                return vxcpu_col(r[0], x) + vxcpu_col(r[4], x) +
+                       ((vxcpu_col(r[1], x) + vxcpu_col(r[3], x)) << 2) + vxcpu_col(r[2], x) * 6;
+            },
+            [](const vx_int16 *mid, vx_int32 x, v_int32x8 *v) {
+                v_int32x8 m[5];
+
+                vxcpu_mid(m, 2, mid, x);
+                *v = (m[0] + m[4] + ((m[1] + m[3]) << 2) + m[2] * 6) >> 8;
+            },
+            [=](vx_uint32 y, vx_int32 x, const v_int32x8 &v) {
+                vxcpu_store_u8(vxcpu_row<vx_uint8>(out, y), x, out->width, v);
+            });
+    });
+
+    return VX_SUCCESS;
+}
+
+/* a, b = min, max */
+static inline void vxcpu_sort2(v_uint8x16 &a, v_uint8x16 &b)
+{
+    v_uint8x16 t = a;
+
+    a = v_min(a, b);
+    b = v_max(t, b);
+}
+
+vx_status vxcpu_median3x3(const vxcpu_image_t *in, vxcpu_image_t *out, const vx_border_mode_t *border)
+{
+    vx_status status = vxcpu_check_u8(in, out, VX_DF_IMAGE_U8);
+
+    if (status != VX_SUCCESS)
+        return status;
+
+    vxcpu_parallel_band(out, [=](vx_uint32 y0, vx_uint32 y1) {
+        vxcpu_row_cache cache(in, 1, 1, border);
+
+        for (vx_uint32 y = y0; y < y1; y++) {
+            const vx_uint8 *r0 = cache.row((vx_int32)y - 1);
+            const vx_uint8 *r1 = cache.row((vx_int32)y);
+            const vx_uint8 *r2 = cache.row((vx_int32)y + 1);
+            vx_uint8 *d = vxcpu_row<vx_uint8>(out, y);
+
+            for (vx_uint32 x = 0; x < out->width; x += VXCPU_LANES_U8) {
+                v_uint8x16 p0 = v_load(r0 + x - 1), p1 = v_load(r0 + x), p2 = v_load(r0 + x + 1);
+                v_uint8x16 p3 = v_load(r1 + x - 1), p4 = v_load(r1 + x), p5 = v_load(r1 + x + 1);
+                v_uint8x16 p6 = v_load(r2 + x - 1), p7 = v_load(r2 + x), p8 = v_load(r2 + x + 1);
+
+                /* 19 exchanges leave the median of 9 in p4 */
+                vxcpu_sort2(p1, p2); vxcpu_sort2(p4, p5); vxcpu_sort2(p7, p8);
+                vxcpu_sort2(p0, p1); vxcpu_sort2(p3, p4); vxcpu_sort2(p6, p7);
+                vxcpu_sort2(p1, p2); vxcpu_sort2(p4, p5); vxcpu_sort2(p7, p8);
+                vxcpu_sort2(p0, p3); vxcpu_sort2(p5, p8); vxcpu_sort2(p4, p7);
+                vxcpu_sort2(p3, p6); vxcpu_sort2(p1, p4); vxcpu_sort2(p2, p5);
+                vxcpu_sort2(p4, p7); vxcpu_sort2(p4, p2); vxcpu_sort2(p6, p4);
+                vxcpu_sort2(p4, p2);
+
+                if (x + VXCPU_LANES_U8 <= out->width) {
+                    v_store(d + x, p4);
+                } else {
+                    vx_uint8 tmp[VXCPU_LANES_U8];
+                    v_store(tmp, p4);
+                    memcpy(d + x, tmp, out->width - x);
+                }
+            }
+        }
+    });
+
+    return VX_SUCCESS;
+}
+
+/*
+ * 3x3 gradients, smooth * derivative: sobel smooths with [1 2 1], scharr
+ * with [3 10 3].
+ */
+template <vx_int16 SIDE, vx_int16 CENTER>
+static vx_status vxcpu_gradient3x3(const vxcpu_image_t *in, vxcpu_image_t *grad_x, vxcpu_image_t *grad_y,
+                                        const vx_border_mode_t *border)
+{
+    if ((grad_x && vxcpu_check_u8(in, grad_x, VX_DF_IMAGE_S16) != VX_SUCCESS) ||
+        (grad_y && vxcpu_check_u8(in, grad_y, VX_DF_IMAGE_S16) != VX_SUCCESS))
+        return VX_ERROR_INVALID_PARAMETERS;
+    if (grad_x == NULL && grad_y == NULL)
+        return VX_SUCCESS;
+    /* both outputs are walked by the rows of one */
+    if (grad_x && grad_y && (grad_x->start_y != grad_y->start_y || vxcpu_end_row(grad_x) != vxcpu_end_row(grad_y)))
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    vxcpu_parallel_band(grad_x ? grad_x : grad_y, [=](vx_uint32 y0, vx_uint32 y1) {
+        if (grad_x) {
+            vxcpu_separable(in, 1, border, y0, y1,
+                [](const vx_uint8 **r, vx_int32 x) {
+                    return (vxcpu_col(r[0], x) + vxcpu_col(r[2], x)) * SIDE + vxcpu_col(r[1], x) * CENTER;
+                },
+                [](const vx_int16 *mid, vx_int32 x, v_int32x8 *v) {
+                    v_int32x8 m[3];
+
+                    vxcpu_mid(m, 1, mid, x);
+                    *v = m[2] - m[0];
+                },
+                [=](vx_uint32 y, vx_int32 x, const v_int32x8 &v) {
+                    vxcpu_store_s16(vxcpu_row<vx_int16>(grad_x, y), x, grad_x->width, v);
+                });
+        }
+        if (grad_y) {
+            vxcpu_separable(in, 1, border, y0, y1,
+                [](const vx_uint8 **r, vx_int32 x) {
+                    return vxcpu_col(r[2], x) - vxcpu_col(r[0], x);
+                },
+                [](const vx_int16 *mid, vx_int32 x, v_int32x8 *v) {
+                    v_int32x8 m[3];
+
+                    vxcpu_mid(m, 1, mid, x);
+                    *v = (m[0] + m[2]) * SIDE + m[1] * CENTER;
+                },
+                [=](vx_uint32 y, vx_int32 x, const v_int32x8 &v) {
+                    vxcpu_store_s16(vxcpu_row<vx_int16>(grad_y, y), x, grad_y->width, v);
+                });
+        }
+    });
+
+    return VX_SUCCESS;
+}
+
+vx_status vxcpu_sobel3x3(const vxcpu_image_t *in, vxcpu_image_t *grad_x, vxcpu_image_t *grad_y,
+                                const vx_border_mode_t *border)
+{
+    return vxcpu_gradient3x3<1, 2>(in, grad_x, grad_y, border);
+}
+
+vx_status vxcpu_scharr3x3(const vxcpu_image_t *in, vxcpu_image_t *grad_x, vxcpu_image_t *grad_y,
+                                const vx_border_mode_t *border)
+{
+    return vxcpu_gradient3x3<3, 10>(in, grad_x, grad_y, border);
+}
+
+vx_status vxcpu_convolve(const vxcpu_image_t *in, const vx_int16 *coeffs, vx_uint32 cols, vx_uint32 rows,
+                                vx_uint32 scale, vxcpu_image_t *out, const vx_border_mode_t *border)
+{
+    vx_int32 shift = -1;
+
+    if (!vxcpu_same_size(in, out))
+        return VX_ERROR_INVALID_PARAMETERS;
+    if (in->format != VX_DF_IMAGE_U8 || (out->format != VX_DF_IMAGE_U8 && out->format != VX_DF_IMAGE_S16))
+        return VX_ERROR_INVALID_FORMAT;
+    if (cols == 0 || rows == 0 || (cols & 1) == 0 || (rows & 1) == 0 ||
+        cols > VXCPU_MAX_CONVOLUTION_DIM || rows > VXCPU_MAX_CONVOLUTION_DIM || scale == 0)
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    /* the spec asks for a power of 2, anything else takes a division */
+    if ((scale & (scale - 1)) == 0) {
+        for (shift = 0; (1u << shift) != scale; shift++)
+            ;
+    }
+
+    vxcpu_parallel_band(out, [=](vx_uint32 y0, vx_uint32 y1) {
+        vx_int32 rx = cols / 2, ry = rows / 2;
+        vxcpu_row_cache cache(in, rx, ry, border);
+        const vx_uint8 *r[VXCPU_MAX_CONVOLUTION_DIM];
+        /* flipped, so that coefficient k multiplies window pixel k */
+        vx_int32 c[VXCPU_MAX_CONVOLUTION_DIM * VXCPU_MAX_CONVOLUTION_DIM];
+        vx_uint32 n = cols * rows;
+
+        for (vx_uint32 k = 0; k < n; k++)
+            c[k] = coeffs[n - 1 - k];
+
+        for (vx_uint32 y = y0; y < y1; y++) {
+            for (vx_uint32 i = 0; i < rows; i++)
+                r[i] = cache.row((vx_int32)y - ry + (vx_int32)i);
+
+            for (vx_uint32 x = 0; x < out->width; x += VXCPU_LANES) {
+                v_int32x8 sum = {}, p;
+
+                for (vx_uint32 i = 0; i < rows; i++) {
+                    const vx_uint8 *src = r[i] + x - rx;
+                    const vx_int32 *ci = c + i * cols;
+
+                    for (vx_uint32 j = 0; j < cols; j++) {
+                        if (ci[j]) {
+                            v_load_expand_s32(&p, src + j);
+                            sum += p * ci[j];
+                        }
+                    }
+                }
+
+                /* C division, towards zero */
+                if (shift >= 0)
+                    sum = (sum + ((sum >> 31) & (vx_int32)(scale - 1))) >> shift;
+                else
+                    sum = sum / (vx_int32)scale;
+
+                if (out->format == VX_DF_IMAGE_U8)
+                    vxcpu_store_u8(vxcpu_row<vx_uint8>(out, y), x, out->width, sum);
+                else
+                    vxcpu_store_s16(vxcpu_row<vx_int16>(out, y), x, out->width, sum);
+            }
+        }
+    });
+
+    return VX_SUCCESS;
+}
@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vxcpu_core_priv.h"
+
+/* bilinear weights, Q11 */
+#define VXCPU_INTER_BITS    (11)
+#define VXCPU_INTER_ONE     (1 << VXCPU_INTER_BITS)
+
+/* source pixel of destination pixel x at ratio src/dst, centers aligned */
+static inline vx_float32 vxcpu_src_coord(vx_uint32 x, vx_float32 ratio)
+{
+    return ((vx_float32)x + 0.5f) * ratio - 0.5f;
+}
+
+static inline vx_int32 vxcpu_nearest_coord(vx_uint32 x, vx_float32 ratio, vx_uint32 size)
+{
+    vx_float32 src = vxcpu_src_coord(x, ratio);
+    vx_int32 i = (vx_int32)src;
+
+    if (src - (vx_float32)i >= 0.5f)
+        i++;
+    return vxcpu_clamp(i, 0, (vx_int32)size - 1);
+}
+
+static void vxcpu_scale_nearest(const vxcpu_image_t *in, vxcpu_image_t *out)
+{
+    vx_float32 wr = (vx_float32)in->width / out->width;
+    vx_float32 hr = (vx_float32)in->height / out->height;
+    std::vector<vx_int32> xmap(out->width);
+
+    for (vx_uint32 x = 0; x < out->width; x++)
+        xmap[x] = vxcpu_nearest_coord(x, wr, in->width);
+
+    vxcpu_parallel_rows(out->height, out->width, [&](vx_uint32 y0, vx_uint32 y1) {
+        for (vx_uint32 y = y0; y < y1; y++) {
+            const vx_uint8 *s = vxcpu_row<vx_uint8>(in, vxcpu_nearest_coord(y, hr, in->height));
+            vx_uint8 *d = vxcpu_row<vx_uint8>(out, y);
+
+            for (vx_uint32 x = 0; x < out->width; x++)
+                d[x] = s[xmap[x]];
+        }
+    });
+}
+
+/*
+ * Rows are blended first, 8 pixels at a time, into a row of Q11 values; the
+ * columns are then picked out of that row.
+ */
+static void vxcpu_scale_bilinear(const vxcpu_image_t *in, vxcpu_image_t *out, const vx_border_mode_t *border)
+{
+    vx_float32 wr = (vx_float32)in->width / out->width;
+    vx_float32 hr = (vx_float32)in->height / out->height;
+    std::vector<vx_int32> xmap(out->width);
+    std::vector<vx_int32> xweight(out->width);
+
+    /* the source x stays within [-1, width], the padding of the row cache */
+    for (vx_uint32 x = 0; x < out->width; x++) {
+        vx_float32 src = vxcpu_src_coord(x, wr);
+        vx_float32 x0 = floorf(src);
+
+        xmap[x] = vxcpu_clamp((vx_int32)x0, -1, in->width - 1);
+        xweight[x] = (vx_int32)((src - x0) * VXCPU_INTER_ONE + 0.5f);
+    }
+
+    vxcpu_parallel_rows(out->height, out->width, [&](vx_uint32 y0, vx_uint32 y1) {
+        vxcpu_row_cache cache(in, 1, 1, border);
+        std::vector<vx_int32> blend(in->width + 2 + 2 * VXCPU_LANES);
+        vx_int32 *t = &blend[1];
+
+        for (vx_uint32 y = y0; y < y1; y++) {
+            vx_float32 src = vxcpu_src_coord(y, hr);
+            vx_float32 fy0 = floorf(src);
+            vx_int32 sy = vxcpu_clamp((vx_int32)fy0, -1, in->height - 1);
+            vx_int32 wy = (vx_int32)((src - fy0) * VXCPU_INTER_ONE + 0.5f);
+            const vx_uint8 *r0 = cache.row(sy);
+            const vx_uint8 *r1 = cache.row(sy + 1);
+            vx_uint8 *d = vxcpu_row<vx_uint8>(out, y);
+
+            for (vx_int32 x = -1; x <= (vx_int32)in->width; x += VXCPU_LANES) {
+                v_int32x8 v0, v1, v;
+
+                v_load_expand_s32(&v0, r0 + x);
+                v_load_expand_s32(&v1, r1 + x);
+                v = v0 * (VXCPU_INTER_ONE - wy) + v1 * wy;
+                memcpy(t + x, &v, sizeof(v));
+            }
+
+            for (vx_uint32 x = 0; x < out->width; x++) {
+                const vx_int32 *p = t + xmap[x];
+                vx_int32 wx = xweight[x];
+
+                d[x] = (vx_uint8)((p[0] * (VXCPU_INTER_ONE - wx) + p[1] * wx +
+                                  (1 << (2 * VXCPU_INTER_BITS - 1))) >> (2 * VXCPU_INTER_BITS));
+            }
+        }
+    });
+}
+
+/* downscale: mean of the source pixels a destination pixel covers */
+static void vxcpu_scale_area(const vxcpu_image_t *in, vxcpu_image_t *out)
+{
+    vx_float32 wr = (vx_float32)in->width / out->width;
+    vx_float32 hr = (vx_float32)in->height / out->height;
+    std::vector<vx_int32> xbegin(out->width + 1);
+
+    for (vx_uint32 x = 0; x <= out->width; x++)
+        xbegin[x] = vxcpu_clamp((vx_int32)((vx_float32)x * wr), 0, in->width);
+
+    vxcpu_parallel_rows(out->height, out->width, [&](vx_uint32 y0, vx_uint32 y1) {
+        std::vector<vx_uint32> sums(in->width + VXCPU_LANES);
+
+        for (vx_uint32 y = y0; y < y1; y++) {
+            vx_int32 sy0 = vxcpu_clamp((vx_int32)((vx_float32)y * hr), 0, in->height - 1);
+            vx_int32 sy1 = vxcpu_clamp((vx_int32)((vx_float32)(y + 1) * hr), sy0 + 1, in->height);
+            vx_uint8 *d = vxcpu_row<vx_uint8>(out, y);
+
+            memset(&sums[0], 0, in->width * sizeof(vx_uint32));
+            for (vx_int32 sy = sy0; sy < sy1; sy++) {
+                const vx_uint8 *s = vxcpu_row<vx_uint8>(in, sy);
+                vx_uint32 x = 0;
+
+                for (; x + VXCPU_LANES <= in->width; x += VXCPU_LANES) {
+                    v_uint32x8 sum;
+                    v_int32x8 v;
+
+                    v_load(&sum, &sums[x]);
+                    v_load_expand_s32(&v, s + x);
+                    v_store(&sums[x], sum + (v_uint32x8)v);
+                }
+                for (; x < in->width; x++)
+                    sums[x] += s[x];
+            }
+
+            for (vx_uint32 x = 0; x < out->width; x++) {
+                vx_int32 sx0 = vxcpu_clamp(xbegin[x], 0, in->width - 1);
+                vx_int32 sx1 = xbegin[x + 1] > sx0 ? xbegin[x + 1] : sx0 + 1;
+                vx_uint32 n = (vx_uint32)((sx1 - sx0) * (sy1 - sy0));
+                vx_uint32 sum = 0;
+
+                for (vx_int32 sx = sx0; sx < sx1; sx++)
+                    sum += sums[sx];
+                d[x] = (vx_uint8)((sum + n / 2) / n);
+            }
+        }
+    });
+}
+
+vx_status vxcpu_scale_image(const vxcpu_image_t *in, vxcpu_image_t *out, vx_enum interpolation,
+                                const vx_border_mode_t *border)
+{
+    if (in->format != VX_DF_IMAGE_U8 || out->format != VX_DF_IMAGE_U8)
+        return VX_ERROR_INVALID_FORMAT;
+    if (in->width == 0 || in->height == 0 || out->width == 0 || out->height == 0)
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    switch (interpolation) {
+    case VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR:
+        vxcpu_scale_nearest(in, out);
+        break;
+    case VX_INTERPOLATION_TYPE_AREA:
+        /* only defined for shrinking, otherwise the same as bilinear */
+        if (out->width <= in->width && out->height <= in->height) {
+            vxcpu_scale_area(in, out);
+            break;
+        }
+        /* fall through */
+    case VX_INTERPOLATION_TYPE_BILINEAR:
+        vxcpu_scale_bilinear(in, out, border);
+        break;
+    default:
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    return VX_SUCCESS;
+}
+
+/* source pixel (x, y), which may be outside of the image */
+static inline vx_int32 vxcpu_warp_pixel(const vxcpu_image_t *in, vx_int32 x, vx_int32 y,
+                                            const vx_border_mode_t *border)
+{
+    if (x < 0 || y < 0 || x >= (vx_int32)in->width || y >= (vx_int32)in->height) {
+        if (border->mode == VX_BORDER_MODE_CONSTANT)
+            return (vx_uint8)border->constant_value;
+        x = vxcpu_clamp(x, 0, in->width - 1);
+        y = vxcpu_clamp(y, 0, in->height - 1);
+    }
+
+    return vxcpu_row<vx_uint8>(in, y)[x];
+}
+
+/*
+ * Warps share the sampling: map(x, y, &xf, &yf) gives the source coordinates
+ * of 8 destination pixels, which are then fetched one by one.  A 2x2 inside
+ * of the image is read straight from its rows, only one reaching the border
+ * goes through vxcpu_warp_pixel().  The bilinear blend is done on the 8
+ * lanes at once.
+ */
+template <typename Map>
+static void vxcpu_warp(const vxcpu_image_t *in, vx_enum interpolation, vxcpu_image_t *out,
+                            const vx_border_mode_t *border, Map map)
+{
+    vxcpu_parallel_rows(out->height, out->width, [=](vx_uint32 y0, vx_uint32 y1) {
+        /* far enough out that any pixel of the 2x2 is a border pixel, NaN ends up there too */
+        v_float32x8 lo, xhi, yhi;
+        const v_float32x8 xs = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f };
+        vx_int32 xi[VXCPU_LANES], yi[VXCPU_LANES];
+        vx_int32 p[4][VXCPU_LANES] = {};
+
+        v_setall_f32(&lo, -2.0f);
+        v_setall_f32(&xhi, (vx_float32)in->width + 1.0f);
+        v_setall_f32(&yhi, (vx_float32)in->height + 1.0f);
+
+        for (vx_uint32 y = y0; y < y1; y++) {
+            vx_uint8 *d = vxcpu_row<vx_uint8>(out, y);
+            v_float32x8 fy;
+
+            v_setall_f32(&fy, (vx_float32)y);
+
+            for (vx_uint32 x = 0; x < out->width; x += VXCPU_LANES) {
+                v_float32x8 xf, yf, f;
+                v_int32x8 vxi, vyi;
+                vx_uint32 n = out->width - x < VXCPU_LANES ? out->width - x : VXCPU_LANES;
+
+                map(xs + (vx_float32)x, fy, &xf, &yf);
+                v_max(&xf, xf, lo);
+                v_min(&xf, xf, xhi);
+                v_max(&yf, yf, lo);
+                v_min(&yf, yf, yhi);
+                v_floor(&vxi, xf);
+                v_floor(&vyi, yf);
+                memcpy(xi, &vxi, sizeof(xi));
+                memcpy(yi, &vyi, sizeof(yi));
+
+                if (interpolation == VX_INTERPOLATION_TYPE_BILINEAR) {
+                    v_float32x8 p00, p01, p10, p11, ax, ay, top, bottom;
+                    v_int32x8 v;
+
+                    for (vx_uint32 i = 0; i < n; i++) {
+                        if ((vx_uint32)xi[i] < in->width - 1 && (vx_uint32)yi[i] < in->height - 1) {
+                            const vx_uint8 *s = vxcpu_row<vx_uint8>(in, yi[i]) + xi[i];
+
+                            p[0][i] = s[0];
+                            p[1][i] = s[1];
+                            p[2][i] = s[in->stride];
+                            p[3][i] = s[in->stride + 1];
+                        } else {
+                            p[0][i] = vxcpu_warp_pixel(in, xi[i], yi[i], border);
+                            p[1][i] = vxcpu_warp_pixel(in, xi[i] + 1, yi[i], border);
+                            p[2][i] = vxcpu_warp_pixel(in, xi[i], yi[i] + 1, border);
+                            p[3][i] = vxcpu_warp_pixel(in, xi[i] + 1, yi[i] + 1, border);
+                        }
+                    }
+                    memcpy(&v, p[0], sizeof(v));
+                    v_cvt_f32(&p00, v);
+                    memcpy(&v, p[1], sizeof(v));
+                    v_cvt_f32(&p01, v);
+                    memcpy(&v, p[2], sizeof(v));
+                    v_cvt_f32(&p10, v);
+                    memcpy(&v, p[3], sizeof(v));
+                    v_cvt_f32(&p11, v);
+
+                    v_cvt_f32(&f, vxi);
+                    ax = xf - f;
+                    v_cvt_f32(&f, vyi);
+                    ay = yf - f;
+                    top = p00 + (p01 - p00) * ax;
+                    bottom = p10 + (p11 - p10) * ax;
+                    v_trunc(&v, top + (bottom - top) * ay + 0.5f);
+
+                    if (n == VXCPU_LANES) {
+                        v_trunc_store_u8(d + x, v);
+                    } else {
+                        vx_uint8 tmp[VXCPU_LANES];
+                        v_trunc_store_u8(tmp, v);
+                        memcpy(d + x, tmp, n);
+                    }
+                } else {
+                    for (vx_uint32 i = 0; i < n; i++) {
+                        if ((vx_uint32)xi[i] < in->width && (vx_uint32)yi[i] < in->height)
+                            d[x + i] = vxcpu_row<vx_uint8>(in, yi[i])[xi[i]];
+                        else
+                            d[x + i] = (vx_uint8)vxcpu_warp_pixel(in, xi[i], yi[i], border);
+                    }
+                }
+            }
+        }
+    });
+}
+
+vx_status vxcpu_warp_affine(const vxcpu_image_t *in, const vx_float32 matrix[6], vx_enum interpolation,
+                                vxcpu_image_t *out, const vx_border_mode_t *border)
+{
+    vx_float32 m[6];
+
+    if (in->format != VX_DF_IMAGE_U8 || out->format != VX_DF_IMAGE_U8)
+        return VX_ERROR_INVALID_FORMAT;
+    if (in->width == 0 || in->height == 0 ||
+        (interpolation != VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR && interpolation != VX_INTERPOLATION_TYPE_BILINEAR))
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    memcpy(m, matrix, sizeof(m));
+    vxcpu_warp(in, interpolation, out, border,
+        [m](const v_float32x8 &x, const v_float32x8 &y, v_float32x8 *xf, v_float32x8 *yf) {
+            *xf = x * m[0] + y * m[2] + m[4];
+            *yf = x * m[1] + y * m[3] + m[5];
+        });
+
+    return VX_SUCCESS;
+}
+
+vx_status vxcpu_warp_perspective(const vxcpu_image_t *in, const vx_float32 matrix[9], vx_enum interpolation,
+                                vxcpu_image_t *out, const vx_border_mode_t *border)
+{
+    vx_float32 m[9];
+
+    if (in->format != VX_DF_IMAGE_U8 || out->format != VX_DF_IMAGE_U8)
+        return VX_ERROR_INVALID_FORMAT;
+    if (in->width == 0 || in->height == 0 ||
+        (interpolation != VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR && interpolation != VX_INTERPOLATION_TYPE_BILINEAR))
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    memcpy(m, matrix, sizeof(m));
+    vxcpu_warp(in, interpolation, out, border,
+        [m](const v_float32x8 &x, const v_float32x8 &y, v_float32x8 *xf, v_float32x8 *yf) {
+            v_float32x8 z = x * m[2] + y * m[5] + m[8];
+
+            *xf = (x * m[0] + y * m[3] + m[6]) / z;
+            *yf = (x * m[1] + y * m[4] + m[7]) / z;
+        });
+
+    return VX_SUCCESS;
+}
+
+vx_status vxcpu_pyramid_level(const vxcpu_image_t *in, vxcpu_image_t *out, const vx_border_mode_t *border)
+{
+    std::vector<vx_uint8> buf((size_t)in->width * in->height);
+    vxcpu_image_t smooth = *in;
+    vx_status status;
+
+    smooth.ptr = buf.data();
+    smooth.stride = in->width;
+    status = vxcpu_gaussian5x5(in, &smooth, border);
+    if (status != VX_SUCCESS)
+        return status;
+
+    return vxcpu_scale_image(&smooth, out, VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR, border);
+}
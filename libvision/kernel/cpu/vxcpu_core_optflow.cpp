@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vxcpu_core_priv.h"
+
+#define INT_ROUND(x,n)     (((x) + (1 << ((n)-1))) >> (n))
+
+#define LK_W_BITS           (14)
+#define LK_FLT_SCALE        (1.f/(1 << 20))
+/* VX_TERM_CRITERIA_EPSILON alone still has to stop somewhere */
+#define LK_MAX_ITERATIONS   (100)
+
+struct vxcpu_lk_point_t {
+    vx_float32 x;
+    vx_float32 y;
+};
+
+struct vxcpu_lk_level_t {
+    const vxcpu_image_t *prev;
+    const vxcpu_image_t *next;
+    const vx_int16 *grad_x;     /* of prev, width x height */
+    const vx_int16 *grad_y;
+};
+
+/* per thread patch of the previous image and of its gradients */
+struct vxcpu_lk_window_t {
+    std::vector<vx_int16> i;
+    std::vector<vx_int16> ix;
+    std::vector<vx_int16> iy;
+};
+
+static inline void vxcpu_lk_weights(vx_float32 a, vx_float32 b, vx_int32 w[4])
+{
+    w[0] = (vx_int32)(((1.f - a) * (1.f - b) * (1 << LK_W_BITS)) + 0.5f);
+    w[1] = (vx_int32)((a * (1.f - b) * (1 << LK_W_BITS)) + 0.5f);
+    w[2] = (vx_int32)(((1.f - a) * b * (1 << LK_W_BITS)) + 0.5f);
+    w[3] = (1 << LK_W_BITS) - w[0] - w[1] - w[2];
+}
+
+/*
+ * One level of the tracker, coordinates of the window's top left corner.
+ * Returns false when the point is lost at this level.
+ */
+static bool vxcpu_lk_track(const vxcpu_lk_level_t *level, vxcpu_lk_point_t prev, vxcpu_lk_point_t *next,
+                                const vxcpu_optflow_params_t *params, vx_uint32 max_iterations,
+                                vxcpu_lk_window_t *win)
+{
+    vx_int32 win_size = (vx_int32)params->window_dimension;
+    vx_int32 width = level->prev->width, height = level->prev->height;
+    vx_int32 stride_i = level->prev->stride, stride_j = level->next->stride;
+    vx_int32 ix0 = (vx_int32)floorf(prev.x), iy0 = (vx_int32)floorf(prev.y);
+    vxcpu_lk_point_t prev_delta = { 0.0f, 0.0f };
+    vx_float64 A11 = 0, A12 = 0, A22 = 0, D;
+    vx_float32 minEig;
+    vx_int32 w[4];
+
+    if (ix0 < 0 || ix0 >= width - win_size - 1 || iy0 < 0 || iy0 >= height - win_size - 1)
+        return false;
+
+    /* patch of the first image and covariance of its derivatives */
+    vxcpu_lk_weights(prev.x - ix0, prev.y - iy0, w);
+    for (vx_int32 y = 0; y < win_size; y++) {
+        const vx_uint8 *src = vxcpu_row<vx_uint8>(level->prev, iy0 + y) + ix0;
+        const vx_int16 *dx = level->grad_x + (iy0 + y) * width + ix0;
+        const vx_int16 *dy = level->grad_y + (iy0 + y) * width + ix0;
+        vx_int16 *Iptr = &win->i[y * win_size];
+        vx_int16 *dIptr_x = &win->ix[y * win_size];
+        vx_int16 *dIptr_y = &win->iy[y * win_size];
+
+        for (vx_int32 x = 0; x < win_size; x++) {
+            vx_int32 ival = INT_ROUND(src[x] * w[0] + src[x + 1] * w[1] +
+                                      src[x + stride_i] * w[2] + src[x + stride_i + 1] * w[3], LK_W_BITS - 5);
+            vx_int32 ixval = INT_ROUND(dx[x] * w[0] + dx[x + 1] * w[1] +
+                                       dx[x + width] * w[2] + dx[x + width + 1] * w[3], LK_W_BITS);
+            vx_int32 iyval = INT_ROUND(dy[x] * w[0] + dy[x + 1] * w[1] +
+                                       dy[x + width] * w[2] + dy[x + width + 1] * w[3], LK_W_BITS);
+
+            Iptr[x] = (vx_int16)ival;
+            dIptr_x[x] = (vx_int16)ixval;
+            dIptr_y[x] = (vx_int16)iyval;
+
+            A11 += (vx_float32)(ixval * ixval);
+            A12 += (vx_float32)(ixval * iyval);
+            A22 += (vx_float32)(iyval * iyval);
+        }
+    }
+
+    A11 *= LK_FLT_SCALE;
+    A12 *= LK_FLT_SCALE;
+    A22 *= LK_FLT_SCALE;
+
+    D = A11 * A22 - A12 * A12;
+    minEig = (A22 + A11 - sqrt((A11 - A22) * (A11 - A22) + 4.f * A12 * A12)) / (2 * win_size * win_size);
+    if (minEig < 1.0e-04F || D < 1.0e-07F)
+        return false;
+    D = 1.f / D;
+
+    for (vx_uint32 j = 0; j < max_iterations; j++) {
+        vx_int32 jx0 = (vx_int32)floorf(next->x), jy0 = (vx_int32)floorf(next->y);
+        vx_float64 b1 = 0, b2 = 0;
+        vx_float32 delta_x, delta_y;
+
+        if (jx0 < 0 || jx0 >= width - win_size - 1 || jy0 < 0 || jy0 >= height - win_size - 1)
+            return false;
+
+        vxcpu_lk_weights(next->x - jx0, next->y - jy0, w);
+        for (vx_int32 y = 0; y < win_size; y++) {
+            const vx_uint8 *Jptr = vxcpu_row<vx_uint8>(level->next, jy0 + y) + jx0;
+            const vx_int16 *Iptr = &win->i[y * win_size];
+            const vx_int16 *dIptr_x = &win->ix[y * win_size];
+            const vx_int16 *dIptr_y = &win->iy[y * win_size];
+
+            for (vx_int32 x = 0; x < win_size; x++) {
+                vx_int32 diff = INT_ROUND(Jptr[x] * w[0] + Jptr[x + 1] * w[1] +
+                                          Jptr[x + stride_j] * w[2] + Jptr[x + stride_j + 1] * w[3],
+                                          LK_W_BITS - 5) - Iptr[x];
+                b1 += (vx_float32)(diff * dIptr_x[x]);
+                b2 += (vx_float32)(diff * dIptr_y[x]);
+            }
+        }
+
+        b1 *= LK_FLT_SCALE;
+        b2 *= LK_FLT_SCALE;
+
+        delta_x = (vx_float32)((A12 * b2 - A22 * b1) * D);
+        delta_y = (vx_float32)((A12 * b1 - A11 * b2) * D);
+        next->x += delta_x;
+        next->y += delta_y;
+
+        if (delta_x * delta_x + delta_y * delta_y <= params->epsilon &&
+            (params->termination == VX_TERM_CRITERIA_EPSILON || params->termination == VX_TERM_CRITERIA_BOTH))
+            break;
+
+        /* going back and forth, settle in the middle */
+        if (j > 0 && fabsf(delta_x + prev_delta.x) < 0.01f && fabsf(delta_y + prev_delta.y) < 0.01f) {
+            next->x -= delta_x * 0.5f;
+            next->y -= delta_y * 0.5f;
+            break;
+        }
+        prev_delta.x = delta_x;
+        prev_delta.y = delta_y;
+    }
+
+    return true;
+}
+
+vx_status vxcpu_optical_flow_pyr_lk(const vxcpu_image_t *old_levels, const vxcpu_image_t *new_levels,
+                                vx_size num_levels, const vx_keypoint_t *old_points,
+                                const vx_keypoint_t *new_points_estimates, vx_keypoint_t *new_points,
+                                vx_size num_points, const vxcpu_optflow_params_t *params)
+{
+    std::vector<std::vector<vx_int16> > grad(2 * num_levels);
+    std::vector<vxcpu_lk_level_t> levels(num_levels);
+    vx_border_mode_t border = { VX_BORDER_MODE_REPLICATE, 0 };
+    vx_uint32 max_iterations;
+    vx_float32 top_scale;
+
+    if (num_levels == 0 || params->window_dimension < 3 || params->pyramid_scale <= 0.0f ||
+        params->pyramid_scale >= 1.0f)
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    switch (params->termination) {
+    case VX_TERM_CRITERIA_ITERATIONS:
+    case VX_TERM_CRITERIA_BOTH:
+        max_iterations = params->num_iterations;
+        break;
+    case VX_TERM_CRITERIA_EPSILON:
+        max_iterations = LK_MAX_ITERATIONS;
+        break;
+    default:
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    /* derivatives of the previous pyramid, Scharr as the tracker expects */
+    for (vx_size l = 0; l < num_levels; l++) {
+        const vxcpu_image_t *prev = &old_levels[l];
+        vxcpu_image_t gx = { NULL, (vx_int32)(prev->width * sizeof(vx_int16)), prev->width, prev->height,
+                              VX_DF_IMAGE_S16, 0, 0 };
+        vxcpu_image_t gy = gx;
+        vx_status status;
+
+        if (prev->format != VX_DF_IMAGE_U8 || new_levels[l].format != VX_DF_IMAGE_U8 ||
+            !vxcpu_same_size(prev, &new_levels[l]))
+            return VX_ERROR_INVALID_FORMAT;
+
+        grad[2 * l].resize((size_t)prev->width * prev->height);
+        grad[2 * l + 1].resize((size_t)prev->width * prev->height);
+        gx.ptr = grad[2 * l].data();
+        gy.ptr = grad[2 * l + 1].data();
+        status = vxcpu_scharr3x3(prev, &gx, &gy, &border);
+        if (status != VX_SUCCESS)
+            return status;
+
+        levels[l].prev = prev;
+        levels[l].next = &new_levels[l];
+        levels[l].grad_x = grad[2 * l].data();
+        levels[l].grad_y = grad[2 * l + 1].data();
+    }
+
+    top_scale = powf(params->pyramid_scale, (vx_float32)(num_levels - 1));
+
+    /* every point runs down the whole pyramid on its own */
+    vxcpu_parallel_for(num_points, 16, [&](vx_uint32 p0, vx_uint32 p1) {
+        vx_size win_area = params->window_dimension * params->window_dimension;
+        vx_float32 half_win = (vx_float32)(params->window_dimension / 2);
+        vxcpu_lk_window_t win;
+
+        win.i.resize(win_area);
+        win.ix.resize(win_area);
+        win.iy.resize(win_area);
+
+        for (vx_uint32 p = p0; p < p1; p++) {
+            const vx_keypoint_t *initial = params->use_initial_estimate ? &new_points_estimates[p] : &old_points[p];
+            vx_keypoint_t *out = &new_points[p];
+            vxcpu_lk_point_t prev, next;
+            vx_int32 tracking = old_points[p].tracking_status;
+
+            *out = *initial;
+            if (tracking == 0)
+                continue;
+
+            prev.x = old_points[p].x * top_scale;
+            prev.y = old_points[p].y * top_scale;
+            next.x = initial->x * top_scale;
+            next.y = initial->y * top_scale;
+
+            for (vx_int32 l = (vx_int32)num_levels - 1; l >= 0; l--) {
+                vxcpu_lk_point_t corner;
+                bool tracked;
+
+                if (l != (vx_int32)num_levels - 1) {
+                    prev.x /= params->pyramid_scale;
+                    prev.y /= params->pyramid_scale;
+                    next.x /= params->pyramid_scale;
+                    next.y /= params->pyramid_scale;
+                }
+
+                /* the tracker works on the top left corner of the window */
+                corner.x = prev.x - half_win;
+                corner.y = prev.y - half_win;
+                next.x -= half_win;
+                next.y -= half_win;
+                tracked = vxcpu_lk_track(&levels[l], corner, &next, params, max_iterations, &win);
+                next.x += half_win;
+                next.y += half_win;
+
+                /* lost above the finest level: go on from the last estimate */
+                if (!tracked && l == 0)
+                    tracking = 0;
+            }
+
+            out->x = (vx_int32)(next.x + 0.5f);
+            out->y = (vx_int32)(next.y + 0.5f);
+            out->tracking_status = tracking;
+            out->error = 0;
+        }
+    });
+
+    return VX_SUCCESS;
+}
@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vxcpu_core_priv.h"
+
+static inline vx_int32 vxcpu_saturate_s16(vx_int32 v)
+{
+    return vxcpu_clamp(v, INT16_MIN, INT16_MAX);
+}
+
+/* 8 pixels of a U8 or S16 row, as s32 */
+static inline void vxcpu_load_s32(v_int32x8 *v, const void *row, vx_df_image format, vx_uint32 x)
+{
+    if (format == VX_DF_IMAGE_U8)
+        v_load_expand_s32(v, (const vx_uint8 *)row + x);
+    else
+        v_load_expand_s32(v, (const vx_int16 *)row + x);
+}
+
+static inline vx_int32 vxcpu_pixel_s32(const void *row, vx_df_image format, vx_uint32 x)
+{
+    if (format == VX_DF_IMAGE_U8)
+        return ((const vx_uint8 *)row)[x];
+    else
+        return ((const vx_int16 *)row)[x];
+}
+
+vx_status vxcpu_absdiff(const vxcpu_image_t *in1, const vxcpu_image_t *in2, vxcpu_image_t *out)
+{
+    if (!vxcpu_same_size(in1, in2) || !vxcpu_same_size(in1, out) ||
+        in1->format != in2->format || in1->format != out->format)
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    if (in1->format == VX_DF_IMAGE_U8) {
+        vxcpu_parallel_band(out, [=](vx_uint32 y0, vx_uint32 y1) {
+            for (vx_uint32 y = y0; y < y1; y++) {
+                const vx_uint8 *a = vxcpu_row<vx_uint8>(in1, y);
+                const vx_uint8 *b = vxcpu_row<vx_uint8>(in2, y);
+                vx_uint8 *d = vxcpu_row<vx_uint8>(out, y);
+                vx_uint32 x = 0;
+
+                for (; x + VXCPU_LANES_U8 <= out->width; x += VXCPU_LANES_U8)
+                    v_store(d + x, v_absdiff(v_load(a + x), v_load(b + x)));
+                for (; x < out->width; x++)
+                    d[x] = (vx_uint8)abs(a[x] - b[x]);
+            }
+        });
+    } else if (in1->format == VX_DF_IMAGE_S16) {
+        vxcpu_parallel_band(out, [=](vx_uint32 y0, vx_uint32 y1) {
+            for (vx_uint32 y = y0; y < y1; y++) {
+                const vx_int16 *a = vxcpu_row<vx_int16>(in1, y);
+                const vx_int16 *b = vxcpu_row<vx_int16>(in2, y);
+                vx_int16 *d = vxcpu_row<vx_int16>(out, y);
+                vx_uint32 x = 0;
+
+                for (; x + VXCPU_LANES <= out->width; x += VXCPU_LANES) {
+                    v_int32x8 va, vb, hi, lo;
+
+                    v_load_expand_s32(&va, a + x);
+                    v_load_expand_s32(&vb, b + x);
+                    v_max(&hi, va, vb);
+                    v_min(&lo, va, vb);
+                    v_pack_store_s16(d + x, hi - lo);
+                }
+                for (; x < out->width; x++)
+                    d[x] = (vx_int16)vxcpu_saturate_s16(abs(a[x] - b[x]));
+            }
+        });
+    } else {
+        return VX_ERROR_INVALID_FORMAT;
+    }
+
+    return VX_SUCCESS;
+}
+
+vx_status vxcpu_arithmetic(const vxcpu_image_t *in1, const vxcpu_image_t *in2, vx_enum policy,
+                                vx_bool subtract, vxcpu_image_t *out)
+{
+    vx_bool saturate = (policy == VX_CONVERT_POLICY_SATURATE) ? vx_true_e : vx_false_e;
+
+    if (!vxcpu_same_size(in1, in2) || !vxcpu_same_size(in1, out))
+        return VX_ERROR_INVALID_PARAMETERS;
+    if ((in1->format != VX_DF_IMAGE_U8 && in1->format != VX_DF_IMAGE_S16) ||
+        (in2->format != VX_DF_IMAGE_U8 && in2->format != VX_DF_IMAGE_S16) ||
+        (out->format != VX_DF_IMAGE_U8 && out->format != VX_DF_IMAGE_S16))
+        return VX_ERROR_INVALID_FORMAT;
+    if (out->format == VX_DF_IMAGE_U8 && (in1->format != VX_DF_IMAGE_U8 || in2->format != VX_DF_IMAGE_U8))
+        return VX_ERROR_INVALID_FORMAT;
+
+    /* the common case stays on 16 lanes of u8 */
+    if (out->format == VX_DF_IMAGE_U8) {
+        vxcpu_parallel_band(out, [=](vx_uint32 y0, vx_uint32 y1) {
+            for (vx_uint32 y = y0; y < y1; y++) {
+                const vx_uint8 *a = vxcpu_row<vx_uint8>(in1, y);
+                const vx_uint8 *b = vxcpu_row<vx_uint8>(in2, y);
+                vx_uint8 *d = vxcpu_row<vx_uint8>(out, y);
+                vx_uint32 x = 0;
+
+                for (; x + VXCPU_LANES_U8 <= out->width; x += VXCPU_LANES_U8) {
+                    v_uint8x16 va = v_load(a + x), vb = v_load(b + x);
+                    if (subtract)
+                        v_store(d + x, saturate ? v_subs(va, vb) : va - vb);
+                    else
+                        v_store(d + x, saturate ? v_adds(va, vb) : va + vb);
+                }
+                for (; x < out->width; x++) {
+                    vx_int32 v = subtract ? a[x] - b[x] : a[x] + b[x];
+                    d[x] = saturate ? (vx_uint8)vxcpu_clamp(v, 0, UINT8_MAX) : (vx_uint8)v;
+                }
+            }
+        });
+        return VX_SUCCESS;
+    }
+
+    vxcpu_parallel_band(out, [=](vx_uint32 y0, vx_uint32 y1) {
+        for (vx_uint32 y = y0; y < y1; y++) {
+            const void *a = vxcpu_row<void>(in1, y);
+            const void *b = vxcpu_row<void>(in2, y);
+            vx_int16 *d = vxcpu_row<vx_int16>(out, y);
+            vx_uint32 x = 0;
+
+            for (; x + VXCPU_LANES <= out->width; x += VXCPU_LANES) {
+                v_int32x8 va, vb, v;
+
+                vxcpu_load_s32(&va, a, in1->format, x);
+                vxcpu_load_s32(&vb, b, in2->format, x);
+                v = subtract ? va - vb : va + vb;
+                if (saturate)
+                    v_pack_store_s16(d + x, v);
+                else
+                    v_trunc_store_s16(d + x, v);
+            }
+            for (; x < out->width; x++) {
+                vx_int32 va = vxcpu_pixel_s32(a, in1->format, x);
+                vx_int32 vb = vxcpu_pixel_s32(b, in2->format, x);
+                vx_int32 v = subtract ? va - vb : va + vb;
+                d[x] = saturate ? (vx_int16)vxcpu_saturate_s16(v) : (vx_int16)v;
+            }
+        }
+    });
+
+    return VX_SUCCESS;
+}
+
+vx_status vxcpu_bitwise(const vxcpu_image_t *in1, const vxcpu_image_t *in2, vx_enum op, vxcpu_image_t *out)
+{
+    if (!vxcpu_same_size(in1, out) || (op != VXCPU_BITWISE_NOT && !vxcpu_same_size(in1, in2)))
+        return VX_ERROR_INVALID_PARAMETERS;
+    if (in1->format != VX_DF_IMAGE_U8 || out->format != VX_DF_IMAGE_U8 ||
+        (op != VXCPU_BITWISE_NOT && in2->format != VX_DF_IMAGE_U8))
+        return VX_ERROR_INVALID_FORMAT;
+    if (op != VXCPU_BITWISE_AND && op != VXCPU_BITWISE_OR && op != VXCPU_BITWISE_XOR && op != VXCPU_BITWISE_NOT)
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    vxcpu_parallel_band(out, [=](vx_uint32 y0, vx_uint32 y1) {
+        for (vx_uint32 y = y0; y < y1; y++) {
+            const vx_uint8 *a = vxcpu_row<vx_uint8>(in1, y);
+            /* NOT: point b at a, it is not used */
+            const vx_uint8 *b = vxcpu_row<vx_uint8>(op == VXCPU_BITWISE_NOT ? in1 : in2, y);
+            vx_uint8 *d = vxcpu_row<vx_uint8>(out, y);
+            vx_uint32 x = 0;
+
+            switch (op) {
+            case VXCPU_BITWISE_AND:
+                for (; x + VXCPU_LANES_U8 <= out->width; x += VXCPU_LANES_U8)
+                    v_store(d + x, v_load(a + x) & v_load(b + x));
+                for (; x < out->width; x++)
+                    d[x] = a[x] & b[x];
+                break;
+            case VXCPU_BITWISE_OR:
+                for (; x + VXCPU_LANES_U8 <= out->width; x += VXCPU_LANES_U8)
+                    v_store(d + x, v_load(a + x) | v_load(b + x));
+                for (; x < out->width; x++)
+                    d[x] = a[x] | b[x];
+                break;
+            case VXCPU_BITWISE_XOR:
+                for (; x + VXCPU_LANES_U8 <= out->width; x += VXCPU_LANES_U8)
+                    v_store(d + x, v_load(a + x) ^ v_load(b + x));
+                for (; x < out->width; x++)
+                    d[x] = a[x] ^ b[x];
+                break;
+            default:
+                for (; x + VXCPU_LANES_U8 <= out->width; x += VXCPU_LANES_U8)
+                    v_store(d + x, ~v_load(a + x));
+                for (; x < out->width; x++)
+                    d[x] = ~a[x];
+                break;
+            }
+        }
+    });
+
+    return VX_SUCCESS;
+}
+
+vx_status vxcpu_threshold(const vxcpu_image_t *in, vx_enum type, vx_int32 value,
+                                vx_int32 lower, vx_int32 upper, vxcpu_image_t *out)
+{
+    vx_int32 lo, hi;
+
+    if (!vxcpu_same_size(in, out))
+        return VX_ERROR_INVALID_PARAMETERS;
+    if (in->format != VX_DF_IMAGE_U8 || out->format != VX_DF_IMAGE_U8)
+        return VX_ERROR_INVALID_FORMAT;
+
+    /* both types as "lo <= v <= hi is true", bounds brought into u8 */
+    if (type == VX_THRESHOLD_TYPE_BINARY) {
+        lo = value + 1;
+        hi = UINT8_MAX;
+    } else if (type == VX_THRESHOLD_TYPE_RANGE) {
+        lo = lower;
+        hi = upper;
+    } else {
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    if (lo > UINT8_MAX || hi < 0 || lo > hi) {
+        lo = 1;     /* nothing is true */
+        hi = 0;
+    } else {
+        lo = vxcpu_clamp(lo, 0, UINT8_MAX);
+        hi = vxcpu_clamp(hi, 0, UINT8_MAX);
+    }
+
+    vxcpu_parallel_band(out, [=](vx_uint32 y0, vx_uint32 y1) {
+        v_uint8x16 vlo = v_setall_u8((vx_uint8)lo);
+        v_uint8x16 vhi = v_setall_u8((vx_uint8)hi);
+
+        for (vx_uint32 y = y0; y < y1; y++) {
+            const vx_uint8 *s = vxcpu_row<vx_uint8>(in, y);
+            vx_uint8 *d = vxcpu_row<vx_uint8>(out, y);
+            vx_uint32 x = 0;
+
+            for (; x + VXCPU_LANES_U8 <= out->width; x += VXCPU_LANES_U8) {
+                v_uint8x16 v = v_load(s + x);
+                v_store(d + x, (v_uint8x16)((v >= vlo) & (v <= vhi)));
+            }
+            for (; x < out->width; x++)
+                d[x] = (s[x] >= lo && s[x] <= hi) ? UINT8_MAX : 0;
+        }
+    });
+
+    return VX_SUCCESS;
+}
+
+vx_status vxcpu_magnitude(const vxcpu_image_t *grad_x, const vxcpu_image_t *grad_y, vxcpu_image_t *mag)
+{
+    if (!vxcpu_same_size(grad_x, grad_y) || !vxcpu_same_size(grad_x, mag))
+        return VX_ERROR_INVALID_PARAMETERS;
+    if (grad_x->format != VX_DF_IMAGE_S16 || grad_y->format != VX_DF_IMAGE_S16 || mag->format != VX_DF_IMAGE_S16)
+        return VX_ERROR_INVALID_FORMAT;
+
+    vxcpu_parallel_band(mag, [=](vx_uint32 y0, vx_uint32 y1) {
+        for (vx_uint32 y = y0; y < y1; y++) {
+            const vx_int16 *gx = vxcpu_row<vx_int16>(grad_x, y);
+            const vx_int16 *gy = vxcpu_row<vx_int16>(grad_y, y);
+            vx_int16 *d = vxcpu_row<vx_int16>(mag, y);
+
+            /*
+             * round(sqrt(x^2 + y^2)), exact in double.  A plain loop, as the
+             * vectors have no sqrt: the compiler vectorizes it with
+             * -fno-math-errno, and it beats a float estimate made exact in
+             * s32, which takes more multiplies than the sqrt it saves.
+             */
+            for (vx_uint32 x = 0; x < mag->width; x++) {
+                vx_float64 fx = gx[x], fy = gy[x];
+                vx_float64 m = sqrt(fx * fx + fy * fy) + 0.5;
+
+                d[x] = (vx_int16)(m < INT16_MAX ? m : INT16_MAX);
+            }
+        }
+    });
+
+    return VX_SUCCESS;
+}
+
+/*
+ * atan2 as a polynomial in min/max of |x| and |y|, ~0.01 degrees, scaled to
+ * the 256 steps of a full turn of the U8 output.
+ */
+#define VXCPU_PHASE_SCALE   (256.0f / 6.2831853071795865f)
+#define VXCPU_ATAN2_P1      (0.9997878412794807f * VXCPU_PHASE_SCALE)
+#define VXCPU_ATAN2_P3      (-0.3258083974640975f * VXCPU_PHASE_SCALE)
+#define VXCPU_ATAN2_P5      (0.1555786518463281f * VXCPU_PHASE_SCALE)
+#define VXCPU_ATAN2_P7      (-0.04432655554792128f * VXCPU_PHASE_SCALE)
+
+/* tail pixels, same as the vector path */
+static inline vx_uint8 vxcpu_phase_pixel(vx_float32 fx, vx_float32 fy)
+{
+    vx_float32 ax = fabsf(fx), ay = fabsf(fy);
+    vx_float32 c = (ax < ay ? ax : ay) / ((ax < ay ? ay : ax) + 1e-10f);
+    vx_float32 c2 = c * c;
+    vx_float32 a = (((VXCPU_ATAN2_P7 * c2 + VXCPU_ATAN2_P5) * c2 + VXCPU_ATAN2_P3) * c2 + VXCPU_ATAN2_P1) * c;
+
+    if (ay > ax)
+        a = 64.0f - a;
+    if (fx < 0.0f)
+        a = 128.0f - a;
+    if (fy < 0.0f)
+        a = 256.0f - a;
+    return (vx_uint8)((vx_int32)(a + 0.5f) & 0xFF);
+}
+
+vx_status vxcpu_phase(const vxcpu_image_t *grad_x, const vxcpu_image_t *grad_y, vxcpu_image_t *orientation)
+{
+    if (!vxcpu_same_size(grad_x, grad_y) || !vxcpu_same_size(grad_x, orientation))
+        return VX_ERROR_INVALID_PARAMETERS;
+    if (grad_x->format != VX_DF_IMAGE_S16 || grad_y->format != VX_DF_IMAGE_S16 ||
+        orientation->format != VX_DF_IMAGE_U8)
+        return VX_ERROR_INVALID_FORMAT;
+
+    vxcpu_parallel_band(orientation, [=](vx_uint32 y0, vx_uint32 y1) {
+        const v_float32x8 zero = {};
+
+        for (vx_uint32 y = y0; y < y1; y++) {
+            const vx_int16 *gx = vxcpu_row<vx_int16>(grad_x, y);
+            const vx_int16 *gy = vxcpu_row<vx_int16>(grad_y, y);
+            vx_uint8 *d = vxcpu_row<vx_uint8>(orientation, y);
+            vx_uint32 x = 0;
+
+            for (; x + VXCPU_LANES <= orientation->width; x += VXCPU_LANES) {
+                v_int32x8 ix, iy;
+                v_float32x8 fx, fy, ax, ay, lo, hi, c, c2, a;
+
+                v_load_expand_s32(&ix, gx + x);
+                v_load_expand_s32(&iy, gy + x);
+                v_cvt_f32(&fx, ix);
+                v_cvt_f32(&fy, iy);
+                v_abs(&ax, fx);
+                v_abs(&ay, fy);
+                v_min(&lo, ax, ay);
+                v_max(&hi, ax, ay);
+                c = lo / (hi + 1e-10f);
+                c2 = c * c;
+                a = (((VXCPU_ATAN2_P7 * c2 + VXCPU_ATAN2_P5) * c2 + VXCPU_ATAN2_P3) * c2 + VXCPU_ATAN2_P1) * c;
+
+                v_select(&a, (v_int32x8)(ay > ax), 64.0f - a, a);
+                v_select(&a, (v_int32x8)(fx < zero), 128.0f - a, a);
+                v_select(&a, (v_int32x8)(fy < zero), 256.0f - a, a);
+                v_trunc(&ix, a + 0.5f);
+                v_trunc_store_u8(d + x, ix);
+            }
+            for (; x < orientation->width; x++)
+                d[x] = vxcpu_phase_pixel(gx[x], gy[x]);
+        }
+    });
+
+    return VX_SUCCESS;
+}
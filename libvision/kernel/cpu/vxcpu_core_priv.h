@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VXCPU_CORE_PRIV_H
+#define VXCPU_CORE_PRIV_H
+
+#include <vector>
+
+#include "vxcpu_core.h"
+#include "vxcpu_parallel.h"
+#include "vxcpu_simd.h"
+
+/* pixels per chunk below which splitting costs more than it gains */
+#define VXCPU_MIN_CHUNK_PIXELS  (16 * 1024)
+
+template <typename T>
+static inline T *vxcpu_row(const vxcpu_image_t *image, vx_int32 y)
+{
+    return (T *)((vx_uint8 *)image->ptr + (ptrdiff_t)(y - (vx_int32)image->start_y) * image->stride);
+}
+
+/* one past the last row held */
+static inline vx_uint32 vxcpu_end_row(const vxcpu_image_t *image)
+{
+    return image->end_y ? image->end_y : image->height;
+}
+
+static inline vx_bool vxcpu_same_size(const vxcpu_image_t *a, const vxcpu_image_t *b)
+{
+    return (a->width == b->width && a->height == b->height) ? vx_true_e : vx_false_e;
+}
+
+static inline vx_int32 vxcpu_clamp(vx_int32 v, vx_int32 lo, vx_int32 hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+/* 8 pixels at x of a row width wide, fewer at the end of it */
+static inline void vxcpu_store_u8(vx_uint8 *row, vx_uint32 x, vx_uint32 width, const v_int32x8 &v)
+{
+    vx_uint8 tmp[VXCPU_LANES];
+
+    if (x + VXCPU_LANES <= width) {
+        v_pack_store_u8(row + x, v);
+    } else {
+        v_pack_store_u8(tmp, v);
+        memcpy(row + x, tmp, width - x);
+    }
+}
+
+static inline void vxcpu_store_s16(vx_int16 *row, vx_uint32 x, vx_uint32 width, const v_int32x8 &v)
+{
+    vx_int16 tmp[VXCPU_LANES];
+
+    if (x + VXCPU_LANES <= width) {
+        v_pack_store_s16(row + x, v);
+    } else {
+        v_pack_store_s16(tmp, v);
+        memcpy(row + x, tmp, (width - x) * sizeof(vx_int16));
+    }
+}
+
+/* body(y_begin, y_end) over the rows of an image width pixels wide */
+static inline void vxcpu_parallel_rows(vx_uint32 height, vx_uint32 width,
+                                            const std::function<void(vx_uint32, vx_uint32)> &body)
+{
+    vx_uint32 grain = VXCPU_MIN_CHUNK_PIXELS / (width ? width : 1);
+
+    vxcpu_parallel_for(height, grain ? grain : 1, body);
+}
+
+/* body(y_begin, y_end) over the rows out holds */
+static inline void vxcpu_parallel_band(const vxcpu_image_t *out,
+                                            const std::function<void(vx_uint32, vx_uint32)> &body)
+{
+    vx_uint32 start = out->start_y;
+
+    vxcpu_parallel_rows(vxcpu_end_row(out) - start, out->width, [&](vx_uint32 y0, vx_uint32 y1) {
+        body(start + y0, start + y1);
+    });
+}
+
+/*
+ * Rows of a U8 image padded by rx pixels left and right, for the rows of a
+ * (2 * ry + 1) high window.  Border pixels come from the border mode; rows
+ * are kept in a ring, so walking down the image fills one row per step.
+ */
+class vxcpu_row_cache {
+public:
+    vxcpu_row_cache(const vxcpu_image_t *image, vx_uint32 rx, vx_uint32 ry, const vx_border_mode_t *border)
+        : m_image(image), m_rx(rx), m_count(2 * ry + 1),
+          m_constant(border->mode == VX_BORDER_MODE_CONSTANT),
+          m_value((vx_uint8)border->constant_value),
+          /* slack so that vector loads may run past the right border */
+          m_pitch(image->width + 2 * rx + VXCPU_LANES_U8),
+          m_buf(m_pitch * m_count), m_rows(m_count, INT32_MIN)
+    {
+    }
+
+    /* pixel (0, y), valid from -rx to width + rx - 1 */
+    const vx_uint8 *row(vx_int32 y)
+    {
+        vx_uint32 slot = (vx_uint32)(y + (vx_int32)m_count * 4096) % m_count;
+        vx_uint8 *dst = &m_buf[slot * m_pitch];
+
+        if (m_rows[slot] != y) {
+            fill(dst, y);
+            m_rows[slot] = y;
+        }
+        return dst + m_rx;
+    }
+
+private:
+    void fill(vx_uint8 *dst, vx_int32 y)
+    {
+        vx_uint32 w = m_image->width;
+        const vx_uint8 *src;
+
+        if (m_constant && (y < 0 || y >= (vx_int32)m_image->height)) {
+            memset(dst, m_value, w + 2 * m_rx);
+            return;
+        }
+
+        src = vxcpu_row<vx_uint8>(m_image, vxcpu_clamp(y, 0, m_image->height - 1));
+        memcpy(dst + m_rx, src, w);
+        memset(dst, m_constant ? m_value : src[0], m_rx);
+        memset(dst + m_rx + w, m_constant ? m_value : src[w - 1], m_rx);
+    }
+
+    const vxcpu_image_t *m_image;
+    vx_uint32 m_rx;
+    vx_uint32 m_count;
+    bool m_constant;
+    vx_uint8 m_value;
+    vx_uint32 m_pitch;
+    std::vector<vx_uint8> m_buf;
+    std::vector<vx_int32> m_rows;
+};
+
+#endif
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mutex>
+
+#include "vxcpu_core_priv.h"
+
+vx_status vxcpu_histogram(const vxcpu_image_t *in, vx_uint32 *bins, vx_size num_bins,
+                                vx_int32 offset, vx_uint32 range)
+{
+    vx_uint32 counts[256] = { 0 };
+    vx_uint32 window;
+    std::mutex lock;
+
+    if (in->format != VX_DF_IMAGE_U8)
+        return VX_ERROR_INVALID_FORMAT;
+    if (num_bins == 0 || range == 0 || range < num_bins)
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    /* count every value, bins come out of the 256 counts */
+    vxcpu_parallel_rows(in->height, in->width, [&](vx_uint32 y0, vx_uint32 y1) {
+        /* four sets, so that runs of one value do not serialize on a counter */
+        vx_uint32 local[4][256];
+
+        memset(local, 0, sizeof(local));
+        for (vx_uint32 y = y0; y < y1; y++) {
+            const vx_uint8 *s = vxcpu_row<vx_uint8>(in, y);
+            vx_uint32 x = 0;
+
+            for (; x + 4 <= in->width; x += 4) {
+                local[0][s[x]]++;
+                local[1][s[x + 1]]++;
+                local[2][s[x + 2]]++;
+                local[3][s[x + 3]]++;
+            }
+            for (; x < in->width; x++)
+                local[0][s[x]]++;
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        for (vx_uint32 v = 0; v < 256; v++)
+            counts[v] += local[0][v] + local[1][v] + local[2][v] + local[3][v];
+    });
+
+    window = range / (vx_uint32)num_bins;
+    memset(bins, 0, num_bins * sizeof(vx_uint32));
+    for (vx_int32 v = 0; v < 256; v++) {
+        vx_uint32 index;
+
+        if (v < offset || (vx_int64)v >= (vx_int64)offset + range)
+            continue;
+        index = (vx_uint32)(v - offset) / window;
+        if (index < num_bins)
+            bins[index] += counts[v];
+    }
+
+    return VX_SUCCESS;
+}
+
+/* dst[x] += add[x] over a row */
+static void vxcpu_add_row_u32(vx_uint32 *dst, const vx_uint32 *add, vx_uint32 width)
+{
+    vx_uint32 x = 0;
+
+    for (; x + VXCPU_LANES <= width; x += VXCPU_LANES) {
+        v_uint32x8 a, b;
+
+        v_load(&a, dst + x);
+        v_load(&b, add + x);
+        v_store(dst + x, a + b);
+    }
+    for (; x < width; x++)
+        dst[x] += add[x];
+}
+
+vx_status vxcpu_integral_image(const vxcpu_image_t *in, vxcpu_image_t *out)
+{
+    vx_uint32 bands, band_rows;
+
+    if (!vxcpu_same_size(in, out))
+        return VX_ERROR_INVALID_PARAMETERS;
+    if (in->format != VX_DF_IMAGE_U8 || out->format != VX_DF_IMAGE_U32)
+        return VX_ERROR_INVALID_FORMAT;
+    if (in->height == 0 || in->width == 0)
+        return VX_SUCCESS;
+
+    /*
+     * Each band of rows is summed as if it were the top of the image, then
+     * the bottom rows of the bands are chained, then every other row of a
+     * band gets the bottom row of the band above added.
+     */
+    bands = vxcpu_parallel_threads() * 2;
+    band_rows = (in->height + bands - 1) / bands;
+    if (band_rows < 8)
+        band_rows = 8;
+    bands = (in->height + band_rows - 1) / band_rows;
+
+    vxcpu_parallel_for(bands, 1, [=](vx_uint32 b0, vx_uint32 b1) {
+        for (vx_uint32 b = b0; b < b1; b++) {
+            vx_uint32 y_end = (b + 1) * band_rows < in->height ? (b + 1) * band_rows : in->height;
+
+            for (vx_uint32 y = b * band_rows; y < y_end; y++) {
+                const vx_uint8 *s = vxcpu_row<vx_uint8>(in, y);
+                vx_uint32 *d = vxcpu_row<vx_uint32>(out, y);
+                vx_uint32 sum = 0;
+
+                for (vx_uint32 x = 0; x < in->width; x++) {
+                    sum += s[x];
+                    d[x] = sum;
+                }
+                if (y != b * band_rows)
+                    vxcpu_add_row_u32(d, vxcpu_row<vx_uint32>(out, y - 1), in->width);
+            }
+        }
+    });
+
+    for (vx_uint32 b = 1; b < bands; b++) {
+        vx_uint32 last = (b + 1) * band_rows < in->height ? (b + 1) * band_rows - 1 : in->height - 1;
+
+        vxcpu_add_row_u32(vxcpu_row<vx_uint32>(out, last),
+                            vxcpu_row<vx_uint32>(out, b * band_rows - 1), in->width);
+    }
+
+    vxcpu_parallel_for(bands, 1, [=](vx_uint32 b0, vx_uint32 b1) {
+        for (vx_uint32 b = (b0 ? b0 : 1); b < b1; b++) {
+            vx_uint32 last = (b + 1) * band_rows < in->height ? (b + 1) * band_rows - 1 : in->height - 1;
+            const vx_uint32 *above = vxcpu_row<vx_uint32>(out, b * band_rows - 1);
+
+            for (vx_uint32 y = b * band_rows; y < last; y++)
+                vxcpu_add_row_u32(vxcpu_row<vx_uint32>(out, y), above, in->width);
+        }
+    });
+
+    return VX_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <VX/vx.h>
+#include <VX/vx_api.h>
+#include <VX/vx_helper.h>
+
+#include "vxcpu_kernel_module.h"
+#include "vxcpu_parallel.h"
+
+static vx_kernel_description_t *cpu_kernels[] = {
+    &absdiff_cpu_kernel,
+    &add_cpu_kernel,
+    &subtract_cpu_kernel,
+    &and_cpu_kernel,
+    &or_cpu_kernel,
+    &xor_cpu_kernel,
+    &not_cpu_kernel,
+    &convolution_cpu_kernel,
+    &box3x3_cpu_kernel,
+    &gaussian3x3_cpu_kernel,
+    &median3x3_cpu_kernel,
+    &sobel3x3_cpu_kernel,
+    &magnitude_cpu_kernel,
+    &phase_cpu_kernel,
+    &threshold_cpu_kernel,
+    &histogram_cpu_kernel,
+    &integralimage_cpu_kernel,
+    &scaleimage_cpu_kernel,
+    &warp_affine_cpu_kernel,
+    &warp_perspective_cpu_kernel,
+    &pyramid_cpu_kernel,
+    &optpyrlk_cpu_kernel
+};
+
+static vxcpu_band_description_t *cpu_bands[] = {
+    &absdiff_cpu_band,
+    &add_cpu_band,
+    &subtract_cpu_band,
+    &and_cpu_band,
+    &or_cpu_band,
+    &xor_cpu_band,
+    &not_cpu_band,
+    &convolution_cpu_band,
+    &box3x3_cpu_band,
+    &gaussian3x3_cpu_band,
+    &median3x3_cpu_band,
+    &sobel3x3_cpu_band,
+    &magnitude_cpu_band,
+    &phase_cpu_band,
+    &threshold_cpu_band
+};
+
+/* the band entry has to be set before the kernel is finalized */
+static vx_status vxcpuSetBandFunction(vx_kernel kernel, vx_enum enumeration)
+{
+    vx_status status = VX_SUCCESS;
+
+    for (vx_uint32 b = 0; b < dimof(cpu_bands); b++) {
+        if (cpu_bands[b]->enumeration != enumeration)
+            continue;
+
+        status |= vxSetKernelAttribute(kernel, VX_KERNEL_ATTRIBUTE_BAND_FUNCTION,
+                                        &cpu_bands[b]->function, sizeof(cpu_bands[b]->function));
+        status |= vxSetKernelAttribute(kernel, VX_KERNEL_ATTRIBUTE_BAND_RADIUS,
+                                        &cpu_bands[b]->radius, sizeof(cpu_bands[b]->radius));
+        break;
+    }
+
+    return status;
+}
+
+VX_API_ENTRY vx_status VX_API_CALL vxModuleInitializer(vx_context context)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status;
+
+    /* one worker per online core */
+    status = vxcpu_parallel_init(0);
+    if (status != VX_SUCCESS)
+        VXLOGE("creating worker pool fails, err:%d, context:%p", status, context);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+VX_API_ENTRY vx_status VX_API_CALL vxModuleDeinitializer(void)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vxcpu_parallel_deinit();
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return VX_SUCCESS;
+}
+
+VX_API_ENTRY vx_status VX_API_CALL vxPublishKernels(vx_context context)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = VX_SUCCESS;
+
+    vx_uint32 num_cpu_kernels = dimof(cpu_kernels);
+
+    for (vx_uint32 k = 0; k < num_cpu_kernels; k++)
+    {
+        vx_kernel kernel = vxAddKernel(context,
+                             cpu_kernels[k]->name,
+                             cpu_kernels[k]->enumeration,
+                             cpu_kernels[k]->function,
+                             cpu_kernels[k]->numParams,
+                             cpu_kernels[k]->input_validate,
+                             cpu_kernels[k]->output_validate,
+                             cpu_kernels[k]->initialize,
+                             cpu_kernels[k]->deinitialize);
+
+        if (kernel)
+        {
+            vx_uint32 num_kernel_params = cpu_kernels[k]->numParams;
+            vx_param_description_t *parameters  = cpu_kernels[k]->parameters;
+
+            for (vx_uint32 p = 0; p < num_kernel_params; p++)
+            {
+                status = vxAddParameterToKernel(kernel, p, parameters[p].direction, parameters[p].data_type, parameters[p].state);
+                if (status != VX_SUCCESS) {
+                    VXLOGE("%s: add parameter to kernel fail(%d)", cpu_kernels[k]->name, status);
+                }
+            }
+
+            /* without it the kernel still runs, only never fused */
+            if (vxcpuSetBandFunction(kernel, cpu_kernels[k]->enumeration) != VX_SUCCESS)
+                VXLOGE("%s: setting band function fail", cpu_kernels[k]->name);
+
+            status = vxFinalizeKernel(kernel);
+            if (status != VX_SUCCESS) {
+                VXLOGE("%s: finalize kernel fail(%d)", cpu_kernels[k]->name, status);
+            }
+        } else {
+            VXLOGE("%s: add kernel fail", cpu_kernels[k]->name);
+        }
+    }
+
+    /* the module is unloaded without its deinitializer when publishing fails */
+    if (status != VX_SUCCESS)
+        vxcpu_parallel_deinit();
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
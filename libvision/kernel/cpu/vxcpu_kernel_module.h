@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VXCPU_KERNEL_MODULE_H
+#define VXCPU_KERNEL_MODULE_H
+
+#include "vxcpu_kernel_util.h"
+
+/* OpenVX primitive kernels */
+extern vx_kernel_description_t absdiff_cpu_kernel;
+extern vx_kernel_description_t add_cpu_kernel;
+extern vx_kernel_description_t subtract_cpu_kernel;
+extern vx_kernel_description_t and_cpu_kernel;
+extern vx_kernel_description_t or_cpu_kernel;
+extern vx_kernel_description_t xor_cpu_kernel;
+extern vx_kernel_description_t not_cpu_kernel;
+extern vx_kernel_description_t convolution_cpu_kernel;
+extern vx_kernel_description_t box3x3_cpu_kernel;
+extern vx_kernel_description_t gaussian3x3_cpu_kernel;
+extern vx_kernel_description_t median3x3_cpu_kernel;
+extern vx_kernel_description_t sobel3x3_cpu_kernel;
+extern vx_kernel_description_t magnitude_cpu_kernel;
+extern vx_kernel_description_t phase_cpu_kernel;
+extern vx_kernel_description_t threshold_cpu_kernel;
+extern vx_kernel_description_t histogram_cpu_kernel;
+extern vx_kernel_description_t integralimage_cpu_kernel;
+extern vx_kernel_description_t scaleimage_cpu_kernel;
+extern vx_kernel_description_t warp_affine_cpu_kernel;
+extern vx_kernel_description_t warp_perspective_cpu_kernel;
+extern vx_kernel_description_t pyramid_cpu_kernel;
+extern vx_kernel_description_t optpyrlk_cpu_kernel;
+
+/* row band entry of a kernel, the graph may run it fused with its neighbors */
+struct vxcpu_band_description_t {
+    vx_enum enumeration;
+    vx_kernel_band_f function;
+    /* input rows read above and below an output row */
+    vx_uint32 radius;
+};
+
+extern vxcpu_band_description_t absdiff_cpu_band;
+extern vxcpu_band_description_t add_cpu_band;
+extern vxcpu_band_description_t subtract_cpu_band;
+extern vxcpu_band_description_t and_cpu_band;
+extern vxcpu_band_description_t or_cpu_band;
+extern vxcpu_band_description_t xor_cpu_band;
+extern vxcpu_band_description_t not_cpu_band;
+extern vxcpu_band_description_t convolution_cpu_band;
+extern vxcpu_band_description_t box3x3_cpu_band;
+extern vxcpu_band_description_t gaussian3x3_cpu_band;
+extern vxcpu_band_description_t median3x3_cpu_band;
+extern vxcpu_band_description_t sobel3x3_cpu_band;
+extern vxcpu_band_description_t magnitude_cpu_band;
+extern vxcpu_band_description_t phase_cpu_band;
+extern vxcpu_band_description_t threshold_cpu_band;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+VX_API_ENTRY vx_status VX_API_CALL vxModuleInitializer(vx_context context);
+VX_API_ENTRY vx_status VX_API_CALL vxModuleDeinitializer(void);
+VX_API_ENTRY vx_status VX_API_CALL vxPublishKernels(vx_context context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelUtil"
+#include <cutils/log.h>
+
+#include <string.h>
+
+#include "vxcpu_kernel_util.h"
+
+static vx_uint32 vxcpuPixelSize(vx_df_image format)
+{
+    switch (format) {
+    case VX_DF_IMAGE_U8:
+        return sizeof(vx_uint8);
+    case VX_DF_IMAGE_S16:
+        return sizeof(vx_int16);
+    case VX_DF_IMAGE_U32:
+        return sizeof(vx_uint32);
+    default:
+        return 0;
+    }
+}
+
+vx_status vxcpuAccessImage(vx_image image, vx_enum usage, vxcpu_image_access_t *access)
+{
+    vx_status status = VX_SUCCESS;
+    vx_df_image format = VX_DF_IMAGE_VIRT;
+
+    memset(access, 0x0, sizeof(*access));
+    access->image = image;
+
+    status |= vxQueryImage(image, VX_IMAGE_ATTRIBUTE_WIDTH, &access->rect.end_x, sizeof(access->rect.end_x));
+    status |= vxQueryImage(image, VX_IMAGE_ATTRIBUTE_HEIGHT, &access->rect.end_y, sizeof(access->rect.end_y));
+    status |= vxQueryImage(image, VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format));
+    if (status != VX_SUCCESS) {
+        VXLOGE("querying image fails, err:%d", status);
+        goto EXIT;
+    }
+
+    /* a NULL pointer asks for the image's own memory, no copy */
+    status = vxAccessImagePatch(image, &access->rect, 0, &access->addr, &access->base, usage);
+    if (status != VX_SUCCESS) {
+        VXLOGE("accessing image fails, err:%d", status);
+        goto EXIT;
+    }
+
+    access->plane.ptr = access->base;
+    access->plane.stride = access->addr.stride_y;
+    access->plane.width = access->addr.dim_x;
+    access->plane.height = access->addr.dim_y;
+    access->plane.format = format;
+
+    if ((vx_uint32)access->addr.stride_x != vxcpuPixelSize(format)) {
+        VXLOGE("image is not supported, format:0x%x, stride_x:%d", format, access->addr.stride_x);
+        vxCommitImagePatch(image, &access->rect, 0, &access->addr, access->base);
+        access->base = NULL;
+        status = VX_ERROR_NOT_SUPPORTED;
+    }
+
+EXIT:
+    return status;
+}
+
+vx_status vxcpuCommitImage(vxcpu_image_access_t *access)
+{
+    vx_status status;
+
+    if (access->base == NULL)
+        return VX_SUCCESS;
+
+    status = vxCommitImagePatch(access->image, &access->rect, 0, &access->addr, access->base);
+    if (status != VX_SUCCESS)
+        VXLOGE("committing image fails, err:%d", status);
+    access->base = NULL;
+
+    return status;
+}
+
+void vxcpuBandImage(const vx_image_band_t *band, vxcpu_image_t *plane)
+{
+    plane->ptr = band->ptr;
+    plane->stride = band->stride_y;
+    plane->width = band->width;
+    plane->height = band->height;
+    plane->format = band->format;
+    plane->start_y = band->start_y;
+    plane->end_y = band->end_y;
+}
+
+void vxcpuQueryBorder(vx_node node, vx_border_mode_t *border)
+{
+    border->mode = VX_BORDER_MODE_UNDEFINED;
+    border->constant_value = 0;
+
+    if (vxQueryNode(node, VX_NODE_ATTRIBUTE_BORDER_MODE, border, sizeof(*border)) != VX_SUCCESS) {
+        border->mode = VX_BORDER_MODE_UNDEFINED;
+        border->constant_value = 0;
+    }
+}
+
+vx_status vxcpuQueryImageParam(vx_node node, vx_uint32 index, vx_uint32 *width, vx_uint32 *height,
+                                    vx_df_image *format)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_parameter param = vxGetParameterByIndex(node, index);
+    vx_image image = 0;
+
+    if (param == NULL)
+        return status;
+
+    vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &image, sizeof(image));
+    if (image) {
+        status = VX_SUCCESS;
+        if (width)
+            status |= vxQueryImage(image, VX_IMAGE_ATTRIBUTE_WIDTH, width, sizeof(*width));
+        if (height)
+            status |= vxQueryImage(image, VX_IMAGE_ATTRIBUTE_HEIGHT, height, sizeof(*height));
+        if (format)
+            status |= vxQueryImage(image, VX_IMAGE_ATTRIBUTE_FORMAT, format, sizeof(*format));
+        vxReleaseImage(&image);
+    }
+    vxReleaseParameter(&param);
+
+    return status;
+}
+
+vx_status vxcpuQueryScalarParam(vx_node node, vx_uint32 index, vx_enum *type)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_parameter param = vxGetParameterByIndex(node, index);
+    vx_scalar scalar = 0;
+
+    if (param == NULL)
+        return status;
+
+    vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &scalar, sizeof(scalar));
+    if (scalar) {
+        status = vxQueryScalar(scalar, VX_SCALAR_ATTRIBUTE_TYPE, type, sizeof(*type));
+        vxReleaseScalar(&scalar);
+    }
+    vxReleaseParameter(&param);
+
+    return status;
+}
+
+vx_status vxcpuCheckInterpolationParam(vx_node node, vx_uint32 index, vx_bool allow_area)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_parameter param = vxGetParameterByIndex(node, index);
+    vx_scalar scalar = 0;
+
+    if (param == NULL)
+        return status;
+
+    vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &scalar, sizeof(scalar));
+    if (scalar) {
+        vx_enum type = 0;
+        vx_enum interp = 0;
+
+        vxQueryScalar(scalar, VX_SCALAR_ATTRIBUTE_TYPE, &type, sizeof(type));
+        if (type == VX_TYPE_ENUM) {
+            vxReadScalarValue(scalar, &interp);
+            if ((interp == VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR) ||
+                (interp == VX_INTERPOLATION_TYPE_BILINEAR) ||
+                (allow_area && (interp == VX_INTERPOLATION_TYPE_AREA)))
+                status = VX_SUCCESS;
+            else
+                status = VX_ERROR_INVALID_VALUE;
+        } else {
+            status = VX_ERROR_INVALID_TYPE;
+        }
+        vxReleaseScalar(&scalar);
+    }
+    vxReleaseParameter(&param);
+
+    return status;
+}
+
+vx_status vxcpuCheckSameImageParam(vx_node node, vx_uint32 index0, vx_uint32 index1, vx_bool same_format)
+{
+    vx_status status = VX_SUCCESS;
+    vx_uint32 width[2], height[2];
+    vx_df_image format[2];
+
+    status |= vxcpuQueryImageParam(node, index0, &width[0], &height[0], &format[0]);
+    status |= vxcpuQueryImageParam(node, index1, &width[1], &height[1], &format[1]);
+    if (status != VX_SUCCESS)
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    if ((width[0] != width[1]) || (height[0] != height[1])) {
+        VXLOGE("size is not matched, %ux%u != %ux%u", width[0], height[0], width[1], height[1]);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+    if (same_format && (format[0] != format[1])) {
+        VXLOGE("format is not matched, 0x%x != 0x%x", format[0], format[1]);
+        return VX_ERROR_INVALID_FORMAT;
+    }
+
+    return VX_SUCCESS;
+}
+
+vx_status vxcpuSetMetaImage(vx_meta_format meta, vx_uint32 width, vx_uint32 height, vx_df_image format)
+{
+    vx_status status = VX_SUCCESS;
+
+    status |= vxSetMetaFormatAttribute(meta, VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format));
+    status |= vxSetMetaFormatAttribute(meta, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width));
+    status |= vxSetMetaFormatAttribute(meta, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height));
+
+    return status;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VXCPU_KERNEL_UTIL_H
+#define VXCPU_KERNEL_UTIL_H
+
+#include <VX/vx.h>
+#include <VX/vx_helper.h>
+
+#include <ExynosVisionCommonConfig.h>
+
+#include "vxcpu_core.h"
+
+//#define EXYNOS_CPU_KERNEL_IF_TRACE
+#ifdef EXYNOS_CPU_KERNEL_IF_TRACE
+#define EXYNOS_CPU_KERNEL_IF_IN()   VXLOGD("IN...")
+#define EXYNOS_CPU_KERNEL_IF_OUT()  VXLOGD("OUT..")
+#else
+#define EXYNOS_CPU_KERNEL_IF_IN()   ((void *)0)
+#define EXYNOS_CPU_KERNEL_IF_OUT()  ((void *)0)
+#endif
+
+/* Whole image mapped for a kernel function, see vxcpuAccessImage(). */
+struct vxcpu_image_access_t {
+    vx_image image;
+    vx_rectangle_t rect;
+    vx_imagepatch_addressing_t addr;
+    void *base;
+    vxcpu_image_t plane;
+};
+
+/* Maps plane 0 of the image, rows must be packed pixels. */
+vx_status vxcpuAccessImage(vx_image image, vx_enum usage, vxcpu_image_access_t *access);
+vx_status vxcpuCommitImage(vxcpu_image_access_t *access);
+
+/* plane of a band handed to a band entry, see vx_kernel_band_f */
+void vxcpuBandImage(const vx_image_band_t *band, vxcpu_image_t *plane);
+
+/* border of the node, UNDEFINED when the node has none */
+void vxcpuQueryBorder(vx_node node, vx_border_mode_t *border);
+
+/* validator helpers, the parameter at index must be set */
+vx_status vxcpuQueryImageParam(vx_node node, vx_uint32 index, vx_uint32 *width, vx_uint32 *height,
+                                    vx_df_image *format);
+vx_status vxcpuQueryScalarParam(vx_node node, vx_uint32 index, vx_enum *type);
+/* enum scalar of NEAREST_NEIGHBOR or BILINEAR, or AREA if allowed */
+vx_status vxcpuCheckInterpolationParam(vx_node node, vx_uint32 index, vx_bool allow_area);
+/* images at both indexes have the same size, and the same format if asked */
+vx_status vxcpuCheckSameImageParam(vx_node node, vx_uint32 index0, vx_uint32 index1, vx_bool same_format);
+vx_status vxcpuSetMetaImage(vx_meta_format meta, vx_uint32 width, vx_uint32 height, vx_df_image format);
+
+#endif
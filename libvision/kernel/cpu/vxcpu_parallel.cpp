@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "vxcpu_parallel.h"
+
+/* more chunks than threads, so a slow core does not hold up the call */
+#define VXCPU_CHUNKS_PER_THREAD (4)
+
+struct vxcpu_job {
+    const std::function<void(vx_uint32, vx_uint32)> *body;
+    vx_uint32 count;
+    vx_uint32 chunk_size;
+    vx_uint32 chunks;
+    vx_uint32 next;     /* first unclaimed chunk */
+    vx_uint32 done;     /* finished chunks */
+};
+
+static std::mutex g_lock;
+static std::condition_variable g_work_cond;
+static std::condition_variable g_done_cond;
+static std::list<vxcpu_job*> g_jobs;
+static std::vector<std::thread> g_workers;
+static vx_uint32 g_threads;
+static vx_uint32 g_users;
+static bool g_exit;
+
+/* Claims a chunk of the oldest job with one left. g_lock held. */
+static vxcpu_job *claimChunk(vx_uint32 *chunk)
+{
+    while (!g_jobs.empty()) {
+        vxcpu_job *job = g_jobs.front();
+        if (job->next < job->chunks) {
+            *chunk = job->next++;
+            if (job->next == job->chunks)
+                g_jobs.pop_front();
+            return job;
+        }
+        g_jobs.pop_front();
+    }
+
+    return NULL;
+}
+
+/* Runs a claimed chunk. Takes and gives back the lock. */
+static void runChunk(std::unique_lock<std::mutex> &lock, vxcpu_job *job, vx_uint32 chunk)
+{
+    vx_uint32 begin = chunk * job->chunk_size;
+    vx_uint32 end = begin + job->chunk_size;
+
+    if (end > job->count)
+        end = job->count;
+
+    lock.unlock();
+    (*job->body)(begin, end);
+    lock.lock();
+
+    if (++job->done == job->chunks)
+        g_done_cond.notify_all();
+}
+
+static void workerMain(void)
+{
+    std::unique_lock<std::mutex> lock(g_lock);
+
+    while (true) {
+        vxcpu_job *job;
+        vx_uint32 chunk;
+
+        g_work_cond.wait(lock, [] { return g_exit || !g_jobs.empty(); });
+        if (g_exit)
+            break;
+
+        job = claimChunk(&chunk);
+        if (job)
+            runChunk(lock, job, chunk);
+    }
+}
+
+vx_status vxcpu_parallel_init(vx_uint32 threads)
+{
+    std::lock_guard<std::mutex> lock(g_lock);
+
+    if (g_users++ > 0)
+        return VX_SUCCESS;
+
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? (vx_uint32)cpus : 1;
+    }
+
+    g_exit = false;
+    g_threads = threads;
+    /* the calling thread is one of them */
+    for (vx_uint32 i = 1; i < threads; i++)
+        g_workers.push_back(std::thread(workerMain));
+
+    return VX_SUCCESS;
+}
+
+void vxcpu_parallel_deinit(void)
+{
+    std::vector<std::thread> workers;
+
+    {
+        std::lock_guard<std::mutex> lock(g_lock);
+
+        if (g_users == 0 || --g_users > 0)
+            return;
+
+        g_exit = true;
+        g_threads = 0;
+        workers.swap(g_workers);
+        g_work_cond.notify_all();
+    }
+
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+vx_uint32 vxcpu_parallel_threads(void)
+{
+    std::lock_guard<std::mutex> lock(g_lock);
+
+    return g_threads ? g_threads : 1;
+}
+
+void vxcpu_parallel_for(vx_uint32 count, vx_uint32 grain,
+                            const std::function<void(vx_uint32 begin, vx_uint32 end)> &body)
+{
+    std::unique_lock<std::mutex> lock(g_lock);
+    vx_uint32 max_chunks = g_threads * VXCPU_CHUNKS_PER_THREAD;
+    vxcpu_job job;
+
+    if (count == 0)
+        return;
+    if (grain == 0)
+        grain = 1;
+
+    job.body = &body;
+    job.count = count;
+    job.chunks = (count + grain - 1) / grain;
+    if (job.chunks > max_chunks)
+        job.chunks = max_chunks;
+
+    if (g_threads <= 1 || job.chunks <= 1) {
+        lock.unlock();
+        body(0, count);
+        return;
+    }
+
+    job.chunk_size = (count + job.chunks - 1) / job.chunks;
+    job.chunks = (count + job.chunk_size - 1) / job.chunk_size;
+    job.next = 0;
+    job.done = 0;
+
+    g_jobs.push_back(&job);
+    g_work_cond.notify_all();
+
+    /* work on our own chunks until all are claimed, then wait for the rest */
+    while (job.next < job.chunks) {
+        vx_uint32 chunk = job.next++;
+        if (job.next == job.chunks)
+            g_jobs.remove(&job);
+        runChunk(lock, &job, chunk);
+    }
+
+    g_done_cond.wait(lock, [&job] { return job.done == job.chunks; });
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VXCPU_PARALLEL_H
+#define VXCPU_PARALLEL_H
+
+#include <functional>
+
+#include <VX/vx.h>
+
+/*
+ * Worker pool of the cpu target.
+ *
+ * vxcpu_parallel_for() splits [0, count) into chunks of at least grain items
+ * and runs them on the pool; the caller works on chunks too and returns when
+ * all of them are done.  Calls from several nodes at once are fine, chunks of
+ * every call are served in order.  Without a pool, or with one thread, the
+ * body runs inline.
+ */
+
+/* threads == 0: one per online cpu */
+vx_status vxcpu_parallel_init(vx_uint32 threads);
+void vxcpu_parallel_deinit(void);
+vx_uint32 vxcpu_parallel_threads(void);
+
+void vxcpu_parallel_for(vx_uint32 count, vx_uint32 grain,
+                            const std::function<void(vx_uint32 begin, vx_uint32 end)> &body);
+
+#endif
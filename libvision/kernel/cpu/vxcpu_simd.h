@@ -0,0 +1,307 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VXCPU_SIMD_H
+#define VXCPU_SIMD_H
+
+#include <string.h>
+#include <math.h>
+
+#include <VX/vx.h>
+
+/*
+ * Portable SIMD layer of the cpu target.
+ *
+ * The vectors are GCC/clang generic vectors, so one source builds to NEON on
+ * arm/arm64 and to SSE on x86 without intrinsics.  A 16 byte vector holds 16
+ * u8 or 8 s16 lanes; arithmetic that needs headroom is done on 8 lanes of
+ * 32 bit, which the compiler splits over two registers.
+ *
+ * Loads and stores go through memcpy() and have no alignment requirement.
+ * Comparisons give all-ones/all-zeros lanes of the same width, used as masks
+ * by v_select().
+ *
+ * The 32 byte vectors never cross a function boundary by value, not even an
+ * inline one: the x86 ABI passes them differently with and without AVX, and
+ * GCC warns (-Wpsabi) for every such function. Their helpers take const
+ * references and give their result through the first argument.
+ */
+
+#define VXCPU_LANES_U8      (16)
+#define VXCPU_LANES         (8)
+
+typedef vx_uint8    v_uint8x16  __attribute__((vector_size(16)));
+typedef vx_int8     v_int8x16   __attribute__((vector_size(16)));
+typedef vx_uint8    v_uint8x8   __attribute__((vector_size(8)));
+typedef vx_int16    v_int16x8   __attribute__((vector_size(16)));
+typedef vx_uint16   v_uint16x8  __attribute__((vector_size(16)));
+typedef vx_int32    v_int32x8   __attribute__((vector_size(32)));
+typedef vx_uint32   v_uint32x8  __attribute__((vector_size(32)));
+typedef vx_float32  v_float32x8 __attribute__((vector_size(32)));
+
+/* loads and stores */
+
+static inline v_uint8x16 v_load(const vx_uint8 *p)
+{
+    v_uint8x16 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline v_int16x8 v_load(const vx_int16 *p)
+{
+    v_int16x8 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void v_load(v_uint32x8 *v, const vx_uint32 *p)
+{
+    memcpy(v, p, sizeof(*v));
+}
+
+static inline void v_store(vx_uint8 *p, v_uint8x16 v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline void v_store(vx_int16 *p, v_int16x8 v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline void v_store(vx_uint32 *p, const v_uint32x8 &v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+/* 8 pixels, widened */
+static inline v_int16x8 v_load_expand_s16(const vx_uint8 *p)
+{
+    v_uint8x8 v;
+    memcpy(&v, p, sizeof(v));
+    return __builtin_convertvector(v, v_int16x8);
+}
+
+static inline void v_load_expand_s32(v_int32x8 *v, const vx_uint8 *p)
+{
+    v_uint8x8 u;
+    memcpy(&u, p, sizeof(u));
+    *v = __builtin_convertvector(u, v_int32x8);
+}
+
+static inline void v_load_expand_s32(v_int32x8 *v, const vx_int16 *p)
+{
+    *v = __builtin_convertvector(v_load(p), v_int32x8);
+}
+
+/* broadcasts */
+
+static inline v_uint8x16 v_setall_u8(vx_uint8 x)
+{
+    v_uint8x16 v = {};
+    return v + x;
+}
+
+static inline v_int16x8 v_setall_s16(vx_int16 x)
+{
+    v_int16x8 v = {};
+    return v + x;
+}
+
+static inline void v_setall_s32(v_int32x8 *v, vx_int32 x)
+{
+    v_int32x8 z = {};
+    *v = z + x;
+}
+
+static inline void v_setall_u32(v_uint32x8 *v, vx_uint32 x)
+{
+    v_uint32x8 z = {};
+    *v = z + x;
+}
+
+static inline void v_setall_f32(v_float32x8 *v, vx_float32 x)
+{
+    v_float32x8 z = {};
+    *v = z + x;
+}
+
+/* mask ? a : b, mask lanes all-ones or all-zeros */
+
+static inline v_uint8x16 v_select(v_int8x16 mask, v_uint8x16 a, v_uint8x16 b)
+{
+    v_uint8x16 m = (v_uint8x16)mask;
+    return (a & m) | (b & ~m);
+}
+
+static inline v_int16x8 v_select(v_int16x8 mask, v_int16x8 a, v_int16x8 b)
+{
+    return (a & mask) | (b & ~mask);
+}
+
+/* r may be a or b */
+static inline void v_select(v_int32x8 *r, const v_int32x8 &mask, const v_int32x8 &a, const v_int32x8 &b)
+{
+    *r = (a & mask) | (b & ~mask);
+}
+
+static inline void v_select(v_uint32x8 *r, const v_int32x8 &mask, const v_uint32x8 &a, const v_uint32x8 &b)
+{
+    *r = (a & (v_uint32x8)mask) | (b & ~(v_uint32x8)mask);
+}
+
+static inline void v_select(v_float32x8 *r, const v_int32x8 &mask, const v_float32x8 &a, const v_float32x8 &b)
+{
+    *r = (v_float32x8)(((v_int32x8)a & mask) | ((v_int32x8)b & ~mask));
+}
+
+/* min / max */
+
+static inline v_uint8x16 v_min(v_uint8x16 a, v_uint8x16 b)
+{
+    return v_select((v_int8x16)(a < b), a, b);
+}
+
+static inline v_uint8x16 v_max(v_uint8x16 a, v_uint8x16 b)
+{
+    return v_select((v_int8x16)(a > b), a, b);
+}
+
+static inline v_int16x8 v_min(v_int16x8 a, v_int16x8 b)
+{
+    return v_select((v_int16x8)(a < b), a, b);
+}
+
+static inline v_int16x8 v_max(v_int16x8 a, v_int16x8 b)
+{
+    return v_select((v_int16x8)(a > b), a, b);
+}
+
+static inline void v_min(v_int32x8 *r, const v_int32x8 &a, const v_int32x8 &b)
+{
+    v_select(r, (v_int32x8)(a < b), a, b);
+}
+
+static inline void v_max(v_int32x8 *r, const v_int32x8 &a, const v_int32x8 &b)
+{
+    v_select(r, (v_int32x8)(a > b), a, b);
+}
+
+static inline void v_min(v_float32x8 *r, const v_float32x8 &a, const v_float32x8 &b)
+{
+    v_select(r, (v_int32x8)(a < b), a, b);
+}
+
+static inline void v_max(v_float32x8 *r, const v_float32x8 &a, const v_float32x8 &b)
+{
+    v_select(r, (v_int32x8)(a > b), a, b);
+}
+
+static inline void v_clamp(v_int32x8 *r, const v_int32x8 &v, vx_int32 lo, vx_int32 hi)
+{
+    v_int32x8 vlo, vhi;
+
+    v_setall_s32(&vlo, lo);
+    v_setall_s32(&vhi, hi);
+    v_max(r, v, vlo);
+    v_min(r, *r, vhi);
+}
+
+/* u8 arithmetic */
+
+static inline v_uint8x16 v_adds(v_uint8x16 a, v_uint8x16 b)
+{
+    return a + v_min(b, ~a);
+}
+
+static inline v_uint8x16 v_subs(v_uint8x16 a, v_uint8x16 b)
+{
+    return v_max(a, b) - b;
+}
+
+static inline v_uint8x16 v_absdiff(v_uint8x16 a, v_uint8x16 b)
+{
+    return v_max(a, b) - v_min(a, b);
+}
+
+/* narrowing with saturation, 8 pixels */
+
+static inline void v_pack_store_u8(vx_uint8 *p, v_int16x8 v)
+{
+    v_uint8x8 r = __builtin_convertvector(v_min(v_max(v, v_setall_s16(0)), v_setall_s16(UINT8_MAX)), v_uint8x8);
+    memcpy(p, &r, sizeof(r));
+}
+
+static inline void v_pack_store_u8(vx_uint8 *p, const v_int32x8 &v)
+{
+    v_int32x8 c;
+    v_uint8x8 r;
+
+    v_clamp(&c, v, 0, UINT8_MAX);
+    r = __builtin_convertvector(c, v_uint8x8);
+    memcpy(p, &r, sizeof(r));
+}
+
+static inline void v_pack_store_s16(vx_int16 *p, const v_int32x8 &v)
+{
+    v_int32x8 c;
+
+    v_clamp(&c, v, INT16_MIN, INT16_MAX);
+    v_store(p, __builtin_convertvector(c, v_int16x8));
+}
+
+/* narrowing by truncation (wrap), 8 pixels */
+
+static inline void v_trunc_store_u8(vx_uint8 *p, const v_int32x8 &v)
+{
+    v_uint8x8 r = __builtin_convertvector(v, v_uint8x8);
+    memcpy(p, &r, sizeof(r));
+}
+
+static inline void v_trunc_store_s16(vx_int16 *p, const v_int32x8 &v)
+{
+    v_int16x8 r = __builtin_convertvector(v, v_int16x8);
+    v_store(p, r);
+}
+
+/* float */
+
+static inline void v_cvt_f32(v_float32x8 *r, const v_int32x8 &v)
+{
+    *r = __builtin_convertvector(v, v_float32x8);
+}
+
+/* toward zero */
+static inline void v_trunc(v_int32x8 *r, const v_float32x8 &v)
+{
+    *r = __builtin_convertvector(v, v_int32x8);
+}
+
+static inline void v_floor(v_int32x8 *r, const v_float32x8 &v)
+{
+    v_int32x8 i = __builtin_convertvector(v, v_int32x8);
+
+    /* -1 where the truncation went up */
+    *r = i + (v_int32x8)(__builtin_convertvector(i, v_float32x8) > v);
+}
+
+static inline void v_abs(v_float32x8 *r, const v_float32x8 &v)
+{
+    *r = (v_float32x8)((v_int32x8)v & INT32_MAX);
+}
+
+#endif
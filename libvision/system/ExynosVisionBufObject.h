@@ -40,6 +40,7 @@
 namespace android {
 
 #define DEFAULT_SLOT_NUM    2
+#define MAX_SLOT_NUM        8
 
 class ExynosVisionBufMemory {
 private:
@@ -21,6 +21,7 @@
 #include <utils/List.h>
 #include <utils/Vector.h>
 #include <map>
+#include <atomic>
 
 #include <VX/vx.h>
 
@@ -69,6 +70,28 @@ typedef struct _time_pair_t {
         time_pair[index].end = usec;    \
     }
 
+/* image traffic of a frame, see ExynosVisionGraph::measureTraffic() */
+typedef struct _traffic_info_t {
+    /* bytes of images read and written when every node runs by itself */
+    vx_uint64 unfused_bytes;
+    /* bytes of images read and written, intermediate of fused subgraph stays in bands */
+    vx_uint64 fused_bytes;
+    /* bytes of intermediate images that are never allocated */
+    vx_uint64 unallocated_bytes;
+    /* bytes of images read and written in memory, intermediate of fused subgraph is not counted */
+    vx_uint64 read_bytes;
+    vx_uint64 write_bytes;
+} traffic_info_t;
+
+/* number of executions the trace ring of an object keeps, power of 2 */
+#define MAX_TRACE_RECORD_NUM    256
+
+/* time pairs of one execution, NODE_TIMEPAIR_NUMBER is the largest set */
+typedef struct _trace_record_t {
+    vx_uint32 frame_number;
+    time_pair_t time_pair[NODE_TIMEPAIR_NUMBER];
+} trace_record_t;
+
 class ExynosVisionStampElement {
 
 enum graph_state {
@@ -141,11 +164,24 @@ class ExynosVisionPerfMonitor {
 
 #define MAX_TRACE_FRAME_NUM 100
 
+typedef struct _trace_cell_t {
+    /* index+1 of the record once it is complete, 0 while it is written */
+    std::atomic<vx_uint32> seq;
+    vx_uint32 claim;
+    trace_record_t record;
+} trace_cell_t;
+
 typedef struct _perf_info_t {
     /* stamp vector for tracing several frames performance */
     Vector<ExynosVisionStampElement*> *stamp_vector;
 
     vx_perf_t *vx_perf_info;
+
+    traffic_info_t traffic_info;
+
+    /* trace mode, the last executions are recorded without locking */
+    trace_cell_t *trace_ring;
+    std::atomic<vx_uint32> trace_head;
 } perf_info_t;
 
 private:
@@ -180,6 +216,7 @@ public:
                 }
                 delete object_perf->stamp_vector;
                 delete object_perf->vx_perf_info;
+                delete[] object_perf->trace_ring;
 
                 delete object_perf;
             }
@@ -207,6 +244,9 @@ public:
         perf_info_t *perf_info = new perf_info_t;
         perf_info->stamp_vector = stamp_vector;
         perf_info->vx_perf_info = vx_perf_info;
+        memset(&perf_info->traffic_info, 0x0, sizeof(perf_info->traffic_info));
+        perf_info->trace_ring = NULL;
+        perf_info->trace_head.store(0, std::memory_order_relaxed);
 
         m_perf_bunch_map[object] = perf_info;
 
@@ -226,6 +266,7 @@ public:
             }
             delete object_perf->stamp_vector;
             delete object_perf->vx_perf_info;
+            delete[] object_perf->trace_ring;
 
             delete object_perf;
         } else {
@@ -246,6 +287,21 @@ public:
             return NULL;
         }
 
+        if (object_perf->trace_ring != NULL) {
+            /* claim the oldest cell, a reader skips it until it is published again */
+            vx_uint32 index = object_perf->trace_head.fetch_add(1, std::memory_order_relaxed);
+            trace_cell_t *cell = &object_perf->trace_ring[index & (MAX_TRACE_RECORD_NUM - 1)];
+
+            cell->seq.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            cell->claim = index;
+            cell->record.frame_number = frame_number;
+            memset(cell->record.time_pair, 0x0, sizeof(cell->record.time_pair));
+
+            return cell->record.time_pair;
+        }
+
         Vector<ExynosVisionStampElement*>*stamp_vector = object_perf->stamp_vector;
         ExynosVisionStampElement *perf_elem = stamp_vector->editItemAt(frame_number%MAX_TRACE_FRAME_NUM);;
         if (perf_elem == NULL) {
@@ -267,6 +323,21 @@ public:
             return;
         }
 
+        if (object_perf->trace_ring != NULL) {
+            trace_cell_t *cell = (trace_cell_t*)((char*)time_pair - offsetof(trace_cell_t, record.time_pair));
+            vx_uint32 index = (vx_uint32)(cell - object_perf->trace_ring);
+
+            if ((index >= MAX_TRACE_RECORD_NUM) || (cell->record.frame_number != frame_number)) {
+                ALOGE("[%s] returned trace record is corrupted, frame_%d, %p", __FUNCTION__, frame_number, time_pair);
+                return;
+            }
+
+            updateVxPerfInfo(object_perf->vx_perf_info, time_pair);
+
+            cell->seq.store(cell->claim + 1, std::memory_order_release);
+            return;
+        }
+
         Vector<ExynosVisionStampElement*>*stamp_vector = object_perf->stamp_vector;
         ExynosVisionStampElement *perf_elem = stamp_vector->editItemAt(frame_number%MAX_TRACE_FRAME_NUM);;
         if (perf_elem == NULL) {
@@ -314,6 +385,86 @@ public:
             return NULL;
     }
 
+    void setTrafficInfo(T object, const traffic_info_t *traffic_info)
+    {
+        Mutex::Autolock lock(m_access_lock);
+
+        perf_info_t *object_perf = m_perf_bunch_map[object];
+        if (object_perf)
+            object_perf->traffic_info = *traffic_info;
+        else
+            ALOGE("[%s] un-registered object", __FUNCTION__);
+    }
+
+    traffic_info_t* getTrafficInfo(T object)
+    {
+        m_access_lock.lock();
+        perf_info_t *object_perf = m_perf_bunch_map[object];
+        m_access_lock.unlock();
+
+        if (object_perf != NULL)
+            return &object_perf->traffic_info;
+        else
+            return NULL;
+    }
+
+    /* switch an object between the stamp and the trace mode, not while it is executed */
+    void setTraceMode(T object, vx_bool enable)
+    {
+        Mutex::Autolock lock(m_access_lock);
+
+        perf_info_t *object_perf = m_perf_bunch_map[object];
+        if (object_perf == NULL) {
+            ALOGE("[%s] un-registered object", __FUNCTION__);
+            return;
+        }
+
+        if ((enable == vx_true_e) && (object_perf->trace_ring == NULL)) {
+            object_perf->trace_ring = new trace_cell_t[MAX_TRACE_RECORD_NUM];
+            for (vx_uint32 i=0; i<MAX_TRACE_RECORD_NUM; i++)
+                object_perf->trace_ring[i].seq.store(0, std::memory_order_relaxed);
+            object_perf->trace_head.store(0, std::memory_order_relaxed);
+        } else if ((enable == vx_false_e) && (object_perf->trace_ring != NULL)) {
+            delete[] object_perf->trace_ring;
+            object_perf->trace_ring = NULL;
+        }
+    }
+
+    /* copy the completed records of the trace ring, oldest first */
+    vx_uint32 getTraceRecords(T object, Vector<trace_record_t> *records)
+    {
+        m_access_lock.lock();
+        perf_info_t *object_perf = m_perf_bunch_map[object];
+        m_access_lock.unlock();
+
+        records->clear();
+        if ((object_perf == NULL) || (object_perf->trace_ring == NULL))
+            return 0;
+
+        vx_uint32 head = object_perf->trace_head.load(std::memory_order_acquire);
+        vx_uint32 index = (head > MAX_TRACE_RECORD_NUM) ? (head - MAX_TRACE_RECORD_NUM) : 0;
+
+        for (; index != head; index++) {
+            trace_cell_t *cell = &object_perf->trace_ring[index & (MAX_TRACE_RECORD_NUM - 1)];
+            trace_record_t record;
+
+            vx_uint32 seq = cell->seq.load(std::memory_order_acquire);
+            if (seq != index + 1)
+                continue;
+
+            record = cell->record;
+
+            /* a writer that claimed the cell meanwhile makes the copy torn */
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (cell->seq.load(std::memory_order_relaxed) != seq)
+                continue;
+
+            records->push_back(record);
+        }
+
+        return records->size();
+    }
+
     void displayPerfInfo(void)
     {
         typename map<T, perf_info_t*>::iterator  map_iter;
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EXYNOS_VISION_PERF_REPORT_H
+#define EXYNOS_VISION_PERF_REPORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * The performance report of the graph and tools/vxperf_report.cpp on the host
+ * share this file, keep it free of framework headers.
+ */
+
+/* event categories of the trace, one event per line */
+#define PERF_TRACE_CAT_GRAPH        "graph"
+#define PERF_TRACE_CAT_SUBGRAPH     "subgraph"
+#define PERF_TRACE_CAT_NODE         "node"
+#define PERF_TRACE_CAT_KERNEL       "kernel"
+#define PERF_TRACE_CAT_FIRMWARE     "firmware"
+
+/* nearest rank percentile of durations sorted in ascending order */
+static inline uint64_t perfPercentile(const uint64_t *sorted, size_t num, uint32_t percent)
+{
+    size_t rank;
+
+    if (num == 0)
+        return 0;
+
+    rank = (num * percent + 99) / 100;
+    if (rank == 0)
+        rank = 1;
+
+    return sorted[rank - 1];
+}
+
+/* bytes moved in duration_us microseconds, in GB/s */
+static inline float perfGbps(uint64_t bytes, uint64_t duration_us)
+{
+    if (duration_us == 0)
+        return 0.0f;
+
+    return (float)bytes / (float)duration_us / 1000.0f;
+}
+
+#endif
@@ -25,7 +25,7 @@
 #include <VX/vx.h>
 
 #include "ExynosVisionMemoryAllocator.h"
-#include "ExynosVisionPool.h"
+#include "ExynosVisionRingQueue.h"
 #include "ExynosVisionState.h"
 
 #define RES_DBG_MSG  0
@@ -316,7 +316,8 @@ private:
     /* m_buf_element_list has the all of the res element */
     List<ExynosVisionResElement<T>*> m_registered_res_element_list;
 
-    ExynosVisionPool<ExynosVisionResElement<T>*> m_free_res_element_pool;
+    /* a free element is handed to the writer of the next frame without locking */
+    ExynosVisionRingQueue<ExynosVisionResElement<T>*> m_free_res_element_pool;
 
 public:
 
@@ -325,6 +326,7 @@ private:
 public:
     /* Constructor */
     ExynosVisionResSlotType(vx_uint32 slot_num = 1)
+                                                    : m_free_res_element_pool(slot_num, 0)
     {
         ExynosVisionResManager<T>::m_res_class_type = RESOURCE_CLASS_SLOT;
         m_slot_num = slot_num;
@@ -351,7 +353,7 @@ public:
         m_registered_res_element_list.push_back(res_element);
         ExynosVisionResManager<T>::m_res_mutex.unlock();
 
-        m_free_res_element_pool.putResource(res_element);
+        m_free_res_element_pool.pushProcessQ(&res_element);
 
         return VX_SUCCESS;
     }
@@ -361,7 +363,6 @@ public:
         vx_status status = VX_SUCCESS;
 
         m_free_res_element_pool.release();
-        m_free_res_element_pool.flush();
 
         typename List<ExynosVisionResElement<T>*>::iterator elem_iter;
         for (elem_iter=m_registered_res_element_list.begin(); elem_iter!=m_registered_res_element_list.end(); elem_iter++)
@@ -374,12 +375,12 @@ public:
 
     virtual T waitAndGetEmptyResAndWrLk(vx_uint32 frame_id)
     {
-        pool_exception_t pool_exception;
+        queue_exception_t exception;
         ExynosVisionResElement<T>* res_element = NULL;
 
-        pool_exception = m_free_res_element_pool.getResource(&res_element);
+        exception = m_free_res_element_pool.waitAndPopProcessQ(&res_element);
 
-        if (pool_exception == POOL_EXCEPTION_NONE) {
+        if (exception == QUEUE_EXCEPTION_NONE) {
             ExynosVisionResManager<T>::m_res_mutex.lock();
             res_element->setId(frame_id);
             res_element->setState(RES_ELEMENT_WRITE_LOCK);
@@ -498,7 +499,7 @@ public:
                 res_element->clearReadInfo();
                 res_element->setId(0);
                 res_element->setState(RES_ELEMENT_NO_LOCK);
-                m_free_res_element_pool.putResource(res_element);
+                m_free_res_element_pool.pushProcessQ(&res_element);
             }
         }
 
@@ -520,7 +521,7 @@ public:
         vx_uint32 i;
         typename List<ExynosVisionResElement<T>*>::iterator elem_iter;
 
-        VXLOGD("%s[SLOT]used buf num:%d, free buf num:%d", MAKE_TAB(tap, tab_num), ExynosVisionResManager<T>::m_using_res_element_list.size(), m_free_res_element_pool.getFreeNum());
+        VXLOGD("%s[SLOT]used buf num:%d, free buf num:%d", MAKE_TAB(tap, tab_num), ExynosVisionResManager<T>::m_using_res_element_list.size(), m_free_res_element_pool.getRemainedMsgNum());
         if (detail_info == vx_true_e) {
             for (elem_iter=ExynosVisionResManager<T>::m_using_res_element_list.begin(), i=0;
                     elem_iter!=ExynosVisionResManager<T>::m_using_res_element_list.end();
@@ -541,7 +542,7 @@ private:
 
 protected:
     Vector<ExynosVisionResElement<T>*> m_res_element_vector;
-    ExynosVisionPool<ExynosVisionResElement<T>*> m_done_res_element_pool;
+    ExynosVisionRingQueue<ExynosVisionResElement<T>*> m_done_res_element_pool;
 
 public:
 
@@ -550,6 +551,7 @@ private:
 public:
     /* Constructor */
     ExynosVisionResQueueType(void)
+                                    : m_done_res_element_pool(MAX_QUEUE_RES_NUM, 0)
     {
         for (vx_uint32 i=0; i<MAX_QUEUE_RES_NUM; i++) {
             ExynosVisionResElement<T> *res_element = new ExynosVisionResElement<T>();
@@ -580,11 +582,11 @@ public:
     {
         vx_status status = VX_SUCCESS;
 
-        pool_exception_t pool_exception;
+        queue_exception_t exception;
         ExynosVisionResElement<T>* res_element = NULL;
 
-        pool_exception = m_done_res_element_pool.getResource(&res_element);
-        if (pool_exception == POOL_EXCEPTION_NONE) {
+        exception = m_done_res_element_pool.waitAndPopProcessQ(&res_element);
+        if (exception == QUEUE_EXCEPTION_NONE) {
             ExynosVisionResManager<T>::m_res_mutex.lock();
             if (res_element->getResource() == NULL)
                 VXLOGE("element holds null resource");
@@ -706,7 +708,7 @@ public:
                 ExynosVisionResManager<T>::m_using_res_element_list.erase(elem_iter);
                 res_element->clearReadInfo();
                 res_element->setState(RES_ELEMENT_NO_LOCK);
-                ExynosVisionResQueueType<T>::m_done_res_element_pool.putResource(res_element);
+                ExynosVisionResQueueType<T>::m_done_res_element_pool.pushProcessQ(&res_element);
             }
         }
 
@@ -723,14 +725,14 @@ public:
         vx_uint32 i;
         typename List<ExynosVisionResElement<T>*>::iterator elem_iter;
 
-        VXLOGD("%s[QUEU][%d]rece buf num:%d, done buf num:%d", MAKE_TAB(tap, tab_num), detail_info, ExynosVisionResQueueType<T>::m_using_res_element_list.size(), ExynosVisionResQueueType<T>::m_done_res_element_pool.getFreeNum());
+        VXLOGD("%s[QUEU][%d]rece buf num:%d, done buf num:%d", MAKE_TAB(tap, tab_num), detail_info, ExynosVisionResQueueType<T>::m_using_res_element_list.size(), ExynosVisionResQueueType<T>::m_done_res_element_pool.getRemainedMsgNum());
     }
 };
 
 template<typename T>
 class ExynosVisionResOutputQueueType : public ExynosVisionResQueueType<T> {
 private:
-    ExynosVisionPool<ExynosVisionResElement<T>*> m_free_res_element_pool;
+    ExynosVisionRingQueue<ExynosVisionResElement<T>*> m_free_res_element_pool;
 
 public:
 
@@ -739,6 +741,7 @@ private:
 public:
     /* Constructor */
     ExynosVisionResOutputQueueType(void)
+                                            : m_free_res_element_pool(MAX_QUEUE_RES_NUM, 0)
     {
         ExynosVisionResManager<T>::m_res_class_type = RESOURCE_CLASS_OUTPUT_QUEUE;
     }
@@ -766,18 +769,18 @@ public:
         res_element->setResource(resource);
         ExynosVisionResManager<T>::m_res_mutex.unlock();
 
-        m_free_res_element_pool.putResource(res_element);
+        m_free_res_element_pool.pushProcessQ(&res_element);
 
         return VX_SUCCESS;
     }
 
     virtual T waitAndGetEmptyResAndWrLk(vx_uint32 frame_id) {
-        pool_exception_t pool_exception;
+        queue_exception_t exception;
         ExynosVisionResElement<T>* res_element = NULL;
 
-        pool_exception = m_free_res_element_pool.getResource(&res_element);
+        exception = m_free_res_element_pool.waitAndPopProcessQ(&res_element);
 
-        if (pool_exception == POOL_EXCEPTION_NONE) {
+        if (exception == QUEUE_EXCEPTION_NONE) {
             ExynosVisionResManager<T>::m_res_mutex.lock();
             res_element->setId(frame_id);
             res_element->setState(RES_ELEMENT_WRITE_LOCK);
@@ -815,7 +818,7 @@ public:
             VXLOGE("cannot find perfer buffer, id:%d", frame_id);
         } else {
             ExynosVisionResQueueType<T>::m_using_res_element_list.erase(elem_iter);
-            ExynosVisionResQueueType<T>::m_done_res_element_pool.putResource(res_element);
+            ExynosVisionResQueueType<T>::m_done_res_element_pool.pushProcessQ(&res_element);
         }
 
         ExynosVisionResManager<T>::m_res_mutex.unlock();
@@ -832,8 +835,8 @@ public:
         typename List<ExynosVisionResElement<T>*>::iterator elem_iter;
 
         VXLOGD("%s[QUEU][%d]free buf num:%d, done buf num:%d", MAKE_TAB(tap, tab_num), detail_info,
-                m_free_res_element_pool.getFreeNum(),
-                ExynosVisionResQueueType<T>::m_done_res_element_pool.getFreeNum());
+                m_free_res_element_pool.getRemainedMsgNum(),
+                ExynosVisionResQueueType<T>::m_done_res_element_pool.getRemainedMsgNum());
     }
 };
 
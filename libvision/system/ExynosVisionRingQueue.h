@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EXYNOS_VISION_RING_QUEUE_H
+#define EXYNOS_VISION_RING_QUEUE_H
+
+#include <utils/threads.h>
+#include <utils/Mutex.h>
+
+#include <atomic>
+
+#include "ExynosVisionQueue.h"
+
+#define RING_QUEUE_CACHE_LINE   (64)
+
+namespace android {
+
+/*
+ * Bounded multi-producer/multi-consumer ring with the interface of ExynosVisionQueue.
+ * Every cell carries a sequence number, so push and pop only race on one
+ * compare-and-swap of the enqueue or the dequeue position. The mutex is taken
+ * only to sleep, when a consumer finds the ring empty or a producer finds it full,
+ * and by the other side when somebody is sleeping.
+ */
+template<typename T>
+class ExynosVisionRingQueue {
+private:
+    struct ring_cell_t {
+        std::atomic<uint32_t> seq;
+        T data;
+    };
+
+    ring_cell_t         *m_cells;
+    uint32_t            m_mask;
+    uint64_t            m_waitTime;
+
+    /* padding keeps producers and consumers off each other's cache line,
+        alignas() would need an over-aligned operator new */
+    char                m_pad0[RING_QUEUE_CACHE_LINE];
+    std::atomic<uint32_t> m_enqueue_pos;
+    char                m_pad1[RING_QUEUE_CACHE_LINE];
+    std::atomic<uint32_t> m_dequeue_pos;
+    char                m_pad2[RING_QUEUE_CACHE_LINE];
+
+    std::atomic<int32_t> m_pop_waiter_num;
+    std::atomic<int32_t> m_push_waiter_num;
+    std::atomic<bool>   m_queue_enable;
+
+    Mutex               m_wait_mutex;
+    mutable Condition   m_not_empty_cond;
+    mutable Condition   m_not_full_cond;
+    bool                m_wake_up_flag;
+
+    bool tryPush(const T *buf)
+    {
+        ring_cell_t *cell;
+        uint32_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            uint32_t seq = cell->seq.load(std::memory_order_acquire);
+            int32_t diff = (int32_t)(seq - pos);
+
+            if (diff == 0) {
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = *buf;
+        cell->seq.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool tryPop(T *buf)
+    {
+        ring_cell_t *cell;
+        uint32_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            uint32_t seq = cell->seq.load(std::memory_order_acquire);
+            int32_t diff = (int32_t)(seq - (pos + 1));
+
+            if (diff == 0) {
+                if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        *buf = cell->data;
+        cell->seq.store(pos + m_mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /* the fence pairs with the one after the waiter count is raised */
+    void signalWaiter(std::atomic<int32_t> *waiter_num, Condition *cond)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiter_num->load(std::memory_order_relaxed) > 0) {
+            Mutex::Autolock lock(m_wait_mutex);
+            cond->signal();
+        }
+    }
+
+public:
+    ExynosVisionRingQueue(uint32_t capacity, uint64_t wait_time)
+    {
+        uint32_t size = 2;
+
+        while ((size < capacity) && (size < (1U << 30)))
+            size <<= 1;
+
+        m_mask = size - 1;
+        m_cells = new ring_cell_t[size];
+        for (uint32_t i = 0; i < size; i++)
+            m_cells[i].seq.store(i, std::memory_order_relaxed);
+
+        m_waitTime = wait_time;
+
+        m_enqueue_pos.store(0, std::memory_order_relaxed);
+        m_dequeue_pos.store(0, std::memory_order_relaxed);
+        m_pop_waiter_num.store(0, std::memory_order_relaxed);
+        m_push_waiter_num.store(0, std::memory_order_relaxed);
+        m_queue_enable.store(true, std::memory_order_relaxed);
+
+        m_wake_up_flag = false;
+    }
+
+    ~ExynosVisionRingQueue()
+    {
+        release();
+        delete[] m_cells;
+    }
+
+    void wakeupPendingThread(void)
+    {
+        Mutex::Autolock lock(m_wait_mutex);
+
+        if (m_pop_waiter_num.load(std::memory_order_relaxed) > 0) {
+            m_wake_up_flag = true;
+            m_not_empty_cond.signal();
+        }
+    }
+
+    void wakeupPendingThreadAndQDisable(void)
+    {
+        Mutex::Autolock lock(m_wait_mutex);
+
+        m_queue_enable.store(false, std::memory_order_relaxed);
+        if (m_pop_waiter_num.load(std::memory_order_relaxed) > 0) {
+            m_wake_up_flag = true;
+            m_not_empty_cond.signal();
+        }
+        m_not_full_cond.broadcast();
+    }
+
+    /* Process Queue, a producer sleeps only while the ring is full */
+    void pushProcessQ(T *buf)
+    {
+        DEBUGQ("[Q][%s]", __FUNCTION__);
+
+        if (tryPush(buf) == false) {
+            m_wait_mutex.lock();
+            m_push_waiter_num.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            while (tryPush(buf) == false) {
+                if (m_queue_enable.load(std::memory_order_relaxed) == false) {
+                    ALOGE("ERR(%s):queue is disabled, drop the message", __FUNCTION__);
+                    break;
+                }
+                m_not_full_cond.wait(m_wait_mutex);
+            }
+
+            m_push_waiter_num.fetch_sub(1, std::memory_order_relaxed);
+            m_wait_mutex.unlock();
+        }
+
+        signalWaiter(&m_pop_waiter_num, &m_not_empty_cond);
+    };
+
+    status_t popProcessQ(T *buf)
+    {
+        DEBUGQ("[Q][%s]", __FUNCTION__);
+
+        if (tryPop(buf) == false)
+            return TIMED_OUT;
+
+        signalWaiter(&m_push_waiter_num, &m_not_full_cond);
+
+        return OK;
+    };
+
+    queue_exception_t waitAndPopProcessQ(T *buf)
+    {
+        status_t ret;
+        queue_exception_t exception = QUEUE_EXCEPTION_NONE;
+
+        DEBUGQ("[Q][%s]", __FUNCTION__);
+
+        if (m_queue_enable.load(std::memory_order_acquire) == false)
+            return QUEUE_EXCEPTION_DISABLE;
+
+        if (tryPop(buf) == true) {
+            signalWaiter(&m_push_waiter_num, &m_not_full_cond);
+            return QUEUE_EXCEPTION_NONE;
+        }
+
+        m_wait_mutex.lock();
+        m_pop_waiter_num.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        while (tryPop(buf) == false) {
+            if (m_wake_up_flag == true) {
+                m_wake_up_flag = false;
+
+                if (m_queue_enable.load(std::memory_order_relaxed) == false)
+                    exception = QUEUE_EXCEPTION_DISABLE;
+                else
+                    exception = QUEUE_EXCEPTION_WAKE_UP;
+                break;
+            }
+
+            if (m_queue_enable.load(std::memory_order_relaxed) == false) {
+                exception = QUEUE_EXCEPTION_DISABLE;
+                break;
+            }
+
+            if (m_waitTime)
+                ret = m_not_empty_cond.waitRelative(m_wait_mutex, m_waitTime);
+            else
+                ret = m_not_empty_cond.wait(m_wait_mutex);
+
+            if ((ret < 0) && (tryPop(buf) == false)) {
+                if (ret == TIMED_OUT) {
+                    ALOGD("DEBUG(%s):Time out, Skip to pop process Q", __FUNCTION__);
+                }
+                else {
+                    ALOGE("ERR(%s):Fail to pop processQ", __FUNCTION__);
+                }
+
+                exception = QUEUE_EXCEPTION_TIME_OUT;
+                break;
+            } else if (ret < 0) {
+                break;
+            }
+        }
+
+        m_pop_waiter_num.fetch_sub(1, std::memory_order_relaxed);
+        m_wait_mutex.unlock();
+
+        if (exception == QUEUE_EXCEPTION_NONE)
+            signalWaiter(&m_push_waiter_num, &m_not_full_cond);
+
+        return exception;
+    };
+
+    uint32_t getRemainedMsgNum(void)
+    {
+        uint32_t dequeue_pos = m_dequeue_pos.load(std::memory_order_acquire);
+        uint32_t enqueue_pos = m_enqueue_pos.load(std::memory_order_acquire);
+        int32_t diff = (int32_t)(enqueue_pos - dequeue_pos);
+
+        if (diff < 0)
+            return 0;
+        if ((uint32_t)diff > m_mask + 1)
+            return m_mask + 1;
+
+        return (uint32_t)diff;
+    }
+
+    uint32_t getCapacity(void)
+    {
+        return m_mask + 1;
+    }
+
+    /* disable the queue, wake every sleeper and drop the remained messages */
+    void release(void)
+    {
+        T buf;
+
+        DEBUGQ("[Q][%s]", __FUNCTION__);
+
+        m_wait_mutex.lock();
+        m_queue_enable.store(false, std::memory_order_release);
+        m_not_empty_cond.broadcast();
+        m_not_full_cond.broadcast();
+        m_wait_mutex.unlock();
+
+        while (tryPop(&buf) == true)
+            ;
+    };
+};
+
+}; // namespace android
+#endif
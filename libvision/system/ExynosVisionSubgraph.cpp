@@ -22,6 +22,7 @@
 #include "ExynosVisionSubgraph.h"
 
 #include "ExynosVisionGraph.h"
+#include "ExynosVisionImage.h"
 #include "ExynosVisionBufObject.h"
 
 #define BIT_FLAG(i) ((1<<i))
@@ -58,6 +59,12 @@ ExynosVisionSubgraph::ExynosVisionSubgraph(ExynosVisionGraph *graph)
     m_complete_event = NULL;
 
     m_last_process_frame = 0;
+
+    m_is_header = vx_false_e;
+    m_is_footer = vx_false_e;
+
+    m_band_height = 0;
+    m_band_rows = 0;
 }
 
 ExynosVisionSubgraph::~ExynosVisionSubgraph(void)
@@ -80,6 +87,19 @@ ExynosVisionSubgraph::init(ExynosVisionNode *node)
     return VX_SUCCESS;
 }
 
+vx_status
+ExynosVisionSubgraph::addNode(ExynosVisionNode *node)
+{
+    vx_size len = strlen(m_sg_name);
+
+    snprintf(m_sg_name + len, sizeof(m_sg_name) - len, "+%s", node->getKernelHandle()->getKernelFuncName());
+
+    /* nodes are added in topological order, the represent node is the first */
+    m_node_list.push_back(node);
+
+    return VX_SUCCESS;
+}
+
 vx_status
 ExynosVisionSubgraph::destroy(void)
 {
@@ -98,11 +118,17 @@ ExynosVisionSubgraph::destroy(void)
     if (m_params)
         delete m_params;
 
+    releaseFusedNodeInfo();
+
     if (m_complete_event) {
         delete m_complete_event;
         m_complete_event = NULL;
     }
 
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++)
+        (*node_iter)->setSubgraph(NULL);
+
     return status;
 }
 
@@ -113,44 +139,217 @@ ExynosVisionSubgraph::makeInputOutputPort(void)
 
     vx_status status = VX_SUCCESS;
 
+    List<ExynosVisionNode*>::iterator node_iter;
+
     m_target_done_bitmask = 0;
+    m_is_header = vx_true_e;
+    m_is_footer = vx_true_e;
 
     m_input_data_ref_list.clear();
     m_output_data_ref_list.clear();
+    m_strip_map.clear();
+
+    /* virtual image written and read only inside of fused subgraph doesn't become a port */
+    if (isFused()) {
+        for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+            ExynosVisionNode *node = *node_iter;
+            for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+                ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+                if ((data_ref == NULL) || (node->getKernelHandle()->getParamDirection(p) != VX_OUTPUT))
+                    continue;
+
+                if ((data_ref->isVirtual() != vx_true_e) || (data_ref->getType() != VX_TYPE_IMAGE) ||
+                    (data_ref->getDirectOutputNodeNum(m_graph) == 0) ||
+                    (data_ref->getDirectOutputNodeNum(m_graph) != data_ref->getIndirectOutputNodeNum(m_graph)))
+                    continue;
+
+                vx_uint32 i;
+                for (i = 0; i < data_ref->getDirectOutputNodeNum(m_graph); i++) {
+                    if (data_ref->getDirectOutputNode(m_graph, i)->getSubgraph() != this)
+                        break;
+                }
 
-    for (vx_uint32 p = 0; p < m_represent_node->getDataRefNum(); p++) {
-        ExynosVisionDataReference *data_ref = m_represent_node->getDataRefByIndex(p);
-        if ((data_ref == NULL) && m_represent_node->getKernelHandle()->getParamState(p) == VX_PARAMETER_STATE_REQUIRED) {
-            VXLOGE("%s(%s) does not have necessary parameter[%d]", m_represent_node->getName(), m_represent_node->getKernelName(), p);
+                if (i == data_ref->getDirectOutputNodeNum(m_graph)) {
+                    band_strip_t strip;
+                    memset(&strip, 0x0, sizeof(strip));
+                    m_strip_map[data_ref] = strip;
+                }
+            }
         }
+    }
+
+    for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        ExynosVisionNode *node = *node_iter;
 
-        ref_connect_info_t connect_info;
-        connect_info.ref = data_ref;
-        connect_info.node_index = p;
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+            if ((data_ref == NULL) && node->getKernelHandle()->getParamState(p) == VX_PARAMETER_STATE_REQUIRED) {
+                VXLOGE("%s(%s) does not have necessary parameter[%d]", node->getName(), node->getKernelName(), p);
+            }
+
+            if ((data_ref != NULL) && isInternalRef(data_ref))
+                continue;
+
+            ref_connect_info_t connect_info;
+            connect_info.ref = data_ref;
+            connect_info.node = node;
+            connect_info.node_index = p;
+
+            if (node->getKernelHandle()->getParamDirection(p) == VX_INPUT) {
+                /* exclusive object doesn't need to receive doen event */
+                if ((data_ref != NULL) &&
+                    ((data_ref->getIndirectInputNodeNum(m_graph) != 0) || (data_ref->isQueue()))) {
+                    if (m_input_data_ref_list.size() >= sizeof(m_target_done_bitmask) * 8) {
+                        VXLOGE("%s has too many input ports, %d", getSgName(), m_input_data_ref_list.size());
+                        status = VX_ERROR_NO_RESOURCES;
+                    } else {
+                        m_target_done_bitmask |= BIT_FLAG(m_input_data_ref_list.size());
+                    }
+                }
 
-        if (m_represent_node->getKernelHandle()->getParamDirection(p) == VX_INPUT) {
-            m_input_data_ref_list.push_back(connect_info);
+                if ((data_ref != NULL) && (data_ref->getIndirectInputNodeNum(m_graph) != 0))
+                    m_is_header = vx_false_e;
 
-            /* exclusive object doesn't need to receive doen event */
-            if ((data_ref != NULL) &&
-                ((data_ref->getIndirectInputNodeNum(m_graph) != 0) || (data_ref->isQueue()))) {
-                m_target_done_bitmask |= BIT_FLAG(p);
+                m_input_data_ref_list.push_back(connect_info);
+            } else {
+                if ((data_ref != NULL) && (data_ref->getIndirectOutputNodeNum(m_graph) != 0))
+                    m_is_footer = vx_false_e;
+
+                m_output_data_ref_list.push_back(connect_info);
             }
-        } else {
-            m_output_data_ref_list.push_back(connect_info);
         }
     }
 
-    m_param_num = m_input_data_ref_list.size() + m_output_data_ref_list.size();
-    m_params = new ExynosVisionDataReference*[m_param_num];
+    /* fused nodes keep their own parameters, see makeFusedNodeInfo() */
+    if (isFused() == vx_false_e) {
+        m_param_num = m_input_data_ref_list.size() + m_output_data_ref_list.size();
+        m_params = new ExynosVisionDataReference*[m_param_num];
+    }
 
     EXYNOS_VISION_SYSTEM_OUT();
 
-    return VX_SUCCESS;
+    return status;
+}
+
+vx_uint32
+ExynosVisionSubgraph::getBandPixelSize(vx_df_image format)
+{
+    switch (format) {
+    case VX_DF_IMAGE_U8:
+        return sizeof(vx_uint8);
+    case VX_DF_IMAGE_S16:
+        return sizeof(vx_int16);
+    case VX_DF_IMAGE_U32:
+        return sizeof(vx_uint32);
+    default:
+        return 0;
+    }
 }
 
 vx_status
-ExynosVisionSubgraph::replaceDataRef(ExynosVisionDataReference *old_ref, ExynosVisionDataReference *new_ref, vx_uint32 node_index, enum vx_direction_e dir)
+ExynosVisionSubgraph::makeFusedNodeInfo(void)
+{
+    EXYNOS_VISION_SYSTEM_IN();
+
+    vx_status status = VX_SUCCESS;
+    vx_uint32 radius_sum = 0;
+    vx_uint32 row_bytes = 0;
+
+    m_band_height = 0;
+
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        ExynosVisionNode *node = *node_iter;
+        const ExynosVisionKernel *kernel = node->getKernelHandle();
+
+        fused_node_info_t info;
+        info.node = node;
+        info.params = new ExynosVisionDataReference*[node->getDataRefNum()];
+        info.bands = new vx_image_band_t[node->getDataRefNum()];
+        memset(info.bands, 0x0, sizeof(vx_image_band_t) * node->getDataRefNum());
+        info.start_y = 0;
+        info.end_y = 0;
+
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+
+            /* intermediate image is handed over as it is, band function doesn't access it */
+            info.params[p] = data_ref;
+            if ((data_ref == NULL) || (kernel->getParamType(p) != VX_TYPE_IMAGE))
+                continue;
+
+            ExynosVisionImage *image = (ExynosVisionImage*)data_ref;
+            vx_image_band_t *band = &info.bands[p];
+            status |= image->getDimension(&band->width, &band->height);
+            status |= image->queryImage(VX_IMAGE_ATTRIBUTE_FORMAT, &band->format, sizeof(band->format));
+            m_band_height = band->height;
+        }
+
+        radius_sum += kernel->getBandRadius();
+        m_fused_node_list.push_back(info);
+    }
+
+    map<ExynosVisionDataReference*, band_strip_t>::iterator strip_iter;
+    for (strip_iter=m_strip_map.begin(); strip_iter!=m_strip_map.end(); strip_iter++) {
+        ExynosVisionImage *image = (ExynosVisionImage*)strip_iter->first;
+        vx_uint32 width = 0, height = 0;
+        vx_df_image format = VX_DF_IMAGE_VIRT;
+
+        status |= image->getDimension(&width, &height);
+        status |= image->queryImage(VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format));
+        strip_iter->second.stride = width * getBandPixelSize(format);
+        row_bytes += strip_iter->second.stride;
+    }
+
+    if (status != VX_SUCCESS) {
+        VXLOGE("%s, querying image fails, err:%d", getSgName(), status);
+        goto EXIT;
+    }
+
+    /* intermediate rows of a band should stay in cache */
+    m_band_rows = (row_bytes != 0) ? (FUSED_BAND_BYTES / row_bytes) : m_band_height;
+    if (m_band_rows < FUSED_MIN_BAND_ROWS)
+        m_band_rows = FUSED_MIN_BAND_ROWS;
+    if (m_band_rows > m_band_height)
+        m_band_rows = m_band_height;
+
+    /* a producer computes rows of the band and the rows its consumers read around them */
+    for (strip_iter=m_strip_map.begin(); strip_iter!=m_strip_map.end(); strip_iter++) {
+        band_strip_t *strip = &strip_iter->second;
+        strip->capacity = m_band_rows + radius_sum * 2;
+        if (strip->capacity > m_band_height)
+            strip->capacity = m_band_height;
+        strip->ptr = new vx_uint8[strip->stride * strip->capacity];
+    }
+
+    VXLOGD2("%s, height:%d, band rows:%d, intermediate:%d", getSgName(), m_band_height, m_band_rows, m_strip_map.size());
+
+EXIT:
+    EXYNOS_VISION_SYSTEM_OUT();
+
+    return status;
+}
+
+void
+ExynosVisionSubgraph::releaseFusedNodeInfo(void)
+{
+    List<fused_node_info_t>::iterator info_iter;
+    for (info_iter=m_fused_node_list.begin(); info_iter!=m_fused_node_list.end(); info_iter++) {
+        delete [] (*info_iter).params;
+        delete [] (*info_iter).bands;
+    }
+    m_fused_node_list.clear();
+
+    map<ExynosVisionDataReference*, band_strip_t>::iterator strip_iter;
+    for (strip_iter=m_strip_map.begin(); strip_iter!=m_strip_map.end(); strip_iter++) {
+        if (strip_iter->second.ptr)
+            delete [] strip_iter->second.ptr;
+        strip_iter->second.ptr = NULL;
+    }
+}
+
+vx_status
+ExynosVisionSubgraph::replaceDataRef(ExynosVisionDataReference *old_ref, ExynosVisionDataReference *new_ref, ExynosVisionNode *node, vx_uint32 node_index, enum vx_direction_e dir)
 {
     EXYNOS_VISION_SYSTEM_IN();
 
@@ -183,10 +382,10 @@ ExynosVisionSubgraph::replaceDataRef(ExynosVisionDataReference *old_ref, ExynosV
         data_ref_list = &m_output_data_ref_list;
 
     for (ref_iter=data_ref_list->begin(); ref_iter!=data_ref_list->end(); ref_iter++) {
-        if (((*ref_iter).ref == old_ref) && ((*ref_iter).node_index == node_index)){
+        if (((*ref_iter).ref == old_ref) && ((*ref_iter).node == node) && ((*ref_iter).node_index == node_index)){
             ref_iter = data_ref_list->erase(ref_iter);
 
-            ref_connect_info_t connect_info = { new_ref, node_index};
+            ref_connect_info_t connect_info = { new_ref, node, node_index};
             data_ref_list->insert(ref_iter, connect_info);
             result = vx_true_e;
             break;
@@ -197,9 +396,9 @@ ExynosVisionSubgraph::replaceDataRef(ExynosVisionDataReference *old_ref, ExynosV
         VXLOGE("can't replace %s to %s at %s", old_ref->getName(), new_ref->getName(), this->getSgName());
 
         for (ref_iter=data_ref_list->begin(); ref_iter!=data_ref_list->end(); ref_iter++) {
-            VXLOGD("ref:%s, node_index:%d", (*ref_iter).ref->getName(), (*ref_iter).node_index);
+            VXLOGD("ref:%s, node:%s, node_index:%d", (*ref_iter).ref->getName(), (*ref_iter).node->getName(), (*ref_iter).node_index);
         }
-        m_represent_node->displayInfo(0, vx_true_e);
+        node->displayInfo(0, vx_true_e);
 
         status = VX_FAILURE;
     } else {
@@ -219,19 +418,24 @@ ExynosVisionSubgraph::allocateDataRefMemory(void)
 
     vx_status status = VX_SUCCESS;
 
-    /* allocation reference object memory */
-    for (vx_uint32 p = 0; p < m_represent_node->getDataRefNum(); p++) {
-        ExynosVisionDataReference *data_ref = m_represent_node->getDataRefByIndex(p);
-        if (data_ref == NULL)
-            continue;
-
-        if (data_ref->isAllocated() == vx_false_e) {
-            VXLOGD2("%s, allocating memory", data_ref->getName());
-            status = data_ref->allocateMemory();
-            if (status != VX_SUCCESS)
-                VXLOGE("data_ref(%s) allocation memory fail, error:%d", data_ref->getName(), status);
-        } else {
-            VXLOGD2("%s, memory is already allocated", data_ref->getName());
+    /* allocation reference object memory, intermediate image of fused subgraph lives in band strip */
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        ExynosVisionNode *node = *node_iter;
+
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+            if ((data_ref == NULL) || isInternalRef(data_ref))
+                continue;
+
+            if (data_ref->isAllocated() == vx_false_e) {
+                VXLOGD2("%s, allocating memory", data_ref->getName());
+                status = data_ref->allocateMemory();
+                if (status != VX_SUCCESS)
+                    VXLOGE("data_ref(%s) allocation memory fail, error:%d", data_ref->getName(), status);
+            } else {
+                VXLOGD2("%s, memory is already allocated", data_ref->getName());
+            }
         }
     }
 
@@ -257,15 +461,28 @@ ExynosVisionSubgraph::fixSubgraph(void)
         VXLOGE("allocating memory fails, err:%d", status);
     }
 
+    if (isFused()) {
+        status = makeFusedNodeInfo();
+        if (status != VX_SUCCESS) {
+            VXLOGE("making fused node info fails, err:%d", status);
+        }
+    }
+
     if (m_graph->getPerfMonitor() != NULL) {
-        m_graph->getPerfMonitor()->registerObjectForTrace(m_represent_node, NODE_TIMEPAIR_NUMBER);
+        List<ExynosVisionNode*>::iterator node_iter;
+        for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+            m_graph->getPerfMonitor()->registerObjectForTrace(*node_iter, NODE_TIMEPAIR_NUMBER);
+            m_graph->getPerfMonitor()->setTraceMode(*node_iter, m_graph->isPerfTraceEnabled());
+        }
     } else {
         VXLOGE("performance monitor is not assigned");
     }
 
     m_last_process_frame = 0;
 
-    m_message_queue = new sg_msg_queue_t(0);
+    /* a frame in flight posts at most one event per input port, and the frames in flight are
+        bounded by the slots of the pipeline and the buffers of the graph queues */
+    m_message_queue = new sg_msg_queue_t((MAX_QUEUE_RES_NUM + m_graph->getPipelineDepth()) * (m_input_data_ref_list.size() + 1), 0);
     m_main_thread = new ExynosVisionThread<ExynosVisionSubgraph>(this, &ExynosVisionSubgraph::mainThreadFunc, "subgraph", PRIORITY_DEFAULT);
     m_main_thread->run();
 
@@ -275,14 +492,15 @@ ExynosVisionSubgraph::fixSubgraph(void)
 }
 
 vx_bool
-ExynosVisionSubgraph::verifyPopedEvent(ExynosVisionDataReference *data_ref, vx_uint32 node_index)
+ExynosVisionSubgraph::verifyPopedEvent(ExynosVisionDataReference *data_ref, ExynosVisionNode *node, vx_uint32 node_index, vx_uint32 *ret_port_index)
 {
     vx_uint32 i;
     vx_bool result = vx_false_e;
 
     List<ref_connect_info_t>::iterator ref_iter;
     for (ref_iter=m_input_data_ref_list.begin(), i=0; ref_iter!=m_input_data_ref_list.end(); ref_iter++, i++) {
-        if (((*ref_iter).ref == data_ref) && ((*ref_iter).node_index == node_index)) {
+        if (((*ref_iter).ref == data_ref) && ((*ref_iter).node == node) && ((*ref_iter).node_index == node_index)) {
+            *ret_port_index = i;
             result = vx_true_e;
             break;
         }
@@ -290,8 +508,8 @@ ExynosVisionSubgraph::verifyPopedEvent(ExynosVisionDataReference *data_ref, vx_u
 
     if (result != vx_true_e) {
         VXLOGE("[%s] data reference is not found", getSgName());
-        VXLOGD("ref:%s, node_index:%d", data_ref->getName(), node_index);
-        m_represent_node->displayInfo(0, vx_true_e);
+        VXLOGD("ref:%s, node:%s, node_index:%d", data_ref->getName(), node->getName(), node_index);
+        node->displayInfo(0, vx_true_e);
 
         for (ref_iter=m_input_data_ref_list.begin(), i=0; ref_iter!=m_input_data_ref_list.end(); ref_iter++, i++)
             VXLOGD("input_list, ref:%s, node_index:%d", (*ref_iter).ref->getName(), (*ref_iter).node_index);
@@ -301,12 +519,13 @@ ExynosVisionSubgraph::verifyPopedEvent(ExynosVisionDataReference *data_ref, vx_u
 }
 
 vx_status
-ExynosVisionSubgraph::pushDoneEvent(vx_uint32 frame_cnt, ExynosVisionDataReference *ref, vx_uint32 node_index)
+ExynosVisionSubgraph::pushDoneEvent(vx_uint32 frame_cnt, ExynosVisionDataReference *ref, ExynosVisionNode *node, vx_uint32 node_index)
 {
     subgraph_message_t sg_msg;
     sg_msg.type = SG_MESSAGE_DONE_EVENT;
     sg_msg.frame_cnt = frame_cnt;
     sg_msg.done_reference = ref;
+    sg_msg.node = node;
     sg_msg.node_index = node_index;
 
     VXLOGTD("push done event: %s, frame(%d)", ref->getName(), frame_cnt);
@@ -323,6 +542,7 @@ ExynosVisionSubgraph::pushTrigger(vx_uint32 frame_cnt)
     sg_msg.type = SG_MESSAGE_TRIGGER;
     sg_msg.frame_cnt = frame_cnt;
     sg_msg.done_reference = NULL;
+    sg_msg.node = NULL;
     sg_msg.node_index = 0;
 
     VXLOGTD("push trigger:frame_%d", frame_cnt);
@@ -336,6 +556,7 @@ queue_exception_t
 ExynosVisionSubgraph::popDoneEvent(vx_uint32 *ret_frame_cnt)
 {
     vx_uint32 ready_frame_cnt = 0;
+    vx_uint32 port_index = 0;
 
     subgraph_message_t sg_msg;
     memset(&sg_msg, 0x0, sizeof(sg_msg));
@@ -363,12 +584,12 @@ ExynosVisionSubgraph::popDoneEvent(vx_uint32 *ret_frame_cnt)
         ready_frame_cnt = sg_msg.frame_cnt;
     } else {
         while(1) {
-            if (verifyPopedEvent(sg_msg.done_reference, sg_msg.node_index) != vx_true_e) {
+            if (verifyPopedEvent(sg_msg.done_reference, sg_msg.node, sg_msg.node_index, &port_index) != vx_true_e) {
                 VXLOGE("poped event doesn't match input reference information");
                 break;
             }
 
-            m_ready_bitmask_map[sg_msg.frame_cnt] |= BIT_FLAG(sg_msg.node_index);
+            m_ready_bitmask_map[sg_msg.frame_cnt] |= BIT_FLAG(port_index);
             VXLOGTD("pop done: %s, frame(%d), ready_bitmask:%p, target_bitmask:%p", sg_msg.done_reference->getName(), sg_msg.frame_cnt,
                                                                                                                                m_ready_bitmask_map[sg_msg.frame_cnt], m_target_done_bitmask);
 
@@ -414,7 +635,7 @@ ExynosVisionSubgraph::getSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
         ref_represent = (*ref_iter).ref;
         if (ref_represent == NULL) {
             /* null parameter, it could be optional parameter */
-            ref_connect_info_t connect_info = {NULL, (*ref_iter).node_index};
+            ref_connect_info_t connect_info = {NULL, (*ref_iter).node, (*ref_iter).node_index};
             m_cur_input_data_ref_list.push_back(connect_info);
             continue;
         }
@@ -427,7 +648,7 @@ ExynosVisionSubgraph::getSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
                 status = VX_ERROR_INVALID_REFERENCE;
             } else {
                 ref_clone ->increaseKernelCount();
-                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node_index};
+                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node, (*ref_iter).node_index};
                 m_cur_input_data_ref_list.push_back(connect_info);
             }
         } else {
@@ -444,7 +665,7 @@ ExynosVisionSubgraph::getSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
                 status = VX_ERROR_INVALID_REFERENCE;
             } else {
                 ref_clone ->increaseKernelCount();
-                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node_index};
+                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node, (*ref_iter).node_index};
                 m_cur_input_data_ref_list.push_back(connect_info);
             }
         }
@@ -470,7 +691,7 @@ ExynosVisionSubgraph::getDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
         ref_represent = (*ref_iter).ref;
         if (ref_represent == NULL) {
             /* null parameter, it could be optional parameter */
-            ref_connect_info_t connect_info = {NULL, (*ref_iter).node_index};
+            ref_connect_info_t connect_info = {NULL, (*ref_iter).node, (*ref_iter).node_index};
             m_cur_output_data_ref_list.push_back(connect_info);
             continue;
         }
@@ -483,7 +704,7 @@ ExynosVisionSubgraph::getDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
                 status = VX_ERROR_INVALID_REFERENCE;
             } else {
                 ref_clone ->increaseKernelCount();
-                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node_index};
+                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node, (*ref_iter).node_index};
                 m_cur_output_data_ref_list.push_back(connect_info);
             }
         } else {
@@ -500,7 +721,7 @@ ExynosVisionSubgraph::getDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
                 status = VX_ERROR_INVALID_REFERENCE;
             } else {
                 ref_clone ->increaseKernelCount();
-                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node_index};
+                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node, (*ref_iter).node_index};
                 m_cur_output_data_ref_list.push_back(connect_info);
             }
         }
@@ -518,6 +739,9 @@ ExynosVisionSubgraph::kernelProcess(vx_uint32 frame_cnt)
         VXLOGW("frame count is zero");
     }
 
+    if (isFused())
+        return fusedKernelProcess(frame_cnt);
+
     List<ref_connect_info_t>::iterator ref_iter;
     for (ref_iter=m_cur_input_data_ref_list.begin(); ref_iter!=m_cur_input_data_ref_list.end(); ref_iter++) {
         m_params[(*ref_iter).node_index] = (*ref_iter).ref;
@@ -535,6 +759,270 @@ EXIT:
     return status;
 }
 
+vx_status
+ExynosVisionSubgraph::fusedKernelProcess(vx_uint32 frame_cnt)
+{
+    vx_status status = VX_SUCCESS;
+    vx_status unmap_status;
+
+    List<ref_connect_info_t> *cur_list[2] = { &m_cur_input_data_ref_list, &m_cur_output_data_ref_list };
+    List<ref_connect_info_t>::iterator ref_iter;
+    List<fused_node_info_t>::iterator info_iter;
+
+    /* the ports are instance references of this frame, intermediate image is not changed */
+    for (vx_uint32 i = 0; i < 2; i++) {
+        for (ref_iter=cur_list[i]->begin(); ref_iter!=cur_list[i]->end(); ref_iter++) {
+            for (info_iter=m_fused_node_list.begin(); info_iter!=m_fused_node_list.end(); info_iter++) {
+                if ((*info_iter).node == (*ref_iter).node) {
+                    (*info_iter).params[(*ref_iter).node_index] = (*ref_iter).ref;
+                    break;
+                }
+            }
+        }
+    }
+
+    status = mapPorts();
+    if (status == VX_SUCCESS) {
+        for (vx_uint32 y = 0; y < m_band_height; y += m_band_rows) {
+            vx_uint32 end_y = y + m_band_rows;
+            if (end_y > m_band_height)
+                end_y = m_band_height;
+
+            computeBandRange(y, end_y);
+            status = processBand();
+            if (status != VX_SUCCESS) {
+                VXLOGE("%s, processing band fails, rows:%d~%d, frame_%d", getSgName(), y, end_y, frame_cnt);
+                break;
+            }
+        }
+    }
+
+    unmap_status = unmapPorts();
+    if (status == VX_SUCCESS)
+        status = unmap_status;
+
+    return status;
+}
+
+vx_status
+ExynosVisionSubgraph::mapPorts(void)
+{
+    vx_status status = VX_SUCCESS;
+
+    List<ref_connect_info_t> *cur_list[2] = { &m_cur_input_data_ref_list, &m_cur_output_data_ref_list };
+    vx_enum usage[2] = { VX_READ_ONLY, VX_WRITE_ONLY };
+    List<ref_connect_info_t>::iterator ref_iter;
+
+    m_port_map.clear();
+
+    for (vx_uint32 i = 0; i < 2; i++) {
+        for (ref_iter=cur_list[i]->begin(); ref_iter!=cur_list[i]->end(); ref_iter++) {
+            ExynosVisionDataReference *data_ref = (*ref_iter).ref;
+            if ((data_ref == NULL) || (data_ref->getType() != VX_TYPE_IMAGE))
+                continue;
+
+            /* a port could be connected to several nodes */
+            if (m_port_map.find(data_ref) != m_port_map.end())
+                continue;
+
+            ExynosVisionImage *image = (ExynosVisionImage*)data_ref;
+            vx_df_image format = VX_DF_IMAGE_VIRT;
+            port_mapping_t mapping;
+            memset(&mapping, 0x0, sizeof(mapping));
+
+            status |= image->getDimension(&mapping.rect.end_x, &mapping.rect.end_y);
+            status |= image->queryImage(VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format));
+            if (status != VX_SUCCESS) {
+                VXLOGE("querying %s fails, err:%d", data_ref->getName(), status);
+                goto EXIT;
+            }
+
+            /* a NULL pointer maps the image's own memory */
+            status = image->accessImagePatch(&mapping.rect, 0, &mapping.addr, &mapping.base, usage[i]);
+            if (status != VX_SUCCESS) {
+                VXLOGE("accessing %s fails, err:%d", data_ref->getName(), status);
+                goto EXIT;
+            }
+            m_port_map[data_ref] = mapping;
+
+            if ((vx_uint32)mapping.addr.stride_x != getBandPixelSize(format)) {
+                VXLOGE("%s is not supported, format:0x%x, stride_x:%d", data_ref->getName(), format, mapping.addr.stride_x);
+                status = VX_ERROR_NOT_SUPPORTED;
+                goto EXIT;
+            }
+        }
+    }
+
+EXIT:
+    return status;
+}
+
+vx_status
+ExynosVisionSubgraph::unmapPorts(void)
+{
+    vx_status status = VX_SUCCESS;
+
+    map<ExynosVisionDataReference*, port_mapping_t>::iterator port_iter;
+    for (port_iter=m_port_map.begin(); port_iter!=m_port_map.end(); port_iter++) {
+        ExynosVisionImage *image = (ExynosVisionImage*)port_iter->first;
+        port_mapping_t *mapping = &port_iter->second;
+
+        if (image->commitImagePatch(&mapping->rect, 0, &mapping->addr, mapping->base) != VX_SUCCESS) {
+            VXLOGE("committing %s fails", image->getName());
+            status = VX_FAILURE;
+        }
+    }
+    m_port_map.clear();
+
+    return status;
+}
+
+void
+ExynosVisionSubgraph::computeBandRange(vx_uint32 start_y, vx_uint32 end_y)
+{
+    map<ExynosVisionDataReference*, band_strip_t>::iterator strip_iter;
+    for (strip_iter=m_strip_map.begin(); strip_iter!=m_strip_map.end(); strip_iter++) {
+        strip_iter->second.need_start_y = m_band_height;
+        strip_iter->second.need_end_y = 0;
+    }
+
+    /* from the last node, a node computes the rows its consumers read and a band of its port */
+    List<fused_node_info_t>::iterator info_iter = m_fused_node_list.end();
+    while (info_iter != m_fused_node_list.begin()) {
+        info_iter--;
+
+        fused_node_info_t *info = &(*info_iter);
+        ExynosVisionNode *node = info->node;
+        const ExynosVisionKernel *kernel = node->getKernelHandle();
+        vx_uint32 node_start_y = m_band_height;
+        vx_uint32 node_end_y = 0;
+
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+            if ((data_ref == NULL) || (kernel->getParamDirection(p) != VX_OUTPUT))
+                continue;
+
+            vx_uint32 need_start_y = start_y;
+            vx_uint32 need_end_y = end_y;
+
+            strip_iter = m_strip_map.find(data_ref);
+            if (strip_iter != m_strip_map.end()) {
+                need_start_y = strip_iter->second.need_start_y;
+                need_end_y = strip_iter->second.need_end_y;
+            }
+
+            if (need_start_y < node_start_y)
+                node_start_y = need_start_y;
+            if (need_end_y > node_end_y)
+                node_end_y = need_end_y;
+        }
+
+        if (node_start_y >= node_end_y) {
+            info->start_y = 0;
+            info->end_y = 0;
+            continue;
+        }
+
+        info->start_y = node_start_y;
+        info->end_y = node_end_y;
+
+        vx_uint32 radius = kernel->getBandRadius();
+        vx_uint32 need_start_y = (node_start_y > radius) ? (node_start_y - radius) : 0;
+        vx_uint32 need_end_y = ((node_end_y + radius) < m_band_height) ? (node_end_y + radius) : m_band_height;
+
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+            if ((data_ref == NULL) || (kernel->getParamDirection(p) != VX_INPUT))
+                continue;
+
+            strip_iter = m_strip_map.find(data_ref);
+            if (strip_iter == m_strip_map.end())
+                continue;
+
+            band_strip_t *strip = &strip_iter->second;
+            if (need_start_y < strip->need_start_y)
+                strip->need_start_y = need_start_y;
+            if (need_end_y > strip->need_end_y)
+                strip->need_end_y = need_end_y;
+        }
+    }
+}
+
+vx_status
+ExynosVisionSubgraph::processBand(void)
+{
+    vx_status status = VX_SUCCESS;
+
+    map<ExynosVisionDataReference*, band_strip_t>::iterator strip_iter;
+    map<ExynosVisionDataReference*, port_mapping_t>::iterator port_iter;
+
+    List<fused_node_info_t>::iterator info_iter;
+    for (info_iter=m_fused_node_list.begin(); info_iter!=m_fused_node_list.end(); info_iter++) {
+        fused_node_info_t *info = &(*info_iter);
+        ExynosVisionNode *node = info->node;
+        const ExynosVisionKernel *kernel = node->getKernelHandle();
+
+        if (info->start_y >= info->end_y)
+            continue;
+
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+            if ((data_ref == NULL) || (kernel->getParamType(p) != VX_TYPE_IMAGE))
+                continue;
+
+            vx_image_band_t *band = &info->bands[p];
+            vx_bool is_output = (kernel->getParamDirection(p) == VX_OUTPUT) ? vx_true_e : vx_false_e;
+
+            strip_iter = m_strip_map.find(data_ref);
+            if (strip_iter != m_strip_map.end()) {
+                band_strip_t *strip = &strip_iter->second;
+
+                if (is_output) {
+                    if ((info->end_y - info->start_y) > strip->capacity) {
+                        VXLOGE("%s, band of %s overflows, rows:%d~%d, capacity:%d", getSgName(), data_ref->getName(),
+                                                                    info->start_y, info->end_y, strip->capacity);
+                        status = VX_ERROR_NO_RESOURCES;
+                        goto EXIT;
+                    }
+                    strip->start_y = info->start_y;
+                    strip->end_y = info->end_y;
+                }
+
+                band->ptr = strip->ptr;
+                band->stride_y = strip->stride;
+                band->start_y = strip->start_y;
+                band->end_y = strip->end_y;
+            } else {
+                port_iter = m_port_map.find(info->params[p]);
+                if (port_iter == m_port_map.end()) {
+                    VXLOGE("%s, %s is not mapped", getSgName(), data_ref->getName());
+                    status = VX_ERROR_INVALID_REFERENCE;
+                    goto EXIT;
+                }
+
+                port_mapping_t *mapping = &port_iter->second;
+                band->stride_y = mapping->addr.stride_y;
+                if (is_output) {
+                    band->ptr = (vx_uint8*)mapping->base + info->start_y * mapping->addr.stride_y;
+                    band->start_y = info->start_y;
+                    band->end_y = info->end_y;
+                } else {
+                    band->ptr = mapping->base;
+                    band->start_y = 0;
+                    band->end_y = band->height;
+                }
+            }
+        }
+
+        status = kernel->bandFunction(node, (const ExynosVisionDataReference **)info->params, node->getDataRefNum(), info->bands);
+        if (status != VX_SUCCESS)
+            break;
+    }
+
+EXIT:
+    return status;
+}
+
 vx_status
 ExynosVisionSubgraph::putSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode)
 {
@@ -645,7 +1133,9 @@ ExynosVisionSubgraph::sendDoneToPost(vx_uint32 frame_cnt)
         List<ref_connect_info_t>::iterator ref_iter;
         for (ref_iter=m_output_data_ref_list.begin(); ref_iter!=m_output_data_ref_list.end(); ref_iter++) {
             ExynosVisionDataReference *ref = (*ref_iter).ref;
-            ref->triggerDoneEventIndirect(m_graph, frame_cnt);
+            /* null parameter, it could be optional parameter */
+            if (ref != NULL)
+                ref->triggerDoneEventIndirect(m_graph, frame_cnt);
         }
     }
 
@@ -734,7 +1224,9 @@ ExynosVisionSubgraph::mainThreadFunc(void)
 
     if (frame_cnt && status == VX_SUCCESS) {
         VXLOGTD("%s, start frame_%d", getSgName(), frame_cnt);
-        m_represent_node->informKernelStart(frame_cnt);
+        List<ExynosVisionNode*>::iterator node_iter;
+        for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++)
+            (*node_iter)->informKernelStart(frame_cnt);
 
 #if (DISPLAY_PROCESS_GRAPH_TIME==1)
         uint64_t start_time, end_time;
@@ -778,13 +1270,16 @@ ExynosVisionSubgraph::mainThreadFunc(void)
             VXLOGTD("kernelProcess end");
 
             /* node call back check */
-            if (m_represent_node->m_callback) {
-                vx_action action;
-                action = m_represent_node->m_callback((vx_node)m_represent_node);
-                if (action == VX_ACTION_ABANDON) {
-                    VXLOGE("abandon graph due to callback from %s", m_represent_node->getName());
-                    status = VX_ERROR_GRAPH_ABANDONED;
-                    goto EXIT;
+            for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+                ExynosVisionNode *node = *node_iter;
+                if (node->m_callback) {
+                    vx_action action;
+                    action = node->m_callback((vx_node)node);
+                    if (action == VX_ACTION_ABANDON) {
+                        VXLOGE("abandon graph due to callback from %s", node->getName());
+                        status = VX_ERROR_GRAPH_ABANDONED;
+                        goto EXIT;
+                    }
                 }
             }
         } else {
@@ -823,7 +1318,8 @@ ExynosVisionSubgraph::mainThreadFunc(void)
         VXLOGI("[SG] %llu us", end_time - start_time);
 #endif
 
-        m_represent_node->informKernelEnd(frame_cnt, status);
+        for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++)
+            (*node_iter)->informKernelEnd(frame_cnt, status);
     }
 
 EXIT:
@@ -880,12 +1376,21 @@ ExynosVisionSubgraph::displayPerf(vx_uint32 tab_num, vx_bool detail_info)
     VXLOGI("%s[Subgrap][%d] represent node(%s, %s)", MAKE_TAB(tap, tab_num), detail_info,
         getSgName(), m_represent_node->getName(), m_represent_node->getKernelName());
 
-    vx_perf_t *vx_perf = m_graph->getPerfMonitor()->getVxPerfInfo(m_represent_node);
-    for (uint32_t i=0; i<NODE_TIMEPAIR_NUMBER; i++) {
-        VXLOGI("%s ==Set_%d, number of exec: %llu==", MAKE_TAB(tap, tab_num+1), i, vx_perf[i].num);
-        VXLOGI("%s average: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].avg/1000.0f);
-        VXLOGI("%s minimum: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].min/1000.0f);
-        VXLOGI("%s maximum: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].max/1000.0f);
+    if (isFused())
+        VXLOGI("%s fused nodes:%d, band rows:%d/%d", MAKE_TAB(tap, tab_num+1), m_node_list.size(), m_band_rows, m_band_height);
+
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        vx_perf_t *vx_perf = m_graph->getPerfMonitor()->getVxPerfInfo(*node_iter);
+
+        if (isFused())
+            VXLOGI("%s node(%s, %s)", MAKE_TAB(tap, tab_num+1), (*node_iter)->getName(), (*node_iter)->getKernelName());
+        for (uint32_t i=0; i<NODE_TIMEPAIR_NUMBER; i++) {
+            VXLOGI("%s ==Set_%d, number of exec: %llu==", MAKE_TAB(tap, tab_num+1), i, vx_perf[i].num);
+            VXLOGI("%s average: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].avg/1000.0f);
+            VXLOGI("%s minimum: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].min/1000.0f);
+            VXLOGI("%s maximum: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].max/1000.0f);
+        }
     }
 }
 
@@ -23,7 +23,7 @@
 
 #include <VX/vx.h>
 
-#include "ExynosVisionQueue.h"
+#include "ExynosVisionRingQueue.h"
 #include "ExynosVisionThread.h"
 #include "ExynosVisionEvent.h"
 #include "ExynosVisionState.h"
@@ -33,6 +33,10 @@
 
 namespace android {
 
+/* rows of intermediate images a fused subgraph keeps per band, in bytes */
+#define FUSED_BAND_BYTES        (256 * 1024)
+#define FUSED_MIN_BAND_ROWS     16
+
 enum thread_state {
     THREAD_STATE_NOT_START = 0,
 
@@ -58,18 +62,50 @@ typedef struct _subgraph_message_t {
     vx_int32		frame_cnt;
 
     ExynosVisionDataReference   *done_reference;
+    ExynosVisionNode    *node;
     vx_uint32 node_index;
 } subgraph_message_t;
 
-typedef ExynosVisionQueue<subgraph_message_t> sg_msg_queue_t;
+typedef ExynosVisionRingQueue<subgraph_message_t> sg_msg_queue_t;
 
 class ExynosVisionSubgraph {
 
 typedef struct _ref_connect_info_t {
     ExynosVisionDataReference *ref;
+    ExynosVisionNode *node;
     vx_uint32 node_index;
 } ref_connect_info_t;
 
+/* a node of fused subgraph and the parameters it is called with */
+typedef struct _fused_node_info_t {
+    ExynosVisionNode *node;
+    ExynosVisionDataReference **params;
+    vx_image_band_t *bands;
+    /* output rows of current band */
+    vx_uint32 start_y;
+    vx_uint32 end_y;
+} fused_node_info_t;
+
+/* an intermediate image of fused subgraph, only the rows of a band are kept */
+typedef struct _band_strip_t {
+    vx_uint8 *ptr;
+    vx_uint32 stride;
+    vx_uint32 capacity;
+    /* rows held, written by the producer of current band */
+    vx_uint32 start_y;
+    vx_uint32 end_y;
+    /* rows needed by the consumers of current band */
+    vx_uint32 need_start_y;
+    vx_uint32 need_end_y;
+} band_strip_t;
+
+/* whole plane of an external image, mapped during fused process */
+typedef struct _port_mapping_t {
+    vx_rectangle_t rect;
+    vx_imagepatch_addressing_t addr;
+    void *base;
+} port_mapping_t;
+
 private:
     vx_uint32 m_id;
     vx_char m_sg_name[VX_MAX_SUBGRAPH_NAME];
@@ -105,6 +141,16 @@ private:
 
     vx_uint32 m_last_process_frame;
 
+    vx_bool m_is_header;
+    vx_bool m_is_footer;
+
+    /* fused subgraph, the nodes run band by band and intermediate images are never allocated */
+    List<fused_node_info_t> m_fused_node_list;
+    map<ExynosVisionDataReference*, band_strip_t> m_strip_map;
+    map<ExynosVisionDataReference*, port_mapping_t> m_port_map;
+    vx_uint32 m_band_height;
+    vx_uint32 m_band_rows;
+
 public:
 
 private:
@@ -114,12 +160,19 @@ private:
     vx_status getSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode, vx_bool *ret_data_valid);
     vx_status getDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode);
     vx_status kernelProcess(vx_uint32 frame_cnt);
+    vx_status fusedKernelProcess(vx_uint32 frame_cnt);
+    vx_status mapPorts(void);
+    vx_status unmapPorts(void);
+    void computeBandRange(vx_uint32 start_y, vx_uint32 end_y);
+    vx_status processBand(void);
     vx_status putSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode);
     vx_status putDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode, vx_bool data_valid);
     vx_status sendDoneToPost(vx_uint32 frame_cnt);
 
     vx_status makeInputOutputPort(void);
     vx_status allocateDataRefMemory(void);
+    vx_status makeFusedNodeInfo(void);
+    void releaseFusedNodeInfo(void);
 
 public:
 
@@ -130,20 +183,36 @@ public:
     virtual ~ExynosVisionSubgraph();
 
     vx_status init(ExynosVisionNode *node);
+    vx_status addNode(ExynosVisionNode *node);
     vx_status destroy(void);
 
     vx_status fixSubgraph(void);
 
-    vx_bool verifyPopedEvent(ExynosVisionDataReference *data_ref, vx_uint32 node_index);
+    vx_bool verifyPopedEvent(ExynosVisionDataReference *data_ref, ExynosVisionNode *node, vx_uint32 node_index, vx_uint32 *ret_port_index);
 
     vx_bool isHeader(void)
     {
-        return m_represent_node->isHeader();
+        return m_is_header;
     }
     vx_bool isFooter(void)
     {
-        return m_represent_node->isFooter();
+        return m_is_footer;
+    }
+    vx_bool isFused(void)
+    {
+        return (m_node_list.size() > 1) ? vx_true_e : vx_false_e;
+    }
+    /* data reference that is produced and consumed only by the nodes of this subgraph */
+    vx_bool isInternalRef(ExynosVisionDataReference *data_ref)
+    {
+        return (m_strip_map.find(data_ref) != m_strip_map.end()) ? vx_true_e : vx_false_e;
+    }
+    List<ExynosVisionNode*>* getNodeList(void)
+    {
+        return &m_node_list;
     }
+    /* bytes per pixel of a format that band function can handle, zero if not */
+    static vx_uint32 getBandPixelSize(vx_df_image format);
     vx_uint32 getId()
     {
         return m_id;
@@ -156,7 +225,7 @@ public:
     /* push start signal to subgraph, all input data reference should be exclusive */
     vx_status pushTrigger(vx_uint32 frame_cnt);
     /* push doen event to subgraph, each input data reference send done event individually */
-    vx_status pushDoneEvent(vx_uint32 frame_cnt, ExynosVisionDataReference *ref, vx_uint32 node_index);
+    vx_status pushDoneEvent(vx_uint32 frame_cnt, ExynosVisionDataReference *ref, ExynosVisionNode *node, vx_uint32 node_index);
 
     vx_status clearSubgraphComplete(void);
     vx_status waitSubgraphComplete(vx_uint64 wait_time);
@@ -164,7 +233,7 @@ public:
     vx_status flushWaitEvent();
     vx_status exitThread();
 
-    vx_status replaceDataRef(ExynosVisionDataReference *old_ref, ExynosVisionDataReference *new_ref, vx_uint32 node_index, enum vx_direction_e dir);
+    vx_status replaceDataRef(ExynosVisionDataReference *old_ref, ExynosVisionDataReference *new_ref, ExynosVisionNode *node, vx_uint32 node_index, enum vx_direction_e dir);
 
     virtual void displayInfo(vx_uint32 tab_num, vx_bool detail_info);
     virtual void displayPerf(vx_uint32 tab_num, vx_bool detail_info);
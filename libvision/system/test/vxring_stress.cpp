@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Stress of ExynosVisionRingQueue.
+ *
+ * For every capacity from 2 to 16 and every mix of 1, 2 and 4 producers and
+ * consumers, each producer pushes its own numbered items. Consumers take
+ * turns at the blocking pop and the polling pop, and every other ring times
+ * the blocking pop out, so the rings run full and empty with sleepers on
+ * both sides.
+ * Every item has to come out exactly once, and the items of one producer in
+ * the order it pushed them. A run that does not end in time is released
+ * and fails. Exit status is the number of failed runs.
+ *
+ * usage: vxring_stress [items_per_producer]
+ */
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <log/log.h>
+
+#include "ExynosVisionRingQueue.h"
+
+using namespace android;
+
+#define STRESS_MIN_CAPACITY     2
+#define STRESS_MAX_CAPACITY     16
+#define STRESS_ITEM_SHIFT       24
+#define STRESS_END_ITEM         (~0U)
+
+/* 1ms, for the time out path of waitAndPopProcessQ() */
+#define STRESS_WAIT_TIME        (1000000ULL)
+#define STRESS_RUN_TIME_OUT_SEC (30)
+
+enum stress_pop_mode {
+    POP_MODE_WAIT,
+    POP_MODE_POLL,
+    POP_MODE_END
+};
+
+struct stress_result {
+    uint32_t popped;
+    uint32_t out_of_order;
+};
+
+/* a lost or duplicated end item leaves somebody waiting for good, release the ring then */
+struct stress_watchdog {
+    std::mutex lock;
+    std::condition_variable cond;
+    bool finished;
+    std::atomic<bool> fired;
+};
+
+static void watch(ExynosVisionRingQueue<uint32_t> *queue, stress_watchdog *watchdog)
+{
+    std::unique_lock<std::mutex> lock(watchdog->lock);
+
+    if (watchdog->cond.wait_for(lock, std::chrono::seconds(STRESS_RUN_TIME_OUT_SEC),
+                                [watchdog] { return watchdog->finished; }) == false) {
+        watchdog->fired.store(true);
+        queue->release();
+    }
+}
+
+static void produce(ExynosVisionRingQueue<uint32_t> *queue, uint32_t producer, uint32_t items)
+{
+    for (uint32_t i = 0; i < items; i++) {
+        uint32_t item = (producer << STRESS_ITEM_SHIFT) | i;
+        queue->pushProcessQ(&item);
+    }
+}
+
+static bool popItem(ExynosVisionRingQueue<uint32_t> *queue, stress_pop_mode mode, uint32_t *item,
+                    stress_watchdog *watchdog)
+{
+    queue_exception_t exception;
+
+    for (;;) {
+        if (mode == POP_MODE_POLL) {
+            if (queue->popProcessQ(item) == OK)
+                return true;
+            if (watchdog->fired.load() == true)
+                return false;
+            sched_yield();
+            continue;
+        }
+
+        exception = queue->waitAndPopProcessQ(item);
+        if (exception == QUEUE_EXCEPTION_NONE)
+            return true;
+        if (exception != QUEUE_EXCEPTION_TIME_OUT)
+            return false;
+    }
+}
+
+static void consume(ExynosVisionRingQueue<uint32_t> *queue, stress_pop_mode mode, uint32_t producer_num,
+                    std::vector<std::atomic<uint8_t> > *seen, uint32_t items, stress_watchdog *watchdog,
+                    stress_result *result)
+{
+    std::vector<int64_t> last(producer_num, -1);
+    uint32_t item;
+
+    result->popped = 0;
+    result->out_of_order = 0;
+
+    while (popItem(queue, mode, &item, watchdog) == true) {
+        if (item == STRESS_END_ITEM)
+            break;
+
+        uint32_t producer = item >> STRESS_ITEM_SHIFT;
+        uint32_t index = item & ((1U << STRESS_ITEM_SHIFT) - 1);
+
+        /* the pop positions only grow, so one consumer sees a producer in order */
+        if ((int64_t)index <= last[producer])
+            result->out_of_order++;
+        last[producer] = index;
+
+        (*seen)[producer * items + index].fetch_add(1, std::memory_order_relaxed);
+        result->popped++;
+    }
+}
+
+static bool runStress(uint32_t capacity, uint32_t producer_num, uint32_t consumer_num, uint32_t items)
+{
+    ExynosVisionRingQueue<uint32_t> queue(capacity, (capacity & 1) ? STRESS_WAIT_TIME : 0);
+    std::vector<std::atomic<uint8_t> > seen(producer_num * items);
+    std::vector<stress_result> results(consumer_num);
+    std::vector<std::thread> producers, consumers;
+    stress_watchdog watchdog;
+    uint32_t lost = 0, duplicated = 0, out_of_order = 0, popped = 0;
+
+    for (uint32_t i = 0; i < seen.size(); i++)
+        seen[i].store(0, std::memory_order_relaxed);
+
+    watchdog.finished = false;
+    watchdog.fired.store(false);
+    std::thread watchdog_thread(watch, &queue, &watchdog);
+
+    for (uint32_t i = 0; i < consumer_num; i++)
+        consumers.push_back(std::thread(consume, &queue, (stress_pop_mode)(i % POP_MODE_END),
+                                        producer_num, &seen, items, &watchdog, &results[i]));
+    for (uint32_t i = 0; i < producer_num; i++)
+        producers.push_back(std::thread(produce, &queue, i, items));
+
+    for (uint32_t i = 0; i < producer_num; i++)
+        producers[i].join();
+
+    /* behind every item in the ring order, one per consumer */
+    for (uint32_t i = 0; i < consumer_num; i++) {
+        uint32_t item = STRESS_END_ITEM;
+        queue.pushProcessQ(&item);
+    }
+
+    for (uint32_t i = 0; i < consumer_num; i++) {
+        consumers[i].join();
+        popped += results[i].popped;
+        out_of_order += results[i].out_of_order;
+    }
+
+    watchdog.lock.lock();
+    watchdog.finished = true;
+    watchdog.lock.unlock();
+    watchdog.cond.notify_one();
+    watchdog_thread.join();
+
+    for (uint32_t i = 0; i < seen.size(); i++) {
+        uint8_t count = seen[i].load(std::memory_order_relaxed);
+        if (count == 0)
+            lost++;
+        else if (count > 1)
+            duplicated += count - 1;
+    }
+
+    if ((watchdog.fired.load() == true) || (lost != 0) || (duplicated != 0) || (out_of_order != 0)
+        || (queue.getRemainedMsgNum() != 0)) {
+        printf("FAIL capacity:%u producers:%u consumers:%u popped:%u lost:%u duplicated:%u out of order:%u remained:%u%s\n",
+                capacity, producer_num, consumer_num, popped, lost, duplicated, out_of_order, queue.getRemainedMsgNum(),
+                (watchdog.fired.load() == true) ? ", timed out" : "");
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    static const uint32_t thread_nums[] = { 1, 2, 4 };
+    uint32_t items = (argc > 1) ? strtoul(argv[1], NULL, 0) : 20000;
+    uint32_t runs = 0, failed = 0;
+
+    if ((items == 0) || (items >= (1U << STRESS_ITEM_SHIFT))) {
+        fprintf(stderr, "usage: %s [items_per_producer]\n", argv[0]);
+        return 1;
+    }
+
+    for (uint32_t capacity = STRESS_MIN_CAPACITY; capacity <= STRESS_MAX_CAPACITY; capacity++) {
+        for (uint32_t p = 0; p < sizeof(thread_nums) / sizeof(thread_nums[0]); p++) {
+            for (uint32_t c = 0; c < sizeof(thread_nums) / sizeof(thread_nums[0]); c++) {
+                if (runStress(capacity, thread_nums[p], thread_nums[c], items) == false)
+                    failed++;
+                runs++;
+            }
+        }
+    }
+
+    printf("%u runs of %u items per producer, %u failed\n", runs, items, failed);
+
+    return failed;
+}
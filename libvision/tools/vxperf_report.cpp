@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Summary of a graph trace taken with VX_GRAPH_ATTRIBUTE_PERF_TRACE_JSON.
+ *
+ * The trace itself opens in chrome://tracing or Perfetto. This prints the
+ * p50/p95/p99 time of every node and subgraph, the bytes a node moves per
+ * frame and the bandwidth it achieves. Given the peak bandwidth of the
+ * device, nodes that come close to it are marked bandwidth-bound, the
+ * others compute-bound. It needs no framework, so it builds on a host:
+ *
+ *   g++ -std=c++14 -O2 -I../system -o vxperf_report vxperf_report.cpp
+ *
+ * usage: vxperf_report [-b peak_GB/s] trace.json
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ExynosVisionPerfReport.h"
+
+/* a node achieving this share of the peak bandwidth is bandwidth-bound */
+#define BANDWIDTH_BOUND_RATIO   0.7f
+
+struct trace_event {
+    std::string name;
+    std::string cat;
+    uint64_t dur;
+    uint64_t read_bytes;
+    uint64_t write_bytes;
+};
+
+struct event_group {
+    std::vector<uint64_t> durations;
+    uint64_t read_bytes;
+    uint64_t write_bytes;
+};
+
+/* the exporter writes one event per line with fixed keys, see ExynosVisionGraph::exportPerfTrace() */
+static bool findString(const char *line, const char *key, std::string *value)
+{
+    const char *pos = strstr(line, key);
+    const char *end;
+
+    if (pos == NULL)
+        return false;
+
+    pos += strlen(key);
+    end = strchr(pos, '"');
+    if (end == NULL)
+        return false;
+
+    value->assign(pos, end - pos);
+    return true;
+}
+
+static uint64_t findNumber(const char *line, const char *key)
+{
+    const char *pos = strstr(line, key);
+
+    if (pos == NULL)
+        return 0;
+
+    return strtoull(pos + strlen(key), NULL, 10);
+}
+
+static bool parseEvent(const char *line, trace_event *event)
+{
+    if (strstr(line, "\"ph\":\"X\"") == NULL)
+        return false;
+
+    if (!findString(line, "\"name\":\"", &event->name) || !findString(line, "\"cat\":\"", &event->cat))
+        return false;
+
+    event->dur = findNumber(line, "\"dur\":");
+    event->read_bytes = findNumber(line, "\"read_bytes\":");
+    event->write_bytes = findNumber(line, "\"write_bytes\":");
+
+    return true;
+}
+
+static void printGroups(const char *title, std::map<std::string, event_group> *groups, bool with_bytes, float peak_gbps)
+{
+    std::map<std::string, event_group>::iterator iter;
+
+    if (groups->empty())
+        return;
+
+    printf("\n%s\n", title);
+    printf("%-32s %6s %10s %10s %10s", "name", "num", "p50(us)", "p95(us)", "p99(us)");
+    if (with_bytes)
+        printf(" %12s %12s %8s %s", "read(B)", "write(B)", "GB/s", peak_gbps > 0.0f ? "bound" : "");
+    printf("\n");
+
+    for (iter = groups->begin(); iter != groups->end(); iter++) {
+        event_group *group = &iter->second;
+        std::vector<uint64_t> *durations = &group->durations;
+
+        std::sort(durations->begin(), durations->end());
+        uint64_t p50 = perfPercentile(&(*durations)[0], durations->size(), 50);
+        uint64_t p95 = perfPercentile(&(*durations)[0], durations->size(), 95);
+        uint64_t p99 = perfPercentile(&(*durations)[0], durations->size(), 99);
+
+        printf("%-32s %6zu %10llu %10llu %10llu", iter->first.c_str(), durations->size(),
+                (unsigned long long)p50, (unsigned long long)p95, (unsigned long long)p99);
+
+        if (with_bytes) {
+            float gbps = perfGbps(group->read_bytes + group->write_bytes, p50);
+
+            printf(" %12llu %12llu %8.2f", (unsigned long long)group->read_bytes,
+                    (unsigned long long)group->write_bytes, gbps);
+            if (peak_gbps > 0.0f)
+                printf(" %s", (gbps >= peak_gbps * BANDWIDTH_BOUND_RATIO) ? "bandwidth" : "compute");
+        }
+        printf("\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::map<std::string, event_group> graphs, subgraphs, nodes;
+    std::string slowest;
+    uint64_t slowest_p50 = 0;
+    float peak_gbps = 0.0f;
+    char line[4096];
+    FILE *fp;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:")) != -1) {
+        switch (opt) {
+        case 'b':
+            peak_gbps = strtof(optarg, NULL);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-b peak_GB/s] trace.json\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-b peak_GB/s] trace.json\n", argv[0]);
+        return 1;
+    }
+
+    fp = fopen(argv[optind], "r");
+    if (fp == NULL) {
+        fprintf(stderr, "cannot open %s\n", argv[optind]);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        trace_event event;
+        event_group *group;
+
+        if (!parseEvent(line, &event))
+            continue;
+
+        if (event.cat == PERF_TRACE_CAT_NODE)
+            group = &nodes[event.name];
+        else if (event.cat == PERF_TRACE_CAT_SUBGRAPH)
+            group = &subgraphs[event.name];
+        else if (event.cat == PERF_TRACE_CAT_GRAPH)
+            group = &graphs[event.name];
+        else
+            continue;
+
+        group->durations.push_back(event.dur);
+        group->read_bytes = event.read_bytes;
+        group->write_bytes = event.write_bytes;
+    }
+    fclose(fp);
+
+    if (nodes.empty()) {
+        fprintf(stderr, "no node event in %s, is the graph in trace mode?\n", argv[optind]);
+        return 1;
+    }
+
+    printGroups("graph", &graphs, false, peak_gbps);
+    printGroups("subgraph", &subgraphs, false, peak_gbps);
+    printGroups("node", &nodes, true, peak_gbps);
+
+    /* a stream graph runs as fast as its slowest subgraph */
+    std::map<std::string, event_group>::iterator iter;
+    for (iter = subgraphs.begin(); iter != subgraphs.end(); iter++) {
+        std::vector<uint64_t> *durations = &iter->second.durations;
+        uint64_t p50 = perfPercentile(&(*durations)[0], durations->size(), 50);
+
+        if (p50 > slowest_p50) {
+            slowest_p50 = p50;
+            slowest = iter->first;
+        }
+    }
+
+    if (slowest_p50 != 0)
+        printf("\nslowest subgraph: %s, %llu us, up to %.1f frames/s in stream mode\n", slowest.c_str(),
+                (unsigned long long)slowest_p50, 1000000.0 / slowest_p50);
+
+    return 0;
+}
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Frame rate of a stream graph per VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH.
+ *
+ * The graph is a chain of box 3x3 nodes on the cpu target between an input
+ * and an output queue image, with a virtual image between each two nodes.
+ * For every depth from 1 to MAX_SLOT_NUM, the graph is built again and fed
+ * with depth + 1 frames in flight : a frame is pushed as soon as the output
+ * of an older one pops. The frames per second and the mean time a frame
+ * spends in the graph are printed per depth.
+ *
+ * usage: vxstream_fps [-w width] [-h height] [-n nodes] [-f frames]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include <VX/vx.h>
+
+/* MAX_SLOT_NUM of the framework */
+#define STREAM_MAX_DEPTH    8
+#define STREAM_WARM_UP      8
+
+struct stream_result {
+    double fps;
+    double latency_ms;
+};
+
+static double getTimeMs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static vx_status pushFrame(vx_image input, vx_image output, vx_uint32 index,
+                           std::vector<vx_uint8> *in_buf, std::vector<vx_uint8> *out_buf)
+{
+    void *in_ptr = &(*in_buf)[0];
+    void *out_ptr = &(*out_buf)[0];
+    vx_status status;
+
+    /* the output buffer has to be there before the last node writes it */
+    status = vxPushImagePatch(output, index, &out_ptr, 1);
+    if (status == VX_SUCCESS)
+        status = vxPushImagePatch(input, index, &in_ptr, 1);
+
+    return status;
+}
+
+static vx_status popFrame(vx_image input, vx_image output, vx_uint32 *ret_index)
+{
+    vx_uint32 in_index;
+    vx_bool data_valid;
+    vx_status status;
+
+    status = vxPopImage(output, ret_index, &data_valid);
+    if ((status == VX_SUCCESS) && (data_valid == vx_false_e)) {
+        fprintf(stderr, "frame %u is not valid\n", *ret_index);
+        status = VX_FAILURE;
+    }
+
+    /* the input buffer of the frame comes back as well */
+    if (status == VX_SUCCESS)
+        status = vxPopImage(input, &in_index, &data_valid);
+
+    return status;
+}
+
+static vx_status runStream(vx_context context, vx_uint32 depth, vx_uint32 width, vx_uint32 height,
+                           vx_uint32 node_num, vx_uint32 frame_num, stream_result *result)
+{
+    vx_uint32 inflight = depth + 1;
+    std::vector<std::vector<vx_uint8> > in_bufs(inflight, std::vector<vx_uint8>(width * height, 0x80));
+    std::vector<std::vector<vx_uint8> > out_bufs(inflight, std::vector<vx_uint8>(width * height));
+    std::vector<double> push_time(inflight);
+    std::vector<vx_image> images(node_num + 1, (vx_image)NULL);
+    vx_graph graph;
+    vx_status status;
+    vx_uint32 index, i;
+    double start = 0, latency_sum = 0;
+
+    graph = vxCreateGraph(context);
+    status = vxGetStatus((vx_reference)graph);
+    if (status != VX_SUCCESS)
+        return status;
+
+    status = vxHint((vx_reference)graph, VX_HINT_STREAM);
+    if (status == VX_SUCCESS)
+        status = vxSetGraphAttribute(graph, VX_GRAPH_ATTRIBUTE_PIPELINE_DEPTH, &depth, sizeof(depth));
+    if (status != VX_SUCCESS)
+        goto EXIT;
+
+    images[0] = vxCreateImageFromQueue(graph, width, height, VX_DF_IMAGE_U8);
+    images[node_num] = vxCreateImageFromQueue(graph, width, height, VX_DF_IMAGE_U8);
+    for (i = 1; i < node_num; i++)
+        images[i] = vxCreateVirtualImage(graph, width, height, VX_DF_IMAGE_U8);
+
+    for (i = 0; i < node_num; i++) {
+        vx_node node = vxBox3x3Node(graph, images[i], images[i + 1]);
+        status = vxGetStatus((vx_reference)node);
+        if (status != VX_SUCCESS) {
+            fprintf(stderr, "creating node %u fails, err:%d\n", i, status);
+            goto EXIT;
+        }
+
+        status = vxSetNodeTarget(node, VX_TARGET_CPU, NULL);
+        vxReleaseNode(&node);
+        if (status != VX_SUCCESS)
+            goto EXIT;
+    }
+
+    status = vxVerifyGraph(graph);
+    if (status != VX_SUCCESS) {
+        fprintf(stderr, "verifying graph fails, err:%d\n", status);
+        goto EXIT;
+    }
+
+    for (i = 0; i < STREAM_WARM_UP + frame_num; i++) {
+        if (i >= inflight) {
+            status = popFrame(images[0], images[node_num], &index);
+            if (status != VX_SUCCESS)
+                break;
+
+            if (i > STREAM_WARM_UP + inflight)
+                latency_sum += getTimeMs() - push_time[index];
+        }
+
+        if (i == STREAM_WARM_UP)
+            start = getTimeMs();
+
+        index = i % inflight;
+        push_time[index] = getTimeMs();
+        status = pushFrame(images[0], images[node_num], index, &in_bufs[index], &out_bufs[index]);
+        if (status != VX_SUCCESS)
+            break;
+    }
+
+    for (i = 0; (status == VX_SUCCESS) && (i < inflight); i++)
+        status = popFrame(images[0], images[node_num], &index);
+
+    if (status == VX_SUCCESS) {
+        result->fps = frame_num * 1000.0 / (getTimeMs() - start);
+        result->latency_ms = latency_sum / (frame_num - inflight - 1);
+    }
+
+EXIT:
+    for (i = 0; i <= node_num; i++) {
+        if (images[i] != NULL)
+            vxReleaseImage(&images[i]);
+    }
+    vxReleaseGraph(&graph);
+
+    return status;
+}
+
+int main(int argc, char **argv)
+{
+    vx_uint32 width = 1920, height = 1080;
+    vx_uint32 node_num = 4, frame_num = 300;
+    stream_result result;
+    vx_context context;
+    int opt, failed = 0;
+
+    while ((opt = getopt(argc, argv, "w:h:n:f:")) != -1) {
+        switch (opt) {
+        case 'w':
+            width = strtoul(optarg, NULL, 0);
+            break;
+        case 'h':
+            height = strtoul(optarg, NULL, 0);
+            break;
+        case 'n':
+            node_num = strtoul(optarg, NULL, 0);
+            break;
+        case 'f':
+            frame_num = strtoul(optarg, NULL, 0);
+            break;
+        default:
+            width = 0;
+            break;
+        }
+    }
+
+    if ((width < 3) || (height < 3) || (node_num == 0) || (frame_num <= STREAM_MAX_DEPTH + 2)) {
+        fprintf(stderr, "usage: %s [-w width] [-h height] [-n nodes] [-f frames]\n", argv[0]);
+        return 1;
+    }
+
+    context = vxCreateContext();
+    if (vxGetStatus((vx_reference)context) != VX_SUCCESS) {
+        fprintf(stderr, "creating context fails\n");
+        return 1;
+    }
+
+    printf("%ux%u, %u nodes, %u frames\n", width, height, node_num, frame_num);
+    printf("%6s %10s %12s\n", "depth", "fps", "latency(ms)");
+    for (vx_uint32 depth = 1; depth <= STREAM_MAX_DEPTH; depth++) {
+        vx_status status = runStream(context, depth, width, height, node_num, frame_num, &result);
+        if (status != VX_SUCCESS) {
+            printf("%6u failed, err:%d\n", depth, status);
+            failed++;
+            continue;
+        }
+
+        printf("%6u %10.1f %12.2f\n", depth, result.fps, result.latency_ms);
+    }
+
+    vxReleaseContext(&context);
+
+    return failed;
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2013-2022 TRUSTONIC LIMITED
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the TRUSTONIC LIMITED nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TLCKEYMINT_BULK_H
+#define TLCKEYMINT_BULK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "MobiCoreDriverApi.h"
+#include "keymint_ta_defs.h"
+
+/**
+ * Maximum size of buffer to process internally in an update() operation.
+ *
+ * Longer messages are split up into chunks this size.
+ */
+#define INPUT_CHUNK_SIZE (4096*4)
+
+/**
+ * Size of the output window.  The output of a chunk is at most the chunk
+ * plus a block held back from before; the last chunk also carries the tail
+ * of the operation (padding, tag or signature).
+ */
+#define BULK_OUTPUT_SIZE (INPUT_CHUNK_SIZE + 4096)
+
+/**
+ * Bulk buffers of a session, mapped into the TA once for the lifetime of the
+ * session rather than once per chunk.
+ *
+ * The pool is a single mapping holding two input windows and one output
+ * window.  The input windows take turns: while the TA works on the chunk in
+ * one of them, the next chunk is copied into the other.
+ *
+ * If the pool can't be set up, @c buf is NULL and the callers fall back to
+ * mapping a copy of each chunk.
+ */
+struct bulk_pool {
+    uint8_t             *buf;           /**< page aligned, or NULL */
+    uint32_t            size;
+    mcBulkMap_t         map;            /**< the whole pool */
+    unsigned            current;        /**< input window given to the TA last */
+    const uint8_t       *next;          /**< chunk to fill in while the TA works */
+    uint32_t            next_length;
+    const uint8_t       *filled;        /**< chunk already in the spare window */
+    uint32_t            filled_length;
+};
+
+/**
+ * Allocate the pool and map it into the session.
+ *
+ * @return KM_ERROR_OK or error; @p pool is unusable (but safe to close) on
+ *   error
+ */
+keymaster_error_t bulk_pool_open(
+    mcSessionHandle_t *session_handle,
+    struct bulk_pool *pool);
+
+/**
+ * Unmap and free the pool.  Must be called before the session is closed.
+ */
+void bulk_pool_close(
+    mcSessionHandle_t *session_handle,
+    struct bulk_pool *pool);
+
+/**
+ * Put a chunk of input into the next input window.
+ *
+ * The copy is skipped if bulk_pool_prefetch() already filled in the same
+ * chunk.
+ *
+ * @param[out] map mapping of the chunk, to pass to the TA
+ *
+ * @return true, or false if the pool can't take the chunk (no pool, or the
+ *   chunk is too big) and the caller has to map it itself
+ */
+bool bulk_pool_input(
+    struct bulk_pool *pool,
+    const uint8_t *data, uint32_t length,
+    mcBulkMap_t *map);
+
+/**
+ * Get the output window for @p length bytes of output, cleared.  The TA's
+ * output is at bulk_pool_output_data() afterwards.
+ *
+ * @return true, or false if the caller has to map its output itself
+ */
+bool bulk_pool_output(
+    struct bulk_pool *pool,
+    uint32_t length,
+    mcBulkMap_t *map);
+
+const uint8_t *bulk_pool_output_data(
+    const struct bulk_pool *pool);
+
+/**
+ * Name the chunk to submit after the current one, expecting the TA to take
+ * all of the current one.  bulk_pool_prefetch() copies it in.
+ */
+void bulk_pool_set_next(
+    struct bulk_pool *pool,
+    const uint8_t *data, uint32_t length);
+
+/**
+ * Copy the chunk named by bulk_pool_set_next() into the spare input window.
+ * Called while the TA works on the current chunk.
+ */
+void bulk_pool_prefetch(
+    struct bulk_pool *pool);
+
+/**
+ * Forget any prefetched input.  The caller's buffer may be reused with
+ * different contents once a request is done.
+ */
+void bulk_pool_reset(
+    struct bulk_pool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TLCKEYMINT_BULK_H */
@@ -40,6 +40,7 @@ extern "C" {
 #include <stdbool.h>
 #include "MobiCoreDriverApi.h"
 #include "TAKeymint_Api.h"
+#include "tlcKeymint_bulk.h"
 
 typedef void *TEE_SessionHandle;
 
@@ -84,6 +85,7 @@ struct TEE_Session {
     mcSessionHandle_t   sessionHandle;
     struct operation    op[MAX_OPERATION_NUM];
     unsigned            live_ops;
+    struct bulk_pool    bulk;
 };
 
 /**
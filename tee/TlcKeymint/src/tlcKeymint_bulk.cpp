@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2013-2022 TRUSTONIC LIMITED
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the TRUSTONIC LIMITED nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "tlcKeymint_bulk.h"
+#include "km_shared_util.h"
+
+/* Window layout: input 0, input 1, output. */
+#define BULK_INPUT_OFFSET(i) ((i) * INPUT_CHUNK_SIZE)
+#define BULK_OUTPUT_OFFSET BULK_INPUT_OFFSET(2)
+
+/**
+ * Mapping of part of the pool.
+ */
+static void bulk_window_map(
+    const struct bulk_pool *pool,
+    uint32_t offset, uint32_t length,
+    mcBulkMap_t *map)
+{
+#if ( __WORDSIZE == 64 )
+    map->sVirtualAddr = pool->map.sVirtualAddr + offset;
+#else
+    map->sVirtualAddr = (uint8_t *)pool->map.sVirtualAddr + offset;
+#endif
+    map->sVirtualLen = length;
+}
+
+keymaster_error_t bulk_pool_open(
+    mcSessionHandle_t *session_handle,
+    struct bulk_pool *pool)
+{
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = BULK_OUTPUT_OFFSET + BULK_OUTPUT_SIZE;
+    mcResult_t mcRet;
+    void *buf;
+
+    memset(pool, 0, sizeof(*pool));
+
+    size = (size + page_size - 1) & ~(page_size - 1);
+    buf = mmap(NULL, size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf == MAP_FAILED) {
+        LOG_E("%s: mmap(%zu) failed: %s", __func__, size, strerror(errno));
+        return KM_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+
+    mcRet = mcMap(session_handle, buf, (uint32_t)size, &pool->map);
+    if (mcRet != MC_DRV_OK) {
+        LOG_E("%s: mcMap() returned 0x%08x", __func__, mcRet);
+        munmap(buf, size);
+        memset(&pool->map, 0, sizeof(pool->map));
+        return KM_ERROR_SECURE_HW_COMMUNICATION_FAILED;
+    }
+
+    pool->buf = (uint8_t *)buf;
+    pool->size = (uint32_t)size;
+    LOG_D("%s: %u bytes mapped", __func__, pool->size);
+    return KM_ERROR_OK;
+}
+
+void bulk_pool_close(
+    mcSessionHandle_t *session_handle,
+    struct bulk_pool *pool)
+{
+    mcResult_t mcRet;
+
+    if (pool->buf == NULL)
+        return;
+
+    mcRet = mcUnmap(session_handle, pool->buf, &pool->map);
+    if (mcRet != MC_DRV_OK) {
+        LOG_E("%s: mcUnmap() returned 0x%08x", __func__, mcRet);
+    }
+    munmap(pool->buf, pool->size);
+    memset(pool, 0, sizeof(*pool));
+}
+
+bool bulk_pool_input(
+    struct bulk_pool *pool,
+    const uint8_t *data, uint32_t length,
+    mcBulkMap_t *map)
+{
+    unsigned window;
+
+    if (pool->buf == NULL || length > INPUT_CHUNK_SIZE)
+        return false;
+
+    /* The TA has finished with the current window, but the spare one may
+     * already hold this chunk.
+     */
+    window = pool->current ^ 1;
+    if (pool->filled != data || pool->filled_length != length)
+        memcpy(pool->buf + BULK_INPUT_OFFSET(window), data, length);
+
+    pool->current = window;
+    pool->next = NULL;
+    pool->filled = NULL;
+    bulk_window_map(pool, BULK_INPUT_OFFSET(window), length, map);
+    return true;
+}
+
+bool bulk_pool_output(
+    struct bulk_pool *pool,
+    uint32_t length,
+    mcBulkMap_t *map)
+{
+    if (pool->buf == NULL || length > BULK_OUTPUT_SIZE)
+        return false;
+
+    /* Same as mapping an empty buffer: nothing. */
+    if (length == 0) {
+        memset(map, 0, sizeof(*map));
+        return true;
+    }
+
+    /* The window still holds the output of the last chunk, which may be of
+     * another operation: the TA must not see it.
+     */
+    memset(pool->buf + BULK_OUTPUT_OFFSET, 0, length);
+    bulk_window_map(pool, BULK_OUTPUT_OFFSET, length, map);
+    return true;
+}
+
+const uint8_t *bulk_pool_output_data(
+    const struct bulk_pool *pool)
+{
+    return pool->buf + BULK_OUTPUT_OFFSET;
+}
+
+void bulk_pool_set_next(
+    struct bulk_pool *pool,
+    const uint8_t *data, uint32_t length)
+{
+    if (pool->buf == NULL || length == 0 || length > INPUT_CHUNK_SIZE) {
+        pool->next = NULL;
+        return;
+    }
+
+    pool->next = data;
+    pool->next_length = length;
+}
+
+void bulk_pool_prefetch(
+    struct bulk_pool *pool)
+{
+    if (pool->next == NULL)
+        return;
+
+    memcpy(pool->buf + BULK_INPUT_OFFSET(pool->current ^ 1),
+        pool->next, pool->next_length);
+    pool->filled = pool->next;
+    pool->filled_length = pool->next_length;
+    pool->next = NULL;
+}
+
+void bulk_pool_reset(
+    struct bulk_pool *pool)
+{
+    pool->next = NULL;
+    pool->filled = NULL;
+}
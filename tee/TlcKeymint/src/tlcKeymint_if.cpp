@@ -522,10 +522,14 @@ void unmap_buffer(
 
 /**
  * Notify the trusted application and wait for response.
+ *
+ * If @p pool is not NULL, the next chunk of input is copied into it while
+ * the TA works on this one.
  */
-keymaster_error_t transact(
+static keymaster_error_t transact_prefetch(
     mcSessionHandle_t* session_handle,
-    tciMessage_ptr tci)
+    tciMessage_ptr tci,
+    struct bulk_pool *pool)
 {
     keymaster_error_t ret = KM_ERROR_OK;
     mcResult_t mcRet;
@@ -537,6 +541,10 @@ keymaster_error_t transact(
         goto end;
     }
 
+    if (pool != NULL) {
+        bulk_pool_prefetch(pool);
+    }
+
     mcRet = mcWaitNotification(session_handle, MC_INFINITE_TIMEOUT);
     if (mcRet != MC_DRV_OK) {
         LOG_E("%s: mcWaitNotification() returned 0x%08x", __func__, mcRet);
@@ -550,6 +558,16 @@ end:
     return ret;
 }
 
+/**
+ * Notify the trusted application and wait for response.
+ */
+keymaster_error_t transact(
+    mcSessionHandle_t* session_handle,
+    tciMessage_ptr tci)
+{
+    return transact_prefetch(session_handle, tci, NULL);
+}
+
 /**
  * Find the operation record given the handle.
  */
@@ -766,6 +784,11 @@ int TEE_Open(TEE_SessionHandle *pSessionHandle)
     }
     *pSessionHandle = (TEE_SessionHandle)session;
 
+    /* Not fatal: without the pool, chunks are mapped one at a time. */
+    if (bulk_pool_open(&session->sessionHandle, &session->bulk) != KM_ERROR_OK) {
+        LOG_E("%s: No bulk buffer pool", __func__);
+    }
+
     /* No operations in progress yet. */
     for (i = 0; i < MAX_OPERATION_NUM; i++)
         session->op[i].live = false;
@@ -810,6 +833,8 @@ void TEE_Close(TEE_SessionHandle sessionHandle)
     }
     struct TEE_Session *session = (struct TEE_Session *)sessionHandle;
 
+    bulk_pool_close(&session->sessionHandle, &session->bulk);
+
     (void)TEE_CloseSession(session);
 
     /* Close session */
@@ -1975,13 +2000,6 @@ end:
     return ret;
 }
 
-/**
- * Maximum size of buffer to process internally in an update() operation.
- *
- * Longer messages are split up into chunks this size.
- */
-#define INPUT_CHUNK_SIZE 4096*4
-
 /**
  * Process a chunk of input to an operation.
  *
@@ -2023,7 +2041,7 @@ static keymaster_error_t update_chunk(
         memcpy(tci->update.auth_mac, auth_token->mac.data, 32);
     }
 
-    CHECK_RESULT_OK( transact(session_handle, tci) );
+    CHECK_RESULT_OK( transact_prefetch(session_handle, tci, &session->bulk) );
 
     *input_consumed_r = tci->update.input_consumed;
     *output_used_r = tci->update.output.data_length;
@@ -2081,7 +2099,7 @@ static keymaster_error_t final_chunk(
         memcpy(tci->finish.auth_mac, auth_token->mac.data, 32);
     }
 
-    CHECK_RESULT_OK( transact(session_handle, tci) );
+    CHECK_RESULT_OK( transact_prefetch(session_handle, tci, &session->bulk) );
 
     *input_consumed_r = input_map->sVirtualLen;
     *output_used_r = tci->finish.output.data_length;
@@ -2136,7 +2154,10 @@ typedef keymaster_error_t chunk_submit_func(
  * @p submit_last function.
  *
  * This function takes responsibility for setting up the necessary shared-memory
- * mappings.
+ * mappings.  Chunks go through the session's bulk pool, which is mapped
+ * already; the next chunk is copied in while the TA processes this one.  A
+ * chunk the pool can't take is mapped on its own, as is the caller's output
+ * buffer if it's too big for the pool's output window.
  */
 static keymaster_error_t split_update_chunks(
     struct TEE_Session *session, const struct operation *op,
@@ -2149,11 +2170,14 @@ static keymaster_error_t split_update_chunks(
 {
     keymaster_error_t ret = KM_ERROR_OK;
     mcSessionHandle_t *session_handle = &session->sessionHandle;
+    struct bulk_pool *pool = &session->bulk;
     const uint8_t *inp, *inp_limit;
     uint8_t *output_window = NULL;
     mcBulkMap_t input_map = { 0, 0 };
     mcBulkMap_t output_map = { 0, 0 };
     scoped_buf_ptr_t input_window;
+    bool input_pooled = false;
+    bool output_pooled = false;
 
     LOG_D("split_update_chunks");
 
@@ -2171,6 +2195,7 @@ static keymaster_error_t split_update_chunks(
     while (at_least_one || inp) {
         bool maybe_last_time = true;
         size_t budget = INPUT_CHUNK_SIZE;
+        size_t input_size = 0;
 
         at_least_one = false;
 
@@ -2179,7 +2204,10 @@ static keymaster_error_t split_update_chunks(
          * last time hanging around.  If we're using up the last of our input
          * then switch in the other submit function.
          */
-        unmap_buffer(session_handle, input_window.buf.get(), &input_map);
+        if (!input_pooled)
+            unmap_buffer(session_handle, input_window.buf.get(), &input_map);
+        memset(&input_map, 0, sizeof(input_map));
+        input_pooled = false;
         if (inp && budget) {
             size_t n = inp_limit - inp;
             if (n > budget) {
@@ -2187,9 +2215,23 @@ static keymaster_error_t split_update_chunks(
                 maybe_last_time = false;
             }
             budget -= n;
-            CHECK_RESULT_OK(copy_to_scoped_buf(inp, n, input_window));
-            CHECK_RESULT_OK(map_buffer(session_handle,
-                input_window.buf.get(), n, &input_map));
+            input_size = n;
+            if (bulk_pool_input(pool, inp, n, &input_map)) {
+                input_pooled = true;
+            } else {
+                CHECK_RESULT_OK(copy_to_scoped_buf(inp, n, input_window));
+                CHECK_RESULT_OK(map_buffer(session_handle,
+                    input_window.buf.get(), n, &input_map));
+            }
+
+            /* The TA normally takes the whole chunk, so the next one starts
+             * right after it.  If it doesn't, the guess is just not used.
+             */
+            if (!maybe_last_time) {
+                size_t next = inp_limit - (inp + n);
+                if (next > INPUT_CHUNK_SIZE) next = INPUT_CHUNK_SIZE;
+                bulk_pool_set_next(pool, inp + n, next);
+            }
         }
 
         /* Finally, arrange some output.  There are two interesting cases.
@@ -2203,16 +2245,23 @@ static keymaster_error_t split_update_chunks(
          * should hand over the whole of the caller's output buffer because
          * it was presumably provided for some good reason.
          */
-        unmap_buffer(session_handle, output_window, &output_map);
+        if (!output_pooled)
+            unmap_buffer(session_handle, output_window, &output_map);
+        memset(&output_map, 0, sizeof(output_map));
+        output_pooled = false;
         if (output) {
             size_t n = output_limit - output;
             if (!maybe_last_time) {
-                size_t avail = input_window.size + 16;
+                size_t avail = input_size + 16;
                 if (n > avail) n = avail;
             }
             output_window = output;
-            CHECK_RESULT_OK(map_buffer(session_handle,
-                output_window, n, &output_map));
+            if (bulk_pool_output(pool, n, &output_map)) {
+                output_pooled = true;
+            } else {
+                CHECK_RESULT_OK(map_buffer(session_handle,
+                    output_window, n, &output_map));
+            }
         }
 
         /* Push the next chunk through the machinery.  At this point,
@@ -2226,6 +2275,13 @@ static keymaster_error_t split_update_chunks(
             auth_token,
             ctx));
 
+        /* The TA wrote into the pool; hand the output over. */
+        if (output_pooled && output_used) {
+            CHECK_TRUE(KM_ERROR_UNKNOWN_ERROR,
+                output_used <= output_map.sVirtualLen);
+            memcpy(output, bulk_pool_output_data(pool), output_used);
+        }
+
         /* Advance the input.  (There doesn't seem to be a way for us to
          * refuse to accept some of the AAD.)
          */
@@ -2245,8 +2301,12 @@ static keymaster_error_t split_update_chunks(
     }
 
 end:
-    unmap_buffer(session_handle, input_window.buf.get(), &input_map);
-    unmap_buffer(session_handle, output_window, &output_map);
+    /* Nothing prefetched may outlive the caller's input. */
+    bulk_pool_reset(pool);
+    if (!input_pooled)
+        unmap_buffer(session_handle, input_window.buf.get(), &input_map);
+    if (!output_pooled)
+        unmap_buffer(session_handle, output_window, &output_map);
     return ret;
 }
 
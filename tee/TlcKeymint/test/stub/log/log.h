@@ -0,0 +1,14 @@
+/*
+ * Host stand-in for Android's <log/log.h>, for the test harness.
+ */
+
+#ifndef TLCKEYMINT_TEST_STUB_LOG_H
+#define TLCKEYMINT_TEST_STUB_LOG_H
+
+#include <stdio.h>
+
+#define ALOGE(fmt, ...) fprintf(stderr, "E " LOG_TAG ": " fmt "\n", ##__VA_ARGS__)
+#define ALOGI(fmt, ...) fprintf(stderr, "I " LOG_TAG ": " fmt "\n", ##__VA_ARGS__)
+#define ALOGD(fmt, ...) do { } while (0)
+
+#endif /* TLCKEYMINT_TEST_STUB_LOG_H */
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2013-2022 TRUSTONIC LIMITED
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the TRUSTONIC LIMITED nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <time.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "mc_stub.h"
+
+/* TA addresses handed out by mcMap(), one region per mapping. */
+#define STUB_SVA_BASE 0x10000000u
+#define STUB_SVA_REGION 0x00100000u
+
+struct stub_map {
+    uint32_t sva;
+    uint8_t *buf;
+    uint32_t len;
+};
+
+static std::mutex g_lock;
+static std::condition_variable g_cond;
+static std::thread g_ta;
+static tciMessage_ptr g_tci;
+static struct mc_stub_config g_config;
+static struct mc_stub_stats g_stats;
+static std::vector<struct stub_map> g_maps;
+static uint32_t g_next_sva;
+static bool g_notified;
+static bool g_responded;
+static bool g_exit;
+
+static void spin_ns(uint64_t ns)
+{
+    struct timespec t;
+    uint64_t end;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    end = (uint64_t)t.tv_sec * 1000000000ull + t.tv_nsec + ns;
+    do {
+        clock_gettime(CLOCK_MONOTONIC, &t);
+    } while ((uint64_t)t.tv_sec * 1000000000ull + t.tv_nsec < end);
+}
+
+static uint32_t to_sva(const mcBulkMap_t *map)
+{
+    return (uint32_t)(uintptr_t)map->sVirtualAddr;
+}
+
+/* Host address of [sva, sva + len) if a live mapping covers it. g_lock held. */
+static uint8_t *resolve(uint32_t sva, uint32_t len)
+{
+    if (sva == 0 && len == 0)
+        return NULL;
+
+    for (const struct stub_map &m : g_maps) {
+        if (sva >= m.sva && sva - m.sva + (uint64_t)len <= m.len)
+            return m.buf + (sva - m.sva);
+    }
+
+    g_stats.bad_addresses++;
+    return NULL;
+}
+
+static uint32_t ta_command(tciMessage_ptr tci)
+{
+    /* The TCI is packed: work on copies of the blobs. */
+    data_blob_t in, out;
+    uint8_t *src, *dst;
+    bool update;
+
+    switch (tci->command.header.commandId) {
+    case CMD_ID_TEE_UPDATE:
+        update = true;
+        in = tci->update.input;
+        out = tci->update.output;
+        break;
+    case CMD_ID_TEE_FINISH:
+        update = false;
+        in = tci->finish.input;
+        out = tci->finish.output;
+        break;
+    default:
+        return KM_ERROR_UNIMPLEMENTED;
+    }
+
+    src = resolve(in.data, in.data_length);
+    dst = resolve(out.data, out.data_length);
+    if ((in.data_length && !src) || (out.data_length && !dst))
+        return KM_ERROR_SECURE_HW_COMMUNICATION_FAILED;
+    if (in.data_length > out.data_length)
+        return KM_ERROR_INVALID_INPUT_LENGTH;
+
+    spin_ns((uint64_t)g_config.ta_ns_per_kb * in.data_length / 1024);
+    for (uint32_t i = 0; i < in.data_length; i++)
+        dst[i] = src[i] ^ MC_STUB_KEY;
+
+    if (update) {
+        tci->update.input_consumed = in.data_length;
+        tci->update.output.data_length = in.data_length;
+    } else {
+        tci->finish.output.data_length = in.data_length;
+    }
+    return KM_ERROR_OK;
+}
+
+static void ta_thread(void)
+{
+    std::unique_lock<std::mutex> lock(g_lock);
+
+    while (true) {
+        g_cond.wait(lock, [] { return g_notified || g_exit; });
+        if (g_exit)
+            break;
+        g_notified = false;
+
+        uint32_t rc = ta_command(g_tci);
+        g_tci->response.header.returnCode = rc;
+        g_stats.commands++;
+
+        g_responded = true;
+        g_cond.notify_all();
+    }
+}
+
+void mc_stub_start(tciMessage_ptr tci, const struct mc_stub_config *config)
+{
+    g_tci = tci;
+    g_config = *config;
+    g_stats = mc_stub_stats();
+    g_maps.clear();
+    g_next_sva = STUB_SVA_BASE;
+    g_notified = g_responded = g_exit = false;
+    g_ta = std::thread(ta_thread);
+}
+
+void mc_stub_stop(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_lock);
+        g_exit = true;
+        g_cond.notify_all();
+    }
+    g_ta.join();
+}
+
+void mc_stub_get_stats(struct mc_stub_stats *stats)
+{
+    std::lock_guard<std::mutex> lock(g_lock);
+    *stats = g_stats;
+}
+
+mcResult_t mcMap(mcSessionHandle_t *, void *buf, uint32_t len, mcBulkMap_t *mapInfo)
+{
+    struct stub_map m;
+
+    if (buf == NULL || len == 0 || len > STUB_SVA_REGION)
+        return MC_DRV_ERR_INVALID_PARAMETER;
+
+    spin_ns((uint64_t)g_config.map_cost_us * 1000);
+
+    std::lock_guard<std::mutex> lock(g_lock);
+    m.sva = g_next_sva;
+    m.buf = (uint8_t *)buf;
+    m.len = len;
+    g_next_sva += STUB_SVA_REGION;
+    if (g_next_sva == 0)
+        g_next_sva = STUB_SVA_BASE;
+    g_maps.push_back(m);
+    g_stats.maps++;
+
+#if ( __WORDSIZE == 64 )
+    mapInfo->sVirtualAddr = m.sva;
+#else
+    mapInfo->sVirtualAddr = (void *)(uintptr_t)m.sva;
+#endif
+    mapInfo->sVirtualLen = len;
+    return MC_DRV_OK;
+}
+
+mcResult_t mcUnmap(mcSessionHandle_t *, void *buf, mcBulkMap_t *mapInfo)
+{
+    spin_ns((uint64_t)g_config.map_cost_us * 1000);
+
+    std::lock_guard<std::mutex> lock(g_lock);
+    for (size_t i = 0; i < g_maps.size(); i++) {
+        if (g_maps[i].sva == to_sva(mapInfo) && g_maps[i].buf == buf) {
+            g_maps.erase(g_maps.begin() + i);
+            g_stats.unmaps++;
+            return MC_DRV_OK;
+        }
+    }
+    return MC_DRV_ERR_BLK_BUFF_NOT_FOUND;
+}
+
+mcResult_t mcNotify(mcSessionHandle_t *)
+{
+    spin_ns((uint64_t)g_config.switch_cost_us * 1000 / 2);
+
+    std::lock_guard<std::mutex> lock(g_lock);
+    g_responded = false;
+    g_notified = true;
+    g_cond.notify_all();
+    return MC_DRV_OK;
+}
+
+mcResult_t mcWaitNotification(mcSessionHandle_t *, int32_t)
+{
+    {
+        std::unique_lock<std::mutex> lock(g_lock);
+        g_cond.wait(lock, [] { return g_responded; });
+    }
+
+    spin_ns((uint64_t)g_config.switch_cost_us * 1000 / 2);
+    return MC_DRV_OK;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2013-2022 TRUSTONIC LIMITED
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the TRUSTONIC LIMITED nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host model of the MobiCore driver and of the Keymint TA's update and
+ * finish commands, for measuring the bulk data path without a TEE.
+ *
+ * mcMap()/mcUnmap() cost a fixed time and hand out TA addresses that the
+ * fake TA resolves; an address outside a live mapping fails the command.
+ * mcNotify() wakes the fake TA on its own thread, which "encrypts" the
+ * input into the output by XOR with MC_STUB_KEY at a fixed cost per KB.
+ */
+
+#ifndef TLCKEYMINT_TEST_MC_STUB_H
+#define TLCKEYMINT_TEST_MC_STUB_H
+
+#include <stdint.h>
+#include "MobiCoreDriverApi.h"
+#include "TAKeymint_Api.h"
+
+#define MC_STUB_KEY 0x5a
+
+struct mc_stub_config {
+    unsigned map_cost_us;       /**< per mcMap() and per mcUnmap() */
+    unsigned switch_cost_us;    /**< per command, world switch both ways */
+    unsigned ta_ns_per_kb;      /**< TA processing */
+};
+
+struct mc_stub_stats {
+    uint64_t maps;
+    uint64_t unmaps;
+    uint64_t commands;
+    uint64_t bad_addresses;
+};
+
+void mc_stub_start(tciMessage_ptr tci, const struct mc_stub_config *config);
+void mc_stub_stop(void);
+void mc_stub_get_stats(struct mc_stub_stats *stats);
+
+#endif /* TLCKEYMINT_TEST_MC_STUB_H */
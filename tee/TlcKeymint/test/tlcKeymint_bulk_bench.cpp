@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2013-2022 TRUSTONIC LIMITED
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the TRUSTONIC LIMITED nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Throughput of the update() bulk data path on a plain Linux host, against
+ * the stub MobiCore driver in stub/.
+ *
+ * "per-chunk" is the path split_update_chunks() used to take for every
+ * chunk: copy the chunk to a fresh buffer, map it and the caller's output,
+ * transact, unmap both.  "pool" is the bulk_pool path: chunks go through
+ * windows mapped once, the next chunk is copied in while the TA works, and
+ * the output is copied out of the pool.  Both check the TA's output, and
+ * "pool" checks that the output window comes back cleared for the next one.
+ *
+ * Build and run from tee/TlcKeymint:
+ *
+ *   g++ -O2 -std=c++17 -pthread -Iinclude -Itest/stub \
+ *       -I../kinibi520/common/ApiHeaders/include \
+ *       test/tlcKeymint_bulk_bench.cpp test/stub/mc_stub.cpp \
+ *       src/tlcKeymint_bulk.cpp -o tlcKeymint_bulk_bench
+ *   ./tlcKeymint_bulk_bench [map_cost_us] [switch_cost_us] [ta_ns_per_kb]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <memory>
+#include "tlcKeymint_bulk.h"
+#include "mc_stub.h"
+
+#define BENCH_TOTAL_BYTES (64u << 20)
+
+static mcSessionHandle_t g_session_handle;
+static tciMessage_t g_tci;
+
+static uint64_t now_ns(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ull + t.tv_nsec;
+}
+
+/* What update_chunk() does, with or without the prefetch. */
+static bool submit(const mcBulkMap_t *input_map, const mcBulkMap_t *output_map,
+    struct bulk_pool *pool, size_t *input_consumed, size_t *output_used)
+{
+    tciMessage_ptr tci = &g_tci;
+
+    tci->command.header.commandId = CMD_ID_TEE_UPDATE;
+    tci->update.input.data = (uint32_t)(uintptr_t)input_map->sVirtualAddr;
+    tci->update.input.data_length = input_map->sVirtualLen;
+    tci->update.output.data = (uint32_t)(uintptr_t)output_map->sVirtualAddr;
+    tci->update.output.data_length = output_map->sVirtualLen;
+
+    if (mcNotify(&g_session_handle) != MC_DRV_OK)
+        return false;
+    if (pool != NULL)
+        bulk_pool_prefetch(pool);
+    if (mcWaitNotification(&g_session_handle, MC_INFINITE_TIMEOUT) != MC_DRV_OK)
+        return false;
+    if (tci->response.header.returnCode != KM_ERROR_OK)
+        return false;
+
+    *input_consumed = tci->update.input_consumed;
+    *output_used = tci->update.output.data_length;
+    return true;
+}
+
+static bool update_per_chunk(const uint8_t *inp, size_t length, uint8_t *output)
+{
+    const uint8_t *inp_limit = inp + length;
+
+    while (inp < inp_limit) {
+        size_t n = inp_limit - inp;
+        mcBulkMap_t input_map = { 0, 0 };
+        mcBulkMap_t output_map = { 0, 0 };
+        size_t input_consumed = 0, output_used = 0;
+        bool ok;
+
+        if (n > INPUT_CHUNK_SIZE)
+            n = INPUT_CHUNK_SIZE;
+
+        std::unique_ptr<uint8_t[]> input_window(new uint8_t[n]);
+        memcpy(input_window.get(), inp, n);
+        if (mcMap(&g_session_handle, input_window.get(), n, &input_map) != MC_DRV_OK)
+            return false;
+        if (mcMap(&g_session_handle, output, n + 16, &output_map) != MC_DRV_OK)
+            return false;
+
+        ok = submit(&input_map, &output_map, NULL, &input_consumed, &output_used);
+
+        mcUnmap(&g_session_handle, input_window.get(), &input_map);
+        mcUnmap(&g_session_handle, output, &output_map);
+        if (!ok)
+            return false;
+
+        inp += input_consumed;
+        output += output_used;
+    }
+    return true;
+}
+
+static bool update_pool(struct bulk_pool *pool, const uint8_t *inp, size_t length, uint8_t *output)
+{
+    const uint8_t *inp_limit = inp + length;
+    bool ok = true;
+
+    while (ok && inp < inp_limit) {
+        size_t n = inp_limit - inp;
+        mcBulkMap_t input_map, output_map;
+        size_t input_consumed = 0, output_used = 0;
+
+        if (n > INPUT_CHUNK_SIZE)
+            n = INPUT_CHUNK_SIZE;
+
+        if (!bulk_pool_input(pool, inp, n, &input_map) ||
+            !bulk_pool_output(pool, n + 16, &output_map)) {
+            ok = false;
+            break;
+        }
+        if (inp + n < inp_limit) {
+            size_t next = inp_limit - (inp + n);
+            bulk_pool_set_next(pool, inp + n, next > INPUT_CHUNK_SIZE ? INPUT_CHUNK_SIZE : next);
+        }
+
+        ok = submit(&input_map, &output_map, pool, &input_consumed, &output_used);
+        if (ok)
+            memcpy(output, bulk_pool_output_data(pool), output_used);
+
+        inp += input_consumed;
+        output += output_used;
+    }
+
+    bulk_pool_reset(pool);
+    return ok;
+}
+
+static bool check(const uint8_t *input, const uint8_t *output, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        if (output[i] != (input[i] ^ MC_STUB_KEY)) {
+            printf("  output mismatch at %zu\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* The output window must not hand the last output to the next update. */
+static bool check_output_cleared(struct bulk_pool *pool, size_t length)
+{
+    mcBulkMap_t output_map;
+    const uint8_t *data;
+
+    if (length > BULK_OUTPUT_SIZE)
+        length = BULK_OUTPUT_SIZE;
+    if (!bulk_pool_output(pool, (uint32_t)length, &output_map))
+        return false;
+
+    data = bulk_pool_output_data(pool);
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] != 0) {
+            printf("  output window not cleared at %zu\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+static int run(size_t message, struct bulk_pool *pool)
+{
+    std::unique_ptr<uint8_t[]> input(new uint8_t[message]);
+    std::unique_ptr<uint8_t[]> output(new uint8_t[message + 16]);
+    size_t count = BENCH_TOTAL_BYTES / message;
+    struct mc_stub_stats before, after;
+    uint64_t start;
+    double sec;
+    bool ok = true;
+
+    if (count == 0)
+        count = 1;
+    for (size_t i = 0; i < message; i++)
+        input[i] = (uint8_t)(i * 131 + 7);
+
+    /* Only the last round's output is checked, outside the timing. */
+    mc_stub_get_stats(&before);
+    start = now_ns();
+    for (size_t i = 0; ok && i < count; i++) {
+        ok = pool ? update_pool(pool, input.get(), message, output.get())
+                  : update_per_chunk(input.get(), message, output.get());
+    }
+    sec = (now_ns() - start) / 1e9;
+    mc_stub_get_stats(&after);
+
+    if (!ok || !check(input.get(), output.get(), message) ||
+        after.bad_addresses != before.bad_addresses ||
+        (pool && !check_output_cleared(pool, message + 16))) {
+        printf("  %-9s %8zu bytes : FAILED\n", pool ? "pool" : "per-chunk", message);
+        return 1;
+    }
+
+    printf("  %-9s %8zu bytes : %8.1f MB/s, %6.2f maps/update\n",
+        pool ? "pool" : "per-chunk", message,
+        (double)message * count / sec / (1 << 20),
+        (double)(after.maps - before.maps) / count);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    static const size_t messages[] = {
+        256, 4096, INPUT_CHUNK_SIZE, 64 << 10, 1 << 20, 16 << 20,
+    };
+    struct mc_stub_config config = { 30, 10, 1000 };
+    struct bulk_pool pool;
+    int failed = 0;
+
+    if (argc > 1)
+        config.map_cost_us = atoi(argv[1]);
+    if (argc > 2)
+        config.switch_cost_us = atoi(argv[2]);
+    if (argc > 3)
+        config.ta_ns_per_kb = atoi(argv[3]);
+
+    printf("map %u us, world switch %u us, TA %u ns/KB, chunk %u bytes\n",
+        config.map_cost_us, config.switch_cost_us, config.ta_ns_per_kb,
+        INPUT_CHUNK_SIZE);
+
+    mc_stub_start(&g_tci, &config);
+
+    if (bulk_pool_open(&g_session_handle, &pool) != KM_ERROR_OK) {
+        mc_stub_stop();
+        return 1;
+    }
+
+    for (size_t i = 0; i < sizeof(messages) / sizeof(messages[0]); i++) {
+        failed |= run(messages[i], NULL);
+        failed |= run(messages[i], &pool);
+    }
+
+    bulk_pool_close(&g_session_handle, &pool);
+    mc_stub_stop();
+    return failed;
+}
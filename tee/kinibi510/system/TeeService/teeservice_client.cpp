@@ -45,6 +45,7 @@
 
 #include <binder/IServiceManager.h>
 #include <cutils/ashmem.h>
+#include <cutils/properties.h>
 #include <utils/Log.h>
 #include <utils/Mutex.h>
 
@@ -53,6 +54,7 @@
 #include "gp_types.h"
 #include "mc_types.h"
 #include "teeservice_client.h"
+#include "teeservice_pool.h"
 
 static const int32_t client_version = 1;
 
@@ -288,8 +290,328 @@ struct TeeServiceClient::Impl {
         }
     };
 
+    // Buffer in a pool region: either a copy of a temporary memory reference,
+    // or shared memory allocated from or registered in the region.
+    class PoolBuffer: public IBuffer {
+        std::shared_ptr<SharedMemoryPool::Region> region_;
+        uint8_t* dest_ = nullptr;
+        uint32_t offset_ = 0;
+        uint32_t size_ = 0;
+        // Temporary memory reference to copy, if any
+        void* src_ = nullptr;
+        const size_t* src_size_ = nullptr;
+    public:
+        PoolBuffer(
+                const std::shared_ptr<GpContext>& context,
+                const std::shared_ptr<SharedMemoryPool::Region>& region,
+                uint32_t offset,
+                uint32_t size,
+                uint32_t flags):
+            IBuffer(context, flags), region_(region),
+            dest_(region->address() + offset), offset_(offset), size_(size) {
+            setReference(region->reference());
+        }
+
+        PoolBuffer(
+                const std::shared_ptr<GpContext>& context,
+                const std::shared_ptr<SharedMemoryPool::Region>& region,
+                const TEEC_TempMemoryReference& tmpref,
+                uint32_t flags):
+            IBuffer(context, flags), region_(region),
+            dest_(region->address()),
+            size_(static_cast<uint32_t>(tmpref.size)),
+            src_(tmpref.buffer), src_size_(&tmpref.size) {
+            setReference(region->reference());
+        }
+
+        int fd() const override {
+            return region_->fd();
+        }
+
+        void* address() const override {
+            return dest_;
+        }
+
+        uint32_t size() const override {
+            return size_;
+        }
+
+        uint32_t offset() const {
+            return offset_;
+        }
+
+        uint32_t regionSize() const {
+            return region_->size();
+        }
+
+        void updateDestination() override {
+            if (!src_) {
+                return;
+            }
+            // No need to copy in what the TA is only going to write, but the
+            // region may still hold the data of an earlier command
+            if (flags() & TEEC_MEM_INPUT) {
+                ::memcpy(dest_, src_, size_);
+            } else {
+                ::memset(dest_, 0, size_);
+            }
+        }
+
+        void updateSource() override {
+            // Only what the TA says it wrote, the size is updated by now
+            if (src_ && (flags() & TEEC_MEM_OUTPUT)) {
+                ::memcpy(src_, dest_, std::min<size_t>(*src_size_, size_));
+            }
+        }
+    };
+
+    // Regions of a GP context, and the shared memory that lives in them
+    class GpPool {
+        std::shared_ptr<GpContext> context_;
+        SharedMemoryPool pool_;
+        bool zero_copy_ = false;
+        std::mutex buffers_mutex_;
+        std::vector<std::shared_ptr<PoolBuffer>> buffers_;
+
+        static bool share(
+                const std::shared_ptr<GpContext>& context,
+                const SharedMemoryPool::Region& region) {
+            TeeServiceGpSharedMemoryIn params_in;
+            params_in.context = context->reference();
+            params_in.buffer = region.fd();
+            params_in.reference = region.reference();
+            params_in.size = region.size();
+            params_in.flags = TEEC_MEM_INOUT;
+
+            int32_t aidl_return;
+            auto status = context->getService()->get()->TEEC_RegisterSharedMemory(
+                              params_in, &aidl_return);
+            if (!status.isOk()) {
+                ALOGE("Failed to call service: %d.", status.exceptionCode());
+                return false;
+            }
+
+            ALOGH("%s region %jx returns %x", __func__,
+                  params_in.reference, aidl_return);
+            return aidl_return == TEEC_SUCCESS;
+        }
+
+        static void unshare(
+                const std::shared_ptr<GpContext>& context,
+                const SharedMemoryPool::Region& region) {
+            TeeServiceGpSharedMemoryIn params_in;
+            params_in.context = context->reference();
+            params_in.reference = region.reference();
+            params_in.flags = TEEC_MEM_INOUT;
+            auto status = context->getService()->get()->TEEC_ReleaseSharedMemory(
+                              params_in);
+            if (!status.isOk()) {
+                ALOGE("Failed to call service: %d.", status.exceptionCode());
+            }
+        }
+    public:
+        GpPool(
+                const std::shared_ptr<GpContext>& context,
+                bool zero_copy):
+            context_(context),
+            pool_([context](const SharedMemoryPool::Region& region) {
+                      return share(context, region);
+                  },
+                  [context](const SharedMemoryPool::Region& region) {
+                      unshare(context, region);
+                  }),
+            zero_copy_(zero_copy) {}
+
+        uint64_t reference() const {
+            return context_->reference();
+        }
+
+        // Null if the caller has to use a shadow buffer
+        std::shared_ptr<PoolBuffer> temporary(
+                const TEEC_TempMemoryReference& tmpref,
+                uint32_t flags) {
+            if (tmpref.size > SharedMemoryPool::maxSize()) {
+                return nullptr;
+            }
+
+            auto size = static_cast<uint32_t>(tmpref.size);
+            if (zero_copy_) {
+                uint32_t offset;
+                auto region = pool_.find(tmpref.buffer, size, &offset);
+                if (region) {
+                    return std::make_shared<PoolBuffer>(
+                               context_, region, offset, size, flags);
+                }
+            }
+
+            auto region = pool_.acquire(size);
+            if (!region) {
+                return nullptr;
+            }
+
+            return std::make_shared<PoolBuffer>(context_, region, tmpref, flags);
+        }
+
+        // Null if the caller has to allocate a buffer of its own
+        std::shared_ptr<PoolBuffer> allocate(
+                const TEEC_SharedMemory* shared_mem) {
+            if ((shared_mem->flags & TEEC_MEM_ION) ||
+                    (shared_mem->size > SharedMemoryPool::maxSize())) {
+                return nullptr;
+            }
+
+            auto size = static_cast<uint32_t>(shared_mem->size);
+            auto region = pool_.acquire(size);
+            if (!region) {
+                return nullptr;
+            }
+
+            // Fresh ashmem is zeroed, keep it that way for reused regions
+            ::memset(region->address(), 0, region->size());
+            return std::make_shared<PoolBuffer>(
+                       context_, region, 0, size, shared_mem->flags);
+        }
+
+        // Null unless zero-copy is enabled and the memory is in a region
+        std::shared_ptr<PoolBuffer> alias(
+                const TEEC_SharedMemory* shared_mem) {
+            if (!zero_copy_ || (shared_mem->flags & TEEC_MEM_ION) ||
+                    (shared_mem->size > SharedMemoryPool::maxSize())) {
+                return nullptr;
+            }
+
+            auto size = static_cast<uint32_t>(shared_mem->size);
+            uint32_t offset;
+            auto region = pool_.find(shared_mem->buffer, size, &offset);
+            if (!region) {
+                return nullptr;
+            }
+
+            return std::make_shared<PoolBuffer>(
+                       context_, region, offset, size, shared_mem->flags);
+        }
+
+        void addBuffer(
+                const std::shared_ptr<PoolBuffer>& buffer) {
+            std::lock_guard<std::mutex> lock(buffers_mutex_);
+            buffers_.emplace_back(buffer);
+            ALOGM("%zu pool buffers", buffers_.size());
+        }
+
+        std::shared_ptr<PoolBuffer> getBuffer(
+                void* buf) {
+            std::lock_guard<std::mutex> lock(buffers_mutex_);
+            auto it = std::find_if(buffers_.begin(), buffers_.end(), [buf]
+                                   (const auto& buffer) {
+                return buffer->address() == buf;
+            }
+            );
+            if (it == buffers_.end()) {
+                return nullptr;
+            }
+
+            return *it;
+        }
+
+        // Returned so the region can go back to the pool outside the lock
+        std::shared_ptr<PoolBuffer> removeBuffer(
+                void* buf) {
+            std::lock_guard<std::mutex> lock(buffers_mutex_);
+            auto it = std::find_if(buffers_.begin(), buffers_.end(), [buf]
+                                   (const auto& buffer) {
+                return buffer->address() == buf;
+            }
+            );
+            if (it == buffers_.end()) {
+                return nullptr;
+            }
+
+            auto buffer = *it;
+            buffers_.erase(it);
+            ALOGM("%zu pool buffers", buffers_.size());
+            return buffer;
+        }
+    };
+
+    std::mutex gp_pools_mutex;
+    std::vector<std::shared_ptr<GpPool>> gp_pools;
+    // Set to false to go back to a new region per operation
+    const bool gp_pool = ::property_get_bool(
+                             "vendor.trustonic.teeservice.pool", true);
+    // Let the TA work on memory from the pool in place, see GpPool::alias
+    const bool gp_zero_copy = ::property_get_bool(
+                                  "vendor.trustonic.teeservice.zero_copy", false);
+
+    void addPool(
+            const std::shared_ptr<GpContext>& context) {
+        if (!gp_pool) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(gp_pools_mutex);
+        gp_pools.emplace_back(std::make_shared<GpPool>(context, gp_zero_copy));
+    }
+
+    void removePool(
+            uint64_t reference) {
+        // Its regions are unregistered outside the lock, in reverse
+        // declaration order
+        std::shared_ptr<GpPool> removed;
+        std::lock_guard<std::mutex> lock(gp_pools_mutex);
+        auto it = std::find_if(gp_pools.begin(), gp_pools.end(), [reference]
+                               (const auto& pool) {
+            return pool->reference() == reference;
+        }
+        );
+        if (it != gp_pools.end()) {
+            removed = std::move(*it);
+            gp_pools.erase(it);
+        }
+    }
+
+    std::shared_ptr<GpPool> getPool(
+            uint64_t reference) {
+        std::lock_guard<std::mutex> lock(gp_pools_mutex);
+        auto it = std::find_if(gp_pools.begin(), gp_pools.end(), [reference]
+                               (const auto& pool) {
+            return pool->reference() == reference;
+        }
+        );
+        if (it == gp_pools.end()) {
+            return nullptr;
+        }
+
+        return *it;
+    }
+
+    std::shared_ptr<PoolBuffer> removePoolBuffer(
+            void* buf) {
+        std::lock_guard<std::mutex> lock(gp_pools_mutex);
+        for (auto& pool: gp_pools) {
+            auto buffer = pool->removeBuffer(buf);
+            if (buffer) {
+                return buffer;
+            }
+        }
+
+        return nullptr;
+    }
+
+    static uint32_t partialType(
+            uint32_t flags) {
+        switch (flags & TEEC_MEM_INOUT) {
+            case TEEC_MEM_INPUT:
+                return TEEC_MEMREF_PARTIAL_INPUT;
+            case TEEC_MEM_OUTPUT:
+                return TEEC_MEMREF_PARTIAL_OUTPUT;
+        }
+
+        return TEEC_MEMREF_PARTIAL_INOUT;
+    }
+
     static TEEC_Result fromOperation(
             const std::shared_ptr<GpContext>& context,
+            const std::shared_ptr<GpPool>& pool,
             const TEEC_Operation* operation_in,
             TeeServiceGpOperation* operation_out,
             std::vector<std::shared_ptr<IBuffer>>& buffers) {
@@ -332,6 +654,22 @@ struct TeeServiceClient::Impl {
                                 break;
                         }
 
+                        // Passed as a window on a region the server already
+                        // has, the TA sees the same memory reference.
+                        auto pooled = pool ?
+                                      pool->temporary(param_in.tmpref, flags) :
+                                      nullptr;
+                        if (pooled) {
+                            buffers.push_back(pooled);
+                            param_out.type = partialType(flags);
+                            param_out.reference = pooled->reference();
+                            param_out.size = pooled->regionSize();
+                            param_out.flags = TEEC_MEM_INOUT;
+                            param_out.window_offset = pooled->offset();
+                            param_out.window_size = pooled->size();
+                            break;
+                        }
+
                         auto buffer = std::make_shared<ShadowBuffer>(
                                           context,
                                           param_in.tmpref.buffer,
@@ -355,6 +693,27 @@ struct TeeServiceClient::Impl {
                 case TEEC_MEMREF_PARTIAL_OUTPUT:
                 case TEEC_MEMREF_PARTIAL_INPUT:
                 case TEEC_MEMREF_PARTIAL_INOUT:
+                    auto pooled = pool ?
+                                  pool->getBuffer(param_in.memref.parent->buffer) :
+                                  nullptr;
+                    if (pooled) {
+                        buffers.push_back(pooled);
+                        param_out.reference = pooled->reference();
+                        param_out.size = pooled->regionSize();
+                        param_out.flags = param_in.memref.parent->flags;
+                        if (param_out.type == TEEC_MEMREF_WHOLE) {
+                            // The region is bigger than the shared memory
+                            param_out.type = partialType(param_out.flags);
+                            param_out.window_offset = pooled->offset();
+                            param_out.window_size = pooled->size();
+                        } else {
+                            param_out.window_offset = pooled->offset() +
+                                                      param_in.memref.offset;
+                            param_out.window_size = param_in.memref.size;
+                        }
+                        break;
+                    }
+
                     auto buffer = context->getBuffer(
                                       param_in.memref.parent->buffer);
                     if (!buffer) {
@@ -397,7 +756,9 @@ struct TeeServiceClient::Impl {
         for (size_t i = 0; i < 4; i++) {
             const TeeServiceGpOperation::Param& param_in = operation_in.params[i];
             TEEC_Parameter& param_out = operation_out->params[i];
-            switch (param_in.type) {
+            // Not param_in.type, temporary references from the pool are sent
+            // as partial ones
+            switch ((operation_out->paramTypes >> (4 * i)) & 0xf) {
                 case TEEC_NONE:
                 case TEEC_VALUE_INPUT:
                     break;
@@ -485,6 +846,7 @@ TEEC_Result TeeServiceClient::TEEC_InitializeContext(
     }
 
     ALOGH("%s aidl_return=%x", __func__, aidl_return);
+    pimpl_->addPool(gp_context);
     return TEEC_SUCCESS;
 }
 
@@ -500,6 +862,8 @@ void TeeServiceClient::TEEC_FinalizeContext(
 
     TeeServiceGpContextIn params_in;
     params_in.context = reinterpret_cast<uint64_t>(context);
+    // The pool unregisters its idle regions, while the context is still there
+    pimpl_->removePool(params_in.context);
     auto status = gp_context->getService()->get()->TEEC_FinalizeContext(
                       params_in);
     if (!status.isOk()) {
@@ -521,6 +885,17 @@ TEEC_Result TeeServiceClient::TEEC_RegisterSharedMemory(
         return TEEC_ERROR_BAD_STATE;
     }
 
+    auto gp_pool = pimpl_->getPool(gp_context->reference());
+    if (gp_pool) {
+        auto pooled = gp_pool->alias(shared_mem);
+        if (pooled) {
+            gp_pool->addBuffer(pooled);
+            ALOGH("%s aliased buffer %p in region %jx", __func__,
+                  shared_mem->buffer, pooled->reference());
+            return TEEC_SUCCESS;
+        }
+    }
+
     auto buffer = std::make_shared<Impl::ShadowBuffer>(
                       gp_context, shared_mem->buffer, shared_mem->size,
                       shared_mem->flags);
@@ -566,6 +941,18 @@ TEEC_Result TeeServiceClient::TEEC_AllocateSharedMemory(
         return TEEC_ERROR_BAD_STATE;
     }
 
+    auto gp_pool = pimpl_->getPool(gp_context->reference());
+    if (gp_pool) {
+        auto pooled = gp_pool->allocate(shared_mem);
+        if (pooled) {
+            shared_mem->buffer = pooled->address();
+            gp_pool->addBuffer(pooled);
+            ALOGH("%s allocated buffer %p in region %jx", __func__,
+                  shared_mem->buffer, pooled->reference());
+            return TEEC_SUCCESS;
+        }
+    }
+
     auto buffer = std::make_shared<Impl::RealBuffer>(
                       gp_context, shared_mem->size, shared_mem->flags);
     shared_mem->buffer = buffer->create();
@@ -609,6 +996,13 @@ void TeeServiceClient::TEEC_ReleaseSharedMemory(
         return;
     }
 
+    // Pool regions stay registered with the server
+    auto pooled = pimpl_->removePoolBuffer(shared_mem->buffer);
+    if (pooled) {
+        ALOGH("%s removed pool buffer %p", __func__, shared_mem->buffer);
+        return;
+    }
+
     auto buffer = gp_client->getBuffer(shared_mem->buffer);
     if (!buffer) {
         // Log'd in callee
@@ -694,7 +1088,8 @@ TEEC_Result TeeServiceClient::TEEC_OpenSession(
     // We need to keep the temporary buffers for the duration of the operation
     std::vector<std::shared_ptr<IBuffer>> buffers;
     auto result = Impl::fromOperation(
-                      gp_context, operation, &params_in.operation, buffers);
+                      gp_context, pimpl_->getPool(gp_context->reference()),
+                      operation, &params_in.operation, buffers);
     if (result != TEEC_SUCCESS) {
         return result;
     }
@@ -813,7 +1208,8 @@ TEEC_Result TeeServiceClient::TEEC_InvokeCommand(
     // We need to keep the temporary buffers for the duration of the operation
     std::vector<std::shared_ptr<IBuffer>> buffers;
     auto result = Impl::fromOperation(
-                      gp_context, operation, &params_in.operation, buffers);
+                      gp_context, pimpl_->getPool(gp_context->reference()),
+                      operation, &params_in.operation, buffers);
     if (result != TEEC_SUCCESS) {
         return result;
     }
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2018 TRUSTONIC LIMITED
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the TRUSTONIC LIMITED nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TEESERVICE_POOL_H
+#define TEESERVICE_POOL_H
+
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vendor {
+namespace trustonic {
+
+// Ashmem regions of a GP context, kept mapped and registered with the server
+// as shared memory for the lifetime of the context. An operation copies its
+// temporary memory references into a region and passes it by reference,
+// rather than creating, mapping and sending a new region each time.
+//
+// Regions come in a few size classes. A released region is kept for the next
+// operation, up to a few per class; the others are unregistered and freed.
+class SharedMemoryPool {
+public:
+    class Region {
+        int fd_ = -1;
+        uint8_t* address_ = nullptr;
+        uint32_t size_ = 0;
+        size_t size_class_ = 0;
+        friend class SharedMemoryPool;
+    public:
+        ~Region();
+
+        int fd() const {
+            return fd_;
+        }
+
+        uint8_t* address() const {
+            return address_;
+        }
+
+        uint32_t size() const {
+            return size_;
+        }
+
+        // Reference given to the server, same as for any GP shared memory
+        uint64_t reference() const {
+            return reinterpret_cast<uint64_t>(address_);
+        }
+    };
+
+    // Register/unregister a region with the server
+    using Share = std::function<bool(const Region&)>;
+    using Unshare = std::function<void(const Region&)>;
+
+    SharedMemoryPool(
+            Share share,
+            Unshare unshare);
+
+    // Unregisters and frees the idle regions, so the pool must go before its
+    // context. Regions still in use are freed when released; the server drops
+    // them with the context.
+    ~SharedMemoryPool();
+
+    // Region of at least size bytes, returned to the pool when the last
+    // reference goes. Null if size is above the largest class or no region
+    // could be set up, in which case the caller does without.
+    std::shared_ptr<Region> acquire(
+            uint32_t size);
+
+    // Region in use that contains [buffer, buffer + size), for buffers handed
+    // out from the pool. Null if none.
+    std::shared_ptr<Region> find(
+            const void* buffer,
+            uint32_t size,
+            uint32_t* offset);
+
+    static uint32_t maxSize();
+
+private:
+    struct State;
+    std::shared_ptr<State> state_;
+};
+
+}
+}
+
+#endif // TEESERVICE_POOL_H
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2018 TRUSTONIC LIMITED
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the TRUSTONIC LIMITED nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define LOG_TAG "teeservice_client"
+//#define LOG_NDEBUG 0
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iterator>
+
+#include <cutils/ashmem.h>
+#include <utils/Log.h>
+
+#include "teeservice_pool.h"
+
+using namespace vendor::trustonic;
+
+// 4 KiB to 256 KiB
+static const size_t size_classes = 4;
+static const uint32_t smallest_size = 4096;
+// Per class, so at most a few hundred KiB stay allocated when idle
+static const size_t max_idle_regions = 2;
+
+static uint32_t classSize(
+        size_t size_class) {
+    return smallest_size << (2 * size_class);
+}
+
+struct SharedMemoryPool::State {
+    Share share;
+    Unshare unshare;
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Region>> idle[size_classes];
+    std::vector<std::weak_ptr<Region>> busy;
+    bool closed = false;
+
+    State(
+            Share share_,
+            Unshare unshare_):
+        share(share_), unshare(unshare_) {}
+
+    static void release(
+            const std::shared_ptr<State>& state,
+            Region* region) {
+        std::unique_ptr<Region> owned(region);
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            auto& busy = state->busy;
+            busy.erase(std::remove_if(busy.begin(), busy.end(),
+                                      [](const auto& weak) {
+                return weak.expired();
+            }), busy.end());
+            if (state->closed) {
+                return;
+            }
+
+            auto& idle = state->idle[owned->size_class_];
+            if (idle.size() < max_idle_regions) {
+                idle.push_back(std::move(owned));
+                return;
+            }
+        }
+
+        // Too many spare regions of this class
+        state->unshare(*owned);
+    }
+};
+
+SharedMemoryPool::Region::~Region() {
+    if (fd_ >= 0) {
+        ::munmap(address_, size_);
+        ::close(fd_);
+    }
+}
+
+SharedMemoryPool::SharedMemoryPool(
+        Share share,
+        Unshare unshare):
+    state_(std::make_shared<State>(share, unshare)) {}
+
+SharedMemoryPool::~SharedMemoryPool() {
+    std::vector<std::unique_ptr<Region>> regions;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->closed = true;
+        for (auto& idle: state_->idle) {
+            std::move(idle.begin(), idle.end(), std::back_inserter(regions));
+            idle.clear();
+        }
+    }
+
+    for (const auto& region: regions) {
+        state_->unshare(*region);
+    }
+}
+
+std::shared_ptr<SharedMemoryPool::Region> SharedMemoryPool::acquire(
+        uint32_t size) {
+    size_t size_class = 0;
+    while (size_class < size_classes && size > classSize(size_class)) {
+        size_class++;
+    }
+
+    if (size_class == size_classes) {
+        return nullptr;
+    }
+
+    std::unique_ptr<Region> region;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        auto& idle = state_->idle[size_class];
+        if (!idle.empty()) {
+            region = std::move(idle.back());
+            idle.pop_back();
+        }
+    }
+
+    if (!region) {
+        region.reset(new Region);
+        region->size_ = classSize(size_class);
+        region->size_class_ = size_class;
+        region->fd_ = ::ashmem_create_region("teeservice", region->size_);
+        if (region->fd_ < 0) {
+            ALOGE("Failed to allocate pool region.");
+            return nullptr;
+        }
+
+        void* address = ::mmap(NULL, region->size_, PROT_READ | PROT_WRITE,
+                               MAP_SHARED, region->fd_, 0);
+        if (address == MAP_FAILED) {
+            ::close(region->fd_);
+            region->fd_ = -1;
+            ALOGE("Failed to map pool region.");
+            return nullptr;
+        }
+
+        region->address_ = static_cast<uint8_t*>(address);
+        if (!state_->share(*region)) {
+            ALOGE("Failed to share pool region.");
+            return nullptr;
+        }
+    }
+
+    auto state = state_;
+    std::shared_ptr<Region> lease(region.release(), [state]
+                                  (Region* released) {
+        State::release(state, released);
+    }
+    );
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->busy.push_back(lease);
+    return lease;
+}
+
+std::shared_ptr<SharedMemoryPool::Region> SharedMemoryPool::find(
+        const void* buffer,
+        uint32_t size,
+        uint32_t* offset) {
+    auto start = static_cast<const uint8_t*>(buffer);
+    // Dropping the last reference to a region releases it, which takes the
+    // mutex: the references go after the lock, in reverse declaration order
+    std::vector<std::shared_ptr<Region>> regions;
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    regions.reserve(state_->busy.size());
+    for (const auto& weak: state_->busy) {
+        auto region = weak.lock();
+        if (!region) {
+            continue;
+        }
+
+        regions.push_back(region);
+        auto begin = region->address();
+        if ((start >= begin) &&
+                (static_cast<uint64_t>(start - begin) + size <= region->size())) {
+            *offset = static_cast<uint32_t>(start - begin);
+            return region;
+        }
+    }
+
+    return nullptr;
+}
+
+uint32_t SharedMemoryPool::maxSize() {
+    return classSize(size_classes - 1);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2018 TRUSTONIC LIMITED
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the TRUSTONIC LIMITED nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host stand-in for the few libbinder types the client uses. sp<> does no
+ * reference counting, objects live until the process exits.
+ */
+
+#ifndef TEESERVICE_TEST_STUB_BINDER_ISERVICEMANAGER_H
+#define TEESERVICE_TEST_STUB_BINDER_ISERVICEMANAGER_H
+
+#include <stdint.h>
+
+namespace android {
+
+template<typename T>
+class sp {
+    T* ptr_ = nullptr;
+public:
+    sp() {}
+
+    sp(T* ptr): ptr_(ptr) {}
+
+    template<typename U>
+    sp(const sp<U>& other): ptr_(other.get()) {}
+
+    T* get() const {
+        return ptr_;
+    }
+
+    T* operator->() const {
+        return ptr_;
+    }
+};
+
+class IBinder {
+public:
+    virtual ~IBinder() {}
+};
+
+class String16 {
+public:
+    explicit String16(const char*) {}
+};
+
+class IServiceManager {
+public:
+    sp<IBinder> getService(const String16&) const;
+};
+
+// The service returned for any name, set by the test
+void setDefaultService(IBinder* service);
+
+sp<IServiceManager> defaultServiceManager();
+
+template<typename T>
+sp<T> interface_cast(const sp<IBinder>& binder) {
+    return static_cast<T*>(binder.get());
+}
+
+namespace binder {
+
+class Status {
+    int32_t exception_ = 0;
+public:
+    static Status ok() {
+        return Status();
+    }
+
+    static Status fromExceptionCode(int32_t exception) {
+        Status status;
+        status.exception_ = exception;
+        return status;
+    }
+
+    bool isOk() const {
+        return exception_ == 0;
+    }
+
+    int32_t exceptionCode() const {
+        return exception_;
+    }
+};
+
+}
+
+}
+
+#endif // TEESERVICE_TEST_STUB_BINDER_ISERVICEMANAGER_H
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2018 TRUSTONIC LIMITED
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the TRUSTONIC LIMITED nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host stand-in for libbinder's Parcel: a flat byte buffer plus the file
+ * descriptors written to it. As with binder, a written descriptor is
+ * duplicated into the parcel, and the parcel owns (and closes) it.
+ */
+
+#ifndef TEESERVICE_TEST_STUB_BINDER_PARCEL_H
+#define TEESERVICE_TEST_STUB_BINDER_PARCEL_H
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+namespace android {
+
+typedef int32_t status_t;
+enum {
+    OK = 0,
+    NOT_ENOUGH_DATA = -61,
+};
+
+class Parcel {
+    std::vector<uint8_t> data_;
+    std::vector<int> fds_;
+    mutable size_t position_ = 0;
+    mutable size_t fd_position_ = 0;
+
+    void write(const void* data, size_t size) {
+        auto bytes = static_cast<const uint8_t*>(data);
+        data_.insert(data_.end(), bytes, bytes + size);
+    }
+
+    status_t read(void* data, size_t size) const {
+        if (position_ + size > data_.size()) {
+            ::memset(data, 0, size);
+            return NOT_ENOUGH_DATA;
+        }
+
+        ::memcpy(data, &data_[position_], size);
+        position_ += size;
+        return OK;
+    }
+public:
+    Parcel() {}
+    Parcel(const Parcel&) = delete;
+    Parcel& operator=(const Parcel&) = delete;
+
+    ~Parcel() {
+        for (int fd: fds_) {
+            ::close(fd);
+        }
+    }
+
+    status_t writeInt32(int32_t value) {
+        write(&value, sizeof(value));
+        return OK;
+    }
+
+    status_t writeUint32(uint32_t value) {
+        write(&value, sizeof(value));
+        return OK;
+    }
+
+    status_t writeUint64(uint64_t value) {
+        write(&value, sizeof(value));
+        return OK;
+    }
+
+    status_t writeBool(bool value) {
+        return writeInt32(value);
+    }
+
+    status_t writeCString(const char* value) {
+        write(value, ::strlen(value) + 1);
+        return OK;
+    }
+
+    status_t writeByteVector(const std::vector<uint8_t>& value) {
+        writeUint32(static_cast<uint32_t>(value.size()));
+        write(value.data(), value.size());
+        return OK;
+    }
+
+    status_t writeFileDescriptor(int fd) {
+        fds_.push_back(::dup(fd));
+        return OK;
+    }
+
+    status_t readInt32(int32_t* value) const {
+        return read(value, sizeof(*value));
+    }
+
+    status_t readUint32(uint32_t* value) const {
+        return read(value, sizeof(*value));
+    }
+
+    status_t readUint64(uint64_t* value) const {
+        return read(value, sizeof(*value));
+    }
+
+    bool readBool() const {
+        int32_t value = 0;
+        readInt32(&value);
+        return value;
+    }
+
+    const char* readCString() const {
+        auto str = reinterpret_cast<const char*>(&data_[position_]);
+        position_ += ::strnlen(str, data_.size() - position_) + 1;
+        return str;
+    }
+
+    status_t readByteVector(std::vector<uint8_t>* value) const {
+        uint32_t size = 0;
+        readUint32(&size);
+        if (position_ + size > data_.size()) {
+            return NOT_ENOUGH_DATA;
+        }
+
+        value->assign(&data_[position_], &data_[position_] + size);
+        position_ += size;
+        return OK;
+    }
+
+    int readFileDescriptor() const {
+        if (fd_position_ >= fds_.size()) {
+            return -1;
+        }
+
+        return fds_[fd_position_++];
+    }
+};
+
+class Parcelable {
+public:
+    virtual ~Parcelable() {}
+    virtual status_t writeToParcel(Parcel* parcel) const = 0;
+    virtual status_t readFromParcel(const Parcel* parcel) = 0;
+};
+
+}
+
+#endif // TEESERVICE_TEST_STUB_BINDER_PARCEL_H
@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2018 TRUSTONIC LIMITED
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the TRUSTONIC LIMITED nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <time.h>
+#include <sys/mman.h>
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cutils/ashmem.h>
+#include <cutils/properties.h>
+
+#include "teeservice_loopback.h"
+
+using namespace vendor::trustonic::teeservice;
+
+// System properties and service manager
+
+static std::map<std::string, bool> g_properties;
+static ::android::IBinder* g_default_service;
+
+int8_t property_get_bool(const char* key, int8_t default_value) {
+    auto it = g_properties.find(key);
+    if (it == g_properties.end()) {
+        return default_value;
+    }
+
+    return it->second;
+}
+
+void property_set_bool(const char* key, bool value) {
+    g_properties[key] = value;
+}
+
+::android::sp<::android::IBinder> android::IServiceManager::getService(
+        const String16&) const {
+    return g_default_service;
+}
+
+void android::setDefaultService(IBinder* service) {
+    g_default_service = service;
+}
+
+::android::sp<::android::IServiceManager> android::defaultServiceManager() {
+    static IServiceManager service_manager;
+    return &service_manager;
+}
+
+// Server
+
+static void spin_ns(uint64_t ns) {
+    struct timespec t;
+    ::clock_gettime(CLOCK_MONOTONIC, &t);
+    uint64_t end = static_cast<uint64_t>(t.tv_sec) * 1000000000ull + t.tv_nsec + ns;
+    do {
+        ::clock_gettime(CLOCK_MONOTONIC, &t);
+    } while (static_cast<uint64_t>(t.tv_sec) * 1000000000ull + t.tv_nsec < end);
+}
+
+struct Mapping {
+    int fd = -1;
+    uint8_t* address = nullptr;
+    size_t size = 0;
+
+    bool map(int fd_in) {
+        int size_region = ::ashmem_get_size_region(fd_in);
+        if (size_region <= 0) {
+            return false;
+        }
+
+        void* mem = ::mmap(NULL, size_region, PROT_READ | PROT_WRITE, MAP_SHARED,
+                           fd_in, 0);
+        if (mem == MAP_FAILED) {
+            return false;
+        }
+
+        fd = fd_in;
+        address = static_cast<uint8_t*>(mem);
+        size = size_region;
+        return true;
+    }
+
+    void unmap() {
+        if (address) {
+            ::munmap(address, size);
+        }
+
+        if (fd >= 0) {
+            ::close(fd);
+        }
+
+        fd = -1;
+        address = nullptr;
+    }
+};
+
+struct LoopbackTeeService::Impl {
+    loopback_config config;
+    loopback_stats stats = loopback_stats();
+    // Registered shared memory by context and reference, server thread only
+    std::map<std::pair<uint64_t, uint64_t>, Mapping> mappings;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::function<void()> job;
+    bool done = false;
+    bool exit = false;
+    std::thread server;
+
+    explicit Impl(const loopback_config& config_): config(config_) {
+        server = std::thread([this] {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                cond.wait(lock, [this] { return job || exit; });
+                if (exit) {
+                    break;
+                }
+
+                lock.unlock();
+                spin_ns(config.transaction_us * 500ull);
+                job();
+                lock.lock();
+                job = nullptr;
+                done = true;
+                cond.notify_all();
+            }
+        });
+    }
+
+    ~Impl() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            exit = true;
+            cond.notify_all();
+        }
+
+        server.join();
+        for (auto& mapping: mappings) {
+            mapping.second.unmap();
+        }
+    }
+
+    // Marshal in, run handler on the server thread, marshal out
+    template<typename In, typename Out>
+    void transact(
+            const In& params_in,
+            Out* params_out,
+            std::function<void(In&, Out&)> handler) {
+        ::android::Parcel data;
+        ::android::Parcel reply;
+        params_in.writeToParcel(&data);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done = false;
+            job = [&] {
+                In server_in;
+                Out server_out;
+                server_in.readFromParcel(&data);
+                handler(server_in, server_out);
+                server_out.writeToParcel(&reply);
+            };
+            cond.notify_all();
+            cond.wait(lock, [this] { return done; });
+            stats.transactions++;
+        }
+
+        spin_ns(config.transaction_us * 500ull);
+        params_out->readFromParcel(&reply);
+    }
+
+    // Runs on the server thread
+    uint32_t invoke(
+            uint64_t context,
+            TeeServiceGpOperation& operation) {
+        if (!operation.reference) {
+            return TEEC_SUCCESS;
+        }
+
+        std::vector<Mapping> temporaries;
+        uint32_t result = TEEC_SUCCESS;
+        for (auto& param: operation.params) {
+            uint8_t* data = nullptr;
+            uint64_t size = 0;
+            uint32_t direction = 0;
+            switch (param.type) {
+                case TEEC_MEMREF_TEMP_INPUT:
+                case TEEC_MEMREF_TEMP_OUTPUT:
+                case TEEC_MEMREF_TEMP_INOUT: {
+                    direction = param.type & TEEC_MEM_INOUT;
+                    if (param.buffer < 0) {
+                        break;
+                    }
+
+                    stats.fds++;
+                    Mapping mapping;
+                    if (!mapping.map(param.buffer)) {
+                        ::close(param.buffer);
+                        result = TEEC_ERROR_OUT_OF_MEMORY;
+                        break;
+                    }
+
+                    stats.maps++;
+                    temporaries.push_back(mapping);
+                    data = mapping.address;
+                    size = param.size;
+                    break;
+                }
+                case TEEC_MEMREF_WHOLE:
+                case TEEC_MEMREF_PARTIAL_INPUT:
+                case TEEC_MEMREF_PARTIAL_OUTPUT:
+                case TEEC_MEMREF_PARTIAL_INOUT: {
+                    auto it = mappings.find(std::make_pair(context, param.reference));
+                    uint64_t offset = 0;
+                    if (param.type == TEEC_MEMREF_WHOLE) {
+                        direction = param.flags & TEEC_MEM_INOUT;
+                        size = param.size;
+                    } else {
+                        direction = param.type & TEEC_MEM_INOUT;
+                        offset = param.window_offset;
+                        size = param.window_size;
+                    }
+
+                    if ((it == mappings.end()) || (param.size > it->second.size) ||
+                            (offset + size > param.size)) {
+                        stats.bad_references++;
+                        result = TEEC_ERROR_BAD_PARAMETERS;
+                        break;
+                    }
+
+                    data = it->second.address + offset;
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            if (!data || (result != TEEC_SUCCESS)) {
+                continue;
+            }
+
+            spin_ns(config.ta_ns_per_kb * size / 1024);
+            switch (direction) {
+                case TEEC_MEM_INOUT:
+                    for (uint64_t i = 0; i < size; i++) {
+                        data[i] ^= LOOPBACK_KEY;
+                    }
+                    break;
+                case TEEC_MEM_OUTPUT:
+                    for (uint64_t i = 0; i < size; i++) {
+                        if (data[i]) {
+                            stats.stale_outputs++;
+                            break;
+                        }
+                    }
+
+                    ::memset(data, LOOPBACK_KEY, size);
+                    break;
+                default: {
+                    volatile uint8_t sum = 0;
+                    for (uint64_t i = 0; i < size; i++) {
+                        sum += data[i];
+                    }
+                    break;
+                }
+            }
+
+            // Size written, for both temporary and registered references
+            param.size = size;
+        }
+
+        for (auto& mapping: temporaries) {
+            mapping.unmap();
+        }
+
+        return result;
+    }
+};
+
+LoopbackTeeService::LoopbackTeeService(
+        const loopback_config& config):
+    pimpl_(new Impl(config)) {}
+
+LoopbackTeeService::~LoopbackTeeService() {
+    delete pimpl_;
+}
+
+loopback_stats LoopbackTeeService::stats() const {
+    std::lock_guard<std::mutex> lock(pimpl_->mutex);
+    return pimpl_->stats;
+}
+
+// For calls without out parameters
+struct NoOut {
+    ::android::status_t writeToParcel(::android::Parcel*) const {
+        return ::android::OK;
+    }
+
+    ::android::status_t readFromParcel(const ::android::Parcel*) {
+        return ::android::OK;
+    }
+};
+
+::android::binder::Status LoopbackTeeService::TEEC_InitializeContext(
+        const TeeServiceGpContextIn& params_in,
+        int32_t* _aidl_return) {
+    NoOut out;
+    pimpl_->transact<TeeServiceGpContextIn, NoOut>(params_in, &out,
+            [](TeeServiceGpContextIn&, NoOut&) {});
+    *_aidl_return = TEEC_SUCCESS;
+    return ::android::binder::Status::ok();
+}
+
+::android::binder::Status LoopbackTeeService::TEEC_FinalizeContext(
+        const TeeServiceGpContextIn& params_in) {
+    NoOut out;
+    pimpl_->transact<TeeServiceGpContextIn, NoOut>(params_in, &out,
+            [this](TeeServiceGpContextIn& in, NoOut&) {
+        auto& mappings = pimpl_->mappings;
+        for (auto it = mappings.begin(); it != mappings.end();) {
+            if (it->first.first == in.context) {
+                it->second.unmap();
+                it = mappings.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    });
+    return ::android::binder::Status::ok();
+}
+
+::android::binder::Status LoopbackTeeService::TEEC_RegisterSharedMemory(
+        const TeeServiceGpSharedMemoryIn& params_in,
+        int32_t* _aidl_return) {
+    NoOut out;
+    pimpl_->transact<TeeServiceGpSharedMemoryIn, NoOut>(params_in, &out,
+            [this, _aidl_return](TeeServiceGpSharedMemoryIn& in, NoOut&) {
+        pimpl_->stats.fds++;
+        Mapping mapping;
+        if (!mapping.map(in.buffer)) {
+            ::close(in.buffer);
+            *_aidl_return = TEEC_ERROR_OUT_OF_MEMORY;
+            return;
+        }
+
+        pimpl_->stats.maps++;
+        pimpl_->mappings[std::make_pair(in.context, in.reference)] = mapping;
+        *_aidl_return = TEEC_SUCCESS;
+    });
+    return ::android::binder::Status::ok();
+}
+
+::android::binder::Status LoopbackTeeService::TEEC_ReleaseSharedMemory(
+        const TeeServiceGpSharedMemoryIn& params_in) {
+    NoOut out;
+    pimpl_->transact<TeeServiceGpSharedMemoryIn, NoOut>(params_in, &out,
+            [this](TeeServiceGpSharedMemoryIn& in, NoOut&) {
+        auto it = pimpl_->mappings.find(std::make_pair(in.context, in.reference));
+        if (it == pimpl_->mappings.end()) {
+            pimpl_->stats.bad_references++;
+            return;
+        }
+
+        it->second.unmap();
+        pimpl_->mappings.erase(it);
+    });
+    return ::android::binder::Status::ok();
+}
+
+::android::binder::Status LoopbackTeeService::TEEC_OpenSession(
+        const TeeServiceGpOpenSessionIn& params_in,
+        TeeServiceGpOpenSessionOut* params_out,
+        int32_t* _aidl_return) {
+    pimpl_->transact<TeeServiceGpOpenSessionIn, TeeServiceGpOpenSessionOut>(
+            params_in, params_out,
+            [this, _aidl_return](TeeServiceGpOpenSessionIn& in,
+                                 TeeServiceGpOpenSessionOut& out) {
+        *_aidl_return = pimpl_->invoke(in.context, in.operation);
+        out.origin = TEEC_ORIGIN_TRUSTED_APP;
+        out.id = 1;
+        out.operation = in.operation;
+    });
+    return ::android::binder::Status::ok();
+}
+
+::android::binder::Status LoopbackTeeService::TEEC_CloseSession(
+        const TeeServiceGpCloseSessionIn& params_in) {
+    NoOut out;
+    pimpl_->transact<TeeServiceGpCloseSessionIn, NoOut>(params_in, &out,
+            [](TeeServiceGpCloseSessionIn&, NoOut&) {});
+    return ::android::binder::Status::ok();
+}
+
+::android::binder::Status LoopbackTeeService::TEEC_InvokeCommand(
+        const TeeServiceGpInvokeCommandIn& params_in,
+        TeeServiceGpInvokeCommandOut* params_out,
+        int32_t* _aidl_return) {
+    pimpl_->transact<TeeServiceGpInvokeCommandIn, TeeServiceGpInvokeCommandOut>(
+            params_in, params_out,
+            [this, _aidl_return](TeeServiceGpInvokeCommandIn& in,
+                                 TeeServiceGpInvokeCommandOut& out) {
+        *_aidl_return = pimpl_->invoke(in.context, in.operation);
+        out.origin = TEEC_ORIGIN_TRUSTED_APP;
+        out.operation = in.operation;
+    });
+    return ::android::binder::Status::ok();
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2018 TRUSTONIC LIMITED
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the TRUSTONIC LIMITED nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * In-process stand-in for the TeeService server and the TEE behind it, for
+ * measuring the client's GP round trip on a plain Linux host.
+ *
+ * Each call is serialised into a Parcel, run on a server thread and its reply
+ * serialised back, with a fixed cost per transaction for binder. The server
+ * treats buffers the way TeeService does: it maps the region behind each
+ * temporary memory reference for the duration of the call, and keeps the
+ * regions of registered shared memory mapped until they are released.
+ *
+ * The "TA" takes any command and, for each memory reference, XORs an input
+ * and output buffer with LOOPBACK_KEY, fills an output one with LOOPBACK_KEY
+ * (after checking that it holds nothing yet) and just reads an input one, at a fixed cost per KB. It reports the size
+ * it was given as the size it wrote.
+ */
+
+#ifndef TEESERVICE_TEST_LOOPBACK_H
+#define TEESERVICE_TEST_LOOPBACK_H
+
+#include <stdint.h>
+
+#include "vendor/trustonic/teeservice/BpTeeService.h"
+
+#define LOOPBACK_KEY 0x5a
+
+struct loopback_config {
+    unsigned transaction_us;    // per call, both ways
+    unsigned ta_ns_per_kb;      // TA processing
+};
+
+struct loopback_stats {
+    uint64_t transactions;
+    uint64_t fds;               // received by the server
+    uint64_t maps;              // made by the server
+    uint64_t bad_references;    // memory references the server could not find
+    uint64_t stale_outputs;     // output buffers that did not come in zeroed
+};
+
+class LoopbackTeeService: public ::vendor::trustonic::teeservice::ITeeService {
+    struct Impl;
+    Impl* pimpl_;
+public:
+    explicit LoopbackTeeService(
+            const loopback_config& config);
+    ~LoopbackTeeService() override;
+
+    loopback_stats stats() const;
+
+    ::android::binder::Status TEEC_InitializeContext(
+            const ::vendor::trustonic::teeservice::TeeServiceGpContextIn& params_in,
+            int32_t* _aidl_return) override;
+
+    ::android::binder::Status TEEC_FinalizeContext(
+            const ::vendor::trustonic::teeservice::TeeServiceGpContextIn& params_in) override;
+
+    ::android::binder::Status TEEC_RegisterSharedMemory(
+            const ::vendor::trustonic::teeservice::TeeServiceGpSharedMemoryIn& params_in,
+            int32_t* _aidl_return) override;
+
+    ::android::binder::Status TEEC_ReleaseSharedMemory(
+            const ::vendor::trustonic::teeservice::TeeServiceGpSharedMemoryIn& params_in) override;
+
+    ::android::binder::Status TEEC_OpenSession(
+            const ::vendor::trustonic::teeservice::TeeServiceGpOpenSessionIn& params_in,
+            ::vendor::trustonic::teeservice::TeeServiceGpOpenSessionOut* params_out,
+            int32_t* _aidl_return) override;
+
+    ::android::binder::Status TEEC_CloseSession(
+            const ::vendor::trustonic::teeservice::TeeServiceGpCloseSessionIn& params_in) override;
+
+    ::android::binder::Status TEEC_InvokeCommand(
+            const ::vendor::trustonic::teeservice::TeeServiceGpInvokeCommandIn& params_in,
+            ::vendor::trustonic::teeservice::TeeServiceGpInvokeCommandOut* params_out,
+            int32_t* _aidl_return) override;
+};
+
+#endif // TEESERVICE_TEST_LOOPBACK_H
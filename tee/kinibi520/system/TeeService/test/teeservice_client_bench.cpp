@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2018 TRUSTONIC LIMITED
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the TRUSTONIC LIMITED nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Round trip of TEEC_InvokeCommand through TeeServiceClient on a plain Linux
+ * host, against the loopback server in stub/.
+ *
+ * Each command has one TEEC_MEMREF_TEMP_INOUT parameter.
+ *  * "region": vendor.trustonic.teeservice.pool=false, a new region is
+ *    created, mapped, passed and copied through for every command.
+ *  * "pool": the region comes from the context's pool, already registered
+ *    with the server.
+ *  * "in place": vendor.trustonic.teeservice.zero_copy=true and the buffer is
+ *    TEEC_AllocateSharedMemory memory, which the TA works on directly.
+ *  * "alias": same, but the memory is registered again with
+ *    TEEC_RegisterSharedMemory and passed as TEEC_MEMREF_WHOLE instead.
+ * All check the TA's output. "region" and "pool" then send an output only
+ * reference, which the TA must find zeroed even though the pool region held
+ * the data of the commands before.
+ *
+ * Build and run from system/TeeService, with clang like the rest of the tree:
+ *
+ *   clang++ -O2 -std=c++17 -pthread -DTBASE_API_LEVEL=11 -Itest/stub -I. \
+ *       -I../../common/ApiHeaders/include -I../../common/ApiHeaders/include/GP \
+ *       test/teeservice_client_bench.cpp test/stub/teeservice_loopback.cpp \
+ *       teeservice_client.cpp teeservice_pool.cpp -o teeservice_client_bench
+ *   ./teeservice_client_bench [transaction_us] [ta_ns_per_kb]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <memory>
+
+#include <cutils/properties.h>
+
+#include "teeservice_client.h"
+#include "teeservice_loopback.h"
+
+#define BENCH_COMMANDS 2000
+
+enum Mode {
+    MODE_REGION,
+    MODE_POOL,
+    MODE_IN_PLACE,
+    MODE_ALIAS,
+};
+
+static const char* const mode_names[] = {
+    "region", "pool", "in place", "alias",
+};
+
+static uint64_t now_ns() {
+    struct timespec t;
+    ::clock_gettime(CLOCK_MONOTONIC, &t);
+    return static_cast<uint64_t>(t.tv_sec) * 1000000000ull + t.tv_nsec;
+}
+
+static int run(
+        LoopbackTeeService& service,
+        Mode mode,
+        size_t size) {
+    ::property_set_bool("vendor.trustonic.teeservice.pool", mode != MODE_REGION);
+    ::property_set_bool("vendor.trustonic.teeservice.zero_copy", mode >= MODE_IN_PLACE);
+    TeeServiceClient client;
+    TEEC_Context context;
+    TEEC_Session session;
+    TEEC_SharedMemory shared_mem;
+    TEEC_SharedMemory alias_mem;
+    TEEC_UUID uuid;
+    uint32_t origin;
+    ::memset(&context, 0, sizeof(context));
+    ::memset(&session, 0, sizeof(session));
+    ::memset(&shared_mem, 0, sizeof(shared_mem));
+    ::memset(&alias_mem, 0, sizeof(alias_mem));
+    ::memset(&uuid, 0, sizeof(uuid));
+
+    if ((client.TEEC_InitializeContext(nullptr, &context) != TEEC_SUCCESS) ||
+            (client.TEEC_OpenSession(&context, &session, &uuid, TEEC_LOGIN_PUBLIC,
+                                     nullptr, nullptr, &origin) != TEEC_SUCCESS)) {
+        printf("  failed to open session\n");
+        return 1;
+    }
+
+    std::unique_ptr<uint8_t[]> local(new uint8_t[size]);
+    uint8_t* buffer = local.get();
+    if (mode >= MODE_IN_PLACE) {
+        shared_mem.size = size;
+        shared_mem.flags = TEEC_MEM_INOUT;
+        if (client.TEEC_AllocateSharedMemory(&context, &shared_mem) != TEEC_SUCCESS) {
+            printf("  failed to allocate shared memory\n");
+            return 1;
+        }
+
+        buffer = static_cast<uint8_t*>(shared_mem.buffer);
+    }
+
+    if (mode == MODE_ALIAS) {
+        alias_mem.buffer = buffer;
+        alias_mem.size = size;
+        alias_mem.flags = TEEC_MEM_INOUT;
+        if (client.TEEC_RegisterSharedMemory(&context, &alias_mem) != TEEC_SUCCESS) {
+            printf("  failed to register shared memory\n");
+            return 1;
+        }
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        buffer[i] = static_cast<uint8_t>(i * 131 + 7);
+    }
+
+    TEEC_Operation operation;
+    ::memset(&operation, 0, sizeof(operation));
+    operation.paramTypes = TEEC_PARAM_TYPES(
+                               mode == MODE_ALIAS ? TEEC_MEMREF_WHOLE : TEEC_MEMREF_TEMP_INOUT,
+                               TEEC_NONE, TEEC_NONE, TEEC_NONE);
+    bool ok = true;
+    auto before = service.stats();
+    auto start = now_ns();
+    // An even number of XORs leaves the buffer as it was
+    for (size_t i = 0; ok && (i < BENCH_COMMANDS); i++) {
+        if (mode == MODE_ALIAS) {
+            operation.params[0].memref.parent = &alias_mem;
+            operation.params[0].memref.size = 0;
+            operation.params[0].memref.offset = 0;
+        } else {
+            operation.params[0].tmpref.buffer = buffer;
+            operation.params[0].tmpref.size = size;
+        }
+
+        // The TA reports the whole buffer written
+        ok = (client.TEEC_InvokeCommand(&session, 0, &operation, &origin) == TEEC_SUCCESS) &&
+             ((mode == MODE_ALIAS ? operation.params[0].memref.size :
+                                    operation.params[0].tmpref.size) == size);
+    }
+
+    double usec = (now_ns() - start) / 1e3 / BENCH_COMMANDS;
+    auto after = service.stats();
+    for (size_t i = 0; ok && (i < size); i++) {
+        if (buffer[i] != static_cast<uint8_t>(i * 131 + 7)) {
+            printf("  data mismatch at %zu\n", i);
+            ok = false;
+        }
+    }
+
+    if (ok && (mode <= MODE_POOL)) {
+        std::unique_ptr<uint8_t[]> output(new uint8_t[size]);
+        ::memset(output.get(), 0, size);
+        operation.paramTypes = TEEC_PARAM_TYPES(
+                                   TEEC_MEMREF_TEMP_OUTPUT, TEEC_NONE, TEEC_NONE, TEEC_NONE);
+        operation.params[0].tmpref.buffer = output.get();
+        operation.params[0].tmpref.size = size;
+        ok = (client.TEEC_InvokeCommand(&session, 0, &operation, &origin) == TEEC_SUCCESS);
+        for (size_t i = 0; ok && (i < size); i++) {
+            if (output[i] != LOOPBACK_KEY) {
+                printf("  output mismatch at %zu\n", i);
+                ok = false;
+            }
+        }
+
+        if (ok && (service.stats().stale_outputs != before.stale_outputs)) {
+            printf("  output reference not zeroed\n");
+            ok = false;
+        }
+    }
+
+    if (mode == MODE_ALIAS) {
+        client.TEEC_ReleaseSharedMemory(&alias_mem);
+    }
+
+    if (mode >= MODE_IN_PLACE) {
+        client.TEEC_ReleaseSharedMemory(&shared_mem);
+    }
+
+    client.TEEC_CloseSession(&session);
+    client.TEEC_FinalizeContext(&context);
+    if (!ok || (after.bad_references != before.bad_references)) {
+        printf("  %-8s %7zu bytes : FAILED\n", mode_names[mode], size);
+        return 1;
+    }
+
+    printf("  %-8s %7zu bytes : %8.1f us/command, %5.2f fds/command, %5.2f maps/command\n",
+           mode_names[mode], size, usec,
+           static_cast<double>(after.fds - before.fds) / BENCH_COMMANDS,
+           static_cast<double>(after.maps - before.maps) / BENCH_COMMANDS);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    static const size_t sizes[] = {
+        64, 1024, 4096, 16384, 65536, 262144,
+    };
+    loopback_config config = { 50, 100 };
+    int failed = 0;
+
+    if (argc > 1) {
+        config.transaction_us = atoi(argv[1]);
+    }
+
+    if (argc > 2) {
+        config.ta_ns_per_kb = atoi(argv[2]);
+    }
+
+    printf("transaction %u us, TA %u ns/KB, %d commands\n",
+           config.transaction_us, config.ta_ns_per_kb, BENCH_COMMANDS);
+
+    auto service = new LoopbackTeeService(config);
+    ::android::setDefaultService(service);
+    for (auto size: sizes) {
+        failed |= run(*service, MODE_REGION, size);
+        failed |= run(*service, MODE_POOL, size);
+        failed |= run(*service, MODE_IN_PLACE, size);
+        failed |= run(*service, MODE_ALIAS, size);
+    }
+
+    delete service;
+    return failed;
+}